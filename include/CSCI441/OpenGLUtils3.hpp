@@ -49,16 +49,16 @@ namespace CSCI441 {
 		static const glm::vec3 Z_AXIS_NEG(  0.0f,  0.0f, -1.0f );		// constant for negative Z_AXIS
 
 		/**	@brief Multiplies current matrix by given matrix
-			* @deprecated Multiplies current matrix by given matrix
+			* @deprecated Multiplies current matrix by given matrix; use CSCI441::SceneGraph instead
 			* @param glm::mat4 mtx		- matrix to multiply the current matrix by
 		  */
-		DEPRECATED(void pushMatrix( glm::mat4 mtx ));
+		DEPRECATED(void pushMatrix( const glm::mat4 &mtx ));
 
     /**	@brief Multiplies current matrix by inverse of given matrix
-			* @deprecated Multiplies current matrix by inverse of given matrix
+			* @deprecated Multiplies current matrix by inverse of given matrix; use CSCI441::SceneGraph instead
 			* @param glm::mat4 mtx		- matrix to multiply the current matrix by the inverse of
 		  */
-		DEPRECATED(void popMatrix( glm::mat4 mtx ));
+		DEPRECATED(void popMatrix( const glm::mat4 &mtx ));
 
     /** @namespace OpenGLUtils
       * @brief contains OpenGL Utility functions
@@ -108,11 +108,11 @@ namespace CSCI441_INTERNAL {
 ////////////////////////////////////////////////////////////////////////////////////
 // Outward facing function implementations
 
-inline void CSCI441::pushMatrix( glm::mat4 mtx ) {
+inline void CSCI441::pushMatrix( const glm::mat4 &mtx ) {
 	glMultMatrixf( &mtx[0][0] );
 }
 
-inline void CSCI441::popMatrix( glm::mat4 mtx ) {
+inline void CSCI441::popMatrix( const glm::mat4 &mtx ) {
 	glMultMatrixf( &( glm::inverse(mtx) )[0][0] );
 }
 
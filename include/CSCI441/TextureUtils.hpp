@@ -0,0 +1,1230 @@
+/** @file TextureUtils.hpp
+  * @brief Helper functions to work with OpenGL Textures
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 03 Nov 2017
+	* @version 1.5
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	These functions, classes, and constants help minimize common
+	*	code that needs to be written.
+  */
+
+#ifndef __CSCI441_TEXTUREUTILS_H__
+#define __CSCI441_TEXTUREUTILS_H__
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+	#include <OpenGL/gl.h>
+#else
+	#include <GL/gl.h>
+#endif
+
+#include <SOIL/SOIL.h>
+
+#include <CSCI441/imageKernels.hpp>
+
+// OpenGL 1.2 and 3.0 names missing from some platforms' gl.h
+#ifndef GL_TEXTURE_MAX_LEVEL
+	#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+#ifndef GL_RG
+	#define GL_RG 0x8227
+#endif
+#ifndef GL_TEXTURE_CUBE_MAP
+	#define GL_TEXTURE_CUBE_MAP 0x8513
+	#define GL_TEXTURE_CUBE_MAP_POSITIVE_X 0x8515
+	#define GL_TEXTURE_CUBE_MAP_NEGATIVE_Z 0x851A
+#endif
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	// a whole file mapped read only into memory, or read into a buffer where mapping is unavailable
+	struct MappedFile {
+		const unsigned char *data;
+		size_t size;
+		bool mapped;
+#ifdef _WIN32
+		HANDLE file, mapping;
+#endif
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+	/** @namespace TextureUtils
+	  * @brief OpenGL Texture Utility functions
+	  */
+	namespace TextureUtils {
+		/**	@brief loads a BMP into memory
+			*
+			*  This function reads an uncompressed 24 bit BMP, returning true if the function succeeds and
+			*      false if it fails. If it succeeds, the variables imageWidth and
+			*      imageHeight will hold the width and height of the read image, respectively.
+			*
+			*  Returns the image as an unsigned character array containing
+			*      imageWidth*imageHeight*3 entries (for that many bytes of storage),
+			*      bottom row first as OpenGL expects.
+			*
+			*  NOTE: this function expects imageData to be UNALLOCATED, and will allocate
+			*      memory itself. If the function fails (returns false), imageData
+			*      will be set to NULL and any allocated memory will be automatically deallocated.
+			*
+			*	@param[in] const char* filename	- filename of the image to load
+			* @param[out] int &imageWidth			-	will contain the image width upon successful completion
+			* @param[out] int &imageHeight		- will contain the image height upon successful completion
+			* @param[out] int &imageChannels  - will contain the number of channels in the image upon successful completion
+			* @param[out] unsigned char* &imageData - will contain the RGB data upon successful completion
+			* @param[in] const char* path 		- path to where file is stored.  defaults to current directory
+			* @pre imageData is unallocated
+			* @return bool - true if loading succeeded, false otherwise
+			*/
+		bool loadBMP( const char* filename, int &imageWidth, int &imageHeight, int &imageChannels, unsigned char* &imageData, const char* path = "./" );
+
+		/**	@brief loads a PPM into memory
+			*
+			*  This function reads an ASCII (P3) or binary (P6) PPM, returning true if the function
+			*      succeeds and false if it fails. If it succeeds, the variables imageWidth and
+			*      imageHeight will hold the width and height of the read image, respectively.
+			*
+			*  Any maximum value up to 65535 is accepted and scaled to the range 0-255.
+			*
+			*  Returns the image as an unsigned character array containing
+			*      imageWidth*imageHeight*3 entries (for that many bytes of storage).
+			*
+			*  NOTE: this function expects imageData to be UNALLOCATED, and will allocate
+			*      memory itself. If the function fails (returns false), imageData
+			*      will be set to NULL and any allocated memory will be automatically deallocated.
+			*
+			*	@param[in] const char *filename	- filename of the image to load
+			* @param[out] int &imageWidth			-	will contain the image width upon successful completion
+			* @param[out] int &imageHeight		- will contain the image height upon successful completion
+			* @param[out] unsigned char* &imageData - will contain the RGB data upon successful completion
+			* @pre imageData is unallocated
+			* @return bool - true if loading succeeded, false otherwise
+			*/
+		bool loadPPM( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData );
+
+		/**	@brief saves RGB data as a binary (P6) PPM
+			*
+			*  Binary PPMs load straight from a file mapping, so writing out an image once it
+			*      has been decoded or converted makes every later load nearly free.
+			*
+			*	@param[in] const char *filename	- filename of the image to write
+			* @param[in] int imageWidth			-	width of the image
+			* @param[in] int imageHeight		- height of the image
+			* @param[in] const unsigned char* imageData - imageWidth*imageHeight*3 bytes of RGB data, rows in the order to be written
+			* @return bool - true if the whole file was written, false otherwise
+			*/
+		bool writePPM( const char *filename, int imageWidth, int imageHeight, const unsigned char *imageData );
+
+		/** @class PPMImage
+			* @brief A PPM held in memory in the form OpenGL takes it
+			*
+			*	The file is mapped into memory rather than read.  Binary (P6) images with a
+			*	maximum value of 255 or 65535 are then used where they lie: getPixels()
+			*	points at the raster inside the mapping and upload() hands that pointer to
+			*	glTexImage2D(), so the pixels are never copied on the CPU.  Sixteen bit
+			*	samples stay big endian as stored and upload() has OpenGL swap them.
+			*
+			*	ASCII (P3) images and other maximum values are decoded into a buffer the
+			*	image owns, scaled to the full 8 or 16 bit range.  P3 numbers are read
+			*	eight characters at a time within 64-bit words.
+			*
+			*	Rows are in file order, top row first, the same as loadPPM().
+			*/
+		class PPMImage {
+		public:
+			/** @brief Creates an empty image
+				*/
+			PPMImage();
+			/** @brief Unmaps the file and frees any decoded pixels
+				*/
+			~PPMImage();
+
+			/** @brief Maps a PPM and decodes it if it cannot be used in place
+				* @param const char* filename	- filename of the image to load
+				* @return true if loading succeeded, false otherwise
+				*/
+			bool load( const char *filename );
+			/** @brief Unmaps the file and frees any decoded pixels
+				*/
+			void release();
+
+			/** @brief Returns the width of the image
+				* @return pixels across
+				*/
+			int getWidth() const;
+			/** @brief Returns the height of the image
+				* @return pixels down
+				*/
+			int getHeight() const;
+			/** @brief Returns the maximum value the file declared
+				* @return 1 through 65535
+				*/
+			unsigned int getMaxValue() const;
+			/** @brief Returns the OpenGL type of each sample
+				* @return GL_UNSIGNED_BYTE or GL_UNSIGNED_SHORT
+				*/
+			GLenum getType() const;
+			/** @brief Returns whether sixteen bit samples are big endian, as they are in a mapped P6 file
+				* @return true if the bytes of each sample must be swapped on little endian machines
+				*/
+			bool isBigEndian() const;
+			/** @brief Returns whether the pixels lie inside the file mapping rather than a decoded copy
+				* @return true if no decoding was needed
+				*/
+			bool isMapped() const;
+			/** @brief Returns the RGB samples, width*height*3 of getType()
+				* @return pointer valid until release() or the image is destroyed
+				*/
+			const void* getPixels() const;
+			/** @brief Returns the size of the RGB samples
+				* @return bytes
+				*/
+			size_t getSize() const;
+
+			/** @brief Specifies the bound texture's image from the pixels
+				*
+				*	Internal format is GL_RGB8 or GL_RGB16 to match the samples.  The unpack
+				*	alignment and byte swapping this needs are set for the call and then restored.
+				*
+				* @param GLenum target	- texture target to specify (default: GL_TEXTURE_2D)
+				* @param GLint level		- mipmap level to specify (default: 0)
+				*/
+			void upload( GLenum target = GL_TEXTURE_2D, GLint level = 0 ) const;
+
+		private:
+			PPMImage( const PPMImage& );
+			PPMImage& operator=( const PPMImage& );
+
+			CSCI441_INTERNAL::MappedFile _file;
+			int _width, _height;
+			unsigned int _maxValue;
+			GLenum _type;
+			bool _bigEndian;
+			const unsigned char *_pixels;
+			size_t _size;
+			vector< unsigned char > _decoded;
+		};
+
+		/** @class MipmapChain
+			* @brief Every mipmap level of an 8-bit image, filtered on the CPU in linear light
+			*
+			*	Each level is filtered from the one above it in floating point, so
+			*	rounding never accumulates down the chain.  sRGB images are decoded to
+			*	linear intensity before filtering and encoded again afterwards; averaging
+			*	the encoded values instead darkens every level and shifts colors at
+			*	high contrast edges.  Large levels are filtered across threads.
+			*
+			*	The levels are plain arrays of bytes, so they can be written to disk as
+			*	easily as they are uploaded.
+			*/
+		class MipmapChain {
+		public:
+			/** @brief Creates an empty chain
+				*/
+			MipmapChain();
+
+			/** @brief Builds every level down to one by one from an image
+				* @param const unsigned char* pixels	- width*height*channels bytes, copied as level 0
+				* @param int width					- pixels across
+				* @param int height					- pixels down
+				* @param int channels				- 1 to 4; a fourth channel is alpha
+				* @param bool srgb					- whether the color channels are sRGB encoded (default: true)
+				* @param MipmapFilter filter			- how each level is shrunk from the one above (default: box)
+				*/
+			void build( const unsigned char *pixels, int width, int height, int channels, bool srgb = true,
+						ImageKernels::MipmapFilter filter = ImageKernels::MIPMAP_FILTER_BOX );
+
+			/** @brief Specifies every level of the bound texture and turns on trilinear filtering
+				*
+				*	The format matches the channels: GL_RED, GL_RG, GL_RGB, or GL_RGBA.
+				*
+				* @param GLenum target		- texture target to specify (default: GL_TEXTURE_2D)
+				* @param GLenum minFilter	- minification filter to apply (default: GL_LINEAR_MIPMAP_LINEAR)
+				*/
+			void upload( GLenum target = GL_TEXTURE_2D, GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR ) const;
+
+			/** @brief Returns the number of levels built
+				* @return 0 before build(), otherwise 1 + floor(log2(max(width, height)))
+				*/
+			int getNumLevels() const;
+			/** @brief Returns the width of a level
+				* @param int level	- 0 is the full size image
+				* @return pixels across
+				*/
+			int getWidth( int level = 0 ) const;
+			/** @brief Returns the height of a level
+				* @param int level	- 0 is the full size image
+				* @return pixels down
+				*/
+			int getHeight( int level = 0 ) const;
+			/** @brief Returns the bytes per pixel of every level
+				* @return 1 to 4
+				*/
+			int getChannels() const;
+			/** @brief Returns the format upload() specifies the levels in
+				* @return GL_RED, GL_RG, GL_RGB, or GL_RGBA
+				*/
+			GLenum getFormat() const;
+			/** @brief Returns the pixels of a level
+				* @param int level	- 0 is the full size image
+				* @return getWidth(level)*getHeight(level)*getChannels() bytes
+				*/
+			const unsigned char* getLevel( int level ) const;
+			/** @brief Returns the bytes in all levels together
+				* @return about 4/3 the size of level 0
+				*/
+			size_t getSize() const;
+			/** @brief Returns how long the last build() took
+				* @return time in milliseconds
+				*/
+			double getBuildTime() const;
+
+		private:
+			int _channels;
+			vector< int > _widths, _heights;
+			vector< vector< unsigned char > > _levels;
+			double _buildTime;
+		};
+
+		/**	@brief loads a TGA into memory
+			*
+			*  This function reads a 24 or 32 bit TGA, uncompressed or run length encoded, returning
+			*      true if the function succeeds and false if it fails. If it succeeds, the variables
+			*      imageWidth and imageHeight will hold the width and height of the read image, respectively.
+			*
+			*  Returns the image as an unsigned character array containing
+			*      imageWidth*imageHeight*imageChannels entries (for that many bytes of storage),
+			*      top row first whichever corner the file starts from.
+			*
+			*  NOTE: this function expects imageData to be UNALLOCATED, and will allocate
+			*      memory itself. If the function fails (returns false), imageData
+			*      will be set to NULL and any allocated memory will be automatically deallocated.
+			*
+			*	@param[in] const char *filename	- filename of the image to load
+			* @param[out] int &imageWidth			-	will contain the image width upon successful completion
+			* @param[out] int &imageHeight		- will contain the image height upon successful completion
+			* @param[out] unsigned char* &imageData - will contain the RGB data upon successful completion
+			* @param[out] int &imageChannels  - will contain the number of channels in the image upon successful completion
+			* @pre imageData is unallocated
+			* @return bool - true if loading succeeded, false otherwise
+			*/
+		bool loadTGA( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData, int &imageChannels );
+
+		/**	@brief loads and registers a texture into memory returning a texture handle
+			*
+			*  Equivalent to loadAndRegister2DTexture()
+			*/
+		GLuint loadAndRegisterTexture( const char *filename,
+																		GLenum minFilter = GL_LINEAR,
+																		GLenum magFilter = GL_LINEAR,
+																		GLenum wrapS = GL_REPEAT,
+																		GLenum wrapT = GL_REPEAT );
+
+		/**	@brief loads and registers a texture into memory returning a texture handle
+			*
+			*  This function loads a texture into memory and registers the texture with
+			* OpenGL.  The provided minification and magnification filters are set for
+			* the texture.  The texture coordinate wrapping parameters are also set.
+			*
+			*	@param const char* filename - name of texture to load
+			* @param GLenum minFilter     - minification filter to apply (default: GL_LINEAR)
+			* @param GLenum magFilter     - magnification filter to apply (default: GL_LINEAR)
+			* @param GLenum wrapS         - wrapping to apply to S coordinate (default: GL_REPEAT)
+			* @param GLenum wrapT         - wrapping to apply to T coordinate (default: GL_REPEAT)
+			* @return GLuint 						  - texture handle corresponding to the texture
+			*/
+		GLuint loadAndRegister2DTexture( const char *filename,
+														  				GLenum minFilter = GL_LINEAR,
+															  			GLenum magFilter = GL_LINEAR,
+																  		GLenum wrapS = GL_REPEAT,
+																	  	GLenum wrapT = GL_REPEAT );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	bool mapFile( const char *filename, MappedFile &file );
+	void unmapFile( MappedFile &file );
+	bool isLittleEndian();
+
+	bool readPPMHeader( const MappedFile &file, int &format, int &width, int &height, unsigned int &maxValue, size_t &rasterOffset );
+	bool readPPMHeaderValue( const unsigned char *data, size_t size, size_t &offset, unsigned int &value );
+	template< typename T > size_t scanPPMSamples( const unsigned char *text, const unsigned char *end, T *samples, size_t numSamples, unsigned int maxValue );
+	unsigned int readPPMNumber( const unsigned char *number, const unsigned char *end, unsigned int maxValue );
+	template< typename T > void scalePPMSamples( T *samples, size_t numSamples, unsigned int maxValue, unsigned int fullValue );
+	unsigned long long loadPPMWord( const unsigned char *text );
+
+	bool decodeTGA( const unsigned char *data, const unsigned char *end, unsigned char *imageData, size_t width, size_t height, unsigned int channels, bool topLeft, bool usingRLE );
+	void fillPixels( unsigned char *pixels, size_t numPixels, unsigned int channels );
+	unsigned int readLittleEndian16( const unsigned char *bytes );
+	unsigned int readLittleEndian32( const unsigned char *bytes );
+	unsigned long long ppmNonDigits( unsigned long long word );
+	unsigned int ppmParseDigits( unsigned long long word, unsigned int length );
+	unsigned int ppmCountTrailingZeros( unsigned long long bits );
+	GLenum textureParameterTarget( GLenum target );
+
+	// widest image side accepted from a PPM header
+	static const unsigned int PPM_MAX_DIMENSION = 65535;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+// loadBMP() //////////////////////////////////////////////////////////////////
+//
+// Load an uncompressed 24-bit BMP as RGB
+//
+////////////////////////////////////////////////////////////////////////////////
+inline bool CSCI441::TextureUtils::loadBMP( const char* filename, int &imageWidth, int &imageHeight, int &imageChannels, unsigned char* &imageData, const char* path ) {
+	imageData = NULL;
+
+	// make sure the file is there.
+	CSCI441_INTERNAL::MappedFile file;
+	if( !CSCI441_INTERNAL::mapFile( filename, file ) ) {
+		string folderName = string(path) + string(filename);
+		if( !CSCI441_INTERNAL::mapFile( folderName.c_str(), file ) ) {
+			printf("[.bmp]: [ERROR]: File Not Found: %s\n",filename);
+			return false;
+		}
+	}
+
+	// the file header and the start of the info header hold everything we need
+	if( file.size < 54 || file.data[0] != 'B' || file.data[1] != 'M' ) {
+		printf("[.bmp]: [ERROR]: %s is not a BMP.\n", filename);
+		CSCI441_INTERNAL::unmapFile( file );
+		return false;
+	}
+	const size_t dataOffset = CSCI441_INTERNAL::readLittleEndian32( file.data + 10 );
+	const unsigned int infoSize = CSCI441_INTERNAL::readLittleEndian32( file.data + 14 );
+	const int width = (int)CSCI441_INTERNAL::readLittleEndian32( file.data + 18 );
+	const int height = (int)CSCI441_INTERNAL::readLittleEndian32( file.data + 22 );
+	const unsigned int planes = CSCI441_INTERNAL::readLittleEndian16( file.data + 26 );
+	const unsigned int bpp = CSCI441_INTERNAL::readLittleEndian16( file.data + 28 );
+	const unsigned int compression = CSCI441_INTERNAL::readLittleEndian32( file.data + 30 );
+
+	const char *error = NULL;
+	if( infoSize < 40 )		error = "[.bmp]: [ERROR]: %s uses an unsupported header.\n";
+	else if( planes != 1 )		error = "[.bmp]: [ERROR]: Planes from %s is not 1.\n";
+	else if( bpp != 24 )		error = "[.bmp]: [ERROR]: Bpp from %s is not 24.\n";
+	else if( compression != 0 )	error = "[.bmp]: [ERROR]: %s is compressed.\n";
+	else if( width <= 0 || height == 0 || width > 65535 || height > 65535 || height < -65535 )
+		error = "[.bmp]: [ERROR]: %s has an invalid size.\n";
+	if( error ) {
+		printf( error, filename );
+		CSCI441_INTERNAL::unmapFile( file );
+		return false;
+	}
+
+	// rows are padded to four bytes and stored bottom up unless the height is negative
+	const bool topDown = height < 0;
+	const size_t numRows = topDown ? -height : height;
+	const size_t rowBytes = (size_t)width * 3;
+	const size_t stride = ( rowBytes + 3 ) & ~(size_t)3;
+	if( dataOffset > file.size || file.size - dataOffset < stride * ( numRows - 1 ) + rowBytes ) {
+		printf("[.bmp]: [ERROR]: reading image data from %s.\n", filename);
+		CSCI441_INTERNAL::unmapFile( file );
+		return false;
+	}
+
+	// reverse all of the colors (bgr -> rgb) while copying each row into place
+	imageData = new unsigned char[rowBytes * numRows];
+	for( size_t row = 0; row < numRows; row++ ) {
+		const size_t destinationRow = topDown ? numRows - 1 - row : row;
+		CSCI441::ImageKernels::swapRedBlue( file.data + dataOffset + row * stride, imageData + destinationRow * rowBytes, width, 3 );
+	}
+	CSCI441_INTERNAL::unmapFile( file );
+
+	imageWidth = width;
+	imageHeight = (int)numRows;
+	imageChannels = 3;
+
+	return true;
+}
+
+// loadPPM() //////////////////////////////////////////////////////////////////
+//
+// Load a P3 or P6 PPM as 8-bit RGB
+//
+////////////////////////////////////////////////////////////////////////////////
+inline bool CSCI441::TextureUtils::loadPPM( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData ) {
+	imageData = NULL;
+
+	PPMImage image;
+	if( !image.load( filename ) ) {
+		return false;
+	}
+
+	imageWidth = image.getWidth();
+	imageHeight = image.getHeight();
+	const size_t numSamples = (size_t)imageWidth * imageHeight * 3;
+	imageData = new unsigned char[numSamples];
+
+	if( image.getType() == GL_UNSIGNED_BYTE ) {
+		memcpy( imageData, image.getPixels(), numSamples );
+	} else {
+		// round sixteen bit samples to the nearest eight bit value
+		const unsigned char *bytes = (const unsigned char*)image.getPixels();
+		const unsigned short *samples = (const unsigned short*)image.getPixels();
+		const bool bigEndian = image.isBigEndian();
+		for( size_t i = 0; i < numSamples; i++ ) {
+			unsigned int value = bigEndian ? ( bytes[2*i] << 8 ) | bytes[2*i+1] : samples[i];
+			imageData[i] = (unsigned char)( ( value * 255 + 32767 ) / 65535 );
+		}
+	}
+
+	return true;
+}
+
+// writePPM() /////////////////////////////////////////////////////////////////
+//
+// Save 8-bit RGB as a binary P6 PPM
+//
+////////////////////////////////////////////////////////////////////////////////
+inline bool CSCI441::TextureUtils::writePPM( const char *filename, int imageWidth, int imageHeight, const unsigned char *imageData ) {
+	FILE *fp = fopen( filename, "wb" );
+	if( !fp ) {
+		fprintf( stderr, "Error: could not create PPM file: %s.\n", filename );
+		return false;
+	}
+
+	const size_t size = (size_t)imageWidth * imageHeight * 3;
+	bool written = fprintf( fp, "P6\n%d %d\n255\n", imageWidth, imageHeight ) > 0;
+	written = written && fwrite( imageData, 1, size, fp ) == size;
+	if( fclose( fp ) != 0 ) {
+		written = false;
+	}
+
+	if( !written ) {
+		fprintf( stderr, "Error: could not write PPM file: %s.\n", filename );
+	}
+	return written;
+}
+
+inline CSCI441::TextureUtils::PPMImage::PPMImage() {
+	_file.data = NULL;
+	_file.size = 0;
+	_file.mapped = false;
+	release();
+}
+
+inline CSCI441::TextureUtils::PPMImage::~PPMImage() {
+	release();
+}
+
+inline bool CSCI441::TextureUtils::PPMImage::load( const char *filename ) {
+	release();
+
+	if( !CSCI441_INTERNAL::mapFile( filename, _file ) ) {
+		fprintf( stderr, "Error: could not open PPM file: %s.\n", filename );
+		return false;
+	}
+
+	int format;
+	size_t rasterOffset;
+	if( !CSCI441_INTERNAL::readPPMHeader( _file, format, _width, _height, _maxValue, rasterOffset ) ) {
+		fprintf( stderr, "Error: %s is not a P3 or P6 PPM file.\n", filename );
+		release();
+		return false;
+	}
+
+	const size_t numSamples = (size_t)_width * _height * 3;
+	const size_t sampleBytes = _maxValue > 255 ? 2 : 1;
+	const unsigned char *raster = _file.data + rasterOffset;
+	const unsigned char *end = _file.data + _file.size;
+	_type = sampleBytes == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+	_size = numSamples * sampleBytes;
+
+	// P3 samples take at least two characters each, P6 samples exactly their bytes
+	if( (size_t)( end - raster ) < ( format == 6 ? _size : 2 * numSamples - 1 ) ) {
+		fprintf( stderr, "Error: PPM file %s ends before its pixels do.\n", filename );
+		release();
+		return false;
+	}
+
+	if( format == 6 ) {
+		// full range samples are already what OpenGL takes
+		if( _maxValue == 255 || _maxValue == 65535 ) {
+			_pixels = raster;
+			_bigEndian = sampleBytes == 2;
+			return true;
+		}
+
+		_decoded.resize( _size );
+		if( sampleBytes == 1 ) {
+			memcpy( &_decoded[0], raster, _size );
+			CSCI441_INTERNAL::scalePPMSamples( &_decoded[0], numSamples, _maxValue, 255 );
+		} else {
+			unsigned short *samples = (unsigned short*)&_decoded[0];
+			for( size_t i = 0; i < numSamples; i++ ) {
+				unsigned int value = ( raster[2*i] << 8 ) | raster[2*i+1];
+				samples[i] = (unsigned short)( value > _maxValue ? _maxValue : value );
+			}
+			CSCI441_INTERNAL::scalePPMSamples( samples, numSamples, _maxValue, 65535 );
+		}
+	} else {
+		// comments may also sit between P3 samples; blank them out of a copy so the scanner never sees them
+		vector< unsigned char > text;
+		if( memchr( raster, '#', end - raster ) ) {
+			text.assign( raster, end );
+			for( size_t i = 0; i < text.size(); i++ ) {
+				if( text[i] == '#' ) {
+					for( ; i < text.size() && text[i] != '\n' && text[i] != '\r'; i++ ) {
+						text[i] = ' ';
+					}
+				}
+			}
+			raster = &text[0];
+			end = raster + text.size();
+		}
+
+		_decoded.resize( _size );
+		size_t numRead;
+		if( sampleBytes == 1 ) {
+			numRead = CSCI441_INTERNAL::scanPPMSamples( raster, end, &_decoded[0], numSamples, _maxValue );
+			if( _maxValue != 255 ) CSCI441_INTERNAL::scalePPMSamples( &_decoded[0], numSamples, _maxValue, 255 );
+		} else {
+			unsigned short *samples = (unsigned short*)&_decoded[0];
+			numRead = CSCI441_INTERNAL::scanPPMSamples( raster, end, samples, numSamples, _maxValue );
+			if( _maxValue != 65535 ) CSCI441_INTERNAL::scalePPMSamples( samples, numSamples, _maxValue, 65535 );
+		}
+
+		if( numRead < numSamples ) {
+			fprintf( stderr, "Error: PPM file %s ends before its pixels do.\n", filename );
+			release();
+			return false;
+		}
+	}
+
+	// decoded pixels no longer need the file
+	CSCI441_INTERNAL::unmapFile( _file );
+	_pixels = &_decoded[0];
+	_bigEndian = false;
+	return true;
+}
+
+inline void CSCI441::TextureUtils::PPMImage::release() {
+	CSCI441_INTERNAL::unmapFile( _file );
+	vector< unsigned char >().swap( _decoded );
+	_width = _height = 0;
+	_maxValue = 0;
+	_type = GL_UNSIGNED_BYTE;
+	_bigEndian = false;
+	_pixels = NULL;
+	_size = 0;
+}
+
+inline int CSCI441::TextureUtils::PPMImage::getWidth() const {
+	return _width;
+}
+
+inline int CSCI441::TextureUtils::PPMImage::getHeight() const {
+	return _height;
+}
+
+inline unsigned int CSCI441::TextureUtils::PPMImage::getMaxValue() const {
+	return _maxValue;
+}
+
+inline GLenum CSCI441::TextureUtils::PPMImage::getType() const {
+	return _type;
+}
+
+inline bool CSCI441::TextureUtils::PPMImage::isBigEndian() const {
+	return _bigEndian;
+}
+
+inline bool CSCI441::TextureUtils::PPMImage::isMapped() const {
+	return _pixels != NULL && _decoded.empty();
+}
+
+inline const void* CSCI441::TextureUtils::PPMImage::getPixels() const {
+	return _pixels;
+}
+
+inline size_t CSCI441::TextureUtils::PPMImage::getSize() const {
+	return _size;
+}
+
+inline void CSCI441::TextureUtils::PPMImage::upload( GLenum target, GLint level ) const {
+	GLint alignment, swapBytes;
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &alignment );
+	glGetIntegerv( GL_UNPACK_SWAP_BYTES, &swapBytes );
+
+	// RGB rows are packed and big endian samples must be swapped on little endian machines
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	glPixelStorei( GL_UNPACK_SWAP_BYTES, _bigEndian && CSCI441_INTERNAL::isLittleEndian() ? GL_TRUE : GL_FALSE );
+	glTexImage2D( target, level, _type == GL_UNSIGNED_SHORT ? GL_RGB16 : GL_RGB8, _width, _height, 0, GL_RGB, _type, _pixels );
+
+	glPixelStorei( GL_UNPACK_ALIGNMENT, alignment );
+	glPixelStorei( GL_UNPACK_SWAP_BYTES, swapBytes );
+}
+
+// loadTGA() //////////////////////////////////////////////////////////////////
+//
+// Load a 24 or 32-bit TGA, uncompressed or RLE, as RGB or RGBA
+//
+////////////////////////////////////////////////////////////////////////////////
+inline bool CSCI441::TextureUtils::loadTGA(const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData, int &imageChannels ) {
+	imageData = NULL;
+
+	CSCI441_INTERNAL::MappedFile file;
+	if( !CSCI441_INTERNAL::mapFile( filename, file ) ) {
+		fprintf(stderr, "Error: could not open TGA file: %s.\n", filename);
+		return false;
+	}
+	if( file.size < 18 ) {
+		fprintf(stderr, "Error: TGA file %s ends before its header does.\n", filename);
+		CSCI441_INTERNAL::unmapFile( file );
+		return false;
+	}
+
+	//the fields of the file header we need, all little endian
+	const unsigned char idLength = file.data[0];
+	const unsigned char colorMapType = file.data[1];
+	const unsigned char imageType = file.data[2];
+	const unsigned int width = CSCI441_INTERNAL::readLittleEndian16( file.data + 12 );
+	const unsigned int height = CSCI441_INTERNAL::readLittleEndian16( file.data + 14 );
+	const unsigned char bitsPerPixel = file.data[16];
+	const unsigned char imageAttributeFlags = file.data[17];
+
+	//now check to make sure that we actually have the capability to read this file.
+	bool supported = false;
+	if(colorMapType != 0) {
+		fprintf(stderr, "Error: TGA file (%s) uses colormap instead of RGB/RGBA data; this is unsupported.\n", filename);
+	} else if(imageType != 2 && imageType != 10) {
+		fprintf(stderr, "Error: unspecified TGA type: %d. Only supports 2 (uncompressed RGB/A) and 10 (RLE, RGB/A).\n", imageType);
+	} else if(bitsPerPixel != 24 && bitsPerPixel != 32) {
+		fprintf(stderr, "Error: unsupported image depth (%d bits per pixel). Only supports 24bpp and 32bpp.\n", bitsPerPixel);
+	} else if(width == 0 || height == 0) {
+		fprintf(stderr, "Error: TGA file (%s) is empty.\n", filename);
+	} else {
+		supported = true;
+	}
+	if( !supported ) {
+		CSCI441_INTERNAL::unmapFile( file );
+		return false;
+	}
+
+	//set some helpful variables based on the header information:
+	const bool usingRLE = (imageType == 10);              //whether the file uses run-length encoding (compression)
+	const unsigned int channels = bitsPerPixel / 8;       //whether the file is RGB or RGBA (RGBA = 32bpp)
+	const bool topLeft = (imageAttributeFlags & 32) != 0; //whether the origin is at the top-left or bottom-left
+
+	//the pixels follow the image id.  before allocating, make sure the file could hold them:
+	//raw pixels take all their bytes, and an RLE packet covers at most 128 pixels
+	const size_t numPixels = (size_t)width * height;
+	const size_t pixelBytes = 18u + idLength <= file.size ? file.size - 18 - idLength : 0;
+	const size_t minimumBytes = usingRLE ? ( numPixels + 127 ) / 128 * ( 1 + channels ) : numPixels * channels;
+	if( pixelBytes < minimumBytes ) {
+		fprintf(stderr, "Error: TGA file %s ends before its pixels do.\n", filename);
+		CSCI441_INTERNAL::unmapFile( file );
+		return false;
+	}
+
+	//each row lands the right way up as it is decoded
+	imageData = new unsigned char[numPixels * channels];
+	const bool complete = CSCI441_INTERNAL::decodeTGA( file.data + 18 + idLength, file.data + file.size, imageData, width, height, channels, topLeft, usingRLE );
+	CSCI441_INTERNAL::unmapFile( file );
+
+	if( !complete ) {
+		fprintf(stderr, "Error: TGA file %s ends before its pixels do.\n", filename);
+		delete[] imageData;
+		imageData = NULL;
+		return false;
+	}
+
+	imageWidth = width;
+	imageHeight = height;
+	imageChannels = channels;
+	return true;
+}
+
+inline CSCI441::TextureUtils::MipmapChain::MipmapChain() {
+	_channels = 0;
+	_buildTime = 0.0;
+}
+
+inline void CSCI441::TextureUtils::MipmapChain::build( const unsigned char *pixels, int width, int height, int channels, bool srgb, ImageKernels::MipmapFilter filter ) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	_channels = channels;
+	_widths.assign( 1, width );
+	_heights.assign( 1, height );
+	_levels.assign( 1, vector< unsigned char >( pixels, pixels + (size_t)width * height * channels ) );
+
+	// filter in linear light, keeping every level as floats until the next has been made from it
+	vector< float > current( (size_t)width * height * channels ), next;
+	if( srgb ) {
+		ImageKernels::srgbToLinear( pixels, &current[0], (size_t)width * height, channels );
+	} else {
+		for( size_t i = 0; i < current.size(); i++ ) current[i] = pixels[i] * ( 1.0f / 255.0f );
+	}
+
+	while( width > 1 || height > 1 ) {
+		const int nextWidth = width > 1 ? width / 2 : 1;
+		const int nextHeight = height > 1 ? height / 2 : 1;
+		next.resize( (size_t)nextWidth * nextHeight * channels );
+		ImageKernels::downsample( &current[0], width, height, &next[0], channels, filter );
+
+		_levels.push_back( vector< unsigned char >( next.size() ) );
+		unsigned char *level = &_levels.back()[0];
+		if( srgb ) {
+			ImageKernels::linearToSrgb( &next[0], level, (size_t)nextWidth * nextHeight, channels );
+		} else {
+			for( size_t i = 0; i < next.size(); i++ ) {
+				const float value = next[i] > 0.0f ? ( next[i] < 1.0f ? next[i] : 1.0f ) : 0.0f;
+				level[i] = (unsigned char)( value * 255.0f + 0.5f );
+			}
+		}
+
+		width = nextWidth;
+		height = nextHeight;
+		_widths.push_back( width );
+		_heights.push_back( height );
+		current.swap( next );
+	}
+
+	_buildTime = chrono::duration< double, milli >( chrono::steady_clock::now() - start ).count();
+}
+
+inline void CSCI441::TextureUtils::MipmapChain::upload( GLenum target, GLenum minFilter ) const {
+	const GLenum format = getFormat();
+
+	// small levels of RGB images have rows that are not a multiple of four bytes
+	GLint alignment;
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &alignment );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	for( size_t level = 0; level < _levels.size(); level++ ) {
+		glTexImage2D( target, (GLint)level, format, _widths[level], _heights[level], 0, format, GL_UNSIGNED_BYTE, &_levels[level][0] );
+	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, alignment );
+
+	// a cube map face is specified on its own but its parameters belong to the whole cube
+	const GLenum parameterTarget = CSCI441_INTERNAL::textureParameterTarget( target );
+	glTexParameteri( parameterTarget, GL_TEXTURE_MAX_LEVEL, (GLint)_levels.size() - 1 );
+	glTexParameteri( parameterTarget, GL_TEXTURE_MIN_FILTER, minFilter );
+}
+
+inline int CSCI441::TextureUtils::MipmapChain::getNumLevels() const {
+	return (int)_levels.size();
+}
+
+inline int CSCI441::TextureUtils::MipmapChain::getWidth( int level ) const {
+	return _widths[level];
+}
+
+inline int CSCI441::TextureUtils::MipmapChain::getHeight( int level ) const {
+	return _heights[level];
+}
+
+inline int CSCI441::TextureUtils::MipmapChain::getChannels() const {
+	return _channels;
+}
+
+inline GLenum CSCI441::TextureUtils::MipmapChain::getFormat() const {
+	static const GLenum FORMATS[4] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	return FORMATS[_channels - 1];
+}
+
+inline const unsigned char* CSCI441::TextureUtils::MipmapChain::getLevel( int level ) const {
+	return &_levels[level][0];
+}
+
+inline size_t CSCI441::TextureUtils::MipmapChain::getSize() const {
+	size_t size = 0;
+	for( size_t level = 0; level < _levels.size(); level++ ) {
+		size += _levels[level].size();
+	}
+	return size;
+}
+
+inline double CSCI441::TextureUtils::MipmapChain::getBuildTime() const {
+	return _buildTime;
+}
+
+// loadAndRegisterTexture() ////////////////////////////////////////////////////
+//
+// Load and register a texture with OpenGL
+//
+////////////////////////////////////////////////////////////////////////////////
+inline GLuint CSCI441::TextureUtils::loadAndRegisterTexture( const char *filename, GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT ) {
+	return loadAndRegister2DTexture( filename, minFilter, magFilter, wrapS, wrapT );
+}
+
+// loadAndRegister2DTexture() ////////////////////////////////////////////////////
+//
+// Load and register a 2D texture with OpenGL
+//
+////////////////////////////////////////////////////////////////////////////////
+inline GLuint CSCI441::TextureUtils::loadAndRegister2DTexture( const char *filename, GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT ) {
+	GLuint texHandle = SOIL_load_OGL_texture( filename,
+																					 SOIL_LOAD_AUTO,
+																					 SOIL_CREATE_NEW_ID,
+																					 SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT );
+
+	if( texHandle == 0 ) {
+			printf( "[ERROR]: Could not load texture \"%s\"\n[SOIL]: %s\n", filename, SOIL_last_result() );
+	} else {
+			printf( "[INFO]: Successfully loaded texture \"%s\"\n[SOIL]: %s\n", filename, SOIL_last_result() );
+			glBindTexture(   GL_TEXTURE_2D,  texHandle );
+			glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MIN_FILTER, minFilter );
+			glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MAG_FILTER, magFilter );
+			glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_S,     wrapS );
+			glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_T,     wrapT );
+	}
+
+	return texHandle;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function implementations
+
+inline bool CSCI441_INTERNAL::mapFile( const char *filename, MappedFile &file ) {
+	file.data = NULL;
+	file.size = 0;
+	file.mapped = false;
+
+#ifdef _WIN32
+	file.file = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if( file.file == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+	file.mapping = NULL;
+	LARGE_INTEGER size;
+	if( GetFileSizeEx( file.file, &size ) && size.QuadPart > 0 ) {
+		file.mapping = CreateFileMappingA( file.file, NULL, PAGE_READONLY, 0, 0, NULL );
+		if( file.mapping ) {
+			file.data = (const unsigned char*)MapViewOfFile( file.mapping, FILE_MAP_READ, 0, 0, 0 );
+		}
+	}
+	if( file.data ) {
+		file.size = (size_t)size.QuadPart;
+		file.mapped = true;
+		return true;
+	}
+	if( file.mapping ) CloseHandle( file.mapping );
+	CloseHandle( file.file );
+#else
+	int fd = open( filename, O_RDONLY );
+	if( fd < 0 ) {
+		return false;
+	}
+	struct stat info;
+	if( fstat( fd, &info ) == 0 && info.st_size > 0 ) {
+		void *data = mmap( NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( data != MAP_FAILED ) {
+			file.data = (const unsigned char*)data;
+			file.size = (size_t)info.st_size;
+			file.mapped = true;
+		}
+	}
+	close( fd );
+	if( file.mapped ) {
+		return true;
+	}
+#endif
+
+	// empty files and devices that cannot be mapped are read instead
+	FILE *fp = fopen( filename, "rb" );
+	if( !fp ) {
+		return false;
+	}
+	size_t capacity = 65536, size = 0;
+	unsigned char *buffer = (unsigned char*)malloc( capacity );
+	while( buffer ) {
+		size += fread( buffer + size, 1, capacity - size, fp );
+		if( size < capacity ) break;
+		capacity *= 2;
+		unsigned char *grown = (unsigned char*)realloc( buffer, capacity );
+		if( !grown ) free( buffer );
+		buffer = grown;
+	}
+	fclose( fp );
+
+	file.data = buffer;
+	file.size = size;
+	return buffer != NULL;
+}
+
+inline void CSCI441_INTERNAL::unmapFile( MappedFile &file ) {
+	if( file.mapped ) {
+#ifdef _WIN32
+		UnmapViewOfFile( file.data );
+		CloseHandle( file.mapping );
+		CloseHandle( file.file );
+#else
+		munmap( (void*)file.data, file.size );
+#endif
+	} else {
+		free( (void*)file.data );
+	}
+	file.data = NULL;
+	file.size = 0;
+	file.mapped = false;
+}
+
+inline bool CSCI441_INTERNAL::isLittleEndian() {
+	const unsigned short one = 1;
+	return *(const unsigned char*)&one == 1;
+}
+
+inline bool CSCI441_INTERNAL::readPPMHeader( const MappedFile &file, int &format, int &width, int &height, unsigned int &maxValue, size_t &rasterOffset ) {
+	if( file.size < 2 || file.data[0] != 'P' || ( file.data[1] != '3' && file.data[1] != '6' ) ) {
+		return false;
+	}
+	format = file.data[1] - '0';
+
+	size_t offset = 2;
+	unsigned int w, h;
+	if( !readPPMHeaderValue( file.data, file.size, offset, w )
+		|| !readPPMHeaderValue( file.data, file.size, offset, h )
+		|| !readPPMHeaderValue( file.data, file.size, offset, maxValue ) ) {
+		return false;
+	}
+	if( w == 0 || h == 0 || w > PPM_MAX_DIMENSION || h > PPM_MAX_DIMENSION || maxValue == 0 || maxValue > 65535 ) {
+		return false;
+	}
+
+	// a single whitespace character separates the header from the raster
+	if( offset == file.size || !isspace( file.data[offset] ) ) {
+		return false;
+	}
+	width = (int)w;
+	height = (int)h;
+	rasterOffset = offset + 1;
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::readPPMHeaderValue( const unsigned char *data, size_t size, size_t &offset, unsigned int &value ) {
+	// whitespace and comments may come before each value
+	while( offset < size ) {
+		if( data[offset] == '#' ) {
+			while( offset < size && data[offset] != '\n' && data[offset] != '\r' ) offset++;
+		} else if( isspace( data[offset] ) ) {
+			offset++;
+		} else {
+			break;
+		}
+	}
+
+	if( offset == size || (unsigned int)( data[offset] - '0' ) > 9 ) {
+		return false;
+	}
+	value = 0;
+	while( offset < size && (unsigned int)( data[offset] - '0' ) <= 9 ) {
+		if( value > 100000000 ) return false;
+		value = value * 10 + ( data[offset++] - '0' );
+	}
+	return true;
+}
+
+template< typename T >
+inline size_t CSCI441_INTERNAL::scanPPMSamples( const unsigned char *text, const unsigned char *end, T *samples, size_t numSamples, unsigned int maxValue ) {
+	const unsigned char *p = text;
+	size_t n = 0;
+	bool inNumber = false;		// whether the character before p is a digit
+
+	// 64 characters at a time: mark every digit, find where each number starts, then
+	// convert the numbers independently of one another
+	while( n < numSamples && end - p >= 72 ) {
+		unsigned long long digits = 0;
+		for( unsigned int k = 0; k < 8; k++ ) {
+			const unsigned long long high = ~ppmNonDigits( loadPPMWord( p + 8*k ) ) & 0x8080808080808080ULL;
+			digits |= ( ( ( high >> 7 ) * 0x0102040810204080ULL ) >> 56 ) << ( 8*k );
+		}
+		unsigned long long starts = digits & ~( ( digits << 1 ) | ( inNumber ? 1ULL : 0ULL ) );
+		inNumber = ( digits >> 63 ) != 0;
+
+		while( starts && n < numSamples ) {
+			const unsigned char *number = p + ppmCountTrailingZeros( starts );
+			starts &= starts - 1;
+			samples[n++] = (T)readPPMNumber( number, end, maxValue );
+		}
+		p += 64;
+	}
+
+	// the last few characters go one at a time so no word reads past the end
+	if( inNumber ) {
+		while( p < end && (unsigned int)( *p - '0' ) <= 9 ) p++;
+	}
+	while( n < numSamples ) {
+		while( p < end && (unsigned int)( *p - '0' ) > 9 ) p++;
+		if( p == end ) break;
+		unsigned int value = 0;
+		for( ; p < end && (unsigned int)( *p - '0' ) <= 9; p++ ) {
+			if( value <= maxValue ) value = value * 10 + ( *p - '0' );
+		}
+		samples[n++] = (T)( value > maxValue ? maxValue : value );
+	}
+	return n;
+}
+
+inline unsigned int CSCI441_INTERNAL::readPPMNumber( const unsigned char *number, const unsigned char *end, unsigned int maxValue ) {
+	unsigned int value = 0;
+	const unsigned long long nonDigits = ppmNonDigits( loadPPMWord( number ) );
+	if( nonDigits ) {
+		value = ppmParseDigits( loadPPMWord( number ), ppmCountTrailingZeros( nonDigits ) >> 3 );
+	} else {
+		// eight or more digits, most likely leading zeros
+		for( ; number < end && (unsigned int)( *number - '0' ) <= 9; number++ ) {
+			if( value <= maxValue ) value = value * 10 + ( *number - '0' );
+		}
+	}
+	return value > maxValue ? maxValue : value;
+}
+
+inline bool CSCI441_INTERNAL::decodeTGA( const unsigned char *data, const unsigned char *end, unsigned char *imageData, size_t width, size_t height, unsigned int channels, bool topLeft, bool usingRLE ) {
+	const size_t rowBytes = width * channels;
+
+	if( !usingRLE ) {
+		if( (size_t)( end - data ) / rowBytes < height ) {
+			return false;
+		}
+		for( size_t row = 0; row < height; row++ ) {
+			const size_t destinationRow = topLeft ? row : height - 1 - row;
+			CSCI441::ImageKernels::swapRedBlue( data + row * rowBytes, imageData + destinationRow * rowBytes, width, channels );
+		}
+		return true;
+	}
+
+	//packets may run across rows, so each is split wherever a row ends
+	size_t row = 0, column = 0;
+	while( row < height ) {
+		if( data == end ) {
+			return false;
+		}
+		const bool isRLEPacket = ( *data & 0x80 ) != 0;
+		size_t count = ( *data & 0x7F ) + 1;
+		data++;
+
+		//a run repeats its single pixel, raw packets carry every pixel
+		const size_t packetBytes = isRLEPacket ? channels : count * channels;
+		if( (size_t)( end - data ) < packetBytes ) {
+			return false;
+		}
+
+		while( count > 0 && row < height ) {
+			const size_t span = count < width - column ? count : width - column;
+			unsigned char *destination = imageData + ( topLeft ? row : height - 1 - row ) * rowBytes + column * channels;
+			if( isRLEPacket ) {
+				CSCI441::ImageKernels::swapRedBlue( data, destination, 1, channels );
+				fillPixels( destination, span, channels );
+			} else {
+				CSCI441::ImageKernels::swapRedBlue( data, destination, span, channels );
+				data += span * channels;
+			}
+			count -= span;
+			column += span;
+			if( column == width ) {
+				column = 0;
+				row++;
+			}
+		}
+		if( isRLEPacket ) {
+			data += channels;
+		}
+	}
+	return true;
+}
+
+inline void CSCI441_INTERNAL::fillPixels( unsigned char *pixels, size_t numPixels, unsigned int channels ) {
+	// the first pixel is in place; keep doubling the filled part until the run is complete
+	size_t filled = 1;
+	while( filled < numPixels ) {
+		const size_t copied = filled < numPixels - filled ? filled : numPixels - filled;
+		memcpy( pixels + filled * channels, pixels, copied * channels );
+		filled += copied;
+	}
+}
+
+inline unsigned int CSCI441_INTERNAL::readLittleEndian16( const unsigned char *bytes ) {
+	return bytes[0] | ( bytes[1] << 8 );
+}
+
+inline unsigned int CSCI441_INTERNAL::readLittleEndian32( const unsigned char *bytes ) {
+	return bytes[0] | ( bytes[1] << 8 ) | ( bytes[2] << 16 ) | ( (unsigned int)bytes[3] << 24 );
+}
+
+template< typename T >
+inline void CSCI441_INTERNAL::scalePPMSamples( T *samples, size_t numSamples, unsigned int maxValue, unsigned int fullValue ) {
+	const unsigned int half = maxValue / 2;
+	for( size_t i = 0; i < numSamples; i++ ) {
+		samples[i] = (T)( ( samples[i] * fullValue + half ) / maxValue );
+	}
+}
+
+inline unsigned long long CSCI441_INTERNAL::loadPPMWord( const unsigned char *text ) {
+	// eight characters with the first in the lowest byte
+	unsigned long long word;
+	memcpy( &word, text, 8 );
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	word = __builtin_bswap64( word );
+#endif
+	return word;
+}
+
+inline unsigned long long CSCI441_INTERNAL::ppmNonDigits( unsigned long long word ) {
+	// digits become 0-9 and everything else 10 or more; adding 0x76 sets the high bit of exactly those
+	const unsigned long long values = word ^ 0x3030303030303030ULL;
+	return ( ( ( values & 0x7F7F7F7F7F7F7F7FULL ) + 0x7676767676767676ULL ) | values ) & 0x8080808080808080ULL;
+}
+
+inline unsigned int CSCI441_INTERNAL::ppmParseDigits( unsigned long long word, unsigned int length ) {
+	// shift the 1-7 digits to the top so the bytes below act as leading zeros, then
+	// combine neighbouring digits, pairs, and quads with one multiply each
+	word <<= 8 * ( 8 - length );
+	word = ( ( word & 0x0F0F0F0F0F0F0F0FULL ) * 2561 ) >> 8;
+	word = ( ( word & 0x00FF00FF00FF00FFULL ) * 6553601 ) >> 16;
+	return (unsigned int)( ( ( word & 0x0000FFFF0000FFFFULL ) * 42949672960001ULL ) >> 32 );
+}
+
+inline unsigned int CSCI441_INTERNAL::ppmCountTrailingZeros( unsigned long long bits ) {
+#if defined(__GNUC__)
+	return __builtin_ctzll( bits );
+#else
+	unsigned int count = 0;
+	for( ; !( bits & 1 ); bits >>= 1 ) count++;
+	return count;
+#endif
+}
+
+inline GLenum CSCI441_INTERNAL::textureParameterTarget( GLenum target ) {
+	if( target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z )
+		return GL_TEXTURE_CUBE_MAP;
+	return target;
+}
+
+#endif // __CSCI441_TEXTUREUTILS_H__
@@ -0,0 +1,558 @@
+/** @file bezierPatch3.hpp
+  * @brief Tessellates and draws bicubic Bezier patches with OpenGL 3.0+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	This class holds a set of bicubic Bezier patches that share a pool of
+	*	control points.  The patches can be tessellated at any resolution; each
+	*	resolution is evaluated once, with normals from the surface partial
+	*	derivatives, and the resulting mesh is kept on both the CPU and GPU.
+	*	Samples shared along patch seams are welded into a single vertex, and
+	*	the GPU copy is one interleaved float VBO with 16 bit indices whenever
+	*	the vertex count allows.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.0+
+	*	@warning NOTE: This header file depends upon GLEW
+	*	@warning NOTE: This header file depends upon glm
+	*	@warning NOTE: Large tessellations are split across std::thread workers.  Define
+	*	CSCI441_NO_THREADS before including this file on toolchains without std::thread support
+  */
+
+#ifndef __CSCI441_BEZIERPATCH_3_HPP__
+#define __CSCI441_BEZIERPATCH_3_HPP__
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <assert.h>
+#include <math.h>
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <functional>
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	struct BezierBasisTable;
+}
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @class BezierPatchSet
+		* @brief Bicubic Bezier patches tessellated on demand and rendered using VBOs/VAOs
+		*/
+	class BezierPatchSet {
+	public:
+		/** @struct Mesh
+			* @brief Tessellated patches with the samples along shared seams welded together
+			*
+			* @var positions		- surface position of each vertex
+			* @var normals			- unit surface normal of each vertex
+			* @var texCoords		- texture coordinate of each vertex
+			* @var indices			- GL_TRIANGLES indices, two triangles per grid cell
+			* @var edgeIndices	- GL_LINES indices along the sample grid, each edge listed once
+			*/
+		struct Mesh {
+			std::vector< glm::vec3 > positions;
+			std::vector< glm::vec3 > normals;
+			std::vector< glm::vec2 > texCoords;
+			std::vector< GLuint > indices;
+			std::vector< GLuint > edgeIndices;
+		};
+
+		/** @brief Creates a set of patches
+			*
+			*	Each patch is 16 indices into the control points, in row major order with
+			*	the first index varying along u and the second along v.  Normals point along
+			*	dP/du x dP/dv.
+			*
+			*	Each patch maps (u, v) linearly onto a texture rectangle (s0, t0, s1, t1), the
+			*	whole texture by default.  Seam samples are only welded when their texture
+			*	coordinates agree, so give neighboring patches adjoining rectangles for them to
+			*	share vertices.
+			*
+			* @param const std::vector<glm::vec3>& controlPoints	- pool of control points shared by the patches
+			* @param const std::vector<GLuint>& patchIndices				- 16 control point indices per patch
+			* @param const std::vector<glm::vec4>& patchTexCoords	- optional texture rectangle per patch
+			* @pre patchIndices must hold a multiple of 16 indices
+			* @pre patchTexCoords must be empty or hold one rectangle per patch
+			*/
+		BezierPatchSet( const std::vector< glm::vec3 > &controlPoints, const std::vector< GLuint > &patchIndices,
+										const std::vector< glm::vec4 > &patchTexCoords = std::vector< glm::vec4 >() );
+		/** @brief Frees memory associated with the patches on both CPU and GPU
+			*/
+		~BezierPatchSet();
+
+		/** @brief Tessellates every patch into a res x res grid of samples
+			*
+			*	The mesh for each resolution is computed once and cached.
+			*
+			* @param GLint resolution	- number of samples along each side of a patch
+			* @return tessellated mesh of all the patches
+			* @pre resolution must be greater than one
+			*/
+		const Mesh& tessellate( GLint resolution );
+		/** @brief Renders the patches at the given resolution
+			*
+			*	Each resolution is uploaded once and each set of attribute locations gets its
+			*	own VAO, so repeated draws only bind and draw.  A location of -1 is left disabled.
+			*
+			* @param GLint resolution				- number of samples along each side of a patch
+			* @param GLint positionLocation	- attribute location of vertex position
+			* @param GLint normalLocation		- attribute location of vertex normal
+			* @param GLint texCoordLocation	- attribute location of vertex texture coordinate
+			* @param GLenum renderMode				- GL_FILL to draw the surface or GL_LINE to draw the sample grid
+			* @pre resolution must be greater than one
+			*/
+		void draw( GLint resolution, GLint positionLocation, GLint normalLocation = -1, GLint texCoordLocation = -1, GLenum renderMode = GL_FILL );
+
+		/** @brief Returns the number of patches in the set
+			* @return number of patches
+			*/
+		GLuint getNumPatches() const;
+
+	private:
+		struct BufferData {
+			GLuint vbod, ibod, edgeIbod;
+			GLsizei numVertices, numIndices, numEdgeIndices;
+			GLenum indexType;
+		};
+		struct VAOData {
+			GLint resolution, p, n, t;
+			bool operator<( const VAOData rhs ) const {
+				if( resolution != rhs.resolution ) return resolution < rhs.resolution;
+				if( p != rhs.p ) return p < rhs.p;
+				if( n != rhs.n ) return n < rhs.n;
+				return t < rhs.t;
+			}
+		};
+
+		void _tessellatePatches( const CSCI441_INTERNAL::BezierBasisTable &table, GLuint firstPatch, GLuint patchStep, GLint resolution, Mesh *mesh ) const;
+		void _weldSeams( Mesh *mesh ) const;
+		const BufferData& _uploadMesh( GLint resolution );
+		void _bindVAO( GLint resolution, const BufferData &bufferData, GLint positionLocation, GLint normalLocation, GLint texCoordLocation );
+
+		std::vector< glm::vec3 > _controlPoints;
+		std::vector< GLuint > _patchIndices;
+		std::vector< glm::vec4 > _patchTexCoords;
+
+		std::map< GLint, Mesh > _meshes;
+		std::map< GLint, BufferData > _buffers;
+		std::map< VAOData, GLuint > _vaos;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	// cubic Bernstein basis and its derivative sampled at res evenly spaced parameters,
+	// stored per basis function so a sample's four weights are a column of b (or db)
+	struct BezierBasisTable {
+		std::vector< GLfloat > b[4], db[4];
+	};
+	void evaluateBezierBasis( GLfloat t, GLfloat b[4], GLfloat db[4] );
+	const BezierBasisTable& getBezierBasisTable( GLint resolution );
+
+	// below this many samples a tessellation is not worth spreading across threads
+	static const GLuint BEZIER_THREAD_MIN_SAMPLES = 16384;
+
+	// seam samples closer than this are the same point, and get one vertex if their
+	// normals are within about 10 degrees and their texture coordinates match
+	static const GLfloat BEZIER_WELD_DISTANCE = 1e-4f;
+	static const GLfloat BEZIER_WELD_NORMAL_DOT = 0.985f;
+	static const GLfloat BEZIER_WELD_TEXCOORD = 1e-5f;
+}
+
+inline CSCI441::BezierPatchSet::BezierPatchSet( const std::vector< glm::vec3 > &controlPoints, const std::vector< GLuint > &patchIndices,
+																								const std::vector< glm::vec4 > &patchTexCoords )
+	: _controlPoints( controlPoints ), _patchIndices( patchIndices ), _patchTexCoords( patchTexCoords ) {
+	assert( patchIndices.size() % 16 == 0 );
+	assert( patchTexCoords.empty() || patchTexCoords.size() == patchIndices.size() / 16 );
+
+	if( _patchTexCoords.empty() ) {
+		_patchTexCoords.resize( getNumPatches(), glm::vec4( 0.0f, 0.0f, 1.0f, 1.0f ) );
+	}
+}
+
+inline CSCI441::BezierPatchSet::~BezierPatchSet() {
+	for( std::map< GLint, BufferData >::iterator bufferIter = _buffers.begin(); bufferIter != _buffers.end(); bufferIter++ ) {
+		glDeleteBuffers( 1, &bufferIter->second.vbod );
+		glDeleteBuffers( 1, &bufferIter->second.ibod );
+		glDeleteBuffers( 1, &bufferIter->second.edgeIbod );
+	}
+	for( std::map< VAOData, GLuint >::iterator vaoIter = _vaos.begin(); vaoIter != _vaos.end(); vaoIter++ ) {
+		glDeleteVertexArrays( 1, &vaoIter->second );
+	}
+}
+
+inline GLuint CSCI441::BezierPatchSet::getNumPatches() const {
+	return _patchIndices.size() / 16;
+}
+
+inline const CSCI441::BezierPatchSet::Mesh& CSCI441::BezierPatchSet::tessellate( GLint resolution ) {
+	assert( resolution > 1 );
+
+	std::map< GLint, Mesh >::iterator meshIter = _meshes.find( resolution );
+	if( meshIter != _meshes.end() ) {
+		return meshIter->second;
+	}
+
+	GLuint numPatches = getNumPatches();
+	GLuint samplesPerPatch = resolution * resolution;
+
+	Mesh &mesh = _meshes[ resolution ];
+	mesh.positions.resize( numPatches * samplesPerPatch );
+	mesh.normals.resize( numPatches * samplesPerPatch );
+	mesh.texCoords.resize( numPatches * samplesPerPatch );
+
+	// looked up once here, so the workers never touch the table map
+	const CSCI441_INTERNAL::BezierBasisTable &table = CSCI441_INTERNAL::getBezierBasisTable( resolution );
+
+	GLuint numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+	if( numPatches * samplesPerPatch >= CSCI441_INTERNAL::BEZIER_THREAD_MIN_SAMPLES ) {
+		numThreads = std::thread::hardware_concurrency();
+		if( numThreads < 1 ) numThreads = 1;
+		if( numThreads > numPatches ) numThreads = numPatches;
+	}
+
+	// every patch writes its own range of samples, so the workers never share output
+	std::vector< std::thread > workers;
+	for( GLuint t = 1; t < numThreads; t++ ) {
+		workers.push_back( std::thread( &CSCI441::BezierPatchSet::_tessellatePatches, this, std::cref( table ), t, numThreads, resolution, &mesh ) );
+	}
+#endif
+	_tessellatePatches( table, 0, numThreads, resolution, &mesh );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+
+	mesh.indices.resize( numPatches * (resolution-1) * (resolution-1) * 6 );
+	mesh.edgeIndices.resize( numPatches * resolution * (resolution-1) * 4 );
+	GLuint *index = &mesh.indices[0], *edgeIndex = &mesh.edgeIndices[0];
+	for( GLuint p = 0; p < numPatches; p++ ) {
+		GLuint base = p * samplesPerPatch;
+		for( GLint ru = 0; ru < resolution; ru++ ) {
+			for( GLint rv = 0; rv < resolution; rv++ ) {
+				GLuint a = base + ru*resolution + rv;
+
+				if( ru < resolution-1 && rv < resolution-1 ) {
+					// 1 square ABCD = 2 triangles ABC + CDA
+					*index++ = a;
+					*index++ = a + 1;
+					*index++ = a + resolution + 1;
+					*index++ = a + resolution + 1;
+					*index++ = a + resolution;
+					*index++ = a;
+				}
+				if( rv < resolution-1 ) {
+					*edgeIndex++ = a;
+					*edgeIndex++ = a + 1;
+				}
+				if( ru < resolution-1 ) {
+					*edgeIndex++ = a;
+					*edgeIndex++ = a + resolution;
+				}
+			}
+		}
+	}
+
+	_weldSeams( &mesh );
+
+	return mesh;
+}
+
+inline void CSCI441::BezierPatchSet::_weldSeams( Mesh *mesh ) const {
+	typedef std::pair< long long, std::pair< long long, long long > > CellKey;
+	std::map< CellKey, std::vector< GLuint > > cells;
+
+	std::vector< GLuint > remap( mesh->positions.size() );
+	Mesh welded;
+
+	for( size_t i = 0; i < mesh->positions.size(); i++ ) {
+		const glm::vec3 &position = mesh->positions[i];
+		CellKey key( llround( position.x / CSCI441_INTERNAL::BEZIER_WELD_DISTANCE ),
+								 std::pair< long long, long long >( llround( position.y / CSCI441_INTERNAL::BEZIER_WELD_DISTANCE ),
+																										llround( position.z / CSCI441_INTERNAL::BEZIER_WELD_DISTANCE ) ) );
+		std::vector< GLuint > &candidates = cells[ key ];
+
+		GLuint match = welded.positions.size();
+		for( size_t c = 0; c < candidates.size(); c++ ) {
+			GLuint w = candidates[c];
+			if( glm::dot( glm::normalize( welded.normals[w] ), mesh->normals[i] ) >= CSCI441_INTERNAL::BEZIER_WELD_NORMAL_DOT
+			    && fabs( welded.texCoords[w].x - mesh->texCoords[i].x ) <= CSCI441_INTERNAL::BEZIER_WELD_TEXCOORD
+			    && fabs( welded.texCoords[w].y - mesh->texCoords[i].y ) <= CSCI441_INTERNAL::BEZIER_WELD_TEXCOORD ) {
+				match = w;
+				break;
+			}
+		}
+
+		if( match == welded.positions.size() ) {
+			welded.positions.push_back( position );
+			welded.normals.push_back( mesh->normals[i] );
+			welded.texCoords.push_back( mesh->texCoords[i] );
+			candidates.push_back( match );
+		} else {
+			// patches are only G1 at some seams, so average what each side saw
+			welded.normals[match] += mesh->normals[i];
+		}
+		remap[i] = match;
+	}
+
+	for( size_t w = 0; w < welded.normals.size(); w++ ) {
+		welded.normals[w] = glm::normalize( welded.normals[w] );
+	}
+
+	// triangles that collapsed onto a pole, like the lid's knob, are dropped
+	welded.indices.reserve( mesh->indices.size() );
+	for( size_t i = 0; i < mesh->indices.size(); i += 3 ) {
+		GLuint a = remap[ mesh->indices[i] ], b = remap[ mesh->indices[i+1] ], c = remap[ mesh->indices[i+2] ];
+		if( a == b || b == c || c == a ) continue;
+		welded.indices.push_back( a );
+		welded.indices.push_back( b );
+		welded.indices.push_back( c );
+	}
+
+	// neighboring patches both listed the edges along their shared seam
+	std::set< std::pair< GLuint, GLuint > > edges;
+	welded.edgeIndices.reserve( mesh->edgeIndices.size() );
+	for( size_t i = 0; i < mesh->edgeIndices.size(); i += 2 ) {
+		GLuint a = remap[ mesh->edgeIndices[i] ], b = remap[ mesh->edgeIndices[i+1] ];
+		if( a == b ) continue;
+		if( !edges.insert( std::pair< GLuint, GLuint >( a < b ? a : b, a < b ? b : a ) ).second ) continue;
+		welded.edgeIndices.push_back( a );
+		welded.edgeIndices.push_back( b );
+	}
+
+	mesh->positions.swap( welded.positions );
+	mesh->normals.swap( welded.normals );
+	mesh->texCoords.swap( welded.texCoords );
+	mesh->indices.swap( welded.indices );
+	mesh->edgeIndices.swap( welded.edgeIndices );
+}
+
+inline void CSCI441::BezierPatchSet::_tessellatePatches( const CSCI441_INTERNAL::BezierBasisTable &table, GLuint firstPatch, GLuint patchStep, GLint resolution, Mesh *mesh ) const {
+	for( GLuint p = firstPatch; p < getNumPatches(); p += patchStep ) {
+		glm::vec3 controlPoints[4][4];
+		for( int i = 0; i < 4; i++ )
+			for( int j = 0; j < 4; j++ )
+				controlPoints[i][j] = _controlPoints[ _patchIndices[ p*16 + i*4 + j ] ];
+
+		glm::vec3 *positions = &mesh->positions[ p * resolution * resolution ];
+		glm::vec3 *normals = &mesh->normals[ p * resolution * resolution ];
+		glm::vec2 *texCoords = &mesh->texCoords[ p * resolution * resolution ];
+		const glm::vec4 &texRect = _patchTexCoords[p];
+
+		for( GLint ru = 0; ru < resolution; ru++ ) {
+			// collapse the patch along u into one cubic curve in v and its u derivative
+			glm::vec3 curve[4], curveDu[4];
+			for( int j = 0; j < 4; j++ ) {
+				curve[j] = table.b[0][ru]*controlPoints[0][j] + table.b[1][ru]*controlPoints[1][j]
+				         + table.b[2][ru]*controlPoints[2][j] + table.b[3][ru]*controlPoints[3][j];
+				curveDu[j] = table.db[0][ru]*controlPoints[0][j] + table.db[1][ru]*controlPoints[1][j]
+				           + table.db[2][ru]*controlPoints[2][j] + table.db[3][ru]*controlPoints[3][j];
+			}
+
+			// straight line multiply-adds over the table so the compiler can vectorize across v
+			for( GLint rv = 0; rv < resolution; rv++ ) {
+				GLfloat b0 = table.b[0][rv], b1 = table.b[1][rv], b2 = table.b[2][rv], b3 = table.b[3][rv];
+				GLfloat db0 = table.db[0][rv], db1 = table.db[1][rv], db2 = table.db[2][rv], db3 = table.db[3][rv];
+
+				positions[ ru*resolution + rv ] = b0*curve[0] + b1*curve[1] + b2*curve[2] + b3*curve[3];
+				glm::vec3 du = b0*curveDu[0] + b1*curveDu[1] + b2*curveDu[2] + b3*curveDu[3];
+				glm::vec3 dv = db0*curve[0] + db1*curve[1] + db2*curve[2] + db3*curve[3];
+				normals[ ru*resolution + rv ] = glm::cross( du, dv );
+			}
+		}
+
+		for( GLint ru = 0; ru < resolution; ru++ ) {
+			for( GLint rv = 0; rv < resolution; rv++ ) {
+				texCoords[ ru*resolution + rv ] = glm::vec2( texRect.x + (texRect.z - texRect.x) * ru / (resolution-1),
+																										 texRect.y + (texRect.w - texRect.y) * rv / (resolution-1) );
+
+				glm::vec3 &normal = normals[ ru*resolution + rv ];
+				GLfloat length = glm::length( normal );
+				if( length > 1e-6f ) {
+					normal /= length;
+					continue;
+				}
+
+				// a row of control points collapsed to a point (e.g. the lid's knob), so one
+				// partial vanishes.  take the normal from just inside the patch instead
+				GLfloat u = (GLfloat)ru / (resolution-1), v = (GLfloat)rv / (resolution-1);
+				u += ( u < 0.5f ? 1e-3f : -1e-3f );
+				v += ( v < 0.5f ? 1e-3f : -1e-3f );
+
+				GLfloat bu[4], dbu[4], bv[4], dbv[4];
+				CSCI441_INTERNAL::evaluateBezierBasis( u, bu, dbu );
+				CSCI441_INTERNAL::evaluateBezierBasis( v, bv, dbv );
+
+				glm::vec3 du( 0.0f ), dv( 0.0f );
+				for( int i = 0; i < 4; i++ ) {
+					for( int j = 0; j < 4; j++ ) {
+						du += dbu[i]*bv[j]*controlPoints[i][j];
+						dv += bu[i]*dbv[j]*controlPoints[i][j];
+					}
+				}
+				normal = glm::cross( du, dv );
+				length = glm::length( normal );
+				if( length > 0.0f ) normal /= length;
+			}
+		}
+	}
+}
+
+inline const CSCI441::BezierPatchSet::BufferData& CSCI441::BezierPatchSet::_uploadMesh( GLint resolution ) {
+	std::map< GLint, BufferData >::iterator bufferIter = _buffers.find( resolution );
+	if( bufferIter != _buffers.end() ) {
+		return bufferIter->second;
+	}
+
+	const Mesh &mesh = tessellate( resolution );
+
+	BufferData bufferData;
+	bufferData.numVertices = mesh.positions.size();
+	bufferData.numIndices = mesh.indices.size();
+	bufferData.numEdgeIndices = mesh.edgeIndices.size();
+	bufferData.indexType = bufferData.numVertices <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+	GLuint buffers[3];
+	glGenBuffers( 3, buffers );
+	bufferData.vbod = buffers[0];
+	bufferData.ibod = buffers[1];
+	bufferData.edgeIbod = buffers[2];
+
+	// one interleaved vertex: position, normal, texCoord
+	std::vector< GLfloat > vertices( bufferData.numVertices * 8 );
+	for( GLsizei i = 0; i < bufferData.numVertices; i++ ) {
+		GLfloat *vertex = &vertices[ i*8 ];
+		vertex[0] = mesh.positions[i].x;	vertex[1] = mesh.positions[i].y;	vertex[2] = mesh.positions[i].z;
+		vertex[3] = mesh.normals[i].x;		vertex[4] = mesh.normals[i].y;		vertex[5] = mesh.normals[i].z;
+		vertex[6] = mesh.texCoords[i].x;	vertex[7] = mesh.texCoords[i].y;
+	}
+
+	// everything goes through GL_ARRAY_BUFFER so the element binding of whatever VAO is bound is left alone
+	glBindBuffer( GL_ARRAY_BUFFER, bufferData.vbod );
+	glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * vertices.size(), &vertices[0], GL_STATIC_DRAW );
+
+	if( bufferData.indexType == GL_UNSIGNED_SHORT ) {
+		std::vector< GLushort > indices( mesh.indices.begin(), mesh.indices.end() );
+		std::vector< GLushort > edgeIndices( mesh.edgeIndices.begin(), mesh.edgeIndices.end() );
+
+		glBindBuffer( GL_ARRAY_BUFFER, bufferData.ibod );
+		glBufferData( GL_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), &indices[0], GL_STATIC_DRAW );
+		glBindBuffer( GL_ARRAY_BUFFER, bufferData.edgeIbod );
+		glBufferData( GL_ARRAY_BUFFER, sizeof(GLushort) * edgeIndices.size(), &edgeIndices[0], GL_STATIC_DRAW );
+	} else {
+		glBindBuffer( GL_ARRAY_BUFFER, bufferData.ibod );
+		glBufferData( GL_ARRAY_BUFFER, sizeof(GLuint) * bufferData.numIndices, &mesh.indices[0], GL_STATIC_DRAW );
+		glBindBuffer( GL_ARRAY_BUFFER, bufferData.edgeIbod );
+		glBufferData( GL_ARRAY_BUFFER, sizeof(GLuint) * bufferData.numEdgeIndices, &mesh.edgeIndices[0], GL_STATIC_DRAW );
+	}
+
+	return _buffers.insert( std::pair< GLint, BufferData >( resolution, bufferData ) ).first->second;
+}
+
+inline void CSCI441::BezierPatchSet::_bindVAO( GLint resolution, const BufferData &bufferData, GLint positionLocation, GLint normalLocation, GLint texCoordLocation ) {
+	VAOData key = { resolution, positionLocation, normalLocation, texCoordLocation };
+	std::map< VAOData, GLuint >::iterator vaoIter = _vaos.find( key );
+	if( vaoIter != _vaos.end() ) {
+		glBindVertexArray( vaoIter->second );
+		return;
+	}
+
+	GLuint vaod;
+	glGenVertexArrays( 1, &vaod );
+	glBindVertexArray( vaod );
+	glBindBuffer( GL_ARRAY_BUFFER, bufferData.vbod );
+
+	if( positionLocation != -1 ) {
+		glEnableVertexAttribArray( positionLocation );
+		glVertexAttribPointer( positionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 8, (void*)0 );
+	}
+	if( normalLocation != -1 ) {
+		glEnableVertexAttribArray( normalLocation );
+		glVertexAttribPointer( normalLocation, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 8, (void*)(sizeof(GLfloat) * 3) );
+	}
+	if( texCoordLocation != -1 ) {
+		glEnableVertexAttribArray( texCoordLocation );
+		glVertexAttribPointer( texCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 8, (void*)(sizeof(GLfloat) * 6) );
+	}
+
+	_vaos.insert( std::pair< VAOData, GLuint >( key, vaod ) );
+}
+
+inline void CSCI441::BezierPatchSet::draw( GLint resolution, GLint positionLocation, GLint normalLocation, GLint texCoordLocation, GLenum renderMode ) {
+	assert( resolution > 1 );
+
+	const BufferData &bufferData = _uploadMesh( resolution );
+	_bindVAO( resolution, bufferData, positionLocation, normalLocation, texCoordLocation );
+
+	// solid and wire share the VAO, so select the element buffer for this draw
+	if( renderMode == GL_LINE ) {
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, bufferData.edgeIbod );
+		glDrawElements( GL_LINES, bufferData.numEdgeIndices, bufferData.indexType, (void*)0 );
+	} else {
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, bufferData.ibod );
+		glDrawElements( GL_TRIANGLES, bufferData.numIndices, bufferData.indexType, (void*)0 );
+	}
+}
+
+inline void CSCI441_INTERNAL::evaluateBezierBasis( GLfloat t, GLfloat b[4], GLfloat db[4] ) {
+	GLfloat s = 1.0f - t;
+
+	b[0] = s*s*s;
+	b[1] = 3.0f*t*s*s;
+	b[2] = 3.0f*t*t*s;
+	b[3] = t*t*t;
+
+	db[0] = -3.0f*s*s;
+	db[1] = 3.0f*s*s - 6.0f*t*s;
+	db[2] = 6.0f*t*s - 3.0f*t*t;
+	db[3] = 3.0f*t*t;
+}
+
+inline const CSCI441_INTERNAL::BezierBasisTable& CSCI441_INTERNAL::getBezierBasisTable( GLint resolution ) {
+	// one set of tables for the whole program, like the teapot's patch set
+	static std::map< GLint, BezierBasisTable > bezierBasisTables;
+
+	std::map< GLint, BezierBasisTable >::iterator tableIter = bezierBasisTables.find( resolution );
+	if( tableIter != bezierBasisTables.end() ) {
+		return tableIter->second;
+	}
+
+	BezierBasisTable &table = bezierBasisTables[ resolution ];
+	for( int i = 0; i < 4; i++ ) {
+		table.b[i].resize( resolution );
+		table.db[i].resize( resolution );
+	}
+	for( GLint r = 0; r < resolution; r++ ) {
+		GLfloat b[4], db[4];
+		evaluateBezierBasis( (GLfloat)r / (resolution-1), b, db );
+		for( int i = 0; i < 4; i++ ) {
+			table.b[i][r] = b[i];
+			table.db[i][r] = db[i];
+		}
+	}
+
+	return table;
+}
+
+#endif // __CSCI441_BEZIERPATCH_3_HPP__
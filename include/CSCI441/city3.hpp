@@ -0,0 +1,834 @@
+/** @file city3.hpp
+  * @brief Procedural city of box buildings drawn with one instanced draw in OpenGL 3.3+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	The city is a grid of cells with streets along every even row and column.
+	*	Each remaining cell may hold one building, decided by a random generator
+	*	seeded from the city seed and the cell coordinates alone, so a city is
+	*	reproducible and any block of cells can be generated on its own, in any
+	*	order and on any thread.
+	*
+	*	Every building is one instance of a unit cube: a buffer holds each
+	*	building's base position, size and color, and the whole city is drawn
+	*	with a single glDrawElementsInstanced() call.  The vertex shader places
+	*	the cube with
+	*
+	*		vec3 worldPos = instancePosition + vPos * instanceSize;
+	*
+	*	where the unit cube spans [-0.5, 0.5] along x and z and [0, 1] along y.
+	*
+	*	Buildings are kept in a quadtree over blocks of cells.  Each node covers a
+	*	contiguous run of buildings, so cull() can take whole nodes that lie inside
+	*	the view frustum without looking at their buildings, and only tests the
+	*	individual bounding boxes of leaves that straddle a frustum plane.  Given
+	*	a CSCI441::OcclusionCuller, nodes inside the frustum are also tested
+	*	against its depth pyramid and skipped whole when hidden.  The buildings
+	*	that survive are compacted into the instance buffer before the next draw.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
+	*	@warning NOTE: This header file depends upon GLEW
+	*	@warning NOTE: This header file depends upon glm
+	*	@warning NOTE: Culling large cities is split across std::thread workers.  Define
+	*	CSCI441_NO_THREADS before including this file on toolchains without std::thread support
+  */
+
+#ifndef __CSCI441_CITY_3_HPP__
+#define __CSCI441_CITY_3_HPP__
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <CSCI441/occlusionCuller.hpp>
+
+#include <math.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @struct CityBuilding
+		* @brief One building, laid out exactly as its instance data on the GPU
+		*
+		* @var position	- center of the base of the building
+		* @var size			- width, height and depth of the building
+		* @var color			- diffuse color of the building
+		*/
+	struct CityBuilding {
+		glm::vec3 position;
+		glm::vec3 size;
+		glm::vec4 color;
+	};
+
+	/** @class CityRandom
+		* @brief Small seeded random number generator, one per cell so cells never share state
+		*/
+	class CityRandom {
+	public:
+		/** @brief Creates a generator for one cell of a city
+			* @param GLuint seed	- city seed
+			* @param GLint x			- cell column
+			* @param GLint z			- cell row
+			*/
+		CityRandom( GLuint seed, GLint x, GLint z );
+
+		/** @brief Returns the next random 32 bit value
+			* @return random value
+			*/
+		GLuint nextUInt();
+		/** @brief Returns the next random value in [0, 1)
+			* @return random value
+			*/
+		GLfloat nextFloat();
+
+		/** @brief Mixes the bits of a value so nearby inputs give unrelated outputs
+			* @param GLuint h	- value to mix
+			* @return mixed value
+			*/
+		static GLuint mix( GLuint h );
+
+	private:
+		GLuint _state;
+	};
+
+	/** @class City
+		* @brief Grid of procedurally generated buildings rendered with one instanced draw
+		*/
+	class City {
+	public:
+		/** @brief Generates a city centered on the origin
+			* @param GLuint seed				- seed that determines every building
+			* @param GLint gridX				- number of cells along x
+			* @param GLint gridZ				- number of cells along z
+			* @param GLfloat spacing		- distance between neighboring cell centers
+			* @param GLfloat density		- chance that a cell between streets holds a building
+			*/
+		City( GLuint seed, GLint gridX, GLint gridZ, GLfloat spacing = 1.1f, GLfloat density = 0.4f );
+		/** @brief Generates one rectangle of cells out of an unbounded city
+			*
+			*	Cell (x, z) sits at (x * spacing, 0, z * spacing) and its building depends only
+			*	on the seed and the cell, so neighboring rectangles line up seamlessly.  Makes
+			*	no OpenGL calls, so it is safe to construct on any thread.
+			*
+			* @param GLuint seed				- seed that determines every building
+			* @param glm::ivec2 firstCell	- first cell of the rectangle along x and z
+			* @param glm::ivec2 numCells		- number of cells along x and z
+			* @param GLfloat spacing		- distance between neighboring cell centers
+			* @param GLfloat density		- chance that a cell between streets holds a building
+			*/
+		City( GLuint seed, glm::ivec2 firstCell, glm::ivec2 numCells, GLfloat spacing = 1.1f, GLfloat density = 0.4f );
+		/** @brief Frees memory associated with the city on both CPU and GPU
+			*/
+		~City();
+
+		/** @brief Generates the building, if any, of one cell
+			*
+			*	Depends only on its arguments, so it is safe to call from any thread.
+			*
+			* @param GLuint seed				- city seed
+			* @param GLint x						- cell column
+			* @param GLint z						- cell row
+			* @param glm::vec3 center		- center of the cell on the ground
+			* @param GLfloat density		- chance that a cell between streets holds a building
+			* @param CityBuilding& building	- receives the building
+			* @return true if the cell holds a building
+			*/
+		static bool generateCell( GLuint seed, GLint x, GLint z, glm::vec3 center, GLfloat density, CityBuilding &building );
+
+		/** @brief Returns every building of the city, ordered so each block of cells is contiguous
+			* @return buildings
+			*/
+		const std::vector< CityBuilding >& getBuildings() const;
+		/** @brief Returns the number of buildings in the city
+			* @return number of buildings
+			*/
+		GLuint getNumBuildings() const;
+		/** @brief Returns the box around every building of the city
+			* @param glm::vec3& boundsMin	- receives the minimum corner
+			* @param glm::vec3& boundsMax	- receives the maximum corner
+			* @return false if the city has no buildings
+			*/
+		bool getBounds( glm::vec3 &boundsMin, glm::vec3 &boundsMax ) const;
+		/** @brief Returns the number of bytes the city sends to the GPU when uploaded
+			* @return size of the vertex, index and instance buffers
+			*/
+		GLuint getUploadSize() const;
+
+		/** @brief Finds the buildings inside a view frustum
+			*
+			*	Until the next call, draw() renders only these buildings.  Safe to call
+			*	without a current OpenGL context; the upload happens in draw().
+			*
+			* @param glm::mat4 viewProjectionMatrix						- projection matrix times view matrix of the camera
+			* @param CSCI441::OcclusionCuller* occlusionCuller	- if not NULL, also drops buildings hidden behind its occluders;
+			*																											end() must have been called with the same camera
+			*/
+		void cull( const glm::mat4 &viewProjectionMatrix, const OcclusionCuller *occlusionCuller = NULL );
+		/** @brief Returns the buildings found by the last cull() in the order they are drawn
+			* @return visible buildings
+			*/
+		const std::vector< CityBuilding >& getVisibleBuildings() const;
+		/** @brief Returns the number of buildings the next draw() renders
+			* @return number of visible buildings
+			*/
+		GLuint getNumVisible() const;
+		/** @brief Returns the number of buildings the last cull() removed
+			* @return number of culled buildings
+			*/
+		GLuint getNumCulled() const;
+		/** @brief Returns the number of buildings inside the frustum that the last cull() found hidden
+			* @return number of occluded buildings, 0 without an occlusion culler
+			*/
+		GLuint getNumOccluded() const;
+		/** @brief Forgets the last cull() so draw() renders every building again
+			*/
+		void clearCull();
+		/** @brief Returns how long the last cull() took
+			* @return time in milliseconds
+			*/
+		GLdouble getCullTime() const;
+
+		/** @brief Renders every visible building with one instanced draw
+			*
+			*	The instance buffer is uploaded on the first draw and again after every
+			*	cull().  Each set of attribute locations gets its own VAO.  A location of
+			*	-1 is left disabled.
+			*
+			* @param GLint positionLocation					- attribute location of the unit cube vertex position
+			* @param GLint normalLocation						- attribute location of the unit cube vertex normal
+			* @param GLint instancePositionLocation	- attribute location of the building base position
+			* @param GLint instanceSizeLocation			- attribute location of the building size
+			* @param GLint instanceColorLocation		- attribute location of the building color
+			*/
+		void draw( GLint positionLocation, GLint normalLocation, GLint instancePositionLocation, GLint instanceSizeLocation, GLint instanceColorLocation );
+		/** @brief Creates the GPU buffers now instead of on the first draw
+			*/
+		void upload();
+
+	private:
+		struct VAOData {
+			GLint p, n, ip, is, ic;
+			bool operator<( const VAOData rhs ) const {
+				if( p != rhs.p ) return p < rhs.p;
+				if( n != rhs.n ) return n < rhs.n;
+				if( ip != rhs.ip ) return ip < rhs.ip;
+				if( is != rhs.is ) return is < rhs.is;
+				return ic < rhs.ic;
+			}
+		};
+
+		// quadtree node over the buildings [first, last); leaves are one block of cells
+		struct CullNode {
+			glm::vec3 min, max;
+			GLuint first, last;
+			GLint children[4];
+			bool leaf;
+		};
+		// node to traverse with the frustum planes its parent did not already clear
+		struct CullTask {
+			GLint node;
+			GLuint planeMask;
+		};
+
+		void _generate( GLuint seed, glm::ivec2 firstCell, glm::ivec2 numCells, glm::vec2 originCell, GLfloat spacing, GLfloat density );
+		GLint _buildNode( const std::vector< GLuint > &keys, GLuint key, GLuint level );
+		void _cullTasks( const CullTask *tasks, GLuint numTasks, const glm::vec4 *planes, const OcclusionCuller *occlusionCuller, std::vector< CityBuilding > *visible, GLuint *numOccluded ) const;
+		void _cullLeaf( const CullNode &node, GLuint planeMask, const glm::vec4 *planes, const OcclusionCuller *occlusionCuller, std::vector< CityBuilding > &visible, GLuint &numOccluded ) const;
+		GLuint _bindVAO( const VAOData &locations );
+
+		std::vector< CityBuilding > _buildings;
+
+		// bounding boxes as separate arrays so the per building test runs down contiguous floats
+		std::vector< GLfloat > _boundsCenter[3], _boundsExtent[3];
+		std::vector< CullNode > _nodes;
+		GLint _root;
+
+		std::vector< CityBuilding > _visibleBuildings;
+		bool _culled, _visibleDirty;
+		GLuint _numOccluded;
+		GLdouble _cullTime;
+
+		GLuint _cubeVBO, _cubeIBO, _instanceVBO;
+		std::map< VAOData, GLuint > _vaos;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	// unit cube with its base on y = 0: 24 vertices of position then normal, 36 indices
+	void generateCityCube( std::vector< GLfloat > &vertices, std::vector< GLushort > &indices );
+
+	static const GLuint CITY_CUBE_VERTICES = 24;
+	static const GLuint CITY_CUBE_INDICES = 36;
+
+	// cells per side of a quadtree leaf
+	static const GLint CITY_BLOCK_CELLS = 8;
+	// buildings tested together by the frustum test
+	static const GLuint CITY_CULL_LANES = 8;
+	// below this many buildings a cull finishes before extra threads would start
+	static const GLuint CITY_THREAD_MIN_BUILDINGS = 262144;
+
+	// the six planes of the frustum of a view projection matrix as (normal, distance),
+	// positive on the inside.  left, right, bottom, top, near, far
+	void extractFrustumPlanes( const glm::mat4 &viewProjectionMatrix, glm::vec4 planes[6] );
+	// tests a box against the planes set in planeMask.  returns -1 if the box is
+	// outside, otherwise the planes the box still straddles (0 when fully inside)
+	GLint testFrustumAABB( const glm::vec4 planes[6], GLuint planeMask, const glm::vec3 &boxMin, const glm::vec3 &boxMax );
+	// interleaves the bits of x and z so nearby blocks get nearby keys
+	GLuint mortonKey( GLuint x, GLuint z );
+}
+
+inline CSCI441::CityRandom::CityRandom( GLuint seed, GLint x, GLint z ) {
+	// fold the cell coordinates into the seed one at a time so (x, z) and (z, x) differ
+	_state = mix( seed ^ 0x9E3779B9u );
+	_state = mix( _state ^ ((GLuint)x * 0x85EBCA6Bu) );
+	_state = mix( _state ^ ((GLuint)z * 0xC2B2AE35u) );
+}
+
+inline GLuint CSCI441::CityRandom::nextUInt() {
+	// a Weyl sequence through the mixer; every cell gets its own stream
+	_state += 0x9E3779B9u;
+	return mix( _state );
+}
+
+inline GLfloat CSCI441::CityRandom::nextFloat() {
+	// top 24 bits so every value is exactly representable and below 1
+	return (nextUInt() >> 8) * (1.0f / 16777216.0f);
+}
+
+inline GLuint CSCI441::CityRandom::mix( GLuint h ) {
+	h ^= h >> 16;
+	h *= 0x85EBCA6Bu;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35u;
+	h ^= h >> 16;
+	return h;
+}
+
+inline CSCI441::City::City( GLuint seed, GLint gridX, GLint gridZ, GLfloat spacing, GLfloat density ) {
+	_generate( seed, glm::ivec2( 0, 0 ), glm::ivec2( gridX, gridZ ), glm::vec2( gridX/2.0f, gridZ/2.0f ), spacing, density );
+}
+
+inline CSCI441::City::City( GLuint seed, glm::ivec2 firstCell, glm::ivec2 numCells, GLfloat spacing, GLfloat density ) {
+	_generate( seed, firstCell, numCells, glm::vec2( 0.0f, 0.0f ), spacing, density );
+}
+
+inline void CSCI441::City::_generate( GLuint seed, glm::ivec2 firstCell, glm::ivec2 numCells, glm::vec2 originCell, GLfloat spacing, GLfloat density ) {
+	_cubeVBO = _cubeIBO = _instanceVBO = 0;
+	_culled = _visibleDirty = false;
+	_numOccluded = 0;
+	_cullTime = 0.0;
+
+	// visit the blocks of cells in key order so every quadtree node ends up owning
+	// a contiguous run of buildings without sorting the buildings themselves
+	const GLint BLOCK = CSCI441_INTERNAL::CITY_BLOCK_CELLS;
+	GLint blocksX = (numCells.x + BLOCK - 1) / BLOCK, blocksZ = (numCells.y + BLOCK - 1) / BLOCK;
+	std::vector< std::pair< GLuint, GLint > > blocks;
+	blocks.reserve( blocksX * blocksZ );
+	for( GLint bx = 0; bx < blocksX; bx++ ) {
+		for( GLint bz = 0; bz < blocksZ; bz++ ) {
+			blocks.push_back( std::pair< GLuint, GLint >( CSCI441_INTERNAL::mortonKey( bx, bz ), bx * blocksZ + bz ) );
+		}
+	}
+	std::sort( blocks.begin(), blocks.end() );
+
+	// about a quarter of the cells lie between streets
+	std::vector< GLuint > keys;
+	_buildings.reserve( (size_t)( numCells.x * numCells.y * density / 4.0f * 1.1f ) + 16 );
+	keys.reserve( _buildings.capacity() );
+	for( size_t b = 0; b < blocks.size(); b++ ) {
+		GLint bx = blocks[b].second / blocksZ, bz = blocks[b].second % blocksZ;
+		for( GLint i = bx * BLOCK; i < (bx + 1) * BLOCK && i < numCells.x; i++ ) {
+			for( GLint j = bz * BLOCK; j < (bz + 1) * BLOCK && j < numCells.y; j++ ) {
+				GLint x = firstCell.x + i, z = firstCell.y + j;
+				glm::vec3 center( (x - originCell.x) * spacing, 0.0f, (z - originCell.y) * spacing );
+				CityBuilding building;
+				if( generateCell( seed, x, z, center, density, building ) ) {
+					_buildings.push_back( building );
+					keys.push_back( blocks[b].first );
+				}
+			}
+		}
+	}
+
+	// padded by one batch so the frustum test can always read a full batch
+	for( int axis = 0; axis < 3; axis++ ) {
+		_boundsCenter[axis].assign( _buildings.size() + CSCI441_INTERNAL::CITY_CULL_LANES, 0.0f );
+		_boundsExtent[axis].assign( _buildings.size() + CSCI441_INTERNAL::CITY_CULL_LANES, 0.0f );
+	}
+	for( size_t i = 0; i < _buildings.size(); i++ ) {
+		glm::vec3 extent = _buildings[i].size * 0.5f;
+		glm::vec3 center = _buildings[i].position + glm::vec3( 0.0f, extent.y, 0.0f );
+		for( int axis = 0; axis < 3; axis++ ) {
+			_boundsCenter[axis][i] = center[axis];
+			_boundsExtent[axis][i] = extent[axis];
+		}
+	}
+
+	GLuint levels = 0;
+	while( (1 << levels) < std::max( blocksX, blocksZ ) ) levels++;
+	_root = _buildNode( keys, 0, levels );
+}
+
+inline CSCI441::City::~City() {
+	if( _cubeVBO != 0 ) glDeleteBuffers( 1, &_cubeVBO );
+	if( _cubeIBO != 0 ) glDeleteBuffers( 1, &_cubeIBO );
+	if( _instanceVBO != 0 ) glDeleteBuffers( 1, &_instanceVBO );
+	for( std::map< VAOData, GLuint >::iterator vaoIter = _vaos.begin(); vaoIter != _vaos.end(); vaoIter++ ) {
+		glDeleteVertexArrays( 1, &vaoIter->second );
+	}
+}
+
+inline bool CSCI441::City::generateCell( GLuint seed, GLint x, GLint z, glm::vec3 center, GLfloat density, CityBuilding &building ) {
+	// streets run along every even row and column
+	if( (x & 1) == 0 || (z & 1) == 0 ) return false;
+
+	CityRandom random( seed, x, z );
+	if( random.nextFloat() >= density ) return false;
+
+	// mostly low buildings with the occasional tower
+	GLfloat height = powf( random.nextFloat(), 2.5f ) * 10.0f + 1.0f;
+
+	building.position = center;
+	building.size = glm::vec3( 1.0f, height, 1.0f );
+	building.color.r = random.nextFloat();
+	building.color.g = random.nextFloat();
+	building.color.b = random.nextFloat();
+	building.color.a = 1.0f;
+	return true;
+}
+
+inline const std::vector< CSCI441::CityBuilding >& CSCI441::City::getBuildings() const {
+	return _buildings;
+}
+
+inline GLuint CSCI441::City::getNumBuildings() const {
+	return _buildings.size();
+}
+
+inline bool CSCI441::City::getBounds( glm::vec3 &boundsMin, glm::vec3 &boundsMax ) const {
+	if( _root == -1 ) {
+		boundsMin = boundsMax = glm::vec3( 0.0f );
+		return false;
+	}
+	boundsMin = _nodes[_root].min;
+	boundsMax = _nodes[_root].max;
+	return true;
+}
+
+inline GLuint CSCI441::City::getUploadSize() const {
+	if( _buildings.empty() ) return 0;
+	return CSCI441_INTERNAL::CITY_CUBE_VERTICES * 6 * sizeof(GLfloat) + CSCI441_INTERNAL::CITY_CUBE_INDICES * sizeof(GLushort) + _buildings.size() * sizeof(CityBuilding);
+}
+
+inline void CSCI441::City::cull( const glm::mat4 &viewProjectionMatrix, const OcclusionCuller *occlusionCuller ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	glm::vec4 planes[6];
+	CSCI441_INTERNAL::extractFrustumPlanes( viewProjectionMatrix, planes );
+
+	_visibleBuildings.clear();
+	_culled = _visibleDirty = true;
+
+	std::vector< CullTask > tasks;
+	GLint rootMask = _root == -1 ? -1 : CSCI441_INTERNAL::testFrustumAABB( planes, 0x3F, _nodes[_root].min, _nodes[_root].max );
+	if( rootMask >= 0 ) {
+		CullTask root = { _root, (GLuint)rootMask };
+		tasks.push_back( root );
+	}
+
+	GLuint numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+	if( _buildings.size() >= CSCI441_INTERNAL::CITY_THREAD_MIN_BUILDINGS ) {
+		numThreads = std::thread::hardware_concurrency();
+		if( numThreads < 1 ) numThreads = 1;
+	}
+#endif
+
+	// open the tree a level at a time until every thread has several subtrees to
+	// take.  children replace their parent in place, so the tasks stay in key order
+	while( numThreads > 1 && tasks.size() < numThreads * 4 ) {
+		std::vector< CullTask > next;
+		bool opened = false;
+		for( size_t t = 0; t < tasks.size(); t++ ) {
+			const CullNode &node = _nodes[ tasks[t].node ];
+			if( node.leaf || tasks[t].planeMask == 0 ) {
+				next.push_back( tasks[t] );
+				continue;
+			}
+			for( int c = 0; c < 4; c++ ) {
+				if( node.children[c] == -1 ) continue;
+				GLint mask = CSCI441_INTERNAL::testFrustumAABB( planes, tasks[t].planeMask, _nodes[ node.children[c] ].min, _nodes[ node.children[c] ].max );
+				if( mask < 0 ) continue;
+				CullTask child = { node.children[c], (GLuint)mask };
+				next.push_back( child );
+			}
+			opened = true;
+		}
+		tasks.swap( next );
+		if( !opened ) break;
+	}
+	if( numThreads > tasks.size() ) numThreads = tasks.size();
+	if( numThreads < 1 ) numThreads = 1;
+
+	// each thread takes a contiguous run of tasks, so joining their lists in
+	// thread order gives the same list a single thread would have built
+	std::vector< std::vector< CityBuilding > > visible( numThreads - 1 );
+	std::vector< std::vector< CityBuilding >* > lists( numThreads );
+	lists[0] = &_visibleBuildings;
+	for( GLuint t = 1; t < numThreads; t++ ) lists[t] = &visible[t-1];
+	std::vector< GLuint > occluded( numThreads, 0 );
+
+#ifndef CSCI441_NO_THREADS
+	std::vector< std::thread > workers;
+	for( GLuint t = 1; t < numThreads; t++ ) {
+		size_t first = tasks.size() * t / numThreads, last = tasks.size() * (t+1) / numThreads;
+		workers.push_back( std::thread( &City::_cullTasks, this, &tasks[0] + first, (GLuint)(last - first), planes, occlusionCuller, lists[t], &occluded[t] ) );
+	}
+#endif
+	if( !tasks.empty() ) {
+		_cullTasks( &tasks[0], tasks.size() / numThreads, planes, occlusionCuller, lists[0], &occluded[0] );
+	}
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+	for( GLuint t = 1; t < numThreads; t++ ) {
+		_visibleBuildings.insert( _visibleBuildings.end(), lists[t]->begin(), lists[t]->end() );
+	}
+	_numOccluded = 0;
+	for( GLuint t = 0; t < numThreads; t++ ) {
+		_numOccluded += occluded[t];
+	}
+
+	_cullTime = std::chrono::duration< GLdouble, std::milli >( std::chrono::steady_clock::now() - start ).count();
+}
+
+inline const std::vector< CSCI441::CityBuilding >& CSCI441::City::getVisibleBuildings() const {
+	return _culled ? _visibleBuildings : _buildings;
+}
+
+inline GLuint CSCI441::City::getNumVisible() const {
+	return _culled ? _visibleBuildings.size() : _buildings.size();
+}
+
+inline GLuint CSCI441::City::getNumCulled() const {
+	return _buildings.size() - getNumVisible();
+}
+
+inline GLuint CSCI441::City::getNumOccluded() const {
+	return _numOccluded;
+}
+
+inline void CSCI441::City::clearCull() {
+	if( !_culled ) return;
+	_culled = false;
+	_visibleDirty = true;
+	_visibleBuildings.clear();
+	_numOccluded = 0;
+}
+
+inline GLdouble CSCI441::City::getCullTime() const {
+	return _cullTime;
+}
+
+inline void CSCI441::City::draw( GLint positionLocation, GLint normalLocation, GLint instancePositionLocation, GLint instanceSizeLocation, GLint instanceColorLocation ) {
+	if( _buildings.empty() ) return;
+	upload();
+
+	if( _visibleDirty ) {
+		// orphan the old contents so the driver need not wait on the last frame's draw
+		glBindBuffer( GL_ARRAY_BUFFER, _instanceVBO );
+		glBufferData( GL_ARRAY_BUFFER, sizeof(CityBuilding) * _buildings.size(), NULL, GL_STREAM_DRAW );
+		if( getNumVisible() > 0 ) {
+			glBufferSubData( GL_ARRAY_BUFFER, 0, sizeof(CityBuilding) * getNumVisible(), &getVisibleBuildings()[0] );
+		}
+		_visibleDirty = false;
+	}
+	if( getNumVisible() == 0 ) return;
+
+	VAOData locations = { positionLocation, normalLocation, instancePositionLocation, instanceSizeLocation, instanceColorLocation };
+	glBindVertexArray( _bindVAO( locations ) );
+	glDrawElementsInstanced( GL_TRIANGLES, CSCI441_INTERNAL::CITY_CUBE_INDICES, GL_UNSIGNED_SHORT, (void*)0, getNumVisible() );
+}
+
+inline GLint CSCI441::City::_buildNode( const std::vector< GLuint > &keys, GLuint key, GLuint level ) {
+	// a node at this level covers 4^level block keys starting at key
+	unsigned long long span = 1ull << (2 * level);
+	GLuint first = std::lower_bound( keys.begin(), keys.end(), key ) - keys.begin();
+	GLuint last = key + span > 0xFFFFFFFFull ? keys.size() : std::lower_bound( keys.begin(), keys.end(), (GLuint)(key + span) ) - keys.begin();
+	if( first == last ) return -1;
+
+	CullNode node;
+	node.first = first;
+	node.last = last;
+	node.leaf = level == 0;
+	node.min = glm::vec3( 1e30f );
+	node.max = glm::vec3( -1e30f );
+	for( int c = 0; c < 4; c++ ) node.children[c] = -1;
+
+	if( node.leaf ) {
+		for( GLuint i = first; i < last; i++ ) {
+			glm::vec3 center( _boundsCenter[0][i], _boundsCenter[1][i], _boundsCenter[2][i] );
+			glm::vec3 extent( _boundsExtent[0][i], _boundsExtent[1][i], _boundsExtent[2][i] );
+			node.min = glm::min( node.min, center - extent );
+			node.max = glm::max( node.max, center + extent );
+		}
+	}
+
+	GLint index = _nodes.size();
+	_nodes.push_back( node );
+	if( node.leaf ) return index;
+
+	for( int c = 0; c < 4; c++ ) {
+		GLint child = _buildNode( keys, key + (GLuint)(span / 4) * c, level - 1 );
+		_nodes[index].children[c] = child;
+		if( child == -1 ) continue;
+		_nodes[index].min = glm::min( _nodes[index].min, _nodes[child].min );
+		_nodes[index].max = glm::max( _nodes[index].max, _nodes[child].max );
+	}
+	return index;
+}
+
+inline void CSCI441::City::_cullTasks( const CullTask *tasks, GLuint numTasks, const glm::vec4 *planes, const OcclusionCuller *occlusionCuller, std::vector< CityBuilding > *visible, GLuint *numOccluded ) const {
+	std::vector< CullTask > stack;
+	for( GLuint t = 0; t < numTasks; t++ ) {
+		stack.push_back( tasks[t] );
+		while( !stack.empty() ) {
+			CullTask task = stack.back();
+			stack.pop_back();
+			const CullNode &node = _nodes[ task.node ];
+
+			if( task.planeMask == 0 && occlusionCuller != NULL && !occlusionCuller->isVisible( node.min, node.max ) ) {
+				// entirely inside the frustum and entirely hidden
+				*numOccluded += node.last - node.first;
+			} else if( task.planeMask == 0 && occlusionCuller == NULL ) {
+				// entirely inside, take every building without testing any of them
+				visible->insert( visible->end(), _buildings.begin() + node.first, _buildings.begin() + node.last );
+			} else if( node.leaf ) {
+				_cullLeaf( node, task.planeMask, planes, occlusionCuller, *visible, *numOccluded );
+			} else {
+				// pushed in reverse so they come off the stack in key order
+				for( int c = 3; c >= 0; c-- ) {
+					if( node.children[c] == -1 ) continue;
+					GLint mask = CSCI441_INTERNAL::testFrustumAABB( planes, task.planeMask, _nodes[ node.children[c] ].min, _nodes[ node.children[c] ].max );
+					if( mask < 0 ) continue;
+					CullTask child = { node.children[c], (GLuint)mask };
+					stack.push_back( child );
+				}
+			}
+		}
+	}
+}
+
+inline void CSCI441::City::_cullLeaf( const CullNode &node, GLuint planeMask, const glm::vec4 *planes, const OcclusionCuller *occlusionCuller, std::vector< CityBuilding > &visible, GLuint &numOccluded ) const {
+	const GLuint LANES = CSCI441_INTERNAL::CITY_CULL_LANES;
+
+	// only the planes the leaf straddles can reject any of its buildings
+	glm::vec4 active[6], activeAbs[6];
+	GLuint numActive = 0;
+	for( GLuint p = 0; p < 6; p++ ) {
+		if( planeMask & (1 << p) ) {
+			active[numActive] = planes[p];
+			activeAbs[numActive] = glm::abs( planes[p] );
+			numActive++;
+		}
+	}
+
+	// a batch of boxes per plane with no branches, so the compiler can run the
+	// lanes side by side.  the arrays are padded, a full batch is always readable
+	for( GLuint base = node.first; base < node.last; base += LANES ) {
+		const GLfloat *cx = &_boundsCenter[0][base], *cy = &_boundsCenter[1][base], *cz = &_boundsCenter[2][base];
+		const GLfloat *ex = &_boundsExtent[0][base], *ey = &_boundsExtent[1][base], *ez = &_boundsExtent[2][base];
+
+		GLint inside[LANES];
+		for( GLuint i = 0; i < LANES; i++ ) inside[i] = 1;
+		for( GLuint p = 0; p < numActive; p++ ) {
+			const glm::vec4 n = active[p], a = activeAbs[p];
+			for( GLuint i = 0; i < LANES; i++ ) {
+				// signed distance of the box corner furthest along the plane normal
+				GLfloat d = n.x*cx[i] + n.y*cy[i] + n.z*cz[i] + n.w + a.x*ex[i] + a.y*ey[i] + a.z*ez[i];
+				inside[i] &= d >= 0.0f;
+			}
+		}
+
+		GLuint count = std::min( LANES, node.last - base );
+		for( GLuint i = 0; i < count; i++ ) {
+			if( !inside[i] ) continue;
+			if( occlusionCuller != NULL ) {
+				glm::vec3 center( cx[i], cy[i], cz[i] ), extent( ex[i], ey[i], ez[i] );
+				if( !occlusionCuller->isVisible( center - extent, center + extent ) ) {
+					numOccluded++;
+					continue;
+				}
+			}
+			visible.push_back( _buildings[base + i] );
+		}
+	}
+}
+
+inline void CSCI441::City::upload() {
+	if( _instanceVBO != 0 || _buildings.empty() ) return;
+
+	std::vector< GLfloat > vertices;
+	std::vector< GLushort > indices;
+	CSCI441_INTERNAL::generateCityCube( vertices, indices );
+
+	glGenBuffers( 1, &_cubeVBO );
+	glBindBuffer( GL_ARRAY_BUFFER, _cubeVBO );
+	glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * vertices.size(), &vertices[0], GL_STATIC_DRAW );
+
+	// upload through GL_ARRAY_BUFFER so whatever VAO is currently bound keeps its element binding
+	glGenBuffers( 1, &_cubeIBO );
+	glBindBuffer( GL_ARRAY_BUFFER, _cubeIBO );
+	glBufferData( GL_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), &indices[0], GL_STATIC_DRAW );
+
+	glGenBuffers( 1, &_instanceVBO );
+	glBindBuffer( GL_ARRAY_BUFFER, _instanceVBO );
+	glBufferData( GL_ARRAY_BUFFER, sizeof(CityBuilding) * _buildings.size(), &_buildings[0], GL_STATIC_DRAW );
+}
+
+inline GLuint CSCI441::City::_bindVAO( const VAOData &locations ) {
+	std::map< VAOData, GLuint >::iterator vaoIter = _vaos.find( locations );
+	if( vaoIter != _vaos.end() ) {
+		return vaoIter->second;
+	}
+
+	GLuint vaod;
+	glGenVertexArrays( 1, &vaod );
+	glBindVertexArray( vaod );
+
+	glBindBuffer( GL_ARRAY_BUFFER, _cubeVBO );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _cubeIBO );
+	if( locations.p != -1 ) {
+		glEnableVertexAttribArray( locations.p );
+		glVertexAttribPointer( locations.p, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 6, (void*)0 );
+	}
+	if( locations.n != -1 ) {
+		glEnableVertexAttribArray( locations.n );
+		glVertexAttribPointer( locations.n, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 6, (void*)(sizeof(GLfloat) * 3) );
+	}
+
+	// per building attributes advance once per instance instead of once per vertex
+	glBindBuffer( GL_ARRAY_BUFFER, _instanceVBO );
+	if( locations.ip != -1 ) {
+		glEnableVertexAttribArray( locations.ip );
+		glVertexAttribPointer( locations.ip, 3, GL_FLOAT, GL_FALSE, sizeof(CityBuilding), (void*)offsetof(CityBuilding, position) );
+		glVertexAttribDivisor( locations.ip, 1 );
+	}
+	if( locations.is != -1 ) {
+		glEnableVertexAttribArray( locations.is );
+		glVertexAttribPointer( locations.is, 3, GL_FLOAT, GL_FALSE, sizeof(CityBuilding), (void*)offsetof(CityBuilding, size) );
+		glVertexAttribDivisor( locations.is, 1 );
+	}
+	if( locations.ic != -1 ) {
+		glEnableVertexAttribArray( locations.ic );
+		glVertexAttribPointer( locations.ic, 4, GL_FLOAT, GL_FALSE, sizeof(CityBuilding), (void*)offsetof(CityBuilding, color) );
+		glVertexAttribDivisor( locations.ic, 1 );
+	}
+
+	_vaos.insert( std::pair< VAOData, GLuint >( locations, vaod ) );
+	return vaod;
+}
+
+inline void CSCI441_INTERNAL::extractFrustumPlanes( const glm::mat4 &viewProjectionMatrix, glm::vec4 planes[6] ) {
+	// each plane is the last row of the matrix plus or minus one of the others
+	const glm::mat4 &m = viewProjectionMatrix;
+	glm::vec4 row[4];
+	for( int r = 0; r < 4; r++ ) {
+		row[r] = glm::vec4( m[0][r], m[1][r], m[2][r], m[3][r] );
+	}
+	for( int p = 0; p < 6; p++ ) {
+		planes[p] = (p % 2 == 0) ? row[3] + row[p/2] : row[3] - row[p/2];
+		// unit normals so the plane equation gives true distances
+		planes[p] /= glm::length( glm::vec3( planes[p] ) );
+	}
+}
+
+inline GLint CSCI441_INTERNAL::testFrustumAABB( const glm::vec4 planes[6], GLuint planeMask, const glm::vec3 &boxMin, const glm::vec3 &boxMax ) {
+	glm::vec3 center = (boxMin + boxMax) * 0.5f;
+	glm::vec3 extent = (boxMax - boxMin) * 0.5f;
+	GLint straddled = 0;
+	for( GLuint p = 0; p < 6; p++ ) {
+		if( !(planeMask & (1 << p)) ) continue;
+		glm::vec3 normal( planes[p] );
+		GLfloat distance = glm::dot( normal, center ) + planes[p].w;
+		GLfloat radius = glm::dot( glm::abs( normal ), extent );
+		if( distance + radius < 0.0f ) return -1;
+		if( distance - radius < 0.0f ) straddled |= 1 << p;
+	}
+	return straddled;
+}
+
+inline GLuint CSCI441_INTERNAL::mortonKey( GLuint x, GLuint z ) {
+	// spread the low 16 bits of each apart and interleave them, x in the even bits
+	GLuint k[2] = { x & 0xFFFF, z & 0xFFFF };
+	for( int i = 0; i < 2; i++ ) {
+		k[i] = (k[i] | (k[i] << 8)) & 0x00FF00FF;
+		k[i] = (k[i] | (k[i] << 4)) & 0x0F0F0F0F;
+		k[i] = (k[i] | (k[i] << 2)) & 0x33333333;
+		k[i] = (k[i] | (k[i] << 1)) & 0x55555555;
+	}
+	return k[0] | (k[1] << 1);
+}
+
+inline void CSCI441_INTERNAL::generateCityCube( std::vector< GLfloat > &vertices, std::vector< GLushort > &indices ) {
+	// each face: outward normal, then two axes spanning it chosen so (u x v) = normal
+	static const GLfloat faces[6][9] = {
+		{  1, 0, 0,   0, 0,-1,   0, 1, 0 },
+		{ -1, 0, 0,   0, 0, 1,   0, 1, 0 },
+		{  0, 1, 0,   1, 0, 0,   0, 0,-1 },
+		{  0,-1, 0,   1, 0, 0,   0, 0, 1 },
+		{  0, 0, 1,   1, 0, 0,   0, 1, 0 },
+		{  0, 0,-1,  -1, 0, 0,   0, 1, 0 }
+	};
+	static const GLfloat corners[4][2] = { {-1,-1}, {1,-1}, {1,1}, {-1,1} };
+
+	vertices.clear();
+	indices.clear();
+	for( int f = 0; f < 6; f++ ) {
+		glm::vec3 n( faces[f][0], faces[f][1], faces[f][2] );
+		glm::vec3 u( faces[f][3], faces[f][4], faces[f][5] );
+		glm::vec3 v( faces[f][6], faces[f][7], faces[f][8] );
+		GLushort base = vertices.size() / 6;
+		for( int c = 0; c < 4; c++ ) {
+			// corners of the [-0.5, 0.5] cube, then lifted so the base sits on y = 0
+			glm::vec3 p = 0.5f * (n + corners[c][0] * u + corners[c][1] * v) + glm::vec3( 0.0f, 0.5f, 0.0f );
+			vertices.push_back( p.x );
+			vertices.push_back( p.y );
+			vertices.push_back( p.z );
+			vertices.push_back( n.x );
+			vertices.push_back( n.y );
+			vertices.push_back( n.z );
+		}
+		// counter-clockwise seen from outside
+		indices.push_back( base );
+		indices.push_back( base + 1 );
+		indices.push_back( base + 2 );
+		indices.push_back( base + 2 );
+		indices.push_back( base + 3 );
+		indices.push_back( base );
+	}
+}
+
+#endif // __CSCI441_CITY_3_HPP__
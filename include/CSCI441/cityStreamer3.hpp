@@ -0,0 +1,563 @@
+/** @file cityStreamer3.hpp
+  * @brief Unbounded procedural city streamed in chunks around the camera in OpenGL 3.3+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	The world is cut into square chunks of cells.  Every chunk within the view
+	*	radius of the camera is generated as its own CSCI441::City on a pool of
+	*	worker threads, nearest chunks first.  A building depends only on the seed
+	*	and its cell, so chunks line up seamlessly and come back identical after
+	*	they have been evicted.
+	*
+	*	update() must be called once per frame from the thread that owns the
+	*	OpenGL context.  It queues the chunks the camera now needs, uploads
+	*	finished chunks until the per frame byte budget is spent and frees the
+	*	least recently used chunks once more than the chunk limit are resident.
+	*	draw() renders every resident chunk whose bounds intersect the view
+	*	frustum, one instanced draw per chunk.
+	*
+	*	cull() may be called between update() and draw() to also skip what is
+	*	hidden.  It picks the buildings nearest the camera that cover the most of
+	*	the screen, rasterizes them as occluders into a CSCI441::OcclusionCuller
+	*	and tests every chunk, then every building, against the depth pyramid.
+	*	It only touches the CPU, so it overlaps the GPU finishing the previous
+	*	frame.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
+	*	@warning NOTE: This header file depends upon GLEW
+	*	@warning NOTE: This header file depends upon glm
+	*	@warning NOTE: Chunks are generated on std::thread workers.  Define CSCI441_NO_THREADS
+	*	before including this file on toolchains without std::thread support; each update()
+	*	then generates one chunk itself
+  */
+
+#ifndef __CSCI441_CITYSTREAMER_3_HPP__
+#define __CSCI441_CITYSTREAMER_3_HPP__
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <CSCI441/city3.hpp>
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @class CityStreamer
+		* @brief Generates, uploads and evicts chunks of an unbounded city around a moving camera
+		*/
+	class CityStreamer {
+	public:
+		/** @brief Starts the worker threads; no chunk exists until the first update()
+			* @param GLuint seed					- seed that determines every building
+			* @param GLint viewRadius			- chunks are kept within this many chunks of the camera
+			* @param GLint chunkCells			- cells along each side of a chunk, rounded up to even so streets line up
+			* @param GLfloat spacing			- distance between neighboring cell centers
+			* @param GLfloat density			- chance that a cell between streets holds a building
+			*/
+		CityStreamer( GLuint seed, GLint viewRadius = 4, GLint chunkCells = 32, GLfloat spacing = 1.1f, GLfloat density = 0.4f );
+		/** @brief Stops the worker threads and frees every chunk on both CPU and GPU
+			*/
+		~CityStreamer();
+
+		/** @brief Sets how many bytes update() may send to the GPU each frame
+			*
+			*	At least one finished chunk is uploaded per frame however small the budget.
+			*
+			* @param GLuint bytesPerFrame	- upload budget
+			*/
+		void setUploadBudget( GLuint bytesPerFrame );
+		/** @brief Sets how many chunks may stay resident before the least recently used are freed
+			*
+			*	Never drops below the number of chunks inside the view radius.
+			*
+			* @param GLuint maxChunks	- chunk limit
+			*/
+		void setMaxChunks( GLuint maxChunks );
+
+		/** @brief Requests, uploads and evicts chunks for the camera's new position
+			* @param glm::vec3 cameraPosition	- world position of the camera
+			*/
+		void update( glm::vec3 cameraPosition );
+		/** @brief Finds the chunks and buildings the next draw() renders
+			*
+			*	Without an occlusion culler only whole chunks outside the frustum are
+			*	dropped, which is what draw() does on its own.  Runs on the CPU alone.
+			*
+			* @param glm::mat4 viewProjectionMatrix						- projection matrix times view matrix of the camera
+			* @param glm::vec3 cameraPosition									- world position of the camera
+			* @param CSCI441::OcclusionCuller* occlusionCuller	- if not NULL, filled with occluders and used to hide chunks and buildings
+			* @param GLuint maxOccluders											- most buildings rasterized as occluders
+			*/
+		void cull( const glm::mat4 &viewProjectionMatrix, glm::vec3 cameraPosition, OcclusionCuller *occlusionCuller = NULL, GLuint maxOccluders = 128 );
+		/** @brief Renders every resident chunk inside the view frustum
+			*
+			*	Draws what the last cull() kept when it was given the same matrix since
+			*	the last update(), otherwise culls chunks against the frustum itself.
+			*
+			* @param glm::mat4 viewProjectionMatrix	- projection matrix times view matrix of the camera
+			* @param GLint positionLocation					- attribute location of the unit cube vertex position
+			* @param GLint normalLocation						- attribute location of the unit cube vertex normal
+			* @param GLint instancePositionLocation	- attribute location of the building base position
+			* @param GLint instanceSizeLocation			- attribute location of the building size
+			* @param GLint instanceColorLocation		- attribute location of the building color
+			*/
+		void draw( const glm::mat4 &viewProjectionMatrix, GLint positionLocation, GLint normalLocation, GLint instancePositionLocation, GLint instanceSizeLocation, GLint instanceColorLocation );
+
+		/** @brief Returns the number of chunks uploaded and ready to draw
+			* @return number of resident chunks
+			*/
+		GLuint getNumChunks() const;
+		/** @brief Returns the number of chunks queued, being generated or waiting for upload
+			* @return number of pending chunks
+			*/
+		GLuint getNumPending();
+		/** @brief Returns the number of bytes the last update() uploaded
+			* @return bytes uploaded
+			*/
+		GLuint getLastUploadBytes() const;
+		/** @brief Returns the number of chunks freed so far
+			* @return number of evictions
+			*/
+		GLuint getNumEvicted() const;
+		/** @brief Returns the number of chunks the last draw() rendered
+			* @return number of drawn chunks
+			*/
+		GLuint getNumDrawnChunks() const;
+		/** @brief Returns the number of buildings the last draw() rendered
+			* @return number of drawn buildings
+			*/
+		GLuint getNumDrawnBuildings() const;
+		/** @brief Returns the number of buildings the last cull() rasterized as occluders
+			* @return number of occluders
+			*/
+		GLuint getNumOccluders() const;
+		/** @brief Returns the number of chunks inside the frustum the last cull() found hidden
+			* @return number of occluded chunks
+			*/
+		GLuint getNumOccludedChunks() const;
+		/** @brief Returns the number of buildings inside the frustum the last cull() found hidden
+			* @return number of occluded buildings, including those of occluded chunks
+			*/
+		GLuint getNumOccludedBuildings() const;
+		/** @brief Returns how long the last cull() took, choosing and rasterizing occluders included
+			* @return time in milliseconds
+			*/
+		GLdouble getCullTime() const;
+
+	private:
+		typedef std::pair< GLint, GLint > ChunkKey;
+
+		struct Chunk {
+			City *city;
+			GLuint lastUsed;								// frame that last wanted the chunk
+			std::list< ChunkKey >::iterator lruEntry;		// most recently used first
+		};
+
+		City* _generateChunk( ChunkKey key ) const;
+		void _queueChunks( const std::vector< ChunkKey > &missing );
+		void _collectFinished();
+		void _uploadReady( glm::ivec2 cameraChunk );
+		void _evict();
+#ifndef CSCI441_NO_THREADS
+		void _work();
+#endif
+
+		GLuint _seed;
+		GLint _viewRadius, _chunkCells;
+		GLfloat _spacing, _density;
+		GLuint _uploadBudget, _maxChunks;
+
+		std::map< ChunkKey, Chunk > _chunks;			// uploaded
+		std::list< ChunkKey > _lru;
+		std::map< ChunkKey, City* > _ready;				// generated, waiting for upload
+		GLuint _frame;
+
+		// shared with the workers, guarded by _mutex
+		std::deque< ChunkKey > _queue;
+		std::set< ChunkKey > _inFlight;
+		std::vector< std::pair< ChunkKey, City* > > _finished;
+#ifndef CSCI441_NO_THREADS
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::vector< std::thread > _workers;
+		bool _stopping;
+#endif
+
+		// chunks kept by the last cull(), valid until the next update()
+		std::vector< City* > _visibleChunks;
+		glm::mat4 _cullViewProjection;
+		bool _culled;
+
+		GLuint _lastUploadBytes, _numEvicted, _numDrawnChunks, _numDrawnBuildings;
+		GLuint _numOccluders, _numOccludedChunks, _numOccludedBuildings;
+		GLdouble _cullTime;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::CityStreamer::CityStreamer( GLuint seed, GLint viewRadius, GLint chunkCells, GLfloat spacing, GLfloat density ) {
+	_seed = seed;
+	_viewRadius = viewRadius < 1 ? 1 : viewRadius;
+	_chunkCells = chunkCells < 2 ? 2 : chunkCells + (chunkCells & 1);
+	_spacing = spacing;
+	_density = density;
+	_uploadBudget = 256 * 1024;
+	_maxChunks = 0;
+	setMaxChunks( 2 * (2*_viewRadius + 1) * (2*_viewRadius + 1) );
+	_frame = 0;
+	_culled = false;
+	_lastUploadBytes = _numEvicted = _numDrawnChunks = _numDrawnBuildings = 0;
+	_numOccluders = _numOccludedChunks = _numOccludedBuildings = 0;
+	_cullTime = 0.0;
+
+#ifndef CSCI441_NO_THREADS
+	// leave a core for the thread that renders
+	_stopping = false;
+	GLuint numWorkers = std::thread::hardware_concurrency();
+	numWorkers = numWorkers > 1 ? numWorkers - 1 : 1;
+	for( GLuint w = 0; w < numWorkers; w++ ) {
+		_workers.push_back( std::thread( &CityStreamer::_work, this ) );
+	}
+#endif
+}
+
+inline CSCI441::CityStreamer::~CityStreamer() {
+#ifndef CSCI441_NO_THREADS
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		_stopping = true;
+		_queue.clear();
+	}
+	_wake.notify_all();
+	for( size_t w = 0; w < _workers.size(); w++ ) {
+		_workers[w].join();
+	}
+#endif
+	for( size_t i = 0; i < _finished.size(); i++ ) delete _finished[i].second;
+	for( std::map< ChunkKey, City* >::iterator readyIter = _ready.begin(); readyIter != _ready.end(); readyIter++ ) {
+		delete readyIter->second;
+	}
+	for( std::map< ChunkKey, Chunk >::iterator chunkIter = _chunks.begin(); chunkIter != _chunks.end(); chunkIter++ ) {
+		delete chunkIter->second.city;
+	}
+}
+
+inline void CSCI441::CityStreamer::setUploadBudget( GLuint bytesPerFrame ) {
+	_uploadBudget = bytesPerFrame;
+}
+
+inline void CSCI441::CityStreamer::setMaxChunks( GLuint maxChunks ) {
+	// the disc of chunks around the camera must always fit
+	GLuint inView = (2*_viewRadius + 1) * (2*_viewRadius + 1);
+	_maxChunks = maxChunks < inView ? inView : maxChunks;
+}
+
+inline void CSCI441::CityStreamer::update( glm::vec3 cameraPosition ) {
+	_frame++;
+	_culled = false;
+	GLfloat chunkSize = _chunkCells * _spacing;
+	glm::ivec2 cameraChunk( (GLint)floorf( cameraPosition.x / chunkSize ), (GLint)floorf( cameraPosition.z / chunkSize ) );
+
+	// every chunk on the disc around the camera, nearest first
+	std::vector< std::pair< GLint, ChunkKey > > wanted;
+	for( GLint dx = -_viewRadius; dx <= _viewRadius; dx++ ) {
+		for( GLint dz = -_viewRadius; dz <= _viewRadius; dz++ ) {
+			if( dx*dx + dz*dz > _viewRadius*_viewRadius ) continue;
+			wanted.push_back( std::pair< GLint, ChunkKey >( dx*dx + dz*dz, ChunkKey( cameraChunk.x + dx, cameraChunk.y + dz ) ) );
+		}
+	}
+	std::sort( wanted.begin(), wanted.end() );
+
+	std::vector< ChunkKey > missing;
+	for( size_t i = 0; i < wanted.size(); i++ ) {
+		std::map< ChunkKey, Chunk >::iterator chunkIter = _chunks.find( wanted[i].second );
+		if( chunkIter != _chunks.end() ) {
+			chunkIter->second.lastUsed = _frame;
+			_lru.splice( _lru.begin(), _lru, chunkIter->second.lruEntry );
+		} else if( _ready.find( wanted[i].second ) == _ready.end() ) {
+			missing.push_back( wanted[i].second );
+		}
+	}
+
+	_queueChunks( missing );
+	_collectFinished();
+	_uploadReady( cameraChunk );
+	_evict();
+}
+
+inline void CSCI441::CityStreamer::cull( const glm::mat4 &viewProjectionMatrix, glm::vec3 cameraPosition, OcclusionCuller *occlusionCuller, GLuint maxOccluders ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	glm::vec4 planes[6];
+	CSCI441_INTERNAL::extractFrustumPlanes( viewProjectionMatrix, planes );
+
+	// chunks inside the frustum along with the planes they straddle
+	std::vector< std::pair< City*, GLint > > inFrustum;
+	for( std::map< ChunkKey, Chunk >::iterator chunkIter = _chunks.begin(); chunkIter != _chunks.end(); chunkIter++ ) {
+		City *city = chunkIter->second.city;
+		glm::vec3 boundsMin, boundsMax;
+		if( !city->getBounds( boundsMin, boundsMax ) ) continue;
+		GLint mask = CSCI441_INTERNAL::testFrustumAABB( planes, 0x3F, boundsMin, boundsMax );
+		if( mask < 0 ) continue;
+		inFrustum.push_back( std::pair< City*, GLint >( city, mask ) );
+	}
+
+	_numOccluders = 0;
+	if( occlusionCuller != NULL ) {
+		// the best occluders are near and large; rank the buildings close to the
+		// camera by roughly how much of the screen their broad side covers
+		GLfloat reach = 1.5f * _chunkCells * _spacing;
+		std::vector< std::pair< GLfloat, const CityBuilding* > > candidates;
+		for( size_t c = 0; c < inFrustum.size(); c++ ) {
+			glm::vec3 boundsMin, boundsMax;
+			inFrustum[c].first->getBounds( boundsMin, boundsMax );
+			if( glm::length( glm::clamp( cameraPosition, boundsMin, boundsMax ) - cameraPosition ) > reach ) continue;
+
+			const std::vector< CityBuilding > &buildings = inFrustum[c].first->getBuildings();
+			for( size_t b = 0; b < buildings.size(); b++ ) {
+				const CityBuilding &building = buildings[b];
+				glm::vec3 halfSize( building.size.x * 0.5f, 0.0f, building.size.z * 0.5f );
+				glm::vec3 boxMin = building.position - halfSize, boxMax = building.position + halfSize + glm::vec3( 0.0f, building.size.y, 0.0f );
+				if( CSCI441_INTERNAL::testFrustumAABB( planes, 0x3F, boxMin, boxMax ) < 0 ) continue;
+
+				glm::vec3 offset = (boxMin + boxMax) * 0.5f - cameraPosition;
+				GLfloat coverage = std::max( building.size.x, building.size.z ) * building.size.y / std::max( glm::dot( offset, offset ), 1e-4f );
+				candidates.push_back( std::pair< GLfloat, const CityBuilding* >( -coverage, &building ) );
+			}
+		}
+		_numOccluders = std::min( (GLuint)candidates.size(), maxOccluders );
+		std::partial_sort( candidates.begin(), candidates.begin() + _numOccluders, candidates.end() );
+
+		occlusionCuller->begin( viewProjectionMatrix );
+		for( GLuint o = 0; o < _numOccluders; o++ ) {
+			const CityBuilding &building = *candidates[o].second;
+			glm::vec3 halfSize( building.size.x * 0.5f, 0.0f, building.size.z * 0.5f );
+			occlusionCuller->addOccluder( building.position - halfSize, building.position + halfSize + glm::vec3( 0.0f, building.size.y, 0.0f ) );
+		}
+		occlusionCuller->end();
+	}
+
+	_visibleChunks.clear();
+	_numOccludedChunks = _numOccludedBuildings = 0;
+	for( size_t c = 0; c < inFrustum.size(); c++ ) {
+		City *city = inFrustum[c].first;
+		if( occlusionCuller == NULL ) {
+			city->clearCull();
+			_visibleChunks.push_back( city );
+			continue;
+		}
+
+		// only a chunk wholly inside the frustum has all its buildings counted as hidden
+		glm::vec3 boundsMin, boundsMax;
+		city->getBounds( boundsMin, boundsMax );
+		if( inFrustum[c].second == 0 && !occlusionCuller->isVisible( boundsMin, boundsMax ) ) {
+			_numOccludedChunks++;
+			_numOccludedBuildings += city->getNumBuildings();
+			continue;
+		}
+		city->cull( viewProjectionMatrix, occlusionCuller );
+		_numOccludedBuildings += city->getNumOccluded();
+		if( city->getNumVisible() > 0 ) _visibleChunks.push_back( city );
+	}
+
+	_cullViewProjection = viewProjectionMatrix;
+	_culled = true;
+	_cullTime = std::chrono::duration< GLdouble, std::milli >( std::chrono::steady_clock::now() - start ).count();
+}
+
+inline void CSCI441::CityStreamer::draw( const glm::mat4 &viewProjectionMatrix, GLint positionLocation, GLint normalLocation, GLint instancePositionLocation, GLint instanceSizeLocation, GLint instanceColorLocation ) {
+	if( !_culled || _cullViewProjection != viewProjectionMatrix ) {
+		cull( viewProjectionMatrix, glm::vec3( 0.0f, 0.0f, 0.0f ) );
+	}
+
+	_numDrawnChunks = _numDrawnBuildings = 0;
+	for( size_t c = 0; c < _visibleChunks.size(); c++ ) {
+		City *city = _visibleChunks[c];
+		city->draw( positionLocation, normalLocation, instancePositionLocation, instanceSizeLocation, instanceColorLocation );
+		_numDrawnChunks++;
+		_numDrawnBuildings += city->getNumVisible();
+	}
+}
+
+inline GLuint CSCI441::CityStreamer::getNumChunks() const {
+	return _chunks.size();
+}
+
+inline GLuint CSCI441::CityStreamer::getNumPending() {
+#ifndef CSCI441_NO_THREADS
+	std::lock_guard< std::mutex > lock( _mutex );
+#endif
+	return _queue.size() + _inFlight.size() + _finished.size() + _ready.size();
+}
+
+inline GLuint CSCI441::CityStreamer::getLastUploadBytes() const {
+	return _lastUploadBytes;
+}
+
+inline GLuint CSCI441::CityStreamer::getNumEvicted() const {
+	return _numEvicted;
+}
+
+inline GLuint CSCI441::CityStreamer::getNumDrawnChunks() const {
+	return _numDrawnChunks;
+}
+
+inline GLuint CSCI441::CityStreamer::getNumDrawnBuildings() const {
+	return _numDrawnBuildings;
+}
+
+inline GLuint CSCI441::CityStreamer::getNumOccluders() const {
+	return _numOccluders;
+}
+
+inline GLuint CSCI441::CityStreamer::getNumOccludedChunks() const {
+	return _numOccludedChunks;
+}
+
+inline GLuint CSCI441::CityStreamer::getNumOccludedBuildings() const {
+	return _numOccludedBuildings;
+}
+
+inline GLdouble CSCI441::CityStreamer::getCullTime() const {
+	return _cullTime;
+}
+
+inline CSCI441::City* CSCI441::CityStreamer::_generateChunk( ChunkKey key ) const {
+	return new City( _seed, glm::ivec2( key.first, key.second ) * _chunkCells, glm::ivec2( _chunkCells, _chunkCells ), _spacing, _density );
+}
+
+inline void CSCI441::CityStreamer::_queueChunks( const std::vector< ChunkKey > &missing ) {
+	{
+#ifndef CSCI441_NO_THREADS
+		std::lock_guard< std::mutex > lock( _mutex );
+#endif
+		// replace whatever is still waiting, so chunks the camera has left behind are
+		// never started and the nearest missing chunks go first
+		_queue.clear();
+		for( size_t i = 0; i < missing.size(); i++ ) {
+			if( _inFlight.find( missing[i] ) != _inFlight.end() ) continue;
+			bool finished = false;
+			for( size_t f = 0; f < _finished.size() && !finished; f++ ) {
+				finished = _finished[f].first == missing[i];
+			}
+			if( !finished ) _queue.push_back( missing[i] );
+		}
+	}
+#ifndef CSCI441_NO_THREADS
+	_wake.notify_all();
+#else
+	if( !_queue.empty() ) {
+		_finished.push_back( std::pair< ChunkKey, City* >( _queue.front(), _generateChunk( _queue.front() ) ) );
+		_queue.pop_front();
+	}
+#endif
+}
+
+inline void CSCI441::CityStreamer::_collectFinished() {
+	std::vector< std::pair< ChunkKey, City* > > finished;
+	{
+#ifndef CSCI441_NO_THREADS
+		std::lock_guard< std::mutex > lock( _mutex );
+#endif
+		finished.swap( _finished );
+	}
+	for( size_t i = 0; i < finished.size(); i++ ) {
+		_ready.insert( finished[i] );
+	}
+}
+
+inline void CSCI441::CityStreamer::_uploadReady( glm::ivec2 cameraChunk ) {
+	// nearest first, dropping chunks the camera has since flown away from
+	std::vector< std::pair< GLint, ChunkKey > > order;
+	for( std::map< ChunkKey, City* >::iterator readyIter = _ready.begin(); readyIter != _ready.end(); ) {
+		GLint dx = readyIter->first.first - cameraChunk.x, dz = readyIter->first.second - cameraChunk.y;
+		if( dx*dx + dz*dz > (_viewRadius + 1) * (_viewRadius + 1) ) {
+			delete readyIter->second;
+			_ready.erase( readyIter++ );
+			continue;
+		}
+		order.push_back( std::pair< GLint, ChunkKey >( dx*dx + dz*dz, readyIter->first ) );
+		readyIter++;
+	}
+	std::sort( order.begin(), order.end() );
+
+	_lastUploadBytes = 0;
+	for( size_t i = 0; i < order.size(); i++ ) {
+		City *city = _ready[ order[i].second ];
+		if( _lastUploadBytes > 0 && _lastUploadBytes + city->getUploadSize() > _uploadBudget ) break;
+
+		city->upload();
+		_lastUploadBytes += city->getUploadSize();
+		_ready.erase( order[i].second );
+
+		Chunk chunk;
+		chunk.city = city;
+		chunk.lastUsed = _frame;
+		chunk.lruEntry = _lru.insert( _lru.begin(), order[i].second );
+		_chunks.insert( std::pair< ChunkKey, Chunk >( order[i].second, chunk ) );
+	}
+}
+
+inline void CSCI441::CityStreamer::_evict() {
+	// the back of the list was used longest ago; stop at anything this frame still wants
+	while( _chunks.size() > _maxChunks ) {
+		std::map< ChunkKey, Chunk >::iterator chunkIter = _chunks.find( _lru.back() );
+		if( chunkIter->second.lastUsed == _frame ) break;
+
+		delete chunkIter->second.city;
+		_chunks.erase( chunkIter );
+		_lru.pop_back();
+		_numEvicted++;
+	}
+}
+
+#ifndef CSCI441_NO_THREADS
+inline void CSCI441::CityStreamer::_work() {
+	std::unique_lock< std::mutex > lock( _mutex );
+	while( true ) {
+		while( !_stopping && _queue.empty() ) {
+			_wake.wait( lock );
+		}
+		if( _stopping ) return;
+
+		ChunkKey key = _queue.front();
+		_queue.pop_front();
+		_inFlight.insert( key );
+
+		lock.unlock();
+		City *city = _generateChunk( key );
+		lock.lock();
+
+		_inFlight.erase( key );
+		_finished.push_back( std::pair< ChunkKey, City* >( key, city ) );
+	}
+}
+#endif
+
+#endif // __CSCI441_CITYSTREAMER_3_HPP__
@@ -0,0 +1,1854 @@
+/** @file imageDecoder.hpp
+  * @brief PNG and JPEG decoding into reused or caller provided buffers, with SOIL as the fallback
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	SOIL decodes each image on one thread into a freshly allocated buffer,
+	*	and flipping it for OpenGL is a second pass over every row.  The decoders
+	*	here write each row straight to its final place, flipped or not, in a
+	*	buffer the caller provides or one kept from an earlier image.
+	*
+	*	Baseline JPEGs with restart markers are entropy decoded one run of
+	*	restart intervals per thread.  Without markers the Huffman stream can
+	*	only be read in order, so other threads run the inverse DCT and color
+	*	conversion of each row of MCUs as soon as the row is read.  PNGs are
+	*	inflated, then unfiltered and expanded a row at a time.  loadImages()
+	*	decodes a list of files side by side.
+	*
+	*	The functions mirror SOIL_load_image() and friends, and decoders for
+	*	other formats can be registered ahead of the built in ones.  Whatever
+	*	no decoder accepts, such as progressive JPEGs, interlaced PNGs, TGAs,
+	*	and BMPs, is handed to SOIL, one thread at a time.
+	*
+	*	@warning NOTE: This header file depends upon SOIL
+	*	@warning NOTE: Images are decoded across std::thread workers.  Define CSCI441_NO_THREADS
+	*	before including this file on toolchains without std::thread support
+  */
+
+#ifndef __CSCI441_IMAGEDECODER_HPP__
+#define __CSCI441_IMAGEDECODER_HPP__
+
+#include <SOIL/SOIL.h>
+
+#include <CSCI441/imageKernels.hpp>
+#include <CSCI441/TextureUtils.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+	/** @namespace ImageDecoder
+	  * @brief Image file decoding that bypasses SOIL where it can
+	  */
+	namespace ImageDecoder {
+		/** @brief Options for decoding; combine with |
+			*/
+		enum DecodeFlags {
+			DECODE_FLIP_Y = 1		///< write the bottom row first, as OpenGL expects
+		};
+
+		/** @brief Reads the size of an image from its header without decoding it
+			* @param const unsigned char* data	- the whole file
+			* @param size_t size				- bytes in the file
+			* @param int* width					- set to the pixels across
+			* @param int* height				- set to the pixels down
+			* @param int* channels				- set to the channels the decoder will write, 1 to 4
+			* @return true if the decoder can decode this file
+			*/
+		typedef bool (*InfoFunction)( const unsigned char *data, size_t size, int *width, int *height, int *channels );
+		/** @brief Decodes an image its InfoFunction accepted
+			* @param const unsigned char* data	- the whole file
+			* @param size_t size				- bytes in the file
+			* @param unsigned char* pixels		- width*height*channels bytes to fill, rows packed with no padding
+			* @param unsigned int flags			- DecodeFlags to honor
+			* @param unsigned int numThreads	- threads the decoder may use, including the calling one
+			* @return true if every row was written
+			*/
+		typedef bool (*DecodeFunction)( const unsigned char *data, size_t size, unsigned char *pixels, unsigned int flags, unsigned int numThreads );
+
+		/** @brief Adds a decoder, tried before the ones already registered
+			*
+			*	The built in PNG and JPEG decoders are registered first, so a decoder
+			*	added here can take over any file they would accept.  Register
+			*	decoders before images start loading on other threads.
+			*
+			* @param InfoFunction info		- says whether a file is one the decoder handles
+			* @param DecodeFunction decode	- decodes the files info accepted
+			*/
+		void registerDecoder( InfoFunction info, DecodeFunction decode );
+
+		/** @brief Reads the size of an image a registered decoder accepts
+			* @param const unsigned char* data	- the whole file
+			* @param size_t size				- bytes in the file
+			* @param int* width					- set to the pixels across
+			* @param int* height				- set to the pixels down
+			* @param int* channels				- set to the channels in the file, 1 to 4
+			* @return false for formats only SOIL can read
+			*/
+		bool getImageInfo( const unsigned char *data, size_t size, int *width, int *height, int *channels );
+
+		/** @brief Decodes an image held in memory into a buffer the caller provides
+			* @param const unsigned char* data	- the whole file
+			* @param size_t size				- bytes in the file
+			* @param unsigned char* pixels		- buffer to write the pixels to
+			* @param size_t capacity			- bytes available at pixels
+			* @param int* width					- set to the pixels across
+			* @param int* height				- set to the pixels down
+			* @param int* channels				- set to the channels in the file
+			* @param int forceChannels			- SOIL_LOAD_AUTO to keep the file's channels, or 1 to 4 to convert to (default: SOIL_LOAD_AUTO)
+			* @param unsigned int flags			- DecodeFlags to apply (default: none)
+			* @return false if the image could not be decoded or does not fit in capacity
+			*/
+		bool decodeInto( const unsigned char *data, size_t size, unsigned char *pixels, size_t capacity, int *width, int *height, int *channels, int forceChannels = SOIL_LOAD_AUTO, unsigned int flags = 0 );
+
+		/** @brief Decodes an image held in memory, as SOIL_load_image_from_memory() does
+			* @param const unsigned char* data	- the whole file
+			* @param size_t size				- bytes in the file
+			* @param int* width					- set to the pixels across
+			* @param int* height				- set to the pixels down
+			* @param int* channels				- set to the channels in the file
+			* @param int forceChannels			- SOIL_LOAD_AUTO to keep the file's channels, or 1 to 4 to convert to (default: SOIL_LOAD_AUTO)
+			* @param unsigned int flags			- DecodeFlags to apply (default: none)
+			* @return pixels to release with freeImageData(), or NULL on failure
+			*/
+		unsigned char* loadImageFromMemory( const unsigned char *data, size_t size, int *width, int *height, int *channels, int forceChannels = SOIL_LOAD_AUTO, unsigned int flags = 0 );
+		/** @brief Decodes an image file, as SOIL_load_image() does
+			* @param const char* filename		- file to read
+			* @param int* width					- set to the pixels across
+			* @param int* height				- set to the pixels down
+			* @param int* channels				- set to the channels in the file
+			* @param int forceChannels			- SOIL_LOAD_AUTO to keep the file's channels, or 1 to 4 to convert to (default: SOIL_LOAD_AUTO)
+			* @param unsigned int flags			- DecodeFlags to apply (default: none)
+			* @return pixels to release with freeImageData(), or NULL on failure
+			*/
+		unsigned char* loadImage( const char *filename, int *width, int *height, int *channels, int forceChannels = SOIL_LOAD_AUTO, unsigned int flags = 0 );
+		/** @brief Releases pixels returned by any of the loading functions
+			*
+			*	The buffer is kept to decode later images into unless the buffers
+			*	already kept hold IMAGE_POOL_MAX_BYTES.
+			*
+			* @param unsigned char* pixels	- pixels to release; NULL is ignored
+			*/
+		void freeImageData( unsigned char *pixels );
+		/** @brief Explains why the last load on the calling thread failed
+			* @return a message that stays valid for the life of the program
+			*/
+		const char* getLastResult();
+
+		/** @struct ImageFile
+			* @brief One file for loadImages() to decode
+			*/
+		struct ImageFile {
+			const char *filename;		///< file to read
+			unsigned char *pixels;		///< decoded pixels to release with freeImageData(), or NULL if loading failed
+			int width;					///< pixels across
+			int height;					///< pixels down
+			int channels;				///< channels in the file
+		};
+
+		/** @brief Decodes several image files at once, one per thread
+			*
+			*	Threads left over once every file has one help decode the larger
+			*	JPEGs.  Each file's pixels are set as for loadImage().
+			*
+			* @param ImageFile* images		- files to load, with filename set
+			* @param int numImages			- entries in images
+			* @param int forceChannels		- SOIL_LOAD_AUTO to keep each file's channels, or 1 to 4 to convert to (default: SOIL_LOAD_AUTO)
+			* @param unsigned int flags		- DecodeFlags to apply to every file (default: none)
+			* @return the number of files that loaded
+			*/
+		int loadImages( ImageFile *images, int numImages, int forceChannels = SOIL_LOAD_AUTO, unsigned int flags = 0 );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal definitions
+
+namespace CSCI441_INTERNAL {
+	struct ImageDecoderEntry {
+		CSCI441::ImageDecoder::InfoFunction info;
+		CSCI441::ImageDecoder::DecodeFunction decode;
+	};
+	std::vector< ImageDecoderEntry >& getImageDecoders();
+	const char*& imageDecoderResult();
+	unsigned int getImageDecoderThreads();
+	unsigned char* decodeImage( const unsigned char *data, size_t size, int *width, int *height, int *channels, int forceChannels, unsigned int flags, unsigned int numThreads );
+	unsigned char* decodeImageWithSOIL( const unsigned char *data, size_t size, int *width, int *height, int *channels, int forceChannels, unsigned int flags );
+	// larger headers are refused outright rather than passed on to SOIL, whose int sizes would overflow
+	static const size_t IMAGE_MAX_PIXELS = (size_t)1 << 28;
+#ifndef CSCI441_NO_THREADS
+	// SOIL and its stb_image keep the last result in globals, so one thread at a time decodes through it
+	std::mutex& getSOILMutex();
+#endif
+	void convertImageChannels( const unsigned char *source, int sourceChannels, unsigned char *destination, int channels, size_t numPixels );
+
+	// buffers handed out by the decoders, kept once released for the next image of a similar size
+	struct ImageBufferPool {
+		std::multimap< size_t, unsigned char* > available;
+		std::map< unsigned char*, size_t > inUse;
+		size_t availableBytes;
+#ifndef CSCI441_NO_THREADS
+		std::mutex mutex;
+#endif
+		ImageBufferPool();
+		~ImageBufferPool();
+	};
+	ImageBufferPool& getImageBufferPool();
+	unsigned char* acquireImageBuffer( size_t size );
+	bool releaseImageBuffer( unsigned char *buffer );
+
+	// bytes of released buffers kept for reuse
+	static const size_t IMAGE_POOL_MAX_BYTES = 64 * 1024 * 1024;
+
+	struct ImageFileJob {
+		CSCI441::ImageDecoder::ImageFile *images;
+		int numImages, forceChannels;
+		unsigned int flags, threadsPerImage;
+		int nextImage;
+#ifndef CSCI441_NO_THREADS
+		std::mutex mutex;
+#endif
+	};
+	void loadImageFiles( ImageFileJob *job );
+
+	// ---- PNG ----
+
+	// a canonical Huffman code as DEFLATE packs it, lowest bit first
+	struct InflateTable {
+		unsigned short fast[1 << 10];		// (length << 9) | symbol for codes up to INFLATE_FAST_BITS long, 0 for longer ones
+		int maxCode[17];					// one past the last code of each length, shifted up to 16 bits
+		unsigned short firstCode[16], firstSymbol[16];
+		unsigned short symbols[288];
+	};
+	struct InflateFixedTables {
+		InflateTable lengths, distances;
+		InflateFixedTables();
+	};
+	struct InflateStream {
+		const unsigned char *next, *end;
+		unsigned long long bits;			// unread bits, the next one lowest
+		unsigned int count, overrun;
+		unsigned char *begin, *out, *outEnd;
+	};
+	bool buildInflateTable( InflateTable &table, const unsigned char *lengths, int numSymbols );
+	const InflateFixedTables& getInflateFixedTables();
+	void refillInflateStream( InflateStream &stream );
+	unsigned int readInflateBits( InflateStream &stream, unsigned int numBits );
+	int decodeInflateSymbol( InflateStream &stream, const InflateTable &table );
+	bool inflateBlock( InflateStream &stream, const InflateTable &lengths, const InflateTable &distances );
+	bool readInflateTables( InflateStream &stream, InflateTable &lengths, InflateTable &distances );
+	bool inflateZlib( const unsigned char *data, size_t size, unsigned char *out, size_t outSize );
+
+	struct PNGImage {
+		int width, height, bitDepth, colorType, interlace;
+		int samples;						// values per pixel in the file
+		int channels;						// bytes per pixel written out
+		unsigned char palette[256 * 4];
+		int paletteSize;
+		bool hasTransparency;
+		unsigned int transparent[3];		// gray or RGB sample that is fully transparent
+		std::vector< std::pair< const unsigned char*, size_t > > data;
+	};
+	bool readPNG( const unsigned char *data, size_t size, PNGImage &png );
+	bool getPNGInfo( const unsigned char *data, size_t size, int *width, int *height, int *channels );
+	bool decodePNG( const unsigned char *data, size_t size, unsigned char *pixels, unsigned int flags, unsigned int numThreads );
+	void unfilterPNGRow( unsigned char *row, const unsigned char *prior, size_t rowBytes, int bytesPerPixel, int filter );
+	void expandPNGRow( const unsigned char *row, const PNGImage &png, unsigned char *pixels );
+
+	static const unsigned char PNG_SIGNATURE[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+	// codes no longer than this decode with one table lookup
+	static const int INFLATE_FAST_BITS = 10;
+
+	// ---- JPEG ----
+
+	struct JPEGHuffmanTable {
+		unsigned short lookup[1 << 9];		// (length << 8) | symbol for codes up to JPEG_HUFFMAN_LOOKUP_BITS long, 0 for longer ones
+		int maxCode[18];					// largest code of each length, -1 when there are none
+		int valueOffset[17];				// subtracted from a code of each length to index symbols
+		unsigned char symbols[256];
+		bool defined;
+	};
+	struct JPEGComponent {
+		int id, h, v, quantTable;
+		int blocksX, blocksY;				// blocks stored, padded out to whole MCUs
+		short *coefficients;				// 64 per block in natural order, not yet dequantized
+	};
+	struct JPEGImage {
+		int width, height, numComponents;
+		int hMax, vMax, mcusX, mcusY;
+		int restartInterval;
+		bool sawFrame, sawJFIF, sawAdobe;
+		int adobeTransform;
+		JPEGComponent components[3];
+		unsigned short quantTables[4][64];	// natural order
+		JPEGHuffmanTable dcTables[4], acTables[4];
+	};
+	struct JPEGScan {
+		int numComponents;
+		int components[3], dcTables[3], acTables[3];
+		const unsigned char *begin, *end;	// entropy coded data
+		int mcusPerRow, numRows, numMCUs;
+	};
+	struct JPEGBitReader {
+		const unsigned char *next, *end;
+		unsigned long long bits;			// unread bits, the next one highest
+		int count;
+		bool atMarker;
+		int predictions[3];
+		int startMCU;						// MCU the reader began at, which needs no restart marker
+	};
+	struct JPEGTransformJob {
+		const JPEGImage *image;
+		unsigned char *pixels;
+		bool flip, rgb;
+		int rowsDecoded;					// rows of MCUs whose coefficients are all read
+		int nextRow;						// next row of MCUs to transform
+		bool failed;
+#ifndef CSCI441_NO_THREADS
+		std::mutex mutex;
+		std::condition_variable ready;
+#endif
+	};
+	struct JPEGColorTables {
+		int crToR[256], cbToB[256], crToG[256], cbToG[256];
+		unsigned char clamp[1024];			// value + JPEG_CLAMP_OFFSET limited to 0 through 255
+		JPEGColorTables();
+	};
+
+	bool buildJPEGHuffmanTable( JPEGHuffmanTable &table, const unsigned char counts[16], const unsigned char *symbols, int numSymbols );
+	int readJPEGMarkers( const unsigned char *data, size_t size, size_t &position, JPEGImage &image );
+	bool readJPEGFrame( const unsigned char *segment, size_t length, JPEGImage &image );
+	bool readJPEGScan( const unsigned char *data, size_t size, size_t &position, const JPEGImage &image, JPEGScan &scan, std::vector< const unsigned char* > *restarts );
+	bool getJPEGInfo( const unsigned char *data, size_t size, int *width, int *height, int *channels );
+	bool decodeJPEG( const unsigned char *data, size_t size, unsigned char *pixels, unsigned int flags, unsigned int numThreads );
+
+	void startJPEGBitReader( JPEGBitReader &reader, const unsigned char *begin, const unsigned char *end, int startMCU );
+	void fillJPEGBits( JPEGBitReader &reader );
+	int decodeJPEGHuffman( JPEGBitReader &reader, const JPEGHuffmanTable &table );
+	int receiveJPEGValue( JPEGBitReader &reader, int numBits );
+	void restartJPEGBitReader( JPEGBitReader &reader );
+	bool decodeJPEGBlock( JPEGBitReader &reader, const JPEGHuffmanTable &dc, const JPEGHuffmanTable &ac, int &prediction, short *coefficients );
+	bool decodeJPEGMCUs( JPEGBitReader &reader, const JPEGImage &image, const JPEGScan &scan, int firstMCU, int lastMCU );
+	bool decodeJPEGScan( const JPEGImage &image, const JPEGScan &scan, JPEGTransformJob *progress );
+	bool decodeJPEGIntervals( const JPEGImage &image, const JPEGScan &scan, const std::vector< const unsigned char* > &restarts, int numIntervals, unsigned int numThreads );
+	void decodeJPEGIntervalRange( const JPEGImage *image, const JPEGScan *scan, const unsigned char *begin, int firstMCU, int lastMCU, bool *succeeded );
+	void transformJPEGRows( JPEGTransformJob *job );
+	void transformJPEGRow( const JPEGTransformJob &job, int row, std::vector< unsigned char > planes[3], std::vector< unsigned char > upsampled[3] );
+	int clampJPEGIDCTInput( int value );
+	void idctJPEGBlock( const short *coefficients, const unsigned short *quant, unsigned char *out, int stride );
+	const JPEGColorTables& getJPEGColorTables();
+
+	// natural order index of each zigzag position
+	static const unsigned char JPEG_ZIGZAG[64] = {
+		 0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+		12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+		35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+		58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+	};
+	// codes no longer than this decode with one table lookup
+	static const int JPEG_HUFFMAN_LOOKUP_BITS = 9;
+	// lowest value the color conversion clamp table covers, negated
+	static const int JPEG_CLAMP_OFFSET = 384;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline void CSCI441::ImageDecoder::registerDecoder( InfoFunction info, DecodeFunction decode ) {
+	CSCI441_INTERNAL::ImageDecoderEntry entry;
+	entry.info = info;
+	entry.decode = decode;
+	std::vector< CSCI441_INTERNAL::ImageDecoderEntry > &decoders = CSCI441_INTERNAL::getImageDecoders();
+	decoders.insert( decoders.begin(), entry );
+}
+
+inline bool CSCI441::ImageDecoder::getImageInfo( const unsigned char *data, size_t size, int *width, int *height, int *channels ) {
+	const std::vector< CSCI441_INTERNAL::ImageDecoderEntry > &decoders = CSCI441_INTERNAL::getImageDecoders();
+	for( size_t i = 0; i < decoders.size(); i++ ) {
+		if( decoders[i].info( data, size, width, height, channels ) ) return true;
+	}
+	return false;
+}
+
+inline bool CSCI441::ImageDecoder::decodeInto( const unsigned char *data, size_t size, unsigned char *pixels, size_t capacity, int *width, int *height, int *channels, int forceChannels, unsigned int flags ) {
+	const std::vector< CSCI441_INTERNAL::ImageDecoderEntry > &decoders = CSCI441_INTERNAL::getImageDecoders();
+	for( size_t i = 0; i < decoders.size(); i++ ) {
+		if( !decoders[i].info( data, size, width, height, channels ) ) continue;
+
+		const int outChannels = forceChannels >= 1 && forceChannels <= 4 ? forceChannels : *channels;
+		const size_t numPixels = (size_t)*width * *height;
+		if( numPixels > CSCI441_INTERNAL::IMAGE_MAX_PIXELS ) {
+			CSCI441_INTERNAL::imageDecoderResult() = "Image is too large";
+			return false;
+		}
+		if( numPixels * outChannels > capacity ) {
+			CSCI441_INTERNAL::imageDecoderResult() = "Image does not fit in the buffer provided";
+			return false;
+		}
+		if( outChannels == *channels ) {
+			if( decoders[i].decode( data, size, pixels, flags, CSCI441_INTERNAL::getImageDecoderThreads() ) ) {
+				CSCI441_INTERNAL::imageDecoderResult() = "Image loaded";
+				return true;
+			}
+		} else {
+			unsigned char *decoded = CSCI441_INTERNAL::acquireImageBuffer( numPixels * *channels );
+			const bool succeeded = decoded && decoders[i].decode( data, size, decoded, flags, CSCI441_INTERNAL::getImageDecoderThreads() );
+			if( succeeded ) CSCI441_INTERNAL::convertImageChannels( decoded, *channels, pixels, outChannels, numPixels );
+			CSCI441_INTERNAL::releaseImageBuffer( decoded );
+			if( succeeded ) {
+				CSCI441_INTERNAL::imageDecoderResult() = "Image loaded";
+				return true;
+			}
+		}
+		break;
+	}
+
+	// formats no decoder takes, and files they failed on, go through SOIL and one extra copy
+	unsigned char *decoded = CSCI441_INTERNAL::decodeImageWithSOIL( data, size, width, height, channels, forceChannels, flags );
+	if( !decoded ) return false;
+	const int outChannels = forceChannels >= 1 && forceChannels <= 4 ? forceChannels : *channels;
+	const size_t bytes = (size_t)*width * *height * outChannels;
+	if( bytes <= capacity ) memcpy( pixels, decoded, bytes );
+	else CSCI441_INTERNAL::imageDecoderResult() = "Image does not fit in the buffer provided";
+	freeImageData( decoded );
+	return bytes <= capacity;
+}
+
+inline unsigned char* CSCI441::ImageDecoder::loadImageFromMemory( const unsigned char *data, size_t size, int *width, int *height, int *channels, int forceChannels, unsigned int flags ) {
+	return CSCI441_INTERNAL::decodeImage( data, size, width, height, channels, forceChannels, flags, CSCI441_INTERNAL::getImageDecoderThreads() );
+}
+
+inline unsigned char* CSCI441::ImageDecoder::loadImage( const char *filename, int *width, int *height, int *channels, int forceChannels, unsigned int flags ) {
+	CSCI441_INTERNAL::MappedFile file;
+	if( !CSCI441_INTERNAL::mapFile( filename, file ) ) {
+		CSCI441_INTERNAL::imageDecoderResult() = "Unable to open file";
+		return NULL;
+	}
+	unsigned char *pixels = loadImageFromMemory( file.data, file.size, width, height, channels, forceChannels, flags );
+	CSCI441_INTERNAL::unmapFile( file );
+	return pixels;
+}
+
+inline void CSCI441::ImageDecoder::freeImageData( unsigned char *pixels ) {
+	if( pixels && !CSCI441_INTERNAL::releaseImageBuffer( pixels ) ) {
+		SOIL_free_image_data( pixels );
+	}
+}
+
+inline const char* CSCI441::ImageDecoder::getLastResult() {
+	return CSCI441_INTERNAL::imageDecoderResult();
+}
+
+inline int CSCI441::ImageDecoder::loadImages( ImageFile *images, int numImages, int forceChannels, unsigned int flags ) {
+	if( numImages <= 0 ) return 0;
+
+	const unsigned int numThreads = CSCI441_INTERNAL::getImageDecoderThreads();
+	const unsigned int numWorkers = numThreads < (unsigned int)numImages ? numThreads : (unsigned int)numImages;
+
+	CSCI441_INTERNAL::ImageFileJob job;
+	job.images = images;
+	job.numImages = numImages;
+	job.forceChannels = forceChannels;
+	job.flags = flags;
+	job.threadsPerImage = numThreads / numWorkers;
+	job.nextImage = 0;
+
+#ifndef CSCI441_NO_THREADS
+	std::vector< std::thread > workers;
+	for( unsigned int t = 1; t < numWorkers; t++ ) {
+		workers.push_back( std::thread( CSCI441_INTERNAL::loadImageFiles, &job ) );
+	}
+#endif
+	CSCI441_INTERNAL::loadImageFiles( &job );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+
+	int numLoaded = 0;
+	for( int i = 0; i < numImages; i++ ) {
+		if( images[i].pixels ) numLoaded++;
+	}
+	return numLoaded;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function implementations
+
+inline std::vector< CSCI441_INTERNAL::ImageDecoderEntry >& CSCI441_INTERNAL::getImageDecoders() {
+	// built before any thread can ask for it, however many threads ask first
+	static const ImageDecoderEntry BUILT_IN[2] = { { getPNGInfo, decodePNG }, { getJPEGInfo, decodeJPEG } };
+	static std::vector< ImageDecoderEntry > decoders( BUILT_IN, BUILT_IN + 2 );
+	return decoders;
+}
+
+inline const char*& CSCI441_INTERNAL::imageDecoderResult() {
+#ifndef CSCI441_NO_THREADS
+	static thread_local const char *result = "No image loaded";
+#else
+	static const char *result = "No image loaded";
+#endif
+	return result;
+}
+
+inline unsigned int CSCI441_INTERNAL::getImageDecoderThreads() {
+#ifndef CSCI441_NO_THREADS
+	const unsigned int numThreads = std::thread::hardware_concurrency();
+	return numThreads > 0 ? numThreads : 1;
+#else
+	return 1;
+#endif
+}
+
+inline unsigned char* CSCI441_INTERNAL::decodeImage( const unsigned char *data, size_t size, int *width, int *height, int *channels, int forceChannels, unsigned int flags, unsigned int numThreads ) {
+	const std::vector< ImageDecoderEntry > &decoders = getImageDecoders();
+	for( size_t i = 0; i < decoders.size(); i++ ) {
+		if( !decoders[i].info( data, size, width, height, channels ) ) continue;
+
+		const int outChannels = forceChannels >= 1 && forceChannels <= 4 ? forceChannels : *channels;
+		const size_t numPixels = (size_t)*width * *height;
+		if( numPixels > IMAGE_MAX_PIXELS ) {
+			imageDecoderResult() = "Image is too large";
+			return NULL;
+		}
+		unsigned char *pixels = acquireImageBuffer( numPixels * outChannels );
+		if( !pixels ) break;
+		if( outChannels == *channels ) {
+			if( decoders[i].decode( data, size, pixels, flags, numThreads ) ) {
+				imageDecoderResult() = "Image loaded";
+				return pixels;
+			}
+		} else {
+			unsigned char *decoded = acquireImageBuffer( numPixels * *channels );
+			const bool succeeded = decoded && decoders[i].decode( data, size, decoded, flags, numThreads );
+			if( succeeded ) convertImageChannels( decoded, *channels, pixels, outChannels, numPixels );
+			releaseImageBuffer( decoded );
+			if( succeeded ) {
+				imageDecoderResult() = "Image loaded";
+				return pixels;
+			}
+		}
+		releaseImageBuffer( pixels );
+		break;
+	}
+
+	return decodeImageWithSOIL( data, size, width, height, channels, forceChannels, flags );
+}
+
+inline unsigned char* CSCI441_INTERNAL::decodeImageWithSOIL( const unsigned char *data, size_t size, int *width, int *height, int *channels, int forceChannels, unsigned int flags ) {
+	unsigned char *pixels;
+	{
+#ifndef CSCI441_NO_THREADS
+		std::lock_guard< std::mutex > lock( getSOILMutex() );
+#endif
+		pixels = SOIL_load_image_from_memory( data, (int)size, width, height, channels, forceChannels );
+		if( !pixels ) {
+			imageDecoderResult() = SOIL_last_result();
+			return NULL;
+		}
+	}
+	if( flags & CSCI441::ImageDecoder::DECODE_FLIP_Y ) {
+		const int outChannels = forceChannels >= 1 && forceChannels <= 4 ? forceChannels : *channels;
+		CSCI441::ImageKernels::flipRows( pixels, *width, *height, outChannels );
+	}
+	imageDecoderResult() = "Image loaded through SOIL";
+	return pixels;
+}
+
+#ifndef CSCI441_NO_THREADS
+inline std::mutex& CSCI441_INTERNAL::getSOILMutex() {
+	static std::mutex soilMutex;
+	return soilMutex;
+}
+#endif
+
+inline void CSCI441_INTERNAL::convertImageChannels( const unsigned char *source, int sourceChannels, unsigned char *destination, int channels, size_t numPixels ) {
+	const bool sourceColor = sourceChannels >= 3, sourceAlpha = sourceChannels == 2 || sourceChannels == 4;
+	for( size_t i = 0; i < numPixels; i++, source += sourceChannels, destination += channels ) {
+		// gray from color uses the same weights as SOIL
+		const unsigned char gray = sourceColor ? (unsigned char)( ( source[0] * 77 + source[1] * 150 + source[2] * 29 ) >> 8 ) : source[0];
+		const unsigned char alpha = sourceAlpha ? source[sourceChannels - 1] : 255;
+		switch( channels ) {
+			case 1:	destination[0] = gray;										break;
+			case 2:	destination[0] = gray;		destination[1] = alpha;			break;
+			case 3:
+			case 4:
+				destination[0] = sourceColor ? source[0] : gray;
+				destination[1] = sourceColor ? source[1] : gray;
+				destination[2] = sourceColor ? source[2] : gray;
+				if( channels == 4 ) destination[3] = alpha;
+				break;
+		}
+	}
+}
+
+inline CSCI441_INTERNAL::ImageBufferPool::ImageBufferPool() : availableBytes(0) {
+}
+
+inline CSCI441_INTERNAL::ImageBufferPool::~ImageBufferPool() {
+	for( std::multimap< size_t, unsigned char* >::iterator bufferIter = available.begin(); bufferIter != available.end(); bufferIter++ ) {
+		free( bufferIter->second );
+	}
+}
+
+inline CSCI441_INTERNAL::ImageBufferPool& CSCI441_INTERNAL::getImageBufferPool() {
+	static ImageBufferPool pool;
+	return pool;
+}
+
+inline unsigned char* CSCI441_INTERNAL::acquireImageBuffer( size_t size ) {
+	ImageBufferPool &pool = getImageBufferPool();
+#ifndef CSCI441_NO_THREADS
+	std::lock_guard< std::mutex > lock( pool.mutex );
+#endif
+	// reuse a kept buffer unless it would waste more than it holds
+	std::multimap< size_t, unsigned char* >::iterator bufferIter = pool.available.lower_bound( size );
+	unsigned char *buffer;
+	size_t capacity;
+	if( bufferIter != pool.available.end() && bufferIter->first <= size * 2 ) {
+		buffer = bufferIter->second;
+		capacity = bufferIter->first;
+		pool.availableBytes -= capacity;
+		pool.available.erase( bufferIter );
+	} else {
+		capacity = size > 0 ? size : 1;
+		buffer = (unsigned char*)malloc( capacity );
+		if( !buffer ) {
+			imageDecoderResult() = "Out of memory";
+			return NULL;
+		}
+	}
+	pool.inUse[ buffer ] = capacity;
+	return buffer;
+}
+
+inline bool CSCI441_INTERNAL::releaseImageBuffer( unsigned char *buffer ) {
+	if( !buffer ) return true;
+	ImageBufferPool &pool = getImageBufferPool();
+#ifndef CSCI441_NO_THREADS
+	std::lock_guard< std::mutex > lock( pool.mutex );
+#endif
+	std::map< unsigned char*, size_t >::iterator bufferIter = pool.inUse.find( buffer );
+	if( bufferIter == pool.inUse.end() ) return false;
+
+	const size_t capacity = bufferIter->second;
+	pool.inUse.erase( bufferIter );
+	if( pool.availableBytes + capacity <= IMAGE_POOL_MAX_BYTES ) {
+		pool.available.insert( std::pair< size_t, unsigned char* >( capacity, buffer ) );
+		pool.availableBytes += capacity;
+	} else {
+		free( buffer );
+	}
+	return true;
+}
+
+inline void CSCI441_INTERNAL::loadImageFiles( ImageFileJob *job ) {
+	for( ;; ) {
+		int i;
+		{
+#ifndef CSCI441_NO_THREADS
+			std::lock_guard< std::mutex > lock( job->mutex );
+#endif
+			if( job->nextImage >= job->numImages ) return;
+			i = job->nextImage++;
+		}
+
+		CSCI441::ImageDecoder::ImageFile &image = job->images[i];
+		image.pixels = NULL;
+		MappedFile file;
+		if( !mapFile( image.filename, file ) ) {
+			imageDecoderResult() = "Unable to open file";
+			continue;
+		}
+		image.pixels = decodeImage( file.data, file.size, &image.width, &image.height, &image.channels, job->forceChannels, job->flags, job->threadsPerImage );
+		unmapFile( file );
+	}
+}
+
+// ---- PNG ----
+
+inline bool CSCI441_INTERNAL::buildInflateTable( InflateTable &table, const unsigned char *lengths, int numSymbols ) {
+	int counts[16] = { 0 };
+	for( int i = 0; i < numSymbols; i++ ) counts[ lengths[i] ]++;
+	counts[0] = 0;
+
+	int nextCode[16];
+	int code = 0, symbol = 0;
+	for( int length = 1; length < 16; length++ ) {
+		nextCode[length] = code;
+		table.firstCode[length] = (unsigned short)code;
+		table.firstSymbol[length] = (unsigned short)symbol;
+		code += counts[length];
+		// more codes of a length than it has room for
+		if( counts[length] && code - 1 >= ( 1 << length ) ) return false;
+		table.maxCode[length] = code << ( 16 - length );
+		code <<= 1;
+		symbol += counts[length];
+	}
+	table.maxCode[16] = 0x10000;
+
+	memset( table.fast, 0, sizeof(table.fast) );
+	for( int i = 0; i < numSymbols; i++ ) {
+		const int length = lengths[i];
+		if( length == 0 ) continue;
+		const int index = nextCode[length] - table.firstCode[length] + table.firstSymbol[length];
+		table.symbols[index] = (unsigned short)i;
+		if( length <= INFLATE_FAST_BITS ) {
+			// the stream holds codes highest bit first, so the table is indexed by the reversed code
+			int reversed = 0;
+			for( int bit = 0; bit < length; bit++ ) {
+				reversed |= ( ( nextCode[length] >> bit ) & 1 ) << ( length - 1 - bit );
+			}
+			for( int j = reversed; j < ( 1 << INFLATE_FAST_BITS ); j += 1 << length ) {
+				table.fast[j] = (unsigned short)( ( length << 9 ) | i );
+			}
+		}
+		nextCode[length]++;
+	}
+	return true;
+}
+
+inline CSCI441_INTERNAL::InflateFixedTables::InflateFixedTables() {
+	unsigned char lengthCodes[288], distanceCodes[30];
+	for( int i = 0; i < 288; i++ ) {
+		lengthCodes[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+	}
+	memset( distanceCodes, 5, sizeof(distanceCodes) );
+	buildInflateTable( lengths, lengthCodes, 288 );
+	buildInflateTable( distances, distanceCodes, 30 );
+}
+
+inline const CSCI441_INTERNAL::InflateFixedTables& CSCI441_INTERNAL::getInflateFixedTables() {
+	static const InflateFixedTables tables;
+	return tables;
+}
+
+inline void CSCI441_INTERNAL::refillInflateStream( InflateStream &stream ) {
+	if( stream.end - stream.next >= 8 ) {
+		// eight bytes at once; only the whole ones that fit are counted as read
+		unsigned long long word = 0;
+		for( int i = 7; i >= 0; i-- ) word = ( word << 8 ) | stream.next[i];
+		stream.bits |= word << stream.count;
+		stream.next += ( 63 - stream.count ) >> 3;
+		stream.count |= 56;
+		return;
+	}
+	while( stream.count <= 56 ) {
+		if( stream.next < stream.end ) {
+			stream.bits |= (unsigned long long)*stream.next++ << stream.count;
+		} else {
+			stream.overrun++;
+		}
+		stream.count += 8;
+	}
+}
+
+inline unsigned int CSCI441_INTERNAL::readInflateBits( InflateStream &stream, unsigned int numBits ) {
+	if( stream.count < numBits ) refillInflateStream( stream );
+	const unsigned int value = (unsigned int)( stream.bits & ( ( 1ULL << numBits ) - 1 ) );
+	stream.bits >>= numBits;
+	stream.count -= numBits;
+	return value;
+}
+
+inline int CSCI441_INTERNAL::decodeInflateSymbol( InflateStream &stream, const InflateTable &table ) {
+	const unsigned int entry = table.fast[ stream.bits & ( ( 1 << INFLATE_FAST_BITS ) - 1 ) ];
+	if( entry ) {
+		const unsigned int length = entry >> 9;
+		stream.bits >>= length;
+		stream.count -= length;
+		return entry & 511;
+	}
+
+	// longer codes compare against the end of each length, highest bit first
+	unsigned int code = 0;
+	for( int bit = 0; bit < 16; bit++ ) {
+		code |= (unsigned int)( ( stream.bits >> bit ) & 1 ) << ( 15 - bit );
+	}
+	int length;
+	for( length = INFLATE_FAST_BITS + 1; length < 16; length++ ) {
+		if( (int)code < table.maxCode[length] ) break;
+	}
+	if( length >= 16 ) return -1;
+	const int index = ( code >> ( 16 - length ) ) - table.firstCode[length] + table.firstSymbol[length];
+	if( index >= 288 ) return -1;
+	stream.bits >>= length;
+	stream.count -= length;
+	return table.symbols[index];
+}
+
+inline bool CSCI441_INTERNAL::inflateBlock( InflateStream &stream, const InflateTable &lengths, const InflateTable &distances ) {
+	static const unsigned short LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	static const unsigned char LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	static const unsigned short DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	static const unsigned char DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	unsigned char *out = stream.out;
+	for( ;; ) {
+		// one refill covers the longest length code, distance code, and their extra bits together
+		if( stream.count < 48 ) refillInflateStream( stream );
+		if( stream.overrun > 8 ) return false;
+
+		int symbol = decodeInflateSymbol( stream, lengths );
+		if( symbol < 256 ) {
+			if( symbol < 0 || out >= stream.outEnd ) return false;
+			*out++ = (unsigned char)symbol;
+			continue;
+		}
+		if( symbol == 256 ) break;
+
+		symbol -= 257;
+		if( symbol >= 29 ) return false;
+		const size_t length = LENGTH_BASE[symbol] + readInflateBits( stream, LENGTH_EXTRA[symbol] );
+		const int distanceSymbol = decodeInflateSymbol( stream, distances );
+		if( distanceSymbol < 0 || distanceSymbol >= 30 ) return false;
+		const size_t distance = DISTANCE_BASE[distanceSymbol] + readInflateBits( stream, DISTANCE_EXTRA[distanceSymbol] );
+		if( distance > (size_t)( out - stream.begin ) || length > (size_t)( stream.outEnd - out ) ) return false;
+
+		const unsigned char *from = out - distance;
+		if( distance == 1 ) {
+			memset( out, *from, length );
+		} else if( distance >= 8 && (size_t)( stream.outEnd - out ) >= length + 8 ) {
+			// whole words at a time; the last may run past the match into bytes written later anyway
+			for( size_t i = 0; i < length; i += 8 ) memcpy( out + i, from + i, 8 );
+		} else {
+			for( size_t i = 0; i < length; i++ ) out[i] = from[i];
+		}
+		out += length;
+	}
+	stream.out = out;
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::readInflateTables( InflateStream &stream, InflateTable &lengths, InflateTable &distances ) {
+	static const unsigned char CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	const int numLengths = readInflateBits( stream, 5 ) + 257;
+	const int numDistances = readInflateBits( stream, 5 ) + 1;
+	const int numCodeLengths = readInflateBits( stream, 4 ) + 4;
+
+	unsigned char codeLengths[19] = { 0 };
+	for( int i = 0; i < numCodeLengths; i++ ) {
+		codeLengths[ CODE_LENGTH_ORDER[i] ] = (unsigned char)readInflateBits( stream, 3 );
+	}
+	InflateTable codeLengthTable;
+	if( !buildInflateTable( codeLengthTable, codeLengths, 19 ) ) return false;
+
+	unsigned char codes[286 + 32];
+	int numCodes = 0;
+	while( numCodes < numLengths + numDistances ) {
+		if( stream.count < 24 ) refillInflateStream( stream );
+		const int symbol = decodeInflateSymbol( stream, codeLengthTable );
+		if( symbol < 0 || symbol > 18 ) return false;
+		if( symbol < 16 ) {
+			codes[numCodes++] = (unsigned char)symbol;
+			continue;
+		}
+
+		int repeat;
+		unsigned char value = 0;
+		if( symbol == 16 ) {
+			if( numCodes == 0 ) return false;
+			value = codes[numCodes - 1];
+			repeat = 3 + readInflateBits( stream, 2 );
+		} else if( symbol == 17 ) {
+			repeat = 3 + readInflateBits( stream, 3 );
+		} else {
+			repeat = 11 + readInflateBits( stream, 7 );
+		}
+		if( numCodes + repeat > numLengths + numDistances ) return false;
+		memset( codes + numCodes, value, repeat );
+		numCodes += repeat;
+	}
+	if( stream.overrun > 8 ) return false;
+
+	return buildInflateTable( lengths, codes, numLengths ) && buildInflateTable( distances, codes + numLengths, numDistances );
+}
+
+inline bool CSCI441_INTERNAL::inflateZlib( const unsigned char *data, size_t size, unsigned char *out, size_t outSize ) {
+	// two byte header: deflate, no preset dictionary
+	if( size < 2 || ( data[0] & 15 ) != 8 || ( data[1] & 32 ) || ( data[0] * 256 + data[1] ) % 31 != 0 ) return false;
+
+	InflateStream stream;
+	stream.next = data + 2;
+	stream.end = data + size;
+	stream.bits = 0;
+	stream.count = 0;
+	stream.overrun = 0;
+	stream.begin = stream.out = out;
+	stream.outEnd = out + outSize;
+
+	InflateTable *dynamicTables = NULL;
+	bool finalBlock = false;
+	while( !finalBlock ) {
+		finalBlock = readInflateBits( stream, 1 ) != 0;
+		const unsigned int type = readInflateBits( stream, 2 );
+		bool succeeded;
+		if( type == 0 ) {
+			// stored: drop to the byte boundary, then copy what the bit buffer still holds before the rest
+			readInflateBits( stream, stream.count & 7 );
+			const unsigned int length = readInflateBits( stream, 16 );
+			const unsigned int inverse = readInflateBits( stream, 16 );
+			succeeded = ( length ^ 0xFFFF ) == inverse && length <= (size_t)( stream.outEnd - stream.out );
+			unsigned int copied = 0;
+			while( succeeded && copied < length && stream.count > 0 ) {
+				*stream.out++ = (unsigned char)readInflateBits( stream, 8 );
+				copied++;
+			}
+			if( succeeded && copied < length ) {
+				// the buffer may still hold bytes read ahead of next, which are about to be skipped
+				stream.bits = 0;
+				succeeded = length - copied <= (size_t)( stream.end - stream.next );
+				if( succeeded ) {
+					memcpy( stream.out, stream.next, length - copied );
+					stream.out += length - copied;
+					stream.next += length - copied;
+				}
+			}
+		} else if( type == 1 ) {
+			succeeded = inflateBlock( stream, getInflateFixedTables().lengths, getInflateFixedTables().distances );
+		} else if( type == 2 ) {
+			if( !dynamicTables ) dynamicTables = new InflateTable[2];
+			succeeded = readInflateTables( stream, dynamicTables[0], dynamicTables[1] )
+					 && inflateBlock( stream, dynamicTables[0], dynamicTables[1] );
+		} else {
+			succeeded = false;
+		}
+		if( !succeeded ) {
+			delete[] dynamicTables;
+			return false;
+		}
+	}
+	delete[] dynamicTables;
+	return stream.out == stream.outEnd;
+}
+
+inline bool CSCI441_INTERNAL::readPNG( const unsigned char *data, size_t size, PNGImage &png ) {
+	if( size < 33 || memcmp( data, PNG_SIGNATURE, 8 ) != 0 || memcmp( data + 12, "IHDR", 4 ) != 0 ) return false;
+
+	const unsigned char *header = data + 16;
+	const unsigned int width = ( (unsigned int)header[0] << 24 ) | ( header[1] << 16 ) | ( header[2] << 8 ) | header[3];
+	const unsigned int height = ( (unsigned int)header[4] << 24 ) | ( header[5] << 16 ) | ( header[6] << 8 ) | header[7];
+	// the PNG specification keeps both below 2^31
+	if( width > 0x7FFFFFFF || height > 0x7FFFFFFF ) return false;
+	png.width = (int)width;
+	png.height = (int)height;
+	png.bitDepth = header[8];
+	png.colorType = header[9];
+	png.interlace = header[12];
+	png.paletteSize = 0;
+	png.hasTransparency = false;
+	png.data.clear();
+
+	static const int SAMPLES[7] = { 1, 0, 3, 1, 2, 0, 4 };
+	if( png.width <= 0 || png.height <= 0 || png.colorType > 6 || SAMPLES[png.colorType] == 0
+		|| header[10] != 0 || header[11] != 0 ) return false;
+	png.samples = SAMPLES[png.colorType];
+	const bool validDepth = png.colorType == 0 ? ( png.bitDepth == 1 || png.bitDepth == 2 || png.bitDepth == 4 || png.bitDepth == 8 || png.bitDepth == 16 )
+						  : png.colorType == 3 ? ( png.bitDepth == 1 || png.bitDepth == 2 || png.bitDepth == 4 || png.bitDepth == 8 )
+						  : ( png.bitDepth == 8 || png.bitDepth == 16 );
+	// Adam7 interlacing is left to SOIL
+	if( !validDepth || png.interlace != 0 ) return false;
+
+	size_t position = 8;
+	while( position + 12 <= size ) {
+		const unsigned char *chunk = data + position;
+		const size_t length = ( (size_t)chunk[0] << 24 ) | ( chunk[1] << 16 ) | ( chunk[2] << 8 ) | chunk[3];
+		if( length > size - position - 12 ) return false;
+		const unsigned char *contents = chunk + 8;
+
+		if( memcmp( chunk + 4, "PLTE", 4 ) == 0 ) {
+			png.paletteSize = (int)( length / 3 );
+			if( png.paletteSize > 256 ) return false;
+			for( int i = 0; i < png.paletteSize; i++ ) {
+				png.palette[i*4 + 0] = contents[i*3 + 0];
+				png.palette[i*4 + 1] = contents[i*3 + 1];
+				png.palette[i*4 + 2] = contents[i*3 + 2];
+				png.palette[i*4 + 3] = 255;
+			}
+		} else if( memcmp( chunk + 4, "tRNS", 4 ) == 0 ) {
+			png.hasTransparency = true;
+			if( png.colorType == 3 ) {
+				for( size_t i = 0; i < length && i < 256; i++ ) png.palette[i*4 + 3] = contents[i];
+			} else if( png.colorType == 0 && length >= 2 ) {
+				png.transparent[0] = ( contents[0] << 8 ) | contents[1];
+			} else if( png.colorType == 2 && length >= 6 ) {
+				for( int i = 0; i < 3; i++ ) png.transparent[i] = ( contents[i*2] << 8 ) | contents[i*2 + 1];
+			} else {
+				png.hasTransparency = false;
+			}
+		} else if( memcmp( chunk + 4, "IDAT", 4 ) == 0 ) {
+			png.data.push_back( std::pair< const unsigned char*, size_t >( contents, length ) );
+		} else if( memcmp( chunk + 4, "IEND", 4 ) == 0 ) {
+			break;
+		}
+		position += length + 12;
+	}
+
+	if( png.data.empty() || ( png.colorType == 3 && png.paletteSize == 0 ) ) return false;
+	png.channels = png.colorType == 3 ? ( png.hasTransparency ? 4 : 3 ) : png.samples + ( png.hasTransparency ? 1 : 0 );
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::getPNGInfo( const unsigned char *data, size_t size, int *width, int *height, int *channels ) {
+	PNGImage png;
+	if( !readPNG( data, size, png ) ) return false;
+	*width = png.width;
+	*height = png.height;
+	*channels = png.channels;
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::decodePNG( const unsigned char *data, size_t size, unsigned char *pixels, unsigned int flags, unsigned int ) {
+	PNGImage png;
+	if( !readPNG( data, size, png ) ) return false;
+
+	// IDAT chunks are one zlib stream; only images split across several need it joined
+	const unsigned char *compressed = png.data[0].first;
+	size_t compressedSize = png.data[0].second;
+	unsigned char *joined = NULL;
+	if( png.data.size() > 1 ) {
+		compressedSize = 0;
+		for( size_t i = 0; i < png.data.size(); i++ ) compressedSize += png.data[i].second;
+		joined = acquireImageBuffer( compressedSize );
+		if( !joined ) return false;
+		size_t offset = 0;
+		for( size_t i = 0; i < png.data.size(); i++ ) {
+			memcpy( joined + offset, png.data[i].first, png.data[i].second );
+			offset += png.data[i].second;
+		}
+		compressed = joined;
+	}
+
+	// each row is a filter type byte and then the packed samples
+	const size_t rowBytes = ( (size_t)png.width * png.samples * png.bitDepth + 7 ) / 8;
+	const int bytesPerPixel = ( png.samples * png.bitDepth + 7 ) / 8;
+	unsigned char *filtered = acquireImageBuffer( ( rowBytes + 1 ) * png.height );
+	bool succeeded = filtered && inflateZlib( compressed, compressedSize, filtered, ( rowBytes + 1 ) * png.height );
+	releaseImageBuffer( joined );
+
+	if( succeeded ) {
+		const std::vector< unsigned char > zeros( rowBytes, 0 );
+		const unsigned char *prior = &zeros[0];
+		const size_t pixelRowBytes = (size_t)png.width * png.channels;
+		for( int y = 0; y < png.height && succeeded; y++ ) {
+			unsigned char *row = filtered + y * ( rowBytes + 1 );
+			if( row[0] > 4 ) {
+				succeeded = false;
+				break;
+			}
+			unfilterPNGRow( row + 1, prior, rowBytes, bytesPerPixel, row[0] );
+			const int outRow = ( flags & CSCI441::ImageDecoder::DECODE_FLIP_Y ) ? png.height - 1 - y : y;
+			expandPNGRow( row + 1, png, pixels + outRow * pixelRowBytes );
+			prior = row + 1;
+		}
+	}
+	releaseImageBuffer( filtered );
+	return succeeded;
+}
+
+inline void CSCI441_INTERNAL::unfilterPNGRow( unsigned char *row, const unsigned char *prior, size_t rowBytes, int bytesPerPixel, int filter ) {
+	const size_t bpp = (size_t)bytesPerPixel;
+	switch( filter ) {
+		case 1:		// sub
+			for( size_t i = bpp; i < rowBytes; i++ ) row[i] = (unsigned char)( row[i] + row[i - bpp] );
+			break;
+		case 2:		// up
+			for( size_t i = 0; i < rowBytes; i++ ) row[i] = (unsigned char)( row[i] + prior[i] );
+			break;
+		case 3:		// average
+			for( size_t i = 0; i < bpp && i < rowBytes; i++ ) row[i] = (unsigned char)( row[i] + ( prior[i] >> 1 ) );
+			for( size_t i = bpp; i < rowBytes; i++ ) row[i] = (unsigned char)( row[i] + ( ( row[i - bpp] + prior[i] ) >> 1 ) );
+			break;
+		case 4:		// Paeth
+			for( size_t i = 0; i < bpp && i < rowBytes; i++ ) row[i] = (unsigned char)( row[i] + prior[i] );
+			for( size_t i = bpp; i < rowBytes; i++ ) {
+				const int a = row[i - bpp], b = prior[i], c = prior[i - bpp];
+				const int p = a + b - c;
+				const int pa = abs( p - a ), pb = abs( p - b ), pc = abs( p - c );
+				row[i] = (unsigned char)( row[i] + ( pa <= pb && pa <= pc ? a : pb <= pc ? b : c ) );
+			}
+			break;
+	}
+}
+
+inline void CSCI441_INTERNAL::expandPNGRow( const unsigned char *row, const PNGImage &png, unsigned char *pixels ) {
+	const int width = png.width;
+	if( png.bitDepth == 8 && !png.hasTransparency && png.colorType != 3 ) {
+		memcpy( pixels, row, (size_t)width * png.channels );
+		return;
+	}
+	if( png.colorType == 3 ) {
+		const int depth = png.bitDepth, mask = ( 1 << depth ) - 1;
+		for( int x = 0; x < width; x++ ) {
+			const int index = depth == 8 ? row[x] : ( row[ ( x * depth ) >> 3 ] >> ( 8 - depth - ( ( x * depth ) & 7 ) ) ) & mask;
+			memcpy( pixels + x * png.channels, png.palette + index * 4, png.channels );
+		}
+		return;
+	}
+
+	// sixteen bit samples keep their high byte; gray below eight bits is scaled to fill the byte
+	static const int SCALE[9] = { 0, 255, 85, 0, 17, 0, 0, 0, 1 };
+	const int depth = png.bitDepth;
+	for( int x = 0; x < width; x++ ) {
+		bool transparent = png.hasTransparency;
+		for( int s = 0; s < png.samples; s++ ) {
+			unsigned int value;
+			unsigned char stored;
+			if( depth == 16 ) {
+				const unsigned char *sample = row + ( (size_t)x * png.samples + s ) * 2;
+				value = ( sample[0] << 8 ) | sample[1];
+				stored = sample[0];
+			} else if( depth == 8 ) {
+				value = stored = row[ (size_t)x * png.samples + s ];
+			} else {
+				value = ( row[ ( x * depth ) >> 3 ] >> ( 8 - depth - ( ( x * depth ) & 7 ) ) ) & ( ( 1 << depth ) - 1 );
+				stored = (unsigned char)( value * SCALE[depth] );
+			}
+			if( s < 3 && value != png.transparent[s] ) transparent = false;
+			pixels[ x * png.channels + s ] = stored;
+		}
+		if( png.hasTransparency ) pixels[ x * png.channels + png.samples ] = transparent ? 0 : 255;
+	}
+}
+
+// ---- JPEG ----
+
+inline bool CSCI441_INTERNAL::buildJPEGHuffmanTable( JPEGHuffmanTable &table, const unsigned char counts[16], const unsigned char *symbols, int numSymbols ) {
+	memset( table.lookup, 0, sizeof(table.lookup) );
+	memcpy( table.symbols, symbols, numSymbols );
+
+	int code = 0, symbol = 0;
+	for( int length = 1; length <= 16; length++ ) {
+		table.valueOffset[length] = symbol - code;
+		for( int i = 0; i < counts[length - 1]; i++, symbol++, code++ ) {
+			if( code >= ( 1 << length ) ) return false;
+			if( length <= JPEG_HUFFMAN_LOOKUP_BITS ) {
+				const int first = code << ( JPEG_HUFFMAN_LOOKUP_BITS - length );
+				for( int j = 0; j < ( 1 << ( JPEG_HUFFMAN_LOOKUP_BITS - length ) ); j++ ) {
+					table.lookup[first + j] = (unsigned short)( ( length << 8 ) | symbols[symbol] );
+				}
+			}
+		}
+		table.maxCode[length] = counts[length - 1] ? code - 1 : -1;
+		code <<= 1;
+	}
+	table.maxCode[17] = 0x7FFFFFFF;
+	table.defined = true;
+	return symbol == numSymbols;
+}
+
+inline int CSCI441_INTERNAL::readJPEGMarkers( const unsigned char *data, size_t size, size_t &position, JPEGImage &image ) {
+	while( position + 4 <= size ) {
+		if( data[position] != 0xFF ) return -1;
+		const int marker = data[position + 1];
+		// fill bytes before a marker
+		if( marker == 0xFF ) {
+			position++;
+			continue;
+		}
+		if( marker == 0xD8 || ( marker >= 0xD0 && marker <= 0xD7 ) || marker == 0x01 ) {
+			position += 2;
+			continue;
+		}
+		if( marker == 0xD9 || marker == 0xDA ) return marker;
+
+		const size_t length = ( data[position + 2] << 8 ) | data[position + 3];
+		if( length < 2 || position + 2 + length > size ) return -1;
+		const unsigned char *segment = data + position + 4;
+		const size_t segmentLength = length - 2;
+
+		switch( marker ) {
+			case 0xC0:		// baseline
+			case 0xC1:		// extended sequential, Huffman coded
+				if( !readJPEGFrame( segment, segmentLength, image ) ) return -1;
+				break;
+			case 0xC4: {
+				size_t offset = 0;
+				while( offset + 17 <= segmentLength ) {
+					const int tableClass = segment[offset] >> 4, tableIndex = segment[offset] & 15;
+					if( tableClass > 1 || tableIndex > 3 ) return -1;
+					int numSymbols = 0;
+					for( int i = 0; i < 16; i++ ) numSymbols += segment[offset + 1 + i];
+					if( numSymbols > 256 || offset + 17 + numSymbols > segmentLength ) return -1;
+					JPEGHuffmanTable &table = tableClass == 0 ? image.dcTables[tableIndex] : image.acTables[tableIndex];
+					if( !buildJPEGHuffmanTable( table, segment + offset + 1, segment + offset + 17, numSymbols ) ) return -1;
+					offset += 17 + numSymbols;
+				}
+			}	break;
+			case 0xDB: {
+				size_t offset = 0;
+				while( offset < segmentLength ) {
+					const int precision = segment[offset] >> 4, tableIndex = segment[offset] & 15;
+					if( precision > 1 || tableIndex > 3 || offset + 1 + 64 * ( precision + 1 ) > segmentLength ) return -1;
+					for( int i = 0; i < 64; i++ ) {
+						image.quantTables[tableIndex][ JPEG_ZIGZAG[i] ] = precision ? (unsigned short)( ( segment[offset + 1 + i*2] << 8 ) | segment[offset + 2 + i*2] )
+																	 : segment[offset + 1 + i];
+					}
+					offset += 1 + 64 * ( precision + 1 );
+				}
+			}	break;
+			case 0xDD:
+				if( segmentLength < 2 ) return -1;
+				image.restartInterval = ( segment[0] << 8 ) | segment[1];
+				break;
+			case 0xE0:
+				if( segmentLength >= 5 && memcmp( segment, "JFIF\0", 5 ) == 0 ) image.sawJFIF = true;
+				break;
+			case 0xEE:
+				if( segmentLength >= 12 && memcmp( segment, "Adobe", 5 ) == 0 ) {
+					image.sawAdobe = true;
+					image.adobeTransform = segment[11];
+				}
+				break;
+			default:
+				// progressive, lossless, hierarchical, and arithmetic coded frames are left to SOIL
+				if( marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC ) return -1;
+				break;
+		}
+		position += 2 + length;
+	}
+	return -1;
+}
+
+inline bool CSCI441_INTERNAL::readJPEGFrame( const unsigned char *segment, size_t length, JPEGImage &image ) {
+	if( image.sawFrame || length < 6 || segment[0] != 8 ) return false;
+	image.height = ( segment[1] << 8 ) | segment[2];
+	image.width = ( segment[3] << 8 ) | segment[4];
+	image.numComponents = segment[5];
+	// CMYK and YCCK are left to SOIL, as are frames whose height arrives later in a DNL marker
+	if( image.width == 0 || image.height == 0 || ( image.numComponents != 1 && image.numComponents != 3 ) || length < 6 + 3 * (size_t)image.numComponents ) return false;
+
+	image.hMax = image.vMax = 1;
+	for( int c = 0; c < image.numComponents; c++ ) {
+		JPEGComponent &component = image.components[c];
+		component.id = segment[6 + c*3];
+		component.h = segment[7 + c*3] >> 4;
+		component.v = segment[7 + c*3] & 15;
+		component.quantTable = segment[8 + c*3];
+		component.coefficients = NULL;
+		if( component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 || component.quantTable > 3 ) return false;
+		// a lone component is coded one block at a time whatever sampling it declares
+		if( image.numComponents == 1 ) component.h = component.v = 1;
+		if( component.h > image.hMax ) image.hMax = component.h;
+		if( component.v > image.vMax ) image.vMax = component.v;
+	}
+	image.mcusX = ( image.width + image.hMax * 8 - 1 ) / ( image.hMax * 8 );
+	image.mcusY = ( image.height + image.vMax * 8 - 1 ) / ( image.vMax * 8 );
+	for( int c = 0; c < image.numComponents; c++ ) {
+		JPEGComponent &component = image.components[c];
+		// chroma is upsampled by whole pixel repeats only
+		if( image.hMax % component.h != 0 || image.vMax % component.v != 0 ) return false;
+		component.blocksX = image.mcusX * component.h;
+		component.blocksY = image.mcusY * component.v;
+	}
+	image.sawFrame = true;
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::readJPEGScan( const unsigned char *data, size_t size, size_t &position, const JPEGImage &image, JPEGScan &scan, std::vector< const unsigned char* > *restarts ) {
+	if( position + 5 > size ) return false;
+	const size_t length = ( data[position + 2] << 8 ) | data[position + 3];
+	const unsigned char *segment = data + position + 4;
+	scan.numComponents = segment[0];
+	if( scan.numComponents < 1 || scan.numComponents > image.numComponents || length < 6 + 2 * (size_t)scan.numComponents || position + 2 + length > size ) return false;
+
+	for( int i = 0; i < scan.numComponents; i++ ) {
+		const int id = segment[1 + i*2];
+		scan.components[i] = -1;
+		for( int c = 0; c < image.numComponents; c++ ) {
+			if( image.components[c].id == id ) scan.components[i] = c;
+		}
+		scan.dcTables[i] = segment[2 + i*2] >> 4;
+		scan.acTables[i] = segment[2 + i*2] & 15;
+		if( scan.components[i] < 0 || scan.dcTables[i] > 3 || scan.acTables[i] > 3
+			|| !image.dcTables[ scan.dcTables[i] ].defined || !image.acTables[ scan.acTables[i] ].defined ) return false;
+	}
+
+	if( scan.numComponents == 1 ) {
+		// one component scans cover just the blocks inside the image, not whole MCUs
+		const JPEGComponent &component = image.components[ scan.components[0] ];
+		scan.mcusPerRow = ( ( image.width * component.h + image.hMax - 1 ) / image.hMax + 7 ) / 8;
+		scan.numRows = ( ( image.height * component.v + image.vMax - 1 ) / image.vMax + 7 ) / 8;
+	} else {
+		scan.mcusPerRow = image.mcusX;
+		scan.numRows = image.mcusY;
+	}
+	scan.numMCUs = scan.mcusPerRow * scan.numRows;
+
+	// the coded data runs to the first marker other than a restart
+	const unsigned char *next = segment + length - 2;
+	const unsigned char *end = data + size;
+	scan.begin = next;
+	while( next + 1 < end ) {
+		next = (const unsigned char*)memchr( next, 0xFF, end - next - 1 );
+		if( !next ) {
+			next = end;
+			break;
+		}
+		const unsigned char marker = next[1];
+		if( marker == 0x00 ) {
+			next += 2;
+		} else if( marker >= 0xD0 && marker <= 0xD7 ) {
+			next += 2;
+			if( restarts ) restarts->push_back( next );
+		} else if( marker == 0xFF ) {
+			next++;
+		} else {
+			break;
+		}
+	}
+	scan.end = next < end ? next : end;
+	position = scan.end - data;
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::getJPEGInfo( const unsigned char *data, size_t size, int *width, int *height, int *channels ) {
+	if( size < 4 || data[0] != 0xFF || data[1] != 0xD8 ) return false;
+	JPEGImage *image = new JPEGImage();
+	size_t position = 0;
+	const bool supported = readJPEGMarkers( data, size, position, *image ) == 0xDA && image->sawFrame;
+	if( supported ) {
+		*width = image->width;
+		*height = image->height;
+		*channels = image->numComponents;
+	}
+	delete image;
+	return supported;
+}
+
+inline bool CSCI441_INTERNAL::decodeJPEG( const unsigned char *data, size_t size, unsigned char *pixels, unsigned int flags, unsigned int numThreads ) {
+	if( size < 4 || data[0] != 0xFF || data[1] != 0xD8 ) return false;
+	JPEGImage *image = new JPEGImage();
+	size_t position = 0;
+	int marker = readJPEGMarkers( data, size, position, *image );
+	if( marker != 0xDA || !image->sawFrame ) {
+		delete image;
+		return false;
+	}
+
+	size_t numCoefficients = 0;
+	for( int c = 0; c < image->numComponents; c++ ) {
+		numCoefficients += (size_t)image->components[c].blocksX * image->components[c].blocksY * 64;
+	}
+	short *coefficients = (short*)acquireImageBuffer( numCoefficients * sizeof(short) );
+	if( !coefficients ) {
+		delete image;
+		return false;
+	}
+	memset( coefficients, 0, numCoefficients * sizeof(short) );
+	numCoefficients = 0;
+	for( int c = 0; c < image->numComponents; c++ ) {
+		image->components[c].coefficients = coefficients + numCoefficients;
+		numCoefficients += (size_t)image->components[c].blocksX * image->components[c].blocksY * 64;
+	}
+
+	JPEGTransformJob job;
+	job.image = image;
+	job.pixels = pixels;
+	job.flip = ( flags & CSCI441::ImageDecoder::DECODE_FLIP_Y ) != 0;
+	// JFIF files are always YCbCr; otherwise Adobe's transform flag or RGB component ids mark untransformed color
+	job.rgb = image->numComponents == 3 && !image->sawJFIF
+			&& ( image->sawAdobe ? image->adobeTransform == 0
+								 : image->components[0].id == 'R' && image->components[1].id == 'G' && image->components[2].id == 'B' );
+	job.rowsDecoded = 0;
+	job.nextRow = 0;
+	job.failed = false;
+
+#ifndef CSCI441_NO_THREADS
+	std::vector< std::thread > workers;
+#endif
+	bool succeeded = true, started = false;
+	for( int numScans = 0; marker == 0xDA && succeeded; numScans++ ) {
+		JPEGScan scan;
+		std::vector< const unsigned char* > restarts;
+		succeeded = readJPEGScan( data, size, position, *image, scan, image->restartInterval > 0 && numThreads > 1 ? &restarts : NULL );
+		if( !succeeded ) break;
+
+		// every restart interval after the first begins right after a marker
+		const int numIntervals = image->restartInterval > 0 ? ( scan.numMCUs + image->restartInterval - 1 ) / image->restartInterval : 0;
+		if( numIntervals >= 2 && !restarts.empty() && (int)restarts.size() + 1 >= numIntervals ) {
+			// the intervals are read side by side, so the rows can only be transformed afterward
+			succeeded = decodeJPEGIntervals( *image, scan, restarts, numIntervals, numThreads );
+		} else if( numScans == 0 && scan.numComponents == image->numComponents ) {
+			// one scan holds the whole image, so each row of MCUs can be transformed as soon as it is read
+#ifndef CSCI441_NO_THREADS
+			for( unsigned int t = 1; t < numThreads; t++ ) {
+				workers.push_back( std::thread( transformJPEGRows, &job ) );
+			}
+#endif
+			started = true;
+			succeeded = decodeJPEGScan( *image, scan, &job );
+			break;
+		} else {
+			succeeded = decodeJPEGScan( *image, scan, NULL );
+		}
+		marker = readJPEGMarkers( data, size, position, *image );
+	}
+
+	{
+#ifndef CSCI441_NO_THREADS
+		std::lock_guard< std::mutex > lock( job.mutex );
+#endif
+		job.rowsDecoded = image->mcusY;
+		job.failed = !succeeded;
+	}
+#ifndef CSCI441_NO_THREADS
+	job.ready.notify_all();
+	if( !started && succeeded ) {
+		for( unsigned int t = 1; t < numThreads; t++ ) {
+			workers.push_back( std::thread( transformJPEGRows, &job ) );
+		}
+	}
+#endif
+	if( succeeded ) transformJPEGRows( &job );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+
+	releaseImageBuffer( (unsigned char*)coefficients );
+	delete image;
+	return succeeded;
+}
+
+inline void CSCI441_INTERNAL::startJPEGBitReader( JPEGBitReader &reader, const unsigned char *begin, const unsigned char *end, int startMCU ) {
+	reader.next = begin;
+	reader.end = end;
+	reader.bits = 0;
+	reader.count = 0;
+	reader.atMarker = false;
+	reader.predictions[0] = reader.predictions[1] = reader.predictions[2] = 0;
+	reader.startMCU = startMCU;
+}
+
+inline void CSCI441_INTERNAL::fillJPEGBits( JPEGBitReader &reader ) {
+	if( !reader.atMarker && reader.end - reader.next >= 8 ) {
+		unsigned long long word = 0;
+		for( int i = 0; i < 8; i++ ) word = ( word << 8 ) | reader.next[i];
+		// with no 0xFF among the next eight bytes, as many as fit go in at once; the
+		// bits of the byte that only partly fits are overwritten with themselves next time
+		const unsigned long long inverse = ~word;
+		if( ( ( inverse - 0x0101010101010101ULL ) & ~inverse & 0x8080808080808080ULL ) == 0 ) {
+			const int numBytes = ( 64 - reader.count ) >> 3;
+			reader.bits |= word >> reader.count;
+			reader.next += numBytes;
+			reader.count += numBytes * 8;
+			return;
+		}
+	}
+	while( reader.count <= 56 ) {
+		unsigned int byte = 0;
+		if( !reader.atMarker && reader.next < reader.end ) {
+			byte = *reader.next;
+			if( byte != 0xFF ) {
+				reader.next++;
+			} else if( reader.next + 1 < reader.end && reader.next[1] == 0x00 ) {
+				reader.next += 2;
+			} else {
+				// past the end of the coded data every further bit reads as zero
+				reader.atMarker = true;
+				byte = 0;
+			}
+		}
+		reader.bits |= (unsigned long long)byte << ( 56 - reader.count );
+		reader.count += 8;
+	}
+}
+
+inline int CSCI441_INTERNAL::decodeJPEGHuffman( JPEGBitReader &reader, const JPEGHuffmanTable &table ) {
+	const unsigned int entry = table.lookup[ reader.bits >> ( 64 - JPEG_HUFFMAN_LOOKUP_BITS ) ];
+	if( entry ) {
+		reader.bits <<= entry >> 8;
+		reader.count -= entry >> 8;
+		return entry & 255;
+	}
+	for( int length = JPEG_HUFFMAN_LOOKUP_BITS + 1; length <= 16; length++ ) {
+		const int code = (int)( reader.bits >> ( 64 - length ) );
+		if( code <= table.maxCode[length] ) {
+			reader.bits <<= length;
+			reader.count -= length;
+			return table.symbols[ ( code + table.valueOffset[length] ) & 255 ];
+		}
+	}
+	return -1;
+}
+
+inline int CSCI441_INTERNAL::receiveJPEGValue( JPEGBitReader &reader, int numBits ) {
+	// the top bit clear marks a negative value, stored offset by 2^n - 1
+	const int value = (int)( reader.bits >> ( 64 - numBits ) );
+	reader.bits <<= numBits;
+	reader.count -= numBits;
+	return value < ( 1 << ( numBits - 1 ) ) ? value - ( 1 << numBits ) + 1 : value;
+}
+
+inline void CSCI441_INTERNAL::restartJPEGBitReader( JPEGBitReader &reader ) {
+	// the bits left before a restart marker are padding
+	while( reader.next + 1 < reader.end && !( reader.next[0] == 0xFF && reader.next[1] >= 0xD0 && reader.next[1] <= 0xD7 ) ) {
+		reader.next++;
+	}
+	if( reader.next + 1 < reader.end ) reader.next += 2;
+	reader.bits = 0;
+	reader.count = 0;
+	reader.atMarker = false;
+	reader.predictions[0] = reader.predictions[1] = reader.predictions[2] = 0;
+}
+
+inline bool CSCI441_INTERNAL::decodeJPEGBlock( JPEGBitReader &reader, const JPEGHuffmanTable &dc, const JPEGHuffmanTable &ac, int &prediction, short *coefficients ) {
+	// every refill leaves at least 57 bits, enough for one code and the value after it
+	fillJPEGBits( reader );
+	const int size = decodeJPEGHuffman( reader, dc );
+	if( size < 0 || size > 11 ) return false;
+	if( size ) prediction += receiveJPEGValue( reader, size );
+	coefficients[0] = (short)prediction;
+
+	for( int k = 1; k < 64; ) {
+		if( reader.count < 32 ) fillJPEGBits( reader );
+		const int runSize = decodeJPEGHuffman( reader, ac );
+		if( runSize < 0 ) return false;
+		const int run = runSize >> 4, bits = runSize & 15;
+		if( bits ) {
+			k += run;
+			if( k > 63 ) return false;
+			coefficients[ JPEG_ZIGZAG[k] ] = (short)receiveJPEGValue( reader, bits );
+			k++;
+		} else if( run == 15 ) {
+			k += 16;
+		} else {
+			break;
+		}
+	}
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::decodeJPEGMCUs( JPEGBitReader &reader, const JPEGImage &image, const JPEGScan &scan, int firstMCU, int lastMCU ) {
+	for( int mcu = firstMCU; mcu < lastMCU; mcu++ ) {
+		if( image.restartInterval && mcu > reader.startMCU && mcu % image.restartInterval == 0 ) {
+			restartJPEGBitReader( reader );
+		}
+
+		if( scan.numComponents == 1 ) {
+			const JPEGComponent &component = image.components[ scan.components[0] ];
+			short *block = component.coefficients + ( (size_t)( mcu / scan.mcusPerRow ) * component.blocksX + mcu % scan.mcusPerRow ) * 64;
+			if( !decodeJPEGBlock( reader, image.dcTables[ scan.dcTables[0] ], image.acTables[ scan.acTables[0] ], reader.predictions[0], block ) ) return false;
+			continue;
+		}
+
+		const int mcuX = mcu % image.mcusX, mcuY = mcu / image.mcusX;
+		for( int i = 0; i < scan.numComponents; i++ ) {
+			const JPEGComponent &component = image.components[ scan.components[i] ];
+			for( int y = 0; y < component.v; y++ ) {
+				short *block = component.coefficients + ( (size_t)( mcuY * component.v + y ) * component.blocksX + mcuX * component.h ) * 64;
+				for( int x = 0; x < component.h; x++, block += 64 ) {
+					if( !decodeJPEGBlock( reader, image.dcTables[ scan.dcTables[i] ], image.acTables[ scan.acTables[i] ], reader.predictions[i], block ) ) return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::decodeJPEGScan( const JPEGImage &image, const JPEGScan &scan, JPEGTransformJob *progress ) {
+	JPEGBitReader reader;
+	startJPEGBitReader( reader, scan.begin, scan.end, 0 );
+	for( int row = 0; row < scan.numRows; row++ ) {
+		if( !decodeJPEGMCUs( reader, image, scan, row * scan.mcusPerRow, ( row + 1 ) * scan.mcusPerRow ) ) return false;
+		if( progress ) {
+			{
+#ifndef CSCI441_NO_THREADS
+				std::lock_guard< std::mutex > lock( progress->mutex );
+#endif
+				progress->rowsDecoded = row + 1;
+			}
+#ifndef CSCI441_NO_THREADS
+			progress->ready.notify_all();
+#endif
+		}
+	}
+	return true;
+}
+
+inline bool CSCI441_INTERNAL::decodeJPEGIntervals( const JPEGImage &image, const JPEGScan &scan, const std::vector< const unsigned char* > &restarts, int numIntervals, unsigned int numThreads ) {
+	if( (int)numThreads > numIntervals ) numThreads = numIntervals;
+
+	std::vector< char > succeeded( numThreads, 0 );
+#ifndef CSCI441_NO_THREADS
+	std::vector< std::thread > workers;
+#endif
+	for( unsigned int t = 0; t < numThreads; t++ ) {
+		const int firstInterval = (int)( (size_t)numIntervals * t / numThreads );
+		const int lastInterval = (int)( (size_t)numIntervals * ( t + 1 ) / numThreads );
+		const unsigned char *begin = firstInterval == 0 ? scan.begin : restarts[firstInterval - 1];
+		const int firstMCU = firstInterval * image.restartInterval;
+		const int lastMCU = std::min( lastInterval * image.restartInterval, scan.numMCUs );
+#ifndef CSCI441_NO_THREADS
+		if( t > 0 ) {
+			workers.push_back( std::thread( decodeJPEGIntervalRange, &image, &scan, begin, firstMCU, lastMCU, (bool*)&succeeded[t] ) );
+			continue;
+		}
+#endif
+		decodeJPEGIntervalRange( &image, &scan, begin, firstMCU, lastMCU, (bool*)&succeeded[t] );
+	}
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+
+	for( unsigned int t = 0; t < numThreads; t++ ) {
+		if( !succeeded[t] ) return false;
+	}
+	return true;
+}
+
+inline void CSCI441_INTERNAL::decodeJPEGIntervalRange( const JPEGImage *image, const JPEGScan *scan, const unsigned char *begin, int firstMCU, int lastMCU, bool *succeeded ) {
+	JPEGBitReader reader;
+	startJPEGBitReader( reader, begin, scan->end, firstMCU );
+	*succeeded = decodeJPEGMCUs( reader, *image, *scan, firstMCU, lastMCU );
+}
+
+inline void CSCI441_INTERNAL::transformJPEGRows( JPEGTransformJob *job ) {
+	std::vector< unsigned char > planes[3], upsampled[3];
+	for( ;; ) {
+		int row;
+		{
+#ifndef CSCI441_NO_THREADS
+			std::unique_lock< std::mutex > lock( job->mutex );
+			while( !job->failed && job->nextRow >= job->rowsDecoded && job->nextRow < job->image->mcusY ) {
+				job->ready.wait( lock );
+			}
+#endif
+			if( job->failed || job->nextRow >= job->image->mcusY ) return;
+			row = job->nextRow++;
+		}
+		transformJPEGRow( *job, row, planes, upsampled );
+	}
+}
+
+inline void CSCI441_INTERNAL::transformJPEGRow( const JPEGTransformJob &job, int row, std::vector< unsigned char > planes[3], std::vector< unsigned char > upsampled[3] ) {
+	const JPEGImage &image = *job.image;
+	const int width = image.width, channels = image.numComponents;
+
+	// each component's samples for this row of MCUs, at its own resolution
+	for( int c = 0; c < channels; c++ ) {
+		const JPEGComponent &component = image.components[c];
+		const int stride = component.blocksX * 8;
+		planes[c].resize( (size_t)stride * component.v * 8 );
+		for( int y = 0; y < component.v; y++ ) {
+			const short *block = component.coefficients + (size_t)( row * component.v + y ) * component.blocksX * 64;
+			for( int x = 0; x < component.blocksX; x++, block += 64 ) {
+				idctJPEGBlock( block, image.quantTables[ component.quantTable ], &planes[c][ (size_t)y * 8 * stride + x * 8 ], stride );
+			}
+		}
+		if( component.h != image.hMax ) upsampled[c].resize( width );
+	}
+
+	const JPEGColorTables &tables = getJPEGColorTables();
+	const unsigned char *clamp = tables.clamp + JPEG_CLAMP_OFFSET;
+	// the usual case of both chroma components sampled alike is converted straight from their own resolution
+	const bool sharedChroma = channels == 3 && !job.rgb && image.components[1].h == image.components[2].h && image.components[1].v == image.components[2].v;
+	const int firstY = row * image.vMax * 8;
+	const int lastY = std::min( firstY + image.vMax * 8, image.height );
+	for( int y = firstY; y < lastY; y++ ) {
+		const unsigned char *samples[3];
+		for( int c = 0; c < channels; c++ ) {
+			const JPEGComponent &component = image.components[c];
+			const unsigned char *source = &planes[c][ (size_t)( ( y - firstY ) / ( image.vMax / component.v ) ) * component.blocksX * 8 ];
+			if( component.h == image.hMax || sharedChroma ) {
+				samples[c] = source;
+				continue;
+			}
+			// each subsampled value covers the pixels beside it
+			const int repeat = image.hMax / component.h;
+			unsigned char *expanded = &upsampled[c][0];
+			for( int x = 0, i = 0; x < width; i++ ) {
+				for( const int end = std::min( x + repeat, width ); x < end; x++ ) expanded[x] = source[i];
+			}
+			samples[c] = expanded;
+		}
+
+		unsigned char *out = job.pixels + (size_t)( job.flip ? image.height - 1 - y : y ) * width * channels;
+		if( channels == 1 ) {
+			memcpy( out, samples[0], width );
+		} else if( job.rgb ) {
+			for( int x = 0; x < width; x++, out += 3 ) {
+				out[0] = samples[0][x];
+				out[1] = samples[1][x];
+				out[2] = samples[2][x];
+			}
+		} else {
+			// one chroma lookup serves every pixel the chroma sample covers
+			const int repeat = sharedChroma ? image.hMax / image.components[1].h : 1;
+			for( int x = 0, i = 0; x < width; i++ ) {
+				const int cb = samples[1][i], cr = samples[2][i];
+				const int red = tables.crToR[cr];
+				const int green = ( tables.cbToG[cb] + tables.crToG[cr] ) >> 16;
+				const int blue = tables.cbToB[cb];
+				for( const int end = std::min( x + repeat, width ); x < end; x++, out += 3 ) {
+					const int luma = samples[0][x];
+					out[0] = clamp[ luma + red ];
+					out[1] = clamp[ luma + green ];
+					out[2] = clamp[ luma + blue ];
+				}
+			}
+		}
+	}
+}
+
+inline int CSCI441_INTERNAL::clampJPEGIDCTInput( const int value ) {
+	// an 8-bit image never comes near these; corrupt data is kept from overflowing the int arithmetic of either pass
+	return value < -32768 ? -32768 : value > 32767 ? 32767 : value;
+}
+
+inline void CSCI441_INTERNAL::idctJPEGBlock( const short *coefficients, const unsigned short *quant, unsigned char *out, int stride ) {
+	// the accurate integer inverse DCT of the IJG library, so results match libjpeg's default exactly
+	static const int CONST_BITS = 13, PASS1_BITS = 2;
+	static const int FIX_0_298631336 = 2446, FIX_0_390180644 = 3196, FIX_0_541196100 = 4433, FIX_0_765366865 = 6270,
+					 FIX_0_899976223 = 7373, FIX_1_175875602 = 9633, FIX_1_501321110 = 12299, FIX_1_847759065 = 15137,
+					 FIX_1_961570560 = 16069, FIX_2_053119869 = 16819, FIX_2_562915447 = 20995, FIX_3_072711026 = 25172;
+
+	int workspace[64];
+	for( int column = 0; column < 8; column++ ) {
+		const short *in = coefficients + column;
+		const unsigned short *q = quant + column;
+		int *ws = workspace + column;
+		if( !in[8] && !in[16] && !in[24] && !in[32] && !in[40] && !in[48] && !in[56] ) {
+			const int dc = clampJPEGIDCTInput( clampJPEGIDCTInput( in[0] * q[0] ) * ( 1 << PASS1_BITS ) );
+			for( int i = 0; i < 64; i += 8 ) ws[i] = dc;
+			continue;
+		}
+
+		int z2 = clampJPEGIDCTInput( in[16] * q[16] ), z3 = clampJPEGIDCTInput( in[48] * q[48] );
+		int z1 = ( z2 + z3 ) * FIX_0_541196100;
+		int tmp2 = z1 - z3 * FIX_1_847759065;
+		int tmp3 = z1 + z2 * FIX_0_765366865;
+		z2 = clampJPEGIDCTInput( in[0] * q[0] );
+		z3 = clampJPEGIDCTInput( in[32] * q[32] );
+		int tmp0 = ( z2 + z3 ) * ( 1 << CONST_BITS );
+		int tmp1 = ( z2 - z3 ) * ( 1 << CONST_BITS );
+		const int tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3, tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;
+
+		tmp0 = clampJPEGIDCTInput( in[56] * q[56] );
+		tmp1 = clampJPEGIDCTInput( in[40] * q[40] );
+		tmp2 = clampJPEGIDCTInput( in[24] * q[24] );
+		tmp3 = clampJPEGIDCTInput( in[8] * q[8] );
+		z1 = tmp0 + tmp3;
+		z2 = tmp1 + tmp2;
+		z3 = tmp0 + tmp2;
+		int z4 = tmp1 + tmp3;
+		const int z5 = ( z3 + z4 ) * FIX_1_175875602;
+		tmp0 *= FIX_0_298631336;
+		tmp1 *= FIX_2_053119869;
+		tmp2 *= FIX_3_072711026;
+		tmp3 *= FIX_1_501321110;
+		z1 *= -FIX_0_899976223;
+		z2 *= -FIX_2_562915447;
+		z3 = z3 * -FIX_1_961570560 + z5;
+		z4 = z4 * -FIX_0_390180644 + z5;
+		tmp0 += z1 + z3;
+		tmp1 += z2 + z4;
+		tmp2 += z2 + z3;
+		tmp3 += z1 + z4;
+
+		const int round = 1 << ( CONST_BITS - PASS1_BITS - 1 );
+		ws[0]  = clampJPEGIDCTInput( ( tmp10 + tmp3 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+		ws[56] = clampJPEGIDCTInput( ( tmp10 - tmp3 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+		ws[8]  = clampJPEGIDCTInput( ( tmp11 + tmp2 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+		ws[48] = clampJPEGIDCTInput( ( tmp11 - tmp2 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+		ws[16] = clampJPEGIDCTInput( ( tmp12 + tmp1 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+		ws[40] = clampJPEGIDCTInput( ( tmp12 - tmp1 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+		ws[24] = clampJPEGIDCTInput( ( tmp13 + tmp0 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+		ws[32] = clampJPEGIDCTInput( ( tmp13 - tmp0 + round ) >> ( CONST_BITS - PASS1_BITS ) );
+	}
+
+	for( int row = 0; row < 8; row++, out += stride ) {
+		const int *ws = workspace + row * 8;
+		if( !ws[1] && !ws[2] && !ws[3] && !ws[4] && !ws[5] && !ws[6] && !ws[7] ) {
+			const int value = ( ( ws[0] + ( 1 << ( PASS1_BITS + 2 ) ) ) >> ( PASS1_BITS + 3 ) ) + 128;
+			memset( out, value < 0 ? 0 : value > 255 ? 255 : value, 8 );
+			continue;
+		}
+
+		int z2 = ws[2], z3 = ws[6];
+		int z1 = ( z2 + z3 ) * FIX_0_541196100;
+		int tmp2 = z1 - z3 * FIX_1_847759065;
+		int tmp3 = z1 + z2 * FIX_0_765366865;
+		int tmp0 = ( ws[0] + ws[4] ) * ( 1 << CONST_BITS );
+		int tmp1 = ( ws[0] - ws[4] ) * ( 1 << CONST_BITS );
+		const int tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3, tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;
+
+		tmp0 = ws[7];
+		tmp1 = ws[5];
+		tmp2 = ws[3];
+		tmp3 = ws[1];
+		z1 = tmp0 + tmp3;
+		z2 = tmp1 + tmp2;
+		z3 = tmp0 + tmp2;
+		int z4 = tmp1 + tmp3;
+		const int z5 = ( z3 + z4 ) * FIX_1_175875602;
+		tmp0 *= FIX_0_298631336;
+		tmp1 *= FIX_2_053119869;
+		tmp2 *= FIX_3_072711026;
+		tmp3 *= FIX_1_501321110;
+		z1 *= -FIX_0_899976223;
+		z2 *= -FIX_2_562915447;
+		z3 = z3 * -FIX_1_961570560 + z5;
+		z4 = z4 * -FIX_0_390180644 + z5;
+		tmp0 += z1 + z3;
+		tmp1 += z2 + z4;
+		tmp2 += z2 + z3;
+		tmp3 += z1 + z4;
+
+		const int shift = CONST_BITS + PASS1_BITS + 3, round = 1 << ( shift - 1 );
+		const int values[8] = { tmp10 + tmp3, tmp11 + tmp2, tmp12 + tmp1, tmp13 + tmp0, tmp13 - tmp0, tmp12 - tmp1, tmp11 - tmp2, tmp10 - tmp3 };
+		for( int i = 0; i < 8; i++ ) {
+			const int value = ( ( values[i] + round ) >> shift ) + 128;
+			out[i] = (unsigned char)( value < 0 ? 0 : value > 255 ? 255 : value );
+		}
+	}
+}
+
+inline CSCI441_INTERNAL::JPEGColorTables::JPEGColorTables() {
+	// ITU-R BT.601 with full range samples, in 16.16 fixed point as libjpeg rounds it
+	const int ONE_HALF = 1 << 15;
+	for( int i = 0; i < 256; i++ ) {
+		const int x = i - 128;
+		crToR[i] = ( 91881 * x + ONE_HALF ) >> 16;
+		cbToB[i] = ( 116130 * x + ONE_HALF ) >> 16;
+		crToG[i] = -46802 * x;
+		cbToG[i] = -22554 * x + ONE_HALF;
+	}
+	for( int i = 0; i < 1024; i++ ) {
+		const int value = i - JPEG_CLAMP_OFFSET;
+		clamp[i] = (unsigned char)( value < 0 ? 0 : value > 255 ? 255 : value );
+	}
+}
+
+inline const CSCI441_INTERNAL::JPEGColorTables& CSCI441_INTERNAL::getJPEGColorTables() {
+	static const JPEGColorTables tables;
+	return tables;
+}
+
+#endif // __CSCI441_IMAGEDECODER_HPP__
@@ -0,0 +1,1025 @@
+/** @file imageKernels.hpp
+  * @brief Bulk operations over 8-bit image data on the CPU
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	The passes every loaded texture goes through before it reaches OpenGL:
+	*	flipping rows, reordering channels, merging a color image with an alpha
+	*	mask, premultiplying alpha, converting between sRGB and linear color,
+	*	shrinking mipmap levels, and compressing to BC1 or BC3 blocks.
+	*
+	*	The per-pixel kernels run SSE2 on x86, and AVX2 when the processor
+	*	reports it at run time, with plain loops finishing whatever is left
+	*	over and standing in everywhere else.  The sRGB conversions look up
+	*	tables, which only AVX2 can gather from, so they skip the SSE2 step.
+	*	Large images are split into runs of rows across threads.
+	*
+	*	@warning NOTE: Large images are processed across std::thread workers.  Define
+	*	CSCI441_NO_THREADS before including this file on toolchains without std::thread support
+  */
+
+#ifndef __CSCI441_IMAGEKERNELS_HPP__
+#define __CSCI441_IMAGEKERNELS_HPP__
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <functional>
+#include <thread>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CSCI441_IMAGEKERNELS_X86
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+	/** @namespace ImageKernels
+	  * @brief Bulk pixel operations for preparing textures
+	  */
+	namespace ImageKernels {
+		/** @brief Reverses the order of the rows of an image in place
+			* @param unsigned char* pixels	- width*height*channels bytes
+			* @param int width				- pixels across
+			* @param int height				- pixels down
+			* @param int channels			- bytes per pixel
+			*/
+		void flipRows( unsigned char *pixels, int width, int height, int channels );
+
+		/** @brief Swaps the first and third channel of every pixel, turning BGR into RGB and back
+			* @param const unsigned char* source	- numPixels*channels bytes
+			* @param unsigned char* destination		- numPixels*channels bytes, may be source
+			* @param size_t numPixels				- pixels to convert
+			* @param int channels					- 3 or 4
+			*/
+		void swapRedBlue( const unsigned char *source, unsigned char *destination, size_t numPixels, int channels );
+
+		/** @brief Builds RGBA pixels from a color image and the first channel of a mask
+			*
+			*	A color image of one or two channels is gray, and its first channel
+			*	fills red, green and blue.  Any other color channels are dropped.
+			*
+			* @param const unsigned char* color	- RGB or RGBA pixels, or gray ones; NULL for white
+			* @param int colorChannels			- bytes per color pixel, 1 to 4
+			* @param const unsigned char* mask	- pixels whose first channel becomes alpha; NULL for opaque
+			* @param int maskChannels			- bytes per mask pixel
+			* @param unsigned char* rgba			- numPixels*4 bytes
+			* @param size_t numPixels			- pixels to build
+			*/
+		void expandRGBA( const unsigned char *color, int colorChannels, const unsigned char *mask, int maskChannels, unsigned char *rgba, size_t numPixels );
+
+		/** @brief Multiplies the color of every RGBA pixel by its alpha in place
+			*
+			*	Each channel becomes color*alpha/255 rounded to nearest, so blending
+			*	with GL_ONE, GL_ONE_MINUS_SRC_ALPHA no longer bleeds the color of
+			*	transparent texels into their neighbors when filtered.
+			*
+			* @param unsigned char* rgba	- numPixels*4 bytes
+			* @param size_t numPixels		- pixels to premultiply
+			*/
+		void premultiplyAlpha( unsigned char *rgba, size_t numPixels );
+
+		/** @brief Decodes sRGB samples to linear intensities
+			*
+			*	A fourth channel is alpha and is only scaled to 0-1.
+			*
+			* @param const unsigned char* srgb	- numPixels*channels bytes
+			* @param float* linear				- numPixels*channels values in 0-1
+			* @param size_t numPixels			- pixels to convert
+			* @param int channels				- 1 to 4
+			*/
+		void srgbToLinear( const unsigned char *srgb, float *linear, size_t numPixels, int channels );
+
+		/** @brief Encodes linear intensities as the nearest sRGB samples
+			*
+			*	Values outside 0-1 are clamped.  A fourth channel is alpha and is only
+			*	scaled to 0-255.
+			*
+			* @param const float* linear		- numPixels*channels values
+			* @param unsigned char* srgb		- numPixels*channels bytes
+			* @param size_t numPixels		- pixels to convert
+			* @param int channels			- 1 to 4
+			*/
+		void linearToSrgb( const float *linear, unsigned char *srgb, size_t numPixels, int channels );
+
+		/** @brief Filters used to shrink an image by half
+			*/
+		enum MipmapFilter {
+			MIPMAP_FILTER_BOX,		///< average of each two by two block; cheapest, slightly blurry
+			MIPMAP_FILTER_KAISER	///< Kaiser windowed sinc eight source pixels wide; sharper and aliases less
+		};
+
+		/** @brief Halves an image of linear intensities in each dimension
+			*
+			*	Odd sizes round down and no side goes below one pixel.  Pixels past
+			*	the edges repeat the edge.  The Kaiser filter has small negative lobes,
+			*	so its results can fall slightly outside the range of the source.
+			*
+			* @param const float* source		- sourceWidth*sourceHeight*channels values
+			* @param int sourceWidth			- pixels across the source
+			* @param int sourceHeight		- pixels down the source
+			* @param float* destination		- max(sourceWidth/2,1)*max(sourceHeight/2,1)*channels values
+			* @param int channels			- values per pixel
+			* @param MipmapFilter filter		- how to weight the source pixels (default: MIPMAP_FILTER_BOX)
+			*/
+		void downsample( const float *source, int sourceWidth, int sourceHeight, float *destination, int channels, MipmapFilter filter = MIPMAP_FILTER_BOX );
+
+		/** @brief Returns the bytes a block compressed image takes
+			* @param int width			- pixels across
+			* @param int height			- pixels down
+			* @param int blockBytes		- 8 for BC1, 16 for BC3
+			* @return one block for every four by four pixels, partial blocks included
+			*/
+		size_t getCompressedSize( int width, int height, int blockBytes );
+
+		/** @brief Compresses an image into BC1 (DXT1) blocks
+			*
+			*	Each four by four block keeps two 5:6:5 endpoint colors and picks one
+			*	of four colors on the line between them for every pixel.  The line
+			*	runs corner to corner across the block's bounding box, along whichever
+			*	diagonal the colors follow, and every pixel is projected onto it.
+			*	Alpha is dropped.  Pixels past the right and bottom edges repeat the edge.
+			*
+			* @param const unsigned char* pixels	- width*height*channels bytes
+			* @param int width					- pixels across
+			* @param int height					- pixels down
+			* @param int channels				- 3 or 4
+			* @param unsigned char* blocks		- getCompressedSize(width, height, 8) bytes
+			*/
+		void compressBC1( const unsigned char *pixels, int width, int height, int channels, unsigned char *blocks );
+
+		/** @brief Compresses an RGBA image into BC3 (DXT5) blocks
+			*
+			*	Color is compressed as BC1 is.  Alpha gets its own block that spans the
+			*	smallest and largest alpha in the block in eight steps.
+			*
+			* @param const unsigned char* rgba	- width*height*4 bytes
+			* @param int width					- pixels across
+			* @param int height					- pixels down
+			* @param unsigned char* blocks		- getCompressedSize(width, height, 16) bytes
+			*/
+		void compressBC3( const unsigned char *rgba, int width, int height, unsigned char *blocks );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal definitions
+
+namespace CSCI441_INTERNAL {
+	// everything one kernel needs; each thread gets the same job and its own range of items
+	struct ImageKernelJob {
+		const unsigned char *source;
+		const unsigned char *mask;
+		unsigned char *destination;
+		const float *linearSource;
+		float *linearDestination;
+		size_t rowBytes, numRows;
+		int sourceChannels, maskChannels, channels;
+		int sourceWidth, sourceHeight, width;
+		const float *weights;
+		int numWeights, firstWeight;
+		int blockBytes;
+	};
+	typedef void (*ImageKernel)( const ImageKernelJob &job, size_t first, size_t last );
+
+	void runImageKernel( ImageKernel kernel, const ImageKernelJob &job, size_t numItems, size_t bytesPerItem );
+	void flipRowsRange( const ImageKernelJob &job, size_t first, size_t last );
+
+	// each ...Range() hands its pixels to the widest vector step the processor has, then the next
+	// narrower one, then the plain loop in ...Pixels().  a vector step returns the first pixel it left
+	void swapRedBlueRange( const ImageKernelJob &job, size_t first, size_t last );
+	void swapRedBluePixels( const ImageKernelJob &job, size_t first, size_t last );
+	void expandRGBARange( const ImageKernelJob &job, size_t first, size_t last );
+	void expandRGBAPixels( const ImageKernelJob &job, size_t first, size_t last );
+	void premultiplyAlphaRange( const ImageKernelJob &job, size_t first, size_t last );
+	void premultiplyAlphaPixels( const ImageKernelJob &job, size_t first, size_t last );
+	void srgbToLinearRange( const ImageKernelJob &job, size_t first, size_t last );
+	void srgbToLinearPixels( const ImageKernelJob &job, size_t first, size_t last );
+	void linearToSrgbRange( const ImageKernelJob &job, size_t first, size_t last );
+	void linearToSrgbPixels( const ImageKernelJob &job, size_t first, size_t last );
+#ifdef __SSE2__
+	size_t swapRedBlueSSE2( const ImageKernelJob &job, size_t first, size_t last );
+	size_t expandRGBASSE2( const ImageKernelJob &job, size_t first, size_t last );
+	size_t premultiplyAlphaSSE2( const ImageKernelJob &job, size_t first, size_t last );
+#endif
+#ifdef CSCI441_IMAGEKERNELS_X86
+	size_t swapRedBlueAVX2( const ImageKernelJob &job, size_t first, size_t last );
+	size_t expandRGBAAVX2( const ImageKernelJob &job, size_t first, size_t last );
+	size_t premultiplyAlphaAVX2( const ImageKernelJob &job, size_t first, size_t last );
+	size_t srgbToLinearAVX2( const ImageKernelJob &job, size_t first, size_t last );
+	size_t linearToSrgbAVX2( const ImageKernelJob &job, size_t first, size_t last );
+	bool useAVX2ImageKernels();
+#endif
+	void downsampleRange( const ImageKernelJob &job, size_t first, size_t last );
+	double besselI0( double x );
+	void compressBlocksRange( const ImageKernelJob &job, size_t first, size_t last );
+	void compressColorBlock( const unsigned char *rgba, unsigned char *block );
+	int fitColorBlock( const unsigned char *rgba, const int high[3], const int low[3], unsigned int endpoint[2], unsigned int &indices, int steps[16] );
+	void compressAlphaBlock( const unsigned char *rgba, unsigned char *block );
+
+	// bins per unit of linear intensity when encoding sRGB; fine enough that no bin holds two code boundaries
+	static const unsigned int SRGB_ENCODE_BINS = 4096;
+
+	// sRGB decoding table and the linear intensity where each 8-bit code begins
+	struct SRGBTables {
+		float toLinear[256];
+		float codeStarts[257];
+		unsigned char firstCode[SRGB_ENCODE_BINS + 4];		// padded so a four byte gather at the last bin stays inside
+		SRGBTables();
+	};
+	const SRGBTables& getSRGBTables();
+
+	// source pixels the Kaiser filter spans along each axis, and the shape of its window
+	static const int KAISER_TAPS = 8;
+	static const double KAISER_ALPHA = 4.0;
+
+	// below this many bytes a kernel finishes before extra threads would start
+	static const size_t IMAGE_THREAD_MIN_BYTES = 4 * 1024 * 1024;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline void CSCI441::ImageKernels::flipRows( unsigned char *pixels, int width, int height, int channels ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.destination = pixels;
+	job.rowBytes = (size_t)width * channels;
+	job.numRows = height;
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::flipRowsRange, job, height / 2, 2 * job.rowBytes );
+}
+
+inline void CSCI441::ImageKernels::swapRedBlue( const unsigned char *source, unsigned char *destination, size_t numPixels, int channels ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.source = source;
+	job.destination = destination;
+	job.channels = channels;
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::swapRedBlueRange, job, numPixels, channels );
+}
+
+inline void CSCI441::ImageKernels::expandRGBA( const unsigned char *color, int colorChannels, const unsigned char *mask, int maskChannels, unsigned char *rgba, size_t numPixels ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.source = color;
+	job.sourceChannels = colorChannels;
+	job.mask = mask;
+	job.maskChannels = maskChannels;
+	job.destination = rgba;
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::expandRGBARange, job, numPixels, 4 );
+}
+
+inline void CSCI441::ImageKernels::premultiplyAlpha( unsigned char *rgba, size_t numPixels ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.destination = rgba;
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::premultiplyAlphaRange, job, numPixels, 4 );
+}
+
+inline void CSCI441::ImageKernels::srgbToLinear( const unsigned char *srgb, float *linear, size_t numPixels, int channels ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.source = srgb;
+	job.linearDestination = linear;
+	job.channels = channels;
+	CSCI441_INTERNAL::getSRGBTables();		// built once before any worker needs it
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::srgbToLinearRange, job, numPixels, channels * ( 1 + sizeof(float) ) );
+}
+
+inline void CSCI441::ImageKernels::linearToSrgb( const float *linear, unsigned char *srgb, size_t numPixels, int channels ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.linearSource = linear;
+	job.destination = srgb;
+	job.channels = channels;
+	CSCI441_INTERNAL::getSRGBTables();
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::linearToSrgbRange, job, numPixels, channels * ( 1 + sizeof(float) ) );
+}
+
+inline void CSCI441::ImageKernels::downsample( const float *source, int sourceWidth, int sourceHeight, float *destination, int channels, MipmapFilter filter ) {
+	// output pixel x is centered between source pixels 2x and 2x+1; tap t reads source pixel 2x + firstWeight + t
+	float weights[CSCI441_INTERNAL::KAISER_TAPS];
+	int numWeights = 2, firstWeight = 0;
+	weights[0] = weights[1] = 0.5f;
+	if( filter == MIPMAP_FILTER_KAISER ) {
+		numWeights = CSCI441_INTERNAL::KAISER_TAPS;
+		firstWeight = 1 - numWeights / 2;
+		double total = 0.0;
+		double window[CSCI441_INTERNAL::KAISER_TAPS];
+		for( int t = 0; t < numWeights; t++ ) {
+			const double distance = t + firstWeight - 0.5;		// in source pixels from the output center
+			const double x = M_PI * distance / 2.0;
+			const double edge = distance / ( numWeights / 2 );
+			window[t] = sin( x ) / x * CSCI441_INTERNAL::besselI0( CSCI441_INTERNAL::KAISER_ALPHA * sqrt( 1.0 - edge * edge ) );
+			total += window[t];
+		}
+		for( int t = 0; t < numWeights; t++ ) {
+			weights[t] = (float)( window[t] / total );
+		}
+	}
+
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.linearSource = source;
+	job.linearDestination = destination;
+	job.channels = channels;
+	job.sourceWidth = sourceWidth;
+	job.sourceHeight = sourceHeight;
+	job.width = sourceWidth > 1 ? sourceWidth / 2 : 1;
+	job.weights = weights;
+	job.numWeights = numWeights;
+	job.firstWeight = firstWeight;
+	const int height = sourceHeight > 1 ? sourceHeight / 2 : 1;
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::downsampleRange, job, height, (size_t)sourceWidth * channels * sizeof(float) * numWeights );
+}
+
+inline size_t CSCI441::ImageKernels::getCompressedSize( int width, int height, int blockBytes ) {
+	return (size_t)( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * blockBytes;
+}
+
+inline void CSCI441::ImageKernels::compressBC1( const unsigned char *pixels, int width, int height, int channels, unsigned char *blocks ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.source = pixels;
+	job.destination = blocks;
+	job.channels = channels;
+	job.sourceWidth = width;
+	job.sourceHeight = height;
+	job.blockBytes = 8;
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::compressBlocksRange, job, ( height + 3 ) / 4, (size_t)width * 4 * channels );
+}
+
+inline void CSCI441::ImageKernels::compressBC3( const unsigned char *rgba, int width, int height, unsigned char *blocks ) {
+	CSCI441_INTERNAL::ImageKernelJob job = CSCI441_INTERNAL::ImageKernelJob();
+	job.source = rgba;
+	job.destination = blocks;
+	job.channels = 4;
+	job.sourceWidth = width;
+	job.sourceHeight = height;
+	job.blockBytes = 16;
+	CSCI441_INTERNAL::runImageKernel( CSCI441_INTERNAL::compressBlocksRange, job, ( height + 3 ) / 4, (size_t)width * 16 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function implementations
+
+inline void CSCI441_INTERNAL::runImageKernel( ImageKernel kernel, const ImageKernelJob &job, size_t numItems, size_t bytesPerItem ) {
+	// items never share bytes, so each thread owns a contiguous run of them outright
+	size_t numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+	if( numItems * bytesPerItem >= IMAGE_THREAD_MIN_BYTES ) {
+		numThreads = std::thread::hardware_concurrency();
+		if( numThreads < 1 ) numThreads = 1;
+		if( numThreads > numItems ) numThreads = numItems;
+	}
+
+	std::vector< std::thread > workers;
+	for( size_t t = 1; t < numThreads; t++ ) {
+		workers.push_back( std::thread( kernel, std::cref( job ), numItems * t / numThreads, numItems * (t+1) / numThreads ) );
+	}
+#endif
+	kernel( job, 0, numItems / numThreads );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+}
+
+inline void CSCI441_INTERNAL::flipRowsRange( const ImageKernelJob &job, size_t first, size_t last ) {
+	// whole rows move through a spare row with memcpy, which is already as wide as the machine allows
+	std::vector< unsigned char > spare( job.rowBytes );
+	for( size_t row = first; row < last; row++ ) {
+		unsigned char *top = job.destination + row * job.rowBytes;
+		unsigned char *bottom = job.destination + ( job.numRows - 1 - row ) * job.rowBytes;
+		memcpy( &spare[0], top, job.rowBytes );
+		memcpy( top, bottom, job.rowBytes );
+		memcpy( bottom, &spare[0], job.rowBytes );
+	}
+}
+
+inline void CSCI441_INTERNAL::swapRedBlueRange( const ImageKernelJob &job, size_t first, size_t last ) {
+	size_t i = first;
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( useAVX2ImageKernels() ) i = swapRedBlueAVX2( job, i, last );
+#endif
+#ifdef __SSE2__
+	i = swapRedBlueSSE2( job, i, last );
+#endif
+	swapRedBluePixels( job, i, last );
+}
+
+inline void CSCI441_INTERNAL::swapRedBluePixels( const ImageKernelJob &job, size_t first, size_t last ) {
+	const unsigned char *source = job.source;
+	unsigned char *destination = job.destination;
+
+	if( job.channels == 4 ) {
+		for( size_t i = first; i < last; i++ ) {
+			const unsigned char b = source[4*i], g = source[4*i+1], r = source[4*i+2], a = source[4*i+3];
+			destination[4*i] = r; destination[4*i+1] = g; destination[4*i+2] = b; destination[4*i+3] = a;
+		}
+	} else {
+		for( size_t i = first; i < last; i++ ) {
+			const unsigned char b = source[3*i], g = source[3*i+1], r = source[3*i+2];
+			destination[3*i] = r; destination[3*i+1] = g; destination[3*i+2] = b;
+		}
+	}
+}
+
+#ifdef __SSE2__
+inline size_t CSCI441_INTERNAL::swapRedBlueSSE2( const ImageKernelJob &job, size_t first, size_t last ) {
+	const unsigned char *source = job.source;
+	unsigned char *destination = job.destination;
+	size_t i = first;
+
+	if( job.channels == 4 ) {
+		// red and blue are the low bytes of the two halves of every pixel; trade the halves
+		const __m128i redBlue = _mm_set1_epi32( 0x00FF00FF );
+		for( ; i + 4 <= last; i += 4 ) {
+			const __m128i pixels = _mm_loadu_si128( (const __m128i*)( source + 4*i ) );
+			const __m128i ends = _mm_and_si128( pixels, redBlue );
+			const __m128i swapped = _mm_or_si128( _mm_andnot_si128( redBlue, pixels ), _mm_or_si128( _mm_slli_epi32( ends, 16 ), _mm_srli_epi32( ends, 16 ) ) );
+			_mm_storeu_si128( (__m128i*)( destination + 4*i ), swapped );
+		}
+	} else if( job.channels == 3 ) {
+		// five pixels a load: every first byte takes the one two ahead, every third the one two back.
+		// the sixteenth byte starts the next pixel and is written back unchanged
+		const __m128i fromAhead = _mm_setr_epi8( -1,0,0, -1,0,0, -1,0,0, -1,0,0, -1,0,0, 0 );
+		const __m128i fromBehind = _mm_setr_epi8( 0,0,-1, 0,0,-1, 0,0,-1, 0,0,-1, 0,0,-1, 0 );
+		const __m128i kept = _mm_setr_epi8( 0,-1,0, 0,-1,0, 0,-1,0, 0,-1,0, 0,-1,0, -1 );
+		for( ; i + 6 <= last; i += 5 ) {
+			const __m128i pixels = _mm_loadu_si128( (const __m128i*)( source + 3*i ) );
+			const __m128i swapped = _mm_or_si128( _mm_and_si128( pixels, kept ),
+									_mm_or_si128( _mm_and_si128( _mm_srli_si128( pixels, 2 ), fromAhead ), _mm_and_si128( _mm_slli_si128( pixels, 2 ), fromBehind ) ) );
+			_mm_storeu_si128( (__m128i*)( destination + 3*i ), swapped );
+		}
+	}
+	return i;
+}
+#endif
+
+inline void CSCI441_INTERNAL::expandRGBARange( const ImageKernelJob &job, size_t first, size_t last ) {
+	size_t i = first;
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( useAVX2ImageKernels() ) i = expandRGBAAVX2( job, i, last );
+#endif
+#ifdef __SSE2__
+	i = expandRGBASSE2( job, i, last );
+#endif
+	expandRGBAPixels( job, i, last );
+}
+
+inline void CSCI441_INTERNAL::expandRGBAPixels( const ImageKernelJob &job, size_t first, size_t last ) {
+	// a missing image reads the same opaque white pixel over and over, and a gray one its first channel three times
+	static const unsigned char WHITE[4] = { 255, 255, 255, 255 };
+	const unsigned char *color = job.source ? job.source : WHITE;
+	const unsigned char *mask = job.mask ? job.mask : WHITE;
+	const size_t colorChannels = job.source ? job.sourceChannels : 0;
+	const size_t maskChannels = job.mask ? job.maskChannels : 0;
+	const size_t green = colorChannels >= 3 ? 1 : 0, blue = colorChannels >= 3 ? 2 : 0;
+	unsigned char *rgba = job.destination;
+
+	for( size_t i = first; i < last; i++ ) {
+		const unsigned char r = color[colorChannels*i], g = color[colorChannels*i+green], b = color[colorChannels*i+blue], a = mask[maskChannels*i];
+		rgba[4*i] = r; rgba[4*i+1] = g; rgba[4*i+2] = b; rgba[4*i+3] = a;
+	}
+}
+
+#ifdef __SSE2__
+inline size_t CSCI441_INTERNAL::expandRGBASSE2( const ImageKernelJob &job, size_t first, size_t last ) {
+	// gray images go to the plain loop
+	const int colorChannels = job.source ? job.sourceChannels : 0;
+	if( colorChannels == 1 || colorChannels == 2 ) return first;
+
+	const unsigned char *mask = job.mask;
+	const size_t maskChannels = job.maskChannels;
+	const __m128i zero = _mm_setzero_si128(), rgb = _mm_set1_epi32( 0x00FFFFFF );
+	const __m128i rgbOf[4] = { _mm_setr_epi32( 0x00FFFFFF, 0, 0, 0 ), _mm_setr_epi32( 0, 0x00FFFFFF, 0, 0 ),
+							   _mm_setr_epi32( 0, 0, 0x00FFFFFF, 0 ), _mm_setr_epi32( 0, 0, 0, 0x00FFFFFF ) };
+	size_t i = first;
+	for( ; i + 6 <= last; i += 4 ) {
+		__m128i colors = rgb;
+		if( colorChannels == 4 ) {
+			colors = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( job.source + 4*i ) ), rgb );
+		} else if( colorChannels == 3 ) {
+			// four pixels in the first twelve bytes; the nth moves up n bytes
+			const __m128i packed = _mm_loadu_si128( (const __m128i*)( job.source + 3*i ) );
+			colors = _mm_or_si128( _mm_or_si128( _mm_and_si128( packed, rgbOf[0] ), _mm_and_si128( _mm_slli_si128( packed, 1 ), rgbOf[1] ) ),
+								   _mm_or_si128( _mm_and_si128( _mm_slli_si128( packed, 2 ), rgbOf[2] ), _mm_and_si128( _mm_slli_si128( packed, 3 ), rgbOf[3] ) ) );
+		}
+
+		__m128i alphas = _mm_set1_epi32( (int)0xFF000000 );
+		if( mask ) {
+			const unsigned char *m = mask + maskChannels*i;
+			const int packed = m[0] | m[maskChannels] << 8 | m[2*maskChannels] << 16 | m[3*maskChannels] << 24;
+			alphas = _mm_unpacklo_epi16( zero, _mm_unpacklo_epi8( zero, _mm_cvtsi32_si128( packed ) ) );
+		}
+		_mm_storeu_si128( (__m128i*)( job.destination + 4*i ), _mm_or_si128( colors, alphas ) );
+	}
+	return i;
+}
+#endif
+
+inline void CSCI441_INTERNAL::premultiplyAlphaRange( const ImageKernelJob &job, size_t first, size_t last ) {
+	size_t i = first;
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( useAVX2ImageKernels() ) i = premultiplyAlphaAVX2( job, i, last );
+#endif
+#ifdef __SSE2__
+	i = premultiplyAlphaSSE2( job, i, last );
+#endif
+	premultiplyAlphaPixels( job, i, last );
+}
+
+inline void CSCI441_INTERNAL::premultiplyAlphaPixels( const ImageKernelJob &job, size_t first, size_t last ) {
+	unsigned char *rgba = job.destination;
+
+	// x/255 rounded is (x + 128 + ((x + 128) >> 8)) >> 8 for every product of two bytes
+	for( size_t i = first; i < last; i++ ) {
+		const unsigned int a = rgba[4*i+3];
+		const unsigned int r = rgba[4*i] * a + 128, g = rgba[4*i+1] * a + 128, b = rgba[4*i+2] * a + 128;
+		rgba[4*i]   = (unsigned char)( ( r + ( r >> 8 ) ) >> 8 );
+		rgba[4*i+1] = (unsigned char)( ( g + ( g >> 8 ) ) >> 8 );
+		rgba[4*i+2] = (unsigned char)( ( b + ( b >> 8 ) ) >> 8 );
+	}
+}
+
+#ifdef __SSE2__
+inline size_t CSCI441_INTERNAL::premultiplyAlphaSSE2( const ImageKernelJob &job, size_t first, size_t last ) {
+	// the same rounding on sixteen bit lanes, two pixels a register; alpha is put back untouched
+	unsigned char *rgba = job.destination;
+	const __m128i zero = _mm_setzero_si128(), half = _mm_set1_epi16( 128 ), alpha = _mm_set1_epi32( (int)0xFF000000 );
+	size_t i = first;
+	for( ; i + 4 <= last; i += 4 ) {
+		const __m128i pixels = _mm_loadu_si128( (const __m128i*)( rgba + 4*i ) );
+		__m128i low = _mm_unpacklo_epi8( pixels, zero ), high = _mm_unpackhi_epi8( pixels, zero );
+		const __m128i lowAlpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( low, 0xFF ), 0xFF );
+		const __m128i highAlpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( high, 0xFF ), 0xFF );
+		low = _mm_add_epi16( _mm_mullo_epi16( low, lowAlpha ), half );
+		high = _mm_add_epi16( _mm_mullo_epi16( high, highAlpha ), half );
+		low = _mm_srli_epi16( _mm_add_epi16( low, _mm_srli_epi16( low, 8 ) ), 8 );
+		high = _mm_srli_epi16( _mm_add_epi16( high, _mm_srli_epi16( high, 8 ) ), 8 );
+		const __m128i product = _mm_packus_epi16( low, high );
+		_mm_storeu_si128( (__m128i*)( rgba + 4*i ), _mm_or_si128( _mm_andnot_si128( alpha, product ), _mm_and_si128( alpha, pixels ) ) );
+	}
+	return i;
+}
+#endif
+
+inline void CSCI441_INTERNAL::srgbToLinearRange( const ImageKernelJob &job, size_t first, size_t last ) {
+	size_t i = first;
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( useAVX2ImageKernels() ) i = srgbToLinearAVX2( job, i, last );
+#endif
+	srgbToLinearPixels( job, i, last );
+}
+
+inline void CSCI441_INTERNAL::srgbToLinearPixels( const ImageKernelJob &job, size_t first, size_t last ) {
+	const float *toLinear = getSRGBTables().toLinear;
+	const size_t channels = job.channels;
+	const size_t colorChannels = channels == 4 ? 3 : channels;
+
+	for( size_t i = first; i < last; i++ ) {
+		for( size_t c = 0; c < colorChannels; c++ ) {
+			job.linearDestination[channels*i+c] = toLinear[ job.source[channels*i+c] ];
+		}
+		if( channels == 4 ) {
+			job.linearDestination[4*i+3] = job.source[4*i+3] * ( 1.0f / 255.0f );
+		}
+	}
+}
+
+inline void CSCI441_INTERNAL::linearToSrgbRange( const ImageKernelJob &job, size_t first, size_t last ) {
+	size_t i = first;
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( useAVX2ImageKernels() ) i = linearToSrgbAVX2( job, i, last );
+#endif
+	linearToSrgbPixels( job, i, last );
+}
+
+inline void CSCI441_INTERNAL::linearToSrgbPixels( const ImageKernelJob &job, size_t first, size_t last ) {
+	const SRGBTables &tables = getSRGBTables();
+	const size_t channels = job.channels;
+	const size_t colorChannels = channels == 4 ? 3 : channels;
+
+	// the bin a value falls in gives the code at its start; at most one more code begins inside the bin
+	for( size_t i = first; i < last; i++ ) {
+		for( size_t c = 0; c < colorChannels; c++ ) {
+			float value = job.linearSource[channels*i+c];
+			value = value > 0.0f ? ( value < 1.0f ? value : 1.0f ) : 0.0f;
+			const unsigned int code = tables.firstCode[ (unsigned int)( value * SRGB_ENCODE_BINS ) ];
+			job.destination[channels*i+c] = (unsigned char)( code + ( value >= tables.codeStarts[code+1] ? 1 : 0 ) );
+		}
+		if( channels == 4 ) {
+			float alpha = job.linearSource[4*i+3];
+			alpha = alpha > 0.0f ? ( alpha < 1.0f ? alpha : 1.0f ) : 0.0f;
+			job.destination[4*i+3] = (unsigned char)( alpha * 255.0f + 0.5f );
+		}
+	}
+}
+
+inline void CSCI441_INTERNAL::downsampleRange( const ImageKernelJob &job, size_t first, size_t last ) {
+	const int channels = job.channels;
+	const int sourceWidth = job.sourceWidth, sourceHeight = job.sourceHeight, width = job.width;
+	const int numWeights = job.numWeights, firstWeight = job.firstWeight;
+	const size_t sourceRow = (size_t)sourceWidth * channels;
+	float weights[KAISER_TAPS];
+	for( int t = 0; t < numWeights; t++ ) weights[t] = job.weights[t];
+
+	std::vector< float > column( sourceRow );
+	for( size_t y = first; y < last; y++ ) {
+		// down the columns first, where every tap scales a whole contiguous source row
+		std::fill( column.begin(), column.end(), 0.0f );
+		for( int t = 0; t < numWeights; t++ ) {
+			int sourceY = 2 * (int)y + firstWeight + t;
+			sourceY = sourceY < 0 ? 0 : ( sourceY < sourceHeight ? sourceY : sourceHeight - 1 );
+			const float *row = job.linearSource + sourceY * sourceRow;
+			const float weight = weights[t];
+			float *sum = &column[0];
+			for( size_t i = 0; i < sourceRow; i++ ) {
+				sum[i] += weight * row[i];
+			}
+		}
+
+		// then across the filtered row, clamping taps only near the edges
+		float *output = job.linearDestination + y * width * channels;
+		for( int x = 0; x < width; x++ ) {
+			const int leftX = 2 * x + firstWeight;
+			if( leftX >= 0 && leftX + numWeights <= sourceWidth ) {
+				const float *taps = &column[leftX * channels];
+				for( int c = 0; c < channels; c++ ) {
+					float sum = 0.0f;
+					for( int t = 0; t < numWeights; t++ ) {
+						sum += weights[t] * taps[t * channels + c];
+					}
+					output[x * channels + c] = sum;
+				}
+				continue;
+			}
+			for( int c = 0; c < channels; c++ ) {
+				float sum = 0.0f;
+				for( int t = 0; t < numWeights; t++ ) {
+					int sourceX = leftX + t;
+					sourceX = sourceX < 0 ? 0 : ( sourceX < sourceWidth ? sourceX : sourceWidth - 1 );
+					sum += weights[t] * column[sourceX * channels + c];
+				}
+				output[x * channels + c] = sum;
+			}
+		}
+	}
+}
+
+inline double CSCI441_INTERNAL::besselI0( double x ) {
+	// power series of the modified Bessel function of the first kind, order zero
+	double sum = 1.0, term = 1.0;
+	for( int k = 1; k < 32; k++ ) {
+		term *= ( x / ( 2.0 * k ) ) * ( x / ( 2.0 * k ) );
+		sum += term;
+	}
+	return sum;
+}
+
+inline void CSCI441_INTERNAL::compressBlocksRange( const ImageKernelJob &job, size_t first, size_t last ) {
+	const int width = job.sourceWidth, height = job.sourceHeight, channels = job.channels;
+	const int blocksAcross = ( width + 3 ) / 4;
+	unsigned char rgba[64];
+	for( size_t blockY = first; blockY < last; blockY++ ) {
+		unsigned char *block = job.destination + blockY * blocksAcross * job.blockBytes;
+		for( int blockX = 0; blockX < blocksAcross; blockX++ ) {
+			// gather the block as RGBA, repeating the last row and column where the image ends
+			for( int y = 0; y < 4; y++ ) {
+				const int sourceY = std::min( (int)blockY * 4 + y, height - 1 );
+				for( int x = 0; x < 4; x++ ) {
+					const int sourceX = std::min( blockX * 4 + x, width - 1 );
+					const unsigned char *pixel = job.source + ( (size_t)sourceY * width + sourceX ) * channels;
+					unsigned char *texel = rgba + ( y * 4 + x ) * 4;
+					texel[0] = pixel[0];
+					texel[1] = pixel[1];
+					texel[2] = pixel[2];
+					texel[3] = channels == 4 ? pixel[3] : 255;
+				}
+			}
+
+			if( job.blockBytes == 16 ) {
+				compressAlphaBlock( rgba, block );
+				block += 8;
+			}
+			compressColorBlock( rgba, block );
+			block += 8;
+		}
+	}
+}
+
+inline void CSCI441_INTERNAL::compressColorBlock( const unsigned char *rgba, unsigned char *block ) {
+	int low[3] = { 255, 255, 255 }, high[3] = { 0, 0, 0 }, mean[3] = { 0, 0, 0 };
+	for( int i = 0; i < 16; i++ ) {
+		for( int c = 0; c < 3; c++ ) {
+			low[c] = std::min( low[c], (int)rgba[i*4 + c] );
+			high[c] = std::max( high[c], (int)rgba[i*4 + c] );
+			mean[c] += rgba[i*4 + c];
+		}
+	}
+
+	// the bounding box runs low to high in green; red and blue run backwards if they fall as green rises
+	int redGreen = 0, blueGreen = 0, redBlue = 0;
+	for( int i = 0; i < 16; i++ ) {
+		const int red = rgba[i*4] * 16 - mean[0], green = rgba[i*4 + 1] * 16 - mean[1], blue = rgba[i*4 + 2] * 16 - mean[2];
+		redGreen += red * green;
+		blueGreen += blue * green;
+		redBlue += red * blue;
+	}
+	if( high[1] == low[1] ) blueGreen = redBlue;		// flat green: follow blue against red instead
+	if( redGreen < 0 ) std::swap( low[0], high[0] );
+	if( blueGreen < 0 ) std::swap( low[2], high[2] );
+
+	// pull both ends in by a sixteenth so the interpolated colors sit among the pixels rather than past them
+	for( int c = 0; c < 3; c++ ) {
+		const int inset = ( high[c] - low[c] ) / 16;
+		high[c] -= inset;
+		low[c] += inset;
+	}
+	unsigned int endpoint[2], indices;
+	int steps[16];
+	int error = fitColorBlock( rgba, high, low, endpoint, indices, steps );
+
+	// then refit both ends by least squares to the pixels each step was given, keeping whichever fits better
+	float sumHigh2 = 0.0f, sumHighLow = 0.0f, sumLow2 = 0.0f, sumHighX[3] = { 0.0f, 0.0f, 0.0f }, sumLowX[3] = { 0.0f, 0.0f, 0.0f };
+	for( int i = 0; i < 16; i++ ) {
+		const float weightHigh = steps[i] / 3.0f, weightLow = 1.0f - weightHigh;
+		sumHigh2 += weightHigh * weightHigh;
+		sumHighLow += weightHigh * weightLow;
+		sumLow2 += weightLow * weightLow;
+		for( int c = 0; c < 3; c++ ) {
+			sumHighX[c] += weightHigh * rgba[i*4 + c];
+			sumLowX[c] += weightLow * rgba[i*4 + c];
+		}
+	}
+	const float determinant = sumHigh2 * sumLow2 - sumHighLow * sumHighLow;
+	if( determinant > 0.0f ) {
+		int refitHigh[3], refitLow[3];
+		for( int c = 0; c < 3; c++ ) {
+			const float fitHigh = ( sumLow2 * sumHighX[c] - sumHighLow * sumLowX[c] ) / determinant;
+			const float fitLow = ( sumHigh2 * sumLowX[c] - sumHighLow * sumHighX[c] ) / determinant;
+			refitHigh[c] = fitHigh < 0.0f ? 0 : ( fitHigh > 255.0f ? 255 : (int)( fitHigh + 0.5f ) );
+			refitLow[c] = fitLow < 0.0f ? 0 : ( fitLow > 255.0f ? 255 : (int)( fitLow + 0.5f ) );
+		}
+		unsigned int refitEndpoint[2], refitIndices;
+		const int refitError = fitColorBlock( rgba, refitHigh, refitLow, refitEndpoint, refitIndices, steps );
+		if( refitError < error ) {
+			endpoint[0] = refitEndpoint[0];
+			endpoint[1] = refitEndpoint[1];
+			indices = refitIndices;
+		}
+	}
+
+	block[0] = (unsigned char)endpoint[0];
+	block[1] = (unsigned char)( endpoint[0] >> 8 );
+	block[2] = (unsigned char)endpoint[1];
+	block[3] = (unsigned char)( endpoint[1] >> 8 );
+	block[4] = (unsigned char)indices;
+	block[5] = (unsigned char)( indices >> 8 );
+	block[6] = (unsigned char)( indices >> 16 );
+	block[7] = (unsigned char)( indices >> 24 );
+}
+
+inline int CSCI441_INTERNAL::fitColorBlock( const unsigned char *rgba, const int high[3], const int low[3], unsigned int endpoint[2], unsigned int &indices, int steps[16] ) {
+	endpoint[0] = ( ( high[0] * 31 + 127 ) / 255 ) << 11 | ( ( high[1] * 63 + 127 ) / 255 ) << 5 | ( high[2] * 31 + 127 ) / 255;
+	endpoint[1] = ( ( low[0] * 31 + 127 ) / 255 ) << 11 | ( ( low[1] * 63 + 127 ) / 255 ) << 5 | ( low[2] * 31 + 127 ) / 255;
+	if( endpoint[0] < endpoint[1] ) std::swap( endpoint[0], endpoint[1] );		// the larger first selects four colors
+	int palette[4][3];
+	for( int e = 0; e < 2; e++ ) {
+		palette[3 * ( 1 - e )][0] = ( endpoint[e] >> 11 ) << 3 | endpoint[e] >> 13;
+		palette[3 * ( 1 - e )][1] = ( endpoint[e] >> 5 & 63 ) << 2 | ( endpoint[e] >> 9 & 3 );
+		palette[3 * ( 1 - e )][2] = ( endpoint[e] & 31 ) << 3 | ( endpoint[e] >> 2 & 7 );
+	}
+	for( int c = 0; c < 3; c++ ) {
+		palette[1][c] = ( 2 * palette[0][c] + palette[3][c] ) / 3;
+		palette[2][c] = ( palette[0][c] + 2 * palette[3][c] ) / 3;
+	}
+
+	// project each pixel onto the line from the second color (step 0) to the first (step 3) and take the nearest step
+	static const unsigned int STEP_TO_INDEX[4] = { 1, 3, 2, 0 };
+	const int axis[3] = { palette[3][0] - palette[0][0], palette[3][1] - palette[0][1], palette[3][2] - palette[0][2] };
+	const int length = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	int error = 0;
+	indices = 0;
+	for( int i = 15; i >= 0; i-- ) {
+		int step = 0;
+		if( length > 0 ) {
+			const int dot = ( rgba[i*4] - palette[0][0] ) * axis[0] + ( rgba[i*4 + 1] - palette[0][1] ) * axis[1] + ( rgba[i*4 + 2] - palette[0][2] ) * axis[2];
+			step = ( 6 * dot + length ) / ( 2 * length );
+			step = step < 0 ? 0 : ( step > 3 ? 3 : step );
+		}
+		steps[i] = step;
+		indices = indices << 2 | ( length > 0 ? STEP_TO_INDEX[step] : 0 );
+		for( int c = 0; c < 3; c++ ) {
+			const int difference = rgba[i*4 + c] - palette[length > 0 ? step : 3][c];
+			error += difference * difference;
+		}
+	}
+	return error;
+}
+
+inline void CSCI441_INTERNAL::compressAlphaBlock( const unsigned char *rgba, unsigned char *block ) {
+	int low = 255, high = 0;
+	for( int i = 0; i < 16; i++ ) {
+		low = std::min( low, (int)rgba[i*4 + 3] );
+		high = std::max( high, (int)rgba[i*4 + 3] );
+	}
+	block[0] = (unsigned char)high;
+	block[1] = (unsigned char)low;
+
+	// with the larger first the block holds both ends and six steps between, from high down to low
+	static const unsigned int STEP_TO_INDEX[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+	const int range = high - low;
+	unsigned long long indices = 0;
+	if( range > 0 ) {
+		for( int i = 15; i >= 0; i-- ) {
+			const int step = ( 14 * ( rgba[i*4 + 3] - low ) + range ) / ( 2 * range );
+			indices = indices << 3 | STEP_TO_INDEX[step];
+		}
+	}
+	for( int b = 0; b < 6; b++ ) {
+		block[2 + b] = (unsigned char)( indices >> ( 8 * b ) );
+	}
+}
+
+inline CSCI441_INTERNAL::SRGBTables::SRGBTables() {
+	for( unsigned int code = 0; code < 256; code++ ) {
+		double value = code / 255.0;
+		toLinear[code] = (float)( value <= 0.04045 ? value / 12.92 : pow( ( value + 0.055 ) / 1.055, 2.4 ) );
+	}
+
+	// code k covers linear values from the decoded midpoint between k-1 and k up to the next midpoint
+	codeStarts[0] = -1.0f;
+	for( unsigned int code = 1; code < 256; code++ ) {
+		double value = ( code - 0.5 ) / 255.0;
+		codeStarts[code] = (float)( value <= 0.04045 ? value / 12.92 : pow( ( value + 0.055 ) / 1.055, 2.4 ) );
+	}
+	codeStarts[256] = 2.0f;
+
+	unsigned int code = 0;
+	for( unsigned int bin = 0; bin <= SRGB_ENCODE_BINS; bin++ ) {
+		const float binStart = (float)bin / SRGB_ENCODE_BINS;
+		while( code < 255 && codeStarts[code+1] <= binStart ) code++;
+		firstCode[bin] = (unsigned char)code;
+	}
+	for( unsigned int bin = SRGB_ENCODE_BINS + 1; bin < SRGB_ENCODE_BINS + 4; bin++ ) {
+		firstCode[bin] = firstCode[SRGB_ENCODE_BINS];
+	}
+}
+
+inline const CSCI441_INTERNAL::SRGBTables& CSCI441_INTERNAL::getSRGBTables() {
+	static const SRGBTables tables;
+	return tables;
+}
+
+#ifdef CSCI441_IMAGEKERNELS_X86
+// eight pixels a step.  three byte pixels are loaded twelve bytes apart into the two halves
+// of a register, since a byte shuffle cannot cross between them
+__attribute__(( target( "avx2" ) ))
+inline size_t CSCI441_INTERNAL::swapRedBlueAVX2( const ImageKernelJob &job, size_t first, size_t last ) {
+	const unsigned char *source = job.source;
+	unsigned char *destination = job.destination;
+	size_t i = first;
+
+	if( job.channels == 4 ) {
+		const __m256i order = _mm256_setr_epi8( 2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15, 2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15 );
+		for( ; i + 8 <= last; i += 8 ) {
+			const __m256i pixels = _mm256_loadu_si256( (const __m256i*)( source + 4*i ) );
+			_mm256_storeu_si256( (__m256i*)( destination + 4*i ), _mm256_shuffle_epi8( pixels, order ) );
+		}
+	} else if( job.channels == 3 ) {
+		// the last four bytes of each half are passed through, so storing the low half first and the
+		// high half over it leaves only bytes the next step rewrites, and in place leaves them as they were
+		const __m256i order = _mm256_setr_epi8( 2,1,0, 5,4,3, 8,7,6, 11,10,9, 12,13,14,15, 2,1,0, 5,4,3, 8,7,6, 11,10,9, 12,13,14,15 );
+		for( ; i + 10 <= last; i += 8 ) {
+			const __m256i pixels = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)( source + 3*i ) ) ),
+															_mm_loadu_si128( (const __m128i*)( source + 3*i + 12 ) ), 1 );
+			const __m256i swapped = _mm256_shuffle_epi8( pixels, order );
+			_mm_storeu_si128( (__m128i*)( destination + 3*i ), _mm256_castsi256_si128( swapped ) );
+			_mm_storeu_si128( (__m128i*)( destination + 3*i + 12 ), _mm256_extracti128_si256( swapped, 1 ) );
+		}
+	}
+	return i;
+}
+
+// eight pixels a step; gray pixels and mask values are gathered, which may read three bytes
+// past the pixel, so the step stops while eleven pixels remain
+__attribute__(( target( "avx2" ) ))
+inline size_t CSCI441_INTERNAL::expandRGBAAVX2( const ImageKernelJob &job, size_t first, size_t last ) {
+	const int colorChannels = job.source ? job.sourceChannels : 0;
+	const int maskChannels = job.maskChannels;
+	const __m256i rgb = _mm256_set1_epi32( 0x00FFFFFF ), lanes = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+	const __m256i colorOffsets = _mm256_mullo_epi32( lanes, _mm256_set1_epi32( colorChannels ) );
+	const __m256i maskOffsets = _mm256_mullo_epi32( lanes, _mm256_set1_epi32( maskChannels ) );
+	const __m256i spread = _mm256_setr_epi8( 0,1,2,-1, 3,4,5,-1, 6,7,8,-1, 9,10,11,-1, 0,1,2,-1, 3,4,5,-1, 6,7,8,-1, 9,10,11,-1 );
+	size_t i = first;
+	for( ; i + 11 <= last; i += 8 ) {
+		__m256i colors = rgb;
+		if( colorChannels == 4 ) {
+			colors = _mm256_and_si256( _mm256_loadu_si256( (const __m256i*)( job.source + 4*i ) ), rgb );
+		} else if( colorChannels == 3 ) {
+			const __m256i packed = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)( job.source + 3*i ) ) ),
+															_mm_loadu_si128( (const __m128i*)( job.source + 3*i + 12 ) ), 1 );
+			colors = _mm256_shuffle_epi8( packed, spread );
+		} else if( colorChannels > 0 ) {
+			const __m256i gray = _mm256_and_si256( _mm256_i32gather_epi32( (const int*)( job.source + colorChannels*i ), colorOffsets, 1 ), _mm256_set1_epi32( 0xFF ) );
+			colors = _mm256_mullo_epi32( gray, _mm256_set1_epi32( 0x010101 ) );
+		}
+
+		__m256i alphas = _mm256_set1_epi32( (int)0xFF000000 );
+		if( job.mask ) {
+			alphas = _mm256_slli_epi32( _mm256_i32gather_epi32( (const int*)( job.mask + maskChannels*i ), maskOffsets, 1 ), 24 );
+		}
+		_mm256_storeu_si256( (__m256i*)( job.destination + 4*i ), _mm256_or_si256( colors, alphas ) );
+	}
+	return i;
+}
+
+// the SSE2 step on registers twice as wide; the unpacks and the pack work within each half alike
+__attribute__(( target( "avx2" ) ))
+inline size_t CSCI441_INTERNAL::premultiplyAlphaAVX2( const ImageKernelJob &job, size_t first, size_t last ) {
+	unsigned char *rgba = job.destination;
+	const __m256i zero = _mm256_setzero_si256(), half = _mm256_set1_epi16( 128 ), alpha = _mm256_set1_epi32( (int)0xFF000000 );
+	const __m256i alphaOrder = _mm256_setr_epi8( 6,7,6,7,6,7,6,7, 14,15,14,15,14,15,14,15, 6,7,6,7,6,7,6,7, 14,15,14,15,14,15,14,15 );
+	size_t i = first;
+	for( ; i + 8 <= last; i += 8 ) {
+		const __m256i pixels = _mm256_loadu_si256( (const __m256i*)( rgba + 4*i ) );
+		__m256i low = _mm256_unpacklo_epi8( pixels, zero ), high = _mm256_unpackhi_epi8( pixels, zero );
+		low = _mm256_add_epi16( _mm256_mullo_epi16( low, _mm256_shuffle_epi8( low, alphaOrder ) ), half );
+		high = _mm256_add_epi16( _mm256_mullo_epi16( high, _mm256_shuffle_epi8( high, alphaOrder ) ), half );
+		low = _mm256_srli_epi16( _mm256_add_epi16( low, _mm256_srli_epi16( low, 8 ) ), 8 );
+		high = _mm256_srli_epi16( _mm256_add_epi16( high, _mm256_srli_epi16( high, 8 ) ), 8 );
+		const __m256i product = _mm256_packus_epi16( low, high );
+		_mm256_storeu_si256( (__m256i*)( rgba + 4*i ), _mm256_blendv_epi8( product, pixels, alpha ) );
+	}
+	return i;
+}
+
+// eight pixels a step, one register of eight samples per channel; every fourth sample of RGBA is alpha
+__attribute__(( target( "avx2" ) ))
+inline size_t CSCI441_INTERNAL::srgbToLinearAVX2( const ImageKernelJob &job, size_t first, size_t last ) {
+	const float *toLinear = getSRGBTables().toLinear;
+	const int channels = job.channels;
+	const __m256 scale = _mm256_set1_ps( 1.0f / 255.0f );
+	size_t i = first;
+	for( ; i + 8 <= last; i += 8 ) {
+		for( int v = 0; v < channels; v++ ) {
+			const size_t sample = channels*i + 8*v;
+			const __m256i codes = _mm256_cvtepu8_epi32( _mm_loadl_epi64( (const __m128i*)( job.source + sample ) ) );
+			__m256 linear = _mm256_i32gather_ps( toLinear, codes, 4 );
+			if( channels == 4 ) linear = _mm256_blend_ps( linear, _mm256_mul_ps( _mm256_cvtepi32_ps( codes ), scale ), 0x88 );
+			_mm256_storeu_ps( job.linearDestination + sample, linear );
+		}
+	}
+	return i;
+}
+
+// the table lookups of linearToSrgbPixels() as gathers, eight samples at a time
+__attribute__(( target( "avx2" ) ))
+inline size_t CSCI441_INTERNAL::linearToSrgbAVX2( const ImageKernelJob &job, size_t first, size_t last ) {
+	const SRGBTables &tables = getSRGBTables();
+	const int channels = job.channels;
+	const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps( 1.0f ), bins = _mm256_set1_ps( (float)SRGB_ENCODE_BINS );
+	const __m256 byteScale = _mm256_set1_ps( 255.0f ), half = _mm256_set1_ps( 0.5f );
+	const __m256i lowByte = _mm256_set1_epi32( 0xFF );
+	const __m256i narrow = _mm256_setr_epi8( 0,4,8,12, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1, 0,4,8,12, -1,-1,-1,-1, -1,-1,-1,-1, -1,-1,-1,-1 );
+	const __m256i halves = _mm256_setr_epi32( 0, 4, 0, 0, 0, 0, 0, 0 );
+	size_t i = first;
+	for( ; i + 8 <= last; i += 8 ) {
+		for( int v = 0; v < channels; v++ ) {
+			const size_t sample = channels*i + 8*v;
+			// max() first so NaN clamps to zero as it does in the plain loop
+			const __m256 value = _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( job.linearSource + sample ), zero ), one );
+			const __m256i bin = _mm256_cvttps_epi32( _mm256_mul_ps( value, bins ) );
+			const __m256i code = _mm256_and_si256( _mm256_i32gather_epi32( (const int*)tables.firstCode, bin, 1 ), lowByte );
+			const __m256 nextStart = _mm256_i32gather_ps( tables.codeStarts + 1, code, 4 );
+			__m256i result = _mm256_sub_epi32( code, _mm256_castps_si256( _mm256_cmp_ps( value, nextStart, _CMP_GE_OQ ) ) );
+			if( channels == 4 ) result = _mm256_blend_epi32( result, _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps( value, byteScale ), half ) ), 0x88 );
+			const __m256i bytes = _mm256_permutevar8x32_epi32( _mm256_shuffle_epi8( result, narrow ), halves );
+			_mm_storel_epi64( (__m128i*)( job.destination + sample ), _mm256_castsi256_si128( bytes ) );
+		}
+	}
+	return i;
+}
+
+inline bool CSCI441_INTERNAL::useAVX2ImageKernels() {
+	// asked once; every worker after that reads the answer
+	static const bool avx2 = ( __builtin_cpu_init(), __builtin_cpu_supports( "avx2" ) != 0 );
+	return avx2;
+}
+#endif
+
+#endif // __CSCI441_IMAGEKERNELS_HPP__
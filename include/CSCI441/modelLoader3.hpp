@@ -11,7 +11,12 @@
 	*		.off
 	*		.stl
 	*
-	*	@warning NOTE: This header file will only work with OpenGL 3.0+
+	*	With texture packing enabled, every diffuse map of an .obj model is packed
+	*	into one CSCI441::TextureArray and its texture coordinates become three
+	*	components (s, t, layer).  The array is bound once per draw, so the
+	*	model's shader must sample a sampler2DArray with a vec3 coordinate.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
 	*	@warning NOTE: This header file depends upon GLEW
   */
 
@@ -34,7 +39,12 @@ using namespace std;
 #include <string.h>
 #include <time.h>
 
+#include <CSCI441/imageDecoder.hpp>
+#include <CSCI441/imageKernels.hpp>
 #include <CSCI441/modelMaterial.hpp>
+#include <CSCI441/textureArray3.hpp>
+#include <CSCI441/textureCache3.hpp>
+#include <CSCI441/textureRegistry3.hpp>
 #include <CSCI441/TextureUtils.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -75,7 +85,7 @@ namespace CSCI441 {
 			* @param GLint matSpecLocation	- attribute location of material specular component
 			* @param GLint matShinLocation	- attribute location of material shininess component
 			* @param GLint matAmbLocation		- attribute location of material ambient component
-			* @param GLenum diffuseTexture	- texture number to bind diffuse texture map to
+			* @param GLenum diffuseTexture	- texture unit to bind diffuse texture map and its sampler to
 			* @return true if draw succeeded, false otherwise
 			*/
 		bool draw( GLint positionLocation, GLint normalLocation = -1, GLint texCoordLocation = -1,
@@ -100,6 +110,29 @@ namespace CSCI441 {
 			*/
 		static void disableAutoGenerateNormals();
 
+		/** @brief Enable packing an .obj model's diffuse maps into one array texture
+			*
+			* Every map_Kd of the model is packed into a CSCI441::TextureArray that
+			* draw() binds once, and materials that share colors then draw in a single
+			* call.  Texture coordinates are given to the shader as a vec3 (s, t, layer)
+			* to sample a sampler2DArray, and materials without a map sample white.
+			*
+			* @note Must be called prior to loading in a model from file
+			*/
+		static void enableTexturePacking();
+		/** @brief Disable packing an .obj model's diffuse maps into one array texture
+			*
+			* Each map_Kd is its own GL_TEXTURE_2D bound by the materials using it.
+			*
+			* @note Must be called prior to loading in a model from file
+			* @note Textures are not packed by default
+			*/
+		static void disableTexturePacking();
+
+		/** @brief Returns the array texture the model's diffuse maps were packed into, or NULL if they were not packed
+			*/
+		const CSCI441::TextureArray* getTextureArray() const;
+
 	private:
 		void _init();
 		bool _loadMTLFile( const char *mtlFilename, bool INFO, bool ERRORS );
@@ -109,6 +142,13 @@ namespace CSCI441 {
 		bool _loadSTLFile( bool INFO, bool ERRORS );
 		vector<string> _tokenizeString( string input, string delimiters );
 
+		void _addPendingTexture( const string &materialName, const string &colorFile, const string &maskFile, const string &path );
+		void _decodePendingTextures( bool INFO, bool ERRORS );
+		void _groupMaterialIndices( unsigned int numIndices );
+		bool _packTextures( bool INFO, bool ERRORS );
+		void _uploadPendingTextures();
+		void _buildDrawBatches();
+
 		char* _filename;
 		CSCI441_INTERNAL::MODEL_TYPE _modelType;
 
@@ -118,12 +158,18 @@ namespace CSCI441 {
 		GLfloat* _vertices;
 		GLfloat* _texCoords;
 		GLfloat* _normals;
+		GLfloat* _packedTexCoords;
 		unsigned int* _indices;
 		unsigned int _uniqueIndex;
 		unsigned int _numIndices;
 
 		map< string, CSCI441_INTERNAL::ModelMaterial* > _materials;
 		map< string, vector< pair< unsigned int, unsigned int > > > _materialIndexStartStop;
+		vector< CSCI441_INTERNAL::ModelDrawBatch > _drawBatches;
+
+		map< string, CSCI441_INTERNAL::ModelPendingTexture > _pendingTextures;
+		map< string, string > _pendingMaterialTextures;
+		CSCI441::TextureArray* _textureArray;
 
 		bool _hasVertexTexCoords;
 		bool _hasVertexNormals;
@@ -137,7 +183,10 @@ namespace CSCI441 {
 
 namespace CSCI441_INTERNAL {
 	unsigned char* createTransparentTexture( unsigned char *imageData, unsigned char *imageMask, int texWidth, int texHeight, int texChannels, int maskChannels );
-	void flipImageY( int texWidth, int texHeight, int textureChannels, unsigned char *textureData );
+	string findTextureFile( const string &filename, const string &path );
+	bool sameMaterialState( const ModelMaterial *lhs, const ModelMaterial *rhs, bool packed );
+	GLuint getModelTextureSampler();
+	bool& modelTexturePacking();
 }
 
 bool CSCI441::ModelLoader::AUTO_GEN_NORMALS = false;
@@ -155,7 +204,9 @@ inline CSCI441::ModelLoader::~ModelLoader() {
 	if( _vertices ) 			free( _vertices );
 	if( _texCoords ) 			free( _texCoords );
 	if( _normals ) 				free( _normals );
+	if( _packedTexCoords )	free( _packedTexCoords );
 	if( _indices ) 				free( _indices );
+	if( _textureArray )		delete _textureArray;
 
 	glDeleteBuffers( 1, &_vaod );
 	glDeleteBuffers( 2, _vbods );
@@ -168,7 +219,9 @@ inline void CSCI441::ModelLoader::_init() {
 	_vertices = NULL;
 	_texCoords = NULL;
 	_normals = NULL;
+	_packedTexCoords = NULL;
 	_indices = NULL;
+	_textureArray = NULL;
 
 	glGenVertexArrays( 1, &_vaod );
 	glGenBuffers( 2, _vbods );
@@ -217,44 +270,32 @@ inline bool CSCI441::ModelLoader::draw( GLint positionLocation, GLint normalLoca
 	glVertexAttribPointer( normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat) * _uniqueIndex * 3) );
 
 	glEnableVertexAttribArray( texCoordLocation );
-	glVertexAttribPointer( texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat) * _uniqueIndex * 6) );
+	glVertexAttribPointer( texCoordLocation, _packedTexCoords ? 3 : 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat) * _uniqueIndex * 6) );
 
 	if( _modelType == CSCI441_INTERNAL::OBJ ) {
-		for( map< string, vector< pair< unsigned int, unsigned int > > >::iterator materialIter = _materialIndexStartStop.begin();
-						materialIter != _materialIndexStartStop.end();
-						materialIter++ ) {
-
-			string materialName = materialIter->first;
-			vector< pair< unsigned int, unsigned int > > indexStartStop = materialIter->second;
-
-			CSCI441_INTERNAL::ModelMaterial* material = NULL;
-			if( _materials.find( materialName ) != _materials.end() )
-				material = _materials.find( materialName )->second;
-
-			for( vector< pair< unsigned int, unsigned int > >::iterator idxIter = indexStartStop.begin();
-							idxIter != indexStartStop.end();
-							idxIter++ ) {
+		if( _textureArray != NULL ) {
+			// every diffuse map is somewhere in the one array
+			CSCI441::TextureRegistry::bindTexture( diffuseTexture, _textureArray->getTextureHandle() );
+		}
 
-				unsigned int start = idxIter->first;
-				unsigned int end = idxIter->second;
-				unsigned int length = end - start + 1;
+		for( vector< CSCI441_INTERNAL::ModelDrawBatch >::iterator batchIter = _drawBatches.begin();
+						batchIter != _drawBatches.end();
+						batchIter++ ) {
 
-				//printf( "rendering material %s (%u, %u) = %u\n", materialName.c_str(), start, end, length );
+			CSCI441_INTERNAL::ModelMaterial* material = batchIter->material;
 
-				if( material != NULL ) {
-					glUniform4fv( matAmbLocation, 1, material->ambient );
-					glUniform4fv( matDiffLocation, 1, material->diffuse );
-					glUniform4fv( matSpecLocation, 1, material->specular );
-					glUniform1f( matShinLocation, material->shininess );
+			if( material != NULL ) {
+				glUniform4fv( matAmbLocation, 1, material->ambient );
+				glUniform4fv( matDiffLocation, 1, material->diffuse );
+				glUniform4fv( matSpecLocation, 1, material->specular );
+				glUniform1f( matShinLocation, material->shininess );
 
-					if( material->map_Kd != -1 ) {
-						glActiveTexture( diffuseTexture );
-						glBindTexture( GL_TEXTURE_2D, material->map_Kd );
-					}
+				if( _textureArray == NULL && material->map_Kd != -1 ) {
+					CSCI441::TextureRegistry::bindTexture( diffuseTexture, material->map_Kd );
 				}
-
-				glDrawElements( GL_TRIANGLES, length, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int)*start) );
 			}
+
+			glDrawElements( GL_TRIANGLES, batchIter->count, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int)*batchIter->start) );
 		}
 	} else {
 		glDrawElements( GL_TRIANGLES, _numIndices, GL_UNSIGNED_INT, (void*)0 );
@@ -692,12 +733,22 @@ inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
 
 	_materialIndexStartStop.find( currentMaterial )->second.back().second = indicesSeen - 1;
 
+	_groupMaterialIndices( indicesSeen );
+	if( CSCI441_INTERNAL::modelTexturePacking() ) {
+		_packTextures( INFO, ERRORS );
+	}
+	_buildDrawBatches();
+
+	if (INFO) printf( "[.obj]: Materials:\t%u\tDraw Calls:\t%u\n", (unsigned int)_materialIndexStartStop.size(), (unsigned int)_drawBatches.size() );
+
+	const unsigned int texCoordComponents = _packedTexCoords ? 3 : 2;
+
 	glBindVertexArray( _vaod );
 	glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
-	glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, NULL, GL_STATIC_DRAW );
+	glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * (6 + texCoordComponents), NULL, GL_STATIC_DRAW );
 	glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * _uniqueIndex * 3, _vertices );
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 3, sizeof(GLfloat) * _uniqueIndex * 3, _normals );
-	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 6, sizeof(GLfloat) * _uniqueIndex * 2, _texCoords );
+	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 6, sizeof(GLfloat) * _uniqueIndex * texCoordComponents, _packedTexCoords ? _packedTexCoords : _texCoords );
 
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _vbods[1] );
 	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indicesSeen, _indices, GL_STATIC_DRAW );
@@ -746,9 +797,14 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 	unsigned char *fullData;
 	int texWidth, texHeight, textureChannels = 1, maskChannels = 1;
 	GLuint textureHandle = 0;
+	CSCI441::TextureCache::CachedTexture cachedTexture;
+	string cachedTextureFile;
 
 	map< string, GLuint > imageHandles;
 
+	// with texture packing, the maps named by the current material
+	string packedColorFile, packedMaskFile;
+
 	int numMaterials = 0;
 
 	while( getline( in, line ) ) {
@@ -770,8 +826,11 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 			textureHandle = 0;
 			textureData = NULL;
 			maskData = NULL;
+			cachedTextureFile.clear();
 			textureChannels = 1;
 			maskChannels = 1;
+			packedColorFile.clear();
+			packedMaskFile.clear();
 
 			numMaterials++;
 		} else if( !tokens[0].compare( "Ka" ) ) {					// ambient component
@@ -800,19 +859,36 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 		} else if( !tokens[0].compare( "illum" ) ) {				// illumination type component
 			// TODO ?
 		} else if( !tokens[0].compare( "map_Kd" ) ) {				// diffuse color texture map
-			if( imageHandles.find( tokens[1] ) != imageHandles.end() ) {
+			if( CSCI441_INTERNAL::modelTexturePacking() ) {
+				packedColorFile = tokens[1];
+				_addPendingTexture( materialName, packedColorFile, packedMaskFile, path );
+			} else if( imageHandles.find( tokens[1] ) != imageHandles.end() ) {
 				// _textureHandles->insert( pair< string, GLuint >( materialName, imageHandles.find( tokens[1] )->second ) );
 				currentMaterial->map_Kd = imageHandles.find( tokens[1] )->second;
+			} else if( maskData == NULL && cachedTexture.load( CSCI441_INTERNAL::findTextureFile( tokens[1], path ).c_str() ) ) {
+				// with no alpha map to merge, the flipped levels come ready made from the texture cache
+				if (INFO) printf( "[.mtl]: TextureMap:\t%s\tSize: %dx%d\tColors: %d\t(%s in %.1f ms)\n", tokens[1].c_str(), cachedTexture.getWidth(), cachedTexture.getHeight(),
+								  cachedTexture.getChannels(), cachedTexture.wasCached() ? "cached" : "processed", cachedTexture.getLoadTime() );
+
+				if( textureHandle == 0 ) {
+					glGenTextures( 1, &textureHandle );
+					imageHandles.insert( pair<string, GLuint>( tokens[1], textureHandle ) );
+				}
+
+				glBindTexture( GL_TEXTURE_2D, textureHandle );
+				cachedTexture.upload();
+				CSCI441::TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, cachedTexture.getFormat(), cachedTexture.getWidth(), cachedTexture.getHeight(), 1, cachedTexture.getNumLevels(),
+														   CSCI441_INTERNAL::getModelTextureSampler(), tokens[1].c_str() );
+				cachedTexture.release();
+
+				// only decoded again if an alpha map follows
+				cachedTextureFile = CSCI441_INTERNAL::findTextureFile( tokens[1], path );
+				currentMaterial->map_Kd = textureHandle;
 			} else {
-				textureData = SOIL_load_image( tokens[1].c_str(), &texWidth, &texHeight, &textureChannels, SOIL_LOAD_AUTO );
+				textureData = CSCI441::ImageDecoder::loadImage( tokens[1].c_str(), &texWidth, &texHeight, &textureChannels, SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
 				if( !textureData ) {
 					string folderName = path + tokens[1];
-					textureData = SOIL_load_image( folderName.c_str(), &texWidth, &texHeight, &textureChannels, SOIL_LOAD_AUTO );
-					if( textureData) {
-						CSCI441_INTERNAL::flipImageY( texWidth, texHeight, textureChannels, textureData );
-					}
-				} else {
-					CSCI441_INTERNAL::flipImageY( texWidth, texHeight, textureChannels, textureData );
+					textureData = CSCI441::ImageDecoder::loadImage( folderName.c_str(), &texWidth, &texHeight, &textureChannels, SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
 				}
 
 				if( !textureData ) {
@@ -828,16 +904,12 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 
 						glBindTexture( GL_TEXTURE_2D, textureHandle );
 
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-						GLenum colorSpace = GL_RGB;
-						if( textureChannels == 4 )
-							colorSpace = GL_RGBA;
-						glTexImage2D( GL_TEXTURE_2D, 0, colorSpace, texWidth, texHeight, 0, colorSpace, GL_UNSIGNED_BYTE, textureData );
+						// every level, filtered in linear light, with trilinear minification
+						CSCI441::TextureUtils::MipmapChain mipmaps;
+						mipmaps.build( textureData, texWidth, texHeight, textureChannels );
+						mipmaps.upload();
+						CSCI441::TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, mipmaps.getFormat(), mipmaps.getWidth(), mipmaps.getHeight(), 1, mipmaps.getNumLevels(),
+																   CSCI441_INTERNAL::getModelTextureSampler(), tokens[1].c_str() );
 
 						currentMaterial->map_Kd = textureHandle;
 					} else {
@@ -850,34 +922,38 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 
 						glBindTexture( GL_TEXTURE_2D, textureHandle );
 
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+						CSCI441::TextureUtils::MipmapChain mipmaps;
+						mipmaps.build( fullData, texWidth, texHeight, 4 );
+						mipmaps.upload();
+						CSCI441::TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, mipmaps.getFormat(), mipmaps.getWidth(), mipmaps.getHeight(), 1, mipmaps.getNumLevels(),
+																   CSCI441_INTERNAL::getModelTextureSampler(), tokens[1].c_str() );
 
-						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, fullData );
-
-						delete fullData;
+						delete[] fullData;
 
 						currentMaterial->map_Kd = textureHandle;
 					}
 				}
 			}
 		} else if( !tokens[0].compare( "map_d" ) ) {				// alpha texture map
-			if( imageHandles.find( tokens[1] ) != imageHandles.end() ) {
+			if( CSCI441_INTERNAL::modelTexturePacking() ) {
+				// merged with the color map, whichever of the two comes first
+				packedMaskFile = tokens[1];
+				if( !packedColorFile.empty() ) {
+					_addPendingTexture( materialName, packedColorFile, packedMaskFile, path );
+				}
+			} else if( imageHandles.find( tokens[1] ) != imageHandles.end() ) {
 				// _textureHandles->insert( pair< string, GLuint >( materialName, imageHandles.find( tokens[1] )->second ) );
 				currentMaterial->map_d = imageHandles.find( tokens[1] )->second;
 			} else {
-				maskData = SOIL_load_image( tokens[1].c_str(), &texWidth, &texHeight, &textureChannels, SOIL_LOAD_AUTO );
-				if( !textureData ) {
+				maskData = CSCI441::ImageDecoder::loadImage( tokens[1].c_str(), &texWidth, &texHeight, &maskChannels, SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
+				if( !maskData ) {
 					string folderName = path + tokens[1];
-					maskData = SOIL_load_image( folderName.c_str(), &texWidth, &texHeight, &textureChannels, SOIL_LOAD_AUTO );
-					if( maskData ) {
-						CSCI441_INTERNAL::flipImageY( texWidth, texHeight, textureChannels, maskData );
-					}
-				} else {
-					CSCI441_INTERNAL::flipImageY( texWidth, texHeight, textureChannels, maskData );
+					maskData = CSCI441::ImageDecoder::loadImage( folderName.c_str(), &texWidth, &texHeight, &maskChannels, SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
+				}
+
+				// a color map that came from the cache has to be decoded after all to merge with the mask
+				if( maskData && textureData == NULL && !cachedTextureFile.empty() ) {
+					textureData = CSCI441::ImageDecoder::loadImage( cachedTextureFile.c_str(), &texWidth, &texHeight, &textureChannels, SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
 				}
 
 				if( !maskData ) {
@@ -891,15 +967,15 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 						if( textureHandle == 0 )
 							glGenTextures( 1, &textureHandle );
 
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+						glBindTexture( GL_TEXTURE_2D, textureHandle );
 
-						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, fullData );
+						CSCI441::TextureUtils::MipmapChain mipmaps;
+						mipmaps.build( fullData, texWidth, texHeight, 4 );
+						mipmaps.upload();
+						CSCI441::TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, mipmaps.getFormat(), mipmaps.getWidth(), mipmaps.getHeight(), 1, mipmaps.getNumLevels(),
+																   CSCI441_INTERNAL::getModelTextureSampler(), tokens[1].c_str() );
 
-						delete fullData;
+						delete[] fullData;
 					}
 				}
 			}
@@ -1759,6 +1835,307 @@ inline void CSCI441::ModelLoader::disableAutoGenerateNormals() {
 	AUTO_GEN_NORMALS = false;
 }
 
+inline void CSCI441::ModelLoader::enableTexturePacking() {
+	CSCI441_INTERNAL::modelTexturePacking() = true;
+}
+
+inline void CSCI441::ModelLoader::disableTexturePacking() {
+	CSCI441_INTERNAL::modelTexturePacking() = false;
+}
+
+inline const CSCI441::TextureArray* CSCI441::ModelLoader::getTextureArray() const {
+	return _textureArray;
+}
+
+// Note a material's diffuse map, merged with its alpha map if it has one, to be decoded and packed once the model is read
+inline void CSCI441::ModelLoader::_addPendingTexture( const string &materialName, const string &colorFile, const string &maskFile, const string &path ) {
+	const string key = maskFile.empty() ? colorFile : colorFile + "|" + maskFile;
+
+	if( _pendingTextures.find( key ) == _pendingTextures.end() ) {
+		CSCI441_INTERNAL::ModelPendingTexture &pending = _pendingTextures[ key ];
+		pending.colorFile = CSCI441_INTERNAL::findTextureFile( colorFile, path );
+		if( !maskFile.empty() ) pending.maskFile = CSCI441_INTERNAL::findTextureFile( maskFile, path );
+		pending.width = pending.height = pending.channels = 0;
+	}
+
+	_pendingMaterialTextures[ materialName ] = key;
+}
+
+// Decode every pending map at once, flipped as they are read, and drop the ones that fail along with their materials' references
+inline void CSCI441::ModelLoader::_decodePendingTextures( bool INFO, bool ERRORS ) {
+	// a color map noted before its material's alpha map showed up is no longer used by anything
+	map< string, bool > used;
+	for( map< string, string >::iterator textureIter = _pendingMaterialTextures.begin(); textureIter != _pendingMaterialTextures.end(); textureIter++ ) {
+		used[ textureIter->second ] = true;
+	}
+
+	vector< string > keys;
+	vector< CSCI441::ImageDecoder::ImageFile > files;
+	for( map< string, CSCI441_INTERNAL::ModelPendingTexture >::iterator pendingIter = _pendingTextures.begin(); pendingIter != _pendingTextures.end(); pendingIter++ ) {
+		if( !used[ pendingIter->first ] ) continue;
+		CSCI441::ImageDecoder::ImageFile file;
+		file.filename = pendingIter->second.colorFile.c_str();
+		files.push_back( file );
+		if( !pendingIter->second.maskFile.empty() ) {
+			file.filename = pendingIter->second.maskFile.c_str();
+			files.push_back( file );
+		}
+		keys.push_back( pendingIter->first );
+	}
+	if( !files.empty() ) {
+		CSCI441::ImageDecoder::loadImages( &files[0], (int)files.size(), SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
+	}
+
+	map< string, CSCI441_INTERNAL::ModelPendingTexture > decoded;
+	size_t f = 0;
+	for( size_t k = 0; k < keys.size(); k++ ) {
+		CSCI441_INTERNAL::ModelPendingTexture &pending = _pendingTextures[ keys[k] ];
+		const CSCI441::ImageDecoder::ImageFile &color = files[f++];
+		const CSCI441::ImageDecoder::ImageFile *mask = pending.maskFile.empty() ? NULL : &files[f++];
+
+		if( !color.pixels ) {
+			if (ERRORS) fprintf( stderr, "[.mtl]: [ERROR]: File Not Found: %s\n", pending.colorFile.c_str() );
+		} else if( mask && ( !mask->pixels || mask->width != color.width || mask->height != color.height ) ) {
+			if (ERRORS) fprintf( stderr, "[.mtl]: [ERROR]: Alpha map %s is missing or not the size of %s\n", pending.maskFile.c_str(), pending.colorFile.c_str() );
+		} else {
+			if (INFO) printf( "[.mtl]: TextureMap:\t%s\tSize: %dx%d\tColors: %d\t(packed)\n", keys[k].c_str(), color.width, color.height, mask ? 4 : color.channels );
+
+			CSCI441_INTERNAL::ModelPendingTexture &kept = decoded[ keys[k] ];
+			kept.width = color.width;
+			kept.height = color.height;
+			if( mask ) {
+				kept.channels = 4;
+				kept.pixels.resize( (size_t)color.width * color.height * 4 );
+				CSCI441::ImageKernels::expandRGBA( color.pixels, color.channels, mask->pixels, mask->channels, &kept.pixels[0], (size_t)color.width * color.height );
+			} else {
+				kept.channels = color.channels;
+				kept.pixels.assign( color.pixels, color.pixels + (size_t)color.width * color.height * color.channels );
+			}
+		}
+		CSCI441::ImageDecoder::freeImageData( color.pixels );
+		if( mask ) CSCI441::ImageDecoder::freeImageData( mask->pixels );
+	}
+	_pendingTextures.swap( decoded );
+
+	for( map< string, string >::iterator textureIter = _pendingMaterialTextures.begin(); textureIter != _pendingMaterialTextures.end(); ) {
+		if( _pendingTextures.find( textureIter->second ) == _pendingTextures.end() ) {
+			_pendingMaterialTextures.erase( textureIter++ );
+		} else {
+			textureIter++;
+		}
+	}
+}
+
+// Move each material's runs of indices next to each other, in the order draw() visits the materials
+inline void CSCI441::ModelLoader::_groupMaterialIndices( unsigned int numIndices ) {
+	if( numIndices == 0 ) return;
+
+	unsigned int *grouped = (unsigned int*)malloc( sizeof(unsigned int) * numIndices );
+	unsigned int numGrouped = 0;
+
+	for( map< string, vector< pair< unsigned int, unsigned int > > >::iterator materialIter = _materialIndexStartStop.begin();
+					materialIter != _materialIndexStartStop.end();
+					materialIter++ ) {
+
+		const unsigned int start = numGrouped;
+		for( vector< pair< unsigned int, unsigned int > >::iterator idxIter = materialIter->second.begin();
+						idxIter != materialIter->second.end();
+						idxIter++ ) {
+			// an empty run stops one before it starts
+			const unsigned int length = idxIter->second - idxIter->first + 1;
+			memcpy( grouped + numGrouped, _indices + idxIter->first, sizeof(unsigned int) * length );
+			numGrouped += length;
+		}
+		materialIter->second.assign( 1, pair< unsigned int, unsigned int >( start, numGrouped - 1 ) );
+	}
+
+	memcpy( _indices, grouped, sizeof(unsigned int) * numGrouped );
+	free( grouped );
+}
+
+// Pack the pending diffuse maps into one array and bake each vertex's place in it into its texture coordinate
+inline bool CSCI441::ModelLoader::_packTextures( bool INFO, bool ERRORS ) {
+	_decodePendingTextures( INFO, ERRORS );
+	if( _pendingTextures.empty() ) return false;
+	if( !_hasVertexTexCoords ) {
+		_uploadPendingTextures();
+		return false;
+	}
+
+	// a map sampled outside [0, 1] must tile a layer of its own
+	map< string, bool > repeats;
+	bool anyUntextured = false;
+	for( map< string, vector< pair< unsigned int, unsigned int > > >::iterator materialIter = _materialIndexStartStop.begin();
+					materialIter != _materialIndexStartStop.end();
+					materialIter++ ) {
+
+		const pair< unsigned int, unsigned int > &indexStartStop = materialIter->second.front();
+		const unsigned int length = indexStartStop.second - indexStartStop.first + 1;
+		map< string, string >::iterator textureIter = _pendingMaterialTextures.find( materialIter->first );
+		if( textureIter == _pendingMaterialTextures.end() ) {
+			if( length > 0 ) anyUntextured = true;
+			continue;
+		}
+
+		bool &textureRepeats = repeats[ textureIter->second ];
+		for( unsigned int i = indexStartStop.first; i < indexStartStop.first + length && !textureRepeats; i++ ) {
+			const GLfloat *texCoord = &_texCoords[ _indices[i] * 2 ];
+			if( texCoord[0] < -0.001f || texCoord[0] > 1.001f || texCoord[1] < -0.001f || texCoord[1] > 1.001f )
+				textureRepeats = true;
+		}
+	}
+
+	CSCI441::TextureArray *textureArray = new CSCI441::TextureArray();
+	map< string, int > images;
+	for( map< string, CSCI441_INTERNAL::ModelPendingTexture >::iterator pendingIter = _pendingTextures.begin();
+					pendingIter != _pendingTextures.end();
+					pendingIter++ ) {
+		const CSCI441_INTERNAL::ModelPendingTexture &pending = pendingIter->second;
+		images[ pendingIter->first ] = textureArray->add( &pending.pixels[0], pending.width, pending.height, pending.channels, repeats[ pendingIter->first ] );
+	}
+	// materials without a map sample white so only their colors show
+	const unsigned char white[4] = { 255, 255, 255, 255 };
+	const int whiteImage = anyUntextured ? textureArray->add( white, 1, 1, 4 ) : -1;
+
+	if( !textureArray->build() ) {
+		if (ERRORS) fprintf( stderr, "[.obj]: [WARN]: Could not pack the textures of %s, binding them one at a time\n", _filename );
+		delete textureArray;
+		_uploadPendingTextures();
+		return false;
+	}
+
+	// a vertex shared by materials packed in different places needs a copy for each place
+	vector< int > vertexImages( _uniqueIndex, -1 );
+	map< pair< unsigned int, int >, unsigned int > copies;
+	vector< unsigned int > copySources;
+	for( map< string, vector< pair< unsigned int, unsigned int > > >::iterator materialIter = _materialIndexStartStop.begin();
+					materialIter != _materialIndexStartStop.end();
+					materialIter++ ) {
+
+		map< string, string >::iterator textureIter = _pendingMaterialTextures.find( materialIter->first );
+		const int image = textureIter != _pendingMaterialTextures.end() ? images[ textureIter->second ] : whiteImage;
+
+		const pair< unsigned int, unsigned int > &indexStartStop = materialIter->second.front();
+		const unsigned int length = indexStartStop.second - indexStartStop.first + 1;
+		for( unsigned int i = indexStartStop.first; i < indexStartStop.first + length; i++ ) {
+			if( vertexImages[ _indices[i] ] == -1 ) {
+				vertexImages[ _indices[i] ] = image;
+			} else if( vertexImages[ _indices[i] ] != image ) {
+				const pair< unsigned int, int > copyKey( _indices[i], image );
+				map< pair< unsigned int, int >, unsigned int >::iterator copyIter = copies.find( copyKey );
+				if( copyIter == copies.end() ) {
+					copyIter = copies.insert( pair< pair< unsigned int, int >, unsigned int >( copyKey, _uniqueIndex + copySources.size() ) ).first;
+					copySources.push_back( _indices[i] );
+					vertexImages.push_back( image );
+				}
+				_indices[i] = copyIter->second;
+			}
+		}
+	}
+
+	if( !copySources.empty() ) {
+		const unsigned int numVertices = _uniqueIndex + copySources.size();
+		_vertices = (GLfloat*)realloc( _vertices, sizeof(GLfloat) * numVertices * 3 );
+		_normals = (GLfloat*)realloc( _normals, sizeof(GLfloat) * numVertices * 3 );
+		_texCoords = (GLfloat*)realloc( _texCoords, sizeof(GLfloat) * numVertices * 2 );
+		for( unsigned int c = 0; c < copySources.size(); c++ ) {
+			memcpy( &_vertices[ (_uniqueIndex + c) * 3 ], &_vertices[ copySources[c] * 3 ], sizeof(GLfloat) * 3 );
+			memcpy( &_normals[ (_uniqueIndex + c) * 3 ], &_normals[ copySources[c] * 3 ], sizeof(GLfloat) * 3 );
+			memcpy( &_texCoords[ (_uniqueIndex + c) * 2 ], &_texCoords[ copySources[c] * 2 ], sizeof(GLfloat) * 2 );
+		}
+		_uniqueIndex = numVertices;
+	}
+
+	_packedTexCoords = (GLfloat*)malloc( sizeof(GLfloat) * _uniqueIndex * 3 );
+	for( unsigned int v = 0; v < _uniqueIndex; v++ ) {
+		if( vertexImages[v] == -1 ) {
+			_packedTexCoords[ v*3 + 0 ] = _texCoords[ v*2 + 0 ];
+			_packedTexCoords[ v*3 + 1 ] = _texCoords[ v*2 + 1 ];
+			_packedTexCoords[ v*3 + 2 ] = 0.0f;
+		} else {
+			const CSCI441::TextureArrayRegion region = textureArray->getRegion( vertexImages[v] );
+			_packedTexCoords[ v*3 + 0 ] = region.offset[0] + _texCoords[ v*2 + 0 ] * region.scale[0];
+			_packedTexCoords[ v*3 + 1 ] = region.offset[1] + _texCoords[ v*2 + 1 ] * region.scale[1];
+			_packedTexCoords[ v*3 + 2 ] = (GLfloat)region.layer;
+		}
+	}
+
+	if (INFO) printf( "[.obj]: Packed %u textures into %d layers of %dx%d\t(%.1f MB in %.1f ms, %u vertices copied)\n", (unsigned int)_pendingTextures.size(),
+					  textureArray->getNumLayers(), textureArray->getWidth(), textureArray->getHeight(),
+					  textureArray->getSize() / 1048576.0, textureArray->getBuildTime(), (unsigned int)copySources.size() );
+
+	_pendingTextures.clear();
+	_pendingMaterialTextures.clear();
+	_textureArray = textureArray;
+	return true;
+}
+
+// Fall back to one GL_TEXTURE_2D per pending map, as if packing were disabled
+inline void CSCI441::ModelLoader::_uploadPendingTextures() {
+	map< string, GLuint > textureHandles;
+	for( map< string, CSCI441_INTERNAL::ModelPendingTexture >::iterator pendingIter = _pendingTextures.begin();
+					pendingIter != _pendingTextures.end();
+					pendingIter++ ) {
+		const CSCI441_INTERNAL::ModelPendingTexture &pending = pendingIter->second;
+
+		GLuint textureHandle;
+		glGenTextures( 1, &textureHandle );
+		glBindTexture( GL_TEXTURE_2D, textureHandle );
+
+		CSCI441::TextureUtils::MipmapChain mipmaps;
+		mipmaps.build( &pending.pixels[0], pending.width, pending.height, pending.channels );
+		mipmaps.upload();
+		CSCI441::TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, mipmaps.getFormat(), mipmaps.getWidth(), mipmaps.getHeight(), 1, mipmaps.getNumLevels(),
+												   CSCI441_INTERNAL::getModelTextureSampler(), pending.colorFile.c_str() );
+
+		textureHandles[ pendingIter->first ] = textureHandle;
+	}
+
+	for( map< string, string >::iterator textureIter = _pendingMaterialTextures.begin();
+					textureIter != _pendingMaterialTextures.end();
+					textureIter++ ) {
+		if( _materials.find( textureIter->first ) != _materials.end() )
+			_materials.find( textureIter->first )->second->map_Kd = textureHandles[ textureIter->second ];
+	}
+
+	_pendingTextures.clear();
+	_pendingMaterialTextures.clear();
+}
+
+// One batch per material, merged with the next when nothing would change between their draws
+inline void CSCI441::ModelLoader::_buildDrawBatches() {
+	_drawBatches.clear();
+
+	for( map< string, vector< pair< unsigned int, unsigned int > > >::iterator materialIter = _materialIndexStartStop.begin();
+					materialIter != _materialIndexStartStop.end();
+					materialIter++ ) {
+
+		CSCI441_INTERNAL::ModelMaterial* material = NULL;
+		if( _materials.find( materialIter->first ) != _materials.end() )
+			material = _materials.find( materialIter->first )->second;
+
+		for( vector< pair< unsigned int, unsigned int > >::iterator idxIter = materialIter->second.begin();
+						idxIter != materialIter->second.end();
+						idxIter++ ) {
+
+			const unsigned int length = idxIter->second - idxIter->first + 1;
+			if( length == 0 ) continue;
+
+			if( !_drawBatches.empty()
+			 && _drawBatches.back().start + _drawBatches.back().count == idxIter->first
+			 && CSCI441_INTERNAL::sameMaterialState( _drawBatches.back().material, material, _textureArray != NULL ) ) {
+				_drawBatches.back().count += length;
+			} else {
+				CSCI441_INTERNAL::ModelDrawBatch batch;
+				batch.material = material;
+				batch.start = idxIter->first;
+				batch.count = length;
+				_drawBatches.push_back( batch );
+			}
+		}
+	}
+}
+
 //
 //  vector<string> tokenizeString(string input, string delimiters)
 //
@@ -1805,43 +2182,40 @@ inline vector<string> CSCI441::ModelLoader::_tokenizeString(string input, string
 inline unsigned char* CSCI441_INTERNAL::createTransparentTexture( unsigned char *imageData, unsigned char *imageMask, int texWidth, int texHeight, int texChannels, int maskChannels ) {
 	//combine the 'mask' array with the image data array into an RGBA array.
 	unsigned char *fullData = new unsigned char[texWidth*texHeight*4];
+	CSCI441::ImageKernels::expandRGBA( imageData, texChannels, imageMask, maskChannels, fullData, (size_t)texWidth*texHeight );
+	return fullData;
+}
 
-	for(int j = 0; j < texHeight; j++) {
-		for(int i = 0; i < texWidth; i++) {
-			if( imageData ) {
-				fullData[(j*texWidth+i)*4+0] = imageData[(j*texWidth+i)*texChannels+0];	// R
-				fullData[(j*texWidth+i)*4+1] = imageData[(j*texWidth+i)*texChannels+1];	// G
-				fullData[(j*texWidth+i)*4+2] = imageData[(j*texWidth+i)*texChannels+2];	// B
-			} else {
-				fullData[(j*texWidth+i)*4+0] = 1;	// R
-				fullData[(j*texWidth+i)*4+1] = 1;	// G
-				fullData[(j*texWidth+i)*4+2] = 1;	// B
-			}
-
-			if( imageMask ) {
-				fullData[(j*texWidth+i)*4+3] = imageMask[(j*texWidth+i)*maskChannels+0];	// A
-			} else {
-				fullData[(j*texWidth+i)*4+3] = 1;	// A
-			}
-		}
+inline string CSCI441_INTERNAL::findTextureFile( const string &filename, const string &path ) {
+	// textures are looked for as named first, then next to the model
+	FILE *fp = fopen( filename.c_str(), "rb" );
+	if( fp ) {
+		fclose( fp );
+		return filename;
 	}
-	return fullData;
+	return path + filename;
 }
 
-inline void CSCI441_INTERNAL::flipImageY( int texWidth, int texHeight, int textureChannels, unsigned char *textureData ) {
-	for( int j = 0; j < texHeight / 2; j++ ) {
-		for( int i = 0; i < texWidth; i++ ) {
-			for( int k = 0; k < textureChannels; k++ ) {
-				int top = (j*texWidth + i)*textureChannels + k;
-				int bot = ((texHeight-j-1)*texWidth + i)*textureChannels + k;
+inline bool CSCI441_INTERNAL::sameMaterialState( const ModelMaterial *lhs, const ModelMaterial *rhs, bool packed ) {
+	if( lhs == rhs ) return true;
+	if( lhs == NULL || rhs == NULL ) return false;
+	// packed maps all live in the one bound array, so only the uniforms have to match
+	if( !packed && lhs->map_Kd != rhs->map_Kd ) return false;
+	for( int i = 0; i < 4; i++ ) {
+		if( lhs->ambient[i] != rhs->ambient[i] || lhs->diffuse[i] != rhs->diffuse[i] || lhs->specular[i] != rhs->specular[i] ) return false;
+	}
+	return lhs->shininess == rhs->shininess;
+}
 
-				unsigned char t = textureData[top];
-				textureData[top] = textureData[bot];
-				textureData[bot] = t;
+inline GLuint CSCI441_INTERNAL::getModelTextureSampler() {
+	// every diffuse map is mipmapped and tiles
+	return CSCI441::TextureRegistry::getSampler( GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT );
+}
 
-			}
-		}
-	}
+inline bool& CSCI441_INTERNAL::modelTexturePacking() {
+	// whether models loaded from now on pack their diffuse maps
+	static bool packTextures = false;
+	return packTextures;
 }
 
 #endif // __CSCI441_MODELLOADER_3_HPP__
@@ -1,6 +1,9 @@
 #ifndef __CSCI441_MODELMATERIAL_H__
 #define __CSCI441_MODELMATERIAL_H__
 
+#include <string>
+#include <vector>
+
 namespace CSCI441_INTERNAL {
 
   struct ModelMaterial {
@@ -30,6 +33,24 @@ namespace CSCI441_INTERNAL {
       }
   };
 
+  // a run of indices drawn with one material's uniforms and one glDrawElements
+  struct ModelDrawBatch {
+      ModelMaterial *material;
+      unsigned int start;
+      unsigned int count;
+  };
+
+  // a diffuse map held until the model's texture coordinates are known and it can be packed,
+  // decoded along with the model's other maps once the model is read
+  struct ModelPendingTexture {
+      std::string colorFile;
+      std::string maskFile;
+      std::vector< unsigned char > pixels;
+      int width;
+      int height;
+      int channels;
+  };
+
   enum MODEL_TYPE {OBJ, OFF, PLY, STL};
 }
 
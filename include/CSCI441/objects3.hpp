@@ -8,10 +8,16 @@
 	*
 	*	These functions draw solid (or wireframe) 3D closed OpenGL
 	*	objects.  All objects are constructed using triangles that
-	*	have normals and texture coordinates properly set.
+	*	have normals and texture coordinates properly set.  Wireframe
+	*	objects draw only the edges of the underlying quad grid.
+	*
+	*	Solid objects always set glPolygonMode() to GL_FILL before they
+	*	draw, so they fill even after the caller switched to GL_LINE.
+	*	Wireframe objects draw GL_LINES and leave the polygon mode alone.
 	*
 	*	@warning NOTE: This header file will only work with OpenGL 3.0+
 	*	@warning NOTE: This header file depends upon GLEW
+	*	@warning NOTE: This header file depends upon glm
   */
 
 #ifdef __CSCI441_OBJECTS_HPP__
@@ -23,12 +29,16 @@
 
 #include <GL/glew.h>
 
+#include <glm/glm.hpp>
+
 #include <assert.h>   					// for assert()
 #include <math.h>								// for cos(), sin()
+#include <string.h>							// for memcmp()
 
 #include <CSCI441/teapot3.hpp> 	// for teapot()
 
 #include <map>									// for map
+#include <vector>								// for vector
 
 #ifndef M_PI
 #define M_PI 3.14159
@@ -42,7 +52,9 @@
 namespace CSCI441 {
 		/**	@brief Sets the attribute locations for vertex positions, normals, and texture coordinates
 			*
-			*	Needs to be called after a shader program is being used and before drawing geometry
+			*	Needs to be called after a shader program is being used and before drawing geometry.
+			*	Each shape keeps one VAO per set of locations, so switching between shaders does
+			*	not respecify attribute pointers every draw.  A location of -1 is left disabled.
 			*
 			* @param GLint positionLocation	- location of the vertex position attribute
 			* @param GLint normalLocation		- location of the vertex normal attribute
@@ -227,19 +239,23 @@ namespace CSCI441 {
 			*	Oriented with spout and handle running along X-axis, cap and bottom along Y-axis.  Origin is at the
 			*	center of the teapot
 			*
-			*	@param GLdouble size	- scale of the teapot
+			*	@param GLdouble size				- scale of the teapot
+			*	@param GLint resolution		- number of samples along each side of every Bezier patch
 			*	@pre size must be greater than zero
+			*	@pre resolution must be greater than one
 			*/
-		void drawSolidTeapot( GLdouble size );
+		void drawSolidTeapot( GLdouble size, GLint resolution = 10 );
 		/** @brief Draws a wireframe teapot
 		  *
 			*	Oriented with spout and handle running along X-axis, cap and bottom along Y-axis.  Origin is at the
 			*	center of the teapot
 			*
-			*	@param GLdouble size	- scale of the teapot
+			*	@param GLdouble size				- scale of the teapot
+			*	@param GLint resolution		- number of samples along each side of every Bezier patch
 			*	@pre size must be greater than zero
+			*	@pre resolution must be greater than one
 			*/
-		void drawWireTeapot( GLdouble size );
+		void drawWireTeapot( GLdouble size, GLint resolution = 10 );
 
 		/** @brief Draws a solid torus
 		  *
@@ -269,6 +285,77 @@ namespace CSCI441 {
 			* @pre rings must be greater than two
 			*/
 		void drawWireTorus( GLdouble innerRadius, GLdouble outerRadius, GLint sides, GLint rings );
+
+		/**	@brief Sets the camera used by the LOD draw functions to pick a tessellation
+			*
+			*	Needs to be called once per frame, after the view and projection matrices are known
+			*	and before any of the *LOD draw functions.  Until it is called the LOD draw functions
+			*	use 16 slices.
+			*
+			* @param glm::mat4 viewMtx					- current view matrix
+			* @param glm::mat4 projMtx					- current projection matrix
+			* @param GLint viewportHeight			- height of the current viewport in pixels
+			* @param GLfloat pixelsPerSegment	- desired on screen length of each silhouette segment
+			* @pre viewportHeight must be greater than zero
+			* @pre pixelsPerSegment must be greater than zero
+			*/
+		void setLevelOfDetailView( glm::mat4 viewMtx, glm::mat4 projMtx, GLint viewportHeight, GLfloat pixelsPerSegment = 8.0f );
+
+		/**	@brief Draws a solid sphere tessellated by its size on screen
+			*
+			*	Picks 8, 16, 32, or 64 slices (and half as many stacks) from the projected radius.  When
+			*	lodLevel is given, it holds the level used last time this object was drawn and the level
+			*	only changes once the size moves past the threshold by a margin, so objects near a
+			*	threshold do not pop back and forth.  Initialize it to -1.
+			*
+			* @param GLdouble radius		- radius of the sphere
+			* @param glm::mat4 modelMtx	- model matrix the sphere will be drawn with
+			* @param GLint* lodLevel		- optional per object level, updated with the level drawn
+			* @pre radius must be greater than zero
+			*/
+		void drawSolidSphereLOD( GLdouble radius, glm::mat4 modelMtx, GLint *lodLevel = NULL );
+		/**	@brief Draws a solid cone tessellated by its size on screen
+			*
+			* @param GLdouble base			- radius of the base of the cone
+			* @param GLdouble height		- height of the cone from the base to the tip
+			* @param glm::mat4 modelMtx	- model matrix the cone will be drawn with
+			* @param GLint* lodLevel		- optional per object level, see drawSolidSphereLOD()
+			* @pre base must be greater than zero
+			* @pre height must be greater than zero
+			*/
+		void drawSolidConeLOD( GLdouble base, GLdouble height, glm::mat4 modelMtx, GLint *lodLevel = NULL );
+		/**	@brief Draws a solid open ended cylinder tessellated by its size on screen
+			*
+			* @param GLdouble base			- radius of the base of the cylinder
+			* @param GLdouble top				- radius of the top of the cylinder
+			* @param GLdouble height		- height of the cylinder from the base to the top
+			* @param glm::mat4 modelMtx	- model matrix the cylinder will be drawn with
+			* @param GLint* lodLevel		- optional per object level, see drawSolidSphereLOD()
+			* @pre either: (1) base is greater than zero and top is greater than or equal to zero or (2) base is greater than or equal to zero and top is greater than zero
+			* @pre height must be greater than zero
+			*/
+		void drawSolidCylinderLOD( GLdouble base, GLdouble top, GLdouble height, glm::mat4 modelMtx, GLint *lodLevel = NULL );
+		/**	@brief Draws a solid disk tessellated by its size on screen
+			*
+			* @param GLdouble inner			- equivalent to the width of the disk
+			* @param GLdouble outer			- radius from the center of the disk to the center of the ring
+			* @param glm::mat4 modelMtx	- model matrix the disk will be drawn with
+			* @param GLint* lodLevel		- optional per object level, see drawSolidSphereLOD()
+			* @pre inner must be greater than or equal to zero
+			* @pre outer must be greater than zero
+			* @pre outer must be greater than inner
+			*/
+		void drawSolidDiskLOD( GLdouble inner, GLdouble outer, glm::mat4 modelMtx, GLint *lodLevel = NULL );
+		/**	@brief Draws a solid torus tessellated by its size on screen
+			*
+			* @param innerRadius 				- equivalent to the width of the torus ring
+			* @param outerRadius				- radius from the center of the torus to the center of the ring
+			* @param glm::mat4 modelMtx	- model matrix the torus will be drawn with
+			* @param GLint* lodLevel		- optional per object level, see drawSolidSphereLOD()
+			* @pre innerRadius must be greater than zero
+			* @pre outerRadius must be greater than zero
+			*/
+		void drawSolidTorusLOD( GLdouble innerRadius, GLdouble outerRadius, glm::mat4 modelMtx, GLint *lodLevel = NULL );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -285,75 +372,109 @@ namespace CSCI441_INTERNAL {
 	void drawSphere( GLdouble radius, GLint stacks, GLint slices, GLenum renderMode );
 	void drawTorus( GLdouble innerRadius, GLdouble outerRadius, GLint sides, GLint rings, GLenum renderMode );
 
-	static GLint _positionLocation = -1;
-	static GLint _normalLocation = -1;
-	static GLint _texCoordLocation = -1;
+	// every primitive VBO is laid out as [ positions | normals | texCoords ] so the
+	// attribute pointers only depend on the VBO, its vertex count, and the locations
+	struct AttributeBindingData {
+		GLuint vbod;
+		GLint p, n, t;
+		bool operator<( const AttributeBindingData rhs ) const {
+			if( vbod != rhs.vbod ) return vbod < rhs.vbod;
+			if( p != rhs.p ) return p < rhs.p;
+			if( n != rhs.n ) return n < rhs.n;
+			return t < rhs.t;
+		}
+	};
+	// each VBO has exactly one edge IBO, so the VAO also keeps that element binding
+	void bindAttributeVAO( GLuint vbod, unsigned long int numVertices, GLuint edgeIbod );
+
+	// wireframes are drawn as GL_LINES through an index buffer holding only the
+	// unique edges of the quad grid, so no triangle diagonals or polygon mode changes
+	GLuint generateEdgeIBO( const std::vector<GLuint> &edgeIndices );
+	void drawEdges( GLuint ibod );
+
+	// pre-built slice counts the LOD draws choose between, and how far past a
+	// threshold the projected size must move before an object changes level
+	static const GLint LOD_SEGMENTS[] = { 8, 16, 32, 64 };
+	static const GLint NUM_LOD_LEVELS = sizeof(LOD_SEGMENTS) / sizeof(LOD_SEGMENTS[0]);
+	static const GLfloat LOD_HYSTERESIS = 0.15f;
+
+	// the camera set by setLevelOfDetailView(), one copy shared by every translation unit
+	struct LevelOfDetailView {
+		glm::mat4 viewMtx, projMtx;
+		GLint viewportHeight;
+		GLfloat pixelsPerSegment;
+		LevelOfDetailView();
+	};
+	LevelOfDetailView& getLevelOfDetailView();
+
+	GLint levelForPixelRadius( GLfloat pixelRadius );
+	GLint selectLevelOfDetail( glm::mat4 modelMtx, glm::vec3 center, GLdouble boundingRadius, GLdouble featureRadius, GLint *lodLevel );
 
-	void generateCubeVAO( GLdouble sideLength );
-	static std::map< GLdouble, GLuint > _cubeVAO;
-	static std::map< GLdouble, GLuint > _cubeVBO;
+	void generateCubeVBO( GLdouble sideLength );
 
 	struct CylinderData {
 		GLdouble b, t, h;
 		GLint st, sl;
 		bool operator<( const CylinderData rhs ) const {
-			bool result = b < rhs.b;
-			if( !result ) result = t < rhs.t;
-			if( !result ) result = h < rhs.h;
-			if( !result ) result = st < rhs.st;
-			if( !result ) result = sl < rhs.sl;
-			return result;
+			if( b != rhs.b ) return b < rhs.b;
+			if( t != rhs.t ) return t < rhs.t;
+			if( h != rhs.h ) return h < rhs.h;
+			if( st != rhs.st ) return st < rhs.st;
+			return sl < rhs.sl;
 		}
 	};
-	void generateCylinderVAO( CylinderData cylData );
-	static std::map< CylinderData, GLuint > _cylinderVAO;
-	static std::map< CylinderData, GLuint > _cylinderVBO;
+	void generateCylinderVBO( CylinderData cylData );
 
 	struct DiskData {
 		GLdouble i, o, st, sw;
 		GLint sl, r;
 		bool operator<( const DiskData rhs ) const {
-			bool result = i < rhs.i;
-			if( !result ) result = o < rhs.o;
-			if( !result ) result = sl < rhs.sl;
-			if( !result ) result = r < rhs.r;
-			if( !result ) result = st < rhs.st;
-			if( !result ) result = sw < rhs.sw;
-			return result;
+			if( i != rhs.i ) return i < rhs.i;
+			if( o != rhs.o ) return o < rhs.o;
+			if( sl != rhs.sl ) return sl < rhs.sl;
+			if( r != rhs.r ) return r < rhs.r;
+			if( st != rhs.st ) return st < rhs.st;
+			return sw < rhs.sw;
 		}
 	};
-	void generateDiskVAO( DiskData diskData );
-	static std::map< DiskData, GLuint > _diskVAO;
-	static std::map< DiskData, GLuint > _diskVBO;
+	void generateDiskVBO( DiskData diskData );
 
 	struct SphereData {
 		GLdouble r;
 		GLint st, sl;
 		bool operator<( const SphereData rhs ) const {
-			bool result = r < rhs.r;
-			if( !result ) result = st < rhs.st;
-			if( !result ) result = sl < rhs.sl;
-			return result;
+			if( r != rhs.r ) return r < rhs.r;
+			if( st != rhs.st ) return st < rhs.st;
+			return sl < rhs.sl;
 		}
 	};
-	void generateSphereVAO( SphereData sphereData );
-	static std::map< SphereData, GLuint > _sphereVAO;
-	static std::map< SphereData, GLuint > _sphereVBO;
+	void generateSphereVBO( SphereData sphereData );
 
 	struct TorusData {
 		GLdouble i, o;
 		GLint s, r;
 		bool operator<( const TorusData rhs ) const {
-			bool result = i < rhs.i;
-			if( !result ) result = o < rhs.o;
-			if( !result ) result = s < rhs.s;
-			if( !result ) result = r < rhs.r;
-			return result;
+			if( i != rhs.i ) return i < rhs.i;
+			if( o != rhs.o ) return o < rhs.o;
+			if( s != rhs.s ) return s < rhs.s;
+			return r < rhs.r;
 		}
 	};
-	void generateTorusVAO( TorusData torusData );
-	static std::map< TorusData, GLuint > _torusVAO;
-	static std::map< TorusData, GLuint > _torusVBO;
+	void generateTorusVBO( TorusData torusData );
+
+	// the attribute locations and every primitive cache, one copy shared by every translation unit
+	struct PrimitiveState {
+		GLint positionLocation, normalLocation, texCoordLocation;
+		std::map< AttributeBindingData, GLuint > attributeVAO;
+		std::map< GLuint, GLsizei > edgeIndexCount;
+		std::map< GLdouble, GLuint > cubeVBO, cubeEdgeIBO;
+		std::map< CylinderData, GLuint > cylinderVBO, cylinderEdgeIBO;
+		std::map< DiskData, GLuint > diskVBO, diskEdgeIBO;
+		std::map< SphereData, GLuint > sphereVBO, sphereEdgeIBO;
+		std::map< TorusData, GLuint > torusVBO, torusEdgeIBO;
+		PrimitiveState();
+	};
+	PrimitiveState& getPrimitiveState();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -361,9 +482,21 @@ namespace CSCI441_INTERNAL {
 // Outward facing function implementations
 
 inline void CSCI441::setVertexAttributeLocations( GLint positionLocation, GLint normalLocation, GLint texCoordLocation ) {
-	CSCI441_INTERNAL::_positionLocation = positionLocation;
-	CSCI441_INTERNAL::_normalLocation = normalLocation;
-	CSCI441_INTERNAL::_texCoordLocation = texCoordLocation;
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
+	state.positionLocation = positionLocation;
+	state.normalLocation = normalLocation;
+	state.texCoordLocation = texCoordLocation;
+}
+
+inline void CSCI441::setLevelOfDetailView( glm::mat4 viewMtx, glm::mat4 projMtx, GLint viewportHeight, GLfloat pixelsPerSegment ) {
+	assert( viewportHeight > 0 );
+	assert( pixelsPerSegment > 0.0f );
+
+	CSCI441_INTERNAL::LevelOfDetailView &lodView = CSCI441_INTERNAL::getLevelOfDetailView();
+	lodView.viewMtx = viewMtx;
+	lodView.projMtx = projMtx;
+	lodView.viewportHeight = viewportHeight;
+	lodView.pixelsPerSegment = pixelsPerSegment;
 }
 
 inline void CSCI441::drawSolidCone( GLdouble base, GLdouble height, GLint stacks, GLint slices ) {
@@ -372,6 +505,7 @@ inline void CSCI441::drawSolidCone( GLdouble base, GLdouble height, GLint stacks
 	assert( stacks > 0 );
 	assert( slices > 2 );
 
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 	CSCI441_INTERNAL::drawCylinder( base, 0.0f, height, stacks, slices, GL_FILL );
 }
 
@@ -387,6 +521,7 @@ inline void CSCI441::drawWireCone( GLdouble base, GLdouble height, GLint stacks,
 inline void CSCI441::drawSolidCube( GLdouble sideLength ) {
   assert( sideLength > 0.0f );
 
+  glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
   CSCI441_INTERNAL::drawCube( sideLength, GL_FILL );
 }
 
@@ -402,6 +537,7 @@ inline void CSCI441::drawSolidCylinder( GLdouble base, GLdouble top, GLdouble he
 	assert( stacks > 0 );
 	assert( slices > 2 );
 
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 	CSCI441_INTERNAL::drawCylinder( base, top, height, stacks, slices, GL_FILL );
 }
 
@@ -421,6 +557,7 @@ inline void CSCI441::drawSolidDisk( GLdouble inner, GLdouble outer, GLint slices
 	assert( slices > 2 );
 	assert( rings > 0 );
 
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 	CSCI441_INTERNAL::drawPartialDisk( inner, outer, slices, rings, 0, 2*M_PI, GL_FILL );
 }
 
@@ -443,6 +580,7 @@ inline void CSCI441::drawSolidPartialDisk( GLdouble inner, GLdouble outer, GLint
 	assert( start >= 0.0f && start <= 360.0f );
 	assert( sweep >= 0.0f && sweep <= 360.0f );
 
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 	CSCI441_INTERNAL::drawPartialDisk( inner, outer, slices, rings, start * M_PI / 180.0f, sweep * M_PI / 180.0f, GL_FILL );
 }
 
@@ -463,6 +601,7 @@ inline void CSCI441::drawSolidSphere( GLdouble radius, GLint stacks, GLint slice
 	assert( stacks > 1 );
 	assert( slices > 2 );
 
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 	CSCI441_INTERNAL::drawSphere( radius, stacks, slices, GL_FILL );
 }
 
@@ -474,18 +613,21 @@ inline void CSCI441::drawWireSphere( GLdouble radius, GLint stacks, GLint slices
 	CSCI441_INTERNAL::drawSphere( radius, stacks, slices, GL_LINE );
 }
 
-inline void CSCI441::drawSolidTeapot( GLdouble size ) {
+inline void CSCI441::drawSolidTeapot( GLdouble size, GLint resolution ) {
 	assert( size > 0.0f );
+	assert( resolution > 1 );
 
-	CSCI441_INTERNAL::teapot( size, CSCI441_INTERNAL::_positionLocation, CSCI441_INTERNAL::_normalLocation );
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	CSCI441_INTERNAL::teapot( size, state.positionLocation, state.normalLocation, state.texCoordLocation, GL_FILL, resolution );
 }
 
-inline void CSCI441::drawWireTeapot( GLdouble size ) {
+inline void CSCI441::drawWireTeapot( GLdouble size, GLint resolution ) {
 	assert( size > 0.0f );
+	assert( resolution > 1 );
 
-	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
-	CSCI441_INTERNAL::teapot( size, CSCI441_INTERNAL::_positionLocation, CSCI441_INTERNAL::_normalLocation );
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
+	CSCI441_INTERNAL::teapot( size, state.positionLocation, state.normalLocation, state.texCoordLocation, GL_LINE, resolution );
 }
 
 inline void CSCI441::drawSolidTorus( GLdouble innerRadius, GLdouble outerRadius, GLint sides, GLint rings ) {
@@ -494,6 +636,7 @@ inline void CSCI441::drawSolidTorus( GLdouble innerRadius, GLdouble outerRadius,
 	assert( sides > 2 );
 	assert( rings > 2 );
 
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 	CSCI441_INTERNAL::drawTorus( innerRadius, outerRadius, sides, rings, GL_FILL );
 }
 
@@ -506,90 +649,236 @@ inline void CSCI441::drawWireTorus( GLdouble innerRadius, GLdouble outerRadius,
 	CSCI441_INTERNAL::drawTorus( innerRadius, outerRadius, sides, rings, GL_LINE );
 }
 
+inline void CSCI441::drawSolidSphereLOD( GLdouble radius, glm::mat4 modelMtx, GLint *lodLevel ) {
+	assert( radius > 0.0f );
+
+	GLint slices = CSCI441_INTERNAL::LOD_SEGMENTS[ CSCI441_INTERNAL::selectLevelOfDetail( modelMtx, glm::vec3( 0.0f ), radius, radius, lodLevel ) ];
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	CSCI441_INTERNAL::drawSphere( radius, slices / 2, slices, GL_FILL );
+}
+
+inline void CSCI441::drawSolidConeLOD( GLdouble base, GLdouble height, glm::mat4 modelMtx, GLint *lodLevel ) {
+	assert( base > 0.0f );
+	assert( height > 0.0f );
+
+	CSCI441::drawSolidCylinderLOD( base, 0.0f, height, modelMtx, lodLevel );
+}
+
+inline void CSCI441::drawSolidCylinderLOD( GLdouble base, GLdouble top, GLdouble height, glm::mat4 modelMtx, GLint *lodLevel ) {
+	assert( (base >= 0.0f && top > 0.0f) || (base > 0.0f && top >= 0.0f) );
+	assert( height > 0.0f );
+
+	// normals do not vary along the height, so a single stack shades the same as many
+	GLdouble radius = base > top ? base : top;
+	GLint slices = CSCI441_INTERNAL::LOD_SEGMENTS[ CSCI441_INTERNAL::selectLevelOfDetail( modelMtx, glm::vec3( 0.0f, height / 2.0f, 0.0f ), sqrt( radius*radius + height*height/4.0f ), radius, lodLevel ) ];
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	CSCI441_INTERNAL::drawCylinder( base, top, height, 1, slices, GL_FILL );
+}
+
+inline void CSCI441::drawSolidDiskLOD( GLdouble inner, GLdouble outer, glm::mat4 modelMtx, GLint *lodLevel ) {
+	assert( inner >= 0.0f );
+	assert( outer > 0.0f );
+	assert( outer > inner );
+
+	GLint slices = CSCI441_INTERNAL::LOD_SEGMENTS[ CSCI441_INTERNAL::selectLevelOfDetail( modelMtx, glm::vec3( 0.0f ), outer, outer, lodLevel ) ];
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	CSCI441_INTERNAL::drawPartialDisk( inner, outer, slices, 1, 0, 2*M_PI, GL_FILL );
+}
+
+inline void CSCI441::drawSolidTorusLOD( GLdouble innerRadius, GLdouble outerRadius, glm::mat4 modelMtx, GLint *lodLevel ) {
+	assert( innerRadius > 0.0f );
+	assert( outerRadius > 0.0f );
+
+	GLint rings = CSCI441_INTERNAL::LOD_SEGMENTS[ CSCI441_INTERNAL::selectLevelOfDetail( modelMtx, glm::vec3( 0.0f ), innerRadius + outerRadius, innerRadius + outerRadius, lodLevel ) ];
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	CSCI441_INTERNAL::drawTorus( innerRadius, outerRadius, rings / 2, rings, GL_FILL );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////
 // Internal function rendering implementations
 
+inline CSCI441_INTERNAL::LevelOfDetailView::LevelOfDetailView() : viewMtx( 1.0f ), projMtx( 1.0f ), viewportHeight( 0 ), pixelsPerSegment( 8.0f ) {
+}
+
+inline CSCI441_INTERNAL::PrimitiveState::PrimitiveState() : positionLocation( -1 ), normalLocation( -1 ), texCoordLocation( -1 ) {
+}
+
+inline CSCI441_INTERNAL::PrimitiveState& CSCI441_INTERNAL::getPrimitiveState() {
+	// like the LOD view, a static local of an inline function is one object program-wide
+	static PrimitiveState state;
+	return state;
+}
+
+inline CSCI441_INTERNAL::LevelOfDetailView& CSCI441_INTERNAL::getLevelOfDetailView() {
+	// a static local of an inline function is the same object in every translation unit
+	static LevelOfDetailView lodView;
+	return lodView;
+}
+
+inline GLint CSCI441_INTERNAL::levelForPixelRadius( GLfloat pixelRadius ) {
+	// coarsest level whose silhouette segments are no longer than the requested length
+	const GLfloat pixelsPerSegment = getLevelOfDetailView().pixelsPerSegment;
+	for( GLint level = 0; level < NUM_LOD_LEVELS - 1; level++ ) {
+		if( 2.0f * M_PI * pixelRadius / LOD_SEGMENTS[level] <= pixelsPerSegment ) {
+			return level;
+		}
+	}
+	return NUM_LOD_LEVELS - 1;
+}
+
+inline GLint CSCI441_INTERNAL::selectLevelOfDetail( glm::mat4 modelMtx, glm::vec3 center, GLdouble boundingRadius, GLdouble featureRadius, GLint *lodLevel ) {
+	GLint level = 1;
+
+	const LevelOfDetailView &lodView = getLevelOfDetailView();
+	if( lodView.viewportHeight > 0 ) {
+		glm::mat4 modelViewMtx = lodView.viewMtx * modelMtx;
+		glm::vec4 viewCenter = modelViewMtx * glm::vec4( center, 1.0f );
+
+		GLfloat scale = glm::length( glm::vec3( modelViewMtx[0] ) );
+		scale = glm::max( scale, glm::length( glm::vec3( modelViewMtx[1] ) ) );
+		scale = glm::max( scale, glm::length( glm::vec3( modelViewMtx[2] ) ) );
+
+		// proj[1][1] maps a view space height at unit depth to NDC, which spans the viewport height twice
+		GLfloat pixelRadius = featureRadius * scale * lodView.projMtx[1][1] * lodView.viewportHeight / 2.0f;
+		if( lodView.projMtx[3][3] == 0.0f ) {
+			// perspective: measure at the nearest point of the bounding sphere.  objects
+			// entirely behind the camera get the coarsest level, ones around it the finest
+			GLfloat depth = -viewCenter.z - boundingRadius * scale;
+			if( depth > 0.0f ) {
+				pixelRadius /= depth;
+			} else {
+				pixelRadius = ( -viewCenter.z + boundingRadius * scale < 0.0f ) ? 0.0f : HUGE_VALF;
+			}
+		}
+
+		level = levelForPixelRadius( pixelRadius );
+
+		if( lodLevel != NULL && *lodLevel >= 0 && *lodLevel < NUM_LOD_LEVELS ) {
+			// only leave the previous level once the size is clearly past the threshold
+			GLint finer = levelForPixelRadius( pixelRadius / (1.0f + LOD_HYSTERESIS) );
+			GLint coarser = levelForPixelRadius( pixelRadius / (1.0f - LOD_HYSTERESIS) );
+			if( finer > *lodLevel ) {
+				level = finer;
+			} else if( coarser < *lodLevel ) {
+				level = coarser;
+			} else {
+				level = *lodLevel;
+			}
+		}
+	}
+
+	if( lodLevel != NULL ) {
+		*lodLevel = level;
+	}
+	return level;
+}
+
+inline void CSCI441_INTERNAL::bindAttributeVAO( GLuint vbod, unsigned long int numVertices, GLuint edgeIbod ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
+	AttributeBindingData bindingData = { vbod, state.positionLocation, state.normalLocation, state.texCoordLocation };
+
+	std::map< AttributeBindingData, GLuint >::iterator vaoIter = state.attributeVAO.find( bindingData );
+	if( vaoIter != state.attributeVAO.end() ) {
+		glBindVertexArray( vaoIter->second );
+		return;
+	}
+
+	// first time this VBO is drawn with this set of locations, bake the pointers into a new VAO
+	GLuint vaod;
+	glGenVertexArrays( 1, &vaod );
+	glBindVertexArray( vaod );
+	glBindBuffer( GL_ARRAY_BUFFER, vbod );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, edgeIbod );
+
+	if( state.positionLocation != -1 ) {
+		glEnableVertexAttribArray( state.positionLocation );
+		glVertexAttribPointer( state.positionLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)0 );
+	}
+	if( state.normalLocation != -1 ) {
+		glEnableVertexAttribArray( state.normalLocation );
+		glVertexAttribPointer( state.normalLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*numVertices*3) );
+	}
+	if( state.texCoordLocation != -1 ) {
+		glEnableVertexAttribArray( state.texCoordLocation );
+		glVertexAttribPointer( state.texCoordLocation, 2, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*numVertices*6) );
+	}
+
+	state.attributeVAO.insert( std::pair<AttributeBindingData, GLuint>( bindingData, vaod ) );
+}
+
+inline void CSCI441_INTERNAL::drawEdges( GLuint ibod ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
+	// the edge IBO was bound into the primitive's VAO when it was built, so wire draws change no buffer state
+	glDrawElements( GL_LINES, state.edgeIndexCount.find( ibod )->second, GL_UNSIGNED_INT, (void*)0 );
+}
+
 inline void CSCI441_INTERNAL::drawCube( GLdouble sideLength, GLenum renderMode ) {
-	if( CSCI441_INTERNAL::_cubeVAO.find( sideLength ) == CSCI441_INTERNAL::_cubeVAO.end() ) {
-		CSCI441_INTERNAL::generateCubeVAO( sideLength );
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
+	if( state.cubeVBO.find( sideLength ) == state.cubeVBO.end() ) {
+		CSCI441_INTERNAL::generateCubeVBO( sideLength );
 	}
 
-	glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-	glBindVertexArray( CSCI441_INTERNAL::_cubeVAO.find( sideLength )->second );
-	glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cubeVBO.find( sideLength )->second );
-	glEnableVertexAttribArray( _positionLocation );
-	glVertexAttribPointer( _positionLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)0 );
-	glEnableVertexAttribArray( _normalLocation );
-	glVertexAttribPointer( _normalLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*36*3) );
-	glEnableVertexAttribArray( _texCoordLocation );
-	glVertexAttribPointer( _texCoordLocation, 2, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*36*6) );
-	glDrawArrays( GL_TRIANGLES, 0, 36 );
+	CSCI441_INTERNAL::bindAttributeVAO( state.cubeVBO.find( sideLength )->second, 36, state.cubeEdgeIBO.find( sideLength )->second );
 
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+	if( renderMode == GL_LINE ) {
+		CSCI441_INTERNAL::drawEdges( state.cubeEdgeIBO.find( sideLength )->second );
+	} else {
+		glDrawArrays( GL_TRIANGLES, 0, 36 );
+	}
 }
 
 inline void CSCI441_INTERNAL::drawCylinder( GLdouble base, GLdouble top, GLdouble height, GLint stacks, GLint slices, GLenum renderMode ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	CylinderData cylData = { base, top, height, stacks, slices };
-	if( CSCI441_INTERNAL::_cylinderVAO.find( cylData ) == CSCI441_INTERNAL::_cylinderVAO.end() ) {
-		CSCI441_INTERNAL::generateCylinderVAO( cylData );
+	if( state.cylinderVBO.find( cylData ) == state.cylinderVBO.end() ) {
+		CSCI441_INTERNAL::generateCylinderVBO( cylData );
 	}
 
-	glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-	glBindVertexArray( CSCI441_INTERNAL::_cylinderVAO.find( cylData )->second );
-	glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cylinderVBO.find( cylData )->second );
-	glEnableVertexAttribArray( _positionLocation );
-	glVertexAttribPointer( _positionLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)0 );
-	glEnableVertexAttribArray( _normalLocation );
-	glVertexAttribPointer( _normalLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*stacks * (slices+1) * 2*3) );
-	glEnableVertexAttribArray( _texCoordLocation );
-	glVertexAttribPointer( _texCoordLocation, 2, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*stacks * (slices+1) * 2*6) );
+	CSCI441_INTERNAL::bindAttributeVAO( state.cylinderVBO.find( cylData )->second, stacks * (slices+1) * 2, state.cylinderEdgeIBO.find( cylData )->second );
+
+	if( renderMode == GL_LINE ) {
+		CSCI441_INTERNAL::drawEdges( state.cylinderEdgeIBO.find( cylData )->second );
+		return;
+	}
 
 	for( int stackNum = 0; stackNum < stacks; stackNum++ ) {
 		glDrawArrays( GL_TRIANGLE_STRIP, (slices+1)*2*stackNum, (slices+1)*2 );
 	}
-
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 }
 
 inline void CSCI441_INTERNAL::drawPartialDisk( GLdouble inner, GLdouble outer, GLint slices, GLint rings, GLdouble start, GLdouble sweep, GLenum renderMode ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	DiskData diskData = { inner, outer, start, sweep, slices, rings };
-	if( CSCI441_INTERNAL::_diskVAO.find( diskData ) == CSCI441_INTERNAL::_diskVAO.end() ) {
-		CSCI441_INTERNAL::generateDiskVAO( diskData );
+	if( state.diskVBO.find( diskData ) == state.diskVBO.end() ) {
+		CSCI441_INTERNAL::generateDiskVBO( diskData );
 	}
 
-	glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-	glBindVertexArray( CSCI441_INTERNAL::_diskVAO.find( diskData )->second );
-	glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_diskVBO.find( diskData )->second );
-	glEnableVertexAttribArray( _positionLocation );
-	glVertexAttribPointer( _positionLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)0 );
-	glEnableVertexAttribArray( _normalLocation );
-	glVertexAttribPointer( _normalLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*rings * (slices+1) * 2*3) );
-	glEnableVertexAttribArray( _texCoordLocation );
-	glVertexAttribPointer( _texCoordLocation, 2, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*rings * (slices+1) * 2*6) );
+	CSCI441_INTERNAL::bindAttributeVAO( state.diskVBO.find( diskData )->second, rings * (slices+1) * 2, state.diskEdgeIBO.find( diskData )->second );
+
+	if( renderMode == GL_LINE ) {
+		CSCI441_INTERNAL::drawEdges( state.diskEdgeIBO.find( diskData )->second );
+		return;
+	}
 
 	for( int ringNum = 0; ringNum < rings; ringNum++ ) {
 		glDrawArrays( GL_TRIANGLE_STRIP, (slices+1)*2*ringNum, (slices+1)*2 );
 	}
-
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 }
 
 inline void CSCI441_INTERNAL::drawSphere( GLdouble radius, GLint stacks, GLint slices, GLenum renderMode ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	SphereData sphereData = { radius, stacks, slices };
-	if( CSCI441_INTERNAL::_sphereVAO.find( sphereData ) == CSCI441_INTERNAL::_sphereVAO.end() ) {
-		CSCI441_INTERNAL::generateSphereVAO( sphereData );
+	if( state.sphereVBO.find( sphereData ) == state.sphereVBO.end() ) {
+		CSCI441_INTERNAL::generateSphereVBO( sphereData );
 	}
 
-	glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-	glBindVertexArray( CSCI441_INTERNAL::_sphereVAO.find( sphereData )->second );
-	glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_sphereVBO.find( sphereData )->second );
-	glEnableVertexAttribArray( _positionLocation );
-	glVertexAttribPointer( _positionLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)0 );
-	glEnableVertexAttribArray( _normalLocation );
-	glVertexAttribPointer( _normalLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*((slices + 2)*2 + ((stacks - 2)*(slices+1))*2) *3) );
-	glEnableVertexAttribArray( _texCoordLocation );
-	glVertexAttribPointer( _texCoordLocation, 2, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*((slices + 2)*2 + ((stacks - 2)*(slices+1))*2) *6) );
+	CSCI441_INTERNAL::bindAttributeVAO( state.sphereVBO.find( sphereData )->second, (slices + 2)*2 + (stacks - 2)*(slices+1)*2, state.sphereEdgeIBO.find( sphereData )->second );
+
+	if( renderMode == GL_LINE ) {
+		CSCI441_INTERNAL::drawEdges( state.sphereEdgeIBO.find( sphereData )->second );
+		return;
+	}
 
 	glDrawArrays( GL_TRIANGLE_FAN, 0, slices+2 );
 
@@ -598,38 +887,42 @@ inline void CSCI441_INTERNAL::drawSphere( GLdouble radius, GLint stacks, GLint s
 	}
 
 	glDrawArrays( GL_TRIANGLE_FAN, (slices+2) + (stacks-2)*(slices+1)*2, slices+2 );
-
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 }
 
 inline void CSCI441_INTERNAL::drawTorus( GLdouble innerRadius, GLdouble outerRadius, GLint sides, GLint rings, GLenum renderMode ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	TorusData torusData = { innerRadius, outerRadius, sides, rings };
-	if( CSCI441_INTERNAL::_torusVAO.find( torusData ) == CSCI441_INTERNAL::_torusVAO.end() ) {
-		CSCI441_INTERNAL::generateTorusVAO( torusData );
+	if( state.torusVBO.find( torusData ) == state.torusVBO.end() ) {
+		CSCI441_INTERNAL::generateTorusVBO( torusData );
 	}
 
-	glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-	glBindVertexArray( CSCI441_INTERNAL::_torusVAO.find( torusData )->second );
-	glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_torusVBO.find( torusData )->second );
-	glEnableVertexAttribArray( _positionLocation );
-	glVertexAttribPointer( _positionLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)0 );
-	glEnableVertexAttribArray( _normalLocation );
-	glVertexAttribPointer( _normalLocation, 3, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*(sides*4*rings)*3) );
-	glEnableVertexAttribArray( _texCoordLocation );
-	glVertexAttribPointer( _texCoordLocation, 2, GL_DOUBLE, GL_FALSE, 0, (void*)(sizeof(GLdouble)*(sides*4*rings)*6) );
+	CSCI441_INTERNAL::bindAttributeVAO( state.torusVBO.find( torusData )->second, sides*4*rings, state.torusEdgeIBO.find( torusData )->second );
+
+	if( renderMode == GL_LINE ) {
+		CSCI441_INTERNAL::drawEdges( state.torusEdgeIBO.find( torusData )->second );
+		return;
+	}
 
 	for( int ringNum = 0; ringNum < rings; ringNum++ ) {
 		glDrawArrays( GL_TRIANGLE_STRIP, ringNum*sides*4, sides*4 );
 	}
-
-	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 }
 
-inline void CSCI441_INTERNAL::generateCubeVAO( GLdouble sideLength ) {
-	GLuint vaod;
-	glGenVertexArrays( 1, &vaod );
-	glBindVertexArray( vaod );
+inline GLuint CSCI441_INTERNAL::generateEdgeIBO( const std::vector<GLuint> &edgeIndices ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
+	GLuint ibod;
+	glGenBuffers( 1, &ibod );
+	// upload through GL_ARRAY_BUFFER so whatever VAO is currently bound keeps its element binding
+	glBindBuffer( GL_ARRAY_BUFFER, ibod );
+	glBufferData( GL_ARRAY_BUFFER, sizeof(GLuint) * edgeIndices.size(), &edgeIndices[0], GL_STATIC_DRAW );
+
+	state.edgeIndexCount.insert( std::pair<GLuint, GLsizei>( ibod, (GLsizei)edgeIndices.size() ) );
 
+	return ibod;
+}
+
+inline void CSCI441_INTERNAL::generateCubeVBO( GLdouble sideLength ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	GLuint vbod;
 	glGenBuffers( 1, &vbod );
 	glBindBuffer( GL_ARRAY_BUFFER, vbod );
@@ -702,15 +995,41 @@ inline void CSCI441_INTERNAL::generateCubeVAO( GLdouble sideLength ) {
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * 36 * 3, sizeof(GLdouble) * 36 * 3, normals );
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * 36 * 6, sizeof(GLdouble) * 36 * 2, texCoords );
 
-	CSCI441_INTERNAL::_cubeVAO.insert( std::pair<GLdouble, GLuint>( sideLength, vaod ) );
-	CSCI441_INTERNAL::_cubeVBO.insert( std::pair<GLdouble, GLuint>( sideLength, vbod ) );
+	state.cubeVBO.insert( std::pair<GLdouble, GLuint>( sideLength, vbod ) );
+
+	// each face is two triangles sharing a diagonal; keep the four outer edges of every
+	// face and drop the ones already added by a neighboring face
+	std::vector<GLuint> edgeIndices;
+	for( GLuint face = 0; face < 6; face++ ) {
+		for( GLuint e = 0; e < 6; e++ ) {
+			GLuint a = face*6 + e, b = face*6 + (e % 3 == 2 ? e - 2 : e + 1);
+
+			bool isDiagonal = false;
+			for( GLuint f = 0; f < 6 && !isDiagonal; f++ ) {
+				GLuint c = face*6 + f, d = face*6 + (f % 3 == 2 ? f - 2 : f + 1);
+				if( c == a ) continue;
+				isDiagonal = ( !memcmp( vertices[a], vertices[c], sizeof(vertices[a]) ) && !memcmp( vertices[b], vertices[d], sizeof(vertices[b]) ) )
+									|| ( !memcmp( vertices[a], vertices[d], sizeof(vertices[a]) ) && !memcmp( vertices[b], vertices[c], sizeof(vertices[b]) ) );
+			}
+			if( isDiagonal ) continue;
+
+			bool isDuplicate = false;
+			for( size_t i = 0; i < edgeIndices.size() && !isDuplicate; i += 2 ) {
+				GLuint c = edgeIndices[i], d = edgeIndices[i+1];
+				isDuplicate = ( !memcmp( vertices[a], vertices[c], sizeof(vertices[a]) ) && !memcmp( vertices[b], vertices[d], sizeof(vertices[b]) ) )
+									 || ( !memcmp( vertices[a], vertices[d], sizeof(vertices[a]) ) && !memcmp( vertices[b], vertices[c], sizeof(vertices[b]) ) );
+			}
+			if( isDuplicate ) continue;
+
+			edgeIndices.push_back( a );
+			edgeIndices.push_back( b );
+		}
+	}
+	state.cubeEdgeIBO.insert( std::pair<GLdouble, GLuint>( sideLength, CSCI441_INTERNAL::generateEdgeIBO( edgeIndices ) ) );
 }
 
-inline void CSCI441_INTERNAL::generateCylinderVAO( CylinderData cylData ) {
-	GLuint vaod;
-	glGenVertexArrays( 1, &vaod );
-	glBindVertexArray( vaod );
-
+inline void CSCI441_INTERNAL::generateCylinderVBO( CylinderData cylData ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	GLuint vbod;
 	glGenBuffers( 1, &vbod );
 	glBindBuffer( GL_ARRAY_BUFFER, vbod );
@@ -764,15 +1083,35 @@ inline void CSCI441_INTERNAL::generateCylinderVAO( CylinderData cylData ) {
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 3, sizeof(GLdouble) * numVertices * 3, normals );
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 6, sizeof(GLdouble) * numVertices * 2, texCoords );
 
-	CSCI441_INTERNAL::_cylinderVAO.insert( std::pair<CylinderData, GLuint>( cylData, vaod ) );
-	CSCI441_INTERNAL::_cylinderVBO.insert( std::pair<CylinderData, GLuint>( cylData, vbod ) );
-}
+	state.cylinderVBO.insert( std::pair<CylinderData, GLuint>( cylData, vbod ) );
 
-inline void CSCI441_INTERNAL::generateDiskVAO( DiskData diskData ) {
-	GLuint vaod;
-	glGenVertexArrays( 1, &vaod );
-	glBindVertexArray( vaod );
+	// stack k is a strip of (bottom, top) pairs: slice s sits at base+2s and base+2s+1.
+	// the last slice repeats the first, so the seam needs no second vertical edge
+	std::vector<GLuint> edgeIndices;
+	for( GLuint stackNum = 0; stackNum < (GLuint)cylData.st; stackNum++ ) {
+		GLuint base = stackNum * (cylData.sl+1) * 2;
+		GLdouble botRadius = cylData.b*(cylData.st-stackNum)/cylData.st + cylData.t*stackNum/cylData.st;
+		GLdouble topRadius = cylData.b*(cylData.st-stackNum-1)/cylData.st + cylData.t*(stackNum+1)/cylData.st;
+
+		for( GLuint sliceNum = 0; sliceNum < (GLuint)cylData.sl; sliceNum++ ) {
+			edgeIndices.push_back( base + 2*sliceNum );
+			edgeIndices.push_back( base + 2*sliceNum + 1 );
+
+			if( botRadius > 0.0f ) {
+				edgeIndices.push_back( base + 2*sliceNum );
+				edgeIndices.push_back( base + 2*(sliceNum+1) );
+			}
+			if( stackNum == (GLuint)cylData.st-1 && topRadius > 0.0f ) {
+				edgeIndices.push_back( base + 2*sliceNum + 1 );
+				edgeIndices.push_back( base + 2*(sliceNum+1) + 1 );
+			}
+		}
+	}
+	state.cylinderEdgeIBO.insert( std::pair<CylinderData, GLuint>( cylData, CSCI441_INTERNAL::generateEdgeIBO( edgeIndices ) ) );
+}
 
+inline void CSCI441_INTERNAL::generateDiskVBO( DiskData diskData ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	GLuint vbod;
 	glGenBuffers( 1, &vbod );
 	glBindBuffer( GL_ARRAY_BUFFER, vbod );
@@ -827,15 +1166,38 @@ inline void CSCI441_INTERNAL::generateDiskVAO( DiskData diskData ) {
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 3, sizeof(GLdouble) * numVertices * 3, normals );
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 6, sizeof(GLdouble) * numVertices * 2, texCoords );
 
-	CSCI441_INTERNAL::_diskVAO.insert( std::pair<DiskData, GLuint>( diskData, vaod ) );
-	CSCI441_INTERNAL::_diskVBO.insert( std::pair<DiskData, GLuint>( diskData, vbod ) );
-}
+	state.diskVBO.insert( std::pair<DiskData, GLuint>( diskData, vbod ) );
 
-inline void CSCI441_INTERNAL::generateSphereVAO( SphereData sphereData ) {
-	GLuint vaod;
-	glGenVertexArrays( 1, &vaod );
-	glBindVertexArray( vaod );
+	// ring r is a strip of (inner, outer) pairs: slice s sits at base+2s and base+2s+1.
+	// a full disk repeats its first slice at the end, so skip that duplicate spoke
+	bool isClosed = diskData.sw >= 2.0 * M_PI - 0.0001;
+	std::vector<GLuint> edgeIndices;
+	for( GLuint ringNum = 0; ringNum < (GLuint)diskData.r; ringNum++ ) {
+		GLuint base = ringNum * (diskData.sl+1) * 2;
+		double currRadius = diskData.i + ringNum*ringStep;
+
+		for( GLuint sliceNum = 0; sliceNum <= (GLuint)diskData.sl; sliceNum++ ) {
+			if( sliceNum < (GLuint)diskData.sl || !isClosed ) {
+				edgeIndices.push_back( base + 2*sliceNum );
+				edgeIndices.push_back( base + 2*sliceNum + 1 );
+			}
+			if( sliceNum == (GLuint)diskData.sl ) break;
+
+			if( currRadius > 0.0f ) {
+				edgeIndices.push_back( base + 2*sliceNum );
+				edgeIndices.push_back( base + 2*(sliceNum+1) );
+			}
+			if( ringNum == (GLuint)diskData.r-1 ) {
+				edgeIndices.push_back( base + 2*sliceNum + 1 );
+				edgeIndices.push_back( base + 2*(sliceNum+1) + 1 );
+			}
+		}
+	}
+	state.diskEdgeIBO.insert( std::pair<DiskData, GLuint>( diskData, CSCI441_INTERNAL::generateEdgeIBO( edgeIndices ) ) );
+}
 
+inline void CSCI441_INTERNAL::generateSphereVBO( SphereData sphereData ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	GLuint vbod;
 	glGenBuffers( 1, &vbod );
 	glBindBuffer( GL_ARRAY_BUFFER, vbod );
@@ -960,15 +1322,40 @@ inline void CSCI441_INTERNAL::generateSphereVAO( SphereData sphereData ) {
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 3, sizeof(GLdouble) * numVertices * 3, normals );
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 6, sizeof(GLdouble) * numVertices * 2, texCoords );
 
-	CSCI441_INTERNAL::_sphereVAO.insert( std::pair<SphereData, GLuint>( sphereData, vaod ) );
-	CSCI441_INTERNAL::_sphereVBO.insert( std::pair<SphereData, GLuint>( sphereData, vbod ) );
-}
+	state.sphereVBO.insert( std::pair<SphereData, GLuint>( sphereData, vbod ) );
 
-inline void CSCI441_INTERNAL::generateTorusVAO( TorusData torusData ) {
-	GLuint vaod;
-	glGenVertexArrays( 1, &vaod );
-	glBindVertexArray( vaod );
+	// top fan is the pole followed by its ring, each middle stack is a strip of
+	// (lower, upper) pairs, and the bottom fan is the pole followed by its ring.
+	// the bottom fan's ring is already covered by the lowest strip (or the top fan)
+	GLuint stripStart = sphereData.sl + 2;
+	GLuint bottomPole = stripStart + (sphereData.st-2)*(sphereData.sl+1)*2;
+	std::vector<GLuint> edgeIndices;
+	for( GLuint sliceNum = 0; sliceNum < (GLuint)sphereData.sl; sliceNum++ ) {
+		edgeIndices.push_back( 0 );
+		edgeIndices.push_back( 1 + sliceNum );
+
+		edgeIndices.push_back( 1 + sliceNum );
+		edgeIndices.push_back( 2 + sliceNum );
 
+		edgeIndices.push_back( bottomPole );
+		edgeIndices.push_back( bottomPole + 1 + sliceNum );
+	}
+	for( GLuint stackNum = 1; stackNum < (GLuint)sphereData.st-1; stackNum++ ) {
+		GLuint base = stripStart + (stackNum-1)*(sphereData.sl+1)*2;
+
+		for( GLuint sliceNum = 0; sliceNum < (GLuint)sphereData.sl; sliceNum++ ) {
+			edgeIndices.push_back( base + 2*sliceNum );
+			edgeIndices.push_back( base + 2*sliceNum + 1 );
+
+			edgeIndices.push_back( base + 2*sliceNum );
+			edgeIndices.push_back( base + 2*(sliceNum+1) );
+		}
+	}
+	state.sphereEdgeIBO.insert( std::pair<SphereData, GLuint>( sphereData, CSCI441_INTERNAL::generateEdgeIBO( edgeIndices ) ) );
+}
+
+inline void CSCI441_INTERNAL::generateTorusVBO( TorusData torusData ) {
+	CSCI441_INTERNAL::PrimitiveState &state = CSCI441_INTERNAL::getPrimitiveState();
 	GLuint vbod;
 	glGenBuffers( 1, &vbod );
 	glBindBuffer( GL_ARRAY_BUFFER, vbod );
@@ -1051,8 +1438,19 @@ inline void CSCI441_INTERNAL::generateTorusVAO( TorusData torusData ) {
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 3, sizeof(GLdouble) * numVertices * 3, normals );
 	glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLdouble) * numVertices * 6, sizeof(GLdouble) * numVertices * 2, texCoords );
 
-	CSCI441_INTERNAL::_torusVAO.insert( std::pair<TorusData, GLuint>( torusData, vaod ) );
-	CSCI441_INTERNAL::_torusVBO.insert( std::pair<TorusData, GLuint>( torusData, vbod ) );
+	state.torusVBO.insert( std::pair<TorusData, GLuint>( torusData, vbod ) );
+
+	// every quad contributes the edge along its ring and the edge around its side;
+	// the other two edges belong to the neighboring quads
+	std::vector<GLuint> edgeIndices;
+	for( GLuint quad = 0; quad < (GLuint)(torusData.s * torusData.r); quad++ ) {
+		edgeIndices.push_back( quad*4 );
+		edgeIndices.push_back( quad*4 + 1 );
+
+		edgeIndices.push_back( quad*4 );
+		edgeIndices.push_back( quad*4 + 2 );
+	}
+	state.torusEdgeIBO.insert( std::pair<TorusData, GLuint>( torusData, CSCI441_INTERNAL::generateEdgeIBO( edgeIndices ) ) );
 }
 
 #endif // __CSCI441_OBJECTS_3_HPP__
@@ -0,0 +1,468 @@
+/** @file occlusionCuller.hpp
+  * @brief Software hierarchical depth buffer for occlusion culling on the CPU
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	A handful of large occluders, such as the nearest buildings or simplified
+	*	versions of big models, are rasterized into a small depth buffer entirely
+	*	on the CPU.  A pyramid is then built over the buffer where every texel
+	*	holds the farthest depth of the four below it, so whether a bounding box
+	*	is hidden is answered by reading a few texels at the level where the box
+	*	covers at most four by four of them.
+	*
+	*	The buffer stores 1/w, which is linear across a triangle on screen and
+	*	keeps its precision far from the camera; larger values are nearer and the
+	*	buffer clears to zero.  Triangles are clipped against the near plane and
+	*	binned into square tiles; each tile is filled eight pixels at a time in
+	*	plain arrays so compilers vectorize them, and large sets of occluders are
+	*	spread across threads by tile.  Nothing here touches OpenGL, so culling
+	*	can run before the frame's draw calls while the GPU is still busy with the
+	*	previous frame, or without any window at all.
+	*
+	*	Usage each frame:
+	*
+	*		culler.begin( projectionMatrix * viewMatrix );
+	*		culler.addOccluder( boxMin, boxMax );	// as many as wanted
+	*		culler.end();
+	*		if( culler.isVisible( objectMin, objectMax ) ) ...
+	*
+	*	Only pixels whose centers an occluder covers are written, so a box seen
+	*	through a gap narrower than a pixel of the culler may be reported hidden.
+	*
+	*	@warning NOTE: This header file depends upon glm
+	*	@warning NOTE: Large sets of occluders are rasterized across std::thread workers.  Define
+	*	CSCI441_NO_THREADS before including this file on toolchains without std::thread support
+  */
+
+#ifndef __CSCI441_OCCLUSIONCULLER_HPP__
+#define __CSCI441_OCCLUSIONCULLER_HPP__
+
+#include <glm/glm.hpp>
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @class OcclusionCuller
+		* @brief Rasterizes occluders into a low resolution hierarchical depth buffer and tests boxes against it
+		*/
+	class OcclusionCuller {
+	public:
+		/** @brief Creates the depth buffer
+			* @param unsigned int width		- pixels across, rounded up to whole tiles
+			* @param unsigned int height	- pixels down, rounded up to whole tiles
+			*/
+		OcclusionCuller( unsigned int width = 320, unsigned int height = 192 );
+
+		/** @brief Clears the depth buffer and starts collecting occluders for a camera
+			* @param glm::mat4 viewProjectionMatrix	- projection matrix times view matrix of the camera
+			*/
+		void begin( const glm::mat4 &viewProjectionMatrix );
+		/** @brief Adds a solid box as an occluder; only its faces toward the camera are rasterized
+			* @param glm::vec3 boxMin	- minimum corner of the box in world space
+			* @param glm::vec3 boxMax	- maximum corner of the box in world space
+			*/
+		void addOccluder( const glm::vec3 &boxMin, const glm::vec3 &boxMax );
+		/** @brief Adds an indexed triangle mesh as an occluder; both sides of every triangle are rasterized
+			*
+			*	The mesh must lie inside the object it stands in for, or the culler will
+			*	hide things the object does not.
+			*
+			* @param glm::vec3* vertices			- object space vertex positions
+			* @param unsigned int* indices		- three indices per triangle
+			* @param unsigned int numTriangles	- number of triangles
+			* @param glm::mat4 modelMatrix		- places the mesh in the world
+			*/
+		void addOccluderMesh( const glm::vec3 *vertices, const unsigned int *indices, unsigned int numTriangles, const glm::mat4 &modelMatrix = glm::mat4(1.0f) );
+		/** @brief Rasterizes every occluder added since begin() and builds the depth pyramid
+			*/
+		void end();
+
+		/** @brief Tests a box against the occluders of the last end()
+			*
+			*	Conservative: true unless every pixel the box covers is nearer to an
+			*	occluder than to the box.  Safe to call from several threads at once.
+			*
+			* @param glm::vec3 boxMin	- minimum corner of the box in world space
+			* @param glm::vec3 boxMax	- maximum corner of the box in world space
+			* @return false if the box is hidden behind the occluders or entirely off screen
+			*/
+		bool isVisible( const glm::vec3 &boxMin, const glm::vec3 &boxMax ) const;
+
+		/** @brief Returns the width of the depth buffer
+			* @return pixels across
+			*/
+		unsigned int getWidth() const;
+		/** @brief Returns the height of the depth buffer
+			* @return pixels down
+			*/
+		unsigned int getHeight() const;
+		/** @brief Returns the number of levels in the depth pyramid
+			* @return levels including the full resolution buffer
+			*/
+		unsigned int getNumLevels() const;
+		/** @brief Returns one level of the depth pyramid as rows from the bottom of the screen up
+			*
+			*	Each value is 1/w of the farthest occluder over that texel, 0 where nothing was drawn.
+			*
+			* @param unsigned int level	- 0 is the full resolution buffer
+			* @return max( width >> level, 1 ) by max( height >> level, 1 ) values, rounded up
+			*/
+		const float* getDepth( unsigned int level = 0 ) const;
+		/** @brief Returns the number of triangles the last end() rasterized
+			* @return triangles after back faces were dropped and the near plane clipped
+			*/
+		unsigned int getNumOccluderTriangles() const;
+		/** @brief Returns how long the last end() took
+			* @return time in milliseconds
+			*/
+		double getRasterTime() const;
+
+	private:
+		// a screen space triangle with edge functions and 1/w as planes relative to its first vertex
+		struct Triangle {
+			float x0, y0;
+			float edgeA[3], edgeB[3], edgeC[3];
+			float depth0, depthA, depthB;
+			int minX, maxX, minY, maxY;
+		};
+
+		void _addClipTriangle( const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c, bool cullBackFaces );
+		void _addScreenTriangle( const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c, bool cullBackFaces );
+		void _rasterizeTiles( unsigned int firstTile, unsigned int lastTile );
+		void _buildPyramid();
+
+		unsigned int _width, _height, _tilesX, _tilesY;
+		glm::mat4 _viewProjection;
+
+		std::vector< Triangle > _triangles;
+		std::vector< std::vector< unsigned int > > _bins;		// triangles touching each tile, in submission order
+		std::vector< std::vector< float > > _levels;
+		std::vector< unsigned int > _levelWidths, _levelHeights;
+		double _rasterTime;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	// pixels along each side of a tile; a multiple of the lanes
+	static const unsigned int OCCLUSION_TILE_SIZE = 32;
+	// pixels of a row filled together; wide enough for AVX over floats
+	static const unsigned int OCCLUSION_LANES = 8;
+	// relative slack on 1/w when comparing a box against the depth pyramid
+	static const float OCCLUSION_DEPTH_BIAS = 1e-4f;
+	// below this many triangles rasterizing finishes before extra threads would start
+	static const unsigned int OCCLUSION_THREAD_MIN_TRIANGLES = 2048;
+}
+
+inline CSCI441::OcclusionCuller::OcclusionCuller( unsigned int width, unsigned int height ) {
+	const unsigned int TILE = CSCI441_INTERNAL::OCCLUSION_TILE_SIZE;
+	_tilesX = width < 1 ? 1 : (width + TILE - 1) / TILE;
+	_tilesY = height < 1 ? 1 : (height + TILE - 1) / TILE;
+	_width = _tilesX * TILE;
+	_height = _tilesY * TILE;
+	_bins.resize( _tilesX * _tilesY );
+	_rasterTime = 0.0;
+
+	unsigned int w = _width, h = _height;
+	while( true ) {
+		_levels.push_back( std::vector< float >( w * h, 0.0f ) );
+		_levelWidths.push_back( w );
+		_levelHeights.push_back( h );
+		if( w == 1 && h == 1 ) break;
+		w = (w + 1) / 2;
+		h = (h + 1) / 2;
+	}
+}
+
+inline void CSCI441::OcclusionCuller::begin( const glm::mat4 &viewProjectionMatrix ) {
+	_viewProjection = viewProjectionMatrix;
+	_triangles.clear();
+	for( size_t b = 0; b < _bins.size(); b++ ) {
+		_bins[b].clear();
+	}
+}
+
+inline void CSCI441::OcclusionCuller::addOccluder( const glm::vec3 &boxMin, const glm::vec3 &boxMax ) {
+	// corner i takes max along x, y and z for bits 0, 1 and 2 of i
+	glm::vec4 corners[8];
+	for( int i = 0; i < 8; i++ ) {
+		glm::vec4 corner( i & 1 ? boxMax.x : boxMin.x, i & 2 ? boxMax.y : boxMin.y, i & 4 ? boxMax.z : boxMin.z, 1.0f );
+		corners[i] = _viewProjection * corner;
+	}
+
+	// each face counter clockwise seen from outside the box
+	static const int faces[6][4] = { { 0, 4, 6, 2 }, { 1, 3, 7, 5 },		// -x, +x
+																	 { 0, 1, 5, 4 }, { 2, 6, 7, 3 },		// -y, +y
+																	 { 0, 2, 3, 1 }, { 4, 5, 7, 6 } };	// -z, +z
+	for( int f = 0; f < 6; f++ ) {
+		const int *q = faces[f];
+		_addClipTriangle( corners[q[0]], corners[q[1]], corners[q[2]], true );
+		_addClipTriangle( corners[q[0]], corners[q[2]], corners[q[3]], true );
+	}
+}
+
+inline void CSCI441::OcclusionCuller::addOccluderMesh( const glm::vec3 *vertices, const unsigned int *indices, unsigned int numTriangles, const glm::mat4 &modelMatrix ) {
+	glm::mat4 mvp = _viewProjection * modelMatrix;
+	for( unsigned int t = 0; t < numTriangles; t++ ) {
+		_addClipTriangle( mvp * glm::vec4( vertices[ indices[t*3] ], 1.0f ),
+											mvp * glm::vec4( vertices[ indices[t*3 + 1] ], 1.0f ),
+											mvp * glm::vec4( vertices[ indices[t*3 + 2] ], 1.0f ), false );
+	}
+}
+
+inline void CSCI441::OcclusionCuller::end() {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::vector< float > &depth = _levels[0];
+	std::fill( depth.begin(), depth.end(), 0.0f );
+
+	const unsigned int TILE = CSCI441_INTERNAL::OCCLUSION_TILE_SIZE;
+	for( unsigned int t = 0; t < _triangles.size(); t++ ) {
+		const Triangle &triangle = _triangles[t];
+		for( int ty = triangle.minY / (int)TILE; ty <= triangle.maxY / (int)TILE; ty++ ) {
+			for( int tx = triangle.minX / (int)TILE; tx <= triangle.maxX / (int)TILE; tx++ ) {
+				_bins[ ty * _tilesX + tx ].push_back( t );
+			}
+		}
+	}
+
+	// tiles never share pixels, so each thread owns a contiguous run of them outright
+	unsigned int numTiles = _tilesX * _tilesY;
+	unsigned int numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+	if( _triangles.size() >= CSCI441_INTERNAL::OCCLUSION_THREAD_MIN_TRIANGLES ) {
+		numThreads = std::thread::hardware_concurrency();
+		if( numThreads < 1 ) numThreads = 1;
+		if( numThreads > numTiles ) numThreads = numTiles;
+	}
+
+	std::vector< std::thread > workers;
+	for( unsigned int t = 1; t < numThreads; t++ ) {
+		workers.push_back( std::thread( &OcclusionCuller::_rasterizeTiles, this, numTiles * t / numThreads, numTiles * (t+1) / numThreads ) );
+	}
+#endif
+	_rasterizeTiles( 0, numTiles / numThreads );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+
+	_buildPyramid();
+
+	_rasterTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+}
+
+inline bool CSCI441::OcclusionCuller::isVisible( const glm::vec3 &boxMin, const glm::vec3 &boxMax ) const {
+	float minX = 1e30f, maxX = -1e30f, minY = 1e30f, maxY = -1e30f, nearest = 0.0f;
+	for( int i = 0; i < 8; i++ ) {
+		glm::vec4 corner( i & 1 ? boxMax.x : boxMin.x, i & 2 ? boxMax.y : boxMin.y, i & 4 ? boxMax.z : boxMin.z, 1.0f );
+		glm::vec4 clip = _viewProjection * corner;
+		// a corner in front of the near plane could be right against the camera
+		if( clip.z < -clip.w || clip.w <= 0.0f ) return true;
+
+		float inverseW = 1.0f / clip.w;
+		float x = (clip.x * inverseW * 0.5f + 0.5f) * _width;
+		float y = (clip.y * inverseW * 0.5f + 0.5f) * _height;
+		minX = std::min( minX, x );
+		maxX = std::max( maxX, x );
+		minY = std::min( minY, y );
+		maxY = std::max( maxY, y );
+		nearest = std::max( nearest, inverseW );
+	}
+	if( maxX < 0.0f || maxY < 0.0f || minX >= (float)_width || minY >= (float)_height ) return false;
+	// a box's own faces, rasterized as an occluder, must not hide it through rounding
+	nearest *= 1.0f + CSCI441_INTERNAL::OCCLUSION_DEPTH_BIAS;
+
+	// every pixel the box's screen rectangle touches
+	int x0 = std::max( (int)floorf( minX ), 0 ), x1 = std::min( (int)floorf( maxX ), (int)_width - 1 );
+	int y0 = std::max( (int)floorf( minY ), 0 ), y1 = std::min( (int)floorf( maxY ), (int)_height - 1 );
+
+	// climb until those pixels fall within four texels each way
+	unsigned int level = 0;
+	while( level + 1 < _levels.size() && ( (x1 >> level) - (x0 >> level) > 3 || (y1 >> level) - (y0 >> level) > 3 ) ) {
+		level++;
+	}
+
+	const float *depth = &_levels[level][0];
+	unsigned int levelWidth = _levelWidths[level];
+	for( int y = y0 >> level; y <= y1 >> level; y++ ) {
+		for( int x = x0 >> level; x <= x1 >> level; x++ ) {
+			// the farthest occluder there is no nearer than the box
+			if( depth[ y * levelWidth + x ] <= nearest ) return true;
+		}
+	}
+	return false;
+}
+
+inline unsigned int CSCI441::OcclusionCuller::getWidth() const {
+	return _width;
+}
+
+inline unsigned int CSCI441::OcclusionCuller::getHeight() const {
+	return _height;
+}
+
+inline unsigned int CSCI441::OcclusionCuller::getNumLevels() const {
+	return _levels.size();
+}
+
+inline const float* CSCI441::OcclusionCuller::getDepth( unsigned int level ) const {
+	return &_levels[ std::min( level, (unsigned int)_levels.size() - 1 ) ][0];
+}
+
+inline unsigned int CSCI441::OcclusionCuller::getNumOccluderTriangles() const {
+	return _triangles.size();
+}
+
+inline double CSCI441::OcclusionCuller::getRasterTime() const {
+	return _rasterTime;
+}
+
+inline void CSCI441::OcclusionCuller::_addClipTriangle( const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c, bool cullBackFaces ) {
+	// distance to the near plane is z + w in clip space
+	const glm::vec4 in[3] = { a, b, c };
+	float distance[3] = { a.z + a.w, b.z + b.w, c.z + c.w };
+	if( distance[0] >= 0.0f && distance[1] >= 0.0f && distance[2] >= 0.0f ) {
+		_addScreenTriangle( a, b, c, cullBackFaces );
+		return;
+	}
+
+	// cut off what lies in front of the near plane, leaving up to four vertices in order
+	glm::vec4 out[4];
+	int numOut = 0;
+	for( int i = 0; i < 3; i++ ) {
+		int j = (i + 1) % 3;
+		if( distance[i] >= 0.0f ) out[numOut++] = in[i];
+		if( (distance[i] >= 0.0f) != (distance[j] >= 0.0f) ) {
+			float t = distance[i] / (distance[i] - distance[j]);
+			out[numOut++] = in[i] + (in[j] - in[i]) * t;
+		}
+	}
+	for( int i = 2; i < numOut; i++ ) {
+		_addScreenTriangle( out[0], out[i-1], out[i], cullBackFaces );
+	}
+}
+
+inline void CSCI441::OcclusionCuller::_addScreenTriangle( const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c, bool cullBackFaces ) {
+	if( a.w <= 0.0f || b.w <= 0.0f || c.w <= 0.0f ) return;
+
+	glm::vec3 v[3];
+	const glm::vec4 *clip[3] = { &a, &b, &c };
+	for( int i = 0; i < 3; i++ ) {
+		float inverseW = 1.0f / clip[i]->w;
+		v[i] = glm::vec3( (clip[i]->x * inverseW * 0.5f + 0.5f) * _width, (clip[i]->y * inverseW * 0.5f + 0.5f) * _height, inverseW );
+	}
+
+	// counter clockwise on screen is a front face
+	float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+	if( area == 0.0f || (cullBackFaces && area < 0.0f) ) return;
+	if( area < 0.0f ) {
+		std::swap( v[1], v[2] );
+		area = -area;
+	}
+
+	Triangle triangle;
+	triangle.minX = std::max( (int)floorf( std::min( v[0].x, std::min( v[1].x, v[2].x ) ) ), 0 );
+	triangle.maxX = std::min( (int)floorf( std::max( v[0].x, std::max( v[1].x, v[2].x ) ) ), (int)_width - 1 );
+	triangle.minY = std::max( (int)floorf( std::min( v[0].y, std::min( v[1].y, v[2].y ) ) ), 0 );
+	triangle.maxY = std::min( (int)floorf( std::max( v[0].y, std::max( v[1].y, v[2].y ) ) ), (int)_height - 1 );
+	if( triangle.minX > triangle.maxX || triangle.minY > triangle.maxY ) return;
+
+	// everything is measured from the first vertex so vertices far off screen after
+	// near plane clipping do not swamp the values at the pixels with rounding
+	triangle.x0 = v[0].x;
+	triangle.y0 = v[0].y;
+	for( int e = 0; e < 3; e++ ) {
+		const glm::vec3 &from = v[(e + 1) % 3], &to = v[(e + 2) % 3];
+		triangle.edgeA[e] = from.y - to.y;
+		triangle.edgeB[e] = to.x - from.x;
+		triangle.edgeC[e] = triangle.edgeA[e] * (v[0].x - from.x) + triangle.edgeB[e] * (v[0].y - from.y);
+	}
+	// edge e is zero on the edge opposite vertex e and equals area there, so it is a barycentric weight
+	triangle.depth0 = v[0].z;
+	triangle.depthA = (triangle.edgeA[1] * (v[1].z - v[0].z) + triangle.edgeA[2] * (v[2].z - v[0].z)) / area;
+	triangle.depthB = (triangle.edgeB[1] * (v[1].z - v[0].z) + triangle.edgeB[2] * (v[2].z - v[0].z)) / area;
+
+	_triangles.push_back( triangle );
+}
+
+inline void CSCI441::OcclusionCuller::_rasterizeTiles( unsigned int firstTile, unsigned int lastTile ) {
+	const int TILE = CSCI441_INTERNAL::OCCLUSION_TILE_SIZE;
+	const int LANES = CSCI441_INTERNAL::OCCLUSION_LANES;
+	float *depth = &_levels[0][0];
+
+	for( unsigned int tile = firstTile; tile < lastTile; tile++ ) {
+		int tileX = (tile % _tilesX) * TILE, tileY = (tile / _tilesX) * TILE;
+		const std::vector< unsigned int > &bin = _bins[tile];
+
+		for( size_t t = 0; t < bin.size(); t++ ) {
+			const Triangle &triangle = _triangles[ bin[t] ];
+			// a lane aligned start stays inside the tile, and pixels past the
+			// triangle's box fail its edge tests, so whole lanes are always safe
+			int x0 = std::max( triangle.minX, tileX ) & ~(LANES - 1), x1 = std::min( triangle.maxX, tileX + TILE - 1 );
+			int y0 = std::max( triangle.minY, tileY ), y1 = std::min( triangle.maxY, tileY + TILE - 1 );
+
+			// copied out so the compiler knows writing pixels cannot change them
+			const float a0 = triangle.edgeA[0], a1 = triangle.edgeA[1], a2 = triangle.edgeA[2], depthA = triangle.depthA;
+			for( int y = y0; y <= y1; y++ ) {
+				float dy = y + 0.5f - triangle.y0;
+				float r0 = triangle.edgeB[0] * dy + triangle.edgeC[0];
+				float r1 = triangle.edgeB[1] * dy + triangle.edgeC[1];
+				float r2 = triangle.edgeB[2] * dy + triangle.edgeC[2];
+				float rowDepth = triangle.depthB * dy + triangle.depth0;
+				float *pixels = depth + y * _width;
+
+				for( int x = x0; x <= x1; x += LANES ) {
+					float *lane = pixels + x;
+					float start = x + 0.5f - triangle.x0;
+					// no branches across the lanes; a pixel inside all three edges keeps the nearer depth
+					for( int i = 0; i < LANES; i++ ) {
+						float dx = start + i;
+						float inside = std::min( std::min( a0 * dx + r0, a1 * dx + r1 ), a2 * dx + r2 );
+						float z = depthA * dx + rowDepth;
+						lane[i] = (inside >= 0.0f) & (z > lane[i]) ? z : lane[i];
+					}
+				}
+			}
+		}
+	}
+}
+
+inline void CSCI441::OcclusionCuller::_buildPyramid() {
+	// each texel keeps the farthest, smallest 1/w of the up to four texels below it
+	for( size_t level = 1; level < _levels.size(); level++ ) {
+		const float *below = &_levels[level-1][0];
+		float *above = &_levels[level][0];
+		unsigned int belowWidth = _levelWidths[level-1], belowHeight = _levelHeights[level-1];
+		for( unsigned int y = 0; y < _levelHeights[level]; y++ ) {
+			unsigned int y0 = y * 2, y1 = std::min( y * 2 + 1, belowHeight - 1 );
+			for( unsigned int x = 0; x < _levelWidths[level]; x++ ) {
+				unsigned int x0 = x * 2, x1 = std::min( x * 2 + 1, belowWidth - 1 );
+				above[ y * _levelWidths[level] + x ] = std::min( std::min( below[ y0 * belowWidth + x0 ], below[ y0 * belowWidth + x1 ] ),
+																												 std::min( below[ y1 * belowWidth + x0 ], below[ y1 * belowWidth + x1 ] ) );
+			}
+		}
+	}
+}
+
+#endif // __CSCI441_OCCLUSIONCULLER_HPP__
@@ -0,0 +1,299 @@
+/** @file sceneGraph3.hpp
+  * @brief Hierarchy of transforms with cached world matrices for OpenGL 3.0+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	Replaces nesting pushMatrix() and popMatrix() calls with a tree of nodes.
+	*	Each node keeps a local transform relative to its parent and a cached
+	*	world transform.  Nodes live in contiguous arrays and a node can only be
+	*	added after its parent, so every parent comes before its children and one
+	*	front to back pass over the arrays updates the whole tree.
+	*
+	*	Changing a local transform only flags the node.  update() recomputes the
+	*	flagged nodes and everything below them and leaves the rest alone.  The
+	*	world matrices are products of their ancestors' local matrices, so nothing
+	*	is ever inverted; undoing a transform is just using the parent's matrix.
+	*	getWorldTransforms() returns every world matrix in one array, ready to be
+	*	passed as a uniform or copied into a buffer.
+	*
+	*	update() costs in proportion to the nodes below the first edited node.
+	*	The multiplies use SSE on x86, or AVX2 with fused multiply adds when the
+	*	processor reports it at run time, and plain C++ everywhere else.  Editing
+	*	the root still rewrites every world matrix, so it costs at least as much
+	*	as copying both arrays; keep the nodes that change every frame near the
+	*	leaves.
+	*
+	*	@warning NOTE: This header file depends upon glm
+  */
+
+#ifndef __CSCI441_SCENEGRAPH_3_HPP__
+#define __CSCI441_SCENEGRAPH_3_HPP__
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CSCI441_SCENEGRAPH_X86
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @class SceneGraph
+		* @brief Tree of local transforms flattened into parent before child arrays
+		*/
+	class SceneGraph {
+	public:
+		/** @brief Parent of nodes that hang directly off the world
+			*/
+		static const GLint ROOT = -1;
+
+		/** @brief Creates an empty scene graph
+			*/
+		SceneGraph();
+
+		/** @brief Reserves room for a number of nodes up front
+			* @param GLuint numNodes	- total number of nodes expected
+			*/
+		void reserve( GLuint numNodes );
+		/** @brief Adds a node below an existing node
+			* @param GLint parent							- node to attach to, or ROOT
+			* @param glm::mat4 localTransform	- transform relative to the parent
+			* @return index of the new node, always greater than the index of its parent
+			*/
+		GLint addNode( GLint parent = ROOT, const glm::mat4 &localTransform = glm::mat4(1.0f) );
+
+		/** @brief Changes the transform of a node relative to its parent
+			*
+			*	The node and everything below it are recomputed on the next update().
+			*
+			* @param GLint node								- node to change
+			* @param glm::mat4 localTransform	- transform relative to the parent
+			*/
+		void setLocalTransform( GLint node, const glm::mat4 &localTransform );
+		/** @brief Returns the transform of a node relative to its parent
+			* @param GLint node	- node to query
+			* @return local transform
+			*/
+		const glm::mat4& getLocalTransform( GLint node ) const;
+		/** @brief Returns the transform of a node relative to the world as of the last update()
+			* @param GLint node	- node to query
+			* @return world transform
+			*/
+		const glm::mat4& getWorldTransform( GLint node ) const;
+		/** @brief Returns the world transform of every node in node order as of the last update()
+			* @return getNumNodes() world transforms
+			*/
+		const glm::mat4* getWorldTransforms() const;
+
+		/** @brief Returns the parent of a node
+			* @param GLint node	- node to query
+			* @return parent node or ROOT
+			*/
+		GLint getParent( GLint node ) const;
+		/** @brief Returns the number of nodes in the scene graph
+			* @return number of nodes
+			*/
+		GLuint getNumNodes() const;
+
+		/** @brief Recomputes the world transforms of changed nodes and their descendants
+			*/
+		void update();
+		/** @brief Returns how many world transforms the last update() recomputed
+			* @return number of recomputed nodes
+			*/
+		GLuint getNumUpdated() const;
+
+	private:
+		std::vector< glm::mat4 > _localTransforms, _worldTransforms;
+		std::vector< GLint > _parents;
+		std::vector< GLubyte > _dirty;
+		GLuint _firstDirty;		// nothing before this node has changed since the last update
+		GLuint _numUpdated;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	// result = a * b for column major 4x4 matrices; result may not alias a or b
+	void multiplyMatrix( const GLfloat *a, const GLfloat *b, GLfloat *result );
+
+	// the pass behind SceneGraph::update() from node first on; returns the number of nodes recomputed
+	GLuint updateWorldTransforms( const GLint *parents, GLubyte *dirty, const GLfloat *locals, GLfloat *worlds, GLuint first, GLuint numNodes );
+#ifdef CSCI441_SCENEGRAPH_X86
+	GLuint updateWorldTransformsAVX2( const GLint *parents, GLubyte *dirty, const GLfloat *locals, GLfloat *worlds, GLuint first, GLuint numNodes );
+	bool hasAVX2();
+#endif
+}
+
+inline CSCI441::SceneGraph::SceneGraph() {
+	_firstDirty = 0;
+	_numUpdated = 0;
+}
+
+inline void CSCI441::SceneGraph::reserve( GLuint numNodes ) {
+	_localTransforms.reserve( numNodes );
+	_worldTransforms.reserve( numNodes );
+	_parents.reserve( numNodes );
+	_dirty.reserve( numNodes );
+}
+
+inline GLint CSCI441::SceneGraph::addNode( GLint parent, const glm::mat4 &localTransform ) {
+	if( parent < ROOT || parent >= (GLint)_parents.size() ) {
+		fprintf( stderr, "[ERROR]: SceneGraph parent %d does not exist, attaching to the root\n", parent );
+		parent = ROOT;
+	}
+
+	GLint node = _parents.size();
+	_localTransforms.push_back( localTransform );
+	_worldTransforms.push_back( localTransform );
+	_parents.push_back( parent );
+	_dirty.push_back( 1 );
+	if( (GLuint)node < _firstDirty ) _firstDirty = node;
+	return node;
+}
+
+inline void CSCI441::SceneGraph::setLocalTransform( GLint node, const glm::mat4 &localTransform ) {
+	_localTransforms[node] = localTransform;
+	_dirty[node] = 1;
+	if( (GLuint)node < _firstDirty ) _firstDirty = node;
+}
+
+inline const glm::mat4& CSCI441::SceneGraph::getLocalTransform( GLint node ) const {
+	return _localTransforms[node];
+}
+
+inline const glm::mat4& CSCI441::SceneGraph::getWorldTransform( GLint node ) const {
+	return _worldTransforms[node];
+}
+
+inline const glm::mat4* CSCI441::SceneGraph::getWorldTransforms() const {
+	return _worldTransforms.empty() ? NULL : &_worldTransforms[0];
+}
+
+inline GLint CSCI441::SceneGraph::getParent( GLint node ) const {
+	return _parents[node];
+}
+
+inline GLuint CSCI441::SceneGraph::getNumNodes() const {
+	return _parents.size();
+}
+
+inline void CSCI441::SceneGraph::update() {
+	GLuint numNodes = _parents.size();
+	_numUpdated = 0;
+	if( _firstDirty >= numNodes ) return;
+
+#ifdef CSCI441_SCENEGRAPH_X86
+	static const bool useAVX2 = CSCI441_INTERNAL::hasAVX2();
+	if( useAVX2 ) {
+		_numUpdated = CSCI441_INTERNAL::updateWorldTransformsAVX2( &_parents[0], &_dirty[0], &_localTransforms[0][0][0], &_worldTransforms[0][0][0], _firstDirty, numNodes );
+	} else
+#endif
+	_numUpdated = CSCI441_INTERNAL::updateWorldTransforms( &_parents[0], &_dirty[0], &_localTransforms[0][0][0], &_worldTransforms[0][0][0], _firstDirty, numNodes );
+
+	memset( &_dirty[_firstDirty], 0, numNodes - _firstDirty );
+	_firstDirty = numNodes;
+}
+
+inline GLuint CSCI441::SceneGraph::getNumUpdated() const {
+	return _numUpdated;
+}
+
+inline void CSCI441_INTERNAL::multiplyMatrix( const GLfloat *a, const GLfloat *b, GLfloat *result ) {
+	// each result column is the columns of a weighted by one column of b
+#ifdef __SSE__
+	__m128 a0 = _mm_loadu_ps( a ), a1 = _mm_loadu_ps( a + 4 ), a2 = _mm_loadu_ps( a + 8 ), a3 = _mm_loadu_ps( a + 12 );
+	for( int c = 0; c < 4; c++ ) {
+		__m128 column = _mm_add_ps( _mm_add_ps( _mm_mul_ps( a0, _mm_set1_ps( b[c*4] ) ),     _mm_mul_ps( a1, _mm_set1_ps( b[c*4 + 1] ) ) ),
+									_mm_add_ps( _mm_mul_ps( a2, _mm_set1_ps( b[c*4 + 2] ) ), _mm_mul_ps( a3, _mm_set1_ps( b[c*4 + 3] ) ) ) );
+		_mm_storeu_ps( result + c*4, column );
+	}
+#else
+	// a is copied in first so the compiler knows result cannot overwrite it
+	GLfloat columns[16], product[16];
+	memcpy( columns, a, sizeof(columns) );
+	for( int c = 0; c < 4; c++ ) {
+		GLfloat b0 = b[c*4], b1 = b[c*4 + 1], b2 = b[c*4 + 2], b3 = b[c*4 + 3];
+		for( int r = 0; r < 4; r++ ) {
+			product[c*4 + r] = columns[r]*b0 + columns[4 + r]*b1 + columns[8 + r]*b2 + columns[12 + r]*b3;
+		}
+	}
+	memcpy( result, product, sizeof(product) );
+#endif
+}
+
+inline GLuint CSCI441_INTERNAL::updateWorldTransforms( const GLint *parents, GLubyte *dirty, const GLfloat *locals, GLfloat *worlds, GLuint first, GLuint numNodes ) {
+	// parents come first, so by the time a node is reached its parent's flag and
+	// world matrix are final.  a flag spreads to every node below it in one pass
+	GLuint numUpdated = 0;
+	for( GLuint node = first; node < numNodes; node++ ) {
+		GLint parent = parents[node];
+		if( parent != CSCI441::SceneGraph::ROOT ) dirty[node] |= dirty[parent];
+		if( !dirty[node] ) continue;
+
+		if( parent == CSCI441::SceneGraph::ROOT ) {
+			memcpy( worlds + node*16, locals + node*16, 16 * sizeof(GLfloat) );
+		} else {
+			multiplyMatrix( worlds + parent*16, locals + node*16, worlds + node*16 );
+		}
+		numUpdated++;
+	}
+	return numUpdated;
+}
+
+#ifdef CSCI441_SCENEGRAPH_X86
+// the same pass as updateWorldTransforms(), computing two result columns per instruction
+__attribute__(( target( "avx2,fma" ) ))
+inline GLuint CSCI441_INTERNAL::updateWorldTransformsAVX2( const GLint *parents, GLubyte *dirty, const GLfloat *locals, GLfloat *worlds, GLuint first, GLuint numNodes ) {
+	GLuint numUpdated = 0;
+	for( GLuint node = first; node < numNodes; node++ ) {
+		GLint parent = parents[node];
+		if( parent != CSCI441::SceneGraph::ROOT ) dirty[node] |= dirty[parent];
+		if( !dirty[node] ) continue;
+
+		const GLfloat *b = locals + node*16;
+		GLfloat *result = worlds + node*16;
+		if( parent == CSCI441::SceneGraph::ROOT ) {
+			memcpy( result, b, 16 * sizeof(GLfloat) );
+		} else {
+			// every column of a in both halves, one column of b per half
+			const GLfloat *a = worlds + parent*16;
+			__m256 a0 = _mm256_broadcast_ps( (const __m128*)a ), a1 = _mm256_broadcast_ps( (const __m128*)(a + 4) );
+			__m256 a2 = _mm256_broadcast_ps( (const __m128*)(a + 8) ), a3 = _mm256_broadcast_ps( (const __m128*)(a + 12) );
+			for( int c = 0; c < 4; c += 2 ) {
+				__m256 b0 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_broadcast_ss( b + c*4 ) ), _mm_broadcast_ss( b + c*4 + 4 ), 1 );
+				__m256 b1 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_broadcast_ss( b + c*4 + 1 ) ), _mm_broadcast_ss( b + c*4 + 5 ), 1 );
+				__m256 b2 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_broadcast_ss( b + c*4 + 2 ) ), _mm_broadcast_ss( b + c*4 + 6 ), 1 );
+				__m256 b3 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_broadcast_ss( b + c*4 + 3 ) ), _mm_broadcast_ss( b + c*4 + 7 ), 1 );
+				_mm256_storeu_ps( result + c*4, _mm256_fmadd_ps( a3, b3, _mm256_fmadd_ps( a2, b2, _mm256_fmadd_ps( a1, b1, _mm256_mul_ps( a0, b0 ) ) ) ) );
+			}
+		}
+		numUpdated++;
+	}
+	return numUpdated;
+}
+
+inline bool CSCI441_INTERNAL::hasAVX2() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" );
+}
+#endif
+
+#endif // __CSCI441_SCENEGRAPH_3_HPP__
@@ -0,0 +1,251 @@
+/** @file skybox3.hpp
+  * @brief Cube map skybox drawn with one call in OpenGL 3.2+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	The six face images are decoded, mipmapped, and compressed on their own
+	*	threads through CSCI441::TextureCache, then uploaded as the faces of one
+	*	GL_TEXTURE_CUBE_MAP.  Faces only SOIL can decode take turns inside it.  The sky is an eight vertex cube around the camera
+	*	drawn as a single triangle strip, and its vertex positions double as the
+	*	direction to sample.
+	*
+	*	Draw the skybox after the opaque geometry.  Its vertex shader should drop
+	*	the translation from the view matrix and write z = w, for instance
+	*
+	*		gl_Position = ( projection * mat4( mat3( view ) ) * vec4( vPos, 1.0 ) ).xyww;
+	*
+	*	so every fragment lands on the far plane.  draw() compares with
+	*	GL_LEQUAL, and early depth testing discards the fragments behind the
+	*	scene before they are shaded, so only the uncovered pixels sample the
+	*	cube map.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
+	*	@warning NOTE: This header file depends upon GLEW and SOIL
+	*	@warning NOTE: The faces are loaded on std::thread workers.  Define CSCI441_NO_THREADS
+	*	before including this file on toolchains without std::thread support
+  */
+
+#ifndef __CSCI441_SKYBOX_3_HPP__
+#define __CSCI441_SKYBOX_3_HPP__
+
+#include <GL/glew.h>
+
+#include <CSCI441/textureCache3.hpp>
+#include <CSCI441/textureRegistry3.hpp>
+
+#include <stdio.h>
+
+#include <chrono>
+#include <map>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @class Skybox
+		* @brief Six images in one cube map, rendered around the camera with a single draw
+		*/
+	class Skybox {
+	public:
+		/** @brief Creates an empty skybox; nothing is drawn until load() succeeds
+			*/
+		Skybox();
+		/** @brief Frees the cube map, buffers, and VAOs
+			*/
+		~Skybox();
+
+		/** @brief Loads six images as the faces of the cube map
+			*
+			*	Each face is loaded through CSCI441::TextureCache on its own thread and the
+			*	faces are uploaded once all have finished.  The images must be square and
+			*	the same size.  They are not flipped: the cube map expects each face's top
+			*	row first.
+			*
+			* @param const char* faceFilenames[6]	- images for +X, -X, +Y, -Y, +Z, and -Z in that order
+			* @param unsigned int flags					- TextureCache::CacheFlags to apply (default: mipmaps and compression)
+			* @return true if every face loaded
+			*/
+		bool load( const char *faceFilenames[6], unsigned int flags = TextureCache::CACHE_MIPMAPS | TextureCache::CACHE_COMPRESS );
+
+		/** @brief Renders the skybox with one draw call
+			*
+			*	Binds the cube map and its sampler through CSCI441::TextureRegistry and
+			*	draws with the depth function set to GL_LEQUAL, restoring the previous
+			*	one afterwards.  Each position location gets its own VAO.
+			*
+			* @param GLint positionLocation	- attribute location of the cube vertex position
+			* @param GLenum textureUnit			- unit the shader samples the cube map from (default: GL_TEXTURE0)
+			*/
+		void draw( GLint positionLocation, GLenum textureUnit = GL_TEXTURE0 );
+
+		/** @brief Returns the cube map texture handle, or 0 before load() succeeds
+			*/
+		GLuint getTextureHandle() const;
+		/** @brief Returns the milliseconds the last load() took, from the first face read to the last face uploaded
+			*/
+		double getLoadTime() const;
+
+	private:
+		Skybox( const Skybox & );
+		Skybox& operator=( const Skybox & );
+
+		GLuint _bindVAO( GLint positionLocation );
+
+		GLuint _textureHandle;
+		GLuint _cubeVBO, _cubeIBO;
+		std::map< GLint, GLuint > _vaos;
+		double _loadTime;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	void loadSkyboxFace( CSCI441::TextureCache::CachedTexture *face, const char *filename, unsigned int flags, bool *loaded );
+
+	// corners of the cube with bit 0, 1, 2 set for +x, +y, +z
+	static const GLuint SKYBOX_CUBE_VERTICES = 8;
+	// one strip covering all six faces
+	static const GLuint SKYBOX_CUBE_INDICES = 14;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::Skybox::Skybox() : _textureHandle(0), _cubeVBO(0), _cubeIBO(0), _loadTime(0.0) {
+}
+
+inline CSCI441::Skybox::~Skybox() {
+	if( _textureHandle != 0 ) {
+		TextureRegistry::unregisterTexture( _textureHandle );
+		glDeleteTextures( 1, &_textureHandle );
+	}
+	if( _cubeVBO != 0 ) glDeleteBuffers( 1, &_cubeVBO );
+	if( _cubeIBO != 0 ) glDeleteBuffers( 1, &_cubeIBO );
+	for( std::map< GLint, GLuint >::iterator vaoIter = _vaos.begin(); vaoIter != _vaos.end(); vaoIter++ ) {
+		glDeleteVertexArrays( 1, &vaoIter->second );
+	}
+}
+
+inline bool CSCI441::Skybox::load( const char *faceFilenames[6], unsigned int flags ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	TextureCache::CachedTexture faces[6];
+	bool loaded[6];
+#ifndef CSCI441_NO_THREADS
+	std::thread workers[6];
+	for( int i = 0; i < 6; i++ ) {
+		workers[i] = std::thread( CSCI441_INTERNAL::loadSkyboxFace, &faces[i], faceFilenames[i], flags, &loaded[i] );
+	}
+	for( int i = 0; i < 6; i++ ) {
+		workers[i].join();
+	}
+#else
+	for( int i = 0; i < 6; i++ ) {
+		CSCI441_INTERNAL::loadSkyboxFace( &faces[i], faceFilenames[i], flags, &loaded[i] );
+	}
+#endif
+
+	for( int i = 0; i < 6; i++ ) {
+		if( !loaded[i] ) return false;
+		if( faces[i].getWidth() != faces[i].getHeight() || faces[i].getWidth() != faces[0].getWidth()
+		 || faces[i].getFormat() != faces[0].getFormat() ) {
+			fprintf( stderr, "[ERROR]: Skybox face \"%s\" is not square or does not match \"%s\"\n", faceFilenames[i], faceFilenames[0] );
+			return false;
+		}
+	}
+
+	if( _textureHandle == 0 ) glGenTextures( 1, &_textureHandle );
+	glBindTexture( GL_TEXTURE_CUBE_MAP, _textureHandle );
+	for( int i = 0; i < 6; i++ ) {
+		faces[i].upload( GL_TEXTURE_CUBE_MAP_POSITIVE_X + i );
+	}
+	TextureRegistry::registerTexture( _textureHandle, GL_TEXTURE_CUBE_MAP, faces[0].getFormat(), faces[0].getWidth(), faces[0].getHeight(), 1, faces[0].getNumLevels(),
+									  TextureRegistry::getSampler( faces[0].getNumLevels() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE ),
+									  faceFilenames[0] );
+	// filter across face edges so the seams of the cube do not show
+	glEnable( GL_TEXTURE_CUBE_MAP_SEAMLESS );
+
+	if( _cubeVBO == 0 ) {
+		GLfloat vertices[ CSCI441_INTERNAL::SKYBOX_CUBE_VERTICES * 3 ];
+		for( GLuint corner = 0; corner < CSCI441_INTERNAL::SKYBOX_CUBE_VERTICES; corner++ ) {
+			for( GLuint axis = 0; axis < 3; axis++ ) {
+				vertices[corner * 3 + axis] = ( corner >> axis ) & 1 ? 1.0f : -1.0f;
+			}
+		}
+		const GLushort indices[ CSCI441_INTERNAL::SKYBOX_CUBE_INDICES ] = { 6, 7, 4, 5, 1, 7, 3, 6, 2, 4, 0, 1, 2, 3 };
+
+		glGenBuffers( 1, &_cubeVBO );
+		glBindBuffer( GL_ARRAY_BUFFER, _cubeVBO );
+		glBufferData( GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW );
+
+		// filled through GL_ARRAY_BUFFER so whatever vertex array is bound keeps its own element
+		// buffer; _bindVAO() attaches it as the element buffer of the skybox's vertex arrays
+		glGenBuffers( 1, &_cubeIBO );
+		glBindBuffer( GL_ARRAY_BUFFER, _cubeIBO );
+		glBufferData( GL_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW );
+	}
+
+	_loadTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+	return true;
+}
+
+inline void CSCI441::Skybox::draw( GLint positionLocation, GLenum textureUnit ) {
+	if( _textureHandle == 0 ) return;
+
+	GLint depthFunc;
+	glGetIntegerv( GL_DEPTH_FUNC, &depthFunc );
+	glDepthFunc( GL_LEQUAL );
+
+	TextureRegistry::bindTexture( textureUnit, _textureHandle );
+	glBindVertexArray( _bindVAO( positionLocation ) );
+	glDrawElements( GL_TRIANGLE_STRIP, CSCI441_INTERNAL::SKYBOX_CUBE_INDICES, GL_UNSIGNED_SHORT, (void*)0 );
+
+	glDepthFunc( depthFunc );
+}
+
+inline GLuint CSCI441::Skybox::getTextureHandle() const {
+	return _textureHandle;
+}
+
+inline double CSCI441::Skybox::getLoadTime() const {
+	return _loadTime;
+}
+
+inline GLuint CSCI441::Skybox::_bindVAO( GLint positionLocation ) {
+	std::map< GLint, GLuint >::iterator vaoIter = _vaos.find( positionLocation );
+	if( vaoIter != _vaos.end() ) {
+		return vaoIter->second;
+	}
+
+	GLuint vaod;
+	glGenVertexArrays( 1, &vaod );
+	glBindVertexArray( vaod );
+
+	glBindBuffer( GL_ARRAY_BUFFER, _cubeVBO );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _cubeIBO );
+	if( positionLocation != -1 ) {
+		glEnableVertexAttribArray( positionLocation );
+		glVertexAttribPointer( positionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 3, (void*)0 );
+	}
+
+	_vaos.insert( std::pair< GLint, GLuint >( positionLocation, vaod ) );
+	return vaod;
+}
+
+inline void CSCI441_INTERNAL::loadSkyboxFace( CSCI441::TextureCache::CachedTexture *face, const char *filename, unsigned int flags, bool *loaded ) {
+	*loaded = face->load( filename, flags );
+}
+
+#endif // __CSCI441_SKYBOX_3_HPP__
@@ -0,0 +1,451 @@
+/** @file splines.hpp
+  * @brief Piecewise cubic splines evaluated in batches
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	Cubic Bezier, Catmull-Rom, uniform B-spline and Hermite curves share one
+	*	formulation: each segment's geometry G is multiplied by the basis matrix M
+	*	once, giving power basis coefficients so that P(t) = [t^3 t^2 t 1] M G is
+	*	three multiply-adds per axis.  Sampling a segment evaluates eight parameters
+	*	at a time in plain arrays so compilers vectorize them, and large batches
+	*	are spread across threads.
+	*
+	*	@warning NOTE: This header file depends upon glm
+	*	@warning NOTE: Large batches are split across std::thread workers.  Define
+	*	CSCI441_NO_THREADS before including this file on toolchains without std::thread support
+  */
+
+#ifndef __CSCI441_SPLINES_HPP__
+#define __CSCI441_SPLINES_HPP__
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @struct BezierBasis
+		* @brief Cubic Bezier segments; segment i uses control points 3i..3i+3 and neighbors share end points
+		*/
+	struct BezierBasis {
+		static const unsigned int STRIDE = 3;
+		static const float* matrix();
+	};
+
+	/** @struct CatmullRomBasis
+		* @brief Catmull-Rom segments; segment i runs from control point i+1 to i+2 through every interior point
+		*/
+	struct CatmullRomBasis {
+		static const unsigned int STRIDE = 1;
+		static const float* matrix();
+	};
+
+	/** @struct BSplineBasis
+		* @brief Uniform cubic B-spline segments; segment i is shaped by control points i..i+3 but passes through none
+		*/
+	struct BSplineBasis {
+		static const unsigned int STRIDE = 1;
+		static const float* matrix();
+	};
+
+	/** @struct HermiteBasis
+		* @brief Cubic Hermite segments; control points alternate position, tangent, position, tangent, ...
+		*/
+	struct HermiteBasis {
+		static const unsigned int STRIDE = 2;
+		static const float* matrix();
+	};
+
+	/** @class Spline
+		* @brief Piecewise cubic curve in the form given by Basis
+		*
+		*	The curve parameter t runs from 0 to getNumSegments(); the integer part picks the
+		*	segment and the fraction is the position within it.
+		*/
+	template< typename Basis >
+	class Spline {
+	public:
+		/** @brief Creates an empty spline
+			*/
+		Spline();
+		/** @brief Creates a spline through the given control points
+			* @param const std::vector<glm::vec3>& controlPoints	- control points in the order Basis expects
+			*/
+		Spline( const std::vector< glm::vec3 > &controlPoints );
+
+		/** @brief Replaces the control points and recomputes every segment's coefficients
+			* @param const std::vector<glm::vec3>& controlPoints	- control points in the order Basis expects
+			*/
+		void setControlPoints( const std::vector< glm::vec3 > &controlPoints );
+		/** @brief Moves one control point and recomputes the segments it shapes
+			* @param unsigned int index		- index of the control point
+			* @param glm::vec3 point				- new location of the control point
+			*/
+		void setControlPoint( unsigned int index, glm::vec3 point );
+		/** @brief Returns the control points of the spline
+			* @return control points
+			*/
+		const std::vector< glm::vec3 >& getControlPoints() const;
+		/** @brief Returns the number of cubic segments in the spline
+			* @return number of segments, zero with fewer than four control points
+			*/
+		unsigned int getNumSegments() const;
+
+		/** @brief Evaluates the curve at one parameter
+			* @param float t	- curve parameter, clamped to [0, getNumSegments()]
+			* @return position on the curve
+			*/
+		glm::vec3 position( float t ) const;
+		/** @brief Evaluates the derivative of the curve at one parameter
+			* @param float t	- curve parameter, clamped to [0, getNumSegments()]
+			* @return derivative with respect to t
+			*/
+		glm::vec3 tangent( float t ) const;
+
+		/** @brief Evaluates the curve at many parameters
+			*
+			*	Parameters may come in any order, as for a group of objects following the curve.
+			*
+			* @param const float* parameters	- curve parameters
+			* @param unsigned int count				- number of parameters
+			* @param glm::vec3* positions				- receives count positions, may be NULL
+			* @param glm::vec3* tangents				- receives count derivatives, may be NULL
+			*/
+		void evaluate( const float *parameters, unsigned int count, glm::vec3 *positions, glm::vec3 *tangents = NULL ) const;
+		/** @brief Samples every segment at evenly spaced parameters
+			*
+			*	Neighboring segments share the sample at their common end, so the output holds
+			*	getNumSegments() * samplesPerSegment + 1 samples.
+			*
+			* @param unsigned int samplesPerSegment	- samples along each segment, not counting its end
+			* @param glm::vec3* positions					- receives the positions, may be NULL
+			* @param glm::vec3* tangents					- receives the derivatives, may be NULL
+			* @pre samplesPerSegment must be greater than zero
+			*/
+		void sample( unsigned int samplesPerSegment, glm::vec3 *positions, glm::vec3 *tangents = NULL ) const;
+
+		/** @brief Returns the power basis coefficients a, b, c, d of one segment, each a packed x,y,z
+			* @param unsigned int segment	- index of the segment
+			* @return 12 floats with P(t) = ((a t + b) t + c) t + d
+			*/
+		const float* getCoefficients( unsigned int segment ) const;
+
+	private:
+		void _updateSegment( unsigned int segment );
+		void _evaluateRange( const float *parameters, unsigned int first, unsigned int last, glm::vec3 *positions, glm::vec3 *tangents ) const;
+		void _sampleRange( unsigned int samplesPerSegment, unsigned int firstSegment, unsigned int lastSegment, glm::vec3 *positions, glm::vec3 *tangents ) const;
+
+		std::vector< glm::vec3 > _controlPoints;
+		std::vector< float > _coefficients;
+	};
+
+	typedef Spline< BezierBasis > BezierSpline;
+	typedef Spline< CatmullRomBasis > CatmullRomSpline;
+	typedef Spline< BSplineBasis > BSpline;
+	typedef Spline< HermiteBasis > HermiteSpline;
+
+	/** @brief Evaluates many splines at one parameter each
+		*
+		*	Meant for many objects each following their own path in the same frame.
+		*
+		* @param const Spline<Basis>* const* splines	- spline followed by each object
+		* @param const float* parameters					- curve parameter of each object
+		* @param unsigned int count								- number of objects
+		* @param glm::vec3* positions								- receives count positions, may be NULL
+		* @param glm::vec3* tangents								- receives count derivatives, may be NULL
+		* @pre every spline must have at least one segment
+		*/
+	template< typename Basis >
+	void evaluateSplines( const Spline< Basis > * const *splines, const float *parameters, unsigned int count, glm::vec3 *positions, glm::vec3 *tangents = NULL );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	// samples of one segment computed together; wide enough for AVX over floats
+	static const unsigned int SPLINE_LANES = 8;
+
+	// below this many samples a batch is not worth spreading across threads
+	static const unsigned int SPLINE_THREAD_MIN_SAMPLES = 16384;
+
+	unsigned int getSplineThreadCount( unsigned int work, unsigned int maxThreads );
+
+	// parameter i is evaluated on splines[ i * splineStride ], so a stride of zero keeps every parameter on one spline
+	template< typename Basis >
+	void evaluateSplinesRange( const CSCI441::Spline< Basis > * const *splines, unsigned int splineStride, const float *parameters,
+														 unsigned int first, unsigned int last, glm::vec3 *positions, glm::vec3 *tangents );
+}
+
+// rows multiply [t^3 t^2 t 1], columns multiply the segment's four geometry points
+inline const float* CSCI441::BezierBasis::matrix() {
+	static const float m[16] = { -1.0f,  3.0f, -3.0f,  1.0f,
+																3.0f, -6.0f,  3.0f,  0.0f,
+															 -3.0f,  3.0f,  0.0f,  0.0f,
+																1.0f,  0.0f,  0.0f,  0.0f };
+	return m;
+}
+
+inline const float* CSCI441::CatmullRomBasis::matrix() {
+	static const float m[16] = { -0.5f,  1.5f, -1.5f,  0.5f,
+																1.0f, -2.5f,  2.0f, -0.5f,
+															 -0.5f,  0.0f,  0.5f,  0.0f,
+																0.0f,  1.0f,  0.0f,  0.0f };
+	return m;
+}
+
+inline const float* CSCI441::BSplineBasis::matrix() {
+	static const float m[16] = { -1.0f/6.0f,  3.0f/6.0f, -3.0f/6.0f, 1.0f/6.0f,
+																3.0f/6.0f, -6.0f/6.0f,  3.0f/6.0f, 0.0f,
+															 -3.0f/6.0f,  0.0f,       3.0f/6.0f, 0.0f,
+																1.0f/6.0f,  4.0f/6.0f,  1.0f/6.0f, 0.0f };
+	return m;
+}
+
+// geometry in the order P0, T0, P1, T1
+inline const float* CSCI441::HermiteBasis::matrix() {
+	static const float m[16] = {  2.0f,  1.0f, -2.0f,  1.0f,
+															 -3.0f, -2.0f,  3.0f, -1.0f,
+																0.0f,  1.0f,  0.0f,  0.0f,
+																1.0f,  0.0f,  0.0f,  0.0f };
+	return m;
+}
+
+template< typename Basis >
+inline CSCI441::Spline< Basis >::Spline() {
+}
+
+template< typename Basis >
+inline CSCI441::Spline< Basis >::Spline( const std::vector< glm::vec3 > &controlPoints ) {
+	setControlPoints( controlPoints );
+}
+
+template< typename Basis >
+inline void CSCI441::Spline< Basis >::setControlPoints( const std::vector< glm::vec3 > &controlPoints ) {
+	_controlPoints = controlPoints;
+	_coefficients.resize( getNumSegments() * 12 );
+	for( unsigned int segment = 0; segment < getNumSegments(); segment++ ) {
+		_updateSegment( segment );
+	}
+}
+
+template< typename Basis >
+inline void CSCI441::Spline< Basis >::setControlPoint( unsigned int index, glm::vec3 point ) {
+	_controlPoints[index] = point;
+
+	// segment s reads control points s*STRIDE .. s*STRIDE+3
+	unsigned int first = index < 3 ? 0 : (index - 3 + Basis::STRIDE - 1) / Basis::STRIDE;
+	for( unsigned int segment = first; segment <= index / Basis::STRIDE && segment < getNumSegments(); segment++ ) {
+		_updateSegment( segment );
+	}
+}
+
+template< typename Basis >
+inline const std::vector< glm::vec3 >& CSCI441::Spline< Basis >::getControlPoints() const {
+	return _controlPoints;
+}
+
+template< typename Basis >
+inline unsigned int CSCI441::Spline< Basis >::getNumSegments() const {
+	return _controlPoints.size() < 4 ? 0 : (_controlPoints.size() - 4) / Basis::STRIDE + 1;
+}
+
+template< typename Basis >
+inline glm::vec3 CSCI441::Spline< Basis >::position( float t ) const {
+	glm::vec3 result( 0.0f, 0.0f, 0.0f );
+	if( getNumSegments() > 0 ) {
+		_evaluateRange( &t, 0, 1, &result, NULL );
+	}
+	return result;
+}
+
+template< typename Basis >
+inline glm::vec3 CSCI441::Spline< Basis >::tangent( float t ) const {
+	glm::vec3 result( 0.0f, 0.0f, 0.0f );
+	if( getNumSegments() > 0 ) {
+		_evaluateRange( &t, 0, 1, NULL, &result );
+	}
+	return result;
+}
+
+template< typename Basis >
+inline void CSCI441::Spline< Basis >::evaluate( const float *parameters, unsigned int count, glm::vec3 *positions, glm::vec3 *tangents ) const {
+	if( getNumSegments() == 0 ) {
+		for( unsigned int i = 0; i < count; i++ ) {
+			if( positions != NULL ) positions[i] = glm::vec3( 0.0f, 0.0f, 0.0f );
+			if( tangents != NULL ) tangents[i] = glm::vec3( 0.0f, 0.0f, 0.0f );
+		}
+		return;
+	}
+
+	unsigned int numThreads = CSCI441_INTERNAL::getSplineThreadCount( count, count / CSCI441_INTERNAL::SPLINE_LANES );
+#ifndef CSCI441_NO_THREADS
+	// every worker writes its own range of the output
+	std::vector< std::thread > workers;
+	for( unsigned int t = 1; t < numThreads; t++ ) {
+		workers.push_back( std::thread( &CSCI441::Spline< Basis >::_evaluateRange, this, parameters,
+																		(unsigned long long)count * t / numThreads, (unsigned long long)count * (t+1) / numThreads, positions, tangents ) );
+	}
+#endif
+	_evaluateRange( parameters, 0, count / numThreads, positions, tangents );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+}
+
+template< typename Basis >
+inline void CSCI441::Spline< Basis >::sample( unsigned int samplesPerSegment, glm::vec3 *positions, glm::vec3 *tangents ) const {
+	unsigned int numSegments = getNumSegments();
+	if( numSegments == 0 || samplesPerSegment == 0 ) return;
+
+	unsigned int numThreads = CSCI441_INTERNAL::getSplineThreadCount( numSegments * samplesPerSegment, numSegments );
+#ifndef CSCI441_NO_THREADS
+	std::vector< std::thread > workers;
+	for( unsigned int t = 1; t < numThreads; t++ ) {
+		workers.push_back( std::thread( &CSCI441::Spline< Basis >::_sampleRange, this, samplesPerSegment,
+																		(unsigned long long)numSegments * t / numThreads, (unsigned long long)numSegments * (t+1) / numThreads, positions, tangents ) );
+	}
+#endif
+	_sampleRange( samplesPerSegment, 0, numSegments / numThreads, positions, tangents );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+
+	// the end of the last segment
+	float t = (float)numSegments;
+	_evaluateRange( &t, 0, 1, positions == NULL ? NULL : positions + numSegments * samplesPerSegment,
+																tangents == NULL ? NULL : tangents + numSegments * samplesPerSegment );
+}
+
+template< typename Basis >
+inline const float* CSCI441::Spline< Basis >::getCoefficients( unsigned int segment ) const {
+	return &_coefficients[ segment * 12 ];
+}
+
+template< typename Basis >
+inline void CSCI441::Spline< Basis >::_updateSegment( unsigned int segment ) {
+	const float *m = Basis::matrix();
+	const glm::vec3 *g = &_controlPoints[ segment * Basis::STRIDE ];
+	float *c = &_coefficients[ segment * 12 ];
+	for( int row = 0; row < 4; row++ ) {
+		glm::vec3 coefficient = m[row*4+0] * g[0] + m[row*4+1] * g[1] + m[row*4+2] * g[2] + m[row*4+3] * g[3];
+		c[row*3+0] = coefficient.x;
+		c[row*3+1] = coefficient.y;
+		c[row*3+2] = coefficient.z;
+	}
+}
+
+template< typename Basis >
+inline void CSCI441::Spline< Basis >::_evaluateRange( const float *parameters, unsigned int first, unsigned int last, glm::vec3 *positions, glm::vec3 *tangents ) const {
+	// the same lane kernel as evaluateSplines(), with every lane on this spline
+	const Spline< Basis > *spline = this;
+	CSCI441_INTERNAL::evaluateSplinesRange( &spline, 0, parameters, first, last, positions, tangents );
+}
+
+template< typename Basis >
+inline void CSCI441::Spline< Basis >::_sampleRange( unsigned int samplesPerSegment, unsigned int firstSegment, unsigned int lastSegment, glm::vec3 *positions, glm::vec3 *tangents ) const {
+	const unsigned int LANES = CSCI441_INTERNAL::SPLINE_LANES;
+	float step = 1.0f / samplesPerSegment;
+
+	for( unsigned int segment = firstSegment; segment < lastSegment; segment++ ) {
+		const float *c = getCoefficients( segment );
+		unsigned int base = segment * samplesPerSegment;
+
+		// one segment's coefficients against LANES parameters at a time; the loops
+		// over l are straight-line arithmetic on plain arrays so they vectorize
+		for( unsigned int i = 0; i < samplesPerSegment; i += LANES ) {
+			unsigned int lanes = samplesPerSegment - i < LANES ? samplesPerSegment - i : LANES;
+			float t[LANES], px[LANES], py[LANES], pz[LANES], dx[LANES], dy[LANES], dz[LANES];
+			for( unsigned int l = 0; l < LANES; l++ ) {
+				t[l] = (i + l) * step;
+			}
+			for( unsigned int l = 0; l < LANES; l++ ) {
+				px[l] = ((c[0] * t[l] + c[3]) * t[l] + c[6]) * t[l] + c[9];
+				py[l] = ((c[1] * t[l] + c[4]) * t[l] + c[7]) * t[l] + c[10];
+				pz[l] = ((c[2] * t[l] + c[5]) * t[l] + c[8]) * t[l] + c[11];
+				dx[l] = (3.0f * c[0] * t[l] + 2.0f * c[3]) * t[l] + c[6];
+				dy[l] = (3.0f * c[1] * t[l] + 2.0f * c[4]) * t[l] + c[7];
+				dz[l] = (3.0f * c[2] * t[l] + 2.0f * c[5]) * t[l] + c[8];
+			}
+			for( unsigned int l = 0; l < lanes; l++ ) {
+				if( positions != NULL ) positions[ base + i + l ] = glm::vec3( px[l], py[l], pz[l] );
+				if( tangents != NULL ) tangents[ base + i + l ] = glm::vec3( dx[l], dy[l], dz[l] );
+			}
+		}
+	}
+}
+
+template< typename Basis >
+inline void CSCI441::evaluateSplines( const Spline< Basis > * const *splines, const float *parameters, unsigned int count, glm::vec3 *positions, glm::vec3 *tangents ) {
+	unsigned int numThreads = CSCI441_INTERNAL::getSplineThreadCount( count, count / CSCI441_INTERNAL::SPLINE_LANES );
+#ifndef CSCI441_NO_THREADS
+	std::vector< std::thread > workers;
+	for( unsigned int t = 1; t < numThreads; t++ ) {
+		workers.push_back( std::thread( &CSCI441_INTERNAL::evaluateSplinesRange< Basis >, splines, 1, parameters,
+																		(unsigned long long)count * t / numThreads, (unsigned long long)count * (t+1) / numThreads, positions, tangents ) );
+	}
+#endif
+	CSCI441_INTERNAL::evaluateSplinesRange( splines, 1, parameters, 0, count / numThreads, positions, tangents );
+#ifndef CSCI441_NO_THREADS
+	for( size_t t = 0; t < workers.size(); t++ ) {
+		workers[t].join();
+	}
+#endif
+}
+
+template< typename Basis >
+inline void CSCI441_INTERNAL::evaluateSplinesRange( const CSCI441::Spline< Basis > * const *splines, unsigned int splineStride, const float *parameters,
+																									 unsigned int first, unsigned int last, glm::vec3 *positions, glm::vec3 *tangents ) {
+	// scattered parameters each read their own segment, so every one is evaluated on its
+	// own from the packed coefficients; gathering them into lanes measured slower
+	for( unsigned int i = first; i < last; i++ ) {
+		const CSCI441::Spline< Basis > *spline = splines[ i * splineStride ];
+		unsigned int numSegments = spline->getNumSegments();
+		float u = parameters[i] < 0.0f ? 0.0f : (parameters[i] > numSegments ? (float)numSegments : parameters[i]);
+		unsigned int segment = (unsigned int)u;
+		if( segment >= numSegments ) segment = numSegments - 1;
+		const float *c = spline->getCoefficients( segment );
+		u -= segment;
+
+		if( positions != NULL ) {
+			positions[i] = glm::vec3( ((c[0] * u + c[3]) * u + c[6]) * u + c[9],
+																((c[1] * u + c[4]) * u + c[7]) * u + c[10],
+																((c[2] * u + c[5]) * u + c[8]) * u + c[11] );
+		}
+		if( tangents != NULL ) {
+			tangents[i] = glm::vec3( (3.0f * c[0] * u + 2.0f * c[3]) * u + c[6],
+															 (3.0f * c[1] * u + 2.0f * c[4]) * u + c[7],
+															 (3.0f * c[2] * u + 2.0f * c[5]) * u + c[8] );
+		}
+	}
+}
+
+inline unsigned int CSCI441_INTERNAL::getSplineThreadCount( unsigned int work, unsigned int maxThreads ) {
+	unsigned int numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+	if( work >= SPLINE_THREAD_MIN_SAMPLES ) {
+		numThreads = std::thread::hardware_concurrency();
+		if( numThreads > maxThreads ) numThreads = maxThreads;
+		if( numThreads < 1 ) numThreads = 1;
+	}
+#endif
+	return numThreads;
+}
+
+#endif // __CSCI441_SPLINES_HPP__
@@ -19,13 +19,16 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include <vector>
+
 /* Use glew.h instead of gl.h to get all the GL prototypes declared */
 #include <GL/glew.h>
 
-namespace CSCI441_INTERNAL {
+#include <glm/glm.hpp>
 
-	static GLuint vao_teapot;
-	static GLuint vbo_teapot_vertices, ibo_teapot_elements;
+#include <CSCI441/bezierPatch3.hpp>		// for BezierPatchSet
+
+namespace CSCI441_INTERNAL {
 
 	struct vertex { GLfloat x, y, z; };
 	static struct vertex teapot_cp_vertices[] = {
@@ -364,152 +367,44 @@ namespace CSCI441_INTERNAL {
 	  { { 229, 232, 233, 212 }, { 257, 264, 265, 234 }, { 260, 266, 267, 238 }, { 263, 268, 269, 242, } },
 	  // no bottom!
 	};
-	#define RESU 10
-	#define RESV 10
-	static struct vertex teapot_vertices[TEAPOT_NB_PATCHES * RESU*RESV*2];
-	static GLushort teapot_elements[TEAPOT_NB_PATCHES * (RESU-1)*(RESV-1) * 2*3];
-
-	static bool teapotBuilt = false;
-
-	void build_control_points_k(int p, struct vertex control_points_k[][ORDER+1]);
-	struct vertex compute_position(struct vertex control_points_k[][ORDER+1], float u, float v);
-	struct vertex compute_normal(struct vertex control_points_k[][ORDER+1], float u, float v);
-	float bernstein_polynomial(int i, int n, float u);
-	float binomial_coefficient(int i, int n);
-	int factorial(int n);
-
-	inline void build_teapot() {
-	  // Vertices
-	  for (int p = 0; p < TEAPOT_NB_PATCHES; p++) {
-	    struct vertex control_points_k[ORDER+1][ORDER+1];
-	    build_control_points_k(p, control_points_k);
-	    for (int ru = 0; ru <= RESU-1; ru++) {
-	      float u = 1.0 * ru / (RESU-1);
-	      for (int rv = 0; rv <= RESV-1; rv++) {
-		float v = 1.0 * rv / (RESV-1);
-		teapot_vertices[p*RESU*RESV + ru*RESV + rv] = compute_position(control_points_k, u, v);
-		teapot_vertices[TEAPOT_NB_PATCHES * RESU*RESV + p*RESU*RESV + ru*RESV + rv] = compute_normal(control_points_k, u, v);
-	      }
-	    }
-	  }
-
-	  // Elements
-	  int n = 0;
-	  for (int p = 0; p < TEAPOT_NB_PATCHES; p++)
-	    for (int ru = 0; ru < RESU-1; ru++)
-	      for (int rv = 0; rv < RESV-1; rv++) {
-		// 1 square ABCD = 2 triangles ABC + CDA
-		// ABC
-		teapot_elements[n] = p*RESU*RESV +  ru   *RESV +  rv   ; n++;
-		teapot_elements[n] = p*RESU*RESV +  ru   *RESV + (rv+1); n++;
-		teapot_elements[n] = p*RESU*RESV + (ru+1)*RESV + (rv+1); n++;
-		// CDA
-		teapot_elements[n] = p*RESU*RESV + (ru+1)*RESV + (rv+1); n++;
-		teapot_elements[n] = p*RESU*RESV + (ru+1)*RESV +  rv   ; n++;
-		teapot_elements[n] = p*RESU*RESV +  ru   *RESV +  rv   ; n++;
-	      }
-
-	}
-
-	inline void build_control_points_k(int p, struct vertex control_points_k[][ORDER+1]) {
-	  for (int i = 0; i <= ORDER; i++)
-	    for (int j = 0; j <= ORDER; j++)
-	      control_points_k[i][j] = teapot_cp_vertices[teapot_patches[p][i][j] - 1];
-	}
-
-	inline struct vertex compute_position(struct vertex control_points_k[][ORDER+1], float u, float v) {
-	  struct vertex result = { 0.0, 0.0, 0.0 };
-	  for (int i = 0; i <= ORDER; i++) {
-	    float poly_i = bernstein_polynomial(i, ORDER, u);
-	    for (int j = 0; j <= ORDER; j++) {
-	      float poly_j = bernstein_polynomial(j, ORDER, v);
-	      result.x += poly_i * poly_j * control_points_k[i][j].x;
-	      result.y += poly_i * poly_j * control_points_k[i][j].y;
-	      result.z += poly_i * poly_j * control_points_k[i][j].z;
-	    }
-	  }
-	  return result;
-	}
+	// resolution teapot() tessellates at unless told otherwise
+	static const GLint TEAPOT_DEFAULT_RESOLUTION = 10;
 
-	// TODO compute normal based on partial derivatives of surface patch
-	inline struct vertex compute_normal(struct vertex control_points_k[][ORDER+1], float u, float v) {
-	  struct vertex result = { 0.0, 0.0, 0.0 };
-	  for (int i = 0; i <= ORDER; i++) {
-	    float poly_i = bernstein_polynomial(i, ORDER, u);
-	    for (int j = 0; j <= ORDER; j++) {
-	      float poly_j = bernstein_polynomial(j, ORDER, v);
-	      result.x += poly_i * poly_j * control_points_k[i][j].x;
-	      result.y += poly_i * poly_j * control_points_k[i][j].y;
-	      result.z += poly_i * poly_j * control_points_k[i][j].z;
-	    }
-	  }
-	  return result;
-	}
-
-	inline float bernstein_polynomial(int i, int n, float u) {
-	  return binomial_coefficient(i, n) * powf(u, i) * powf(1-u, n-i);
-	}
-
-	inline float binomial_coefficient(int i, int n) {
-	  assert(i >= 0); assert(n >= 0);
-	  return 1.0f * factorial(n) / (factorial(i) * factorial(n-i));
-	}
-	inline int factorial(int n) {
-	  assert(n >= 0);
-	  int result = 1;
-	  for (int i = n; i > 1; i--)
-	    result *= i;
-	  return result;
-	}
-
-	inline int init_resources()
-	{
-	  build_teapot();
-
-		glGenVertexArrays(1, &vao_teapot);
-		glBindVertexArray(vao_teapot);
-
-	  glGenBuffers(1, &vbo_teapot_vertices);
-	  glBindBuffer(GL_ARRAY_BUFFER, vbo_teapot_vertices);
-	  glBufferData(GL_ARRAY_BUFFER, sizeof(teapot_vertices), teapot_vertices, GL_STATIC_DRAW);
+	inline CSCI441::BezierPatchSet* build_teapot() {
+		std::vector< glm::vec3 > controlPoints;
+		for( size_t i = 0; i < sizeof(teapot_cp_vertices) / sizeof(teapot_cp_vertices[0]); i++ ) {
+			controlPoints.push_back( glm::vec3( teapot_cp_vertices[i].x, teapot_cp_vertices[i].y, teapot_cp_vertices[i].z ) );
+		}
 
-	  glGenBuffers(1, &ibo_teapot_elements);
-	  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_teapot_elements);
-	  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(teapot_elements), teapot_elements, GL_STATIC_DRAW);
+		// the patch table is 1-based, and transposed so dP/du x dP/dv points out of the teapot
+		std::vector< GLuint > patchIndices;
+		for( int p = 0; p < TEAPOT_NB_PATCHES; p++ )
+			for( int i = 0; i <= ORDER; i++ )
+				for( int j = 0; j <= ORDER; j++ )
+					patchIndices.push_back( teapot_patches[p][j][i] - 1 );
 
-		teapotBuilt = true;
+		// each part wraps the whole texture once: u runs around the part and v runs down it.
+		// neighbors get adjoining rectangles so their seam samples weld into shared vertices
+		std::vector< glm::vec4 > patchTexCoords;
+		for( int p = 0; p < TEAPOT_NB_PATCHES; p++ ) {
+			int column, numColumns, row, numRows;
+			if( p < 12 )      { column = p % 4; numColumns = 4; row = p / 4;        numRows = 3; }	// rim and body
+			else if( p < 16 ) { column = p % 2; numColumns = 2; row = (p - 12) / 2; numRows = 2; }	// handle
+			else if( p < 20 ) { column = p % 2; numColumns = 2; row = (p - 16) / 2; numRows = 2; }	// spout
+			else              { column = p % 4; numColumns = 4; row = (p - 20) / 4; numRows = 2; }	// lid
+			patchTexCoords.push_back( glm::vec4( (GLfloat)column / numColumns, (GLfloat)row / numRows,
+																					 (GLfloat)(column+1) / numColumns, (GLfloat)(row+1) / numRows ) );
+		}
 
-	  return 1;
+		return new CSCI441::BezierPatchSet( controlPoints, patchIndices, patchTexCoords );
 	}
 
-	inline void teapot( GLdouble size, GLint positionLocation, GLint normalLocation ) {
-		if( !teapotBuilt ) {
-			init_resources();
-		}
-
-		glBindVertexArray( vao_teapot );
-	  // Describe our vertices array to OpenGL (it can't guess its format automatically)
-	  glBindBuffer(GL_ARRAY_BUFFER, vbo_teapot_vertices);
-		glEnableVertexAttribArray(positionLocation);
-	  glVertexAttribPointer(
-	    positionLocation,  // attribute
-	    3,                 // number of elements per vertex, here (x,y,z)
-	    GL_FLOAT,          // the type of each element
-	    GL_FALSE,          // take our values as-is
-	    0,                 // no extra data between each position
-	    0                  // offset of first element
-	  );
-		glEnableVertexAttribArray(normalLocation);
-	  glVertexAttribPointer(
-	    normalLocation,  // attribute
-	    3,                 // number of elements per vertex, here (x,y,z)
-	    GL_FLOAT,          // the type of each element
-	    GL_FALSE,          // take our values as-is
-	    0,                 // no extra data between each position
-	    (void*)(TEAPOT_NB_PATCHES * RESU*RESV)                  // offset of first element
-	  );
+	inline void teapot( GLdouble size, GLint positionLocation, GLint normalLocation, GLint texCoordLocation = -1,
+											GLenum renderMode = GL_FILL, GLint resolution = TEAPOT_DEFAULT_RESOLUTION ) {
+		// built on first use, and one set for every translation unit since this is an inline function's static local
+		static CSCI441::BezierPatchSet *teapot_patch_set = build_teapot();
 
-	  glDrawElements(GL_TRIANGLES, sizeof(teapot_elements)/sizeof(teapot_elements[0]), GL_UNSIGNED_SHORT, 0);
+		teapot_patch_set->draw( resolution, positionLocation, normalLocation, texCoordLocation, renderMode );
 	}
 }
 
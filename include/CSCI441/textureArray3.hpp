@@ -0,0 +1,378 @@
+/** @file textureArray3.hpp
+  * @brief Packs many images into the layers of one array texture for OpenGL 3.0+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	Every image added ends up somewhere in a single GL_TEXTURE_2D_ARRAY, so a
+	*	set of objects that each had their own texture can be drawn with the
+	*	array bound once.  Layers are as wide as the widest image and as tall as
+	*	the tallest.  Each image is placed one of three ways:
+	*
+	*		- an image the size of a layer gets a layer to itself
+	*		- an image that repeats gets a layer to itself, tiled across it, so
+	*		  GL_REPEAT on the layer repeats the image; its size must divide the
+	*		  layer size
+	*		- any other image is packed on shelves beside other small images,
+	*		  inside a gutter of its own edge texels
+	*
+	*	Shelf positions and gutters are multiples of the gutter width, so every
+	*	mipmap level down to the one where the gutter is a single texel keeps
+	*	each image apart from its neighbors.  When any image is packed the array
+	*	stops at that level; otherwise every level is built.
+	*
+	*	An image's texture coordinate (s, t) becomes
+	*
+	*		vec3( region.offset + vec2( s, t ) * region.scale, region.layer )
+	*
+	*	which can be baked into vertex data, as CSCI441::ModelLoader does, or
+	*	applied in a shader.  Sample with a sampler2DArray, binding the array with
+	*	CSCI441::TextureRegistry::bindTexture() so its trilinear, repeating sampler
+	*	comes with it.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
+	*	@warning NOTE: This header file depends upon GLEW
+  */
+
+#ifndef __CSCI441_TEXTUREARRAY_3_HPP__
+#define __CSCI441_TEXTUREARRAY_3_HPP__
+
+#include <GL/glew.h>
+
+#include <CSCI441/textureRegistry3.hpp>
+#include <CSCI441/TextureUtils.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @struct TextureArrayRegion
+		* @brief Where one image landed in a TextureArray
+		*
+		* @var layer		- layer of the array holding the image
+		* @var offset	- texture coordinate of the image's bottom left corner within the layer
+		* @var scale		- size of the image as a fraction of the layer
+		*/
+	struct TextureArrayRegion {
+		GLint layer;
+		GLfloat offset[2];
+		GLfloat scale[2];
+	};
+
+	/** @class TextureArray
+		* @brief Collects images, packs them into array texture layers, and uploads the result
+		*/
+	class TextureArray {
+	public:
+		/** @brief Creates an empty array
+			* @param GLsizei gutter	- texels of edge padding around packed images, rounded up to a power of two (default: 8)
+			*/
+		TextureArray( GLsizei gutter = 8 );
+		/** @brief Frees the array texture
+			*/
+		~TextureArray();
+
+		/** @brief Copies an image in to be packed by the next build()
+			*
+			*	Rows are taken bottom first, as OpenGL expects.  Gray and gray alpha images
+			*	are expanded to RGBA.
+			*
+			* @param const unsigned char* pixels	- tightly packed image
+			* @param int width										- width of the image
+			* @param int height										- height of the image
+			* @param int channels									- 1, 2, 3, or 4 components per pixel
+			* @param bool repeats									- whether the image is sampled outside [0, 1] and must tile (default: false)
+			* @return index of the image to pass to getRegion(), or -1 if the image is empty
+			*/
+		int add( const unsigned char *pixels, int width, int height, int channels, bool repeats = false );
+
+		/** @brief Packs every image added, builds the mipmaps, and uploads the array
+			*
+			*	The copies made by add() are freed afterwards.  Fails without creating a
+			*	texture when no image was added or a repeating image does not tile the layer.
+			*
+			* @param bool srgb	- whether the color channels are sRGB encoded (default: true)
+			* @return true if the array was uploaded
+			*/
+		bool build( bool srgb = true );
+
+		/** @brief Returns where an image was placed by build()
+			* @param int image	- index returned by add()
+			*/
+		TextureArrayRegion getRegion( int image ) const;
+		/** @brief Returns the GL_TEXTURE_2D_ARRAY handle, or 0 before build() succeeds
+			*/
+		GLuint getTextureHandle() const;
+		/** @brief Returns the width of every layer
+			*/
+		GLsizei getWidth() const;
+		/** @brief Returns the height of every layer
+			*/
+		GLsizei getHeight() const;
+		/** @brief Returns the number of layers
+			*/
+		GLsizei getNumLayers() const;
+		/** @brief Returns the number of mipmap levels uploaded
+			*/
+		GLint getNumLevels() const;
+		/** @brief Returns the bytes uploaded across every layer and level
+			*/
+		size_t getSize() const;
+		/** @brief Returns the milliseconds the last build() took
+			*/
+		double getBuildTime() const;
+
+	private:
+		TextureArray( const TextureArray & );
+		TextureArray& operator=( const TextureArray & );
+
+		// an image waiting to be packed, and where it goes
+		struct Image {
+			std::vector< unsigned char > rgba;
+			int width, height;
+			bool repeats;
+			GLint layer;
+			int x, y;			// corner of the image within the layer
+			bool ownLayer;
+		};
+
+		void _compose( const Image &image, unsigned char *layer ) const;
+
+		std::vector< Image > _images;
+		std::vector< TextureArrayRegion > _regions;
+
+		GLuint _textureHandle;
+		GLsizei _gutter, _width, _height, _numLayers;
+		GLint _numLevels;
+		size_t _size;
+		double _buildTime;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	bool compareTextureArrayShelves( const std::pair< int, int > &lhs, const std::pair< int, int > &rhs );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::TextureArray::TextureArray( GLsizei gutter ) : _textureHandle(0), _gutter(1), _width(0), _height(0), _numLayers(0), _numLevels(0), _size(0), _buildTime(0.0) {
+	while( _gutter < gutter ) _gutter *= 2;
+}
+
+inline CSCI441::TextureArray::~TextureArray() {
+	if( _textureHandle != 0 ) {
+		TextureRegistry::unregisterTexture( _textureHandle );
+		glDeleteTextures( 1, &_textureHandle );
+	}
+}
+
+inline int CSCI441::TextureArray::add( const unsigned char *pixels, int width, int height, int channels, bool repeats ) {
+	if( pixels == NULL || width <= 0 || height <= 0 || channels < 1 || channels > 4 ) return -1;
+
+	Image image;
+	image.width = width;
+	image.height = height;
+	image.repeats = repeats;
+	image.layer = -1;
+	image.x = image.y = 0;
+	image.ownLayer = false;
+	image.rgba.resize( (size_t)width * height * 4 );
+
+	const size_t numPixels = (size_t)width * height;
+	for( size_t i = 0; i < numPixels; i++ ) {
+		const unsigned char *source = pixels + i * channels;
+		unsigned char *destination = &image.rgba[i * 4];
+		if( channels < 3 ) {
+			destination[0] = destination[1] = destination[2] = source[0];
+			destination[3] = channels == 2 ? source[1] : 255;
+		} else {
+			destination[0] = source[0];
+			destination[1] = source[1];
+			destination[2] = source[2];
+			destination[3] = channels == 4 ? source[3] : 255;
+		}
+	}
+
+	_images.push_back( image );
+	return (int)_images.size() - 1;
+}
+
+inline bool CSCI441::TextureArray::build( bool srgb ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if( _images.empty() ) return false;
+
+	_width = _height = 0;
+	for( size_t i = 0; i < _images.size(); i++ ) {
+		_width = std::max( _width, (GLsizei)_images[i].width );
+		_height = std::max( _height, (GLsizei)_images[i].height );
+	}
+
+	// whole layers first: images the size of a layer, repeating images, and images too big for a gutter
+	std::vector< std::pair< int, int > > shelved;		// padded height, image
+	bool anyShelved = false;
+	_numLayers = 0;
+	for( size_t i = 0; i < _images.size(); i++ ) {
+		Image &image = _images[i];
+		const int paddedWidth = ( image.width + 2 * _gutter + _gutter - 1 ) / _gutter * _gutter;
+		const int paddedHeight = ( image.height + 2 * _gutter + _gutter - 1 ) / _gutter * _gutter;
+		if( image.repeats && ( _width % image.width != 0 || _height % image.height != 0 ) ) {
+			fprintf( stderr, "[ERROR]: A repeating %dx%d image does not tile a %dx%d texture array layer\n", image.width, image.height, _width, _height );
+			return false;
+		}
+		if( image.repeats || ( image.width == _width && image.height == _height ) || paddedWidth > _width || paddedHeight > _height ) {
+			image.layer = _numLayers++;
+			image.ownLayer = true;
+		} else {
+			shelved.push_back( std::pair< int, int >( paddedHeight, (int)i ) );
+		}
+	}
+
+	// then the small images, tallest first, left to right along shelves
+	std::sort( shelved.begin(), shelved.end(), CSCI441_INTERNAL::compareTextureArrayShelves );
+	int x = 0, y = 0, shelfHeight = 0;
+	for( size_t s = 0; s < shelved.size(); s++ ) {
+		Image &image = _images[ shelved[s].second ];
+		const int paddedWidth = ( image.width + 2 * _gutter + _gutter - 1 ) / _gutter * _gutter;
+		const int paddedHeight = shelved[s].first;
+		if( !anyShelved || x + paddedWidth > _width ) {
+			x = 0;
+			y += shelfHeight;
+			shelfHeight = 0;
+		}
+		if( !anyShelved || y + paddedHeight > _height ) {
+			_numLayers++;
+			x = y = shelfHeight = 0;
+		}
+		image.layer = _numLayers - 1;
+		image.x = x + _gutter;
+		image.y = y + _gutter;
+		x += paddedWidth;
+		shelfHeight = std::max( shelfHeight, paddedHeight );
+		anyShelved = true;
+	}
+
+	_regions.resize( _images.size() );
+	for( size_t i = 0; i < _images.size(); i++ ) {
+		const Image &image = _images[i];
+		_regions[i].layer = image.layer;
+		_regions[i].offset[0] = image.x / (GLfloat)_width;
+		_regions[i].offset[1] = image.y / (GLfloat)_height;
+		_regions[i].scale[0] = image.width / (GLfloat)_width;
+		_regions[i].scale[1] = image.height / (GLfloat)_height;
+	}
+
+	std::vector< std::vector< unsigned char > > layers( _numLayers, std::vector< unsigned char >( (size_t)_width * _height * 4, 0 ) );
+	for( size_t i = 0; i < _images.size(); i++ ) {
+		_compose( _images[i], &layers[ _images[i].layer ][0] );
+	}
+	_images.clear();
+
+	// past this level the gutters are narrower than a texel and neighbors bleed together
+	GLint gutterLevels = 1;
+	for( GLsizei g = _gutter; g > 1; g /= 2 ) gutterLevels++;
+
+	if( _textureHandle == 0 ) glGenTextures( 1, &_textureHandle );
+	glBindTexture( GL_TEXTURE_2D_ARRAY, _textureHandle );
+
+	_size = 0;
+	for( GLsizei layer = 0; layer < _numLayers; layer++ ) {
+		TextureUtils::MipmapChain mipmaps;
+		mipmaps.build( &layers[layer][0], _width, _height, 4, srgb );
+		if( layer == 0 ) {
+			_numLevels = anyShelved ? std::min( gutterLevels, (GLint)mipmaps.getNumLevels() ) : mipmaps.getNumLevels();
+			for( GLint level = 0; level < _numLevels; level++ ) {
+				glTexImage3D( GL_TEXTURE_2D_ARRAY, level, GL_RGBA, mipmaps.getWidth( level ), mipmaps.getHeight( level ), _numLayers, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+			}
+		}
+		for( GLint level = 0; level < _numLevels; level++ ) {
+			glTexSubImage3D( GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, mipmaps.getWidth( level ), mipmaps.getHeight( level ), 1, GL_RGBA, GL_UNSIGNED_BYTE, mipmaps.getLevel( level ) );
+			_size += (size_t)mipmaps.getWidth( level ) * mipmaps.getHeight( level ) * 4;
+		}
+		std::vector< unsigned char >().swap( layers[layer] );
+	}
+
+	glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, _numLevels - 1 );
+	TextureRegistry::registerTexture( _textureHandle, GL_TEXTURE_2D_ARRAY, GL_RGBA, _width, _height, _numLayers, _numLevels,
+									  TextureRegistry::getSampler( _numLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT ) );
+
+	_buildTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+	return true;
+}
+
+inline CSCI441::TextureArrayRegion CSCI441::TextureArray::getRegion( int image ) const {
+	return _regions[image];
+}
+
+inline GLuint CSCI441::TextureArray::getTextureHandle() const {
+	return _textureHandle;
+}
+
+inline GLsizei CSCI441::TextureArray::getWidth() const {
+	return _width;
+}
+
+inline GLsizei CSCI441::TextureArray::getHeight() const {
+	return _height;
+}
+
+inline GLsizei CSCI441::TextureArray::getNumLayers() const {
+	return _numLayers;
+}
+
+inline GLint CSCI441::TextureArray::getNumLevels() const {
+	return _numLevels;
+}
+
+inline size_t CSCI441::TextureArray::getSize() const {
+	return _size;
+}
+
+inline double CSCI441::TextureArray::getBuildTime() const {
+	return _buildTime;
+}
+
+inline void CSCI441::TextureArray::_compose( const Image &image, unsigned char *layer ) const {
+	if( image.ownLayer ) {
+		// repeating images tile the layer; others sit in the corner with their last row and column stretched to the far edges
+		for( GLsizei y = 0; y < _height; y++ ) {
+			const int sourceY = image.repeats ? y % image.height : std::min( (int)y, image.height - 1 );
+			for( GLsizei x = 0; x < _width; x++ ) {
+				const int sourceX = image.repeats ? x % image.width : std::min( (int)x, image.width - 1 );
+				memcpy( layer + ( (size_t)y * _width + x ) * 4, &image.rgba[ ( (size_t)sourceY * image.width + sourceX ) * 4 ], 4 );
+			}
+		}
+		return;
+	}
+
+	// the image and a gutter of its clamped edges on every side
+	for( int y = image.y - _gutter; y < image.y + image.height + _gutter; y++ ) {
+		const int sourceY = std::min( std::max( y - image.y, 0 ), image.height - 1 );
+		for( int x = image.x - _gutter; x < image.x + image.width + _gutter; x++ ) {
+			const int sourceX = std::min( std::max( x - image.x, 0 ), image.width - 1 );
+			memcpy( layer + ( (size_t)y * _width + x ) * 4, &image.rgba[ ( (size_t)sourceY * image.width + sourceX ) * 4 ], 4 );
+		}
+	}
+}
+
+inline bool CSCI441_INTERNAL::compareTextureArrayShelves( const std::pair< int, int > &lhs, const std::pair< int, int > &rhs ) {
+	if( lhs.first != rhs.first ) return lhs.first > rhs.first;
+	return lhs.second < rhs.second;
+}
+
+#endif // __CSCI441_TEXTUREARRAY_3_HPP__
@@ -0,0 +1,556 @@
+/** @file textureCache3.hpp
+  * @brief On-disk cache of textures processed and ready to upload for OpenGL 3.0+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	Decoding a PNG or JPEG, flipping it, building its mipmaps, and
+	*	compressing it costs the same on every run.  The first load of an image
+	*	does that work once and writes the result to a cache file holding every
+	*	level in its final orientation and format.  Later loads map that file
+	*	and hand each level straight to OpenGL.
+	*
+	*	Cache files are named by a hash of the source file's bytes together
+	*	with the processing flags, so editing an image or asking for different
+	*	processing misses the old entry instead of reusing it.  The header
+	*	repeats the hash, size, and flags, and any file that does not match or
+	*	is cut short is rebuilt.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
+	*	@warning NOTE: This header file depends upon GLEW and SOIL
+  */
+
+#ifndef __CSCI441_TEXTURECACHE_3_HPP__
+#define __CSCI441_TEXTURECACHE_3_HPP__
+
+#include <GL/glew.h>
+
+#include <SOIL/SOIL.h>
+
+#include <CSCI441/imageDecoder.hpp>
+#include <CSCI441/imageKernels.hpp>
+#include <CSCI441/textureRegistry3.hpp>
+#include <CSCI441/TextureUtils.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+	/** @namespace TextureCache
+	  * @brief Textures loaded from processed copies kept on disk
+	  */
+	namespace TextureCache {
+		/** @brief Processing applied before an image is cached; combine with |
+			*/
+		enum CacheFlags {
+			CACHE_FLIP_Y = 1,		///< store the bottom row first, as OpenGL expects
+			CACHE_MIPMAPS = 2,		///< build every mipmap level on the CPU
+			CACHE_COMPRESS = 4,		///< store RGB images as BC1 and RGBA images as BC3, if GL_EXT_texture_compression_s3tc is supported
+			CACHE_LINEAR = 8		///< color is not sRGB encoded, so mipmaps are filtered as stored
+		};
+
+		/** @class CachedTexture
+			* @brief A texture's levels, mapped from the cache or processed and then cached
+			*
+			*	On a hit the levels point into the mapped cache file and are never
+			*	copied on the CPU.  On a miss the image is decoded from the source
+			*	file that was already mapped to hash it, processed, written out, and
+			*	uploaded from the same bytes that were written.
+			*/
+		class CachedTexture {
+		public:
+			/** @brief Creates an empty texture
+				*/
+			CachedTexture();
+			/** @brief Unmaps the cache file and frees any processed levels
+				*/
+			~CachedTexture();
+
+			/** @brief Loads an image through the cache, creating its cache file if needed
+				*
+				*	CACHE_COMPRESS is dropped when the context does not support
+				*	GL_EXT_texture_compression_s3tc, so call this after glewInit().
+				*
+				* @param const char* filename		- image SOIL can decode
+				* @param unsigned int flags			- CacheFlags to process the image with (default: flip and mipmaps)
+				* @param const char* directory		- folder holding cache files, created if missing (default: .texcache)
+				* @return true if the image was loaded from either the cache or the source
+				*/
+			bool load( const char *filename, unsigned int flags = CACHE_FLIP_Y | CACHE_MIPMAPS, const char *directory = ".texcache" );
+			/** @brief Unmaps the cache file and frees any processed levels
+				*/
+			void release();
+
+			/** @brief Specifies every level of the bound texture
+				*
+				*	Compressed levels go through glCompressedTexImage2D(), the rest through
+				*	glTexImage2D() with the unpack alignment set to one and then restored.
+				*	GL_TEXTURE_MAX_LEVEL is set to the last level, on the whole cube when
+				*	target is one of its faces.  Nothing is specified if the levels are
+				*	compressed and GL_EXT_texture_compression_s3tc is not supported.
+				*
+				* @param GLenum target	- texture target to specify (default: GL_TEXTURE_2D)
+				*/
+			void upload( GLenum target = GL_TEXTURE_2D ) const;
+
+			/** @brief Returns the width of a level
+				* @param int level	- 0 is the full size image
+				* @return pixels across
+				*/
+			int getWidth( int level = 0 ) const;
+			/** @brief Returns the height of a level
+				* @param int level	- 0 is the full size image
+				* @return pixels down
+				*/
+			int getHeight( int level = 0 ) const;
+			/** @brief Returns the channels the image was decoded with
+				* @return 1 to 4
+				*/
+			int getChannels() const;
+			/** @brief Returns the number of levels held
+				* @return 1 without mipmaps
+				*/
+			int getNumLevels() const;
+			/** @brief Returns the format the levels are stored in
+				* @return GL_RED, GL_RG, GL_RGB, GL_RGBA, or a compressed S3TC format
+				*/
+			GLenum getFormat() const;
+			/** @brief Returns whether the levels are block compressed
+				* @return true for BC1 or BC3 levels
+				*/
+			bool isCompressed() const;
+			/** @brief Returns whether the last load() was served from the cache
+				* @return false if the source had to be decoded
+				*/
+			bool wasCached() const;
+			/** @brief Returns the bytes in all levels together
+				* @return bytes uploaded by upload()
+				*/
+			size_t getSize() const;
+			/** @brief Returns the bytes of one level, rows packed with no padding
+				* @param int level	- 0 is the full size image
+				* @return bytes in the level
+				*/
+			size_t getLevelSize( int level ) const;
+			/** @brief Returns the stored bytes of one level, valid until release()
+				* @param int level	- 0 is the full size image
+				* @return bytes in getFormat()
+				*/
+			const unsigned char* getLevel( int level ) const;
+			/** @brief Returns how long the last load() took, including hashing and writing the cache
+				* @return time in milliseconds
+				*/
+			double getLoadTime() const;
+
+		private:
+			CachedTexture( const CachedTexture& );
+			CachedTexture& operator=( const CachedTexture& );
+
+			bool _parse( const unsigned char *data, size_t size, unsigned long long sourceHash, unsigned long long sourceSize, unsigned int flags );
+
+			CSCI441_INTERNAL::MappedFile _file;
+			std::vector< unsigned char > _built;
+			int _channels;
+			GLenum _format;
+			std::vector< int > _widths, _heights;
+			std::vector< const unsigned char* > _levels;
+			std::vector< size_t > _sizes;
+			bool _cached;
+			double _loadTime;
+		};
+
+		/**	@brief loads and registers a texture through the cache returning a texture handle
+			*
+			*  The processed image is uploaded to a new texture, registered with
+			* CSCI441::TextureRegistry to be read through the shared sampler for the
+			* provided filters and wrapping.  Bind it with TextureRegistry::bindTexture().
+			*
+			*	@param const char* filename - name of texture to load
+			* @param unsigned int flags   - CacheFlags to process the image with (default: flip, mipmaps, and compress)
+			* @param GLenum minFilter     - minification filter to apply (default: GL_LINEAR_MIPMAP_LINEAR)
+			* @param GLenum magFilter     - magnification filter to apply (default: GL_LINEAR)
+			* @param GLenum wrapS         - wrapping to apply to S coordinate (default: GL_REPEAT)
+			* @param GLenum wrapT         - wrapping to apply to T coordinate (default: GL_REPEAT)
+			* @return GLuint 						  - texture handle corresponding to the texture, 0 if it could not be loaded
+			*/
+		GLuint loadAndRegisterTexture( const char *filename,
+										unsigned int flags = CACHE_FLIP_Y | CACHE_MIPMAPS | CACHE_COMPRESS,
+										GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR,
+										GLenum magFilter = GL_LINEAR,
+										GLenum wrapS = GL_REPEAT,
+										GLenum wrapT = GL_REPEAT );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal definitions
+
+namespace CSCI441_INTERNAL {
+	// fixed part of a cache file; a table of level offsets and sizes follows, then the levels
+	struct TextureCacheHeader {
+		char magic[8];
+		unsigned int version, flags;
+		unsigned long long sourceHash, sourceSize;
+		unsigned int width, height, channels, format, numLevels;
+		unsigned int reserved[3];
+	};
+
+	unsigned long long hashTextureSource( const unsigned char *data, size_t size );
+	bool textureCompressionSupported();
+	bool writeTextureCache( const char *directory, const std::string &path, const std::vector< unsigned char > &contents );
+
+	static const char TEXTURE_CACHE_MAGIC[8] = { 'C', 'S', 'C', 'I', '4', '4', '1', 'T' };
+	// bump whenever the processing or layout changes so older files miss
+	static const unsigned int TEXTURE_CACHE_VERSION = 2;
+	// each level starts on this boundary within the file
+	static const size_t TEXTURE_CACHE_ALIGNMENT = 16;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline CSCI441::TextureCache::CachedTexture::CachedTexture() {
+	_file.data = NULL;
+	_file.size = 0;
+	_file.mapped = false;
+	_channels = 0;
+	_format = 0;
+	_cached = false;
+	_loadTime = 0.0;
+}
+
+inline CSCI441::TextureCache::CachedTexture::~CachedTexture() {
+	release();
+}
+
+inline bool CSCI441::TextureCache::CachedTexture::load( const char *filename, unsigned int flags, const char *directory ) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	release();
+
+	// without S3TC the levels are cached uncompressed, under their own name
+	if( ( flags & CACHE_COMPRESS ) && !CSCI441_INTERNAL::textureCompressionSupported() ) {
+		flags &= ~CACHE_COMPRESS;
+	}
+
+	CSCI441_INTERNAL::MappedFile source;
+	if( !CSCI441_INTERNAL::mapFile( filename, source ) ) {
+		fprintf( stderr, "[ERROR]: Could not open texture \"%s\"\n", filename );
+		return false;
+	}
+	const unsigned long long sourceHash = CSCI441_INTERNAL::hashTextureSource( source.data, source.size );
+	const unsigned long long sourceSize = source.size;
+
+	char name[40];
+	sprintf( name, "/%016llx.tex", sourceHash ^ ( (unsigned long long)flags << 56 ) );
+	const std::string path = std::string( directory ) + name;
+
+	if( CSCI441_INTERNAL::mapFile( path.c_str(), _file ) ) {
+		if( _parse( _file.data, _file.size, sourceHash, sourceSize, flags ) ) {
+			CSCI441_INTERNAL::unmapFile( source );
+			_cached = true;
+			_loadTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+			return true;
+		}
+		CSCI441_INTERNAL::unmapFile( _file );
+	}
+
+	int width, height, channels;
+	unsigned char *pixels = CSCI441::ImageDecoder::loadImageFromMemory( source.data, source.size, &width, &height, &channels, SOIL_LOAD_AUTO,
+																		( flags & CACHE_FLIP_Y ) ? CSCI441::ImageDecoder::DECODE_FLIP_Y : 0 );
+	CSCI441_INTERNAL::unmapFile( source );
+	if( !pixels ) {
+		fprintf( stderr, "[ERROR]: Could not decode texture \"%s\"\n[ImageDecoder]: %s\n", filename, CSCI441::ImageDecoder::getLastResult() );
+		return false;
+	}
+
+	// every level as stored, compressed or not
+	CSCI441::TextureUtils::MipmapChain mipmaps;
+	if( flags & CACHE_MIPMAPS ) {
+		mipmaps.build( pixels, width, height, channels, !( flags & CACHE_LINEAR ) );
+	}
+	const int numLevels = ( flags & CACHE_MIPMAPS ) ? mipmaps.getNumLevels() : 1;
+
+	static const GLenum FORMATS[4] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	GLenum format = FORMATS[channels - 1];
+	int blockBytes = 0;
+	if( ( flags & CACHE_COMPRESS ) && channels >= 3 ) {
+		format = channels == 3 ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		blockBytes = channels == 3 ? 8 : 16;
+	}
+
+	// header, level table, then each level on an aligned offset
+	const size_t tableSize = numLevels * 2 * sizeof(unsigned long long);
+	std::vector< unsigned long long > table( numLevels * 2 );
+	size_t offset = sizeof(CSCI441_INTERNAL::TextureCacheHeader) + tableSize;
+	int levelWidth = width, levelHeight = height;
+	for( int level = 0; level < numLevels; level++ ) {
+		offset = ( offset + CSCI441_INTERNAL::TEXTURE_CACHE_ALIGNMENT - 1 ) & ~( CSCI441_INTERNAL::TEXTURE_CACHE_ALIGNMENT - 1 );
+		table[level*2] = offset;
+		table[level*2 + 1] = blockBytes ? CSCI441::ImageKernels::getCompressedSize( levelWidth, levelHeight, blockBytes ) : (size_t)levelWidth * levelHeight * channels;
+		offset += (size_t)table[level*2 + 1];
+		levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+		levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+	}
+	_built.assign( offset, 0 );
+
+	CSCI441_INTERNAL::TextureCacheHeader header;
+	memset( &header, 0, sizeof(header) );
+	memcpy( header.magic, CSCI441_INTERNAL::TEXTURE_CACHE_MAGIC, sizeof(header.magic) );
+	header.version = CSCI441_INTERNAL::TEXTURE_CACHE_VERSION;
+	header.flags = flags;
+	header.sourceHash = sourceHash;
+	header.sourceSize = sourceSize;
+	header.width = width;
+	header.height = height;
+	header.channels = channels;
+	header.format = format;
+	header.numLevels = numLevels;
+	memcpy( &_built[0], &header, sizeof(header) );
+	memcpy( &_built[sizeof(header)], &table[0], tableSize );
+
+	for( int level = 0; level < numLevels; level++ ) {
+		const unsigned char *levelPixels = ( flags & CACHE_MIPMAPS ) ? mipmaps.getLevel( level ) : pixels;
+		levelWidth = ( flags & CACHE_MIPMAPS ) ? mipmaps.getWidth( level ) : width;
+		levelHeight = ( flags & CACHE_MIPMAPS ) ? mipmaps.getHeight( level ) : height;
+		unsigned char *destination = &_built[(size_t)table[level*2]];
+		if( blockBytes == 8 ) {
+			CSCI441::ImageKernels::compressBC1( levelPixels, levelWidth, levelHeight, channels, destination );
+		} else if( blockBytes == 16 ) {
+			CSCI441::ImageKernels::compressBC3( levelPixels, levelWidth, levelHeight, destination );
+		} else {
+			memcpy( destination, levelPixels, (size_t)table[level*2 + 1] );
+		}
+	}
+	CSCI441::ImageDecoder::freeImageData( pixels );
+
+	// a texture that cannot be cached still loads
+	if( !CSCI441_INTERNAL::writeTextureCache( directory, path, _built ) ) {
+		fprintf( stderr, "[WARN]: Could not write texture cache file %s\n", path.c_str() );
+	}
+
+	_parse( &_built[0], _built.size(), sourceHash, sourceSize, flags );
+	_cached = false;
+	_loadTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+	return true;
+}
+
+inline void CSCI441::TextureCache::CachedTexture::release() {
+	if( _file.data ) {
+		CSCI441_INTERNAL::unmapFile( _file );
+	}
+	std::vector< unsigned char >().swap( _built );
+	_widths.clear();
+	_heights.clear();
+	_levels.clear();
+	_sizes.clear();
+	_channels = 0;
+	_format = 0;
+}
+
+inline void CSCI441::TextureCache::CachedTexture::upload( GLenum target ) const {
+	if( isCompressed() && !CSCI441_INTERNAL::textureCompressionSupported() ) {
+		fprintf( stderr, "[ERROR]: Cannot upload compressed texture levels without GL_EXT_texture_compression_s3tc\n" );
+		return;
+	}
+
+	GLint alignment;
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &alignment );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	for( size_t level = 0; level < _levels.size(); level++ ) {
+		if( isCompressed() ) {
+			glCompressedTexImage2D( target, (GLint)level, _format, _widths[level], _heights[level], 0, (GLsizei)_sizes[level], _levels[level] );
+		} else {
+			glTexImage2D( target, (GLint)level, _format, _widths[level], _heights[level], 0, _format, GL_UNSIGNED_BYTE, _levels[level] );
+		}
+	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, alignment );
+	glTexParameteri( CSCI441_INTERNAL::textureParameterTarget( target ), GL_TEXTURE_MAX_LEVEL, (GLint)_levels.size() - 1 );
+}
+
+inline int CSCI441::TextureCache::CachedTexture::getWidth( int level ) const {
+	return _widths[level];
+}
+
+inline int CSCI441::TextureCache::CachedTexture::getHeight( int level ) const {
+	return _heights[level];
+}
+
+inline int CSCI441::TextureCache::CachedTexture::getChannels() const {
+	return _channels;
+}
+
+inline int CSCI441::TextureCache::CachedTexture::getNumLevels() const {
+	return (int)_levels.size();
+}
+
+inline GLenum CSCI441::TextureCache::CachedTexture::getFormat() const {
+	return _format;
+}
+
+inline bool CSCI441::TextureCache::CachedTexture::isCompressed() const {
+	return _format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || _format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+}
+
+inline bool CSCI441::TextureCache::CachedTexture::wasCached() const {
+	return _cached;
+}
+
+inline size_t CSCI441::TextureCache::CachedTexture::getSize() const {
+	size_t size = 0;
+	for( size_t level = 0; level < _sizes.size(); level++ ) {
+		size += _sizes[level];
+	}
+	return size;
+}
+
+inline size_t CSCI441::TextureCache::CachedTexture::getLevelSize( int level ) const {
+	return _sizes[level];
+}
+
+inline const unsigned char* CSCI441::TextureCache::CachedTexture::getLevel( int level ) const {
+	return _levels[level];
+}
+
+inline double CSCI441::TextureCache::CachedTexture::getLoadTime() const {
+	return _loadTime;
+}
+
+inline bool CSCI441::TextureCache::CachedTexture::_parse( const unsigned char *data, size_t size, unsigned long long sourceHash, unsigned long long sourceSize, unsigned int flags ) {
+	CSCI441_INTERNAL::TextureCacheHeader header;
+	if( size < sizeof(header) ) return false;
+	memcpy( &header, data, sizeof(header) );
+	if( memcmp( header.magic, CSCI441_INTERNAL::TEXTURE_CACHE_MAGIC, sizeof(header.magic) ) != 0
+		|| header.version != CSCI441_INTERNAL::TEXTURE_CACHE_VERSION
+		|| header.flags != flags || header.sourceHash != sourceHash || header.sourceSize != sourceSize
+		|| header.channels < 1 || header.channels > 4 || header.width < 1 || header.height < 1
+		|| header.numLevels < 1 || header.numLevels > 32 ) {
+		return false;
+	}
+	const size_t tableSize = header.numLevels * 2 * sizeof(unsigned long long);
+	if( size - sizeof(header) < tableSize ) return false;
+	std::vector< unsigned long long > table( header.numLevels * 2 );
+	memcpy( &table[0], data + sizeof(header), tableSize );
+
+	// every level has to be the size its dimensions and format call for and lie wholly inside the file
+	const int blockBytes = header.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8 : ( header.format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ? 16 : 0 );
+	int width = (int)header.width, height = (int)header.height;
+	for( unsigned int level = 0; level < header.numLevels; level++ ) {
+		const unsigned long long expected = blockBytes ? CSCI441::ImageKernels::getCompressedSize( width, height, blockBytes ) : (size_t)width * height * header.channels;
+		if( table[level*2 + 1] != expected || table[level*2] > size || size - table[level*2] < expected ) {
+			_widths.clear();
+			_heights.clear();
+			_levels.clear();
+			_sizes.clear();
+			return false;
+		}
+		_widths.push_back( width );
+		_heights.push_back( height );
+		_levels.push_back( data + table[level*2] );
+		_sizes.push_back( (size_t)expected );
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+
+	_channels = (int)header.channels;
+	_format = header.format;
+	return true;
+}
+
+// loadAndRegisterTexture() ////////////////////////////////////////////////////
+//
+// Load a texture through the cache and register it with OpenGL
+//
+////////////////////////////////////////////////////////////////////////////////
+inline GLuint CSCI441::TextureCache::loadAndRegisterTexture( const char *filename, unsigned int flags, GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT ) {
+	CachedTexture texture;
+	if( !texture.load( filename, flags ) ) {
+		printf( "[ERROR]: Could not load texture \"%s\"\n", filename );
+		return 0;
+	}
+	printf( "[INFO]: Successfully loaded texture \"%s\" from %s in %.1f ms\n", filename, texture.wasCached() ? "cache" : "source", texture.getLoadTime() );
+
+	GLuint texHandle;
+	glGenTextures( 1, &texHandle );
+	glBindTexture(   GL_TEXTURE_2D,  texHandle );
+	texture.upload();
+	CSCI441::TextureRegistry::registerTexture( texHandle, GL_TEXTURE_2D, texture.getFormat(), texture.getWidth(), texture.getHeight(), 1, texture.getNumLevels(),
+											   CSCI441::TextureRegistry::getSampler( minFilter, magFilter, wrapS, wrapT ), filename );
+	return texHandle;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function implementations
+
+inline unsigned long long CSCI441_INTERNAL::hashTextureSource( const unsigned char *data, size_t size ) {
+	// eight bytes per multiply; only needs to tell edited images apart, not resist tampering
+	unsigned long long hash = 0x9E3779B97F4A7C15ULL ^ size;
+	size_t i = 0;
+	for( ; i + 8 <= size; i += 8 ) {
+		unsigned long long word;
+		memcpy( &word, data + i, 8 );
+		hash = ( hash ^ word ) * 0xFF51AFD7ED558CCDULL;
+		hash ^= hash >> 32;
+	}
+	unsigned long long tail = 0;
+	if( i < size ) {
+		memcpy( &tail, data + i, size - i );
+	}
+	hash = ( hash ^ tail ) * 0xC4CEB9FE1A85EC53ULL;
+	return hash ^ ( hash >> 29 );
+}
+
+inline bool CSCI441_INTERNAL::textureCompressionSupported() {
+	return glewIsSupported( "GL_EXT_texture_compression_s3tc" ) == GL_TRUE;
+}
+
+inline bool CSCI441_INTERNAL::writeTextureCache( const char *directory, const std::string &path, const std::vector< unsigned char > &contents ) {
+#ifdef _WIN32
+	CreateDirectoryA( directory, NULL );
+#else
+	mkdir( directory, 0755 );
+#endif
+	// written under a name no other process or texture is using, then renamed over the
+	// real one, so a reader never maps a file that is still being written or was cut short
+	char suffix[48];
+#ifdef _WIN32
+	sprintf( suffix, ".%lu.%p.tmp", (unsigned long)GetCurrentProcessId(), (const void*)&contents );
+#else
+	sprintf( suffix, ".%ld.%p.tmp", (long)getpid(), (const void*)&contents );
+#endif
+	const std::string temporaryPath = path + suffix;
+
+	FILE *fp = fopen( temporaryPath.c_str(), "wb" );
+	if( !fp ) {
+		return false;
+	}
+	const bool written = fwrite( &contents[0], 1, contents.size(), fp ) == contents.size();
+	if( fclose( fp ) != 0 || !written ) {
+		remove( temporaryPath.c_str() );
+		return false;
+	}
+#ifdef _WIN32
+	const bool renamed = MoveFileExA( temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+#else
+	const bool renamed = rename( temporaryPath.c_str(), path.c_str() ) == 0;
+#endif
+	if( !renamed ) {
+		remove( temporaryPath.c_str() );
+	}
+	return renamed;
+}
+
+#endif // __CSCI441_TEXTURECACHE_3_HPP__
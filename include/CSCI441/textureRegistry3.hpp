@@ -0,0 +1,462 @@
+/** @file textureRegistry3.hpp
+  * @brief Shared sampler objects and an account of every texture's memory and binds in OpenGL 3.3+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	Filtering and wrapping are kept in sampler objects instead of on each
+	*	texture.  getSampler() hands back one sampler for each distinct set of
+	*	filters, wrap modes, and anisotropy, so every texture sampled the same
+	*	way shares it no matter how many there are.
+	*
+	*	registerTexture() records a texture's target, format, size, and levels
+	*	along with the sampler it is read through, and from those estimates the
+	*	bytes it holds on the GPU.  Textures registered here carry no filter or
+	*	wrap state of their own, so bind them with bindTexture(), which binds the
+	*	texture's sampler to the same unit.  A texture that was never registered
+	*	binds with no sampler and keeps its own parameters.
+	*
+	*	Call beginFrame() once at the top of every frame.  getFrameReport() then
+	*	describes the frame before: textures and bytes resident, samplers alive,
+	*	and how many binds it took.  printReport() lists each texture largest
+	*	first with its binds, so textures that take memory and are never drawn,
+	*	or that are bound over and over, stand out.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
+	*	@warning NOTE: This header file depends upon GLEW
+	*	@warning NOTE: Call these functions only from the thread that owns the OpenGL context
+  */
+
+#ifndef __CSCI441_TEXTUREREGISTRY_3_HPP__
+#define __CSCI441_TEXTUREREGISTRY_3_HPP__
+
+#include <GL/glew.h>
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+	/** @namespace TextureRegistry
+	  * @brief Shared samplers and the memory and binds of every registered texture
+	  */
+	namespace TextureRegistry {
+		/** @struct FrameReport
+			* @brief Texture memory resident and binds made over one frame
+			*/
+		struct FrameReport {
+			GLuint numTextures;				///< textures registered
+			size_t residentBytes;			///< estimated bytes of every resident level of every registered texture
+			GLuint numSamplers;				///< distinct samplers created
+			GLuint textureBinds;			///< textures bound through bindTexture()
+			GLuint repeatedBinds;			///< of those, textures already bound to that unit
+			GLuint samplerBinds;			///< samplers bound; one is skipped whenever the unit already had it
+		};
+
+		/** @brief Returns the sampler for a set of filters, wrap modes, and anisotropy, creating it the first time
+			*
+			*	Anisotropy is limited to what the hardware allows and ignored without
+			*	GL_EXT_texture_filter_anisotropic, so requests that come out the same
+			*	share a sampler.
+			*
+			* @param GLenum minFilter			- minification filter (default: GL_LINEAR_MIPMAP_LINEAR)
+			* @param GLenum magFilter			- magnification filter (default: GL_LINEAR)
+			* @param GLenum wrapS				- wrapping for the S coordinate (default: GL_REPEAT)
+			* @param GLenum wrapT				- wrapping for the T coordinate (default: GL_REPEAT)
+			* @param GLenum wrapR				- wrapping for the R coordinate (default: GL_REPEAT)
+			* @param GLfloat maxAnisotropy		- most samples taken along the axis of anisotropy (default: 1, off)
+			* @return GLuint					- sampler handle, owned by the registry
+			*/
+		GLuint getSampler( GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR, GLenum magFilter = GL_LINEAR,
+						   GLenum wrapS = GL_REPEAT, GLenum wrapT = GL_REPEAT, GLenum wrapR = GL_REPEAT,
+						   GLfloat maxAnisotropy = 1.0f );
+
+		/** @brief Records a texture and the sampler it is read through, or updates one already recorded
+			* @param GLuint textureHandle		- texture to record
+			* @param GLenum target				- GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP, or GL_TEXTURE_3D
+			* @param GLenum internalFormat		- format the texture is stored in, sized, unsized, or compressed
+			* @param GLsizei width				- texels across level 0
+			* @param GLsizei height				- texels down level 0
+			* @param GLsizei depth				- layers of an array or texels deep in level 0 of a 3D texture, otherwise 1
+			* @param GLint numLevels			- mipmap levels specified, 1 without mipmaps
+			* @param GLuint sampler				- sampler from getSampler(), or 0 to keep the texture's own parameters
+			* @param const char* name			- what to call the texture in printReport() (default: none)
+			*/
+		void registerTexture( GLuint textureHandle, GLenum target, GLenum internalFormat,
+							  GLsizei width, GLsizei height, GLsizei depth, GLint numLevels,
+							  GLuint sampler, const char *name = "" );
+		/** @brief Counts only the levels from baseLevel on as resident, as for a texture still streaming in
+			* @param GLuint textureHandle		- registered texture
+			* @param GLint baseLevel			- finest level resident
+			*/
+		void setBaseLevel( GLuint textureHandle, GLint baseLevel );
+		/** @brief Forgets a texture; call it alongside glDeleteTextures()
+			* @param GLuint textureHandle		- registered texture
+			*/
+		void unregisterTexture( GLuint textureHandle );
+
+		/** @brief Binds a texture and its sampler to a texture unit
+			*
+			*	The texture is always bound, since other code may have bound something
+			*	else since, but its sampler only when the unit last had a different one.
+			*
+			* @param GLenum textureUnit			- GL_TEXTURE0 + i
+			* @param GLuint textureHandle		- texture to bind; unregistered textures bind to GL_TEXTURE_2D with no sampler
+			*/
+		void bindTexture( GLenum textureUnit, GLuint textureHandle );
+
+		/** @brief Closes the frame's counts, readable from getFrameReport(), and starts new ones
+			*/
+		void beginFrame();
+		/** @brief Returns the counts of the last frame closed by beginFrame()
+			* @return the frame's report
+			*/
+		FrameReport getFrameReport();
+		/** @brief Returns the estimated bytes of a texture's resident levels
+			* @param GLuint textureHandle		- registered texture
+			* @return bytes, 0 if the texture is not registered
+			*/
+		size_t getTextureBytes( GLuint textureHandle );
+		/** @brief Prints the last frame's report and every texture, largest first
+			*/
+		void printReport();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal definitions
+
+namespace CSCI441_INTERNAL {
+	struct TextureSamplerKey {
+		GLenum minFilter, magFilter, wrapS, wrapT, wrapR;
+		GLfloat maxAnisotropy;
+		bool operator<( const TextureSamplerKey &rhs ) const;
+	};
+
+	struct TextureRecord {
+		GLenum target, internalFormat;
+		GLsizei width, height, depth;
+		GLint numLevels, baseLevel;
+		GLuint sampler;
+		size_t bytes;							// of the levels from baseLevel on
+		GLuint binds, lastFrameBinds, totalBinds;
+		std::string name;
+	};
+
+	struct TextureRegistryState {
+		std::map< TextureSamplerKey, GLuint > samplers;
+		std::map< GLuint, TextureRecord > textures;
+		std::map< GLenum, std::pair< GLuint, GLuint > > units;		// texture and sampler last bound through the registry
+		size_t residentBytes;
+		CSCI441::TextureRegistry::FrameReport frame, lastFrame;
+		GLfloat maxAnisotropy;					// 0 until queried, 1 without the extension
+		TextureRegistryState();
+	};
+
+	TextureRegistryState& getTextureRegistryState();
+	size_t estimateTextureBytes( const TextureRecord &record );
+	size_t textureBlockBytes( GLenum internalFormat );
+	size_t textureTexelBytes( GLenum internalFormat );
+	const char* textureFormatName( GLenum internalFormat );
+	const char* textureTargetName( GLenum target );
+	bool compareTextureRecordBytes( const std::pair< GLuint, const TextureRecord* > &lhs, const std::pair< GLuint, const TextureRecord* > &rhs );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline GLuint CSCI441::TextureRegistry::getSampler( GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT, GLenum wrapR, GLfloat maxAnisotropy ) {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+	if( state.maxAnisotropy == 0.0f ) {
+		state.maxAnisotropy = 1.0f;
+		if( glewIsSupported( "GL_EXT_texture_filter_anisotropic" ) ) glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &state.maxAnisotropy );
+	}
+
+	CSCI441_INTERNAL::TextureSamplerKey key;
+	key.minFilter = minFilter;
+	key.magFilter = magFilter;
+	key.wrapS = wrapS;
+	key.wrapT = wrapT;
+	key.wrapR = wrapR;
+	key.maxAnisotropy = std::max( 1.0f, std::min( maxAnisotropy, state.maxAnisotropy ) );
+
+	std::map< CSCI441_INTERNAL::TextureSamplerKey, GLuint >::iterator samplerIter = state.samplers.find( key );
+	if( samplerIter != state.samplers.end() ) return samplerIter->second;
+
+	GLuint sampler;
+	glGenSamplers( 1, &sampler );
+	glSamplerParameteri( sampler, GL_TEXTURE_MIN_FILTER, minFilter );
+	glSamplerParameteri( sampler, GL_TEXTURE_MAG_FILTER, magFilter );
+	glSamplerParameteri( sampler, GL_TEXTURE_WRAP_S, wrapS );
+	glSamplerParameteri( sampler, GL_TEXTURE_WRAP_T, wrapT );
+	glSamplerParameteri( sampler, GL_TEXTURE_WRAP_R, wrapR );
+	if( key.maxAnisotropy > 1.0f ) glSamplerParameterf( sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, key.maxAnisotropy );
+	state.samplers.insert( std::pair< CSCI441_INTERNAL::TextureSamplerKey, GLuint >( key, sampler ) );
+	return sampler;
+}
+
+inline void CSCI441::TextureRegistry::registerTexture( GLuint textureHandle, GLenum target, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint numLevels, GLuint sampler, const char *name ) {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+
+	// updating keeps the bind counts
+	std::map< GLuint, CSCI441_INTERNAL::TextureRecord >::iterator textureIter = state.textures.find( textureHandle );
+	if( textureIter == state.textures.end() ) {
+		CSCI441_INTERNAL::TextureRecord record;
+		record.bytes = 0;
+		record.binds = record.lastFrameBinds = record.totalBinds = 0;
+		textureIter = state.textures.insert( std::pair< GLuint, CSCI441_INTERNAL::TextureRecord >( textureHandle, record ) ).first;
+	}
+
+	CSCI441_INTERNAL::TextureRecord &record = textureIter->second;
+	record.target = target;
+	record.internalFormat = internalFormat;
+	record.width = width;
+	record.height = height;
+	record.depth = depth;
+	record.numLevels = numLevels;
+	record.baseLevel = 0;
+	record.sampler = sampler;
+	record.name = name != NULL ? name : "";
+
+	state.residentBytes -= record.bytes;
+	record.bytes = CSCI441_INTERNAL::estimateTextureBytes( record );
+	state.residentBytes += record.bytes;
+}
+
+inline void CSCI441::TextureRegistry::setBaseLevel( GLuint textureHandle, GLint baseLevel ) {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+	std::map< GLuint, CSCI441_INTERNAL::TextureRecord >::iterator textureIter = state.textures.find( textureHandle );
+	if( textureIter == state.textures.end() ) return;
+
+	CSCI441_INTERNAL::TextureRecord &record = textureIter->second;
+	record.baseLevel = baseLevel;
+	state.residentBytes -= record.bytes;
+	record.bytes = CSCI441_INTERNAL::estimateTextureBytes( record );
+	state.residentBytes += record.bytes;
+}
+
+inline void CSCI441::TextureRegistry::unregisterTexture( GLuint textureHandle ) {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+	std::map< GLuint, CSCI441_INTERNAL::TextureRecord >::iterator textureIter = state.textures.find( textureHandle );
+	if( textureIter == state.textures.end() ) return;
+
+	state.residentBytes -= textureIter->second.bytes;
+	state.textures.erase( textureIter );
+}
+
+inline void CSCI441::TextureRegistry::bindTexture( GLenum textureUnit, GLuint textureHandle ) {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+
+	GLenum target = GL_TEXTURE_2D;
+	GLuint sampler = 0;
+	std::map< GLuint, CSCI441_INTERNAL::TextureRecord >::iterator textureIter = state.textures.find( textureHandle );
+	if( textureIter != state.textures.end() ) {
+		target = textureIter->second.target;
+		sampler = textureIter->second.sampler;
+		textureIter->second.binds++;
+		textureIter->second.totalBinds++;
+	}
+
+	// a unit seen for the first time has no sampler bound
+	std::map< GLenum, std::pair< GLuint, GLuint > >::iterator unitIter = state.units.find( textureUnit );
+	if( unitIter == state.units.end() ) {
+		unitIter = state.units.insert( std::pair< GLenum, std::pair< GLuint, GLuint > >( textureUnit, std::pair< GLuint, GLuint >( 0, 0 ) ) ).first;
+	}
+
+	glActiveTexture( textureUnit );
+	glBindTexture( target, textureHandle );
+	state.frame.textureBinds++;
+	if( unitIter->second.first == textureHandle ) state.frame.repeatedBinds++;
+	unitIter->second.first = textureHandle;
+
+	if( unitIter->second.second != sampler ) {
+		glBindSampler( textureUnit - GL_TEXTURE0, sampler );
+		state.frame.samplerBinds++;
+		unitIter->second.second = sampler;
+	}
+}
+
+inline void CSCI441::TextureRegistry::beginFrame() {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+	state.frame.numTextures = (GLuint)state.textures.size();
+	state.frame.residentBytes = state.residentBytes;
+	state.frame.numSamplers = (GLuint)state.samplers.size();
+	state.lastFrame = state.frame;
+
+	state.frame.textureBinds = state.frame.repeatedBinds = state.frame.samplerBinds = 0;
+	for( std::map< GLuint, CSCI441_INTERNAL::TextureRecord >::iterator textureIter = state.textures.begin(); textureIter != state.textures.end(); textureIter++ ) {
+		textureIter->second.lastFrameBinds = textureIter->second.binds;
+		textureIter->second.binds = 0;
+	}
+}
+
+inline CSCI441::TextureRegistry::FrameReport CSCI441::TextureRegistry::getFrameReport() {
+	return CSCI441_INTERNAL::getTextureRegistryState().lastFrame;
+}
+
+inline size_t CSCI441::TextureRegistry::getTextureBytes( GLuint textureHandle ) {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+	std::map< GLuint, CSCI441_INTERNAL::TextureRecord >::const_iterator textureIter = state.textures.find( textureHandle );
+	return textureIter != state.textures.end() ? textureIter->second.bytes : 0;
+}
+
+inline void CSCI441::TextureRegistry::printReport() {
+	CSCI441_INTERNAL::TextureRegistryState &state = CSCI441_INTERNAL::getTextureRegistryState();
+	const FrameReport &frame = state.lastFrame;
+	printf( "[INFO]: Texture memory: %u textures, %.2f MB resident, %u samplers\n", frame.numTextures, frame.residentBytes / 1048576.0, frame.numSamplers );
+	printf( "[INFO]: Last frame: %u texture binds (%u repeated), %u sampler binds\n", frame.textureBinds, frame.repeatedBinds, frame.samplerBinds );
+
+	std::vector< std::pair< GLuint, const CSCI441_INTERNAL::TextureRecord* > > textures;
+	for( std::map< GLuint, CSCI441_INTERNAL::TextureRecord >::const_iterator textureIter = state.textures.begin(); textureIter != state.textures.end(); textureIter++ ) {
+		textures.push_back( std::pair< GLuint, const CSCI441_INTERNAL::TextureRecord* >( textureIter->first, &textureIter->second ) );
+	}
+	std::sort( textures.begin(), textures.end(), CSCI441_INTERNAL::compareTextureRecordBytes );
+
+	for( size_t i = 0; i < textures.size(); i++ ) {
+		const CSCI441_INTERNAL::TextureRecord &record = *textures[i].second;
+		printf( "[INFO]: %9.2f KB  %4u  %-20s %-14s %5dx%-5d x%-3d levels %d-%d  binds %u (%u total)%s  %s\n",
+				record.bytes / 1024.0, textures[i].first, CSCI441_INTERNAL::textureTargetName( record.target ), CSCI441_INTERNAL::textureFormatName( record.internalFormat ),
+				record.width, record.height, record.depth, record.baseLevel, record.numLevels - 1,
+				record.lastFrameBinds, record.totalBinds, record.totalBinds == 0 ? "  never bound" : "", record.name.c_str() );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function implementations
+
+inline bool CSCI441_INTERNAL::TextureSamplerKey::operator<( const TextureSamplerKey &rhs ) const {
+	if( minFilter != rhs.minFilter ) return minFilter < rhs.minFilter;
+	if( magFilter != rhs.magFilter ) return magFilter < rhs.magFilter;
+	if( wrapS != rhs.wrapS ) return wrapS < rhs.wrapS;
+	if( wrapT != rhs.wrapT ) return wrapT < rhs.wrapT;
+	if( wrapR != rhs.wrapR ) return wrapR < rhs.wrapR;
+	return maxAnisotropy < rhs.maxAnisotropy;
+}
+
+inline CSCI441_INTERNAL::TextureRegistryState::TextureRegistryState() {
+	residentBytes = 0;
+	frame.numTextures = 0;
+	frame.residentBytes = 0;
+	frame.numSamplers = 0;
+	frame.textureBinds = frame.repeatedBinds = frame.samplerBinds = 0;
+	lastFrame = frame;
+	maxAnisotropy = 0.0f;
+}
+
+inline CSCI441_INTERNAL::TextureRegistryState& CSCI441_INTERNAL::getTextureRegistryState() {
+	static TextureRegistryState state;
+	return state;
+}
+
+inline size_t CSCI441_INTERNAL::estimateTextureBytes( const TextureRecord &record ) {
+	const size_t blockBytes = textureBlockBytes( record.internalFormat );
+	const size_t texelBytes = textureTexelBytes( record.internalFormat );
+
+	size_t bytes = 0;
+	for( GLint level = std::max( record.baseLevel, 0 ); level < record.numLevels; level++ ) {
+		const size_t width = (size_t)std::max( record.width >> level, 1 );
+		const size_t height = (size_t)std::max( record.height >> level, 1 );
+		// only a 3D texture shrinks in depth; array layers stay put
+		const size_t depth = (size_t)( record.target == GL_TEXTURE_3D ? std::max( record.depth >> level, 1 ) : std::max( record.depth, 1 ) );
+		if( blockBytes != 0 ) {
+			bytes += ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * blockBytes * depth;
+		} else {
+			bytes += width * height * depth * texelBytes;
+		}
+	}
+	return record.target == GL_TEXTURE_CUBE_MAP ? bytes * 6 : bytes;
+}
+
+inline size_t CSCI441_INTERNAL::textureBlockBytes( GLenum internalFormat ) {
+	switch( internalFormat ) {
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RED_RGTC1:
+		case GL_COMPRESSED_SIGNED_RED_RGTC1:
+			return 8;
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_RG_RGTC2:
+		case GL_COMPRESSED_SIGNED_RG_RGTC2:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+inline size_t CSCI441_INTERNAL::textureTexelBytes( GLenum internalFormat ) {
+	switch( internalFormat ) {
+		case GL_RED: case GL_R8:
+			return 1;
+		case GL_RG: case GL_RG8: case GL_R16F:
+			return 2;
+		case GL_RGBA16F: case GL_RGB16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8:
+			return 8;
+		case GL_RGBA32F: case GL_RGB32F:
+			return 16;
+		default:
+			// drivers store three channel texels in four bytes, and so most formats come to four
+			return 4;
+	}
+}
+
+inline const char* CSCI441_INTERNAL::textureFormatName( GLenum internalFormat ) {
+	switch( internalFormat ) {
+		case GL_RED:								return "RED";
+		case GL_R8:									return "R8";
+		case GL_RG:									return "RG";
+		case GL_RG8:								return "RG8";
+		case GL_RGB:								return "RGB";
+		case GL_RGB8:								return "RGB8";
+		case GL_SRGB8:								return "SRGB8";
+		case GL_RGBA:								return "RGBA";
+		case GL_RGBA8:								return "RGBA8";
+		case GL_SRGB8_ALPHA8:						return "SRGB8_ALPHA8";
+		case GL_RGBA16F:							return "RGBA16F";
+		case GL_RGBA32F:							return "RGBA32F";
+		case GL_DEPTH_COMPONENT:					return "DEPTH";
+		case GL_DEPTH_COMPONENT24:					return "DEPTH24";
+		case GL_DEPTH24_STENCIL8:					return "DEPTH24_STENCIL8";
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:		return "BC1";
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:		return "BC1A";
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:		return "BC2";
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:		return "BC3";
+		case GL_COMPRESSED_RED_RGTC1:				return "BC4";
+		case GL_COMPRESSED_RG_RGTC2:				return "BC5";
+		default:									return "other";
+	}
+}
+
+inline const char* CSCI441_INTERNAL::textureTargetName( GLenum target ) {
+	switch( target ) {
+		case GL_TEXTURE_2D:				return "GL_TEXTURE_2D";
+		case GL_TEXTURE_2D_ARRAY:		return "GL_TEXTURE_2D_ARRAY";
+		case GL_TEXTURE_CUBE_MAP:		return "GL_TEXTURE_CUBE_MAP";
+		case GL_TEXTURE_3D:				return "GL_TEXTURE_3D";
+		default:						return "other";
+	}
+}
+
+inline bool CSCI441_INTERNAL::compareTextureRecordBytes( const std::pair< GLuint, const TextureRecord* > &lhs, const std::pair< GLuint, const TextureRecord* > &rhs ) {
+	if( lhs.second->bytes != rhs.second->bytes ) return lhs.second->bytes > rhs.second->bytes;
+	return lhs.first < rhs.first;
+}
+
+#endif // __CSCI441_TEXTUREREGISTRY_3_HPP__
@@ -0,0 +1,630 @@
+/** @file textureStreamer3.hpp
+  * @brief Textures that start as a placeholder and sharpen a few rows per frame in OpenGL 3.2+
+	* @author Dr. Jeffrey Paone
+	* @date Last Edit: 19 Oct 2026
+	* @version 1.0
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	request() hands back a texture handle at once, holding a single gray
+	*	texel, and queues the file for a pool of worker threads that load it
+	*	through CSCI441::TextureCache, mipmaps included.  Nothing is decoded or
+	*	uploaded on the calling thread, so requesting every texture a scene
+	*	needs costs next to nothing at startup.
+	*
+	*	update() must be called once per frame from the thread that owns the
+	*	OpenGL context.  Each decoded texture gets its smallest level first and
+	*	then every larger one in turn, with GL_TEXTURE_BASE_LEVEL following the
+	*	finest complete level so the texture is always sampled whole.  Levels go
+	*	up in runs of rows until the per frame byte budget is spent, so even a
+	*	large image never costs one frame more than the budget.  The texture
+	*	that looks blurriest goes first: the one whose sharpest resident level is
+	*	stretched over the most screen pixels, as given by setScreenSize().  A
+	*	texture stops sharpening once its resident level is as wide as it
+	*	appears on screen.
+	*
+	*	Rows are copied into a ring of pixel unpack buffers, one per frame, and
+	*	uploaded from there so the driver does not copy them again.  Each buffer
+	*	is fenced after its frame and only refilled once the GPU is done with it;
+	*	if it is still in use, that frame uploads nothing instead of waiting.
+	*
+	*	Every texture is registered with CSCI441::TextureRegistry, its resident
+	*	bytes following the levels as they arrive, and is sampled through the
+	*	registry's shared sampler for its filters and wrapping.
+	*
+	*	@warning NOTE: This header file will only work with OpenGL 3.3+
+	*	@warning NOTE: This header file depends upon GLEW, SOIL, and glm
+	*	@warning NOTE: Textures are decoded on std::thread workers.  Define CSCI441_NO_THREADS
+	*	before including this file on toolchains without std::thread support; each update()
+	*	then decodes one texture itself
+  */
+
+#ifndef __CSCI441_TEXTURESTREAMER_3_HPP__
+#define __CSCI441_TEXTURESTREAMER_3_HPP__
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <CSCI441/textureCache3.hpp>
+#include <CSCI441/textureRegistry3.hpp>
+
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef CSCI441_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+	/** @class TextureStreamer
+		* @brief Decodes textures in the background and uploads them a level at a time within a per frame budget
+		*/
+	class TextureStreamer {
+	public:
+		/** @brief Starts the worker threads; OpenGL is first touched by request()
+			* @param unsigned int flags				- TextureCache::CacheFlags to load with; mipmaps are always built (default: flip and compress)
+			* @param GLuint numStagingBuffers	- frames of uploads that may be in flight on the GPU at once (default: 3)
+			*/
+		TextureStreamer( unsigned int flags = TextureCache::CACHE_FLIP_Y | TextureCache::CACHE_COMPRESS, GLuint numStagingBuffers = 3 );
+		/** @brief Stops the worker threads and frees every texture, staging buffer, and fence
+			*/
+		~TextureStreamer();
+
+		/** @brief Sets how many bytes update() may send to the GPU each frame
+			*
+			*	Each staging buffer is this size, and it never drops below 64 KB so one row
+			*	of the widest texture OpenGL allows always fits.
+			*
+			* @param GLuint bytesPerFrame	- upload budget (default: 512 KB)
+			*/
+		void setUploadBudget( GLuint bytesPerFrame );
+
+		/** @brief Creates a texture to be streamed in from a file
+			*
+			*	The texture is a single gray texel until its levels arrive and may be
+			*	bound and sampled at once; bind it with TextureRegistry::bindTexture() so
+			*	its sampler comes with it.  It belongs to the streamer and is deleted
+			*	with it.
+			*
+			* @param const char* filename	- image SOIL can decode
+			* @param GLenum minFilter			- minification filter to apply (default: GL_LINEAR_MIPMAP_LINEAR)
+			* @param GLenum magFilter			- magnification filter to apply (default: GL_LINEAR)
+			* @param GLenum wrapS					- wrapping to apply to S coordinate (default: GL_REPEAT)
+			* @param GLenum wrapT					- wrapping to apply to T coordinate (default: GL_REPEAT)
+			* @return GLuint							- texture handle
+			*/
+		GLuint request( const char *filename, GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR, GLenum magFilter = GL_LINEAR, GLenum wrapS = GL_REPEAT, GLenum wrapT = GL_REPEAT );
+		/** @brief Sets how many pixels across a texture covers on screen
+			*
+			*	Decides both how soon the texture sharpens and the finest level it needs.
+			*	Until it is given, a texture is treated as shown at full size.
+			*
+			* @param GLuint textureHandle	- handle returned by request()
+			* @param GLfloat pixels				- width on screen, such as from projectedSize()
+			*/
+		void setScreenSize( GLuint textureHandle, GLfloat pixels );
+
+		/** @brief Collects decoded textures and uploads the most needed rows within the budget
+			*/
+		void update();
+		/** @brief Waits for every decode and uploads every level left, ignoring the budget
+			*
+			*	For loading screens and tools that need the textures whole right away.
+			*/
+		void finish();
+
+		/** @brief Returns the finest level of a texture that is being sampled
+			* @param GLuint textureHandle	- handle returned by request()
+			* @return level, or -1 while only the placeholder texel is resident
+			*/
+		GLint getResidentLevel( GLuint textureHandle ) const;
+		/** @brief Returns the number of textures still decoding or waiting on sharper levels
+			* @return number of textures streaming
+			*/
+		GLuint getNumStreaming() const;
+		/** @brief Returns the number of bytes the last update() uploaded
+			* @return bytes uploaded
+			*/
+		GLuint getLastUploadBytes() const;
+		/** @brief Returns the number of frames that uploaded nothing because the GPU still held the staging buffer
+			* @return number of skipped frames
+			*/
+		GLuint getNumSkippedFrames() const;
+
+		/** @brief Estimates how many pixels across a sphere covers on screen
+			* @param glm::mat4 viewMatrix				- view matrix of the camera
+			* @param glm::mat4 projectionMatrix	- perspective projection matrix of the camera
+			* @param glm::vec3 center						- world position of the center of the sphere
+			* @param GLfloat radius							- radius of the sphere
+			* @param GLint viewportHeight				- height of the viewport in pixels
+			* @return diameter on screen in pixels, FLT_MAX when the camera is inside the sphere
+			*/
+		static GLfloat projectedSize( const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, glm::vec3 center, GLfloat radius, GLint viewportHeight );
+
+	private:
+		TextureStreamer( const TextureStreamer & );
+		TextureStreamer& operator=( const TextureStreamer & );
+
+		struct Stream {
+			std::string filename;
+			TextureCache::CachedTexture *texture;	// decoded levels, freed once level 0 is resident
+			GLint residentLevel;						// finest level sampled, -1 for the placeholder
+			GLint rowsUploaded;							// rows of the level below it already uploaded
+			GLfloat screenSize;							// pixels across on screen, negative until given
+			GLuint sampler;								// shared sampler for its filters and wrapping
+			bool decoded;
+		};
+
+		// rows of one level copied into this frame's staging buffer
+		struct Strip {
+			GLuint textureHandle;
+			GLint level, firstRow, numRows;
+			size_t offset;
+		};
+
+		GLint _wantedLevel( const Stream &stream ) const;
+		GLfloat _blurriness( const Stream &stream ) const;
+		void _collectFinished();
+		void _stream();
+		void _releaseFinished();
+		void _registerLevels( GLuint textureHandle, GLint baseLevel );
+#ifndef CSCI441_NO_THREADS
+		void _work();
+#endif
+
+		unsigned int _flags;
+		GLuint _uploadBudget;
+		std::map< GLuint, Stream > _streams;
+
+		// shared with the workers, guarded by _mutex
+		std::deque< std::pair< GLuint, std::string > > _queue;
+		GLuint _numInFlight;
+		std::vector< std::pair< GLuint, TextureCache::CachedTexture* > > _finished;
+#ifndef CSCI441_NO_THREADS
+		std::mutex _mutex;
+		std::condition_variable _wake, _decoded;
+		std::vector< std::thread > _workers;
+		bool _stopping;
+#endif
+
+		// ring of pixel unpack buffers, each fenced after the frame that filled it
+		std::vector< GLuint > _stagingBuffers;
+		std::vector< GLsync > _stagingFences;
+		GLuint _stagingSize, _nextStaging;
+
+		GLuint _lastUploadBytes, _numSkippedFrames;
+	};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	GLint textureStreamRows( const CSCI441::TextureCache::CachedTexture &texture, GLint level );
+	void defineStreamedLevel( const CSCI441::TextureCache::CachedTexture &texture, GLint level );
+	void uploadStreamedRows( const CSCI441::TextureCache::CachedTexture &texture, GLint level, GLint firstRow, GLint numRows, const void *pixels );
+
+	// the smallest budget that still holds a row 16384 RGBA texels wide
+	static const GLuint TEXTURE_STREAM_MIN_BUDGET = 64 * 1024;
+	// staging offsets stay aligned for any format
+	static const size_t TEXTURE_STREAM_ALIGNMENT = 16;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::TextureStreamer::TextureStreamer( unsigned int flags, GLuint numStagingBuffers ) {
+	// the levels are what gets streamed, so they are always built
+	_flags = flags | TextureCache::CACHE_MIPMAPS;
+	_uploadBudget = 512 * 1024;
+	_numInFlight = 0;
+	_stagingFences.resize( numStagingBuffers < 1 ? 1 : numStagingBuffers, (GLsync)0 );
+	_stagingSize = 0;
+	_nextStaging = 0;
+	_lastUploadBytes = _numSkippedFrames = 0;
+
+#ifndef CSCI441_NO_THREADS
+	// leave a core for the thread that renders
+	_stopping = false;
+	GLuint numWorkers = std::thread::hardware_concurrency();
+	numWorkers = numWorkers > 1 ? numWorkers - 1 : 1;
+	for( GLuint w = 0; w < numWorkers; w++ ) {
+		_workers.push_back( std::thread( &TextureStreamer::_work, this ) );
+	}
+#endif
+}
+
+inline CSCI441::TextureStreamer::~TextureStreamer() {
+#ifndef CSCI441_NO_THREADS
+	{
+		std::lock_guard< std::mutex > lock( _mutex );
+		_stopping = true;
+		_queue.clear();
+	}
+	_wake.notify_all();
+	for( size_t w = 0; w < _workers.size(); w++ ) {
+		_workers[w].join();
+	}
+#endif
+	for( size_t i = 0; i < _finished.size(); i++ ) delete _finished[i].second;
+	for( std::map< GLuint, Stream >::iterator streamIter = _streams.begin(); streamIter != _streams.end(); streamIter++ ) {
+		delete streamIter->second.texture;
+		TextureRegistry::unregisterTexture( streamIter->first );
+		glDeleteTextures( 1, &streamIter->first );
+	}
+	for( size_t s = 0; s < _stagingFences.size(); s++ ) {
+		if( _stagingFences[s] != 0 ) glDeleteSync( _stagingFences[s] );
+	}
+	if( !_stagingBuffers.empty() ) glDeleteBuffers( (GLsizei)_stagingBuffers.size(), &_stagingBuffers[0] );
+}
+
+inline void CSCI441::TextureStreamer::setUploadBudget( GLuint bytesPerFrame ) {
+	_uploadBudget = std::max( bytesPerFrame, CSCI441_INTERNAL::TEXTURE_STREAM_MIN_BUDGET );
+}
+
+inline GLuint CSCI441::TextureStreamer::request( const char *filename, GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT ) {
+	const unsigned char gray[4] = { 128, 128, 128, 255 };
+
+	GLuint textureHandle;
+	glGenTextures( 1, &textureHandle );
+	glBindTexture( GL_TEXTURE_2D, textureHandle );
+	glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0 );
+
+	Stream stream;
+	stream.filename = filename;
+	stream.texture = NULL;
+	stream.residentLevel = -1;
+	stream.rowsUploaded = 0;
+	stream.screenSize = -1.0f;
+	stream.sampler = TextureRegistry::getSampler( minFilter, magFilter, wrapS, wrapT );
+	stream.decoded = false;
+	TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, GL_RGBA, 1, 1, 1, 1, stream.sampler, filename );
+	_streams.insert( std::pair< GLuint, Stream >( textureHandle, stream ) );
+
+	{
+#ifndef CSCI441_NO_THREADS
+		std::lock_guard< std::mutex > lock( _mutex );
+#endif
+		_queue.push_back( std::pair< GLuint, std::string >( textureHandle, stream.filename ) );
+	}
+#ifndef CSCI441_NO_THREADS
+	_wake.notify_one();
+#endif
+	return textureHandle;
+}
+
+inline void CSCI441::TextureStreamer::setScreenSize( GLuint textureHandle, GLfloat pixels ) {
+	std::map< GLuint, Stream >::iterator streamIter = _streams.find( textureHandle );
+	if( streamIter != _streams.end() ) streamIter->second.screenSize = pixels;
+}
+
+inline void CSCI441::TextureStreamer::update() {
+#ifdef CSCI441_NO_THREADS
+	if( !_queue.empty() ) {
+		TextureCache::CachedTexture *texture = new TextureCache::CachedTexture();
+		if( !texture->load( _queue.front().second.c_str(), _flags ) ) {
+			delete texture;
+			texture = NULL;
+		}
+		_finished.push_back( std::pair< GLuint, TextureCache::CachedTexture* >( _queue.front().first, texture ) );
+		_queue.pop_front();
+	}
+#endif
+	_collectFinished();
+	_stream();
+	_releaseFinished();
+}
+
+inline void CSCI441::TextureStreamer::finish() {
+#ifndef CSCI441_NO_THREADS
+	{
+		std::unique_lock< std::mutex > lock( _mutex );
+		while( !_queue.empty() || _numInFlight > 0 ) {
+			_decoded.wait( lock );
+		}
+	}
+#else
+	while( !_queue.empty() ) update();
+#endif
+	_collectFinished();
+
+	GLint boundTexture, alignment;
+	glGetIntegerv( GL_TEXTURE_BINDING_2D, &boundTexture );
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &alignment );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+	// whatever is left of every level, straight from memory
+	for( std::map< GLuint, Stream >::iterator streamIter = _streams.begin(); streamIter != _streams.end(); streamIter++ ) {
+		Stream &stream = streamIter->second;
+		if( stream.texture == NULL ) continue;
+
+		const TextureCache::CachedTexture &texture = *stream.texture;
+		glBindTexture( GL_TEXTURE_2D, streamIter->first );
+		for( GLint level = stream.residentLevel == -1 ? texture.getNumLevels() - 1 : stream.residentLevel - 1; level >= 0; level-- ) {
+			const GLint numRows = CSCI441_INTERNAL::textureStreamRows( texture, level );
+			const size_t rowBytes = texture.getLevelSize( level ) / numRows;
+			if( stream.rowsUploaded == 0 ) CSCI441_INTERNAL::defineStreamedLevel( texture, level );
+			CSCI441_INTERNAL::uploadStreamedRows( texture, level, stream.rowsUploaded, numRows - stream.rowsUploaded, texture.getLevel( level ) + stream.rowsUploaded * rowBytes );
+			stream.rowsUploaded = 0;
+		}
+		stream.residentLevel = 0;
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0 );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.getNumLevels() - 1 );
+		_registerLevels( streamIter->first, 0 );
+	}
+
+	glPixelStorei( GL_UNPACK_ALIGNMENT, alignment );
+	glBindTexture( GL_TEXTURE_2D, boundTexture );
+	_releaseFinished();
+}
+
+inline GLint CSCI441::TextureStreamer::getResidentLevel( GLuint textureHandle ) const {
+	std::map< GLuint, Stream >::const_iterator streamIter = _streams.find( textureHandle );
+	return streamIter != _streams.end() ? streamIter->second.residentLevel : -1;
+}
+
+inline GLuint CSCI441::TextureStreamer::getNumStreaming() const {
+	GLuint numStreaming = 0;
+	for( std::map< GLuint, Stream >::const_iterator streamIter = _streams.begin(); streamIter != _streams.end(); streamIter++ ) {
+		const Stream &stream = streamIter->second;
+		if( !stream.decoded || ( stream.texture != NULL && _blurriness( stream ) > 0.0f ) ) numStreaming++;
+	}
+	return numStreaming;
+}
+
+inline GLuint CSCI441::TextureStreamer::getLastUploadBytes() const {
+	return _lastUploadBytes;
+}
+
+inline GLuint CSCI441::TextureStreamer::getNumSkippedFrames() const {
+	return _numSkippedFrames;
+}
+
+inline GLfloat CSCI441::TextureStreamer::projectedSize( const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, glm::vec3 center, GLfloat radius, GLint viewportHeight ) {
+	// distance in front of the camera; the projection scales it to half the viewport
+	GLfloat depth = -( viewMatrix * glm::vec4( center, 1.0f ) ).z;
+	if( depth <= radius ) return FLT_MAX;
+	return radius * projectionMatrix[1][1] / depth * viewportHeight;
+}
+
+inline GLint CSCI441::TextureStreamer::_wantedLevel( const Stream &stream ) const {
+	// the smallest level still at least as wide as the texture appears
+	GLint level = 0;
+	if( stream.screenSize >= 0.0f ) {
+		while( level + 1 < stream.texture->getNumLevels() && stream.texture->getWidth( level + 1 ) >= stream.screenSize ) level++;
+	}
+	return level;
+}
+
+inline GLfloat CSCI441::TextureStreamer::_blurriness( const Stream &stream ) const {
+	// screen pixels per texel of the resident level; 0 once no sharper level is wanted
+	if( stream.residentLevel == -1 ) return FLT_MAX;
+	if( stream.residentLevel <= _wantedLevel( stream ) ) return 0.0f;
+	GLfloat screenSize = stream.screenSize >= 0.0f ? stream.screenSize : (GLfloat)stream.texture->getWidth( 0 );
+	return screenSize / stream.texture->getWidth( stream.residentLevel );
+}
+
+inline void CSCI441::TextureStreamer::_collectFinished() {
+	std::vector< std::pair< GLuint, TextureCache::CachedTexture* > > finished;
+	{
+#ifndef CSCI441_NO_THREADS
+		std::lock_guard< std::mutex > lock( _mutex );
+#endif
+		finished.swap( _finished );
+	}
+	for( size_t i = 0; i < finished.size(); i++ ) {
+		Stream &stream = _streams[ finished[i].first ];
+		stream.decoded = true;
+		stream.texture = finished[i].second;
+		if( stream.texture == NULL ) fprintf( stderr, "[ERROR]: Could not stream texture \"%s\"\n", stream.filename.c_str() );
+	}
+}
+
+inline void CSCI441::TextureStreamer::_stream() {
+	_lastUploadBytes = 0;
+
+	// blurriest first
+	std::vector< std::pair< GLfloat, GLuint > > order;
+	for( std::map< GLuint, Stream >::iterator streamIter = _streams.begin(); streamIter != _streams.end(); streamIter++ ) {
+		if( streamIter->second.texture == NULL ) continue;
+		GLfloat blurriness = _blurriness( streamIter->second );
+		if( blurriness > 0.0f ) order.push_back( std::pair< GLfloat, GLuint >( -blurriness, streamIter->first ) );
+	}
+	if( order.empty() ) return;
+	std::sort( order.begin(), order.end() );
+
+	if( _stagingBuffers.empty() ) {
+		_stagingBuffers.resize( _stagingFences.size() );
+		glGenBuffers( (GLsizei)_stagingBuffers.size(), &_stagingBuffers[0] );
+	}
+	if( _stagingSize != _uploadBudget ) {
+		// orphaning the old storage leaves any upload still reading it alone
+		_stagingSize = _uploadBudget;
+		for( size_t s = 0; s < _stagingBuffers.size(); s++ ) {
+			glBindBuffer( GL_PIXEL_UNPACK_BUFFER, _stagingBuffers[s] );
+			glBufferData( GL_PIXEL_UNPACK_BUFFER, _stagingSize, NULL, GL_STREAM_DRAW );
+			if( _stagingFences[s] != 0 ) glDeleteSync( _stagingFences[s] );
+			_stagingFences[s] = 0;
+		}
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+	}
+
+	// this buffer was filled a ring's length of frames ago; rather than wait on it, upload nothing this frame
+	GLsync &fence = _stagingFences[ _nextStaging ];
+	if( fence != 0 ) {
+		if( glClientWaitSync( fence, 0, 0 ) == GL_TIMEOUT_EXPIRED ) {
+			_numSkippedFrames++;
+			return;
+		}
+		glDeleteSync( fence );
+		fence = 0;
+	}
+
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, _stagingBuffers[ _nextStaging ] );
+	unsigned char *staging = (unsigned char*)glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, _stagingSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT );
+	if( staging == NULL ) {
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+		return;
+	}
+
+	// as many rows as fit, each texture's levels smallest first
+	std::vector< Strip > strips;
+	size_t used = 0;
+	for( size_t i = 0; i < order.size() && used < _stagingSize; i++ ) {
+		Stream &stream = _streams[ order[i].second ];
+		const TextureCache::CachedTexture &texture = *stream.texture;
+		while( stream.residentLevel == -1 || stream.residentLevel > _wantedLevel( stream ) ) {
+			const GLint level = stream.residentLevel == -1 ? texture.getNumLevels() - 1 : stream.residentLevel - 1;
+			const GLint numRows = CSCI441_INTERNAL::textureStreamRows( texture, level );
+			const size_t rowBytes = texture.getLevelSize( level ) / numRows;
+			const size_t offset = std::min( ( used + CSCI441_INTERNAL::TEXTURE_STREAM_ALIGNMENT - 1 ) & ~( CSCI441_INTERNAL::TEXTURE_STREAM_ALIGNMENT - 1 ), (size_t)_stagingSize );
+			const GLint rows = std::min( numRows - stream.rowsUploaded, (GLint)( ( _stagingSize - offset ) / rowBytes ) );
+			if( rows <= 0 ) {
+				used = _stagingSize;
+				break;
+			}
+
+			memcpy( staging + offset, texture.getLevel( level ) + stream.rowsUploaded * rowBytes, rows * rowBytes );
+			Strip strip;
+			strip.textureHandle = order[i].second;
+			strip.level = level;
+			strip.firstRow = stream.rowsUploaded;
+			strip.numRows = rows;
+			strip.offset = offset;
+			strips.push_back( strip );
+			used = offset + rows * rowBytes;
+			_lastUploadBytes += rows * rowBytes;
+
+			stream.rowsUploaded += rows;
+			if( stream.rowsUploaded < numRows ) break;
+			stream.residentLevel = level;
+			stream.rowsUploaded = 0;
+		}
+	}
+	glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+
+	GLint boundTexture, alignment;
+	glGetIntegerv( GL_TEXTURE_BINDING_2D, &boundTexture );
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &alignment );
+
+	// storage for a level is defined before its first rows, while no unpack buffer is bound
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+	for( size_t s = 0; s < strips.size(); s++ ) {
+		if( strips[s].firstRow != 0 ) continue;
+		glBindTexture( GL_TEXTURE_2D, strips[s].textureHandle );
+		CSCI441_INTERNAL::defineStreamedLevel( *_streams[ strips[s].textureHandle ].texture, strips[s].level );
+	}
+
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, _stagingBuffers[ _nextStaging ] );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	for( size_t s = 0; s < strips.size(); s++ ) {
+		const TextureCache::CachedTexture &texture = *_streams[ strips[s].textureHandle ].texture;
+		glBindTexture( GL_TEXTURE_2D, strips[s].textureHandle );
+		CSCI441_INTERNAL::uploadStreamedRows( texture, strips[s].level, strips[s].firstRow, strips[s].numRows, (const void*)strips[s].offset );
+
+		// sample from a level only once every row of it is in
+		if( strips[s].firstRow + strips[s].numRows == CSCI441_INTERNAL::textureStreamRows( texture, strips[s].level ) ) {
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, strips[s].level );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.getNumLevels() - 1 );
+			_registerLevels( strips[s].textureHandle, strips[s].level );
+		}
+	}
+	glPixelStorei( GL_UNPACK_ALIGNMENT, alignment );
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+	glBindTexture( GL_TEXTURE_2D, boundTexture );
+
+	fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	_nextStaging = ( _nextStaging + 1 ) % _stagingBuffers.size();
+}
+
+inline void CSCI441::TextureStreamer::_releaseFinished() {
+	// once level 0 is in, the decoded copy is never needed again
+	for( std::map< GLuint, Stream >::iterator streamIter = _streams.begin(); streamIter != _streams.end(); streamIter++ ) {
+		Stream &stream = streamIter->second;
+		if( stream.texture != NULL && stream.residentLevel == 0 ) {
+			delete stream.texture;
+			stream.texture = NULL;
+		}
+	}
+}
+
+inline void CSCI441::TextureStreamer::_registerLevels( GLuint textureHandle, GLint baseLevel ) {
+	// the decoded size replaces the placeholder, counted from the finest level resident
+	const Stream &stream = _streams[ textureHandle ];
+	const TextureCache::CachedTexture &texture = *stream.texture;
+	TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, texture.getFormat(), texture.getWidth(), texture.getHeight(), 1, texture.getNumLevels(), stream.sampler, stream.filename.c_str() );
+	TextureRegistry::setBaseLevel( textureHandle, baseLevel );
+}
+
+#ifndef CSCI441_NO_THREADS
+inline void CSCI441::TextureStreamer::_work() {
+	std::unique_lock< std::mutex > lock( _mutex );
+	while( true ) {
+		while( !_stopping && _queue.empty() ) {
+			_wake.wait( lock );
+		}
+		if( _stopping ) return;
+
+		std::pair< GLuint, std::string > job = _queue.front();
+		_queue.pop_front();
+		_numInFlight++;
+
+		lock.unlock();
+		TextureCache::CachedTexture *texture = new TextureCache::CachedTexture();
+		if( !texture->load( job.second.c_str(), _flags ) ) {
+			delete texture;
+			texture = NULL;
+		}
+		lock.lock();
+
+		_numInFlight--;
+		_finished.push_back( std::pair< GLuint, TextureCache::CachedTexture* >( job.first, texture ) );
+		_decoded.notify_all();
+	}
+}
+#endif
+
+inline GLint CSCI441_INTERNAL::textureStreamRows( const CSCI441::TextureCache::CachedTexture &texture, GLint level ) {
+	// compressed levels go up a row of 4x4 blocks at a time
+	return texture.isCompressed() ? ( texture.getHeight( level ) + 3 ) / 4 : texture.getHeight( level );
+}
+
+inline void CSCI441_INTERNAL::defineStreamedLevel( const CSCI441::TextureCache::CachedTexture &texture, GLint level ) {
+	if( texture.isCompressed() ) {
+		glCompressedTexImage2D( GL_TEXTURE_2D, level, texture.getFormat(), texture.getWidth( level ), texture.getHeight( level ), 0, (GLsizei)texture.getLevelSize( level ), NULL );
+	} else {
+		glTexImage2D( GL_TEXTURE_2D, level, texture.getFormat(), texture.getWidth( level ), texture.getHeight( level ), 0, texture.getFormat(), GL_UNSIGNED_BYTE, NULL );
+	}
+}
+
+inline void CSCI441_INTERNAL::uploadStreamedRows( const CSCI441::TextureCache::CachedTexture &texture, GLint level, GLint firstRow, GLint numRows, const void *pixels ) {
+	const GLint numLevelRows = textureStreamRows( texture, level );
+	const size_t rowBytes = texture.getLevelSize( level ) / numLevelRows;
+	if( texture.isCompressed() ) {
+		// the last row of blocks may hang past a height that is not a multiple of four
+		const GLint y = firstRow * 4;
+		const GLint height = std::min( numRows * 4, texture.getHeight( level ) - y );
+		glCompressedTexSubImage2D( GL_TEXTURE_2D, level, 0, y, texture.getWidth( level ), height, texture.getFormat(), (GLsizei)( numRows * rowBytes ), pixels );
+	} else {
+		glTexSubImage2D( GL_TEXTURE_2D, level, 0, firstRow, texture.getWidth( level ), numRows, texture.getFormat(), GL_UNSIGNED_BYTE, pixels );
+	}
+}
+
+#endif // __CSCI441_TEXTURESTREAMER_3_HPP__
@@ -0,0 +1,39 @@
+#ifndef _ARC_LENGTH_TABLE_H_
+#define _ARC_LENGTH_TABLE_H_ 1
+
+#include "BezierCurve.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// arc length lookup for a piecewise cubic Bezier curve.  every segment is split
+// into a fixed number of intervals whose lengths are integrated with 5 point
+// Gauss-Legendre quadrature and summed into one cumulative table.  a distance
+// along the curve maps back to the curve parameter by a binary search of the
+// table followed by Newton steps inside the interval it lands in
+class ArcLengthTable {
+public:
+
+	// CONSTRUCTORS / DESTRUCTORS
+  ArcLengthTable();
+
+	// MISCELLANEOUS
+  void build( const BezierCurve &curve, unsigned int intervalsPerSegment = 16 );
+  float getLength() const;
+
+  float parameterAtDistance( float distance ) const;		// returns t in [0, numSegments] for BezierCurve::evaluate()
+  void parametersAtDistances( const float *distances, float *parameters, unsigned int count ) const;
+
+private:
+  void _measureIntervals( unsigned int firstSegment, unsigned int lastSegment );
+  double _speed( const glm::vec3 *p, double t ) const;
+  double _integrate( const glm::vec3 *p, double a, double b ) const;
+  float _parameterInInterval( unsigned int interval, double distance ) const;
+
+  std::vector<glm::vec3> _controlPoints;
+  std::vector<double> _distances;				// distance from the start at t = interval / _intervalsPerSegment
+  unsigned int _intervalsPerSegment;
+};
+
+#endif	// _ARC_LENGTH_TABLE_H_
@@ -0,0 +1,63 @@
+#ifndef _BEZIER_CURVE_H_
+#define _BEZIER_CURVE_H_ 1
+
+#include <CSCI441/splines.hpp>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// piecewise cubic Bezier curve.  segment s uses control points 3s..3s+3, so
+// neighboring segments share their end points.  the curve is evaluated once
+// into a cached polyline and only segments whose control points changed are
+// evaluated again before the next draw.  segments are either sampled uniformly
+// or flattened adaptively by de Casteljau subdivision until every piece is
+// within a flatness tolerance of its chord
+class BezierCurve {
+public:
+
+	// CONSTRUCTORS / DESTRUCTORS
+  BezierCurve();
+
+	// MISCELLANEOUS
+  void setControlPoints( const std::vector<glm::vec3> &controlPoints );
+  void setControlPoint( unsigned int index, glm::vec3 point );
+  const std::vector<glm::vec3>& getControlPoints() const;
+  unsigned int getNumSegments() const;
+
+  void setResolution( unsigned int resolution );	// line segments per curve segment
+  void setFlatnessTolerance( float tolerance );		// > 0 subdivides adaptively to this world space error
+  unsigned int getNumVertices();
+
+  // world space tolerance that projects to the given number of pixels at a distance from the camera
+  static float toleranceForPixels( float pixels, float distance, float fovy, int viewportHeight );
+
+  glm::vec3 evaluate( float t ) const;				// t in [0, numSegments]
+  glm::vec3 tangent( float t ) const;
+  void evaluate( const float *t, unsigned int count, glm::vec3 *positions, glm::vec3 *tangents = NULL ) const;	// many followers at once
+  void draw();										// one glDrawArrays() of the cached polyline
+
+private:
+  // dirty segments evaluated by one worker; segment firstSegment + i owns points[ starts[i], starts[i+1] )
+  struct Evaluation {
+    unsigned int firstSegment, lastSegment;
+    std::vector<glm::vec3> points;
+    std::vector<unsigned int> starts;
+  };
+
+  void _updatePolyline();
+  void _evaluateSegments( Evaluation *evaluation ) const;
+  void _evaluateSegment( unsigned int segment, std::vector<glm::vec3> &points ) const;
+  void _flattenSegment( glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, int depth, std::vector<glm::vec3> &points ) const;
+  void _markAllDirty();
+
+  CSCI441::BezierSpline _spline;					// control points and per segment coefficients
+  std::vector<glm::vec3> _polyline;
+  std::vector<unsigned int> _segmentOffsets;		// segment s owns _polyline[ offsets[s], offsets[s+1] )
+  std::vector<bool> _dirtySegments;
+  unsigned int _resolution;
+  float _tolerance;
+  bool _dirty;
+};
+
+#endif	// _BEZIER_CURVE_H_
@@ -0,0 +1,33 @@
+#ifndef _CONTROL_POINT_READER_H_
+#define _CONTROL_POINT_READER_H_ 1
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// loads control points from a memory mapped file.  two formats are understood:
+//   text   - an optional point count on the first line followed by one x,y,z
+//            triple per line (commas and/or whitespace separate the values).
+//            a line with more or fewer than three numbers fails the load
+//   binary - the four bytes "CPB1", a little endian 32 bit point count, then
+//            count packed x,y,z 32 bit floats
+// large text files are split at line boundaries and parsed across threads
+class ControlPointReader {
+public:
+  static bool load( const char *filename, std::vector<glm::vec3> &points );
+  static bool saveBinary( const char *filename, const std::vector<glm::vec3> &points );
+
+private:
+  struct Chunk {
+    const char *begin, *end;
+    std::vector<glm::vec3> points;
+    const char *badLine;			// start of the first line without exactly three numbers, or NULL
+  };
+
+  static bool _loadBinary( const char *data, size_t size, std::vector<glm::vec3> &points );
+  static bool _loadText( const char *data, size_t size, std::vector<glm::vec3> &points );
+  static void _parseChunk( Chunk *chunk );
+  static const char* _parseFloat( const char *s, const char *end, float &value );
+};
+
+#endif	// _CONTROL_POINT_READER_H_
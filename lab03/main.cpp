@@ -38,6 +38,10 @@
 #include <vector>				// for vector
 using namespace std;
 
+#include "include/BezierCurve.h"
+#include "include/ArcLengthTable.h"
+#include "include/ControlPointReader.h"
+
 //*************************************************************************************
 //
 // Global Parameters
@@ -55,8 +59,12 @@ glm::vec3 camAngles;               					// camera DIRECTION in spherical coordin
 glm::vec3 camDir; 			                    // camera DIRECTION in cartesian coordinates
 
 vector<glm::vec3> controlPoints;
+BezierCurve bezierCurve;							// cached polyline of our control points
+ArcLengthTable arcLengthTable;						// distance along the curve to curve parameter
 float trackPointVal = 0.0f;
-float resolution = 10000;
+float trackDistance = 0.0f;							// how far the follower has traveled along the curve
+float trackSpeed = 0.02f;							// distance the follower moves each frame
+float flatnessPixels = 0.25f;						// largest on screen error allowed in the curve
 int numSegments = 0;
 int numPoints = 0;
 
@@ -73,21 +81,12 @@ int numPoints = 0;
 bool loadControlPoints( char* filename ) {
 	// TODO #02: read in control points from file.  Make sure the file can be
 	// opened and handle it appropriately.  return false if there is an error
-	ifstream inputFile(filename);
-    if(inputFile.fail()) {
-        return false;
-    }
-
-    inputFile >> numPoints;
-
-    string x, y, z;
-	for(int i = 0; i < numPoints; i++) {
-        getline(inputFile, x, ',');
-        getline(inputFile, y, ',');
-        getline(inputFile, z);
-        //cout << x << y << z;
-        controlPoints.push_back(glm::vec3(stoi(x), stoi(y), stoi(z)));
+	// the file is memory mapped and parsed as floats, either the text x,y,z
+	// format or a binary file written by ControlPointReader::saveBinary()
+	if( !ControlPointReader::load( filename, controlPoints ) ) {
+		return false;
 	}
+	numPoints = controlPoints.size();
 
 	return true;
 }
@@ -108,49 +107,6 @@ void recomputeOrientation() {
     camDir = glm::normalize( camDir );
 }
 
-// evaluateBezierCurve() ////////////////////////////////////////////////////////
-//
-// Computes a location along a Bezier Curve.
-//
-////////////////////////////////////////////////////////////////////////////////
-glm::vec3 evaluateBezierCurve( glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, float t ) {
-	glm::vec3 point(0,0,0);
-
-	// TODO #06: Compute a point along a Bezier curve
-    point.x = pow((1.0f - t), 3) * p0.x + pow((1.0f - t), 2) * p1.x * 3.0f * t + (1.0f - t) * (pow(t, 2)) * 3.0 * p2.x +
-              pow(t, 3) * p3.x;
-    point.y = pow((1.0f - t), 3) * p0.y + pow((1.0f - t), 2) * p1.y * 3.0f * t + (1.0f - t) * (pow(t, 2)) * 3.0 * p2.y +
-              pow(t, 3) * p3.y;
-    point.z = pow((1.0f - t), 3) * p0.z + pow((1.0f - t), 2) * p1.z * 3.0f * t + (1.0f - t) * (pow(t, 2)) * 3.0 * p2.z +
-              pow(t, 3) * p3.z;
-	return point;
-}
-
-// renderBezierCurve() //////////////////////////////////////////////////////////
-//
-// Responsible for drawing a Bezier Curve as defined by four control points.
-//  Breaks the curve into n segments as specified by the resolution.
-//
-////////////////////////////////////////////////////////////////////////////////
-void renderBezierCurve( glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, int resolution ) {
-    // TODO #05: Draw the Bezier Curve!
-
-
-    glm::vec3 point;
-    glBegin(GL_LINE_STRIP); {
-        glLineWidth(3.0f);
-        glColor4f(0.0f, 0.0f,1.0f,1.0f);
-        //cout << resolution << endl;
-        for(float t = 0.0000000; t <= 1.00; t = t + float(1.000f/resolution)) {
-            //if (t == 1) {cout << "t = " << t;}
-            point = evaluateBezierCurve(p0,p1,p2,p3,t);
-            //cout << point.x<<point.y<<point.z<<endl;
-            glVertex3f(point.x, point.y, point.z);
-        }
-
-    }glEnd();
-}
-
 //*************************************************************************************
 // Event Callbacks
 
@@ -301,15 +257,17 @@ void renderScene(void)  {
     } glEnd();
 
 	// TODO #05: Draw the Bezier Curve!
-	float t = resolution;
-	int i = 0;
-   for (int i = 0; (i + 3) < numPoints; i += 3) {
-        glm::vec3 vec = controlPoints[i];
-        glm::vec3 vec2 = controlPoints[i + 1];
-        glm::vec3 vec33 = controlPoints[i + 2];
-        glm::vec3 vec44 = controlPoints[i + 3];
-        renderBezierCurve(vec, vec2, vec33, vec44, t);
-    }
+	// the curve is only evaluated again when its control points change
+	glLineWidth(3.0f);
+	glColor4f(0.0f, 0.0f, 1.0f, 1.0f);
+	bezierCurve.draw();
+
+	// follower moving along the curve at a constant speed
+	transMtx = glm::translate(glm::mat4(1.0f), bezierCurve.evaluate(trackPointVal));
+	glMultMatrixf(&transMtx[0][0]);
+	glColor4f(1.0f, 0.0f, 0.0f, 1.0f);
+	CSCI441::drawSolidSphere(0.25, 16, 16);
+	glMultMatrixf(&(inverse(transMtx))[0][0]);
    glEnable(GL_LIGHTING);
 }
 
@@ -452,6 +410,12 @@ int main( int argc, char *argv[] ) {
     }
 
     delete fileName;
+
+    // flatten adaptively: straight runs take a few vertices, tight bends take many
+    bezierCurve.setFlatnessTolerance( BezierCurve::toleranceForPixels( flatnessPixels, glm::length(camPos), glm::radians(45.0f), windowHeight ) );
+    bezierCurve.setControlPoints(controlPoints);
+    numSegments = bezierCurve.getNumSegments();
+    arcLengthTable.build(bezierCurve);
 	//  This is our draw loop - all rendering is done here.  We use a loop to keep the window open
 	//	until the user decides to close the window and quit the program.  Without a loop, the
 	//	window will display once and then the program exits.
@@ -492,9 +456,11 @@ int main( int argc, char *argv[] ) {
 		glfwSwapBuffers(window);// flush the OpenGL commands and make sure they get rendered!
 		glfwPollEvents();				// check for any events and signal to redraw screen
 
-		trackPointVal += 0.01f;
-		if( trackPointVal > numSegments )
-			trackPointVal = 0.0f;
+		// step by distance rather than by t so the speed does not depend on control point spacing
+		trackDistance += trackSpeed;
+		if( trackDistance > arcLengthTable.getLength() )
+			trackDistance = 0.0f;
+		trackPointVal = arcLengthTable.parameterAtDistance( trackDistance );
 	}
 
 	glfwDestroyWindow( window );// clean up and close our window
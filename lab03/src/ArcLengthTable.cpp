@@ -0,0 +1,136 @@
+#include "../include/ArcLengthTable.h"
+
+#include <algorithm>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+// 5 point Gauss-Legendre rule on [-1, 1]; exact for polynomials up to degree 9
+static const double GAUSS_NODES[5]   = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+static const double GAUSS_WEIGHTS[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+
+// below this many intervals a table is not worth spreading across threads
+static const unsigned int THREAD_MIN_INTERVALS = 16384;
+
+// the guess from linear interpolation is already close, two steps reach float precision
+static const int NEWTON_ITERATIONS = 2;
+
+ArcLengthTable::ArcLengthTable() {
+    _intervalsPerSegment = 16;
+}
+
+void ArcLengthTable::build( const BezierCurve &curve, unsigned int intervalsPerSegment ) {
+    _controlPoints = curve.getControlPoints();
+    _intervalsPerSegment = intervalsPerSegment < 1 ? 1 : intervalsPerSegment;
+
+    unsigned int numSegments = curve.getNumSegments();
+    _distances.assign( numSegments * _intervalsPerSegment + 1, 0.0 );
+    if( numSegments == 0 ) return;
+
+    // each interval length lands in _distances[interval+1] and is summed afterwards
+    unsigned int numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+    if( _distances.size() >= THREAD_MIN_INTERVALS ) {
+        numThreads = std::thread::hardware_concurrency();
+        if( numThreads < 1 ) numThreads = 1;
+        if( numThreads > numSegments ) numThreads = numSegments;
+    }
+
+    std::vector< std::thread > workers;
+    for( unsigned int t = 1; t < numThreads; t++ )
+        workers.push_back( std::thread( &ArcLengthTable::_measureIntervals, this, numSegments * t / numThreads, numSegments * (t+1) / numThreads ) );
+#endif
+    _measureIntervals( 0, numSegments / numThreads );
+#ifndef CSCI441_NO_THREADS
+    for( unsigned int t = 0; t < workers.size(); t++ )
+        workers[t].join();
+#endif
+
+    for( unsigned int i = 1; i < _distances.size(); i++ )
+        _distances[i] += _distances[i-1];
+}
+
+float ArcLengthTable::getLength() const {
+    return _distances.empty() ? 0.0f : (float)_distances.back();
+}
+
+float ArcLengthTable::parameterAtDistance( float distance ) const {
+    if( _distances.size() < 2 ) return 0.0f;
+
+    // last table entry at or below the distance
+    unsigned int interval = std::upper_bound( _distances.begin(), _distances.end(), (double)distance ) - _distances.begin();
+    interval = interval == 0 ? 0 : interval - 1;
+    if( interval >= _distances.size() - 1 ) interval = _distances.size() - 2;
+
+    return _parameterInInterval( interval, distance );
+}
+
+void ArcLengthTable::parametersAtDistances( const float *distances, float *parameters, unsigned int count ) const {
+    if( _distances.size() < 2 ) {
+        std::fill( parameters, parameters + count, 0.0f );
+        return;
+    }
+
+    // followers on one path tend to be near each other, so try the interval of the
+    // previous query and its neighbor before falling back to the binary search
+    unsigned int lastInterval = _distances.size() - 2;
+    unsigned int interval = 0;
+    for( unsigned int i = 0; i < count; i++ ) {
+        double distance = distances[i];
+        if( distance >= _distances[interval] && distance < _distances[interval+1] ) {
+            // same interval
+        } else if( interval < lastInterval && distance >= _distances[interval+1] && distance < _distances[interval+2] ) {
+            interval++;
+        } else {
+            interval = std::upper_bound( _distances.begin(), _distances.end(), distance ) - _distances.begin();
+            interval = interval == 0 ? 0 : interval - 1;
+            if( interval > lastInterval ) interval = lastInterval;
+        }
+        parameters[i] = _parameterInInterval( interval, distance );
+    }
+}
+
+void ArcLengthTable::_measureIntervals( unsigned int firstSegment, unsigned int lastSegment ) {
+    double step = 1.0 / _intervalsPerSegment;
+    for( unsigned int segment = firstSegment; segment < lastSegment; segment++ ) {
+        const glm::vec3 *p = &_controlPoints[ segment*3 ];
+        for( unsigned int i = 0; i < _intervalsPerSegment; i++ )
+            _distances[ segment * _intervalsPerSegment + i + 1 ] = _integrate( p, i * step, (i+1) * step );
+    }
+}
+
+double ArcLengthTable::_speed( const glm::vec3 *p, double t ) const {
+    // |P'(t)| with P'(t) = 3[ (1-t)^2 (p1-p0) + 2t(1-t) (p2-p1) + t^2 (p3-p2) ]
+    double s = 1.0 - t;
+    glm::dvec3 d = 3.0 * ( s*s * glm::dvec3(p[1] - p[0]) + 2.0*s*t * glm::dvec3(p[2] - p[1]) + t*t * glm::dvec3(p[3] - p[2]) );
+    return glm::length( d );
+}
+
+double ArcLengthTable::_integrate( const glm::vec3 *p, double a, double b ) const {
+    double halfWidth = 0.5 * (b - a), center = 0.5 * (a + b);
+    double sum = 0.0;
+    for( int i = 0; i < 5; i++ )
+        sum += GAUSS_WEIGHTS[i] * _speed( p, center + halfWidth * GAUSS_NODES[i] );
+    return sum * halfWidth;
+}
+
+float ArcLengthTable::_parameterInInterval( unsigned int interval, double distance ) const {
+    unsigned int segment = interval / _intervalsPerSegment;
+    const glm::vec3 *p = &_controlPoints[ segment*3 ];
+
+    double t0 = (double)(interval % _intervalsPerSegment) / _intervalsPerSegment;
+    double t1 = t0 + 1.0 / _intervalsPerSegment;
+    double length = _distances[interval+1] - _distances[interval];
+    double target = glm::clamp( distance - _distances[interval], 0.0, length );
+    if( length <= 0.0 ) return segment + (float)t0;
+
+    // solve integral( t0, t ) |P'| = target, starting from linear interpolation
+    double t = t0 + (t1 - t0) * target / length;
+    for( int i = 0; i < NEWTON_ITERATIONS; i++ ) {
+        double speed = _speed( p, t );
+        if( speed <= 0.0 ) break;
+        t = glm::clamp( t - (_integrate( p, t0, t ) - target) / speed, t0, t1 );
+    }
+    return segment + (float)t;
+}
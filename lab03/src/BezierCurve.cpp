@@ -0,0 +1,280 @@
+#include "../include/BezierCurve.h"
+
+#ifdef __APPLE__				// if compiling on Mac OS
+#include <OpenGL/gl.h>
+#else							// if compiling on Linux or Windows OS
+#include <GL/gl.h>
+#endif
+
+#include <algorithm>
+#include <math.h>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+// below this many new vertices an update is not worth spreading across threads
+static const unsigned int THREAD_MIN_VERTICES = 16384;
+
+BezierCurve::BezierCurve() {
+    _resolution = 100;
+    _tolerance = 0.0f;
+    _dirty = false;
+}
+
+void BezierCurve::setControlPoints( const std::vector<glm::vec3> &controlPoints ) {
+    _spline.setControlPoints( controlPoints );
+    _markAllDirty();
+}
+
+void BezierCurve::setControlPoint( unsigned int index, glm::vec3 point ) {
+    _spline.setControlPoint( index, point );
+
+    // a point shared by two segments moves both of them
+    unsigned int segment = index / 3;
+    if( segment < getNumSegments() ) _dirtySegments[segment] = true;
+    if( index % 3 == 0 && segment > 0 ) _dirtySegments[segment-1] = true;
+    _dirty = true;
+}
+
+const std::vector<glm::vec3>& BezierCurve::getControlPoints() const {
+    return _spline.getControlPoints();
+}
+
+unsigned int BezierCurve::getNumSegments() const {
+    return _spline.getNumSegments();
+}
+
+void BezierCurve::setResolution( unsigned int resolution ) {
+    if( resolution < 1 ) resolution = 1;
+    if( resolution == _resolution ) return;
+
+    _resolution = resolution;
+    if( _tolerance <= 0.0f ) _markAllDirty();
+}
+
+void BezierCurve::setFlatnessTolerance( float tolerance ) {
+    if( tolerance < 0.0f ) tolerance = 0.0f;
+    if( tolerance == _tolerance ) return;
+
+    _tolerance = tolerance;
+    _markAllDirty();
+}
+
+float BezierCurve::toleranceForPixels( float pixels, float distance, float fovy, int viewportHeight ) {
+    // height of the view frustum at that distance divided among the rows of the viewport
+    return pixels * 2.0f * distance * tanf( fovy * 0.5f ) / (float)viewportHeight;
+}
+
+unsigned int BezierCurve::getNumVertices() {
+    _updatePolyline();
+    return _polyline.size();
+}
+
+glm::vec3 BezierCurve::evaluate( float t ) const {
+    return _spline.position( t );
+}
+
+glm::vec3 BezierCurve::tangent( float t ) const {
+    return _spline.tangent( t );
+}
+
+void BezierCurve::evaluate( const float *t, unsigned int count, glm::vec3 *positions, glm::vec3 *tangents ) const {
+    _spline.evaluate( t, count, positions, tangents );
+}
+
+void BezierCurve::draw() {
+    _updatePolyline();
+    if( _polyline.empty() ) return;
+
+    // OpenGL 2.1 without an extension loader, so the cached polyline is a client side array
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, 0, &_polyline[0] );
+    glDrawArrays( GL_LINE_STRIP, 0, _polyline.size() );
+    glDisableClientState( GL_VERTEX_ARRAY );
+}
+
+void BezierCurve::_markAllDirty() {
+    _dirtySegments.assign( getNumSegments(), true );
+    _segmentOffsets.clear();
+    _dirty = true;
+}
+
+void BezierCurve::_updatePolyline() {
+    if( !_dirty ) return;
+    _dirty = false;
+
+    unsigned int numSegments = getNumSegments();
+    if( numSegments == 0 ) {
+        _polyline.clear();
+        _segmentOffsets.clear();
+        return;
+    }
+
+    // every segment after the first vertex contributes its points past t = 0,
+    // so neighbors share the vertex at their common end point.  dirty segments
+    // are evaluated by contiguous ranges, across threads when there is enough work
+    unsigned int numDirty = 0;
+    for( unsigned int segment = 0; segment < numSegments; segment++ )
+        if( _dirtySegments[segment] ) numDirty++;
+
+    unsigned int numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+    unsigned int estimatedVertices = numDirty * (_tolerance > 0.0f ? 16 : _resolution);
+    if( estimatedVertices >= THREAD_MIN_VERTICES ) {
+        numThreads = std::thread::hardware_concurrency();
+        if( numThreads < 1 ) numThreads = 1;
+        if( numThreads > numSegments ) numThreads = numSegments;
+    }
+#endif
+
+    std::vector<Evaluation> evaluations( numThreads );
+    for( unsigned int t = 0; t < numThreads; t++ ) {
+        evaluations[t].firstSegment = (unsigned long long)numSegments * t / numThreads;
+        evaluations[t].lastSegment = (unsigned long long)numSegments * (t+1) / numThreads;
+    }
+#ifndef CSCI441_NO_THREADS
+    std::vector< std::thread > workers;
+    for( unsigned int t = 1; t < numThreads; t++ )
+        workers.push_back( std::thread( &BezierCurve::_evaluateSegments, this, &evaluations[t] ) );
+#endif
+    _evaluateSegments( &evaluations[0] );
+#ifndef CSCI441_NO_THREADS
+    for( unsigned int t = 0; t < workers.size(); t++ )
+        workers[t].join();
+#endif
+
+    bool sameLayout = _segmentOffsets.size() == numSegments + 1;
+    for( unsigned int t = 0; t < numThreads && sameLayout; t++ ) {
+        const Evaluation &evaluation = evaluations[t];
+        for( unsigned int segment = evaluation.firstSegment; segment < evaluation.lastSegment; segment++ ) {
+            unsigned int i = segment - evaluation.firstSegment;
+            if( _dirtySegments[segment] && evaluation.starts[i+1] - evaluation.starts[i] != _segmentOffsets[segment+1] - _segmentOffsets[segment] ) {
+                sameLayout = false;
+                break;
+            }
+        }
+    }
+
+    if( sameLayout ) {
+        // vertex counts did not change, overwrite the edited segments in place
+        for( unsigned int t = 0; t < numThreads; t++ ) {
+            const Evaluation &evaluation = evaluations[t];
+            for( unsigned int segment = evaluation.firstSegment; segment < evaluation.lastSegment; segment++ ) {
+                if( !_dirtySegments[segment] ) continue;
+                unsigned int i = segment - evaluation.firstSegment;
+                std::copy( evaluation.points.begin() + evaluation.starts[i], evaluation.points.begin() + evaluation.starts[i+1], _polyline.begin() + _segmentOffsets[segment] );
+                _dirtySegments[segment] = false;
+            }
+        }
+        return;
+    }
+
+    // otherwise splice the new segments between the untouched spans of the old polyline
+    unsigned int numVertices = 1;
+    for( unsigned int t = 0; t < numThreads; t++ )
+        numVertices += evaluations[t].points.size();
+    for( unsigned int segment = 0; segment < numSegments && _segmentOffsets.size() == numSegments + 1; segment++ )
+        if( !_dirtySegments[segment] ) numVertices += _segmentOffsets[segment+1] - _segmentOffsets[segment];
+
+    std::vector<glm::vec3> polyline;
+    std::vector<unsigned int> offsets( numSegments + 1 );
+    polyline.reserve( numVertices );
+    polyline.push_back( _spline.getControlPoints()[0] );
+    for( unsigned int t = 0; t < numThreads; t++ ) {
+        const Evaluation &evaluation = evaluations[t];
+        for( unsigned int segment = evaluation.firstSegment; segment < evaluation.lastSegment; segment++ ) {
+            offsets[segment] = polyline.size();
+            if( _dirtySegments[segment] ) {
+                unsigned int i = segment - evaluation.firstSegment;
+                polyline.insert( polyline.end(), evaluation.points.begin() + evaluation.starts[i], evaluation.points.begin() + evaluation.starts[i+1] );
+                _dirtySegments[segment] = false;
+            } else {
+                polyline.insert( polyline.end(), _polyline.begin() + _segmentOffsets[segment], _polyline.begin() + _segmentOffsets[segment+1] );
+            }
+        }
+    }
+    offsets[numSegments] = polyline.size();
+
+    _polyline.swap( polyline );
+    _segmentOffsets.swap( offsets );
+}
+
+void BezierCurve::_evaluateSegments( Evaluation *evaluation ) const {
+    unsigned int numSegments = evaluation->lastSegment - evaluation->firstSegment;
+    evaluation->starts.resize( numSegments + 1 );
+    if( _tolerance <= 0.0f ) {
+        unsigned int numDirty = 0;
+        for( unsigned int segment = evaluation->firstSegment; segment < evaluation->lastSegment; segment++ )
+            if( _dirtySegments[segment] ) numDirty++;
+        evaluation->points.reserve( numDirty * _resolution );
+    }
+
+    for( unsigned int i = 0; i < numSegments; i++ ) {
+        evaluation->starts[i] = evaluation->points.size();
+        if( _dirtySegments[ evaluation->firstSegment + i ] )
+            _evaluateSegment( evaluation->firstSegment + i, evaluation->points );
+    }
+    evaluation->starts[numSegments] = evaluation->points.size();
+}
+
+void BezierCurve::_evaluateSegment( unsigned int segment, std::vector<glm::vec3> &points ) const {
+    const glm::vec3 *p = &_spline.getControlPoints()[ segment*3 ];
+    unsigned int first = points.size();
+
+    if( _tolerance > 0.0f ) {
+        // subdivide relative to the first point so far from the origin the flatness
+        // test is not swamped by float rounding and the recursion still terminates
+        _flattenSegment( glm::vec3(0,0,0), p[1] - p[0], p[2] - p[0], p[3] - p[0], 0, points );
+        for( unsigned int i = first; i + 1 < points.size(); i++ )
+            points[i] += p[0];
+        points.back() = p[3];
+        return;
+    }
+
+    // power basis P(t) = a t^3 + b t^2 + c t + d, stepped with forward differences.
+    // accumulate in double so the drift stays well under a float ulp over long runs
+    glm::dvec3 p0(p[0]), p1(p[1]), p2(p[2]), p3(p[3]);
+    glm::dvec3 a = -p0 + 3.0*p1 - 3.0*p2 + p3;
+    glm::dvec3 b = 3.0*p0 - 6.0*p1 + 3.0*p2;
+    glm::dvec3 c = -3.0*p0 + 3.0*p1;
+
+    double h = 1.0 / _resolution;
+    glm::dvec3 f = p0;
+    glm::dvec3 df = a*h*h*h + b*h*h + c*h;
+    glm::dvec3 d2f = 6.0*a*h*h*h + 2.0*b*h*h;
+    glm::dvec3 d3f = 6.0*a*h*h*h;
+
+    points.resize( first + _resolution );
+    for( unsigned int i = 0; i + 1 < _resolution; i++ ) {
+        f += df;
+        df += d2f;
+        d2f += d3f;
+        points[first + i] = glm::vec3( f );
+    }
+    // land exactly on the end point instead of trusting t to reach 1.0
+    points[first + _resolution - 1] = p[3];
+}
+
+void BezierCurve::_flattenSegment( glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, int depth, std::vector<glm::vec3> &points ) const {
+    // the curve strays from its chord by at most one quarter of the square root of
+    // the per axis max(u^2, v^2) summed, so stop once that bound is inside the tolerance
+    glm::vec3 u = 3.0f*p1 - 2.0f*p0 - p3;
+    glm::vec3 v = 3.0f*p2 - p0 - 2.0f*p3;
+    u *= u;
+    v *= v;
+    float flatness = glm::max( u.x, v.x ) + glm::max( u.y, v.y ) + glm::max( u.z, v.z );
+
+    if( depth >= 16 || flatness <= 16.0f * _tolerance * _tolerance ) {
+        points.push_back( p3 );
+        return;
+    }
+
+    // de Casteljau split at t = 0.5
+    glm::vec3 p01 = (p0 + p1) * 0.5f, p12 = (p1 + p2) * 0.5f, p23 = (p2 + p3) * 0.5f;
+    glm::vec3 p012 = (p01 + p12) * 0.5f, p123 = (p12 + p23) * 0.5f;
+    glm::vec3 mid = (p012 + p123) * 0.5f;
+
+    _flattenSegment( p0, p01, p012, mid, depth + 1, points );
+    _flattenSegment( mid, p123, p23, p3, depth + 1, points );
+}
@@ -0,0 +1,259 @@
+#include "../include/ControlPointReader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+static const char BINARY_MAGIC[4] = { 'C', 'P', 'B', '1' };
+
+// below this many bytes a text file is not worth spreading across threads
+static const size_t THREAD_MIN_BYTES = 1 << 22;
+
+// "0,0,0\n" is the shortest line, so a file never holds more points than this many bytes each
+static const size_t MIN_LINE_BYTES = 6;
+
+// read only view of a whole file, unmapped when it goes out of scope
+class MappedFile {
+public:
+    MappedFile( const char *filename ) : _data(NULL), _size(0) {
+#ifdef _WIN32
+        _mapping = NULL;
+        _file = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+        if( _file == INVALID_HANDLE_VALUE ) return;
+        LARGE_INTEGER size;
+        if( !GetFileSizeEx( _file, &size ) || size.QuadPart == 0 ) return;
+        _mapping = CreateFileMappingA( _file, NULL, PAGE_READONLY, 0, 0, NULL );
+        if( _mapping == NULL ) return;
+        _data = (const char*)MapViewOfFile( _mapping, FILE_MAP_READ, 0, 0, 0 );
+        if( _data != NULL ) _size = (size_t)size.QuadPart;
+#else
+        _file = ::open( filename, O_RDONLY );
+        if( _file < 0 ) return;
+        struct stat info;
+        if( fstat( _file, &info ) != 0 || info.st_size == 0 ) return;
+        void *data = mmap( NULL, info.st_size, PROT_READ, MAP_PRIVATE, _file, 0 );
+        if( data == MAP_FAILED ) return;
+        madvise( data, info.st_size, MADV_SEQUENTIAL );
+        _data = (const char*)data;
+        _size = info.st_size;
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if( _data != NULL ) UnmapViewOfFile( _data );
+        if( _mapping != NULL ) CloseHandle( _mapping );
+        if( _file != INVALID_HANDLE_VALUE ) CloseHandle( _file );
+#else
+        if( _data != NULL ) munmap( (void*)_data, _size );
+        if( _file >= 0 ) ::close( _file );
+#endif
+    }
+
+    bool isOpen() const { return _data != NULL; }
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    const char *_data;
+    size_t _size;
+#ifdef _WIN32
+    HANDLE _file, _mapping;
+#else
+    int _file;
+#endif
+};
+
+bool ControlPointReader::load( const char *filename, std::vector<glm::vec3> &points ) {
+    points.clear();
+
+    MappedFile file( filename );
+    if( !file.isOpen() ) return false;
+
+    if( file.size() >= 8 && memcmp( file.data(), BINARY_MAGIC, 4 ) == 0 )
+        return _loadBinary( file.data(), file.size(), points );
+    return _loadText( file.data(), file.size(), points );
+}
+
+bool ControlPointReader::saveBinary( const char *filename, const std::vector<glm::vec3> &points ) {
+    FILE *file = fopen( filename, "wb" );
+    if( file == NULL ) return false;
+
+    unsigned int count = points.size();
+    unsigned char header[8];
+    memcpy( header, BINARY_MAGIC, 4 );
+    for( int i = 0; i < 4; i++ ) header[4+i] = (count >> (8*i)) & 0xFF;
+
+    bool success = fwrite( header, 1, 8, file ) == 8;
+    if( success && count > 0 ) success = fwrite( &points[0], sizeof(glm::vec3), count, file ) == count;
+    return fclose( file ) == 0 && success;
+}
+
+bool ControlPointReader::_loadBinary( const char *data, size_t size, std::vector<glm::vec3> &points ) {
+    const unsigned char *header = (const unsigned char*)data;
+    size_t count = header[4] | (header[5] << 8) | (header[6] << 16) | ((size_t)header[7] << 24);
+    if( size < 8 + count * sizeof(glm::vec3) ) return false;
+
+    // glm::vec3 is three packed floats, so the payload copies straight in
+    points.resize( count );
+    if( count > 0 ) memcpy( &points[0], data + 8, count * sizeof(glm::vec3) );
+    return true;
+}
+
+bool ControlPointReader::_loadText( const char *data, size_t size, std::vector<glm::vec3> &points ) {
+    const char *start = data, *end = data + size;
+
+    // a first line holding a single value is the point count
+    const char *lineEnd = (const char*)memchr( data, '\n', size );
+    if( lineEnd == NULL ) lineEnd = end;
+    size_t expected = 0;
+    float count;
+    const char *s = _parseFloat( data, lineEnd, count );
+    while( s != NULL && s < lineEnd && (*s == ' ' || *s == '\t' || *s == '\r') ) s++;
+    if( s == lineEnd && count >= 0.0f ) {
+        // only a hint for reserve(), so a bogus count cannot ask for more than the file can hold
+        expected = count < (float)(size / MIN_LINE_BYTES) ? (size_t)count : size / MIN_LINE_BYTES;
+        data = lineEnd;
+    }
+
+    // split the body at line boundaries so each chunk parses independently
+    unsigned int numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+    if( (size_t)(end - data) >= THREAD_MIN_BYTES ) {
+        numThreads = std::thread::hardware_concurrency();
+        if( numThreads < 1 ) numThreads = 1;
+    }
+#endif
+
+    std::vector<Chunk> chunks( numThreads );
+    const char *begin = data;
+    for( unsigned int t = 0; t < numThreads; t++ ) {
+        const char *split = t + 1 == numThreads ? end : data + (end - data) * (t+1) / numThreads;
+        if( split < begin ) split = begin;
+        while( split < end && *split != '\n' ) split++;
+        chunks[t].begin = begin;
+        chunks[t].end = split;
+        begin = split;
+    }
+    if( numThreads == 1 ) chunks[0].points.reserve( expected );
+
+#ifndef CSCI441_NO_THREADS
+    std::vector< std::thread > workers;
+    for( unsigned int t = 1; t < numThreads; t++ )
+        workers.push_back( std::thread( &ControlPointReader::_parseChunk, &chunks[t] ) );
+#endif
+    _parseChunk( &chunks[0] );
+#ifndef CSCI441_NO_THREADS
+    for( unsigned int t = 0; t < workers.size(); t++ )
+        workers[t].join();
+#endif
+
+    size_t total = 0;
+    for( unsigned int t = 0; t < numThreads; t++ ) {
+        if( chunks[t].badLine != NULL ) {
+            size_t lineNumber = 1;
+            for( const char *c = start; c < chunks[t].badLine; c++ )
+                if( *c == '\n' ) lineNumber++;
+            fprintf( stderr, "[ERROR]: Control point line %lu does not hold exactly three numbers\n", (unsigned long)lineNumber );
+            return false;
+        }
+        total += chunks[t].points.size();
+    }
+
+    if( numThreads == 1 ) {
+        points.swap( chunks[0].points );
+        return true;
+    }
+    points.reserve( total );
+    for( unsigned int t = 0; t < numThreads; t++ )
+        points.insert( points.end(), chunks[t].points.begin(), chunks[t].points.end() );
+    return true;
+}
+
+void ControlPointReader::_parseChunk( Chunk *chunk ) {
+    const char *s = chunk->begin, *end = chunk->end;
+    chunk->badLine = NULL;
+    if( chunk->points.capacity() == 0 ) chunk->points.reserve( (end - s) / 12 );	// "-5,0,5\n" is about the shortest line
+
+    while( s < end ) {
+        // skip blank lines
+        while( s < end && (*s == ' ' || *s == '\t' || *s == '\r' || *s == '\n') ) s++;
+        if( s == end ) break;
+
+        // a line is exactly one point, so a short or long line cannot shift the points after it
+        const char *line = s;
+        glm::vec3 point;
+        int numValues = 0;
+        while( true ) {
+            while( s < end && (*s == ' ' || *s == '\t' || *s == ',' || *s == '\r') ) s++;
+            if( s == end || *s == '\n' ) break;
+            if( numValues == 3 || (s = _parseFloat( s, end, point[numValues] )) == NULL ) break;
+            numValues++;
+        }
+        if( s == NULL || numValues != 3 || (s < end && *s != '\n') ) {
+            chunk->badLine = line;
+            return;
+        }
+        chunk->points.push_back( point );
+    }
+}
+
+const char* ControlPointReader::_parseFloat( const char *s, const char *end, float &value ) {
+    // exact powers of ten, so values with at most 15 significant digits round correctly
+    static const double POWERS_OF_TEN[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    bool negative = false;
+    if( s < end && (*s == '-' || *s == '+') ) negative = *s++ == '-';
+
+    unsigned long long mantissa = 0;
+    int exponent = 0, digits = 0;
+    for( ; s < end && *s >= '0' && *s <= '9'; s++, digits++ ) {
+        if( mantissa < 100000000000000000ULL ) mantissa = mantissa * 10 + (*s - '0');
+        else exponent++;
+    }
+    if( s < end && *s == '.' ) {
+        for( s++; s < end && *s >= '0' && *s <= '9'; s++, digits++ ) {
+            if( mantissa < 100000000000000000ULL ) {
+                mantissa = mantissa * 10 + (*s - '0');
+                exponent--;
+            }
+        }
+    }
+    if( digits == 0 ) return NULL;
+
+    if( s < end && (*s == 'e' || *s == 'E') ) {
+        const char *e = s + 1;
+        bool negativeExponent = false;
+        if( e < end && (*e == '-' || *e == '+') ) negativeExponent = *e++ == '-';
+        if( e < end && *e >= '0' && *e <= '9' ) {
+            int power = 0;
+            for( ; e < end && *e >= '0' && *e <= '9'; e++ )
+                if( power < 10000 ) power = power * 10 + (*e - '0');
+            exponent += negativeExponent ? -power : power;
+            s = e;
+        }
+    }
+
+    double result = (double)mantissa;
+    while( exponent > 22 ) { result *= 1e22; exponent -= 22; }
+    while( exponent < -22 ) { result /= 1e22; exponent += 22; }
+    result = exponent < 0 ? result / POWERS_OF_TEN[-exponent] : result * POWERS_OF_TEN[exponent];
+
+    value = (float)(negative ? -result : result);
+    return s;
+}
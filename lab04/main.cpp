@@ -14,22 +14,22 @@
 // HEADERS /////////////////////////////////////////////////////////////////////
 
 // include the OpenGL library header
-#ifdef __APPLE__				    // if compiling on Mac OS
-#include <OpenGL/gl.h>
-#else							    // if compiling on Linux or Windows OS
-#include <GL/gl.h>
-#endif
+#include <GL/glew.h>                // GLEW first, it replaces the system OpenGL header
 
 #include <GLFW/glfw3.h>			    // include GLFW framework header
 
 #include <CSCI441/objects.hpp>      // for our 3D objects
 #include <CSCI441/OpenGLUtils.hpp>  // for OpenGL helper functions
+#include <CSCI441/ShaderProgram3.hpp>   // for our city shader
+#include <CSCI441/cityStreamer3.hpp>    // for our endless city
+#include <CSCI441/occlusionCuller.hpp>  // for skipping buildings hidden behind others
+#include <CSCI441/sceneGraph3.hpp>      // for the parts of our plane
 
 // include GLM libraries and matrix functions
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include <math.h>                   // for powf functionality
+#include <math.h>                   // for M_PI
 #include <stdio.h>			        // for printf functionality
 #include <stdlib.h>			        // for exit functionality
 #include <time.h>			        // for time() functionality
@@ -54,24 +54,40 @@ glm::vec3 camDir; 			        // camera DIRECTION in cartesian coordinates
 
 GLfloat propAngle = 0.0f;           // angle of rotation for our plane propeller
 
-GLuint environmentDL;               // display list for the 'city'
+CSCI441::SceneGraph planeGraph;     // every part of our plane relative to its parent
+struct PlaneNodes {
+    GLint plane, model, body, leftWing, rightWing, nose, noseLight, propeller, bladeA, bladeB, tail;
+} planeNodes;
+
+GLuint environmentDL;               // display list for the teapot
+GLuint groundDL;                    // display list for the ground around the camera
+
+CSCI441::CityStreamer* cityStreamer = NULL;     // chunks of buildings around the camera
+CSCI441::ShaderProgram* cityShaderProgram = NULL;
+struct CityShaderUniformLocations {
+    GLint viewProjectionMtx;
+    GLint lightPosition;
+    GLint lightDiffuse;
+} cityShaderUniforms;
+struct CityShaderAttributeLocations {
+    GLint vPos;
+    GLint vNormal;
+    GLint instancePosition;
+    GLint instanceSize;
+    GLint instanceColor;
+} cityShaderAttributes;
+
+CSCI441::OcclusionCuller occlusionCuller;      // the nearest buildings in a tiny depth buffer on the CPU
 
 bool light0Toggle = true;
 bool light1Toggle = true;
+bool occlusionToggle = true;
+bool statsToggle = false;                       // print frame and culling statistics once a second
 
 //*************************************************************************************
 //
 // Helper Function
 
-// getRand() ///////////////////////////////////////////////////////////////////
-//
-//  Simple helper function to return a random number between 0.0f and 1.0f.
-//
-////////////////////////////////////////////////////////////////////////////////
-float getRand() {
-    return rand() / (float)RAND_MAX;
-}
-
 // recomputeOrientation() //////////////////////////////////////////////////////
 //
 // This function updates the camera's position in cartesian coordinates based
@@ -111,6 +127,14 @@ static void keyboard_callback( GLFWwindow *window, int key, int scancode, int ac
             case GLFW_KEY_Q:
                 glfwSetWindowShouldClose( window, GLFW_TRUE );
                 break;
+            case GLFW_KEY_3:
+                occlusionToggle = !occlusionToggle;
+                fprintf( stdout, "[INFO]: Occlusion culling %s\n", occlusionToggle ? "on" : "off" );
+                break;
+            case GLFW_KEY_4:
+                statsToggle = !statsToggle;
+                fprintf( stdout, "[INFO]: Culling statistics %s\n", statsToggle ? "on" : "off" );
+                break;
             case GLFW_KEY_1:
                 if(light0Toggle) {
                     light0Toggle = false;
@@ -231,7 +255,9 @@ void animate() {
 // generateEnvironmentDL() /////////////////////////////////////////////////////
 //
 //  This function creates a display list with the code to draw a simple
-//      environment for the user to navigate through.
+//      environment for the user to navigate through.  The buildings are not
+//      part of it: the city streamer generates them in chunks around the
+//      camera, so the ground gets its own list that follows the camera.
 //
 //  And yes, it uses a global variable for the display list.
 //  I know, I know! Kids: don't try this at home. There's something to be said
@@ -239,33 +265,14 @@ void animate() {
 //
 ////////////////////////////////////////////////////////////////////////////////
 void generateEnvironmentDL() {
-    int gridX = 100;
-    int gridY = 100;
-    float spacing = 0.5f;
+    int gridX = 200;
+    int gridY = 200;
 
-    environmentDL = glGenLists(1);
-    glNewList(environmentDL, GL_COMPILE); {
-        //psych! everything's on a grid.
-        for(int i = 0; i < gridX-1; i++) {
-            for(int j = 0; j < gridY-1; j++) {
-                //don't just draw a building ANYWHERE.
-                if( i % 2 && j % 2 && getRand() < 0.4f ) {
-                    float height = getRand();
-                    height = powf(height, 2.5)*10 + 1;
-
-                    // TODO #02: Add a random material color
-                    GLfloat matColorD[4] = {getRand(), getRand(), getRand(), 1.0f};
-                    glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, matColorD);
-                    glm::mat4 transToPosMtx = glm::translate( glm::mat4(1.0f), glm::vec3( (i - gridX/2.0f)*1.1, 0.0f, (j - gridY/2.0f)*1.1 ) ) ;
-                    glm::mat4 transToHeightMtx = glm::translate( transToPosMtx, glm::vec3( 0.0f, height/2.0f, 0.0f ) ) ;
-                    glm::mat4 scaleHeightMtx = glm::scale( transToHeightMtx, glm::vec3( 1.0f, height, 1.0f ) );
-                    CSCI441::pushMatrix( scaleHeightMtx ); {
-                        CSCI441::drawSolidCube(1.0);
-                    }; CSCI441::popMatrix( scaleHeightMtx );
-                }
-            }
-        }
+    // psych! everything's on a grid, forever.  the same seed always builds the same city
+    cityStreamer = new CSCI441::CityStreamer( time(NULL) );
 
+    groundDL = glGenLists(1);
+    glNewList(groundDL, GL_COMPILE); {
         // DRAW OUR GRID
         // TODO #07: convert to materials and set vertex attributes properly
         GLfloat newColorMaterial[4] = {0.07568, 0.61424, 0.07568, 1.0};
@@ -281,8 +288,10 @@ void generateEnvironmentDL() {
             glNormal3f( 0,1.0f,0 );
             glVertex3f( gridX, 0, gridY );
         }; glEnd();
+    }; glEndList();
 
-
+    environmentDL = glGenLists(1);
+    glNewList(environmentDL, GL_COMPILE); {
         // TODO #03: Make our teapot cool
         GLfloat matColorTD[4] = {0.18275,0.17,0.22525,1.0f};                       // make it RED!
         glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, matColorTD);
@@ -296,67 +305,92 @@ void generateEnvironmentDL() {
     }; glEndList();
 }
 
+// setupPlane() /////////////////////////////////////////////////////////////////
+//
+//  Builds the hierarchy of our plane once.  Every part is placed relative to
+//      its parent, and a parent is always added before its children.
+//
+////////////////////////////////////////////////////////////////////////////////
+void setupPlane() {
+    // the plane itself follows the camera; its model frame turns it to face forward
+    planeNodes.plane = planeGraph.addNode( CSCI441::SceneGraph::ROOT );
+    glm::mat4 rotYMtx = glm::rotate( glm::mat4(1.0f), -1.57f, CSCI441::Y_AXIS );
+    planeNodes.model = planeGraph.addNode( planeNodes.plane, glm::rotate( rotYMtx, 1.57f, CSCI441::Z_AXIS ) );
+
+    planeNodes.body = planeGraph.addNode( planeNodes.model, glm::scale( glm::mat4(1.0f), glm::vec3( 2.0f, 0.5f, 1.0f ) ) );
+
+    glm::mat4 wingScaleMtx = glm::scale( glm::mat4(1.0f), glm::vec3( 1.5f, 0.5f, 1.0f ) );
+    planeNodes.leftWing = planeGraph.addNode( planeNodes.model, glm::rotate( wingScaleMtx, -1.57f, CSCI441::X_AXIS ) );
+    planeNodes.rightWing = planeGraph.addNode( planeNodes.model, glm::rotate( wingScaleMtx, 1.57f, CSCI441::X_AXIS ) );
+
+    planeNodes.nose = planeGraph.addNode( planeNodes.model, glm::rotate( glm::mat4(1.0f), 1.57f, CSCI441::Z_AXIS ) );
+    // the front of our nose cone
+    planeNodes.noseLight = planeGraph.addNode( planeNodes.nose, glm::translate( glm::mat4(1.0f), glm::vec3( 0.0f, 0.0f, 0.2f ) ) );
+
+    // the blades spin, so they are set every frame
+    planeNodes.propeller = planeGraph.addNode( planeNodes.model, glm::translate( glm::mat4(1.0f), glm::vec3( 0.1f, 0.0f, 0.0f ) ) );
+    planeNodes.bladeA = planeGraph.addNode( planeNodes.propeller );
+    planeNodes.bladeB = planeGraph.addNode( planeNodes.propeller );
+
+    planeNodes.tail = planeGraph.addNode( planeNodes.model );
+}
+
+// pushNodeMatrix() /////////////////////////////////////////////////////////////
+//
+//  Multiplies the world matrix of a plane part onto the view matrix.  The
+//      matching glPopMatrix() restores the view matrix without an inverse.
+//
+////////////////////////////////////////////////////////////////////////////////
+void pushNodeMatrix( GLint node ) {
+    glPushMatrix();
+    glMultMatrixf( &planeGraph.getWorldTransform( node )[0][0] );
+}
+
 void drawPlaneBody() {
     glColor3f( 0, 0, 1 );
-
-    glm::mat4 scaleMtx = glm::scale( glm::mat4(1.0f), glm::vec3( 2.0f, 0.5f, 1.0f ) );
-    CSCI441::pushMatrix( scaleMtx ); {
+    pushNodeMatrix( planeNodes.body ); {
         CSCI441::drawSolidCube( 0.1 );
-    }; CSCI441::popMatrix( scaleMtx );
+    }; glPopMatrix();
 }
 
 void drawPlaneWing( bool leftWing ) {
     glColor3f( 1, 0, 0 );
-    glm::mat4 scaleMtx = glm::scale( glm::mat4(1.0f), glm::vec3( 1.5f, 0.5f, 1.0f ) );
-
-    glm::mat4 rsMtx;
-    if( leftWing )
-        rsMtx = glm::rotate( scaleMtx, -1.57f, CSCI441::X_AXIS );
-    else
-        rsMtx = glm::rotate( scaleMtx, 1.57f, CSCI441::X_AXIS );
-
-    CSCI441::pushMatrix( rsMtx ); {
+    pushNodeMatrix( leftWing ? planeNodes.leftWing : planeNodes.rightWing ); {
         CSCI441::drawSolidCone( 0.05, 0.2, 16, 16 );
-    }; CSCI441::popMatrix( rsMtx );
+    }; glPopMatrix();
 }
 
 void drawPlaneNose() {
     glColor3f( 0, 1, 0 );
-    glm::mat4 rotateMtx = glm::rotate( glm::mat4(1.0f), 1.57f, CSCI441::Z_AXIS );
-    CSCI441::pushMatrix( rotateMtx ); {
+    pushNodeMatrix( planeNodes.nose ); {
         CSCI441::drawSolidCone( 0.025, 0.3, 16, 16 );
-
-        // move the origin to the front of our nose cone
-        glm::mat4 transMtx = glm::translate( glm::mat4(1.0f), glm::vec3( 0.0f, 0.0f, 0.2f ) );
-        CSCI441::pushMatrix( transMtx ); {
-            // TODO #09: Place our second light here
-            GLfloat light1Pos[4] =  {0,0,0,1.0f};
-            glLightfv(GL_LIGHT1, GL_POSITION, light1Pos);
-            GLfloat dir[4] = {0,1.0f,0,0};
-            glLightfv(GL_LIGHT1, GL_SPOT_DIRECTION, dir);
-        }; CSCI441::popMatrix( transMtx );
-    }; CSCI441::popMatrix( rotateMtx );
+    }; glPopMatrix();
+
+    pushNodeMatrix( planeNodes.noseLight ); {
+        // TODO #09: Place our second light here
+        GLfloat light1Pos[4] =  {0,0,0,1.0f};
+        glLightfv(GL_LIGHT1, GL_POSITION, light1Pos);
+        GLfloat dir[4] = {0,1.0f,0,0};
+        glLightfv(GL_LIGHT1, GL_SPOT_DIRECTION, dir);
+    }; glPopMatrix();
 }
 
 void drawPlanePropeller() {
     glColor3f( 1, 1, 1 );
-    glm::mat4 tMtx = glm::translate( glm::mat4(1.0f), glm::vec3( 0.1f, 0.0f, 0.0f ) );
-    glm::mat4 rtMtx = glm::rotate( tMtx, propAngle, CSCI441::X_AXIS );
-    glm::mat4 srtMtx = glm::scale( rtMtx, glm::vec3( 1.1, 1, 0.025 ) );
-    CSCI441::pushMatrix( srtMtx ); {
+    pushNodeMatrix( planeNodes.bladeA ); {
         CSCI441::drawSolidCube( 0.1 );
-    }; CSCI441::popMatrix( srtMtx );
+    }; glPopMatrix();
 
-    rtMtx = glm::rotate( tMtx, propAngle+1.57f, CSCI441::X_AXIS );
-    srtMtx = glm::scale( rtMtx, glm::vec3( 1.1, 1, 0.025 ) );
-    CSCI441::pushMatrix( srtMtx ); {
+    pushNodeMatrix( planeNodes.bladeB ); {
         CSCI441::drawSolidCube( 0.1 );
-    }; CSCI441::popMatrix( srtMtx );
+    }; glPopMatrix();
 }
 
 void drawPlaneTail() {
     glColor3f( 1, 1, 0 );
-    CSCI441::drawSolidCone( 0.02, 0.1, 16, 16 );
+    pushNodeMatrix( planeNodes.tail ); {
+        CSCI441::drawSolidCone( 0.02, 0.1, 16, 16 );
+    }; glPopMatrix();
 }
 
 // drawPlane() //////////////////////////////////////////////////////////////////
@@ -364,17 +398,21 @@ void drawPlaneTail() {
 //  A very CRUDE plane
 //
 ////////////////////////////////////////////////////////////////////////////////
-void drawPlane() {
-    glm::mat4 rotYMtx = glm::rotate( glm::mat4(1.0f), -1.57f, CSCI441::Y_AXIS );
-    glm::mat4 rotZYMtx = glm::rotate( rotYMtx, 1.57f, CSCI441::Z_AXIS );
-    CSCI441::pushMatrix( rotZYMtx ); {
-        drawPlaneBody();        // the body of our plane
-        drawPlaneWing( true );  // the left wing
-        drawPlaneWing( false ); // the right wing
-        drawPlaneNose();        // the nose
-        drawPlanePropeller();   // the propeller
-        drawPlaneTail();        // the tail
-    }; CSCI441::popMatrix( rotZYMtx );
+void drawPlane( glm::mat4 planeMtx ) {
+    // only the placement and the spinning blades change; update() recomputes
+    // just those nodes and the parts below them
+    planeGraph.setLocalTransform( planeNodes.plane, planeMtx );
+    glm::mat4 bladeScaleMtx = glm::scale( glm::mat4(1.0f), glm::vec3( 1.1, 1, 0.025 ) );
+    planeGraph.setLocalTransform( planeNodes.bladeA, glm::rotate( glm::mat4(1.0f), propAngle, CSCI441::X_AXIS ) * bladeScaleMtx );
+    planeGraph.setLocalTransform( planeNodes.bladeB, glm::rotate( glm::mat4(1.0f), propAngle+1.57f, CSCI441::X_AXIS ) * bladeScaleMtx );
+    planeGraph.update();
+
+    drawPlaneBody();        // the body of our plane
+    drawPlaneWing( true );  // the left wing
+    drawPlaneWing( false ); // the right wing
+    drawPlaneNose();        // the nose
+    drawPlanePropeller();   // the propeller
+    drawPlaneTail();        // the tail
 }
 
 // renderScene() ///////////////////////////////////////////////////////////////
@@ -384,9 +422,26 @@ void drawPlane() {
 //      front buffer (what the user sees).
 //
 ////////////////////////////////////////////////////////////////////////////////
-void renderScene(void)  {
-    // execute our display list
+void renderScene( glm::mat4 viewMtx, glm::mat4 projMtx )  {
+    // execute our display lists, keeping the ground underneath the camera
     glCallList( environmentDL );
+    glm::mat4 groundMtx = glm::translate( glm::mat4(1.0f), glm::vec3( camPos.x, 0.0f, camPos.z ) );
+    CSCI441::pushMatrix( groundMtx ); {
+        glCallList( groundDL );
+    }; CSCI441::popMatrix( groundMtx );
+
+    // draw the buildings with our city shader, one instanced draw per chunk in view
+    cityShaderProgram->useProgram();
+    glm::mat4 vp = projMtx * viewMtx;
+    glm::vec3 lightPosition( 0.0f, 10.0f, 0.0f );
+    glm::vec3 lightDiffuse( 0.75164f, 0.60648f, 0.22648f );
+    glUniformMatrix4fv( cityShaderUniforms.viewProjectionMtx, 1, GL_FALSE, &vp[0][0] );
+    glUniform3fv( cityShaderUniforms.lightPosition, 1, &lightPosition[0] );
+    glUniform3fv( cityShaderUniforms.lightDiffuse, 1, &lightDiffuse[0] );
+    cityStreamer->draw( vp, cityShaderAttributes.vPos, cityShaderAttributes.vNormal,
+                        cityShaderAttributes.instancePosition, cityShaderAttributes.instanceSize, cityShaderAttributes.instanceColor );
+    glBindVertexArray( 0 );
+    glUseProgram( 0 );                  // back to fixed function for the plane
 
     // we are going to cheat and use our look at point to place our plane
     glm::mat4 planeTransMtx = glm::translate( glm::mat4(1.0f), camPos+camDir );
@@ -394,10 +449,45 @@ void renderScene(void)  {
     glm::mat4 planeThetaMtx = glm::rotate( planeTransMtx, -camAngles.x, CSCI441::Y_AXIS );
     // rotate the plane with our camera phi direction
     glm::mat4 planePhiMtx = glm::rotate( planeThetaMtx,  camAngles.y, CSCI441::X_AXIS );
-    CSCI441::pushMatrix( planePhiMtx ); {
-        // draw our plane now
-        drawPlane();
-    }; CSCI441::popMatrix( planePhiMtx );
+    // draw our plane now
+    drawPlane( planePhiMtx );
+}
+
+// reportCulling() /////////////////////////////////////////////////////////////
+//
+//  Once a second while statistics are toggled on (press 4), prints how long
+//      our frames took and how many buildings the occlusion culler kept
+//      away from the GPU.
+//
+////////////////////////////////////////////////////////////////////////////////
+void reportCulling() {
+    static double lastReport = glfwGetTime();
+    static int numFrames = 0;
+    static double cullTime = 0.0;
+
+    // start counting afresh whenever statistics are turned back on
+    if( !statsToggle ) {
+        lastReport = glfwGetTime();
+        numFrames = 0;
+        cullTime = 0.0;
+        return;
+    }
+
+    numFrames++;
+    cullTime += cityStreamer->getCullTime();
+    double now = glfwGetTime();
+    if( now - lastReport < 1.0 ) return;
+
+    GLuint drawn = cityStreamer->getNumDrawnBuildings();
+    GLuint hidden = cityStreamer->getNumOccludedBuildings();
+    fprintf( stdout, "[INFO]: %.2f ms/frame, culling %.3f ms/frame | drew %u buildings in %u chunks, %u occluders hid %u more (%.1f%%)\n",
+             (now - lastReport) * 1000.0 / numFrames, cullTime / numFrames,
+             drawn, cityStreamer->getNumDrawnChunks(), cityStreamer->getNumOccluders(),
+             hidden, drawn + hidden > 0 ? 100.0 * hidden / (drawn + hidden) : 0.0 );
+
+    lastReport = now;
+    numFrames = 0;
+    cullTime = 0.0;
 }
 
 //*************************************************************************************
@@ -424,14 +514,20 @@ GLFWwindow* setupGLFW() {
         fprintf( stdout, "[INFO]: GLFW initialized\n" );
     }
 
-    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 2 );	// request OpenGL v2.X
-    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );	// request OpenGL v2.1
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 3 );	// request OpenGL v3.X
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 3 );	// request OpenGL v3.3
+    // the plane and ground still use fixed function next to the instanced city, so the context
+    // cannot be core.  macOS only offers 3.3+ as a core profile, so lab04 does not run there
+    glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE );
     glfwWindowHint( GLFW_RESIZABLE, GLFW_FALSE );		// do not allow our window to be able to be resized
 
     // create a window for a given size, with a given title
     GLFWwindow *window = glfwCreateWindow( windowWidth, windowHeight, "Lab04 - Flight Simulator v0.33 alpha", NULL, NULL );
     if( !window ) {						                // if the window could not be created, NULL is returned
         fprintf( stderr, "[ERROR]: GLFW Window could not be created\n" );
+#ifdef __APPLE__
+        fprintf( stderr, "[ERROR]: macOS has no OpenGL 3.3 compatibility profile, which lab04 needs to mix fixed function with the instanced city\n" );
+#endif
         glfwTerminate();
         exit( EXIT_FAILURE );
     } else {
@@ -448,6 +544,51 @@ GLFWwindow* setupGLFW() {
     return window;						                // return the window that was created
 }
 
+//
+//  void setupGLEW()
+//
+//      Used to initialize GLEW.  Must be called after the OpenGL context is created.
+//
+void setupGLEW() {
+    glewExperimental = GL_TRUE;
+    GLenum glewResult = glewInit();
+
+    /* check for an error */
+    if( glewResult != GLEW_OK ) {
+        printf( "[ERROR]: Error initalizing GLEW\n");
+        /* Problem: glewInit failed, something is seriously wrong. */
+        fprintf( stderr, "[ERROR]: %s\n", glewGetErrorString(glewResult) );
+        exit(EXIT_FAILURE);
+    } else {
+        fprintf( stdout, "[INFO]: GLEW initialized\n" );
+        fprintf( stdout, "[INFO]: Status: Using GLEW %s\n", glewGetString(GLEW_VERSION) );
+    }
+
+    if( !glewIsSupported( "GL_VERSION_3_3" ) ) {
+        printf( "[ERROR]: OpenGL not version 3.3+.  Instanced drawing not supported\n" );
+        exit(EXIT_FAILURE);
+    }
+}
+
+//
+//  void setupShaders()
+//
+//      Used to load our shader programs and look up their locations
+//
+void setupShaders() {
+    cityShaderProgram = new CSCI441::ShaderProgram( "shaders/cityShader.v.glsl", "shaders/cityShader.f.glsl" );
+
+    cityShaderUniforms.viewProjectionMtx    = cityShaderProgram->getUniformLocation( "viewProjectionMtx" );
+    cityShaderUniforms.lightPosition        = cityShaderProgram->getUniformLocation( "lightPosition" );
+    cityShaderUniforms.lightDiffuse         = cityShaderProgram->getUniformLocation( "lightDiffuse" );
+
+    cityShaderAttributes.vPos               = cityShaderProgram->getAttributeLocation( "vPos" );
+    cityShaderAttributes.vNormal            = cityShaderProgram->getAttributeLocation( "vNormal" );
+    cityShaderAttributes.instancePosition   = cityShaderProgram->getAttributeLocation( "instancePosition" );
+    cityShaderAttributes.instanceSize       = cityShaderProgram->getAttributeLocation( "instanceSize" );
+    cityShaderAttributes.instanceColor      = cityShaderProgram->getAttributeLocation( "instanceColor" );
+}
+
 //
 //  void setupOpenGL()
 //
@@ -497,8 +638,8 @@ void setupScene() {
     camAngles.z = 0;            // radius
     recomputeOrientation();
 
-    srand( time(NULL) );        // seed our random number generator
-    generateEnvironmentDL();    // create our environment display list
+    generateEnvironmentDL();    // create our city and environment display list
+    setupPlane();               // build the parts of our plane
 }
 
 ///*************************************************************************************
@@ -513,7 +654,9 @@ void setupScene() {
 int main( int argc, char *argv[] ) {
     // GLFW sets up our OpenGL context so must be done first
     GLFWwindow *window = setupGLFW();	        // initialize all of the GLFW specific information releated to OpenGL and our window
+    setupGLEW();                                // initialize all of the GLEW specific information
     setupOpenGL();								// initialize all of the OpenGL specific information
+    setupShaders();                             // load our shader programs
     setupScene();								// initialize objects in our scene
     CSCI441::OpenGLUtils::printOpenGLInfo();    // print information related to our OpenGL context
 
@@ -555,7 +698,11 @@ int main( int argc, char *argv[] ) {
         glNormal3f(0,1.0f,0);
         glLightfv( GL_LIGHT0, GL_POSITION, lPosition );
 
-        renderScene();					        // draw everything to the window
+        cityStreamer->update( camPos );         // fetch the chunks around the camera, drop old ones
+        // find what is hidden on the CPU while the GPU is still drawing last frame
+        cityStreamer->cull( projMtx * viewMtx, camPos + camDir * camAngles.z, occlusionToggle ? &occlusionCuller : NULL );
+        renderScene( viewMtx, projMtx );        // draw everything to the window
+        reportCulling();                        // how much did culling save us?
 
         glfwSwapBuffers(window);                // flush the OpenGL commands and make sure they get rendered!
         glfwPollEvents();				        // check for any events and signal to redraw screen
@@ -563,6 +710,9 @@ int main( int argc, char *argv[] ) {
         animate();
     }
 
+    delete cityStreamer;                        // free the city's buffers while the context still exists
+    delete cityShaderProgram;
+
     glfwDestroyWindow( window );                // clean up and close our window
     glfwTerminate();						    // shut down GLFW to clean up our context
 
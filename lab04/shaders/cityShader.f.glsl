@@ -0,0 +1,17 @@
+#version 330 core
+
+in vec3 worldPos;
+in vec3 worldNormal;
+in vec4 color;
+
+out vec4 fragColorOut;
+
+uniform vec3 lightPosition;
+uniform vec3 lightDiffuse;
+
+void main() {
+  // the same point light as GL_LIGHT0 plus the fixed function global ambient of 0.2
+  vec3 lightDir = normalize( lightPosition - worldPos );
+  float diffuse = max( dot( normalize(worldNormal), lightDir ), 0.0 );
+  fragColorOut = vec4( color.rgb * (vec3(0.2) + lightDiffuse * diffuse), color.a );
+}
@@ -0,0 +1,23 @@
+#version 330 core
+
+in vec3 vPos;
+in vec3 vNormal;
+
+// one value per building
+in vec3 instancePosition;
+in vec3 instanceSize;
+in vec4 instanceColor;
+
+out vec3 worldPos;
+out vec3 worldNormal;
+out vec4 color;
+
+uniform mat4 viewProjectionMtx;
+
+void main() {
+  // the unit cube sits on y = 0, so scaling keeps every building on the ground
+  worldPos = instancePosition + vPos * instanceSize;
+  worldNormal = vNormal;
+  color = instanceColor;
+  gl_Position = viewProjectionMtx * vec4(worldPos, 1.0);
+}
@@ -100,13 +100,14 @@ bool registerOpenGLTexture(unsigned char *textureData,
     glGenTextures(1, &textureHandle);
     glBindTexture(GL_TEXTURE_2D, textureHandle);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texWidth, texHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, textureData);
+
+    // upload every mipmap level, which also turns on trilinear minification
+    CSCI441::TextureUtils::MipmapChain mipmaps;
+    mipmaps.build(textureData, texWidth, texHeight, 3);
+    mipmaps.upload();
     return true;
 }
 
@@ -292,7 +293,7 @@ void setupTextures() {
     int textWidth,textHeight;
     unsigned char* imageData;
     // TODO #1: Read in the brick PPM file
-    CSCI441::loadPPM("textures/brick.ppm", textWidth, textHeight, imageData);
+    CSCI441::TextureUtils::loadPPM("textures/brick.ppm", textWidth, textHeight, imageData);
     // TODO #2a: call the registerOpenGLTexture() function
     registerOpenGLTexture(imageData,textWidth,textHeight, brickTexHandle);
 
@@ -302,8 +303,8 @@ void setupTextures() {
     // TODO #6: Register non-PPM
     glBindTexture(GL_TEXTURE_2D, minesTexHandle);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST | GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST | GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     if( minesTexHandle == 0 ) {
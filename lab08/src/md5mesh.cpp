@@ -33,8 +33,12 @@
 
 #include <SOIL/SOIL.h>
 
+#include <CSCI441/imageDecoder.hpp>
+
+#include <chrono>
 #include <fstream>
 #include <string>
+#include <vector>
 using namespace std;
 
 #include <stdio.h>
@@ -121,22 +125,61 @@ void quat_rotatePoint(const quat4_t q, const vec3_t in, vec3_t out) {
 	out[Z] = final[Z];
 }
 
-GLuint loadTexture( string filename ) {
-	GLuint textureHandle = SOIL_load_OGL_texture( filename.c_str(),
-																								SOIL_LOAD_AUTO,
-																								SOIL_CREATE_NEW_ID,
-																								SOIL_FLAG_MIPMAPS | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT );
-	if( textureHandle != 0 ) {
+/* a texture map named by a mesh's shader, decoded along with the rest once the file is read */
+struct md5_texture_request_t {
+	string filename;
+	int *texHandle;
+};
+
+/**
+ * Name the .tga version of a texture map if it exists, otherwise the .png.
+ */
+string findTexture( const char *shader, const char *suffix ) {
+	string filename = string(shader) + suffix + ".tga";
+	FILE *texFile = fopen( filename.c_str(), "rb" );
+	if( texFile ) {
+		fclose( texFile );
+		return filename;
+	}
+	return string(shader) + suffix + ".png";
+}
+
+/**
+ * Decode every requested texture map at once, then upload each with mipmaps.
+ */
+void loadTextures( vector< md5_texture_request_t > &requests ) {
+	if( requests.empty() ) return;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	vector< CSCI441::ImageDecoder::ImageFile > images( requests.size() );
+	for( size_t i = 0; i < requests.size(); i++ ) {
+		images[i].filename = requests[i].filename.c_str();
+	}
+	const int numLoaded = CSCI441::ImageDecoder::loadImages( &images[0], (int)images.size() );
+
+	static const GLenum FORMATS[4] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	for( size_t i = 0; i < requests.size(); i++ ) {
+		*requests[i].texHandle = 0;
+		if( !images[i].pixels ) continue;
+
+		GLuint textureHandle;
+		glGenTextures( 1, &textureHandle );
 		glBindTexture(GL_TEXTURE_2D, textureHandle);
+		glTexImage2D( GL_TEXTURE_2D, 0, FORMATS[images[i].channels - 1], images[i].width, images[i].height, 0, FORMATS[images[i].channels - 1], GL_UNSIGNED_BYTE, images[i].pixels );
+		glGenerateMipmap( GL_TEXTURE_2D );
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		printf("[.md5mesh]: %s texture map read in with handle %d\n", filename.c_str(), textureHandle);
-	} else {
+		CSCI441::ImageDecoder::freeImageData( images[i].pixels );
 
+		*requests[i].texHandle = textureHandle;
+		printf("[.md5mesh]: %s texture map read in with handle %d\n", requests[i].filename.c_str(), textureHandle);
 	}
-	return textureHandle;
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+	printf( "[.md5mesh]: %d of %d texture maps loaded in %.1f ms\n", numLoaded, (int)requests.size(), chrono::duration< double, milli >( chrono::steady_clock::now() - start ).count() );
 }
 
 /**
@@ -156,6 +199,8 @@ int read_MD5_model(const char *filename, struct md5_model_t *mdl) {
 	double minX =  999999, minY =  999999, minZ =  999999;
 	double maxX = -999999, maxY = -999999, maxZ = -999999;
 
+	vector< md5_texture_request_t > textureRequests;
+
 	printf( "[.md5mesh]: about to read %s\n", filename );
 
 	fp = fopen (filename, "rb");
@@ -229,34 +274,14 @@ int read_MD5_model(const char *filename, struct md5_model_t *mdl) {
 						}
 					}
 
-					/* there was a shader name */
+					/* there was a shader name: diffuse, specular, normal, and height maps */
 					if( j > 0 ) {
-						string diffuseMapFN = string(mesh->shader) + ".tga";
-						mesh->textures[0].texHandle = loadTexture( diffuseMapFN );
-						if( mesh->textures[0].texHandle == 0 ) {
-							diffuseMapFN = string(mesh->shader) + ".png";
-							mesh->textures[0].texHandle = loadTexture( diffuseMapFN );
-						}
-
-						string specularMapFN = string(mesh->shader) + "_s.tga";
-						mesh->textures[1].texHandle = loadTexture( specularMapFN );
-						if( mesh->textures[1].texHandle == 0 ) {
-							specularMapFN = string(mesh->shader) + "_s.png";
-							mesh->textures[1].texHandle = loadTexture( specularMapFN );
-						}
-
-						string normalMapFN = string(mesh->shader) + "_local.tga";
-						mesh->textures[2].texHandle = loadTexture( normalMapFN );
-						if( mesh->textures[2].texHandle == 0 ) {
-							normalMapFN = string(mesh->shader) + "_local.png";
-							mesh->textures[2].texHandle = loadTexture( normalMapFN );
-						}
-
-						string heightMapFN = string(mesh->shader) + "_h.tga";
-						mesh->textures[3].texHandle = loadTexture( heightMapFN );
-						if( mesh->textures[3].texHandle == 0 ) {
-							heightMapFN = string(mesh->shader) + "_h.png";
-							mesh->textures[3].texHandle = loadTexture( heightMapFN );
+						static const char *SUFFIXES[4] = { "", "_s", "_local", "_h" };
+						for( int t = 0; t < 4; t++ ) {
+							md5_texture_request_t request;
+							request.filename = findTexture( mesh->shader, SUFFIXES[t] );
+							request.texHandle = &mesh->textures[t].texHandle;
+							textureRequests.push_back( request );
 						}
 					}
 				} else if (sscanf (buff, " numverts %d", &mesh->num_verts) == 1) {
@@ -327,6 +352,8 @@ int read_MD5_model(const char *filename, struct md5_model_t *mdl) {
 
 	fclose (fp);
 
+	loadTextures( textureRequests );
+
 	printf( "[.md5mesh]: finished reading %s\n", filename );
 	printf( "[.md5mesh]: read in %d meshes, %d joints, %d vertices, %d weights, and %d triangles\n", mdl->num_meshes, mdl->num_joints, totVert, totWeights, totTris );
 	printf( "[.md5mesh]: base pose %f units across in X, %f units across in Y, %f units across in Z\n", (maxX - minX), (maxY-minY), (maxZ - minZ) );
@@ -30,6 +30,7 @@
 #include <CSCI441/objects3.hpp>     // to render our 3D primitives
 #include <CSCI441/OpenGLUtils3.hpp> // to print info about OpenGL
 #include <CSCI441/ShaderProgram3.hpp>   // our shader helper functions
+#include <CSCI441/textureRegistry3.hpp> // to bind textures with their samplers
 #include <CSCI441/TextureUtils.hpp>   // our texture helper functions
 #include <iostream>
 
@@ -419,7 +420,8 @@ double temp;
     glBufferSubData(GL_ARRAY_BUFFER,0,sizeof(orderedPoints),orderedPoints);
 
 	// LOOKHERE #4
-	glBindTexture( GL_TEXTURE_2D, textureHandle );
+	// bound through the registry so the sampler the model left on the unit is cleared
+	CSCI441::TextureRegistry::bindTexture( GL_TEXTURE0, textureHandle );
 	glDrawArrays( GL_POINTS, 0, NUM_POINTS );
 }
 
@@ -25,6 +25,7 @@ private:
   double _radius;
   double _rotation;
   glm::vec4 _color;
+  mutable GLint _lodLevel;		// sphere tessellation used last frame, see CSCI441::drawSolidSphereLOD()
 };
 
 #endif	// _MARBLE_H_
@@ -32,6 +32,9 @@
 
 #include <CSCI441/objects3.hpp>
 #include <CSCI441/ShaderProgram3.hpp>
+#include <CSCI441/skybox3.hpp>
+#include <CSCI441/textureRegistry3.hpp>
+#include <CSCI441/textureStreamer3.hpp>
 #include <CSCI441/TextureUtils.hpp>
 
 #include "include/Marble.h"
@@ -54,9 +57,9 @@ GLuint platformVAOd;
 GLuint platformTextureHandle;
 GLuint brickTexHandle;
 
-const unsigned int NUM_WALLS = 6;
-GLuint skyboxVAOds[NUM_WALLS];						// all of our skybox VAOs
-GLuint skyboxHandles[NUM_WALLS];                    // all of our skybox handles
+CSCI441::TextureStreamer* textureStreamer = NULL;	// textures that sharpen over the first frames
+
+CSCI441::Skybox* skybox = NULL;						// all six skybox faces in one cube map
 
 CSCI441::ShaderProgram* textureShaderProgram = NULL;
 struct TextureShaderUniformLocations {
@@ -70,6 +73,15 @@ struct TextureShaderAttributeLocations {
     GLint vTextureCoord;
 } textureShaderAttributes;
 
+CSCI441::ShaderProgram* skyboxShaderProgram = NULL;
+struct SkyboxShaderUniformLocations {
+    GLint viewProjectionMtx;
+    GLint skybox;
+} skyboxShaderUniforms;
+struct SkyboxShaderAttributeLocations {
+    GLint vPos;
+} skyboxShaderAttributes;
+
 std::vector< Marble* > marbles;
 const GLfloat GROUND_SIZE = 10;
 const GLfloat MARBLE_RADIUS = 1.0;
@@ -103,11 +115,9 @@ bool registerOpenGLTexture(unsigned char *textureData,
     glGenTextures(1, &textureHandle);
     glBindTexture(GL_TEXTURE_2D, textureHandle);
 
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texWidth, texHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, textureData);
+    CSCI441::TextureRegistry::registerTexture(textureHandle, GL_TEXTURE_2D, GL_RGB, texWidth, texHeight, 1, 1,
+                                              CSCI441::TextureRegistry::getSampler(GL_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT));
 
     return true;
 }
@@ -137,6 +147,10 @@ static void error_callback(int error, const char* description) {
 static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if( (key == GLFW_KEY_ESCAPE || key == 'Q') && action == GLFW_PRESS )
         glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+    // list every texture's memory and the last frame's binds
+    if( key == 'T' && action == GLFW_PRESS )
+        CSCI441::TextureRegistry::printReport();
 }
 
 // mouse_button_callback() /////////////////////////////////////////////////////
@@ -319,17 +333,21 @@ void setupGLEW() {
 //
 ////////////////////////////////////////////////////////////////////////////////
 void setupTextures() {
-    platformTextureHandle = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/metal.jpg" );
+    // decoded in the background and uploaded a few rows a frame from the render loop
+    textureStreamer = new CSCI441::TextureStreamer();
+    platformTextureHandle = textureStreamer->request( "textures/metal.jpg" );
 
-    // and get handles for our full skybox
+    // and load our full skybox into one cube map, in +X, -X, +Y, -Y, +Z, -Z order
     printf( "[INFO]: registering skybox...\n" );
-    skyboxHandles[0] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/back.png"   );
-    skyboxHandles[1] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/left.png"   );
-    skyboxHandles[2] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/front.png"  );
-    skyboxHandles[3] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/right.png"  );
-    skyboxHandles[4] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/bottom.png" );
-    skyboxHandles[5] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/top.png"    );
-    printf( "[INFO]: ...skybox textures read in and registered!\n\n" );
+    const char* skyboxFaces[6] = {
+            "textures/skybox/right.png",  "textures/skybox/left.png",
+            "textures/skybox/top.png",    "textures/skybox/bottom.png",
+            "textures/skybox/back.png",   "textures/skybox/front.png"
+    };
+    skybox = new CSCI441::Skybox();
+    if( skybox->load( skyboxFaces ) ) {
+        printf( "[INFO]: ...skybox textures read in and registered in %.1f ms!\n\n", skybox->getLoadTime() );
+    }
 
     unsigned char *brickTexData;
     int brickTexWidth, brickTexHeight;
@@ -348,6 +366,13 @@ void setupShaders() {
 
     textureShaderAttributes.vPos            = textureShaderProgram->getAttributeLocation( "vPos" );
     textureShaderAttributes.vTextureCoord   = textureShaderProgram->getAttributeLocation( "vTextureCoord" );
+
+    skyboxShaderProgram = new CSCI441::ShaderProgram( "shaders/skybox.v.glsl", "shaders/skybox.f.glsl" );
+
+    skyboxShaderUniforms.viewProjectionMtx  = skyboxShaderProgram->getUniformLocation( "viewProjectionMtx" );
+    skyboxShaderUniforms.skybox             = skyboxShaderProgram->getUniformLocation( "skybox" );
+
+    skyboxShaderAttributes.vPos             = skyboxShaderProgram->getAttributeLocation( "vPos" );
 }
 
 // setupBuffers() //////////////////////////////////////////////////////////////
@@ -393,79 +418,6 @@ void setupBuffers() {
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vbods[1] );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( platformIndices ), platformIndices, GL_STATIC_DRAW );
-
-    //////////////////////////////////////////
-    //
-    // SKYBOX
-
-    VertexTextured skyboxVerts[NUM_WALLS][4] = {
-            // back
-            {
-                    { -40.0f, -40.0f, -40.0f,   0.0f,   0.0f }, // 0 - BL
-                    { -40.0f, -40.0f,  40.0f,  -1.0f,   0.0f }, // 1 - BR
-                    { -40.0f,  40.0f, -40.0f,   0.0f,   1.0f }, // 2 - TL
-                    { -40.0f,  40.0f,  40.0f,  -1.0f,   1.0f }  // 3 - TR
-            },
-
-            // right
-            {
-                    { -40.0f, -40.0f,  40.0f,   0.0f,   0.0f }, // 0 - BL
-                    {  40.0f, -40.0f,  40.0f,  -1.0f,   0.0f }, // 1 - BR
-                    { -40.0f,  40.0f,  40.0f,   0.0f,   1.0f }, // 2 - TL
-                    {  40.0f,  40.0f,  40.0f,  -1.0f,   1.0f }  // 3 - TR
-            },
-
-            // front
-            {
-                    {  40.0f, -40.0f, -40.0f,   0.0f,   0.0f }, // 0 - BL
-                    {  40.0f, -40.0f,  40.0f,   1.0f,   0.0f }, // 1 - BR
-                    {  40.0f,  40.0f, -40.0f,   0.0f,   1.0f }, // 2 - TL
-                    {  40.0f,  40.0f,  40.0f,   1.0f,   1.0f }  // 3 - TR
-            },
-
-            // left
-            {
-                    { -40.0f, -40.0f, -40.0f,   0.0f,   0.0f }, // 0 - BL
-                    {  40.0f, -40.0f, -40.0f,   1.0f,   0.0f }, // 1 - BR
-                    { -40.0f,  40.0f, -40.0f,   0.0f,   1.0f }, // 2 - TL
-                    {  40.0f,  40.0f, -40.0f,   1.0f,   1.0f }  // 3 - TR
-            },
-
-            // ground
-            {
-                    { -40.0f, -40.0f, -40.0f,   1.0f,   1.0f }, // 0 - BL
-                    {  40.0f, -40.0f, -40.0f,   1.0f,   0.0f }, // 1 - BR
-                    { -40.0f, -40.0f,  40.0f,   0.0f,   1.0f }, // 2 - TL
-                    {  40.0f, -40.0f,  40.0f,   0.0f,   0.0f }  // 3 - TR
-            },
-
-            // top
-            {
-                    { -40.0f,  40.0f, -40.0f,   1.0f,  -1.0f }, // 0 - BL
-                    {  40.0f,  40.0f, -40.0f,   1.0f,   0.0f }, // 1 - BR
-                    { -40.0f,  40.0f,  40.0f,   0.0f,  -1.0f }, // 2 - TL
-                    {  40.0f,  40.0f,  40.0f,   0.0f,   0.0f }  // 3 - TR
-            }
-    };
-
-    unsigned short skyBoxIndices[4] = {
-            0, 1, 2, 3
-    };
-
-    glGenVertexArrays( 6, skyboxVAOds );
-
-    for( unsigned int i = 0; i < NUM_WALLS; i++ ) {
-        glBindVertexArray( skyboxVAOds[i] );
-        glGenBuffers( 2, vbods );
-        glBindBuffer( GL_ARRAY_BUFFER, vbods[0] );
-        glBufferData( GL_ARRAY_BUFFER, sizeof(skyboxVerts[i]), skyboxVerts[i], GL_STATIC_DRAW );
-        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vbods[1] );
-        glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(skyBoxIndices), skyBoxIndices, GL_STATIC_DRAW );
-        glEnableVertexAttribArray(textureShaderAttributes.vPos);
-        glVertexAttribPointer(textureShaderAttributes.vPos, 3, GL_FLOAT, GL_FALSE, sizeof(VertexTextured), (void*) 0);
-        glEnableVertexAttribArray(textureShaderAttributes.vTextureCoord);
-        glVertexAttribPointer(textureShaderAttributes.vTextureCoord, 2, GL_FLOAT, GL_FALSE, sizeof(VertexTextured), (void*) (sizeof(float) * 3));
-    }
 }
 
 void populateMarbles() {
@@ -503,23 +455,24 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
     glUniform1ui(textureShaderUniforms.tex, GL_TEXTURE0);
     glUniform4fv(textureShaderUniforms.color, 1, &white[0]);
 
-    // draw the skybox
-    for( unsigned int i = 0; i < 6; i++ ) {
-        glBindTexture( GL_TEXTURE_2D, skyboxHandles[i] );
-        glBindVertexArray( skyboxVAOds[i] );
-        glDrawElements( GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, (void*)0 );
-    }
-
     // draw the platform
-    glBindTexture( GL_TEXTURE_2D, platformTextureHandle );
+    CSCI441::TextureRegistry::bindTexture( GL_TEXTURE0, platformTextureHandle );
     glBindVertexArray( platformVAOd );
     glDrawElements( GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, (void*)0 );
 
-    // draw the marbles
-    glBindTexture( GL_TEXTURE_2D, brickTexHandle );
+    // draw the marbles, tessellated by how large they appear
+    CSCI441::TextureRegistry::bindTexture( GL_TEXTURE0, brickTexHandle );
+    CSCI441::setLevelOfDetailView( viewMatrix, projectionMatrix, windowHeight );
     for( auto marble : marbles ) {
         marble->draw( modelMatrix, textureShaderUniforms.modelMtx, textureShaderUniforms.color );
     }
+
+    // draw the skybox last so only the pixels nothing else covered are shaded
+    skyboxShaderProgram->useProgram();
+    glm::mat4 skyboxViewProjection = projectionMatrix * glm::mat4( glm::mat3( viewMatrix ) );
+    glUniformMatrix4fv(skyboxShaderUniforms.viewProjectionMtx, 1, GL_FALSE, &skyboxViewProjection[0][0]);
+    glUniform1i(skyboxShaderUniforms.skybox, 0);
+    skybox->draw( skyboxShaderAttributes.vPos );
 }
 
 void moveMarbles() {
@@ -631,6 +584,7 @@ int main( int argc, char *argv[] ) {
     //	until the user decides to close the window and quit the program.  Without a loop, the
     //	window will display once and then the program exits.
     while( !glfwWindowShouldClose(window) ) {	// check if the window was instructed to be closed
+        CSCI441::TextureRegistry::beginFrame();     // close out the last frame's texture binds
         glDrawBuffer( GL_BACK );				// work with our back frame buffer
         glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );	// clear the current color contents and depth buffer in the window
 
@@ -650,6 +604,10 @@ int main( int argc, char *argv[] ) {
         // set up our look at matrix to position our camera
         glm::mat4 viewMatrix = glm::lookAt( eyePoint,lookAtPoint, upVector );
 
+        // sharpen the platform only as far as it shows, measured across its corners
+        textureStreamer->setScreenSize( platformTextureHandle, CSCI441::TextureStreamer::projectedSize( viewMatrix, projectionMatrix, glm::vec3( 0.0f, 0.0f, 0.0f ), ( GROUND_SIZE + MARBLE_RADIUS ) * 1.41421356f, windowHeight ) );
+        textureStreamer->update();
+
         // draw everything to the window
         // pass our view and projection matrices as well as deltaTime between frames
         renderScene( viewMatrix, projectionMatrix );
@@ -667,4 +625,4 @@ int main( int argc, char *argv[] ) {
     glfwTerminate();						// shut down GLFW to clean up our context
 
     return EXIT_SUCCESS;				// exit our program successfully!
-}
\ No newline at end of file
+}
\ No newline at end of file
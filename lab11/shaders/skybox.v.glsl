@@ -0,0 +1,15 @@
+#version 330 core
+
+in vec3 vPos;
+
+out vec3 direction;
+
+// view matrix without its translation, so the sky stays centered on the camera
+uniform mat4 viewProjectionMtx;
+
+void main() {
+  // z = w puts the sky on the far plane, behind everything drawn before it
+  gl_Position = ( viewProjectionMtx * vec4(vPos, 1.0) ).xyww;
+  // front.png faces +x and right.png faces -z; turn them onto the cube map's -Z and +X faces
+  direction = vec3( -vPos.z, vPos.y, -vPos.x );
+}
@@ -12,6 +12,7 @@ Marble::Marble() {
     location = glm::vec3(0,0,0);
     direction = glm::vec3(1,0,0);
     _rotation = 0;
+    _lodLevel = -1;
     _color = glm::vec4(	rand() % 50 / 100.0 + 0.5, 
 						rand() % 50 / 100.0 + 0.5, 
 						rand() % 50 / 100.0 + 0.5,
@@ -20,6 +21,7 @@ Marble::Marble() {
 
 Marble::Marble( glm::vec3 l, glm::vec3 d, double r ) : location(l), direction(d), _radius(r) {
     _rotation = 0;
+    _lodLevel = -1;
     _color = glm::vec4(rand() % 50 / 100.0 + 0.5, 
 					   rand() % 50 / 100.0 + 0.5, 
 					   rand() % 50 / 100.0 + 0.5,
@@ -38,7 +40,7 @@ void Marble::draw( glm::mat4 modelMtx, GLint uniform_modelMtx_loc, GLint uniform
 
     glUniform4fv( uniform_color_loc, 1, &_color[0] );
 
-    CSCI441::drawSolidSphere( _radius, 16, 16 );
+    CSCI441::drawSolidSphereLOD( _radius, modelMtx, &_lodLevel );
 }
 
 void Marble::moveForward() {
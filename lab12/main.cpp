@@ -34,6 +34,9 @@
 #include <CSCI441/modelLoader3.hpp>
 #include <CSCI441/objects3.hpp>
 #include <CSCI441/ShaderProgram3.hpp>
+#include <CSCI441/skybox3.hpp>
+#include <CSCI441/textureRegistry3.hpp>
+#include <CSCI441/textureStreamer3.hpp>
 
 
 //******************************************************************************
@@ -53,8 +56,9 @@ glm::vec3 upVector( 0.0f, 1.0f, 0.0f );
 GLuint platformVAOd;
 GLuint platformTextureHandle;
 
-GLuint skyboxVAOds[6];                      // all of our skybox VAOs
-GLuint skyboxHandles[6];                    // all of our skybox handles
+CSCI441::TextureStreamer *textureStreamer = NULL;   // textures that sharpen over the first frames
+
+CSCI441::Skybox *skybox = NULL;             // all six skybox faces in one cube map
 
 CSCI441::ShaderProgram *textureShaderProgram = NULL;
 struct TextureShaderUniformLocs {
@@ -68,6 +72,15 @@ struct TextureShaderAttributeLocs {
 	GLint vTextureCoord;
 } textureShaderAttributes;
 
+CSCI441::ShaderProgram *skyboxShaderProgram = NULL;
+struct SkyboxShaderUniformLocs {
+	GLint viewProjectionMtx;
+	GLint skybox;
+} skyboxShaderUniforms;
+struct SkyboxShaderAttributeLocs {
+	GLint vPos;
+} skyboxShaderAttributes;
+
 CSCI441::ShaderProgram *modelPhongShaderProgram = NULL;
 struct ModelPhongShaderUniformLocs {
 	GLint modelviewMtx;
@@ -133,11 +146,9 @@ bool registerOpenGLTexture( unsigned char *textureData,
     glGenTextures( 1, &textureHandle );
     glBindTexture( GL_TEXTURE_2D, textureHandle );
 
-    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
-    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
     glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB, texWidth, texHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, textureData );
+    CSCI441::TextureRegistry::registerTexture( textureHandle, GL_TEXTURE_2D, GL_RGB, texWidth, texHeight, 1, 1,
+                                               CSCI441::TextureRegistry::getSampler( GL_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT ) );
 
     return true;
 }
@@ -167,6 +178,10 @@ static void error_callback( int error, const char *description ) {
 static void key_callback( GLFWwindow *window, int key, int scancode, int action, int mods ) {
     if((key == GLFW_KEY_ESCAPE || key == 'Q') && action == GLFW_PRESS )
         glfwSetWindowShouldClose( window, GLFW_TRUE );
+
+    // list every texture's memory and the last frame's binds
+    if( key == 'T' && action == GLFW_PRESS )
+        CSCI441::TextureRegistry::printReport();
 }
 
 // mouse_button_callback() /////////////////////////////////////////////////////
@@ -352,18 +367,22 @@ void setupGLEW() {
 //
 ////////////////////////////////////////////////////////////////////////////////
 void setupTextures() {
-    platformTextureHandle = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/ground.png" );
+    // decoded in the background and uploaded a few rows a frame from the render loop
+    textureStreamer = new CSCI441::TextureStreamer();
+    platformTextureHandle = textureStreamer->request( "textures/ground.png" );
 
-    // and get handles for our full skybox
+    // and load our full skybox into one cube map, in +X, -X, +Y, -Y, +Z, -Z order
     printf( "[INFO]: registering skybox...\n" );
     fflush( stdout );
-    skyboxHandles[0] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/DOOM16BK.png" );
-    skyboxHandles[1] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/DOOM16RT.png" );
-    skyboxHandles[2] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/DOOM16FT.png" );
-	skyboxHandles[3] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/DOOM16LF.png" );
-    skyboxHandles[4] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/DOOM16DN.png" );
-    skyboxHandles[5] = CSCI441::TextureUtils::loadAndRegisterTexture( "textures/skybox/DOOM16UP.png" );
-    printf( "[INFO]: skybox textures read in and registered!\n\n" );
+    const char *skyboxFaces[6] = {
+            "textures/skybox/DOOM16RT.png", "textures/skybox/DOOM16LF.png",
+            "textures/skybox/DOOM16UP.png", "textures/skybox/DOOM16DN.png",
+            "textures/skybox/DOOM16FT.png", "textures/skybox/DOOM16BK.png"
+    };
+    skybox = new CSCI441::Skybox();
+    if( skybox->load( skyboxFaces )) {
+        printf( "[INFO]: skybox textures read in and registered in %.1f ms!\n\n", skybox->getLoadTime() );
+    }
 }
 
 void setupShaders() {
@@ -375,6 +394,11 @@ void setupShaders() {
     textureShaderAttributes.vPos            = textureShaderProgram->getAttributeLocation( "vPos" );
     textureShaderAttributes.vTextureCoord   = textureShaderProgram->getAttributeLocation( "vTextureCoord" );
 
+    skyboxShaderProgram = new CSCI441::ShaderProgram( "shaders/skybox.v.glsl", "shaders/skybox.f.glsl" );
+    skyboxShaderUniforms.viewProjectionMtx  = skyboxShaderProgram->getUniformLocation( "viewProjectionMtx" );
+    skyboxShaderUniforms.skybox             = skyboxShaderProgram->getUniformLocation( "skybox" );
+    skyboxShaderAttributes.vPos             = skyboxShaderProgram->getAttributeLocation( "vPos" );
+
     modelPhongShaderProgram = new CSCI441::ShaderProgram( "shaders/texturingPhong.v.glsl", "shaders/texturingPhong.f.glsl" );
     modelPhongShaderUniforms.modelviewMtx      = modelPhongShaderProgram->getUniformLocation( "modelviewMtx" );
     modelPhongShaderUniforms.viewMtx           = modelPhongShaderProgram->getUniformLocation( "viewMtx" );
@@ -411,6 +435,8 @@ void setupBuffers() {
     //
     // Model
 
+    // the street's textures go in one array texture the model binds once per draw
+    CSCI441::ModelLoader::enableTexturePacking();
     model = new CSCI441::ModelLoader();
     model->loadModelFile( "models/medstreet/medstreet.obj" );
 
@@ -447,74 +473,6 @@ void setupBuffers() {
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vbods[1] );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( platformIndices ), platformIndices, GL_STATIC_DRAW );
 
-    //////////////////////////////////////////
-    //
-    // SKYBOX
-
-    unsigned short skyboxIndices[4] = {
-            0, 1, 2, 3
-    };
-
-    const GLfloat SKYBOX_SIZE = 40.0f;
-    VertexTextured skyboxVertices[6][4] = {
-            { // back
-                {-SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  0.0f}, // 0 - BL
-                {-SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE,  -1.0f,  0.0f}, // 1 - BR
-                {-SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  1.0f}, // 2 - TL
-                {-SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE,  -1.0f,  1.0f}  // 3 - TR
-            },
-
-            { // right
-                {-SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE,   0.0f,  0.0f}, // 0 - BL
-                { SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE,  -1.0f,  0.0f}, // 1 - BR
-                {-SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE,   0.0f,  1.0f}, // 2 - TL
-                { SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE,  -1.0f,  1.0f}  // 3 - TR
-            },
-
-            { // front
-                { SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  0.0f}, // 0 - BL
-                { SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE,   1.0f,  0.0f}, // 1 - BR
-                { SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  1.0f}, // 2 - TL
-                { SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE,   1.0f,  1.0f}  // 3 - TR
-            },
-
-            { // left
-                {-SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  0.0f}, // 0 - BL
-                { SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE,   1.0f,  0.0f}, // 1 - BR
-                {-SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  1.0f}, // 2 - TL
-                { SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE,   1.0f,  1.0f}  // 3 - TR
-            },
-
-            { // bottom
-                {-SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  0.0f}, // 0 - BL
-                { SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE,   0.0f,  1.0f}, // 1 - BR
-                {-SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE,   1.0f,  0.0f}, // 2 - TL
-                { SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE,   1.0f,  1.0f}  // 3 - TR
-            },
-
-            { // top
-                {-SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE,  -1.0f,  1.0f}, // 0 - BL
-                { SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE,  -1.0f,  0.0f}, // 1 - BR
-                {-SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE,   0.0f,  1.0f}, // 2 - TL
-                { SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE,   0.0f,  0.0f}  // 3 - TR
-            }
-    };
-
-    glGenVertexArrays( 6, skyboxVAOds );
-
-    for( int i = 0; i < 6; i++ ) {
-        glBindVertexArray( skyboxVAOds[i] );
-        glGenBuffers( 2, vbods );
-        glBindBuffer( GL_ARRAY_BUFFER, vbods[0] );
-        glBufferData( GL_ARRAY_BUFFER, sizeof( skyboxVertices[i] ), skyboxVertices[i], GL_STATIC_DRAW );
-        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vbods[1] );
-        glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( skyboxIndices ), skyboxIndices, GL_STATIC_DRAW );
-        glEnableVertexAttribArray( textureShaderAttributes.vPos );
-        glVertexAttribPointer( textureShaderAttributes.vPos, 3, GL_FLOAT, GL_FALSE, sizeof( VertexTextured ), (void *)0 );
-        glEnableVertexAttribArray( textureShaderAttributes.vTextureCoord );
-        glVertexAttribPointer( textureShaderAttributes.vTextureCoord, 2, GL_FLOAT, GL_FALSE, sizeof( VertexTextured ), (void *)(sizeof( float ) * 3));
-    }
-
     //////////////////////////////////////////
     //
     // TEXTURED QUAD
@@ -557,10 +515,8 @@ void setupFramebuffer() {
     glBindTexture(GL_TEXTURE_2D, framebufferTextureHandle);
     glActiveTexture(framebufferTextureHandle);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, framebufferWidth, framebufferHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE );
-    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE );
+    CSCI441::TextureRegistry::registerTexture( framebufferTextureHandle, GL_TEXTURE_2D, GL_RGBA, framebufferWidth, framebufferHeight, 1, 1,
+                                               CSCI441::TextureRegistry::getSampler( GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE ), "framebuffer" );
 
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, framebufferTextureHandle, 0);
 
@@ -591,15 +547,8 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
     glm::vec3 white( 1, 1, 1 );
     glUniform3fv( textureShaderUniforms.color, 1, &white[0] );
 
-    // draw the skybox
-    for( unsigned int i = 0; i < 6; i++ ) {
-        glBindTexture( GL_TEXTURE_2D, skyboxHandles[i] );
-        glBindVertexArray( skyboxVAOds[i] );
-        glDrawElements( GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, (void *)0 );
-    }
-
     // draw the platform
-    glBindTexture( GL_TEXTURE_2D, platformTextureHandle );
+    CSCI441::TextureRegistry::bindTexture( GL_TEXTURE0, platformTextureHandle );
     glBindVertexArray( platformVAOd );
     glDrawElements( GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, (void *)0 );
 
@@ -621,6 +570,13 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
     model->draw( modelPhongShaderAttributes.vPos, modelPhongShaderAttributes.vNorm, modelPhongShaderAttributes.vTexCoord,
                  modelPhongShaderUniforms.materialDiffuse, modelPhongShaderUniforms.materialSpecular, modelPhongShaderUniforms.materialShininess, modelPhongShaderUniforms.materialAmbient,
                  GL_TEXTURE0 );
+
+    // draw the skybox last so only the pixels nothing else covered are shaded
+    skyboxShaderProgram->useProgram();
+    glm::mat4 skyboxViewProjection = projectionMatrix * glm::mat4( glm::mat3( viewMatrix ));
+    glUniformMatrix4fv( skyboxShaderUniforms.viewProjectionMtx, 1, GL_FALSE, &skyboxViewProjection[0][0] );
+    glUniform1i( skyboxShaderUniforms.skybox, 0 );
+    skybox->draw( skyboxShaderAttributes.vPos );
 }
 
 ///*****************************************************************************
@@ -651,6 +607,7 @@ int main( int argc, char *argv[] ) {
     //	until the user decides to close the window and quit the program.  Without a loop, the
     //	window will display once and then the program exits.
     while( !glfwWindowShouldClose( window )) {    // check if the window was instructed to be closed
+        CSCI441::TextureRegistry::beginFrame();    // close out the last frame's texture binds
         // Get the size of our window framebuffer.  Ideally this should be the same dimensions as our window, but
         // when using a Retina display the actual window can be larger than the requested window.  Therefore
         // query what the actual size of the window we are rendering to is.
@@ -673,6 +630,10 @@ int main( int argc, char *argv[] ) {
         // set up our look at matrix to position our camera
         glm::mat4 viewMatrix = glm::lookAt( eyePoint, lookAtPoint, upVector );
 
+        // sharpen the platform only as far as it shows, measured across its corners
+        textureStreamer->setScreenSize( platformTextureHandle, CSCI441::TextureStreamer::projectedSize( viewMatrix, projectionMatrix, glm::vec3( 0.0f, 0.0f, 0.0f ), 20.0f * 1.41421356f, framebufferHeight ) );
+        textureStreamer->update();
+
         // pass our view and projection matrices
         renderScene( viewMatrix, projectionMatrix );
         glFlush();
@@ -689,7 +650,7 @@ int main( int argc, char *argv[] ) {
         postprocessingShaderProgram->useProgram();
         glUniformMatrix4fv(postShaderUniforms.projectionMtx, 1, GL_FALSE, &projeMatrix[0][0]);
 
-        glBindTexture(GL_TEXTURE_2D, framebufferTextureHandle);
+        CSCI441::TextureRegistry::bindTexture(GL_TEXTURE0, framebufferTextureHandle);
         glBindVertexArray(texturedQuadVAO);
         glDrawArrays(GL_TRIANGLE_STRIP, 0,4);
 
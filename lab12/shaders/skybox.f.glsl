@@ -0,0 +1,11 @@
+#version 330 core
+
+in vec3 direction;
+
+out vec4 fragColorOut;
+
+uniform samplerCube skybox;
+
+void main() {
+  fragColorOut = texture( skybox, direction );
+}
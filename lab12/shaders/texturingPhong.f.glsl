@@ -3,7 +3,7 @@
 in vec3 normalVec;
 in vec3 lightVec;
 in vec3 halfwayVec;
-in vec2 texCoord;
+in vec3 texCoord;
 
 const vec4 lightDiffuse = vec4(1.0, 1.0, 1.0, 1.0);
 const vec4 lightSpecular = vec4(1.0, 1.0, 1.0, 1.0);
@@ -13,7 +13,7 @@ uniform vec4 materialDiffuse;
 uniform vec4 materialSpecular;
 uniform float materialShininess;
 uniform vec4 materialAmbient;
-uniform sampler2D txtr;
+uniform sampler2DArray txtr;
 
 out vec4 fragColorOut;
 
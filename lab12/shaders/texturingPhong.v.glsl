@@ -2,12 +2,12 @@
 
 in vec3 vPos;
 in vec3 vNormal;
-in vec2 vTexCoord;
+in vec3 vTexCoord;
 
 out vec3 normalVec;
 out vec3 lightVec;
 out vec3 halfwayVec;
-out vec2 texCoord;
+out vec3 texCoord;
 
 uniform mat4 modelviewMtx;
 uniform mat4 viewMtx;
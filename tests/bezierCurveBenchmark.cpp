@@ -0,0 +1,105 @@
+/*
+ *  bezierCurveBenchmark.cpp
+ *
+ *  Frame time of lab03's Bezier curve against its number of control
+ *  points, at lab03's 10000 samples per segment.  Compares the immediate
+ *  mode renderer lab03 used to have (nine pow() calls per sample, every
+ *  frame) against BezierCurve's cached polyline, and times the update
+ *  after one control point moves.
+ *
+ *  usage: bezierCurveBenchmark [frames=20]
+ */
+
+#include "glBenchmark.hpp"
+#include "testHarness.hpp"
+
+#include "../lab03/include/BezierCurve.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+static const unsigned int RESOLUTION = 10000;
+
+// lab03's old evaluateBezierCurve()
+static glm::vec3 evaluateBezierCurve( glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, float t ) {
+	glm::vec3 point;
+	point.x = pow((1.0f - t), 3) * p0.x + pow((1.0f - t), 2) * p1.x * 3.0f * t + (1.0f - t) * (pow(t, 2)) * 3.0 * p2.x + pow(t, 3) * p3.x;
+	point.y = pow((1.0f - t), 3) * p0.y + pow((1.0f - t), 2) * p1.y * 3.0f * t + (1.0f - t) * (pow(t, 2)) * 3.0 * p2.y + pow(t, 3) * p3.y;
+	point.z = pow((1.0f - t), 3) * p0.z + pow((1.0f - t), 2) * p1.z * 3.0f * t + (1.0f - t) * (pow(t, 2)) * 3.0 * p2.z + pow(t, 3) * p3.z;
+	return point;
+}
+
+// lab03's old renderBezierCurve() loop over every segment
+static void renderImmediateCurve( const std::vector<glm::vec3> &controlPoints ) {
+	for( size_t i = 0; i + 3 < controlPoints.size(); i += 3 ) {
+		glBegin( GL_LINE_STRIP );
+		for( float t = 0.0f; t <= 1.0f; t += 1.0f / RESOLUTION ) {
+			glm::vec3 point = evaluateBezierCurve( controlPoints[i], controlPoints[i+1], controlPoints[i+2], controlPoints[i+3], t );
+			glVertex3f( point.x, point.y, point.z );
+		}
+		glEnd();
+	}
+}
+
+static double timeFrame( void (*render)( void* ), void *data ) {
+	double start = TestHarness::now();
+	glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+	render( data );
+	glFinish();
+	return TestHarness::now() - start;
+}
+
+static void renderImmediate( void *data ) { renderImmediateCurve( *(std::vector<glm::vec3>*)data ); }
+static void renderCached( void *data ) { ((BezierCurve*)data)->draw(); }
+
+int main( int argc, char *argv[] ) {
+	const int frames = argc > 1 ? atoi( argv[1] ) : 20;
+	GLFWwindow *window = GLBenchmark::openHiddenWindow( 1280, 720 );
+
+	glMatrixMode( GL_PROJECTION );
+	glOrtho( -12.0, 12.0, -12.0, 12.0, -12.0, 12.0 );
+	glMatrixMode( GL_MODELVIEW );
+
+	printf( "[INFO]: %u samples per segment, ms per frame (with glFinish)\n", RESOLUTION );
+	printf( "[INFO]: control points   immediate   cached   first build   one point edit\n" );
+
+	const unsigned int pointCounts[] = { 7, 31, 301, 3001 };
+	for( size_t c = 0; c < sizeof( pointCounts ) / sizeof( pointCounts[0] ); c++ ) {
+		srand( 441 );
+		std::vector<glm::vec3> controlPoints;
+		for( unsigned int i = 0; i < pointCounts[c]; i++ )
+			controlPoints.push_back( glm::vec3( rand() % 2001 / 100.0f - 10.0f, rand() % 2001 / 100.0f - 10.0f, rand() % 2001 / 100.0f - 10.0f ) );
+
+		// the immediate renderer takes seconds per frame at the top end, so it gets fewer frames there
+		TestHarness::Timings immediate, cached, edit;
+		int immediateFrames = pointCounts[c] > 1000 ? 3 : frames;
+		for( int f = 0; f < immediateFrames; f++ ) immediate.add( timeFrame( renderImmediate, &controlPoints ) );
+
+		BezierCurve curve;
+		curve.setResolution( RESOLUTION );
+		curve.setControlPoints( controlPoints );
+		double buildStart = TestHarness::now();
+		curve.getNumVertices();						// evaluates the whole polyline
+		double build = TestHarness::now() - buildStart;
+
+		for( int f = 0; f < frames; f++ ) cached.add( timeFrame( renderCached, &curve ) );
+
+		for( int f = 0; f < frames; f++ ) {
+			unsigned int index = rand() % pointCounts[c];
+			curve.setControlPoint( index, controlPoints[index] + glm::vec3( 0.0f, 0.01f*f, 0.0f ) );
+			double editStart = TestHarness::now();
+			curve.getNumVertices();
+			edit.add( TestHarness::now() - editStart );
+		}
+
+		printf( "[INFO]: %14u   %9.2f   %6.2f   %11.2f   %14.3f\n", pointCounts[c], immediate.mean(), cached.mean(), build, edit.mean() );
+	}
+
+	GLenum error = glGetError();
+	GLBenchmark::closeWindow( window );
+	if( error != GL_NO_ERROR ) {
+		printf( "[FAIL]: bezierCurveBenchmark, GL error 0x%x\n", error );
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ *  bezierCurveTest.cpp
+ *
+ *  Checks lab03's BezierCurve against direct Bernstein evaluation: the
+ *  forward differenced polyline lands on the curve, a one point edit only
+ *  changes the segments that use the point, and a draw is one glDrawArrays
+ *  of the cached polyline.
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include "../lab03/include/BezierCurve.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+static glm::vec3 bernstein( const glm::vec3 *p, float t ) {
+	float s = 1.0f - t;
+	return s*s*s*p[0] + 3.0f*s*s*t*p[1] + 3.0f*s*t*t*p[2] + t*t*t*p[3];
+}
+
+static std::vector<glm::vec3> randomControlPoints( unsigned int numPoints ) {
+	std::vector<glm::vec3> controlPoints;
+	for( unsigned int i = 0; i < numPoints; i++ )
+		controlPoints.push_back( glm::vec3( rand() % 2001 / 100.0f - 10.0f, rand() % 2001 / 100.0f - 10.0f, rand() % 2001 / 100.0f - 10.0f ) );
+	return controlPoints;
+}
+
+// the polyline the last draw handed to GL
+static std::vector<glm::vec3> drawnPolyline( BezierCurve &curve ) {
+	GLMock::resetCalls();
+	curve.draw();
+	std::vector<glm::vec3> polyline;
+	const std::vector<GLfloat> &vertices = GLMock::clientVertices();
+	for( size_t i = 0; i + 2 < vertices.size(); i += 3 )
+		polyline.push_back( glm::vec3( vertices[i], vertices[i+1], vertices[i+2] ) );
+	return polyline;
+}
+
+// largest distance between the polyline and the curve at the parameters it was sampled at
+static float maxError( const std::vector<glm::vec3> &polyline, const std::vector<glm::vec3> &controlPoints, unsigned int resolution ) {
+	float error = 0.0f;
+	for( size_t v = 0; v < polyline.size(); v++ ) {
+		unsigned int segment = v == 0 ? 0 : (v - 1) / resolution;
+		unsigned int step = v == 0 ? 0 : (v - 1) % resolution + 1;
+		error = std::max( error, glm::length( polyline[v] - bernstein( &controlPoints[segment*3], (float)step / resolution ) ) );
+	}
+	return error;
+}
+
+static void testPolylineLiesOnTheCurve() {
+	GLMock::reset();
+	srand( 441 );
+	std::vector<glm::vec3> controlPoints = randomControlPoints( 3*50 + 1 );
+
+	const unsigned int resolution = 10000;
+	BezierCurve curve;
+	curve.setResolution( resolution );
+	curve.setControlPoints( controlPoints );
+
+	std::vector<glm::vec3> polyline = drawnPolyline( curve );
+	CHECK( GLMock::calls( "glDrawArrays" ) == 1 );
+	CHECK( polyline.size() == 50*resolution + 1 );
+	CHECK( polyline.size() == curve.getNumVertices() );
+	CHECK( maxError( polyline, controlPoints, resolution ) < 1e-4f );
+
+	// each segment ends exactly on its last control point
+	for( unsigned int segment = 0; segment < 50 && polyline.size() == 50*resolution + 1; segment++ )
+		CHECK( polyline[ (segment+1)*resolution ] == controlPoints[ (segment+1)*3 ] );
+}
+
+static void testEditsMatchAFreshCurve() {
+	GLMock::reset();
+	srand( 1441 );
+	std::vector<glm::vec3> controlPoints = randomControlPoints( 3*20 + 1 );
+
+	BezierCurve edited;
+	edited.setResolution( 64 );
+	edited.setControlPoints( controlPoints );
+	drawnPolyline( edited );
+
+	// an end point shared by two segments, then an interior point
+	controlPoints[30] = glm::vec3( 5.0f, -3.0f, 2.0f );
+	edited.setControlPoint( 30, controlPoints[30] );
+	controlPoints[44] = glm::vec3( -7.0f, 1.0f, 0.5f );
+	edited.setControlPoint( 44, controlPoints[44] );
+
+	BezierCurve fresh;
+	fresh.setResolution( 64 );
+	fresh.setControlPoints( controlPoints );
+
+	std::vector<glm::vec3> editedPolyline = drawnPolyline( edited );
+	std::vector<glm::vec3> freshPolyline = drawnPolyline( fresh );
+	CHECK( editedPolyline.size() == freshPolyline.size() );
+	CHECK( editedPolyline == freshPolyline );
+}
+
+static void testUnchangedCurveIsNotEvaluatedAgain() {
+	GLMock::reset();
+	srand( 2441 );
+	BezierCurve curve;
+	curve.setResolution( 100 );
+	curve.setControlPoints( randomControlPoints( 3*10 + 1 ) );
+
+	std::vector<glm::vec3> first = drawnPolyline( curve );
+	std::vector<glm::vec3> second = drawnPolyline( curve );
+	CHECK( first == second );
+	CHECK( GLMock::calls( "glDrawArrays" ) == 1 );
+	CHECK( GLMock::totalCalls() == 4 );				// enable, pointer, draw, disable
+}
+
+int main() {
+	testPolylineLiesOnTheCurve();
+	testEditsMatchAFreshCurve();
+	testUnchangedCurveIsNotEvaluatedAgain();
+
+	return TestHarness::result( "bezierCurveTest" );
+}
@@ -0,0 +1,93 @@
+/*
+ *  bezierPatch3Test.cpp
+ *
+ *  Tessellates a flat sheet of patches through BezierPatchSet, at a
+ *  resolution small enough to run on one thread and at one large enough to
+ *  be split across worker threads, and checks the welded meshes against the
+ *  grid they must come out as.
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/bezierPatch3.hpp>
+
+#include <math.h>
+
+static const int SHEET_SIZE = 8;					// patches along each side of the sheet
+
+// a SHEET_SIZE x SHEET_SIZE sheet of unit patches in the y = 0 plane, facing +y
+static CSCI441::BezierPatchSet* buildSheet() {
+	const int pointsPerSide = SHEET_SIZE*3 + 1;
+	std::vector< glm::vec3 > controlPoints;
+	for( int z = 0; z < pointsPerSide; z++ )
+		for( int x = 0; x < pointsPerSide; x++ )
+			controlPoints.push_back( glm::vec3( x / 3.0f, 0.0f, z / 3.0f ) );
+
+	// u runs along +z and v along +x so dP/du x dP/dv points up
+	std::vector< GLuint > patchIndices;
+	std::vector< glm::vec4 > patchTexCoords;
+	for( int pz = 0; pz < SHEET_SIZE; pz++ ) {
+		for( int px = 0; px < SHEET_SIZE; px++ ) {
+			for( int i = 0; i < 4; i++ )
+				for( int j = 0; j < 4; j++ )
+					patchIndices.push_back( (pz*3 + i)*pointsPerSide + px*3 + j );
+			patchTexCoords.push_back( glm::vec4( (GLfloat)pz / SHEET_SIZE, (GLfloat)px / SHEET_SIZE, (GLfloat)(pz+1) / SHEET_SIZE, (GLfloat)(px+1) / SHEET_SIZE ) );
+		}
+	}
+	return new CSCI441::BezierPatchSet( controlPoints, patchIndices, patchTexCoords );
+}
+
+static void checkSheet( CSCI441::BezierPatchSet *sheet, GLint resolution ) {
+	const CSCI441::BezierPatchSet::Mesh &mesh = sheet->tessellate( resolution );
+
+	// seams weld, so the sheet is one grid of samples
+	const size_t samplesPerSide = SHEET_SIZE*(resolution-1) + 1;
+	CHECK( mesh.positions.size() == samplesPerSide*samplesPerSide );
+	CHECK( mesh.indices.size() == (size_t)SHEET_SIZE*SHEET_SIZE*(resolution-1)*(resolution-1)*6 );
+
+	bool flat = true, facingUp = true, onGrid = true;
+	for( size_t v = 0; v < mesh.positions.size(); v++ ) {
+		const glm::vec3 &position = mesh.positions[v];
+		const glm::vec3 &normal = mesh.normals[v];
+		flat = flat && fabs( position.y ) < 1e-5f;
+		facingUp = facingUp && normal.y > 0.9999f;
+
+		GLfloat gridX = position.x * (resolution-1), gridZ = position.z * (resolution-1);
+		onGrid = onGrid && fabs( gridX - floorf( gridX + 0.5f ) ) < 1e-3f && fabs( gridZ - floorf( gridZ + 0.5f ) ) < 1e-3f;
+	}
+	CHECK( flat );
+	CHECK( facingUp );
+	CHECK( onGrid );
+}
+
+static void testSingleThreadedTessellation() {
+	CSCI441::BezierPatchSet *sheet = buildSheet();
+	// 64 patches x 10 x 10 samples stays on the calling thread
+	checkSheet( sheet, 10 );
+	delete sheet;
+}
+
+static void testThreadedTessellation() {
+	CSCI441::BezierPatchSet *sheet = buildSheet();
+	// 64 patches x 40 x 40 samples is spread across the workers
+	checkSheet( sheet, 40 );
+	delete sheet;
+}
+
+static void testSetsShareBasisTables() {
+	// a second set at a resolution the first already used must find the same table
+	CSCI441::BezierPatchSet *first = buildSheet(), *second = buildSheet();
+	checkSheet( first, 24 );
+	checkSheet( second, 24 );
+	delete first;
+	delete second;
+}
+
+int main() {
+	testSingleThreadedTessellation();
+	testThreadedTessellation();
+	testSetsShareBasisTables();
+
+	return TestHarness::result( "bezierPatch3Test" );
+}
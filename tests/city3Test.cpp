@@ -0,0 +1,103 @@
+/*
+ *  city3Test.cpp
+ *
+ *  Checks the GL calls CSCI441::City makes against the mock: creating its
+ *  buffers leaves the caller's vertex array alone, the whole city is one
+ *  instanced draw, later frames only bind and draw, and a cull decides how
+ *  many instances the next draw renders.
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/city3.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+static void testUploadKeepsTheCallersElementBuffer() {
+	GLMock::reset();
+
+	// a caller's own VAO with its own index buffer, still bound when the city uploads
+	GLuint callerVAO, callerIBO;
+	glGenVertexArrays( 1, &callerVAO );
+	glBindVertexArray( callerVAO );
+	glGenBuffers( 1, &callerIBO );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, callerIBO );
+
+	CSCI441::City city( 441, 21, 21 );
+	city.upload();
+	CHECK( GLMock::boundVertexArray() == callerVAO );
+	CHECK( GLMock::elementBuffer( callerVAO ) == callerIBO );
+
+	// drawing binds the city's own VAO, which holds the cube's index buffer
+	city.draw( 0, 1, 2, 3, 4 );
+	CHECK( GLMock::elementBuffer( callerVAO ) == callerIBO );
+	CHECK( GLMock::boundVertexArray() != callerVAO );
+	CHECK( GLMock::elementBuffer( GLMock::boundVertexArray() ) != 0 );
+	CHECK( GLMock::elementBuffer( GLMock::boundVertexArray() ) != callerIBO );
+	CHECK( GLMock::errors() == 0 );
+}
+
+static void testWholeCityIsOneInstancedDraw() {
+	GLMock::reset();
+	CSCI441::City city( 441, 101, 101 );
+	CHECK( city.getNumBuildings() > 0 );
+
+	city.draw( 0, 1, 2, 3, 4 );
+	CHECK( GLMock::draws().size() == 1 );
+	if( GLMock::draws().size() == 1 ) {
+		const GLMock::DrawCall &draw = GLMock::draws()[0];
+		CHECK( draw.mode == GL_TRIANGLES );
+		CHECK( draw.instances == (GLsizei)city.getNumBuildings() );
+		for( GLuint a = 0; a < 5; a++ ) CHECK( draw.attributeEnabled[a] );
+	}
+
+	// the next frame is a VAO bind and the draw
+	GLMock::resetCalls();
+	city.draw( 0, 1, 2, 3, 4 );
+	CHECK( GLMock::totalCalls() == 2 );
+	CHECK( GLMock::calls( "glBindVertexArray" ) == 1 );
+	CHECK( GLMock::calls( "glDrawElementsInstanced" ) == 1 );
+}
+
+static void testCullDecidesTheInstanceCount() {
+	GLMock::reset();
+	CSCI441::City city( 441, 101, 101 );
+	glm::mat4 projMtx = glm::perspective( 45.0f, 640.0f / 480.0f, 0.1f, 1000.0f );
+
+	// high above the center looking straight down sees every building
+	city.cull( projMtx * glm::lookAt( glm::vec3( 0.0f, 500.0f, 0.0f ), glm::vec3( 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) ) );
+	CHECK( city.getNumVisible() == city.getNumBuildings() );
+	CHECK( city.getNumCulled() == 0 );
+
+	// looking up into the sky sees none
+	city.cull( projMtx * glm::lookAt( glm::vec3( 0.0f, 50.0f, 0.0f ), glm::vec3( 0.0f, 100.0f, 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) ) );
+	CHECK( city.getNumVisible() == 0 );
+	CHECK( city.getNumCulled() == city.getNumBuildings() );
+	GLMock::resetCalls();
+	city.draw( 0, 1, 2, 3, 4 );
+	CHECK( GLMock::draws().empty() );
+
+	// standing in the middle looking along +x sees less than half
+	city.cull( projMtx * glm::lookAt( glm::vec3( 0.0f, 2.0f, 0.0f ), glm::vec3( 10.0f, 2.0f, 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) ) );
+	CHECK( city.getNumVisible() > 0 && city.getNumVisible() < city.getNumBuildings() / 2 );
+	CHECK( city.getNumVisible() + city.getNumCulled() == city.getNumBuildings() );
+	for( size_t i = 0; i < city.getVisibleBuildings().size(); i++ ) CHECK( city.getVisibleBuildings()[i].position.x + city.getVisibleBuildings()[i].size.x > 0.0f );
+	GLMock::resetCalls();
+	city.draw( 0, 1, 2, 3, 4 );
+	CHECK( GLMock::draws().size() == 1 && GLMock::draws()[0].instances == (GLsizei)city.getNumVisible() );
+
+	// and forgetting the cull draws everything again
+	city.clearCull();
+	GLMock::resetCalls();
+	city.draw( 0, 1, 2, 3, 4 );
+	CHECK( GLMock::draws().size() == 1 && GLMock::draws()[0].instances == (GLsizei)city.getNumBuildings() );
+}
+
+int main() {
+	testUploadKeepsTheCallersElementBuffer();
+	testWholeCityIsOneInstancedDraw();
+	testCullDecidesTheInstanceCount();
+
+	return TestHarness::result( "city3Test" );
+}
@@ -0,0 +1,98 @@
+/*
+ *  cityCullBenchmark.cpp
+ *
+ *  Frustum culling of large cities: City::cull()'s quadtree walk against
+ *  testing every building's box, over views orbiting the city center.
+ *  Every view's visible list must match the brute force list exactly.
+ *  Culling runs on the CPU alone, so the benchmark links the mock GL.
+ *
+ *  usage: cityCullBenchmark [views=64]
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/city3.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stdlib.h>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+// a camera above the edge of the city looking across it, the way lab04 flies
+static glm::mat4 orbitView( GLint grid, GLint view, GLint numViews ) {
+	GLfloat angle = 2.0f * M_PI * view / numViews;
+	GLfloat radius = grid * 0.55f * 0.5f;
+	glm::vec3 eye( radius * cosf( angle ), 20.0f, radius * sinf( angle ) );
+	glm::vec3 target( -eye.x, 0.0f, -eye.z );
+	return glm::perspective( 45.0f, 640.0f / 480.0f, 0.001f, 10000.0f ) * glm::lookAt( eye, target, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+}
+
+// every building's box against all six planes, in building order
+static void bruteForceCull( const CSCI441::City &city, const glm::mat4 &viewProjectionMtx, std::vector< CSCI441::CityBuilding > &visible ) {
+	glm::vec4 planes[6];
+	CSCI441_INTERNAL::extractFrustumPlanes( viewProjectionMtx, planes );
+
+	visible.clear();
+	const std::vector< CSCI441::CityBuilding > &buildings = city.getBuildings();
+	for( size_t i = 0; i < buildings.size(); i++ ) {
+		glm::vec3 extent = buildings[i].size * 0.5f;
+		glm::vec3 center = buildings[i].position + glm::vec3( 0.0f, extent.y, 0.0f );
+		bool inside = true;
+		for( int p = 0; p < 6 && inside; p++ ) {
+			const glm::vec4 &n = planes[p];
+			inside = n.x*center.x + n.y*center.y + n.z*center.z + n.w + fabsf(n.x)*extent.x + fabsf(n.y)*extent.y + fabsf(n.z)*extent.z >= 0.0f;
+		}
+		if( inside ) visible.push_back( buildings[i] );
+	}
+}
+
+static bool sameBuildings( const std::vector< CSCI441::CityBuilding > &a, const std::vector< CSCI441::CityBuilding > &b ) {
+	if( a.size() != b.size() ) return false;
+	for( size_t i = 0; i < a.size(); i++ ) {
+		if( a[i].position != b[i].position || a[i].size != b[i].size ) return false;
+	}
+	return true;
+}
+
+int main( int argc, char *argv[] ) {
+	const GLint numViews = argc > 1 ? atoi( argv[1] ) : 64;
+
+	unsigned int numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+	numThreads = std::thread::hardware_concurrency();
+#endif
+	printf( "[INFO]: %d views orbiting each city, %u hardware threads, mean ms per cull\n", numViews, numThreads );
+	printf( "[INFO]: grid   buildings   visible   quadtree   brute force\n" );
+
+	const GLint grids[] = { 101, 1001, 2001 };
+	for( size_t g = 0; g < sizeof( grids ) / sizeof( grids[0] ); g++ ) {
+		CSCI441::City city( 441, grids[g], grids[g] );
+
+		TestHarness::Timings quadtree, bruteForce;
+		size_t visible = 0;
+		std::vector< CSCI441::CityBuilding > expected;
+		for( GLint v = 0; v < numViews; v++ ) {
+			glm::mat4 viewProjectionMtx = orbitView( grids[g], v, numViews );
+
+			city.cull( viewProjectionMtx );
+			quadtree.add( city.getCullTime() );
+
+			double start = TestHarness::now();
+			bruteForceCull( city, viewProjectionMtx, expected );
+			bruteForce.add( TestHarness::now() - start );
+
+			CHECK( sameBuildings( city.getVisibleBuildings(), expected ) );
+			CHECK( city.getNumVisible() + city.getNumCulled() == city.getNumBuildings() );
+			visible += city.getNumVisible();
+		}
+
+		printf( "[INFO]: %4d   %9u   %6.1f%%   %8.3f   %11.3f\n", grids[g], city.getNumBuildings(),
+				100.0 * visible / ( (double)city.getNumBuildings() * numViews ), quadtree.mean(), bruteForce.mean() );
+	}
+
+	return TestHarness::result( "cityCullBenchmark" );
+}
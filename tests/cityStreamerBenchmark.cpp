@@ -0,0 +1,96 @@
+/*
+ *  cityStreamerBenchmark.cpp
+ *
+ *  Headless fly-through of a streamed city.  The camera flies a straight
+ *  line at a few speeds while update(), cull() and draw() run once per
+ *  frame against the mock GL, with a short sleep standing in for the GPU
+ *  and the swap so the workers get to generate.  Every frame must upload
+ *  no more than the budget (or a single chunk), keep residency at the
+ *  chunk limit and finish its main thread work under the spike limit.
+ *  Once the camera stops, every chunk in view must become resident.
+ *
+ *  usage: cityStreamerBenchmark [spikeLimitMs=8] [frames=2000]
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/cityStreamer3.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <thread>
+
+static const GLint VIEW_RADIUS = 6;
+
+// renders one frame and returns the main thread milliseconds it took
+static double renderFrame( CSCI441::CityStreamer &streamer, glm::vec3 cameraPosition, const glm::mat4 &projMtx, GLuint &chunksUploaded ) {
+	glm::mat4 viewMtx = glm::lookAt( cameraPosition, cameraPosition + glm::vec3( 1.0f, -0.2f, 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+
+	double start = TestHarness::now();
+	GLMock::resetCalls();
+	streamer.update( cameraPosition );
+	chunksUploaded = GLMock::calls( "glGenBuffers" ) / 3;			// cube vertices, cube indices and instances
+	streamer.cull( projMtx * viewMtx, cameraPosition );
+	streamer.draw( projMtx * viewMtx, 0, 1, 2, 3, 4 );
+	return TestHarness::now() - start;
+}
+
+static void flyThrough( GLfloat unitsPerFrame, GLuint uploadBudget, GLint frames, double spikeLimit, const glm::mat4 &projMtx ) {
+	CSCI441::CityStreamer streamer( 441, VIEW_RADIUS );
+	streamer.setUploadBudget( uploadBudget );
+	const GLuint maxChunks = 2 * (2*VIEW_RADIUS + 1) * (2*VIEW_RADIUS + 1);
+
+	TestHarness::Timings frameTimes;
+	GLuint maxUploadBytes = 0, maxResident = 0, overBudgetFrames = 0;
+	for( GLint frame = 0; frame < frames; frame++ ) {
+		GLuint chunksUploaded;
+		frameTimes.add( renderFrame( streamer, glm::vec3( frame * unitsPerFrame, 20.0f, 0.0f ), projMtx, chunksUploaded ) );
+
+		// a single chunk may go over the budget, since at least one is uploaded per frame
+		if( streamer.getLastUploadBytes() > uploadBudget ) {
+			overBudgetFrames++;
+			CHECK( chunksUploaded == 1 );
+		}
+		maxUploadBytes = std::max( maxUploadBytes, streamer.getLastUploadBytes() );
+		maxResident = std::max( maxResident, streamer.getNumChunks() );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+	}
+	CHECK( maxResident <= maxChunks );
+	CHECK( GLMock::errors() == 0 );
+
+	printf( "[INFO]: %3.0f units/frame %4u KB budget %5d frames: mean %6.3f ms, p99 %6.3f ms, max %6.3f ms, max upload %4u KB (%u frames over budget), %4u evicted\n",
+			unitsPerFrame, uploadBudget / 1024, frames, frameTimes.mean(), frameTimes.percentile( 99 ), frameTimes.max(), maxUploadBytes / 1024, overBudgetFrames, streamer.getNumEvicted() );
+	CHECK( frameTimes.max() < spikeLimit );
+
+	// hovering in place, the streamer catches up with everything in view
+	glm::vec3 hover( (frames - 1) * unitsPerFrame, 20.0f, 0.0f );
+	GLuint chunksUploaded;
+	for( GLint frame = 0; frame < 5000 && streamer.getNumPending() > 0; frame++ ) {
+		renderFrame( streamer, hover, projMtx, chunksUploaded );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+	}
+	CHECK( streamer.getNumPending() == 0 );
+	renderFrame( streamer, hover, projMtx, chunksUploaded );
+	CHECK( chunksUploaded == 0 );
+	CHECK( streamer.getNumPending() == 0 );
+}
+
+int main( int argc, char *argv[] ) {
+	const double spikeLimit = argc > 1 ? atof( argv[1] ) : 8.0;
+	const GLint frames = argc > 2 ? atoi( argv[2] ) : 2000;
+
+	printf( "[INFO]: view radius %d, %.1f ms spike limit, %u hardware threads\n",
+			VIEW_RADIUS, spikeLimit, std::thread::hardware_concurrency() );
+
+	glm::mat4 projMtx = glm::perspective( 45.0f, 640.0f / 480.0f, 0.1f, 1000.0f );
+	flyThrough( 1.0f, 256 * 1024, frames, spikeLimit, projMtx );
+	flyThrough( 5.0f, 256 * 1024, frames, spikeLimit, projMtx );
+	// a budget smaller than any chunk still uploads one chunk per frame
+	flyThrough( 5.0f, 1024, frames, spikeLimit, projMtx );
+
+	return TestHarness::result( "cityStreamerBenchmark" );
+}
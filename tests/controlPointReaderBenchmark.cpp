@@ -0,0 +1,99 @@
+/*
+ *  controlPointReaderBenchmark.cpp
+ *
+ *  Load time of a recorded flight path of 10^6 and 10^7 control points:
+ *  lab03's old ifstream/getline/stoi loader against ControlPointReader on
+ *  the same CSV file and on its binary copy.  The files are written once
+ *  and read back warm from the page cache.
+ *
+ *  usage: controlPointReaderBenchmark [runs=3]
+ */
+
+#include "testHarness.hpp"
+
+#include "../lab03/include/ControlPointReader.h"
+
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#ifndef CSCI441_NO_THREADS
+#include <thread>
+#endif
+
+static const char *TEXT_FILE = "controlPointReaderBenchmark.csv";
+static const char *BINARY_FILE = "controlPointReaderBenchmark.cpb";
+
+// lab03's loadControlPoints() before the mapped reader
+static bool loadOld( const char *filename, std::vector<glm::vec3> &controlPoints ) {
+	std::ifstream inputFile( filename );
+	if( inputFile.fail() ) return false;
+
+	int numPoints;
+	inputFile >> numPoints;
+
+	std::string x, y, z;
+	for( int i = 0; i < numPoints; i++ ) {
+		getline( inputFile, x, ',' );
+		getline( inputFile, y, ',' );
+		getline( inputFile, z );
+		controlPoints.push_back( glm::vec3( stoi( x ), stoi( y ), stoi( z ) ) );
+	}
+	return true;
+}
+
+// a smooth random walk, written as lab03's count line plus one x,y,z line per point
+static void writePath( unsigned int numPoints ) {
+	FILE *file = fopen( TEXT_FILE, "w" );
+	fprintf( file, "%u\n", numPoints );
+
+	std::vector<glm::vec3> points( numPoints );
+	glm::vec3 position( 0.0f ), velocity( 1.0f, 0.0f, 0.0f );
+	for( unsigned int i = 0; i < numPoints; i++ ) {
+		velocity = velocity * 0.99f + glm::vec3( rand() % 201 - 100, rand() % 201 - 100, rand() % 201 - 100 ) * 0.001f;
+		position += velocity;
+		points[i] = position;
+		fprintf( file, "%.3f,%.3f,%.3f\n", position.x, position.y, position.z );
+	}
+	fclose( file );
+	ControlPointReader::saveBinary( BINARY_FILE, points );
+}
+
+static double timeLoad( bool (*load)( const char*, std::vector<glm::vec3>& ), const char *filename, int runs, size_t expected ) {
+	TestHarness::Timings timings;
+	for( int r = 0; r < runs; r++ ) {
+		std::vector<glm::vec3> points;
+		double start = TestHarness::now();
+		bool loaded = load( filename, points );
+		timings.add( TestHarness::now() - start );
+		CHECK( loaded && points.size() == expected );
+	}
+	return timings.mean();
+}
+
+int main( int argc, char *argv[] ) {
+	const int runs = argc > 1 ? atoi( argv[1] ) : 3;
+
+	unsigned int numThreads = 1;
+#ifndef CSCI441_NO_THREADS
+	numThreads = std::thread::hardware_concurrency();
+#endif
+	printf( "[INFO]: mean of %d warm loads, %u hardware threads, ms\n", runs, numThreads );
+	printf( "[INFO]: points      old loader   mapped csv   binary\n" );
+
+	const unsigned int pointCounts[] = { 1000000, 10000000 };
+	for( size_t c = 0; c < sizeof( pointCounts ) / sizeof( pointCounts[0] ); c++ ) {
+		srand( 441 );
+		writePath( pointCounts[c] );
+
+		double old = timeLoad( loadOld, TEXT_FILE, runs, pointCounts[c] );
+		double text = timeLoad( ControlPointReader::load, TEXT_FILE, runs, pointCounts[c] );
+		double binary = timeLoad( ControlPointReader::load, BINARY_FILE, runs, pointCounts[c] );
+		printf( "[INFO]: %8u   %10.1f   %10.1f   %6.1f\n", pointCounts[c], old, text, binary );
+	}
+
+	remove( TEXT_FILE );
+	remove( BINARY_FILE );
+	return TestHarness::result( "controlPointReaderBenchmark" );
+}
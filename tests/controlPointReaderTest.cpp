@@ -0,0 +1,102 @@
+/*
+ *  controlPointReaderTest.cpp
+ *
+ *  Loads hand written and generated files through lab03's
+ *  ControlPointReader: fractional coordinates survive, a bogus point count
+ *  in the header cannot blow up the reservation, a line without exactly
+ *  three numbers fails the load instead of shifting every point after it,
+ *  and binary files round trip.
+ */
+
+#include "testHarness.hpp"
+
+#include "../lab03/include/ControlPointReader.h"
+
+#include <stdio.h>
+#include <string>
+
+static const char *TEXT_FILE = "controlPointReaderTest.csv";
+static const char *BINARY_FILE = "controlPointReaderTest.cpb";
+
+static void writeFile( const char *filename, const std::string &contents ) {
+	FILE *file = fopen( filename, "wb" );
+	fwrite( contents.data(), 1, contents.size(), file );
+	fclose( file );
+}
+
+static bool loadText( const std::string &contents, std::vector<glm::vec3> &points ) {
+	writeFile( TEXT_FILE, contents );
+	return ControlPointReader::load( TEXT_FILE, points );
+}
+
+static void testFractionalCoordinates() {
+	std::vector<glm::vec3> points;
+	CHECK( loadText( "3\n-5.25,0.5,5\n1e-2 2.5e1 -0\n\n  7.125 , -8 , 9.75\r\n", points ) );
+	CHECK( points.size() == 3 );
+	if( points.size() != 3 ) return;
+	CHECK( points[0] == glm::vec3( -5.25f, 0.5f, 5.0f ) );
+	CHECK( points[1] == glm::vec3( 0.01f, 25.0f, 0.0f ) );
+	CHECK( points[2] == glm::vec3( 7.125f, -8.0f, 9.75f ) );
+
+	// the count line is optional
+	CHECK( loadText( "1,2,3\n4,5,6\n", points ) );
+	CHECK( points.size() == 2 );
+}
+
+static void testBogusCountIsOnlyAHint() {
+	std::vector<glm::vec3> points;
+	CHECK( loadText( "4000000000\n1,2,3\n4,5,6\n", points ) );
+	CHECK( points.size() == 2 );
+	CHECK( points.capacity() < 1000 );
+}
+
+static void testLinesNeedExactlyThreeNumbers() {
+	std::vector<glm::vec3> points;
+	CHECK( !loadText( "3\n1,2,3\n4,5\n6,7,8\n", points ) );
+	CHECK( !loadText( "1,2,3,4\n5,6,7\n", points ) );
+	CHECK( !loadText( "1,2,x\n", points ) );
+	CHECK( !loadText( "1,2,3\n4,5,6abc\n", points ) );
+}
+
+static void testBadLineInAThreadedLoad() {
+	// more than the 4 MB a text file needs before it is split across threads
+	std::string contents;
+	char line[64];
+	for( int i = 0; i < 400000; i++ ) {
+		snprintf( line, sizeof( line ), "%d.5,%d.25,-%d.125\n", i, i % 97, i % 13 );
+		contents += line;
+	}
+
+	std::vector<glm::vec3> points;
+	CHECK( loadText( contents, points ) );
+	CHECK( points.size() == 400000 );
+	if( points.size() == 400000 ) CHECK( points[399999] == glm::vec3( 399999.5f, 399999 % 97 + 0.25f, -(399999 % 13) - 0.125f ) );
+
+	contents.insert( contents.size() / 2, "1,2\n" );
+	CHECK( !loadText( contents, points ) );
+}
+
+static void testBinaryRoundTrip() {
+	std::vector<glm::vec3> written, read;
+	for( int i = 0; i < 1000; i++ ) written.push_back( glm::vec3( i * 0.1f, -i * 0.25f, i * 1e-3f ) );
+
+	CHECK( ControlPointReader::saveBinary( BINARY_FILE, written ) );
+	CHECK( ControlPointReader::load( BINARY_FILE, read ) );
+	CHECK( read == written );
+
+	// a header promising more points than the file holds
+	writeFile( BINARY_FILE, std::string( "CPB1\xff\xff\xff\x0f", 8 ) + std::string( 24, '\0' ) );
+	CHECK( !ControlPointReader::load( BINARY_FILE, read ) );
+}
+
+int main() {
+	testFractionalCoordinates();
+	testBogusCountIsOnlyAHint();
+	testLinesNeedExactlyThreeNumbers();
+	testBadLineInAThreadedLoad();
+	testBinaryRoundTrip();
+
+	remove( TEXT_FILE );
+	remove( BINARY_FILE );
+	return TestHarness::result( "controlPointReaderTest" );
+}
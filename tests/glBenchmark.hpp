@@ -0,0 +1,131 @@
+/** @file glBenchmark.hpp
+  * @brief Hidden window and a flat shader for the GL benchmarks
+	* @author Dr. Jeffrey Paone
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	The benchmarks time the headers against a real driver.  They open
+	*	an invisible GLFW window so they can run from make bench without
+	*	stealing focus, and draw with a shader that takes a position at
+	*	location 0 and a normal at location 1.
+	*
+	*	@warning NOTE: This header file depends upon GLEW and GLFW
+  */
+
+#ifndef __CSCI441_GL_BENCHMARK_HPP__
+#define __CSCI441_GL_BENCHMARK_HPP__
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <stdio.h>									// for fprintf()
+#include <stdlib.h>									// for exit()
+
+namespace GLBenchmark {
+	/**	@desc opens a hidden window with a current OpenGL 3.3 compatibility context, exits on failure
+	 *	@param width framebuffer width
+	 *	@param height framebuffer height
+	 */
+	GLFWwindow* openHiddenWindow( int width, int height );
+
+	/**	@desc compiles and links the flat shader, exits on failure
+	 *	@return the program, already in use
+	 */
+	GLuint useFlatShader();
+
+	/**	@desc closes the window and shuts GLFW down
+	 */
+	void closeWindow( GLFWwindow *window );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441_INTERNAL {
+	GLuint compileBenchmarkShader( GLenum shaderType, const char *source );
+}
+
+inline GLFWwindow* GLBenchmark::openHiddenWindow( int width, int height ) {
+	if( !glfwInit() ) {
+		fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+		exit( EXIT_FAILURE );
+	}
+
+	glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 3 );
+	glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 3 );
+	glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE );
+	glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+
+	GLFWwindow *window = glfwCreateWindow( width, height, "benchmark", NULL, NULL );
+	if( !window ) {
+		fprintf( stderr, "[ERROR]: Could not open an OpenGL 3.3 window\n" );
+		glfwTerminate();
+		exit( EXIT_FAILURE );
+	}
+	glfwMakeContextCurrent( window );
+	glfwSwapInterval( 0 );								// time the work, not the display
+
+	glewExperimental = GL_TRUE;
+	if( glewInit() != GLEW_OK ) {
+		fprintf( stderr, "[ERROR]: Could not initialize GLEW\n" );
+		exit( EXIT_FAILURE );
+	}
+	glGetError();										// glewInit() may leave GL_INVALID_ENUM behind
+
+	glViewport( 0, 0, width, height );
+	glEnable( GL_DEPTH_TEST );
+	printf( "[INFO]: %s on %s\n", glGetString( GL_VERSION ), glGetString( GL_RENDERER ) );
+	return window;
+}
+
+inline GLuint CSCI441_INTERNAL::compileBenchmarkShader( GLenum shaderType, const char *source ) {
+	GLuint shader = glCreateShader( shaderType );
+	glShaderSource( shader, 1, &source, NULL );
+	glCompileShader( shader );
+
+	GLint status;
+	glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+	if( !status ) {
+		char infoLog[1024];
+		glGetShaderInfoLog( shader, sizeof( infoLog ), NULL, infoLog );
+		fprintf( stderr, "[ERROR]: benchmark shader: %s\n", infoLog );
+		exit( EXIT_FAILURE );
+	}
+	return shader;
+}
+
+inline GLuint GLBenchmark::useFlatShader() {
+	const char *vertexSource =
+		"#version 330 core\n"
+		"layout(location = 0) in vec3 vPos;\n"
+		"layout(location = 1) in vec3 vNormal;\n"
+		"uniform mat4 mvpMatrix;\n"
+		"out vec3 normal;\n"
+		"void main() { normal = vNormal; gl_Position = mvpMatrix * vec4( vPos, 1.0 ); }\n";
+	const char *fragmentSource =
+		"#version 330 core\n"
+		"in vec3 normal;\n"
+		"out vec4 fragColor;\n"
+		"void main() { fragColor = vec4( abs( normal ), 1.0 ); }\n";
+
+	GLuint program = glCreateProgram();
+	glAttachShader( program, CSCI441_INTERNAL::compileBenchmarkShader( GL_VERTEX_SHADER, vertexSource ) );
+	glAttachShader( program, CSCI441_INTERNAL::compileBenchmarkShader( GL_FRAGMENT_SHADER, fragmentSource ) );
+	glLinkProgram( program );
+
+	GLint status;
+	glGetProgramiv( program, GL_LINK_STATUS, &status );
+	if( !status ) {
+		fprintf( stderr, "[ERROR]: benchmark shader did not link\n" );
+		exit( EXIT_FAILURE );
+	}
+	glUseProgram( program );
+	return program;
+}
+
+inline void GLBenchmark::closeWindow( GLFWwindow *window ) {
+	glfwDestroyWindow( window );
+	glfwTerminate();
+}
+
+#endif // __CSCI441_GL_BENCHMARK_HPP__
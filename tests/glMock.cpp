@@ -0,0 +1,386 @@
+/*
+ *  glMock.cpp
+ *
+ *  Defines the OpenGL entry points as plain functions (OpenGL 1.1) and the
+ *  GLEW function pointers (everything newer), so a test program links
+ *  without opengl32/libGL and GLEW.  Each entry point counts its call and
+ *  updates the little bit of state GLMock reports.
+ */
+
+#include "glMock.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+#include <string.h>
+
+namespace {
+	struct VertexArrayState {
+		std::set< GLuint > enabled;
+		GLuint elementBuffer;
+		VertexArrayState() : elementBuffer( 0 ) {}
+	};
+
+	struct MockState {
+		std::map< std::string, unsigned int > calls;
+		std::vector< GLMock::DrawCall > draws;
+		std::map< GLuint, VertexArrayState > vertexArrays;
+		std::map< GLuint, GLsizeiptr > bufferSizes;
+		std::vector< GLfloat > clientVertices;
+		std::set< std::string > extensions;
+		size_t textureBytes;
+		const GLfloat *vertexPointer;
+		GLint vertexSize;
+		bool vertexArrayEnabled;
+		GLuint nextName, vao, arrayBuffer;
+		GLenum polygonMode, pendingError;
+		unsigned int numErrors;
+		GLint unpackAlignment;
+		GLenum depthFunc;
+		MockState() : textureBytes( 0 ), vertexPointer( NULL ), vertexSize( 0 ), vertexArrayEnabled( false ), nextName( 0 ), vao( 0 ), arrayBuffer( 0 ), polygonMode( GL_FILL ), pendingError( GL_NO_ERROR ), numErrors( 0 ), unpackAlignment( 4 ), depthFunc( GL_LESS ) {}
+	};
+
+	MockState& state() {
+		static MockState mockState;
+		return mockState;
+	}
+
+	void count( const char *functionName ) {
+		state().calls[ functionName ]++;
+	}
+
+	void raise( GLenum error ) {
+		if( state().pendingError == GL_NO_ERROR ) state().pendingError = error;
+		state().numErrors++;
+	}
+
+	void recordDraw( GLenum mode, GLsizei count, GLsizei instances ) {
+		MockState &s = state();
+		GLMock::DrawCall draw;
+		draw.mode = mode;
+		draw.count = count;
+		draw.instances = instances;
+		draw.vao = s.vao;
+		draw.polygonMode = s.polygonMode;
+		for( GLuint i = 0; i < GLMock::MAX_ATTRIBUTES; i++ ) {
+			draw.attributeEnabled[i] = s.vertexArrays[ s.vao ].enabled.count( i ) > 0;
+		}
+		s.draws.push_back( draw );
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+
+	void APIENTRY mockActiveTexture( GLenum ) {
+		count( "glActiveTexture" );
+	}
+
+	void APIENTRY mockBindBuffer( GLenum target, GLuint buffer ) {
+		count( "glBindBuffer" );
+		if( target == GL_ARRAY_BUFFER ) state().arrayBuffer = buffer;
+		else if( target == GL_ELEMENT_ARRAY_BUFFER ) state().vertexArrays[ state().vao ].elementBuffer = buffer;
+	}
+
+	void APIENTRY mockBindSampler( GLuint, GLuint ) {
+		count( "glBindSampler" );
+	}
+
+	void APIENTRY mockBindVertexArray( GLuint array ) {
+		count( "glBindVertexArray" );
+		state().vao = array;
+	}
+
+	void APIENTRY mockBufferData( GLenum target, GLsizeiptr size, const void *, GLenum ) {
+		count( "glBufferData" );
+		GLuint buffer = target == GL_ELEMENT_ARRAY_BUFFER ? state().vertexArrays[ state().vao ].elementBuffer : state().arrayBuffer;
+		if( target == GL_ARRAY_BUFFER || target == GL_ELEMENT_ARRAY_BUFFER ) state().bufferSizes[ buffer ] = size;
+	}
+
+	void APIENTRY mockBufferSubData( GLenum, GLintptr, GLsizeiptr, const void * ) {
+		count( "glBufferSubData" );
+	}
+
+	void APIENTRY mockCompressedTexImage2D( GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei imageSize, const void * ) {
+		count( "glCompressedTexImage2D" );
+		state().textureBytes += imageSize;
+	}
+
+	void APIENTRY mockDeleteBuffers( GLsizei, const GLuint * ) {
+		count( "glDeleteBuffers" );
+	}
+
+	void APIENTRY mockDeleteVertexArrays( GLsizei n, const GLuint *arrays ) {
+		count( "glDeleteVertexArrays" );
+		for( GLsizei i = 0; i < n; i++ ) {
+			if( arrays[i] == state().vao ) state().vao = 0;
+			state().vertexArrays.erase( arrays[i] );
+		}
+	}
+
+	void APIENTRY mockDrawElementsInstanced( GLenum mode, GLsizei count, GLenum, const void *, GLsizei instances ) {
+		::count( "glDrawElementsInstanced" );
+		recordDraw( mode, count, instances );
+	}
+
+	void APIENTRY mockEnableVertexAttribArray( GLuint index ) {
+		count( "glEnableVertexAttribArray" );
+		if( index >= GLMock::MAX_ATTRIBUTES ) { raise( GL_INVALID_VALUE ); return; }
+		state().vertexArrays[ state().vao ].enabled.insert( index );
+	}
+
+	void APIENTRY mockGenBuffers( GLsizei n, GLuint *buffers ) {
+		count( "glGenBuffers" );
+		for( GLsizei i = 0; i < n; i++ ) buffers[i] = ++state().nextName;
+	}
+
+	void APIENTRY mockGenSamplers( GLsizei n, GLuint *samplers ) {
+		count( "glGenSamplers" );
+		for( GLsizei i = 0; i < n; i++ ) samplers[i] = ++state().nextName;
+	}
+
+	void APIENTRY mockGenVertexArrays( GLsizei n, GLuint *arrays ) {
+		count( "glGenVertexArrays" );
+		for( GLsizei i = 0; i < n; i++ ) arrays[i] = ++state().nextName;
+	}
+
+	void APIENTRY mockSamplerParameterf( GLuint, GLenum, GLfloat ) {
+		count( "glSamplerParameterf" );
+	}
+
+	void APIENTRY mockSamplerParameteri( GLuint, GLenum, GLint ) {
+		count( "glSamplerParameteri" );
+	}
+
+	void APIENTRY mockUniform4fv( GLint, GLsizei, const GLfloat * ) {
+		count( "glUniform4fv" );
+	}
+
+	void APIENTRY mockUniformMatrix4fv( GLint, GLsizei, GLboolean, const GLfloat * ) {
+		count( "glUniformMatrix4fv" );
+	}
+
+	void APIENTRY mockVertexAttribDivisor( GLuint index, GLuint ) {
+		count( "glVertexAttribDivisor" );
+		if( index >= GLMock::MAX_ATTRIBUTES ) raise( GL_INVALID_VALUE );
+	}
+
+	void APIENTRY mockVertexAttribPointer( GLuint index, GLint, GLenum, GLboolean, GLsizei, const void * ) {
+		count( "glVertexAttribPointer" );
+		if( index >= GLMock::MAX_ATTRIBUTES ) raise( GL_INVALID_VALUE );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GLEW dispatches everything past OpenGL 1.1 through these pointers
+
+extern "C" {
+	PFNGLACTIVETEXTUREPROC __glewActiveTexture = mockActiveTexture;
+	PFNGLBINDBUFFERPROC __glewBindBuffer = mockBindBuffer;
+	PFNGLBINDSAMPLERPROC __glewBindSampler = mockBindSampler;
+	PFNGLBINDVERTEXARRAYPROC __glewBindVertexArray = mockBindVertexArray;
+	PFNGLBUFFERDATAPROC __glewBufferData = mockBufferData;
+	PFNGLBUFFERSUBDATAPROC __glewBufferSubData = mockBufferSubData;
+	PFNGLCOMPRESSEDTEXIMAGE2DPROC __glewCompressedTexImage2D = mockCompressedTexImage2D;
+	PFNGLDELETEBUFFERSPROC __glewDeleteBuffers = mockDeleteBuffers;
+	PFNGLDELETEVERTEXARRAYSPROC __glewDeleteVertexArrays = mockDeleteVertexArrays;
+	PFNGLDRAWELEMENTSINSTANCEDPROC __glewDrawElementsInstanced = mockDrawElementsInstanced;
+	PFNGLENABLEVERTEXATTRIBARRAYPROC __glewEnableVertexAttribArray = mockEnableVertexAttribArray;
+	PFNGLGENBUFFERSPROC __glewGenBuffers = mockGenBuffers;
+	PFNGLGENSAMPLERSPROC __glewGenSamplers = mockGenSamplers;
+	PFNGLGENVERTEXARRAYSPROC __glewGenVertexArrays = mockGenVertexArrays;
+	PFNGLSAMPLERPARAMETERFPROC __glewSamplerParameterf = mockSamplerParameterf;
+	PFNGLSAMPLERPARAMETERIPROC __glewSamplerParameteri = mockSamplerParameteri;
+	PFNGLUNIFORM4FVPROC __glewUniform4fv = mockUniform4fv;
+	PFNGLUNIFORMMATRIX4FVPROC __glewUniformMatrix4fv = mockUniformMatrix4fv;
+	PFNGLVERTEXATTRIBDIVISORPROC __glewVertexAttribDivisor = mockVertexAttribDivisor;
+	PFNGLVERTEXATTRIBPOINTERPROC __glewVertexAttribPointer = mockVertexAttribPointer;
+
+	GLboolean glewIsSupported( const char *name ) {
+		return state().extensions.count( name ) ? GL_TRUE : GL_FALSE;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// OpenGL 1.1 entry points are exported directly
+
+	void APIENTRY glDrawArrays( GLenum mode, GLint first, GLsizei count ) {
+		::count( "glDrawArrays" );
+		recordDraw( mode, count, 1 );
+
+		// keep a copy of what a client side array held, since it may be freed right after
+		MockState &s = state();
+		if( s.vao == 0 && s.arrayBuffer == 0 && s.vertexArrayEnabled && s.vertexPointer != NULL && s.vertexSize == 3 ) {
+			s.clientVertices.assign( s.vertexPointer + first*3, s.vertexPointer + (first + count)*3 );
+		}
+	}
+
+	void APIENTRY glEnableClientState( GLenum array ) {
+		::count( "glEnableClientState" );
+		if( array == GL_VERTEX_ARRAY ) state().vertexArrayEnabled = true;
+	}
+
+	void APIENTRY glDisableClientState( GLenum array ) {
+		::count( "glDisableClientState" );
+		if( array == GL_VERTEX_ARRAY ) state().vertexArrayEnabled = false;
+	}
+
+	void APIENTRY glVertexPointer( GLint size, GLenum type, GLsizei stride, const void *pointer ) {
+		::count( "glVertexPointer" );
+		// the mock only follows tightly packed floats
+		state().vertexSize = type == GL_FLOAT && (stride == 0 || stride == size*(GLsizei)sizeof(GLfloat)) ? size : 0;
+		state().vertexPointer = (const GLfloat*)pointer;
+	}
+
+	void APIENTRY glDrawElements( GLenum mode, GLsizei count, GLenum, const void * ) {
+		::count( "glDrawElements" );
+		recordDraw( mode, count, 1 );
+	}
+
+	void APIENTRY glPolygonMode( GLenum, GLenum mode ) {
+		count( "glPolygonMode" );
+		state().polygonMode = mode;
+	}
+
+	void APIENTRY glGenTextures( GLsizei n, GLuint *textures ) {
+		count( "glGenTextures" );
+		for( GLsizei i = 0; i < n; i++ ) textures[i] = ++state().nextName;
+	}
+
+	void APIENTRY glBindTexture( GLenum, GLuint ) {
+		count( "glBindTexture" );
+	}
+
+	void APIENTRY glDeleteTextures( GLsizei, const GLuint * ) {
+		count( "glDeleteTextures" );
+	}
+
+	void APIENTRY glDepthFunc( GLenum func ) {
+		count( "glDepthFunc" );
+		state().depthFunc = func;
+	}
+
+	void APIENTRY glEnable( GLenum ) {
+		count( "glEnable" );
+	}
+
+	void APIENTRY glPixelStorei( GLenum pname, GLint param ) {
+		count( "glPixelStorei" );
+		if( pname == GL_UNPACK_ALIGNMENT ) state().unpackAlignment = param;
+	}
+
+	void APIENTRY glTexImage2D( GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type, const void * ) {
+		count( "glTexImage2D" );
+		// the mock only follows unsigned bytes, rows packed with no padding
+		const size_t channels = format == GL_RED ? 1 : format == GL_RG ? 2 : format == GL_RGB ? 3 : 4;
+		if( type == GL_UNSIGNED_BYTE && width > 0 && height > 0 ) state().textureBytes += (size_t)width * height * channels;
+	}
+
+	void APIENTRY glTexParameteri( GLenum, GLenum, GLint ) {
+		count( "glTexParameteri" );
+	}
+
+	void APIENTRY glGetFloatv( GLenum, GLfloat *params ) {
+		count( "glGetFloatv" );
+		*params = 0.0f;
+	}
+
+	GLenum APIENTRY glGetError( void ) {
+		GLenum error = state().pendingError;
+		state().pendingError = GL_NO_ERROR;
+		return error;
+	}
+
+	void APIENTRY glGetIntegerv( GLenum pname, GLint *params ) {
+		count( "glGetIntegerv" );
+		switch( pname ) {
+			case GL_VERTEX_ARRAY_BINDING:						*params = state().vao;															break;
+			case GL_ARRAY_BUFFER_BINDING:						*params = state().arrayBuffer;											break;
+			case GL_ELEMENT_ARRAY_BUFFER_BINDING:		*params = state().vertexArrays[ state().vao ].elementBuffer;	break;
+			case GL_POLYGON_MODE:										params[0] = params[1] = state().polygonMode;				break;
+			case GL_UNPACK_ALIGNMENT:								*params = state().unpackAlignment;									break;
+			case GL_DEPTH_FUNC:											*params = state().depthFunc;												break;
+			default:																*params = 0;																				break;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void GLMock::reset() {
+	// objects stay alive and names keep counting up, since the headers under test cache them
+	MockState &s = state();
+	s.calls.clear();
+	s.draws.clear();
+	s.clientVertices.clear();
+	s.vertexPointer = NULL;
+	s.vertexSize = 0;
+	s.vertexArrayEnabled = false;
+	s.vertexArrays[0] = VertexArrayState();
+	s.vao = s.arrayBuffer = 0;
+	s.polygonMode = GL_FILL;
+	s.pendingError = GL_NO_ERROR;
+	s.numErrors = 0;
+	s.extensions.clear();
+	s.textureBytes = 0;
+	s.unpackAlignment = 4;
+	s.depthFunc = GL_LESS;
+}
+
+void GLMock::setExtensionSupported( const char *extension, bool supported ) {
+	if( supported ) state().extensions.insert( extension );
+	else state().extensions.erase( extension );
+}
+
+void GLMock::resetCalls() {
+	state().calls.clear();
+	state().draws.clear();
+	state().numErrors = 0;
+}
+
+unsigned int GLMock::calls( const char *functionName ) {
+	std::map< std::string, unsigned int >::const_iterator callIter = state().calls.find( functionName );
+	return callIter != state().calls.end() ? callIter->second : 0;
+}
+
+unsigned int GLMock::totalCalls() {
+	unsigned int total = 0;
+	for( std::map< std::string, unsigned int >::const_iterator callIter = state().calls.begin(); callIter != state().calls.end(); ++callIter ) {
+		total += callIter->second;
+	}
+	return total;
+}
+
+const std::vector< GLMock::DrawCall >& GLMock::draws() {
+	return state().draws;
+}
+
+unsigned int GLMock::errors() {
+	return state().numErrors;
+}
+
+GLuint GLMock::boundVertexArray() {
+	return state().vao;
+}
+
+GLuint GLMock::elementBuffer( GLuint vao ) {
+	return state().vertexArrays[ vao ].elementBuffer;
+}
+
+bool GLMock::attributeEnabled( GLuint vao, GLuint index ) {
+	return state().vertexArrays[ vao ].enabled.count( index ) > 0;
+}
+
+GLenum GLMock::polygonMode() {
+	return state().polygonMode;
+}
+
+GLsizeiptr GLMock::bufferSize( GLuint buffer ) {
+	std::map< GLuint, GLsizeiptr >::const_iterator sizeIter = state().bufferSizes.find( buffer );
+	return sizeIter != state().bufferSizes.end() ? sizeIter->second : 0;
+}
+
+size_t GLMock::textureBytes() {
+	return state().textureBytes;
+}
+
+const std::vector< GLfloat >& GLMock::clientVertices() {
+	return state().clientVertices;
+}
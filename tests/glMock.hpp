@@ -0,0 +1,102 @@
+/** @file glMock.hpp
+  * @brief Call counting stand-in for the OpenGL entry points the headers use
+	* @author Dr. Jeffrey Paone
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	Tests that link glMock.o instead of OpenGL and GLEW can run without
+	*	a window.  The mock keeps just enough state to answer what a test
+	*	wants to know: how often each entry point was called, which
+	*	attributes and element buffer each vertex array holds, and what
+	*	every draw call saw when it was issued.
+	*
+	*	@warning NOTE: build with GLEW_STATIC so the GLEW function pointers
+	*	the mock defines are not declared as DLL imports
+  */
+
+#ifndef __CSCI441_GL_MOCK_HPP__
+#define __CSCI441_GL_MOCK_HPP__
+
+#include <GL/glew.h>
+
+#include <stddef.h>									// for size_t
+
+#include <vector>										// for vector
+
+namespace GLMock {
+	static const GLuint MAX_ATTRIBUTES = 16;
+
+	/**	@desc what a draw call saw when it was issued
+	 */
+	struct DrawCall {
+		GLenum mode;								// primitive type
+		GLsizei count;							// vertices or indices
+		GLsizei instances;					// 1 unless instanced
+		GLuint vao;									// vertex array bound at the time
+		GLenum polygonMode;					// polygon mode at the time
+		bool attributeEnabled[MAX_ATTRIBUTES];
+	};
+
+	/**	@desc unbinds everything and forgets the counts, recorded draws, errors and
+	 *	supported extensions; objects stay alive because the headers under test cache them
+	 */
+	void reset();
+
+	/**	@desc sets whether glewIsSupported() reports an extension; none are until set
+	 *	@param extension name of the extension, such as "GL_EXT_texture_compression_s3tc"
+	 */
+	void setExtensionSupported( const char *extension, bool supported );
+
+	/**	@desc forgets the call counts and recorded draws but keeps objects and bindings
+	 */
+	void resetCalls();
+
+	/**	@desc calls made to one entry point since the last reset
+	 *	@param functionName name of the entry point, such as "glBindVertexArray"
+	 */
+	unsigned int calls( const char *functionName );
+
+	/**	@desc calls made to every entry point since the last reset
+	 */
+	unsigned int totalCalls();
+
+	/**	@desc draw calls recorded since the last reset
+	 */
+	const std::vector<DrawCall>& draws();
+
+	/**	@desc number of GL errors raised since the last reset
+	 */
+	unsigned int errors();
+
+	/**	@desc vertex array currently bound
+	 */
+	GLuint boundVertexArray();
+
+	/**	@desc element buffer held by a vertex array (0 is the default vertex array)
+	 */
+	GLuint elementBuffer( GLuint vao );
+
+	/**	@desc whether a vertex array has an attribute enabled
+	 */
+	bool attributeEnabled( GLuint vao, GLuint index );
+
+	/**	@desc current polygon mode
+	 */
+	GLenum polygonMode();
+
+	/**	@desc bytes last given to glBufferData for a buffer
+	 */
+	GLsizeiptr bufferSize( GLuint buffer );
+
+	/**	@desc bytes given to glTexImage2D() and glCompressedTexImage2D() since the last reset,
+	 *	counting glTexImage2D() rows as tightly packed unsigned bytes
+	 */
+	size_t textureBytes();
+
+	/**	@desc x, y, z of every vertex the last glDrawArrays() read from a
+	 *	client side GL_VERTEX_ARRAY (OpenGL 2.1 labs without a VBO)
+	 */
+	const std::vector<GLfloat>& clientVertices();
+}
+
+#endif // __CSCI441_GL_MOCK_HPP__
@@ -0,0 +1,120 @@
+/*
+ *  imageDecoderBenchmark.cpp
+ *
+ *  CSCI441::ImageDecoder against SOIL, loading textures the way the labs
+ *  hand them to OpenGL: SOIL_load_image() followed by flipping the rows,
+ *  against loadImage() with DECODE_FLIP_Y.  Each of lab08's hellknight
+ *  textures and lab12's 3000x3000 rue2bump.jpg is timed on its own, then
+ *  the hellknight set is loaded one file after another through SOIL and
+ *  all at once through loadImages().  PNGs must give SOIL's bytes.
+ *  rue2bump.jpg has no restart markers, so SOIL reads it correctly and
+ *  may only differ by rounding: each sample within 1.  Times are the best
+ *  of the runs; the files are read warm from the page cache.
+ *
+ *  usage: imageDecoderBenchmark [runs=5]
+ */
+
+#include "testHarness.hpp"
+
+#include <CSCI441/imageDecoder.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+static const char *HELLKNIGHT[10] = {
+	"../lab08/models/monsters/hellknight/textures/hellknight.png", "../lab08/models/monsters/hellknight/textures/hellknight_local.png",
+	"../lab08/models/monsters/hellknight/textures/hellknight_s.png", "../lab08/models/monsters/hellknight/textures/gob.png",
+	"../lab08/models/monsters/hellknight/textures/gob_s.png", "../lab08/models/monsters/hellknight/textures/gob2.png",
+	"../lab08/models/monsters/hellknight/textures/gob2_s.png", "../lab08/models/monsters/hellknight/textures/tongue.png",
+	"../lab08/models/monsters/hellknight/textures/tongue_local.png", "../lab08/models/monsters/hellknight/textures/tongue_s.png"
+};
+static const char *RUE2BUMP = "../lab12/models/medstreet/rue2bump.jpg";
+
+// what the labs did before ImageDecoder
+static unsigned char* loadWithSOIL( const char *filename, int *width, int *height, int *channels ) {
+	unsigned char *pixels = SOIL_load_image( filename, width, height, channels, SOIL_LOAD_AUTO );
+	if( pixels ) CSCI441::ImageKernels::flipRows( pixels, *width, *height, *channels );
+	return pixels;
+}
+
+static int maxDifference( const unsigned char *a, const unsigned char *b, size_t size ) {
+	int difference = 0;
+	for( size_t i = 0; i < size; i++ ) {
+		const int d = abs( a[i] - b[i] );
+		if( d > difference ) difference = d;
+	}
+	return difference;
+}
+
+static void benchmarkFile( const char *name, const char *filename, int tolerance, int runs ) {
+	TestHarness::Timings soilTimes, decoderTimes;
+	int soilWidth = 0, soilHeight = 0, soilChannels = 0, width = 0, height = 0, channels = 0, difference = 0;
+	for( int run = 0; run < runs; run++ ) {
+		double start = TestHarness::now();
+		unsigned char *expected = loadWithSOIL( filename, &soilWidth, &soilHeight, &soilChannels );
+		soilTimes.add( TestHarness::now() - start );
+
+		start = TestHarness::now();
+		unsigned char *pixels = CSCI441::ImageDecoder::loadImage( filename, &width, &height, &channels, SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
+		decoderTimes.add( TestHarness::now() - start );
+
+		CHECK( expected && pixels && width == soilWidth && height == soilHeight && channels == soilChannels );
+		if( expected && pixels ) {
+			difference = maxDifference( pixels, expected, (size_t)width * height * channels );
+			CHECK( difference <= tolerance );
+		}
+		CSCI441::ImageDecoder::freeImageData( pixels );
+		SOIL_free_image_data( expected );
+	}
+
+	const double soil = soilTimes.percentile( 0 ), decoder = decoderTimes.percentile( 0 );
+	printf( "[INFO]: %-24s %4dx%-4d %d  SOIL %8.2f ms  ImageDecoder %8.2f ms  %5.2fx  max difference %d\n", name, width, height, channels, soil, decoder, soil / decoder, difference );
+}
+
+static void benchmarkSet( int runs ) {
+	TestHarness::Timings soilTimes, decoderTimes;
+	for( int run = 0; run < runs; run++ ) {
+		std::vector< unsigned char* > expected( 10 );
+		std::vector< int > sizes( 10 );
+		double start = TestHarness::now();
+		for( int i = 0; i < 10; i++ ) {
+			int width, height, channels;
+			expected[i] = loadWithSOIL( HELLKNIGHT[i], &width, &height, &channels );
+			sizes[i] = width * height * channels;
+		}
+		soilTimes.add( TestHarness::now() - start );
+
+		CSCI441::ImageDecoder::ImageFile images[10];
+		for( int i = 0; i < 10; i++ ) images[i].filename = HELLKNIGHT[i];
+		start = TestHarness::now();
+		const int numLoaded = CSCI441::ImageDecoder::loadImages( images, 10, SOIL_LOAD_AUTO, CSCI441::ImageDecoder::DECODE_FLIP_Y );
+		decoderTimes.add( TestHarness::now() - start );
+
+		CHECK( numLoaded == 10 );
+		for( int i = 0; i < 10; i++ ) {
+			CHECK( expected[i] && images[i].pixels && images[i].width * images[i].height * images[i].channels == sizes[i] );
+			CHECK( expected[i] && images[i].pixels && maxDifference( images[i].pixels, expected[i], sizes[i] ) == 0 );
+			CSCI441::ImageDecoder::freeImageData( images[i].pixels );
+			SOIL_free_image_data( expected[i] );
+		}
+	}
+
+	const double soil = soilTimes.percentile( 0 ), decoder = decoderTimes.percentile( 0 );
+	printf( "[INFO]: %-34s  SOIL %8.2f ms  loadImages   %8.2f ms  %5.2fx\n", "lab08 hellknight set, 10 files", soil, decoder, soil / decoder );
+}
+
+int main( int argc, char *argv[] ) {
+	const int runs = argc > 1 ? atoi( argv[1] ) : 5;
+
+	for( int i = 0; i < 10; i++ ) {
+		const char *name = strrchr( HELLKNIGHT[i], '/' ) + 1;
+		benchmarkFile( name, HELLKNIGHT[i], 0, runs );
+	}
+	benchmarkFile( "rue2bump.jpg", RUE2BUMP, 1, runs );
+	benchmarkSet( runs );
+
+	return TestHarness::result( "imageDecoderBenchmark" );
+}
@@ -0,0 +1,234 @@
+/*
+ *  imageDecoderTest.cpp
+ *
+ *  Checks CSCI441::ImageDecoder against SOIL and libjpeg.  The lab PNGs
+ *  must decode to exactly what SOIL_load_image gives, flipped or not and
+ *  with channels forced.  The JPEGs must match libjpeg's accurate integer
+ *  DCT without fancy upsampling at every thread count; the expected
+ *  hashes below were taken from libjpeg's output.  SOIL is not the
+ *  reference for JPEGs, since its stb_image decodes metal.jpg and the
+ *  necros_hell faces wrong after their first restart marker.  Cut short
+ *  and randomly damaged files must fail or decode without reading or
+ *  writing out of bounds, and headers claiming huge sizes must be refused
+ *  before anything is allocated for them.
+ */
+
+#include "testHarness.hpp"
+
+#include <CSCI441/imageDecoder.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+struct ExpectedJPEG {
+	const char *filename;
+	int width, height;
+	unsigned long long hash, flippedHash;
+};
+
+// libjpeg 8-bit, JDCT_ISLOW, do_fancy_upsampling = FALSE
+static const ExpectedJPEG JPEGS[3] = {
+	{ "../lab08/textures/metal.jpg", 128, 128, 0x56328b817230a5e4ULL, 0x13353e4f95757bc0ULL },					// restart every 16 MCUs, 1x1 sampling
+	{ "../lab08/textures/skybox/necros_hell_front.JPG", 512, 512, 0xb489243a12eeabf2ULL, 0x313afa40f5ab2f8aULL },	// restart every 64 MCUs
+	{ "../lab12/models/medstreet/rue2bump.jpg", 3000, 3000, 0x4d806ec8ad681370ULL, 0x335e6c6cf8244cccULL }		// no restarts, 2x2 luma sampling
+};
+
+static const char *PNGS[5] = { "../lab05/textures/mines.png", "../lab08/models/monsters/hellknight/textures/hellknight.png",
+							   "../lab08/models/monsters/hellknight/textures/gob.png", "../lab12/grayscale.png",
+							   "../lab12/textures/skybox/DOOM16UP.png" };
+
+static unsigned int randomState = 441;
+static unsigned int nextRandom() {
+	randomState = randomState * 1103515245u + 12345u;
+	return randomState >> 8;
+}
+
+static unsigned long long hashPixels( const unsigned char *pixels, size_t size ) {
+	// FNV-1a
+	unsigned long long hash = 14695981039346656037ULL;
+	for( size_t i = 0; i < size; i++ ) {
+		hash ^= pixels[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static std::vector< unsigned char > readFile( const char *filename ) {
+	CSCI441_INTERNAL::MappedFile file;
+	std::vector< unsigned char > bytes;
+	if( !CSCI441_INTERNAL::mapFile( filename, file ) ) return bytes;
+	bytes.assign( file.data, file.data + file.size );
+	CSCI441_INTERNAL::unmapFile( file );
+	return bytes;
+}
+
+// runs the built in decoder for the file on a buffer exactly as large as the image, with no SOIL behind it
+static bool decodeDirectly( const std::vector< unsigned char > &file, unsigned int flags, unsigned int numThreads, std::vector< unsigned char > &pixels ) {
+	const unsigned char *data = file.empty() ? NULL : &file[0];
+	int width, height, channels;
+	const std::vector< CSCI441_INTERNAL::ImageDecoderEntry > &decoders = CSCI441_INTERNAL::getImageDecoders();
+	for( size_t i = 0; i < decoders.size(); i++ ) {
+		if( !decoders[i].info( data, file.size(), &width, &height, &channels ) ) continue;
+		if( (size_t)width * height > 4096 * 4096 ) return false;
+		pixels.assign( (size_t)width * height * channels, 0 );
+		return decoders[i].decode( data, file.size(), &pixels[0], flags, numThreads );
+	}
+	return false;
+}
+
+static void testPNGsMatchSOIL() {
+	for( int i = 0; i < 5; i++ ) {
+		for( int forceChannels = SOIL_LOAD_AUTO; forceChannels <= SOIL_LOAD_RGBA; forceChannels += SOIL_LOAD_RGBA ) {
+			int soilWidth, soilHeight, soilChannels;
+			unsigned char *expected = SOIL_load_image( PNGS[i], &soilWidth, &soilHeight, &soilChannels, forceChannels );
+			CHECK( expected != NULL );
+			if( !expected ) continue;
+			const int outChannels = forceChannels == SOIL_LOAD_AUTO ? soilChannels : forceChannels;
+			const size_t size = (size_t)soilWidth * soilHeight * outChannels;
+
+			int width, height, channels;
+			unsigned char *pixels = CSCI441::ImageDecoder::loadImage( PNGS[i], &width, &height, &channels, forceChannels );
+			CHECK( pixels != NULL && strcmp( CSCI441::ImageDecoder::getLastResult(), "Image loaded" ) == 0 );
+			CHECK( width == soilWidth && height == soilHeight && channels == soilChannels );
+			CHECK( pixels && memcmp( pixels, expected, size ) == 0 );
+			CSCI441::ImageDecoder::freeImageData( pixels );
+
+			CSCI441::ImageKernels::flipRows( expected, soilWidth, soilHeight, outChannels );
+			pixels = CSCI441::ImageDecoder::loadImage( PNGS[i], &width, &height, &channels, forceChannels, CSCI441::ImageDecoder::DECODE_FLIP_Y );
+			CHECK( pixels && memcmp( pixels, expected, size ) == 0 );
+			CSCI441::ImageDecoder::freeImageData( pixels );
+			SOIL_free_image_data( expected );
+		}
+	}
+}
+
+static void testJPEGsMatchLibjpeg() {
+	static const unsigned int THREADS[4] = { 1, 2, 3, 5 };
+	for( int i = 0; i < 3; i++ ) {
+		const std::vector< unsigned char > file = readFile( JPEGS[i].filename );
+		CHECK( !file.empty() );
+		if( file.empty() ) continue;
+
+		int width, height, channels;
+		CHECK( CSCI441::ImageDecoder::getImageInfo( &file[0], file.size(), &width, &height, &channels ) );
+		CHECK( width == JPEGS[i].width && height == JPEGS[i].height && channels == 3 );
+
+		std::vector< unsigned char > pixels;
+		for( int t = 0; t < 4; t++ ) {
+			CHECK( decodeDirectly( file, 0, THREADS[t], pixels ) );
+			CHECK( hashPixels( &pixels[0], pixels.size() ) == JPEGS[i].hash );
+			CHECK( decodeDirectly( file, CSCI441::ImageDecoder::DECODE_FLIP_Y, THREADS[t], pixels ) );
+			CHECK( hashPixels( &pixels[0], pixels.size() ) == JPEGS[i].flippedHash );
+		}
+	}
+}
+
+static void testLoadImagesMatchesLoadImage() {
+	CSCI441::ImageDecoder::ImageFile images[5] = {
+		{ PNGS[0], NULL, 0, 0, 0 }, { JPEGS[0].filename, NULL, 0, 0, 0 }, { "imageDecoderTest.missing.png", NULL, 0, 0, 0 },
+		{ PNGS[3], NULL, 0, 0, 0 }, { JPEGS[1].filename, NULL, 0, 0, 0 }
+	};
+	CHECK( CSCI441::ImageDecoder::loadImages( images, 5, SOIL_LOAD_RGBA, CSCI441::ImageDecoder::DECODE_FLIP_Y ) == 4 );
+	CHECK( images[2].pixels == NULL );
+
+	for( int i = 0; i < 5; i++ ) {
+		if( !images[i].pixels ) continue;
+		int width, height, channels;
+		unsigned char *pixels = CSCI441::ImageDecoder::loadImage( images[i].filename, &width, &height, &channels, SOIL_LOAD_RGBA, CSCI441::ImageDecoder::DECODE_FLIP_Y );
+		CHECK( pixels && width == images[i].width && height == images[i].height && channels == images[i].channels );
+		CHECK( pixels && memcmp( pixels, images[i].pixels, (size_t)width * height * 4 ) == 0 );
+		CSCI441::ImageDecoder::freeImageData( pixels );
+		CSCI441::ImageDecoder::freeImageData( images[i].pixels );
+	}
+}
+
+static void testTruncatedFiles() {
+	// a PNG missing any of its compressed data fails; a JPEG cut inside its entropy data decodes the rest as zeros, as libjpeg does
+	const char *FILES[2] = { PNGS[0], JPEGS[0].filename };
+	for( int f = 0; f < 2; f++ ) {
+		const std::vector< unsigned char > file = readFile( FILES[f] );
+		CHECK( !file.empty() );
+		int numDecoded = 0;
+		for( size_t length = 0; length < file.size(); length += 1 + file.size() / 300 ) {
+			std::vector< unsigned char > truncated( file.begin(), file.begin() + length );
+			std::vector< unsigned char > pixels;
+			if( decodeDirectly( truncated, (unsigned int)( length & 1 ), 1 + (unsigned int)( length % 3 ), pixels ) ) numDecoded++;
+		}
+		if( f == 0 ) CHECK( numDecoded == 0 );
+		else CHECK( numDecoded > 0 );
+	}
+}
+
+static void testDamagedFiles() {
+	// bytes changed at random, mostly in the headers and tables at the front; ASan and UBSan builds catch what a check cannot
+	const char *FILES[4] = { PNGS[0], PNGS[2], PNGS[3], JPEGS[0].filename };
+	for( int f = 0; f < 4; f++ ) {
+		const std::vector< unsigned char > file = readFile( FILES[f] );
+		CHECK( !file.empty() );
+		if( file.empty() ) continue;
+		for( int run = 0; run < 500; run++ ) {
+			std::vector< unsigned char > damaged( file );
+			const int numChanges = 1 + nextRandom() % 8;
+			for( int c = 0; c < numChanges; c++ ) {
+				const unsigned int region = nextRandom() & 3;
+				const size_t limit = region == 0 ? 64 : region == 1 ? 2048 : damaged.size();
+				const size_t position = nextRandom() % ( limit < damaged.size() ? limit : damaged.size() );
+				damaged[position] = ( nextRandom() & 1 ) ? (unsigned char)nextRandom() : (unsigned char)( damaged[position] ^ ( 1 << ( nextRandom() & 7 ) ) );
+			}
+			std::vector< unsigned char > pixels;
+			decodeDirectly( damaged, nextRandom() & 1, 1 + run % 3, pixels );
+		}
+	}
+}
+
+static void testHugeHeadersAreRefused() {
+	int width, height, channels;
+
+	// an IHDR of 2^31-1 by 2^31-1, the largest PNG allows
+	std::vector< unsigned char > png = readFile( PNGS[0] );
+	CHECK( png.size() > 24 );
+	if( png.size() > 24 ) {
+		memset( &png[16], 0xFF, 8 );
+		png[16] = png[20] = 0x7F;
+		double start = TestHarness::now();
+		unsigned char *pixels = CSCI441::ImageDecoder::loadImageFromMemory( &png[0], png.size(), &width, &height, &channels );
+		CHECK( pixels == NULL );
+		CHECK( strcmp( CSCI441::ImageDecoder::getLastResult(), "Image is too large" ) == 0 );
+		unsigned char buffer[16];
+		CHECK( !CSCI441::ImageDecoder::decodeInto( &png[0], png.size(), buffer, sizeof( buffer ), &width, &height, &channels ) );
+		CHECK( strcmp( CSCI441::ImageDecoder::getLastResult(), "Image is too large" ) == 0 );
+
+		// past 2^31 is not a PNG at all
+		png[16] = 0x80;
+		std::vector< unsigned char > ignored;
+		CHECK( !decodeDirectly( png, 0, 1, ignored ) );
+		CHECK( TestHarness::now() - start < 1000.0 );
+	}
+
+	// a start of frame of 65535 by 65535
+	std::vector< unsigned char > jpeg = readFile( JPEGS[0].filename );
+	size_t frame = 2;
+	while( frame + 9 < jpeg.size() && jpeg[frame + 1] != 0xC0 ) frame += 2 + ( jpeg[frame + 2] << 8 ) + jpeg[frame + 3];
+	CHECK( frame + 9 < jpeg.size() );
+	if( frame + 9 < jpeg.size() ) {
+		memset( &jpeg[frame + 5], 0xFF, 4 );
+		double start = TestHarness::now();
+		unsigned char *pixels = CSCI441::ImageDecoder::loadImageFromMemory( &jpeg[0], jpeg.size(), &width, &height, &channels );
+		CHECK( pixels == NULL );
+		CHECK( strcmp( CSCI441::ImageDecoder::getLastResult(), "Image is too large" ) == 0 );
+		CHECK( TestHarness::now() - start < 1000.0 );
+	}
+}
+
+int main() {
+	testPNGsMatchSOIL();
+	testJPEGsMatchLibjpeg();
+	testLoadImagesMatchesLoadImage();
+	testTruncatedFiles();
+	testDamagedFiles();
+	testHugeHeadersAreRefused();
+
+	return TestHarness::result( "imageDecoderTest" );
+}
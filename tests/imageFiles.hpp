@@ -0,0 +1,127 @@
+/** @file imageFiles.hpp
+  * @brief Writes the TGA and BMP files the loader tests and benchmarks read back
+	* @author Dr. Jeffrey Paone
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	The writers take RGB or RGBA pixels top row first, the way loadTGA()
+	*	returns them, and store them the way the format wants: BGR, bottom row
+	*	first unless asked otherwise.  The RLE encoder lets packets run across
+	*	rows, as other tools do.
+  */
+
+#ifndef __CSCI441_IMAGE_FILES_HPP__
+#define __CSCI441_IMAGE_FILES_HPP__
+
+#include <stdio.h>									// for FILE
+#include <string.h>									// for memcmp()
+
+#include <vector>										// for vector
+
+namespace ImageFiles {
+	/**	@desc writes a 24 or 32 bit TGA, uncompressed or RLE
+	 *	@param pixels width*height*channels bytes, top row first
+	 *	@param topLeft whether to store the top row first and flag the origin
+	 *	@param idLength bytes of image id to write after the header
+	 *	@return the bytes written
+	 */
+	std::vector<unsigned char> encodeTGA( const unsigned char *pixels, int width, int height, int channels, bool rle, bool topLeft, int idLength = 0 );
+
+	/**	@desc writes a 24 bit BMP
+	 *	@param pixels width*height*3 bytes, bottom row first
+	 *	@param topDown whether to store the top row first with a negative height
+	 *	@return the bytes written
+	 */
+	std::vector<unsigned char> encodeBMP( const unsigned char *pixels, int width, int height, bool topDown );
+
+	/**	@desc writes bytes to a file
+	 */
+	void writeFile( const char *filename, const std::vector<unsigned char> &bytes );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+
+inline std::vector<unsigned char> ImageFiles::encodeTGA( const unsigned char *pixels, int width, int height, int channels, bool rle, bool topLeft, int idLength ) {
+	std::vector<unsigned char> file( 18, 0 );
+	file[0] = (unsigned char)idLength;
+	file[2] = rle ? 10 : 2;
+	file[12] = width & 0xFF;	file[13] = width >> 8;
+	file[14] = height & 0xFF;	file[15] = height >> 8;
+	file[16] = (unsigned char)( channels * 8 );
+	file[17] = topLeft ? 32 : 0;
+	for( int i = 0; i < idLength; i++ ) file.push_back( (unsigned char)i );
+
+	// every pixel in file order, BGR
+	std::vector<unsigned char> stored;
+	for( int row = 0; row < height; row++ ) {
+		const unsigned char *source = pixels + (size_t)( topLeft ? row : height - 1 - row ) * width * channels;
+		for( int column = 0; column < width; column++, source += channels ) {
+			stored.push_back( source[2] );
+			stored.push_back( source[1] );
+			stored.push_back( source[0] );
+			if( channels == 4 ) stored.push_back( source[3] );
+		}
+	}
+
+	if( !rle ) {
+		file.insert( file.end(), stored.begin(), stored.end() );
+		return file;
+	}
+
+	// runs of two or more equal pixels become run packets, everything else raw packets
+	const size_t numPixels = (size_t)width * height;
+	size_t pixel = 0;
+	while( pixel < numPixels ) {
+		size_t run = 1;
+		while( pixel + run < numPixels && run < 128 && memcmp( &stored[pixel*channels], &stored[(pixel + run)*channels], channels ) == 0 ) run++;
+		if( run > 1 ) {
+			file.push_back( (unsigned char)( 0x80 | ( run - 1 ) ) );
+			file.insert( file.end(), stored.begin() + pixel*channels, stored.begin() + ( pixel + 1 )*channels );
+			pixel += run;
+			continue;
+		}
+
+		size_t count = 1;
+		while( pixel + count < numPixels && count < 128
+			&& ( pixel + count + 1 >= numPixels || memcmp( &stored[(pixel + count)*channels], &stored[(pixel + count + 1)*channels], channels ) != 0 ) ) count++;
+		file.push_back( (unsigned char)( count - 1 ) );
+		file.insert( file.end(), stored.begin() + pixel*channels, stored.begin() + ( pixel + count )*channels );
+		pixel += count;
+	}
+	return file;
+}
+
+inline std::vector<unsigned char> ImageFiles::encodeBMP( const unsigned char *pixels, int width, int height, bool topDown ) {
+	const size_t rowBytes = (size_t)width * 3, stride = ( rowBytes + 3 ) & ~(size_t)3;
+	std::vector<unsigned char> file( 54, 0 );
+	const unsigned int pixelBytes = (unsigned int)( stride * height ), storedHeight = topDown ? -height : height;
+	const unsigned int fields[][2] = { { 2, 54 + pixelBytes }, { 10, 54 }, { 14, 40 }, { 18, (unsigned int)width }, { 22, storedHeight }, { 34, pixelBytes } };
+	file[0] = 'B';
+	file[1] = 'M';
+	for( size_t f = 0; f < sizeof( fields ) / sizeof( fields[0] ); f++ ) {
+		for( int b = 0; b < 4; b++ ) file[fields[f][0] + b] = ( fields[f][1] >> ( 8*b ) ) & 0xFF;
+	}
+	file[26] = 1;
+	file[28] = 24;
+
+	for( int row = 0; row < height; row++ ) {
+		const unsigned char *source = pixels + (size_t)( topDown ? height - 1 - row : row ) * rowBytes;
+		for( int column = 0; column < width; column++, source += 3 ) {
+			file.push_back( source[2] );
+			file.push_back( source[1] );
+			file.push_back( source[0] );
+		}
+		file.resize( file.size() + stride - rowBytes, 0 );
+	}
+	return file;
+}
+
+inline void ImageFiles::writeFile( const char *filename, const std::vector<unsigned char> &bytes ) {
+	FILE *fp = fopen( filename, "wb" );
+	if( !fp ) return;
+	if( !bytes.empty() ) fwrite( &bytes[0], 1, bytes.size(), fp );
+	fclose( fp );
+}
+
+#endif // __CSCI441_IMAGE_FILES_HPP__
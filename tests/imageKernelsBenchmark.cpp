@@ -0,0 +1,188 @@
+/*
+ *  imageKernelsBenchmark.cpp
+ *
+ *  Each ImageKernels pass on one image, one thread at a time through the
+ *  plain loop, the SSE2 step and the AVX2 step, and then through the
+ *  public function, which picks the widest step and splits large images
+ *  across threads.  Every result is checked against the plain loop.  MB/s
+ *  counts the bytes read and written.
+ *
+ *  usage: imageKernelsBenchmark [size=2048] [runs=10]
+ */
+
+#include "testHarness.hpp"
+
+#include <CSCI441/imageKernels.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+typedef CSCI441_INTERNAL::ImageKernelJob Job;
+typedef size_t (*VectorStep)( const Job&, size_t, size_t );
+typedef void (*PlainStep)( const Job&, size_t, size_t );
+
+static int runs = 10;
+
+// best time in milliseconds of a step over every pixel, finished by the plain loop
+static double timeStep( VectorStep step, PlainStep plain, const Job &job, size_t numPixels, void (*reset)() ) {
+	TestHarness::Timings times;
+	for( int run = 0; run < runs; run++ ) {
+		if( reset ) reset();
+		double start = TestHarness::now();
+		size_t i = step ? step( job, 0, numPixels ) : 0;
+		plain( job, i, numPixels );
+		times.add( TestHarness::now() - start );
+	}
+	return times.percentile( 0 );
+}
+
+static void report( const char *label, double ms, double bytes, double plainMs ) {
+	printf( "[INFO]: %-34s %8.3f ms %8.1f MB/s  %5.2fx\n", label, ms, bytes / 1e3 / ms, plainMs / ms );
+}
+
+// times the plain loop, then each vector step the processor has, checking each against the plain result
+template< typename T >
+static void compareSteps( const char *name, VectorStep sse2, VectorStep avx2, PlainStep plain, const Job &job, size_t numPixels, double bytes,
+						  std::vector< T > &output, void (*reset)() ) {
+	char label[64];
+	const double plainMs = timeStep( NULL, plain, job, numPixels, reset );
+	const std::vector< T > expected( output );
+	sprintf( label, "%s plain", name );
+	report( label, plainMs, bytes, plainMs );
+	if( sse2 ) {
+		const double ms = timeStep( sse2, plain, job, numPixels, reset );
+		CHECK( memcmp( &output[0], &expected[0], output.size() * sizeof(T) ) == 0 );
+		sprintf( label, "%s SSE2", name );
+		report( label, ms, bytes, plainMs );
+	}
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( avx2 && CSCI441_INTERNAL::useAVX2ImageKernels() ) {
+		const double ms = timeStep( avx2, plain, job, numPixels, reset );
+		CHECK( memcmp( &output[0], &expected[0], output.size() * sizeof(T) ) == 0 );
+		sprintf( label, "%s AVX2", name );
+		report( label, ms, bytes, plainMs );
+	}
+#endif
+}
+
+static std::vector< unsigned char > color, mask, rgba, source, swapped, srgb;
+static std::vector< float > linear;
+
+static void resetRGBA() {
+	memcpy( &rgba[0], &source[0], rgba.size() );
+}
+
+int main( int argc, char *argv[] ) {
+	const int size = argc > 1 ? atoi( argv[1] ) : 2048;
+	runs = argc > 2 ? atoi( argv[2] ) : 10;
+	const size_t numPixels = (size_t)size * size;
+	printf( "[INFO]: %d x %d, best of %d runs\n", size, size, runs );
+
+	VectorStep sse2[3] = { NULL, NULL, NULL }, avx2[5] = { NULL, NULL, NULL, NULL, NULL };
+#ifdef __SSE2__
+	sse2[0] = CSCI441_INTERNAL::swapRedBlueSSE2;
+	sse2[1] = CSCI441_INTERNAL::expandRGBASSE2;
+	sse2[2] = CSCI441_INTERNAL::premultiplyAlphaSSE2;
+#endif
+#ifdef CSCI441_IMAGEKERNELS_X86
+	avx2[0] = CSCI441_INTERNAL::swapRedBlueAVX2;
+	avx2[1] = CSCI441_INTERNAL::expandRGBAAVX2;
+	avx2[2] = CSCI441_INTERNAL::premultiplyAlphaAVX2;
+	avx2[3] = CSCI441_INTERNAL::srgbToLinearAVX2;
+	avx2[4] = CSCI441_INTERNAL::linearToSrgbAVX2;
+	printf( "[INFO]: the public functions %s AVX2\n", CSCI441_INTERNAL::useAVX2ImageKernels() ? "use" : "run without" );
+#endif
+
+	srand( 441 );
+	color.resize( numPixels * 3 );
+	mask.resize( numPixels );
+	for( size_t i = 0; i < color.size(); i++ ) color[i] = rand() % 256;
+	for( size_t i = 0; i < mask.size(); i++ ) mask[i] = rand() % 256;
+	rgba.resize( numPixels * 4 );
+	swapped.resize( numPixels * 4 );
+
+	for( int channels = 3; channels <= 4; channels++ ) {
+		Job job = Job();
+		job.source = channels == 3 ? &color[0] : &rgba[0];
+		job.destination = &swapped[0];
+		job.channels = channels;
+		swapped.resize( numPixels * channels );
+		compareSteps( channels == 3 ? "swapRedBlue RGB" : "swapRedBlue RGBA", sse2[0], avx2[0], CSCI441_INTERNAL::swapRedBluePixels, job, numPixels, 2.0 * numPixels * channels, swapped, NULL );
+	}
+
+	for( int maskChannels = 0; maskChannels <= 1; maskChannels++ ) {
+		Job job = Job();
+		job.source = &color[0];
+		job.sourceChannels = 3;
+		job.mask = maskChannels ? &mask[0] : NULL;
+		job.maskChannels = maskChannels;
+		job.destination = &rgba[0];
+		compareSteps( maskChannels ? "expandRGBA RGB + mask" : "expandRGBA RGB", sse2[1], avx2[1], CSCI441_INTERNAL::expandRGBAPixels, job, numPixels, numPixels * ( 7.0 + maskChannels ), rgba, NULL );
+	}
+	{
+		Job job = Job();
+		job.source = &mask[0];
+		job.sourceChannels = 1;
+		job.mask = &mask[0];
+		job.maskChannels = 1;
+		job.destination = &rgba[0];
+		compareSteps( "expandRGBA gray + mask", sse2[1], avx2[1], CSCI441_INTERNAL::expandRGBAPixels, job, numPixels, numPixels * 6.0, rgba, NULL );
+	}
+
+	// premultiplying works in place, so every run starts from the same pixels
+	CSCI441::ImageKernels::expandRGBA( &color[0], 3, &mask[0], 1, &rgba[0], numPixels );
+	source = rgba;
+	{
+		Job job = Job();
+		job.destination = &rgba[0];
+		compareSteps( "premultiplyAlpha", sse2[2], avx2[2], CSCI441_INTERNAL::premultiplyAlphaPixels, job, numPixels, numPixels * 8.0, rgba, resetRGBA );
+	}
+
+	linear.resize( numPixels * 4 );
+	srgb.resize( numPixels * 4 );
+	for( int channels = 3; channels <= 4; channels++ ) {
+		Job job = Job();
+		job.source = &source[0];
+		job.linearDestination = &linear[0];
+		job.channels = channels;
+		linear.resize( numPixels * channels );
+		compareSteps( channels == 3 ? "srgbToLinear RGB" : "srgbToLinear RGBA", NULL, avx2[3], CSCI441_INTERNAL::srgbToLinearPixels, job, numPixels, 5.0 * numPixels * channels, linear, NULL );
+
+		job = Job();
+		job.linearSource = &linear[0];
+		job.destination = &srgb[0];
+		job.channels = channels;
+		srgb.resize( numPixels * channels );
+		compareSteps( channels == 3 ? "linearToSrgb RGB" : "linearToSrgb RGBA", NULL, avx2[4], CSCI441_INTERNAL::linearToSrgbPixels, job, numPixels, 5.0 * numPixels * channels, srgb, NULL );
+		CHECK( memcmp( &srgb[0], &source[0], srgb.size() ) == 0 || channels == 3 );
+	}
+
+	// what callers see: the widest step, split across threads
+	TestHarness::Timings swapTimes, expandTimes, premultiplyTimes, toLinearTimes, toSrgbTimes;
+	for( int run = 0; run < runs; run++ ) {
+		double start = TestHarness::now();
+		CSCI441::ImageKernels::swapRedBlue( &color[0], &swapped[0], numPixels, 3 );
+		swapTimes.add( TestHarness::now() - start );
+		start = TestHarness::now();
+		CSCI441::ImageKernels::expandRGBA( &color[0], 3, &mask[0], 1, &rgba[0], numPixels );
+		expandTimes.add( TestHarness::now() - start );
+		start = TestHarness::now();
+		CSCI441::ImageKernels::premultiplyAlpha( &rgba[0], numPixels );
+		premultiplyTimes.add( TestHarness::now() - start );
+		start = TestHarness::now();
+		CSCI441::ImageKernels::srgbToLinear( &rgba[0], &linear[0], numPixels, 4 );
+		toLinearTimes.add( TestHarness::now() - start );
+		start = TestHarness::now();
+		CSCI441::ImageKernels::linearToSrgb( &linear[0], &srgb[0], numPixels, 4 );
+		toSrgbTimes.add( TestHarness::now() - start );
+	}
+	printf( "[INFO]: public swapRedBlue RGB         %8.3f ms\n", swapTimes.percentile( 0 ) );
+	printf( "[INFO]: public expandRGBA RGB + mask   %8.3f ms\n", expandTimes.percentile( 0 ) );
+	printf( "[INFO]: public premultiplyAlpha        %8.3f ms\n", premultiplyTimes.percentile( 0 ) );
+	printf( "[INFO]: public srgbToLinear RGBA       %8.3f ms\n", toLinearTimes.percentile( 0 ) );
+	printf( "[INFO]: public linearToSrgb RGBA       %8.3f ms\n", toSrgbTimes.percentile( 0 ) );
+
+	return TestHarness::result( "imageKernelsBenchmark" );
+}
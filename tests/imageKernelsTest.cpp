@@ -0,0 +1,350 @@
+/*
+ *  imageKernelsTest.cpp
+ *
+ *  Checks every ImageKernels pass against a plain reference written here,
+ *  through the public functions and through each step on its own: the
+ *  plain loop, SSE2 and, when the processor has it, AVX2.  Sizes and
+ *  starting pixels are random so every step meets odd remainders, and the
+ *  buffers are exactly as long as the pixels so a step that reads past its
+ *  image shows up under AddressSanitizer.  Gray color images and every
+ *  mask depth are covered, premultiplyAlpha and srgbToLinear are checked
+ *  for every input, and linearToSrgb on random, out of range and NaN
+ *  values as well as every code boundary.
+ */
+
+#include "testHarness.hpp"
+
+#include <CSCI441/imageKernels.hpp>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+typedef CSCI441_INTERNAL::ImageKernelJob Job;
+typedef size_t (*VectorStep)( const Job&, size_t, size_t );
+typedef void (*PlainStep)( const Job&, size_t, size_t );
+
+// the steps one kernel can take; a NULL step leaves everything to the plain loop
+struct Steps {
+	VectorStep sse2, avx2;
+};
+
+// runs pixels first to last through one step and finishes with the plain loop; false if the step is not available
+static bool runStep( int step, const Steps &steps, PlainStep plain, const Job &job, size_t first, size_t last ) {
+	VectorStep vector = step == 1 ? steps.sse2 : ( step == 2 ? steps.avx2 : NULL );
+	if( step > 0 && !vector ) return false;
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( step == 2 && !CSCI441_INTERNAL::useAVX2ImageKernels() ) return false;
+#endif
+	size_t i = vector ? vector( job, first, last ) : first;
+	CHECK( i >= first && i <= last );
+	plain( job, i, last );
+	return true;
+}
+
+static Steps swapRedBlueSteps() {
+	Steps steps = { NULL, NULL };
+#ifdef __SSE2__
+	steps.sse2 = CSCI441_INTERNAL::swapRedBlueSSE2;
+#endif
+#ifdef CSCI441_IMAGEKERNELS_X86
+	steps.avx2 = CSCI441_INTERNAL::swapRedBlueAVX2;
+#endif
+	return steps;
+}
+
+static Steps expandRGBASteps() {
+	Steps steps = { NULL, NULL };
+#ifdef __SSE2__
+	steps.sse2 = CSCI441_INTERNAL::expandRGBASSE2;
+#endif
+#ifdef CSCI441_IMAGEKERNELS_X86
+	steps.avx2 = CSCI441_INTERNAL::expandRGBAAVX2;
+#endif
+	return steps;
+}
+
+static Steps premultiplyAlphaSteps() {
+	Steps steps = { NULL, NULL };
+#ifdef __SSE2__
+	steps.sse2 = CSCI441_INTERNAL::premultiplyAlphaSSE2;
+#endif
+#ifdef CSCI441_IMAGEKERNELS_X86
+	steps.avx2 = CSCI441_INTERNAL::premultiplyAlphaAVX2;
+#endif
+	return steps;
+}
+
+static Steps srgbToLinearSteps() {
+	Steps steps = { NULL, NULL };
+#ifdef CSCI441_IMAGEKERNELS_X86
+	steps.avx2 = CSCI441_INTERNAL::srgbToLinearAVX2;
+#endif
+	return steps;
+}
+
+static Steps linearToSrgbSteps() {
+	Steps steps = { NULL, NULL };
+#ifdef CSCI441_IMAGEKERNELS_X86
+	steps.avx2 = CSCI441_INTERNAL::linearToSrgbAVX2;
+#endif
+	return steps;
+}
+
+static std::vector< unsigned char > randomBytes( size_t count ) {
+	std::vector< unsigned char > bytes( count );
+	for( size_t i = 0; i < count; i++ ) bytes[i] = rand() % 256;
+	return bytes;
+}
+
+static double srgbDecode( double value ) {
+	return value <= 0.04045 ? value / 12.92 : pow( ( value + 0.055 ) / 1.055, 2.4 );
+}
+
+static void testFlipRows() {
+	srand( 441 );
+	for( int run = 0; run < 50; run++ ) {
+		const int width = 1 + rand() % 30, height = 1 + rand() % 30, channels = 1 + rand() % 4;
+		std::vector< unsigned char > pixels = randomBytes( (size_t)width * height * channels ), flipped( pixels );
+		CSCI441::ImageKernels::flipRows( &flipped[0], width, height, channels );
+		const size_t rowBytes = (size_t)width * channels;
+		for( int row = 0; row < height; row++ ) {
+			CHECK( memcmp( &flipped[row * rowBytes], &pixels[( height - 1 - row ) * rowBytes], rowBytes ) == 0 );
+		}
+	}
+}
+
+static void testSwapRedBlue() {
+	srand( 441 );
+	const Steps steps = swapRedBlueSteps();
+	for( int run = 0; run < 300; run++ ) {
+		const size_t numPixels = 1 + rand() % 100, first = rand() % numPixels;
+		const int channels = rand() % 2 ? 4 : 3;
+		const std::vector< unsigned char > source = randomBytes( numPixels * channels );
+		std::vector< unsigned char > expected( source );
+		for( size_t i = first; i < numPixels; i++ ) std::swap( expected[i*channels], expected[i*channels + 2] );
+
+		for( int step = 0; step < 3; step++ ) {
+			// out of place into a buffer of old garbage, and in place
+			std::vector< unsigned char > outOfPlace( source ), inPlace( source );
+			for( size_t i = first * channels; i < outOfPlace.size(); i++ ) outOfPlace[i] = rand() % 256;
+			Job job = Job();
+			job.source = &source[0];
+			job.destination = &outOfPlace[0];
+			job.channels = channels;
+			if( !runStep( step, steps, CSCI441_INTERNAL::swapRedBluePixels, job, first, numPixels ) ) continue;
+			CHECK( outOfPlace == expected );
+
+			job.source = job.destination = &inPlace[0];
+			runStep( step, steps, CSCI441_INTERNAL::swapRedBluePixels, job, first, numPixels );
+			CHECK( inPlace == expected );
+		}
+	}
+
+	std::vector< unsigned char > pixels = randomBytes( 3000 * 4 ), swapped( pixels.size() );
+	CSCI441::ImageKernels::swapRedBlue( &pixels[0], &swapped[0], 3000, 4 );
+	CHECK( swapped[0] == pixels[2] && swapped[1] == pixels[1] && swapped[2] == pixels[0] && swapped[3] == pixels[3] );
+	CHECK( swapped[4*2999] == pixels[4*2999 + 2] && swapped[4*2999 + 2] == pixels[4*2999] );
+}
+
+static void testExpandRGBA() {
+	srand( 441 );
+	const Steps steps = expandRGBASteps();
+	for( int run = 0; run < 1000; run++ ) {
+		const size_t numPixels = 1 + rand() % 100, first = rand() % numPixels;
+		const int colorChannels = rand() % 5, maskChannels = rand() % 5;
+		const std::vector< unsigned char > color = randomBytes( numPixels * colorChannels ), mask = randomBytes( numPixels * maskChannels );
+
+		// white where there is no color, gray for one or two channels; opaque where there is no mask
+		std::vector< unsigned char > expected( numPixels * 4, 7 );
+		for( size_t i = first; i < numPixels; i++ ) {
+			for( int c = 0; c < 3; c++ ) {
+				expected[4*i + c] = colorChannels == 0 ? 255 : color[i*colorChannels + ( colorChannels >= 3 ? c : 0 )];
+			}
+			expected[4*i + 3] = maskChannels == 0 ? 255 : mask[i*maskChannels];
+		}
+
+		for( int step = 0; step < 3; step++ ) {
+			std::vector< unsigned char > rgba( numPixels * 4, 7 );
+			Job job = Job();
+			job.source = colorChannels ? &color[0] : NULL;
+			job.sourceChannels = colorChannels;
+			job.mask = maskChannels ? &mask[0] : NULL;
+			job.maskChannels = maskChannels;
+			job.destination = &rgba[0];
+			if( !runStep( step, steps, CSCI441_INTERNAL::expandRGBAPixels, job, first, numPixels ) ) continue;
+			CHECK( rgba == expected );
+		}
+	}
+
+	// a gray image and its mask through the public function
+	const unsigned char gray[] = { 10, 20, 30 }, mask[] = { 1, 2, 3 };
+	const unsigned char expected[] = { 10, 10, 10, 1,  20, 20, 20, 2,  30, 30, 30, 3 };
+	unsigned char rgba[12];
+	CSCI441::ImageKernels::expandRGBA( gray, 1, mask, 1, rgba, 3 );
+	CHECK( memcmp( rgba, expected, 12 ) == 0 );
+	const unsigned char grayAlpha[] = { 10, 99, 20, 99, 30, 99 };
+	CSCI441::ImageKernels::expandRGBA( grayAlpha, 2, mask, 1, rgba, 3 );
+	CHECK( memcmp( rgba, expected, 12 ) == 0 );
+}
+
+static void testPremultiplyAlpha() {
+	// every color against every alpha, in each step
+	std::vector< unsigned char > pixels( 65536 * 4 ), expected( pixels.size() );
+	for( unsigned int i = 0; i < 65536; i++ ) {
+		const unsigned int color = i & 255, alpha = i >> 8;
+		pixels[4*i] = pixels[4*i + 1] = pixels[4*i + 2] = color;
+		pixels[4*i + 3] = alpha;
+		const unsigned char product = (unsigned char)floor( color * alpha / 255.0 + 0.5 );
+		expected[4*i] = expected[4*i + 1] = expected[4*i + 2] = product;
+		expected[4*i + 3] = alpha;
+	}
+
+	const Steps steps = premultiplyAlphaSteps();
+	srand( 441 );
+	for( int step = 0; step < 3; step++ ) {
+		std::vector< unsigned char > rgba( pixels );
+		Job job = Job();
+		job.destination = &rgba[0];
+		if( !runStep( step, steps, CSCI441_INTERNAL::premultiplyAlphaPixels, job, 0, 65536 ) ) continue;
+		CHECK( rgba == expected );
+
+		// and short runs that start anywhere
+		for( int run = 0; run < 200; run++ ) {
+			const size_t first = rand() % 65536, last = std::min< size_t >( 65536, first + rand() % 40 );
+			std::vector< unsigned char > part( pixels );
+			job.destination = &part[0];
+			runStep( step, steps, CSCI441_INTERNAL::premultiplyAlphaPixels, job, first, last );
+			CHECK( memcmp( &part[4*first], &expected[4*first], 4 * ( last - first ) ) == 0 );
+			CHECK( memcmp( &part[0], &pixels[0], 4*first ) == 0 && memcmp( &part[4*last], &pixels[4*last], part.size() - 4*last ) == 0 );
+		}
+	}
+}
+
+static void testSrgbToLinear() {
+	const Steps steps = srgbToLinearSteps();
+	for( int channels = 1; channels <= 4; channels++ ) {
+		// every code in every channel, with a count that leaves a remainder
+		const size_t numPixels = 256 + 5;
+		std::vector< unsigned char > srgb( numPixels * channels );
+		for( size_t i = 0; i < srgb.size(); i++ ) srgb[i] = (unsigned char)( i / channels + i % channels * 17 );
+
+		for( int step = 0; step < 3; step++ ) {
+			std::vector< float > linear( srgb.size(), -1.0f );
+			Job job = Job();
+			job.source = &srgb[0];
+			job.linearDestination = &linear[0];
+			job.channels = channels;
+			if( !runStep( step, steps, CSCI441_INTERNAL::srgbToLinearPixels, job, 0, numPixels ) ) continue;
+			for( size_t i = 0; i < srgb.size(); i++ ) {
+				const double expected = channels == 4 && i % 4 == 3 ? srgb[i] / 255.0 : srgbDecode( srgb[i] / 255.0 );
+				CHECK( fabs( linear[i] - expected ) < 1e-6 );
+			}
+		}
+	}
+}
+
+static void testLinearToSrgb() {
+	const Steps steps = linearToSrgbSteps();
+	srand( 441 );
+
+	// random values, values past both ends, NaN, and both sides of every code boundary
+	std::vector< float > values;
+	for( int i = 0; i < 100000; i++ ) values.push_back( rand() / (float)RAND_MAX );
+	for( int i = 0; i < 1000; i++ ) values.push_back( ( rand() / (float)RAND_MAX ) * 4.0f - 2.0f );
+	values.push_back( NAN );
+	values.push_back( -INFINITY );
+	values.push_back( INFINITY );
+	for( int code = 1; code < 256; code++ ) {
+		const float boundary = (float)srgbDecode( ( code - 0.5 ) / 255.0 );
+		values.push_back( boundary );
+		values.push_back( nextafterf( boundary, 0.0f ) );
+		values.push_back( nextafterf( boundary, 1.0f ) );
+	}
+	for( int code = 0; code < 256; code++ ) values.push_back( (float)srgbDecode( code / 255.0 ) );
+
+	for( int channels = 1; channels <= 4; channels++ ) {
+		const size_t numPixels = values.size() / channels;
+		std::vector< unsigned char > plain( numPixels * channels );
+		Job job = Job();
+		job.linearSource = &values[0];
+		job.destination = &plain[0];
+		job.channels = channels;
+		runStep( 0, steps, CSCI441_INTERNAL::linearToSrgbPixels, job, 0, numPixels );
+
+		// the plain loop picks the nearest code
+		for( size_t i = 0; i < plain.size(); i++ ) {
+			float value = values[i];
+			value = value > 0.0f ? ( value < 1.0f ? value : 1.0f ) : 0.0f;
+			if( channels == 4 && i % 4 == 3 ) {
+				CHECK( plain[i] == (unsigned char)( value * 255.0f + 0.5f ) );
+				continue;
+			}
+			const unsigned int code = plain[i];
+			CHECK( code == 0 || value >= (float)srgbDecode( ( code - 0.5 ) / 255.0 ) );
+			CHECK( code == 255 || value < (float)srgbDecode( ( code + 0.5 ) / 255.0 ) );
+		}
+
+		// and the vector steps agree with it exactly
+		for( int step = 1; step < 3; step++ ) {
+			std::vector< unsigned char > srgb( plain.size() );
+			job.destination = &srgb[0];
+			if( !runStep( step, steps, CSCI441_INTERNAL::linearToSrgbPixels, job, 0, numPixels ) ) continue;
+			CHECK( srgb == plain );
+		}
+	}
+
+	// every code survives a trip through linear and back
+	std::vector< unsigned char > codes( 256 * 4 ), back( codes.size() );
+	for( size_t i = 0; i < codes.size(); i++ ) codes[i] = (unsigned char)( i / 4 );
+	std::vector< float > linear( codes.size() );
+	CSCI441::ImageKernels::srgbToLinear( &codes[0], &linear[0], 256, 4 );
+	CSCI441::ImageKernels::linearToSrgb( &linear[0], &back[0], 256, 4 );
+	CHECK( back == codes );
+}
+
+static void testLargeImagesAcrossThreads() {
+	// past the size where the work is split up, every kernel still matches the plain loop
+	srand( 441 );
+	const size_t numPixels = 2000 * 1000 + 3;
+	const std::vector< unsigned char > color = randomBytes( numPixels * 3 ), mask = randomBytes( numPixels );
+	std::vector< unsigned char > rgba( numPixels * 4 ), expected( numPixels * 4 );
+	CSCI441::ImageKernels::expandRGBA( &color[0], 3, &mask[0], 1, &rgba[0], numPixels );
+	Job job = Job();
+	job.source = &color[0];
+	job.sourceChannels = 3;
+	job.mask = &mask[0];
+	job.maskChannels = 1;
+	job.destination = &expected[0];
+	CSCI441_INTERNAL::expandRGBAPixels( job, 0, numPixels );
+	CHECK( rgba == expected );
+
+	CSCI441::ImageKernels::premultiplyAlpha( &rgba[0], numPixels );
+	job = Job();
+	job.destination = &expected[0];
+	CSCI441_INTERNAL::premultiplyAlphaPixels( job, 0, numPixels );
+	CHECK( rgba == expected );
+
+	CSCI441::ImageKernels::swapRedBlue( &rgba[0], &rgba[0], numPixels, 4 );
+	job.source = &expected[0];
+	job.channels = 4;
+	CSCI441_INTERNAL::swapRedBluePixels( job, 0, numPixels );
+	CHECK( rgba == expected );
+}
+
+int main() {
+#ifdef CSCI441_IMAGEKERNELS_X86
+	if( !CSCI441_INTERNAL::useAVX2ImageKernels() ) printf( "[INFO]: no AVX2 on this processor, its steps were not checked\n" );
+#endif
+	testFlipRows();
+	testSwapRedBlue();
+	testExpandRGBA();
+	testPremultiplyAlpha();
+	testSrgbToLinear();
+	testLinearToSrgb();
+	testLargeImagesAcrossThreads();
+
+	return TestHarness::result( "imageKernelsTest" );
+}
@@ -0,0 +1,65 @@
+/*
+ *  marbleUnitsTest.cpp
+ *
+ *  The attribute locations, the level of detail camera and the primitive
+ *  caches in objects3.hpp must be one copy for the whole program.  Lab11
+ *  sets them up in main.cpp and draws its marbles from Marble.cpp, so this
+ *  test does the same: it configures objects3 here and draws through the
+ *  lab's own Marble.cpp, compiled as a separate translation unit.
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include "../lab11/include/Marble.h"
+
+#include <CSCI441/objects3.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+static void testMarblesSeeLocationsSetInMain() {
+	GLMock::reset();
+	CSCI441::setVertexAttributeLocations( 2, -1, 4 );
+
+	Marble marble( glm::vec3( 0.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ), 0.5 );
+	marble.draw( glm::mat4( 1.0f ), 0, 1 );
+
+	CHECK( !GLMock::draws().empty() );
+	for( size_t i = 0; i < GLMock::draws().size(); i++ ) {
+		const GLMock::DrawCall &draw = GLMock::draws()[i];
+		CHECK( draw.attributeEnabled[2] && draw.attributeEnabled[4] );
+		CHECK( !draw.attributeEnabled[0] && !draw.attributeEnabled[1] );
+	}
+	CHECK( GLMock::errors() == 0 );
+}
+
+static void testMarblesSeeLevelOfDetailViewSetInMain() {
+	GLMock::reset();
+	CSCI441::setVertexAttributeLocations( 0, 1, 2 );
+	glm::mat4 viewMtx = glm::lookAt( glm::vec3( 0.0f, 0.0f, 5.0f ), glm::vec3( 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+	glm::mat4 projMtx = glm::perspective( 0.8f, 16.0f / 9.0f, 0.1f, 1000.0f );
+	CSCI441::setLevelOfDetailView( viewMtx, projMtx, 720 );
+
+	Marble nearMarble( glm::vec3( 0.0f, 0.0f, 0.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ), 2.0 );
+	Marble farMarble( glm::vec3( 0.0f, 0.0f, -400.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ), 0.5 );
+
+	GLMock::resetCalls();
+	nearMarble.draw( glm::mat4( 1.0f ), 0, 1 );
+	// a sphere starts with a triangle fan of slices + 2 vertices
+	GLsizei nearFan = GLMock::draws().empty() ? 0 : GLMock::draws()[0].count;
+
+	GLMock::resetCalls();
+	farMarble.draw( glm::mat4( 1.0f ), 0, 1 );
+	GLsizei farFan = GLMock::draws().empty() ? 0 : GLMock::draws()[0].count;
+
+	// without the camera set in this file both would get the same level
+	CHECK( nearFan == CSCI441_INTERNAL::LOD_SEGMENTS[ CSCI441_INTERNAL::NUM_LOD_LEVELS - 1 ] + 2 );
+	CHECK( farFan == CSCI441_INTERNAL::LOD_SEGMENTS[0] + 2 );
+}
+
+int main() {
+	testMarblesSeeLocationsSetInMain();
+	testMarblesSeeLevelOfDetailViewSetInMain();
+
+	return TestHarness::result( "marbleUnitsTest" );
+}
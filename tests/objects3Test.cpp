@@ -0,0 +1,181 @@
+/*
+ *  objects3Test.cpp
+ *
+ *  Checks the GL calls the objects3.hpp primitives make against the mock:
+ *  a primitive's attribute pointers are baked into a VAO the first time it
+ *  is drawn with a set of locations, later draws are just a VAO bind plus
+ *  the draw calls, and locations of -1 never reach GL.  Solid draws fill
+ *  whatever polygon mode the caller left, and wire draws are GL_LINES over
+ *  the quad grid edges without touching the polygon mode.
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/objects3.hpp>
+
+// draws one of every solid primitive
+static void drawSolidScene() {
+	CSCI441::drawSolidCube( 1.0 );
+	CSCI441::drawSolidCylinder( 0.5, 0.5, 1.0, 4, 16 );
+	CSCI441::drawSolidCone( 0.5, 1.0, 4, 16 );
+	CSCI441::drawSolidDisk( 0.2, 0.7, 16, 4 );
+	CSCI441::drawSolidPartialDisk( 0.2, 0.7, 16, 4, 0.0, 90.0 );
+	CSCI441::drawSolidSphere( 0.7, 16, 16 );
+	CSCI441::drawSolidTorus( 0.2, 0.6, 8, 16 );
+	CSCI441::drawSolidTeapot( 1.0 );
+}
+
+static void testRepeatedDrawsOnlyBindTheVAO() {
+	GLMock::reset();
+	CSCI441::setVertexAttributeLocations( 0, 1, 2 );
+
+	drawSolidScene();
+	CHECK( GLMock::calls( "glGenVertexArrays" ) > 0 );
+	CHECK( GLMock::calls( "glVertexAttribPointer" ) > 0 );
+
+	// second frame: the VAOs and buffers already exist
+	GLMock::resetCalls();
+	drawSolidScene();
+	CHECK( GLMock::calls( "glGenVertexArrays" ) == 0 );
+	CHECK( GLMock::calls( "glGenBuffers" ) == 0 );
+	CHECK( GLMock::calls( "glBufferData" ) == 0 );
+	CHECK( GLMock::calls( "glEnableVertexAttribArray" ) == 0 );
+	CHECK( GLMock::calls( "glVertexAttribPointer" ) == 0 );
+
+	// one VAO bind per primitive; the teapot may also select its element buffer
+	const unsigned int drawCalls = GLMock::calls( "glDrawArrays" ) + GLMock::calls( "glDrawElements" );
+	const unsigned int vaoBinds = GLMock::calls( "glBindVertexArray" );
+	CHECK( vaoBinds == 8 );
+	CHECK( GLMock::totalCalls() <= vaoBinds + drawCalls + 1 + GLMock::calls( "glPolygonMode" ) );
+
+	for( size_t i = 0; i < GLMock::draws().size(); i++ ) {
+		const GLMock::DrawCall &draw = GLMock::draws()[i];
+		CHECK( draw.vao != 0 );
+		CHECK( draw.attributeEnabled[0] && draw.attributeEnabled[1] && draw.attributeEnabled[2] );
+	}
+	CHECK( GLMock::errors() == 0 );
+}
+
+static void testUnusedLocationsAreSkipped() {
+	GLMock::reset();
+	CSCI441::setVertexAttributeLocations( 0, -1, -1 );
+
+	drawSolidScene();
+	CHECK( GLMock::errors() == 0 );
+	CHECK( !GLMock::draws().empty() );
+	for( size_t i = 0; i < GLMock::draws().size(); i++ ) {
+		const GLMock::DrawCall &draw = GLMock::draws()[i];
+		CHECK( draw.attributeEnabled[0] );
+		for( GLuint a = 1; a < GLMock::MAX_ATTRIBUTES; a++ ) CHECK( !draw.attributeEnabled[a] );
+	}
+}
+
+static void testEachLocationSetGetsItsOwnVAO() {
+	GLMock::reset();
+	CSCI441::setVertexAttributeLocations( 0, 1, -1 );
+	CSCI441::drawSolidSphere( 1.0, 8, 8 );
+	const GLuint firstVAO = GLMock::boundVertexArray();
+
+	// a shader with other locations gets another VAO over the same VBO
+	CSCI441::setVertexAttributeLocations( 3, 4, 5 );
+	GLMock::resetCalls();
+	CSCI441::drawSolidSphere( 1.0, 8, 8 );
+	const GLuint secondVAO = GLMock::boundVertexArray();
+	CHECK( secondVAO != firstVAO );
+	CHECK( GLMock::calls( "glGenVertexArrays" ) == 1 );
+	CHECK( GLMock::calls( "glGenBuffers" ) == 0 );
+	CHECK( GLMock::attributeEnabled( secondVAO, 3 ) && GLMock::attributeEnabled( secondVAO, 4 ) && GLMock::attributeEnabled( secondVAO, 5 ) );
+
+	// and switching back reuses the first one
+	CSCI441::setVertexAttributeLocations( 0, 1, -1 );
+	GLMock::resetCalls();
+	CSCI441::drawSolidSphere( 1.0, 8, 8 );
+	CHECK( GLMock::boundVertexArray() == firstVAO );
+	CHECK( GLMock::calls( "glGenVertexArrays" ) == 0 );
+	CHECK( GLMock::calls( "glVertexAttribPointer" ) == 0 );
+}
+
+static void testSolidDrawsFillAfterLineMode() {
+	GLMock::reset();
+	CSCI441::setVertexAttributeLocations( 0, 1, 2 );
+
+	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+	drawSolidScene();
+	CHECK( !GLMock::draws().empty() );
+	for( size_t i = 0; i < GLMock::draws().size(); i++ ) {
+		CHECK( GLMock::draws()[i].polygonMode == GL_FILL );
+	}
+
+	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+	GLMock::resetCalls();
+	CSCI441::drawSolidSphereLOD( 1.0, glm::mat4( 1.0f ) );
+	CSCI441::drawSolidConeLOD( 1.0, 2.0, glm::mat4( 1.0f ) );
+	CSCI441::drawSolidDiskLOD( 0.5, 1.0, glm::mat4( 1.0f ) );
+	CSCI441::drawSolidTorusLOD( 0.5, 1.0, glm::mat4( 1.0f ) );
+	CHECK( !GLMock::draws().empty() );
+	for( size_t i = 0; i < GLMock::draws().size(); i++ ) {
+		CHECK( GLMock::draws()[i].polygonMode == GL_FILL );
+	}
+}
+
+// the only draw since the last resetCalls() is GL_LINES over the expected edge count
+static bool drewEdges( GLsizei numEdges ) {
+	return GLMock::draws().size() == 1
+		&& GLMock::draws()[0].mode == GL_LINES
+		&& GLMock::draws()[0].count == 2*numEdges
+		&& GLMock::calls( "glPolygonMode" ) == 0;
+}
+
+static void testWireDrawsLineTheQuadGrid() {
+	GLMock::reset();
+	CSCI441::setVertexAttributeLocations( 0, 1, 2 );
+
+	// wire draws leave the polygon mode as the caller set it
+	glPolygonMode( GL_FRONT_AND_BACK, GL_POINT );
+	GLMock::resetCalls();
+	CSCI441::drawWireCube( 1.0 );
+	CHECK( drewEdges( 12 ) );
+	CHECK( GLMock::polygonMode() == GL_POINT );
+
+	// 8 slices x 3 rings of vertices + 8 x 2 segments along the sides
+	GLMock::resetCalls();
+	CSCI441::drawWireCylinder( 1.0, 1.0, 2.0, 2, 8 );
+	CHECK( drewEdges( 40 ) );
+
+	// the apex ring collapses to a point, so its edges are dropped
+	GLMock::resetCalls();
+	CSCI441::drawWireCone( 1.0, 2.0, 2, 8 );
+	CHECK( drewEdges( 32 ) );
+
+	// no edges around the poles
+	GLMock::resetCalls();
+	CSCI441::drawWireSphere( 1.0, 4, 8 );
+	CHECK( drewEdges( 56 ) );
+
+	GLMock::resetCalls();
+	CSCI441::drawWireTorus( 0.5, 1.0, 6, 8 );
+	CHECK( drewEdges( 96 ) );
+
+	// the inner ring collapses to the center point
+	GLMock::resetCalls();
+	CSCI441::drawWireDisk( 0.0, 1.0, 8, 2 );
+	CHECK( drewEdges( 32 ) );
+
+	// an open sweep keeps the last spoke
+	GLMock::resetCalls();
+	CSCI441::drawWirePartialDisk( 0.5, 1.0, 8, 1, 0.0, 90.0 );
+	CHECK( drewEdges( 25 ) );
+
+	CHECK( GLMock::errors() == 0 );
+}
+
+int main() {
+	testRepeatedDrawsOnlyBindTheVAO();
+	testUnusedLocationsAreSkipped();
+	testEachLocationSetGetsItsOwnVAO();
+	testSolidDrawsFillAfterLineMode();
+	testWireDrawsLineTheQuadGrid();
+
+	return TestHarness::result( "objects3Test" );
+}
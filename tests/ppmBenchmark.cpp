@@ -0,0 +1,154 @@
+/*
+ *  ppmBenchmark.cpp
+ *
+ *  Decode throughput of TextureUtils::loadPPM() against lab09's old fscanf
+ *  loader: lab11's brick.ppm, a 3840x2160 P3 image of noise, and both as
+ *  P6 at 8 and 16 bits.  The files are written once and read back warm
+ *  from the page cache; every load must give the old loader's bytes.
+ *  MB/s is file bytes over the best wall time of the runs.
+ *
+ *  usage: ppmBenchmark [runs=3]
+ */
+
+#include "testHarness.hpp"
+
+#include <CSCI441/TextureUtils.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+static const char *TEXT_FILE = "ppmBenchmark.ppm";
+static const char *BINARY_FILE = "ppmBenchmark.p6.ppm";
+static const char *WIDE_FILE = "ppmBenchmark.p6-16.ppm";
+
+// lab09's loadPPM() before the mapped decoder, with the missing fopen() check added
+static bool loadOld( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData ) {
+	FILE *fp = fopen( filename, "r" );
+	if( !fp ) return false;
+	int temp, maxValue;
+	fscanf( fp, "P%d", &temp );
+	if( temp != 3 ) {
+		fclose( fp );
+		return false;
+	}
+	fscanf( fp, "%d", &imageWidth );
+	fscanf( fp, "%d", &imageHeight );
+	fscanf( fp, "%d", &maxValue );
+
+	imageData = new unsigned char[imageWidth*imageHeight*3];
+	for( int j = 0; j < imageHeight; j++ ) {
+		for( int i = 0; i < imageWidth; i++ ) {
+			int r, g, b;
+			fscanf( fp, "%d", &r );
+			fscanf( fp, "%d", &g );
+			fscanf( fp, "%d", &b );
+			imageData[(j*imageWidth+i)*3+0] = r;
+			imageData[(j*imageWidth+i)*3+1] = g;
+			imageData[(j*imageWidth+i)*3+2] = b;
+		}
+	}
+	fclose( fp );
+	return true;
+}
+
+static size_t fileSize( const char *filename ) {
+	FILE *fp = fopen( filename, "rb" );
+	if( !fp ) return 0;
+	fseek( fp, 0, SEEK_END );
+	size_t size = ftell( fp );
+	fclose( fp );
+	return size;
+}
+
+static void writeNoiseP3( const char *filename, int width, int height ) {
+	FILE *fp = fopen( filename, "w" );
+	fprintf( fp, "P3\n%d %d\n255\n", width, height );
+	srand( 441 );
+	for( int j = 0; j < height; j++ ) {
+		for( int i = 0; i < width; i++ ) fprintf( fp, "%d %d %d ", rand() % 256, rand() % 256, rand() % 256 );
+		fprintf( fp, "\n" );
+	}
+	fclose( fp );
+}
+
+// the same samples scaled to 16 bits, big endian
+static void writeWideP6( const char *filename, int width, int height, const unsigned char *imageData ) {
+	FILE *fp = fopen( filename, "wb" );
+	fprintf( fp, "P6\n%d %d\n65535\n", width, height );
+	std::vector< unsigned char > samples( (size_t)width * height * 6 );
+	for( size_t i = 0; i < samples.size() / 2; i++ ) {
+		samples[2*i] = samples[2*i + 1] = imageData[i];
+	}
+	fwrite( &samples[0], 1, samples.size(), fp );
+	fclose( fp );
+}
+
+typedef bool (*Loader)( const char*, int&, int&, unsigned char*& );
+
+// best time in milliseconds; every run must load the expected pixels
+static double timeLoad( Loader load, const char *filename, int runs, const std::vector< unsigned char > &expected ) {
+	TestHarness::Timings times;
+	for( int run = 0; run < runs; run++ ) {
+		int width, height;
+		unsigned char *imageData = NULL;
+		double start = TestHarness::now();
+		bool loaded = load( filename, width, height, imageData );
+		times.add( TestHarness::now() - start );
+
+		CHECK( loaded && (size_t)width * height * 3 == expected.size() && memcmp( imageData, &expected[0], expected.size() ) == 0 );
+		delete[] imageData;
+	}
+	return times.percentile( 0 );
+}
+
+static void report( const char *label, const char *filename, double ms ) {
+	size_t size = fileSize( filename );
+	printf( "[INFO]: %-26s %7.2f MB  %9.2f ms  %8.1f MB/s\n", label, size / 1e6, ms, size / 1e3 / ms );
+}
+
+static void benchmarkImage( const char *name, const char *textFile, int runs ) {
+	int width, height;
+	unsigned char *oldData = NULL;
+	if( !loadOld( textFile, width, height, oldData ) ) {
+		printf( "[FAIL]: could not read %s\n", textFile );
+		TestHarness::failures()++;
+		return;
+	}
+	std::vector< unsigned char > expected( oldData, oldData + (size_t)width * height * 3 );
+	delete[] oldData;
+
+	CSCI441::TextureUtils::writePPM( BINARY_FILE, width, height, &expected[0] );
+	writeWideP6( WIDE_FILE, width, height, &expected[0] );
+
+	printf( "[INFO]: %s, %d x %d\n", name, width, height );
+	report( "P3 old fscanf loader", textFile, timeLoad( loadOld, textFile, runs, expected ) );
+	report( "P3 loadPPM", textFile, timeLoad( CSCI441::TextureUtils::loadPPM, textFile, runs, expected ) );
+	report( "P6 8-bit loadPPM", BINARY_FILE, timeLoad( CSCI441::TextureUtils::loadPPM, BINARY_FILE, runs, expected ) );
+	report( "P6 16-bit loadPPM", WIDE_FILE, timeLoad( CSCI441::TextureUtils::loadPPM, WIDE_FILE, runs, expected ) );
+
+	// a mapped P6 hands its raster over without decoding or copying
+	TestHarness::Timings mapTimes;
+	for( int run = 0; run < runs; run++ ) {
+		CSCI441::TextureUtils::PPMImage image;
+		double start = TestHarness::now();
+		CHECK( image.load( BINARY_FILE ) && image.isMapped() );
+		mapTimes.add( TestHarness::now() - start );
+	}
+	printf( "[INFO]: %-26s %7.2f MB  %9.2f ms  (pages are read later, by the upload)\n", "P6 8-bit PPMImage, mapped", fileSize( BINARY_FILE ) / 1e6, mapTimes.percentile( 0 ) );
+}
+
+int main( int argc, char *argv[] ) {
+	const int runs = argc > 1 ? atoi( argv[1] ) : 3;
+
+	benchmarkImage( "lab11 brick.ppm", "../lab11/textures/brick.ppm", runs );
+	writeNoiseP3( TEXT_FILE, 3840, 2160 );
+	benchmarkImage( "noise", TEXT_FILE, runs );
+
+	remove( TEXT_FILE );
+	remove( BINARY_FILE );
+	remove( WIDE_FILE );
+	return TestHarness::result( "ppmBenchmark" );
+}
@@ -0,0 +1,136 @@
+/*
+ *  sceneGraph3Test.cpp
+ *
+ *  Checks that SceneGraph::update() gives every node its parent's world
+ *  matrix times its own local matrix, recomputes only the edited nodes and
+ *  what hangs below them, and attaches nodes with a bad parent to the root.
+ *  The portable pass and the AVX2 pass must agree.
+ */
+
+#include "testHarness.hpp"
+
+#include <CSCI441/sceneGraph3.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stdlib.h>
+
+static bool closeTo( const glm::mat4 &a, const glm::mat4 &b ) {
+	for( int c = 0; c < 4; c++ ) {
+		for( int r = 0; r < 4; r++ ) {
+			if( fabsf( a[c][r] - b[c][r] ) > 1e-5f ) return false;
+		}
+	}
+	return true;
+}
+
+static void testWorldIsTheProductOfTheAncestors() {
+	glm::mat4 bodyMtx = glm::translate( glm::mat4( 1.0f ), glm::vec3( 5.0f, 1.0f, -2.0f ) );
+	glm::mat4 wingMtx = glm::rotate( glm::mat4( 1.0f ), 0.7f, glm::vec3( 0.0f, 0.0f, 1.0f ) );
+	glm::mat4 tipMtx = glm::scale( glm::translate( glm::mat4( 1.0f ), glm::vec3( 0.0f, 2.0f, 0.0f ) ), glm::vec3( 0.5f ) );
+
+	CSCI441::SceneGraph graph;
+	GLint body = graph.addNode( CSCI441::SceneGraph::ROOT, bodyMtx );
+	GLint wing = graph.addNode( body, wingMtx );
+	GLint tip = graph.addNode( wing, tipMtx );
+	GLint other = graph.addNode( body );
+	CHECK( body < wing && wing < tip && body < other );
+	CHECK( graph.getNumNodes() == 4 );
+	CHECK( graph.getParent( tip ) == wing );
+
+	graph.update();
+	CHECK( graph.getNumUpdated() == 4 );
+	CHECK( closeTo( graph.getWorldTransform( body ), bodyMtx ) );
+	CHECK( closeTo( graph.getWorldTransform( wing ), bodyMtx * wingMtx ) );
+	CHECK( closeTo( graph.getWorldTransform( tip ), bodyMtx * wingMtx * tipMtx ) );
+	CHECK( closeTo( graph.getWorldTransform( other ), bodyMtx ) );
+	CHECK( graph.getWorldTransforms() == &graph.getWorldTransform( 0 ) );
+}
+
+static void testOnlyEditedSubtreesAreRecomputed() {
+	// 1 + 4 + 16 nodes, breadth first
+	CSCI441::SceneGraph graph;
+	for( GLint node = 0; node < 21; node++ ) {
+		graph.addNode( node == 0 ? CSCI441::SceneGraph::ROOT : (node - 1) / 4, glm::translate( glm::mat4( 1.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ) ) );
+	}
+	graph.update();
+	CHECK( graph.getNumUpdated() == 21 );
+
+	graph.update();
+	CHECK( graph.getNumUpdated() == 0 );
+
+	// node 2 and its four children
+	glm::mat4 liftMtx = glm::translate( glm::mat4( 1.0f ), glm::vec3( 0.0f, 3.0f, 0.0f ) );
+	graph.setLocalTransform( 2, liftMtx );
+	graph.update();
+	CHECK( graph.getNumUpdated() == 5 );
+	CHECK( closeTo( graph.getLocalTransform( 2 ), liftMtx ) );
+	CHECK( closeTo( graph.getWorldTransform( 9 ), glm::translate( glm::mat4( 1.0f ), glm::vec3( 2.0f, 3.0f, 0.0f ) ) ) );
+	CHECK( closeTo( graph.getWorldTransform( 5 ), glm::translate( glm::mat4( 1.0f ), glm::vec3( 3.0f, 0.0f, 0.0f ) ) ) );
+
+	// two leaves under different parents
+	graph.setLocalTransform( 20, liftMtx );
+	graph.setLocalTransform( 6, liftMtx );
+	graph.update();
+	CHECK( graph.getNumUpdated() == 2 );
+	CHECK( closeTo( graph.getWorldTransform( 20 ), glm::translate( glm::mat4( 1.0f ), glm::vec3( 2.0f, 3.0f, 0.0f ) ) ) );
+
+	// the root moves everything
+	graph.setLocalTransform( 0, glm::mat4( 1.0f ) );
+	graph.update();
+	CHECK( graph.getNumUpdated() == 21 );
+	CHECK( closeTo( graph.getWorldTransform( 9 ), glm::translate( glm::mat4( 1.0f ), glm::vec3( 1.0f, 3.0f, 0.0f ) ) ) );
+}
+
+static void testBadParentsAttachToTheRoot() {
+	CSCI441::SceneGraph graph;
+	GLint first = graph.addNode();
+	GLint orphan = graph.addNode( 7, glm::translate( glm::mat4( 1.0f ), glm::vec3( 0.0f, 0.0f, 4.0f ) ) );
+	CHECK( graph.getParent( first ) == CSCI441::SceneGraph::ROOT );
+	CHECK( graph.getParent( orphan ) == CSCI441::SceneGraph::ROOT );
+	graph.update();
+	CHECK( closeTo( graph.getWorldTransform( orphan ), glm::translate( glm::mat4( 1.0f ), glm::vec3( 0.0f, 0.0f, 4.0f ) ) ) );
+}
+
+static void testPassesAgree() {
+	// a random forest, every parent before its child
+	const GLuint numNodes = 1000;
+	std::vector< GLint > parents( numNodes );
+	std::vector< glm::mat4 > locals( numNodes );
+	srand( 441 );
+	for( GLuint node = 0; node < numNodes; node++ ) {
+		parents[node] = node == 0 || rand() % 10 == 0 ? CSCI441::SceneGraph::ROOT : rand() % node;
+		locals[node] = glm::rotate( glm::translate( glm::mat4( 1.0f ), glm::vec3( rand() % 5, rand() % 5, rand() % 5 ) * 0.1f ), ( rand() % 100 ) * 0.01f, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+	}
+
+	std::vector< GLubyte > dirty( numNodes, 0 );
+	std::vector< glm::mat4 > portable( numNodes );
+	dirty[0] = 1;
+	for( GLuint node = 0; node < numNodes; node++ ) if( parents[node] == CSCI441::SceneGraph::ROOT ) dirty[node] = 1;
+	std::vector< GLubyte > portableDirty( dirty );
+	CHECK( CSCI441_INTERNAL::updateWorldTransforms( &parents[0], &portableDirty[0], &locals[0][0][0], &portable[0][0][0], 0, numNodes ) == numNodes );
+
+	CSCI441::SceneGraph graph;
+	for( GLuint node = 0; node < numNodes; node++ ) graph.addNode( parents[node], locals[node] );
+	graph.update();
+	for( GLuint node = 0; node < numNodes; node++ ) CHECK( closeTo( graph.getWorldTransform( node ), portable[node] ) );
+
+#ifdef CSCI441_SCENEGRAPH_X86
+	if( CSCI441_INTERNAL::hasAVX2() ) {
+		std::vector< glm::mat4 > avx2( numNodes );
+		CHECK( CSCI441_INTERNAL::updateWorldTransformsAVX2( &parents[0], &dirty[0], &locals[0][0][0], &avx2[0][0][0], 0, numNodes ) == numNodes );
+		for( GLuint node = 0; node < numNodes; node++ ) CHECK( closeTo( avx2[node], portable[node] ) );
+	} else {
+		printf( "[INFO]: no AVX2 on this processor, only the portable pass was checked\n" );
+	}
+#endif
+}
+
+int main() {
+	testWorldIsTheProductOfTheAncestors();
+	testOnlyEditedSubtreesAreRecomputed();
+	testBadParentsAttachToTheRoot();
+	testPassesAgree();
+
+	return TestHarness::result( "sceneGraph3Test" );
+}
@@ -0,0 +1,122 @@
+/*
+ *  sceneGraphBenchmark.cpp
+ *
+ *  SceneGraph::update() on a 4-ary tree of 100k nodes: every node after an
+ *  edit to the root, one subtree, a hundred scattered leaves and nothing.
+ *  The full update is compared against the portable pass update() falls
+ *  back to without AVX2, a plain glm loop over the same arrays and copying
+ *  the world array, which bounds how fast any pass that rewrites every
+ *  node can go.  Every run is checked against the glm loop.
+ *
+ *  usage: sceneGraphBenchmark [numNodes=100000] [runs=100]
+ */
+
+#include "testHarness.hpp"
+
+#include <CSCI441/sceneGraph3.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+static glm::mat4 nodeTransform( GLuint node, GLfloat angle ) {
+	return glm::rotate( glm::translate( glm::mat4( 1.0f ), glm::vec3( 1.0f, 0.5f * (node % 3), 0.0f ) ), angle + node * 0.01f, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+}
+
+// world = parentWorld * local the obvious way
+static void referenceUpdate( const CSCI441::SceneGraph &graph, std::vector< glm::mat4 > &worlds ) {
+	worlds.resize( graph.getNumNodes() );
+	for( GLuint node = 0; node < graph.getNumNodes(); node++ ) {
+		GLint parent = graph.getParent( node );
+		worlds[node] = parent == CSCI441::SceneGraph::ROOT ? graph.getLocalTransform( node ) : worlds[parent] * graph.getLocalTransform( node );
+	}
+}
+
+static bool matchesReference( const CSCI441::SceneGraph &graph ) {
+	std::vector< glm::mat4 > worlds;
+	referenceUpdate( graph, worlds );
+	for( GLuint node = 0; node < graph.getNumNodes(); node++ ) {
+		const GLfloat *expected = &worlds[node][0][0], *actual = &graph.getWorldTransform( node )[0][0];
+		for( int i = 0; i < 16; i++ ) {
+			if( fabsf( expected[i] - actual[i] ) > 1e-3f * ( 1.0f + fabsf( expected[i] ) ) ) return false;
+		}
+	}
+	return true;
+}
+
+// edits some nodes, then times update(); returns the best of the runs
+static double timeUpdate( CSCI441::SceneGraph &graph, const std::vector< GLuint > &edits, int runs, GLuint &numUpdated ) {
+	TestHarness::Timings times;
+	for( int run = 0; run < runs; run++ ) {
+		for( size_t e = 0; e < edits.size(); e++ ) graph.setLocalTransform( edits[e], nodeTransform( edits[e], run * 0.1f ) );
+		double start = TestHarness::now();
+		graph.update();
+		times.add( TestHarness::now() - start );
+		numUpdated = graph.getNumUpdated();
+	}
+	CHECK( matchesReference( graph ) );
+	return times.percentile( 0 );
+}
+
+int main( int argc, char *argv[] ) {
+	const GLuint numNodes = argc > 1 ? atoi( argv[1] ) : 100000;
+	const int runs = argc > 2 ? atoi( argv[2] ) : 100;
+
+	// breadth first, so the parent of node n is (n-1)/4
+	CSCI441::SceneGraph graph;
+	graph.reserve( numNodes );
+	for( GLuint node = 0; node < numNodes; node++ ) {
+		graph.addNode( node == 0 ? CSCI441::SceneGraph::ROOT : (GLint)( (node - 1) / 4 ), nodeTransform( node, 0.0f ) );
+	}
+	graph.update();
+#ifdef CSCI441_SCENEGRAPH_X86
+	printf( "[INFO]: update() %s AVX2\n", CSCI441_INTERNAL::hasAVX2() ? "uses" : "runs without" );
+#endif
+
+	// the second child of the root owns about a quarter of the tree
+	std::vector< GLuint > root( 1, 0 ), subtree( 1, 2 ), leaves, nothing;
+	for( GLuint i = 0; i < 100; i++ ) leaves.push_back( numNodes - 1 - i * ( numNodes / 400 ) );
+
+	printf( "[INFO]: %u nodes, best of %d runs\n", numNodes, runs );
+	GLuint numUpdated;
+	double ms = timeUpdate( graph, root, runs, numUpdated );
+	printf( "[INFO]: root edited        %6u nodes updated  %7.3f ms\n", numUpdated, ms );
+	CHECK( numUpdated == numNodes );
+	ms = timeUpdate( graph, subtree, runs, numUpdated );
+	printf( "[INFO]: one subtree edited %6u nodes updated  %7.3f ms\n", numUpdated, ms );
+	ms = timeUpdate( graph, leaves, runs, numUpdated );
+	printf( "[INFO]: 100 leaves edited  %6u nodes updated  %7.3f ms\n", numUpdated, ms );
+	CHECK( numUpdated == leaves.size() );
+	ms = timeUpdate( graph, nothing, runs, numUpdated );
+	printf( "[INFO]: nothing edited     %6u nodes updated  %7.3f ms\n", numUpdated, ms );
+	CHECK( numUpdated == 0 );
+
+	// what a pass over every node is up against
+	TestHarness::Timings portableTimes, glmTimes, copyTimes;
+	std::vector< glm::mat4 > worlds( numNodes ), copy( numNodes );
+	std::vector< GLint > parents( numNodes );
+	for( GLuint node = 0; node < numNodes; node++ ) parents[node] = graph.getParent( node );
+	std::vector< GLubyte > dirty( numNodes );
+	for( int run = 0; run < runs; run++ ) {
+		dirty[0] = 1;
+		double start = TestHarness::now();
+		CSCI441_INTERNAL::updateWorldTransforms( &parents[0], &dirty[0], &graph.getLocalTransform( 0 )[0][0], &worlds[0][0][0], 0, numNodes );
+		portableTimes.add( TestHarness::now() - start );
+
+		start = TestHarness::now();
+		referenceUpdate( graph, worlds );
+		glmTimes.add( TestHarness::now() - start );
+
+		start = TestHarness::now();
+		memcpy( &copy[0], graph.getWorldTransforms(), numNodes * sizeof( glm::mat4 ) );
+		copyTimes.add( TestHarness::now() - start );
+	}
+	printf( "[INFO]: portable pass over every node     %7.3f ms\n", portableTimes.percentile( 0 ) );
+	printf( "[INFO]: glm loop over every node          %7.3f ms\n", glmTimes.percentile( 0 ) );
+	printf( "[INFO]: memcpy of the world array         %7.3f ms\n", copyTimes.percentile( 0 ) );
+
+	return TestHarness::result( "sceneGraphBenchmark" );
+}
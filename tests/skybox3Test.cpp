@@ -0,0 +1,97 @@
+/*
+ *  skybox3Test.cpp
+ *
+ *  Checks the GL calls CSCI441::Skybox makes against the mock: loading the
+ *  faces leaves the caller's vertex array and its element buffer alone,
+ *  and drawing is one strip from the skybox's own vertex array with the
+ *  depth function put back afterwards.
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/skybox3.hpp>
+
+#include <dirent.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+static const char *FACES[6] = { "../lab12/textures/skybox/DOOM16RT.png", "../lab12/textures/skybox/DOOM16LF.png",
+								"../lab12/textures/skybox/DOOM16UP.png", "../lab12/textures/skybox/DOOM16DN.png",
+								"../lab12/textures/skybox/DOOM16FT.png", "../lab12/textures/skybox/DOOM16BK.png" };
+
+// the faces are cached in the default folder
+static void clearCache() {
+	DIR *directory = opendir( ".texcache" );
+	if( !directory ) return;
+	std::vector< std::string > names;
+	for( struct dirent *entry = readdir( directory ); entry; entry = readdir( directory ) ) {
+		if( entry->d_name[0] != '.' ) names.push_back( entry->d_name );
+	}
+	closedir( directory );
+	for( size_t i = 0; i < names.size(); i++ ) remove( ( std::string( ".texcache/" ) + names[i] ).c_str() );
+	remove( ".texcache" );
+}
+
+static void testLoadKeepsTheCallersElementBuffer() {
+	GLMock::reset();
+
+	// a caller's own VAO with its own index buffer, still bound when the skybox loads
+	GLuint callerVAO, callerIBO;
+	glGenVertexArrays( 1, &callerVAO );
+	glBindVertexArray( callerVAO );
+	glGenBuffers( 1, &callerIBO );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, callerIBO );
+
+	CSCI441::Skybox skybox;
+	CHECK( skybox.load( FACES, 0 ) );
+	CHECK( skybox.getTextureHandle() != 0 );
+	CHECK( GLMock::boundVertexArray() == callerVAO );
+	CHECK( GLMock::elementBuffer( callerVAO ) == callerIBO );
+	CHECK( GLMock::calls( "glTexImage2D" ) == 6 );
+
+	// drawing binds the skybox's own VAO, which holds the cube's index buffer
+	skybox.draw( 0 );
+	CHECK( GLMock::elementBuffer( callerVAO ) == callerIBO );
+	CHECK( GLMock::boundVertexArray() != callerVAO );
+	CHECK( GLMock::elementBuffer( GLMock::boundVertexArray() ) != 0 );
+	CHECK( GLMock::elementBuffer( GLMock::boundVertexArray() ) != callerIBO );
+	CHECK( GLMock::bufferSize( GLMock::elementBuffer( GLMock::boundVertexArray() ) ) == CSCI441_INTERNAL::SKYBOX_CUBE_INDICES * (GLsizeiptr)sizeof(GLushort) );
+	CHECK( GLMock::errors() == 0 );
+}
+
+static void testDrawIsOneStrip() {
+	GLMock::reset();
+	CSCI441::Skybox skybox;
+	CHECK( skybox.load( FACES, 0 ) );
+
+	GLint depthFunc;
+	glDepthFunc( GL_LESS );
+	for( int frame = 0; frame < 2; frame++ ) {
+		GLMock::resetCalls();
+		skybox.draw( 0 );
+		CHECK( GLMock::draws().size() == 1 );
+		if( GLMock::draws().size() == 1 ) {
+			CHECK( GLMock::draws()[0].mode == GL_TRIANGLE_STRIP );
+			CHECK( GLMock::draws()[0].count == (GLsizei)CSCI441_INTERNAL::SKYBOX_CUBE_INDICES );
+			CHECK( GLMock::draws()[0].attributeEnabled[0] );
+		}
+		glGetIntegerv( GL_DEPTH_FUNC, &depthFunc );
+		CHECK( depthFunc == GL_LESS );
+	}
+
+	// the second frame only binds the VAO made on the first
+	CHECK( GLMock::calls( "glGenVertexArrays" ) == 0 );
+	CHECK( GLMock::calls( "glBindVertexArray" ) == 1 );
+}
+
+int main() {
+	clearCache();
+	testLoadKeepsTheCallersElementBuffer();
+	testDrawIsOneStrip();
+
+	clearCache();
+	return TestHarness::result( "skybox3Test" );
+}
@@ -0,0 +1,107 @@
+/** @file testHarness.hpp
+  * @brief Checks and timers shared by the tests and benchmarks
+	* @author Dr. Jeffrey Paone
+	*
+	* @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+	*
+	*	Every test is its own small program.  CHECK() records a failure
+	*	and keeps going so one run reports every broken expectation, and
+	*	TestHarness::result() turns the tally into the exit code make
+	*	test looks at.  The timers report milliseconds.
+  */
+
+#ifndef __CSCI441_TEST_HARNESS_HPP__
+#define __CSCI441_TEST_HARNESS_HPP__
+
+#include <algorithm>								// for sort()
+#include <chrono>										// for steady_clock
+#include <stdio.h>									// for printf()
+#include <vector>										// for vector
+
+namespace TestHarness {
+	/**	@desc counts a failed check and reports where it happened
+	 *	@param passed result of the expression being checked
+	 *	@param expression text of the expression
+	 *	@param file source file of the check
+	 *	@param line source line of the check
+	 */
+	void check( bool passed, const char *expression, const char *file, int line );
+
+	/**	@desc number of checks that have failed so far
+	 */
+	int& failures();
+
+	/**	@desc prints a one line summary for the test program
+	 *	@param testName name printed with the summary
+	 *	@return exit code for main(): 0 when every check passed
+	 */
+	int result( const char *testName );
+
+	/**	@desc milliseconds on a monotonic clock
+	 */
+	double now();
+
+	/**	@desc collects per frame (or per run) times and summarizes them
+	 */
+	class Timings {
+	public:
+		void add( double ms ) { _samples.push_back( ms ); }
+		size_t count() const { return _samples.size(); }
+		double mean() const;
+		double max() const;
+		double percentile( double p ) const;
+	private:
+		std::vector<double> _samples;
+	};
+}
+
+#define CHECK( expression ) TestHarness::check( (expression), #expression, __FILE__, __LINE__ )
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+
+inline int& TestHarness::failures() {
+	static int numFailures = 0;
+	return numFailures;
+}
+
+inline void TestHarness::check( bool passed, const char *expression, const char *file, int line ) {
+	if( passed ) return;
+
+	failures()++;
+	printf( "[FAIL]: %s:%d: %s\n", file, line, expression );
+}
+
+inline int TestHarness::result( const char *testName ) {
+	if( failures() == 0 ) {
+		printf( "[PASS]: %s\n", testName );
+		return 0;
+	}
+	printf( "[FAIL]: %s, %d failed checks\n", testName, failures() );
+	return 1;
+}
+
+inline double TestHarness::now() {
+	return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+inline double TestHarness::Timings::mean() const {
+	if( _samples.empty() ) return 0.0;
+	double sum = 0.0;
+	for( size_t i = 0; i < _samples.size(); i++ ) sum += _samples[i];
+	return sum / _samples.size();
+}
+
+inline double TestHarness::Timings::max() const {
+	return _samples.empty() ? 0.0 : *std::max_element( _samples.begin(), _samples.end() );
+}
+
+inline double TestHarness::Timings::percentile( double p ) const {
+	if( _samples.empty() ) return 0.0;
+	std::vector<double> sorted( _samples );
+	std::sort( sorted.begin(), sorted.end() );
+	size_t index = (size_t)( p / 100.0 * ( sorted.size() - 1 ) + 0.5 );
+	return sorted[ std::min( index, sorted.size() - 1 ) ];
+}
+
+#endif // __CSCI441_TEST_HARNESS_HPP__
@@ -0,0 +1,168 @@
+/*
+ *  textureCache3Test.cpp
+ *
+ *  Checks CSCI441::TextureCache against the mock: a cold load leaves one
+ *  finished cache file and no temporary ones, a warm load maps the same
+ *  levels back, compression follows GL_EXT_texture_compression_s3tc, and
+ *  empty sources, unwritable folders and cut short cache files are handled.
+ */
+
+#include "glMock.hpp"
+#include "imageFiles.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/textureCache3.hpp>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+static const char *SOURCE = "../lab05/textures/mines.png";
+static const char *CACHE_DIRECTORY = "textureCache3Test.cache";
+static const char *S3TC = "GL_EXT_texture_compression_s3tc";
+
+static std::vector< std::string > listCache() {
+	std::vector< std::string > names;
+	DIR *directory = opendir( CACHE_DIRECTORY );
+	if( !directory ) return names;
+	for( struct dirent *entry = readdir( directory ); entry; entry = readdir( directory ) ) {
+		if( entry->d_name[0] != '.' ) names.push_back( entry->d_name );
+	}
+	closedir( directory );
+	return names;
+}
+
+static void clearCache() {
+	std::vector< std::string > names = listCache();
+	for( size_t i = 0; i < names.size(); i++ ) remove( ( std::string( CACHE_DIRECTORY ) + "/" + names[i] ).c_str() );
+	remove( CACHE_DIRECTORY );
+}
+
+static bool endsWith( const std::string &name, const char *suffix ) {
+	return name.size() >= strlen( suffix ) && name.compare( name.size() - strlen( suffix ), std::string::npos, suffix ) == 0;
+}
+
+static bool sameLevels( const CSCI441::TextureCache::CachedTexture &a, const CSCI441::TextureCache::CachedTexture &b ) {
+	if( a.getNumLevels() != b.getNumLevels() || a.getFormat() != b.getFormat() ) return false;
+	for( int level = 0; level < a.getNumLevels(); level++ ) {
+		if( a.getLevelSize( level ) != b.getLevelSize( level ) || memcmp( a.getLevel( level ), b.getLevel( level ), a.getLevelSize( level ) ) != 0 ) return false;
+	}
+	return true;
+}
+
+static void testWarmLoadMapsTheColdLevels() {
+	GLMock::reset();
+	clearCache();
+
+	CSCI441::TextureCache::CachedTexture cold, warm;
+	CHECK( cold.load( SOURCE, CSCI441::TextureCache::CACHE_FLIP_Y | CSCI441::TextureCache::CACHE_MIPMAPS, CACHE_DIRECTORY ) );
+	CHECK( !cold.wasCached() );
+	CHECK( cold.getWidth() == 280 && cold.getHeight() == 280 && cold.getChannels() == 3 );
+	CHECK( cold.getNumLevels() == 9 );
+
+	// only the finished file is left behind
+	std::vector< std::string > names = listCache();
+	CHECK( names.size() == 1 );
+	CHECK( names.size() == 1 && endsWith( names[0], ".tex" ) );
+
+	CHECK( warm.load( SOURCE, CSCI441::TextureCache::CACHE_FLIP_Y | CSCI441::TextureCache::CACHE_MIPMAPS, CACHE_DIRECTORY ) );
+	CHECK( warm.wasCached() );
+	CHECK( sameLevels( cold, warm ) );
+
+	warm.upload();
+	CHECK( GLMock::calls( "glTexImage2D" ) == 9 );
+	CHECK( GLMock::textureBytes() == warm.getSize() );
+}
+
+static void testCompressionFollowsS3TCSupport() {
+	GLMock::reset();
+	clearCache();
+	const unsigned int flags = CSCI441::TextureCache::CACHE_FLIP_Y | CSCI441::TextureCache::CACHE_MIPMAPS | CSCI441::TextureCache::CACHE_COMPRESS;
+
+	// without the extension the levels are cached and uploaded uncompressed
+	CSCI441::TextureCache::CachedTexture plain;
+	CHECK( plain.load( SOURCE, flags, CACHE_DIRECTORY ) );
+	CHECK( !plain.isCompressed() && plain.getFormat() == GL_RGB );
+	plain.upload();
+	CHECK( GLMock::calls( "glCompressedTexImage2D" ) == 0 );
+	CHECK( GLMock::calls( "glTexImage2D" ) == (unsigned int)plain.getNumLevels() );
+
+	// with it they are BC1, in a cache file of their own
+	GLMock::setExtensionSupported( S3TC, true );
+	GLMock::resetCalls();
+	CSCI441::TextureCache::CachedTexture compressed;
+	CHECK( compressed.load( SOURCE, flags, CACHE_DIRECTORY ) );
+	CHECK( !compressed.wasCached() );
+	CHECK( compressed.isCompressed() && compressed.getFormat() == GL_COMPRESSED_RGB_S3TC_DXT1_EXT );
+	CHECK( listCache().size() == 2 );
+	compressed.upload();
+	CHECK( GLMock::calls( "glCompressedTexImage2D" ) == (unsigned int)compressed.getNumLevels() );
+	CHECK( GLMock::calls( "glTexImage2D" ) == 0 );
+
+	// compressed levels are never handed to a context that cannot read them
+	GLMock::setExtensionSupported( S3TC, false );
+	GLMock::resetCalls();
+	compressed.upload();
+	CHECK( GLMock::totalCalls() == 0 );
+}
+
+static void testEmptySourceFails() {
+	CHECK( CSCI441_INTERNAL::hashTextureSource( NULL, 0 ) == CSCI441_INTERNAL::hashTextureSource( (const unsigned char*)"", 0 ) );
+
+	ImageFiles::writeFile( "textureCache3Test.png", std::vector< unsigned char >() );
+	CSCI441::TextureCache::CachedTexture texture;
+	CHECK( !texture.load( "textureCache3Test.png", CSCI441::TextureCache::CACHE_FLIP_Y, CACHE_DIRECTORY ) );
+	CHECK( texture.getNumLevels() == 0 );
+	remove( "textureCache3Test.png" );
+}
+
+static void testUnwritableCacheStillLoads() {
+	clearCache();
+
+	// a file where the folder should be leaves nowhere to write
+	ImageFiles::writeFile( CACHE_DIRECTORY, std::vector< unsigned char >( 1, 0 ) );
+	CSCI441::TextureCache::CachedTexture texture;
+	CHECK( texture.load( SOURCE, CSCI441::TextureCache::CACHE_FLIP_Y, CACHE_DIRECTORY ) );
+	CHECK( !texture.wasCached() && texture.getNumLevels() == 1 );
+	remove( CACHE_DIRECTORY );
+}
+
+static void testCutShortCacheIsRebuilt() {
+	clearCache();
+	CSCI441::TextureCache::CachedTexture texture;
+	CHECK( texture.load( SOURCE, CSCI441::TextureCache::CACHE_FLIP_Y | CSCI441::TextureCache::CACHE_MIPMAPS, CACHE_DIRECTORY ) );
+	std::vector< unsigned char > expected( texture.getLevel( 0 ), texture.getLevel( 0 ) + texture.getLevelSize( 0 ) );
+	texture.release();
+
+	// keep only the first half of the file, as a crash in the middle of an old write would have
+	std::vector< std::string > names = listCache();
+	CHECK( names.size() == 1 );
+	if( names.size() != 1 ) return;
+	const std::string path = std::string( CACHE_DIRECTORY ) + "/" + names[0];
+	CSCI441_INTERNAL::MappedFile file;
+	CHECK( CSCI441_INTERNAL::mapFile( path.c_str(), file ) );
+	std::vector< unsigned char > half( file.data, file.data + file.size / 2 );
+	CSCI441_INTERNAL::unmapFile( file );
+	ImageFiles::writeFile( path.c_str(), half );
+
+	CHECK( texture.load( SOURCE, CSCI441::TextureCache::CACHE_FLIP_Y | CSCI441::TextureCache::CACHE_MIPMAPS, CACHE_DIRECTORY ) );
+	CHECK( !texture.wasCached() );
+	CHECK( texture.load( SOURCE, CSCI441::TextureCache::CACHE_FLIP_Y | CSCI441::TextureCache::CACHE_MIPMAPS, CACHE_DIRECTORY ) );
+	CHECK( texture.wasCached() );
+	CHECK( texture.getLevelSize( 0 ) == expected.size() && memcmp( texture.getLevel( 0 ), &expected[0], expected.size() ) == 0 );
+	CHECK( listCache().size() == 1 );
+}
+
+int main() {
+	testWarmLoadMapsTheColdLevels();
+	testCompressionFollowsS3TCSupport();
+	testEmptySourceFails();
+	testUnwritableCacheStillLoads();
+	testCutShortCacheIsRebuilt();
+
+	clearCache();
+	return TestHarness::result( "textureCache3Test" );
+}
@@ -0,0 +1,94 @@
+/*
+ *  textureCacheBenchmark.cpp
+ *
+ *  Cold against warm loads through CSCI441::TextureCache for lab12's
+ *  rue2bump.jpg and lab08's hellknight.png, flipped with mipmaps, both
+ *  uncompressed and BC compressed.  A cold load decodes the source,
+ *  builds its mipmaps, compresses them and writes the cache file; a warm
+ *  load hashes the source and maps that file.  Every warm load must give
+ *  the cold load's levels.  Uploads go to glMock, which never reads the
+ *  pixels, so warm times leave out the page faults a driver's copy would
+ *  take.  Times are the best of the runs.
+ *
+ *  usage: textureCacheBenchmark [runs=5]
+ */
+
+#include "glMock.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/textureCache3.hpp>
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+static const char *CACHE_DIRECTORY = "textureCacheBenchmark.cache";
+
+static void clearCache() {
+	DIR *directory = opendir( CACHE_DIRECTORY );
+	if( !directory ) return;
+	std::vector< std::string > names;
+	for( struct dirent *entry = readdir( directory ); entry; entry = readdir( directory ) ) {
+		if( entry->d_name[0] != '.' ) names.push_back( entry->d_name );
+	}
+	closedir( directory );
+	for( size_t i = 0; i < names.size(); i++ ) remove( ( std::string( CACHE_DIRECTORY ) + "/" + names[i] ).c_str() );
+	remove( CACHE_DIRECTORY );
+}
+
+static void benchmarkTexture( const char *name, const char *filename, unsigned int flags, int runs ) {
+	TestHarness::Timings coldTimes, warmTimes;
+	std::vector< unsigned char > expected;
+	int numLevels = 0;
+	size_t size = 0;
+
+	for( int run = 0; run < runs; run++ ) {
+		clearCache();
+		CSCI441::TextureCache::CachedTexture texture;
+		double start = TestHarness::now();
+		bool loaded = texture.load( filename, flags, CACHE_DIRECTORY );
+		if( loaded ) texture.upload();
+		coldTimes.add( TestHarness::now() - start );
+		CHECK( loaded && !texture.wasCached() );
+		if( !loaded ) return;
+
+		numLevels = texture.getNumLevels();
+		size = texture.getSize();
+		expected.clear();
+		for( int level = 0; level < numLevels; level++ ) expected.insert( expected.end(), texture.getLevel( level ), texture.getLevel( level ) + texture.getLevelSize( level ) );
+	}
+
+	for( int run = 0; run < runs; run++ ) {
+		CSCI441::TextureCache::CachedTexture texture;
+		double start = TestHarness::now();
+		bool loaded = texture.load( filename, flags, CACHE_DIRECTORY );
+		if( loaded ) texture.upload();
+		warmTimes.add( TestHarness::now() - start );
+		CHECK( loaded && texture.wasCached() && texture.getNumLevels() == numLevels );
+
+		std::vector< unsigned char > levels;
+		for( int level = 0; loaded && level < texture.getNumLevels(); level++ ) levels.insert( levels.end(), texture.getLevel( level ), texture.getLevel( level ) + texture.getLevelSize( level ) );
+		CHECK( levels == expected );
+	}
+
+	const double cold = coldTimes.percentile( 0 ), warm = warmTimes.percentile( 0 );
+	printf( "[INFO]: %-34s %2d levels %7.2f MB  cold %8.2f ms  warm %6.2f ms  %6.1fx\n", name, numLevels, size / 1e6, cold, warm, cold / warm );
+}
+
+int main( int argc, char *argv[] ) {
+	const int runs = argc > 1 ? atoi( argv[1] ) : 5;
+	const unsigned int flags = CSCI441::TextureCache::CACHE_FLIP_Y | CSCI441::TextureCache::CACHE_MIPMAPS;
+	GLMock::setExtensionSupported( "GL_EXT_texture_compression_s3tc", true );
+
+	benchmarkTexture( "lab12 rue2bump.jpg", "../lab12/models/medstreet/rue2bump.jpg", flags, runs );
+	benchmarkTexture( "lab12 rue2bump.jpg, BC1", "../lab12/models/medstreet/rue2bump.jpg", flags | CSCI441::TextureCache::CACHE_COMPRESS, runs );
+	benchmarkTexture( "lab08 hellknight.png", "../lab08/models/monsters/hellknight/textures/hellknight.png", flags, runs );
+	benchmarkTexture( "lab08 hellknight.png, BC", "../lab08/models/monsters/hellknight/textures/hellknight.png", flags | CSCI441::TextureCache::CACHE_COMPRESS, runs );
+
+	clearCache();
+	return TestHarness::result( "textureCacheBenchmark" );
+}
@@ -0,0 +1,308 @@
+/*
+ *  textureUtilsTest.cpp
+ *
+ *  Checks the TextureUtils image loaders on files written here: P3 and P6
+ *  PPMs at 8 bit, 16 bit and odd maximum values, with comments, leading
+ *  zeros and every kind of separator, a writePPM() round trip, lab11's
+ *  brick.ppm against the old fscanf loader, and missing, empty, truncated
+ *  and wrong magic files.  Random TGAs, raw and RLE at 24 and 32 bits from
+ *  either origin, and random BMPs stored either way up must load back as
+ *  the pixels they were written from; cutting an RLE TGA short anywhere, or
+ *  claiming a huge size in a tiny file, must fail before allocating.
+ */
+
+#include "imageFiles.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/TextureUtils.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+static const char *TEST_FILE = "textureUtilsTest.ppm";
+static const char *TGA_FILE = "textureUtilsTest.tga";
+static const char *BMP_FILE = "textureUtilsTest.bmp";
+
+static void writeFile( const char *filename, const std::string &contents ) {
+	FILE *fp = fopen( filename, "wb" );
+	fwrite( contents.data(), 1, contents.size(), fp );
+	fclose( fp );
+}
+
+// loads through loadPPM() and compares against the expected 8-bit samples
+static bool loadsAs( const std::string &contents, int width, int height, const unsigned char *expected ) {
+	writeFile( TEST_FILE, contents );
+	int imageWidth = 0, imageHeight = 0;
+	unsigned char *imageData = NULL;
+	bool loaded = CSCI441::TextureUtils::loadPPM( TEST_FILE, imageWidth, imageHeight, imageData );
+	bool matches = loaded && imageWidth == width && imageHeight == height && memcmp( imageData, expected, width * height * 3 ) == 0;
+	delete[] imageData;
+	return matches;
+}
+
+static bool fails( const std::string &contents ) {
+	writeFile( TEST_FILE, contents );
+	int imageWidth, imageHeight;
+	unsigned char *imageData = (unsigned char*)1;
+	bool loaded = CSCI441::TextureUtils::loadPPM( TEST_FILE, imageWidth, imageHeight, imageData );
+	return !loaded && imageData == NULL;
+}
+
+// lab09's loadPPM() before the mapped decoder, P3 only
+static bool loadOld( const char *filename, int &imageWidth, int &imageHeight, std::vector< unsigned char > &imageData ) {
+	FILE *fp = fopen( filename, "r" );
+	if( !fp ) return false;
+	int temp, maxValue;
+	if( fscanf( fp, "P%d", &temp ) != 1 || temp != 3 || fscanf( fp, "%d %d %d", &imageWidth, &imageHeight, &maxValue ) != 3 ) {
+		fclose( fp );
+		return false;
+	}
+	imageData.resize( imageWidth * imageHeight * 3 );
+	for( size_t i = 0; i < imageData.size(); i++ ) {
+		int value;
+		if( fscanf( fp, "%d", &value ) != 1 ) value = 0;
+		imageData[i] = value;
+	}
+	fclose( fp );
+	return true;
+}
+
+static void testP3() {
+	const unsigned char expected[] = { 0, 128, 255,  1, 2, 3,  10, 20, 30,  255, 0, 7 };
+	CHECK( loadsAs( "P3\n2 2\n255\n0 128 255\n1 2 3\n10 20 30\n255 0 7\n", 2, 2, expected ) );
+	// comments in and after the header, tabs, carriage returns, leading zeros, no final newline
+	CHECK( loadsAs( "P3 # magic\n# a comment line\n2\t2 255\r\n000 0128 255 # row one\r\n1\t2  3\n10\r20\n30 255 0 007", 2, 2, expected ) );
+
+	// a maximum value of 15 is scaled to the full byte range
+	const unsigned char scaled[] = { 0, 17, 255 };
+	CHECK( loadsAs( "P3\n1 1\n15\n0 1 15\n", 1, 1, scaled ) );
+	// and one of 65535 rounds to the nearest byte
+	const unsigned char wide[] = { 0, 128, 255 };
+	CHECK( loadsAs( "P3\n1 1\n65535\n0 32896 65535\n", 1, 1, wide ) );
+
+	// more numbers than digits allow are clamped to the maximum value
+	const unsigned char clamped[] = { 255, 255, 0 };
+	CHECK( loadsAs( "P3\n1 1\n255\n300 99999999 0\n", 1, 1, clamped ) );
+}
+
+static void testP6() {
+	const unsigned char expected[] = { 0, 128, 255,  1, 2, 3 };
+	CHECK( loadsAs( std::string( "P6\n2 1\n255\n" ) + std::string( (const char*)expected, 6 ), 2, 1, expected ) );
+
+	// sixteen bit samples are big endian
+	const unsigned char wideSamples[] = { 0, 0,  0x80, 0x80,  0xFF, 0xFF };
+	const unsigned char wide[] = { 0, 128, 255 };
+	CHECK( loadsAs( std::string( "P6 1 1 65535\n" ) + std::string( (const char*)wideSamples, 6 ), 1, 1, wide ) );
+
+	const unsigned char oddSamples[] = { 0, 50, 100 };
+	const unsigned char odd[] = { 0, 128, 255 };
+	CHECK( loadsAs( std::string( "P6\n1 1\n100\n" ) + std::string( (const char*)oddSamples, 3 ), 1, 1, odd ) );
+
+	// full range P6 is used in place and 16 bits stay 16 bits
+	writeFile( TEST_FILE, std::string( "P6 1 1 65535\n" ) + std::string( (const char*)wideSamples, 6 ) );
+	CSCI441::TextureUtils::PPMImage image;
+	CHECK( image.load( TEST_FILE ) );
+	CHECK( image.isMapped() && image.isBigEndian() );
+	CHECK( image.getType() == GL_UNSIGNED_SHORT && image.getSize() == 6 );
+	CHECK( memcmp( image.getPixels(), wideSamples, 6 ) == 0 );
+	image.release();
+
+	// anything else is decoded into a buffer of its own
+	writeFile( TEST_FILE, "P3\n1 1\n255\n1 2 3\n" );
+	CHECK( image.load( TEST_FILE ) );
+	CHECK( !image.isMapped() && image.getType() == GL_UNSIGNED_BYTE && image.getSize() == 3 );
+}
+
+static void testRandomImagesRoundTrip() {
+	srand( 441 );
+	for( int run = 0; run < 50; run++ ) {
+		const int width = 1 + rand() % 40, height = 1 + rand() % 40;
+		std::vector< unsigned char > pixels( width * height * 3 );
+		std::string text;
+		char number[16];
+		sprintf( number, "P3\n%d %d\n255\n", width, height );
+		text += number;
+		for( size_t i = 0; i < pixels.size(); i++ ) {
+			pixels[i] = rand() % 256;
+			sprintf( number, rand() % 4 == 0 ? "%03d" : "%d", pixels[i] );
+			text += number;
+			text += " \t\n\r"[rand() % 4];
+		}
+		CHECK( loadsAs( text, width, height, &pixels[0] ) );
+
+		// written back as P6 it loads the same
+		CHECK( CSCI441::TextureUtils::writePPM( TEST_FILE, width, height, &pixels[0] ) );
+		int imageWidth, imageHeight;
+		unsigned char *imageData = NULL;
+		CHECK( CSCI441::TextureUtils::loadPPM( TEST_FILE, imageWidth, imageHeight, imageData ) );
+		CHECK( imageWidth == width && imageHeight == height && memcmp( imageData, &pixels[0], pixels.size() ) == 0 );
+		delete[] imageData;
+	}
+}
+
+static void testBrickMatchesTheOldLoader() {
+	const char *brick = "../lab11/textures/brick.ppm";
+	int oldWidth, oldHeight, width, height;
+	std::vector< unsigned char > oldData;
+	unsigned char *imageData = NULL;
+	CHECK( loadOld( brick, oldWidth, oldHeight, oldData ) );
+	CHECK( CSCI441::TextureUtils::loadPPM( brick, width, height, imageData ) );
+	CHECK( width == oldWidth && height == oldHeight && imageData != NULL && memcmp( imageData, &oldData[0], oldData.size() ) == 0 );
+	delete[] imageData;
+}
+
+static void testBadFilesFail() {
+	int imageWidth, imageHeight;
+	unsigned char *imageData = (unsigned char*)1;
+	CHECK( !CSCI441::TextureUtils::loadPPM( "textureUtilsTest.missing.ppm", imageWidth, imageHeight, imageData ) );
+	CHECK( imageData == NULL );
+
+	CHECK( fails( "" ) );
+	CHECK( fails( "P5\n1 1\n255\n\x01" ) );
+	CHECK( fails( "P3\n" ) );
+	CHECK( fails( "P3\n0 1\n255\n" ) );
+	CHECK( fails( "P3\n1 1\n0\n0 0 0\n" ) );
+	CHECK( fails( "P3\n1 1\n70000\n0 0 0\n" ) );
+	CHECK( fails( "P3\n2 1\n255\n1 2 3 4 5\n" ) );
+	CHECK( fails( "P6\n2 1\n255\n\x01\x02\x03\x04\x05" ) );
+	CHECK( fails( "P6\n1 1\n65535\n\x01\x02\x03\x04\x05" ) );
+	CHECK( fails( "P6\n100000 100000\n255\n" ) );
+	remove( TEST_FILE );
+}
+
+static std::vector< unsigned char > randomPixels( int width, int height, int channels ) {
+	// a few colors, so RLE finds runs as well as raw stretches
+	std::vector< unsigned char > pixels( (size_t)width * height * channels );
+	for( size_t p = 0; p < pixels.size(); p += channels ) {
+		const int color = rand() % 3 == 0 ? rand() % 4 : rand();
+		for( int c = 0; c < channels; c++ ) pixels[p + c] = (unsigned char)( color * ( c + 7 ) );
+	}
+	return pixels;
+}
+
+static bool tgaFails( const std::vector< unsigned char > &file ) {
+	ImageFiles::writeFile( TGA_FILE, file );
+	int imageWidth, imageHeight, imageChannels;
+	unsigned char *imageData = (unsigned char*)1;
+	bool loaded = CSCI441::TextureUtils::loadTGA( TGA_FILE, imageWidth, imageHeight, imageData, imageChannels );
+	return !loaded && imageData == NULL;
+}
+
+static void testRandomTGAsRoundTrip() {
+	srand( 441 );
+	for( int run = 0; run < 200; run++ ) {
+		const int width = 1 + rand() % 70, height = 1 + rand() % 40, channels = rand() % 2 ? 4 : 3;
+		const bool rle = rand() % 2, topLeft = rand() % 2;
+		std::vector< unsigned char > pixels = randomPixels( width, height, channels );
+		ImageFiles::writeFile( TGA_FILE, ImageFiles::encodeTGA( &pixels[0], width, height, channels, rle, topLeft, rand() % 3 == 0 ? rand() % 256 : 0 ) );
+
+		int imageWidth = 0, imageHeight = 0, imageChannels = 0;
+		unsigned char *imageData = NULL;
+		CHECK( CSCI441::TextureUtils::loadTGA( TGA_FILE, imageWidth, imageHeight, imageData, imageChannels ) );
+		CHECK( imageWidth == width && imageHeight == height && imageChannels == channels );
+		CHECK( imageData != NULL && memcmp( imageData, &pixels[0], pixels.size() ) == 0 );
+		delete[] imageData;
+	}
+}
+
+// the loaders report every bad file, on stdout or stderr; hundreds of truncated files need not be
+static int silence( int output ) {
+	fflush( stdout );
+	fflush( stderr );
+	const int saved = dup( output ), devNull = open( "/dev/null", O_WRONLY );
+	dup2( devNull, output );
+	close( devNull );
+	return saved;
+}
+
+static void restore( int output, int saved ) {
+	fflush( stdout );
+	fflush( stderr );
+	dup2( saved, output );
+	close( saved );
+}
+
+static void testShortTGAsFail() {
+	srand( 4410 );
+	std::vector< unsigned char > pixels = randomPixels( 33, 9, 4 );
+
+	// every prefix of an RLE file, with and without an image id
+	const int saved = silence( 2 );
+	for( int idLength = 0; idLength <= 5; idLength += 5 ) {
+		std::vector< unsigned char > file = ImageFiles::encodeTGA( &pixels[0], 33, 9, 4, true, false, idLength );
+		for( size_t size = 0; size < file.size(); size++ ) {
+			CHECK( tgaFails( std::vector< unsigned char >( file.begin(), file.begin() + size ) ) );
+		}
+	}
+	restore( 2, saved );
+	std::vector< unsigned char > file = ImageFiles::encodeTGA( &pixels[0], 33, 9, 4, false, true );
+	CHECK( tgaFails( std::vector< unsigned char >( file.begin(), file.end() - 1 ) ) );
+
+	// a 65535 x 65535 header in front of a single pixel is refused before its 16 GB are allocated
+	for( int rle = 0; rle < 2; rle++ ) {
+		file = ImageFiles::encodeTGA( &pixels[0], 1, 1, 4, rle, false );
+		file[12] = file[13] = file[14] = file[15] = 0xFF;
+		CHECK( tgaFails( file ) );
+	}
+
+	// unsupported types and depths
+	file = ImageFiles::encodeTGA( &pixels[0], 2, 2, 3, false, false );
+	file[2] = 3;
+	CHECK( tgaFails( file ) );
+	file[2] = 2;
+	file[16] = 16;
+	CHECK( tgaFails( file ) );
+	file[16] = 24;
+	file[12] = 0;
+	CHECK( tgaFails( file ) );
+	remove( TGA_FILE );
+}
+
+static void testRandomBMPsRoundTrip() {
+	srand( 441 );
+	for( int run = 0; run < 100; run++ ) {
+		const int width = 1 + rand() % 70, height = 1 + rand() % 40;
+		const bool topDown = rand() % 2;
+		std::vector< unsigned char > pixels = randomPixels( width, height, 3 );
+		std::vector< unsigned char > file = ImageFiles::encodeBMP( &pixels[0], width, height, topDown );
+		ImageFiles::writeFile( BMP_FILE, file );
+
+		int imageWidth = 0, imageHeight = 0, imageChannels = 0;
+		unsigned char *imageData = NULL;
+		CHECK( CSCI441::TextureUtils::loadBMP( BMP_FILE, imageWidth, imageHeight, imageChannels, imageData ) );
+		CHECK( imageWidth == width && imageHeight == height && imageChannels == 3 );
+		CHECK( imageData != NULL && memcmp( imageData, &pixels[0], pixels.size() ) == 0 );
+		delete[] imageData;
+
+		// the last row needs no padding, but every byte of it must be there
+		const size_t rowBytes = width * 3;
+		file.resize( file.size() - ( ( 4 - rowBytes % 4 ) % 4 ) - 1 );
+		ImageFiles::writeFile( BMP_FILE, file );
+		imageData = (unsigned char*)1;
+		const int saved = silence( 1 );
+		CHECK( !CSCI441::TextureUtils::loadBMP( BMP_FILE, imageWidth, imageHeight, imageChannels, imageData ) );
+		restore( 1, saved );
+		CHECK( imageData == NULL );
+	}
+	remove( BMP_FILE );
+}
+
+int main() {
+	testP3();
+	testP6();
+	testRandomImagesRoundTrip();
+	testBrickMatchesTheOldLoader();
+	testBadFilesFail();
+	testRandomTGAsRoundTrip();
+	testShortTGAsFail();
+	testRandomBMPsRoundTrip();
+
+	return TestHarness::result( "textureUtilsTest" );
+}
@@ -0,0 +1,243 @@
+/*
+ *  tgaBenchmark.cpp
+ *
+ *  Decode throughput of TextureUtils::loadTGA() and loadBMP() against the
+ *  fread loaders they replaced: raw TGAs at 24 and 32 bits from either
+ *  origin, RLE TGAs of an image with runs in it, and a bottom-up BMP whose
+ *  rows need no padding, which is all the old BMP loader read right.  The
+ *  files are written once and read back warm from the page cache; every
+ *  load must give the old loader's bytes.  MB/s is file bytes over the best
+ *  wall time of the runs.
+ *
+ *  usage: tgaBenchmark [size=2048] [runs=3]
+ */
+
+#include "imageFiles.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/TextureUtils.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+static const char *TGA_FILE = "tgaBenchmark.tga";
+static const char *BMP_FILE = "tgaBenchmark.bmp";
+
+// loadTGA() before the mapped decoder, with the missing fclose() on errors added
+static bool loadOldTGA( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData, int &imageChannels ) {
+	FILE *fp = fopen( filename, "rb" );
+	imageData = NULL;
+	if( !fp ) return false;
+
+	unsigned char idLength, colorMapType, imageType, numBitsPerColorMapEntry, bytesPerPixel, imageAttributeFlags;
+	unsigned short idxOfFirstColorMapEntry, countOfColorMapEntries, xCoordOfLowerLeft, yCoordOfLowerLeft, width, height;
+	fread( &idLength, sizeof(unsigned char), 1, fp );
+	fread( &colorMapType, sizeof(unsigned char), 1, fp );
+	fread( &imageType, sizeof(unsigned char), 1, fp );
+	fread( &idxOfFirstColorMapEntry, sizeof(unsigned short), 1, fp );
+	fread( &countOfColorMapEntries, sizeof(unsigned short), 1, fp );
+	fread( &numBitsPerColorMapEntry, sizeof(unsigned char), 1, fp );
+	fread( &xCoordOfLowerLeft, sizeof(unsigned short), 1, fp );
+	fread( &yCoordOfLowerLeft, sizeof(unsigned short), 1, fp );
+	fread( &width, sizeof(unsigned short), 1, fp );
+	fread( &height, sizeof(unsigned short), 1, fp );
+	fread( &bytesPerPixel, sizeof(unsigned char), 1, fp );
+	fread( &imageAttributeFlags, sizeof(unsigned char), 1, fp );
+	if( colorMapType != 0 || ( imageType != 2 && imageType != 10 ) || ( bytesPerPixel != 24 && bytesPerPixel != 32 ) ) {
+		fclose( fp );
+		return false;
+	}
+
+	bool usingRLE = ( imageType == 10 );
+	imageChannels = ( bytesPerPixel == 32 ? 4 : 3 );
+	bool topLeft = ( imageAttributeFlags & 32 );
+	if( idLength != 0 ) fseek( fp, idLength, SEEK_CUR );
+
+	imageWidth = width;
+	imageHeight = height;
+	imageData = new unsigned char[imageWidth*imageHeight*imageChannels];
+
+	if( usingRLE ) {
+		int numberOfPixelsRead = 0;
+		unsigned char dummy;
+		while( numberOfPixelsRead < imageWidth*imageHeight ) {
+			fread( &dummy, sizeof(unsigned char), 1, fp );
+			bool isRLEPacket = ( dummy & 0x80 );
+			unsigned char count = ( dummy & 0x7F );
+			if( isRLEPacket ) {
+				unsigned char repeatedR, repeatedG, repeatedB, repeatedA;
+				fread( &repeatedR, sizeof(unsigned char), 1, fp );
+				fread( &repeatedG, sizeof(unsigned char), 1, fp );
+				fread( &repeatedB, sizeof(unsigned char), 1, fp );
+				if( imageChannels == 4 ) fread( &repeatedA, sizeof(unsigned char), 1, fp );
+				for( int i = 0; i < ( (int)count + 1 ); i++ ) {
+					int idx = numberOfPixelsRead * imageChannels;
+					imageData[idx+2] = repeatedR;
+					imageData[idx+1] = repeatedG;
+					imageData[idx+0] = repeatedB;
+					if( imageChannels == 4 ) imageData[idx+3] = repeatedA;
+					numberOfPixelsRead++;
+				}
+			} else {
+				for( int i = 0; i < ( (int)count + 1 ); i++ ) {
+					int idx = numberOfPixelsRead * imageChannels;
+					fread( &imageData[idx+2], sizeof(unsigned char), 1, fp );
+					fread( &imageData[idx+1], sizeof(unsigned char), 1, fp );
+					fread( &imageData[idx+0], sizeof(unsigned char), 1, fp );
+					if( imageChannels == 4 ) fread( &imageData[idx+3], sizeof(unsigned char), 1, fp );
+					numberOfPixelsRead++;
+				}
+			}
+		}
+
+		if( !topLeft ) {
+			unsigned char *tempCopy = new unsigned char[imageWidth*imageHeight*imageChannels];
+			for( int i = 0; i < imageHeight; i++ ) {
+				for( int j = 0; j < imageWidth; j++ ) {
+					int copyIdx = ( i*imageWidth + j )*imageChannels;
+					int pullIdx = ( ( imageHeight - i - 1 )*imageWidth + j )*imageChannels;
+					tempCopy[copyIdx+0] = imageData[pullIdx+0];
+					tempCopy[copyIdx+1] = imageData[pullIdx+1];
+					tempCopy[copyIdx+2] = imageData[pullIdx+2];
+					if( imageChannels == 4 ) tempCopy[copyIdx+3] = imageData[pullIdx+3];
+				}
+			}
+			delete[] imageData;
+			imageData = tempCopy;
+		}
+	} else {
+		unsigned char byte1, byte2, byte3, maybeEvenByte4;
+		for( int i = 0; i < imageHeight; i++ ) {
+			for( int j = 0; j < imageWidth; j++ ) {
+				fread( &byte1, sizeof(unsigned char), 1, fp );
+				fread( &byte2, sizeof(unsigned char), 1, fp );
+				fread( &byte3, sizeof(unsigned char), 1, fp );
+				if( imageChannels == 4 ) fread( &maybeEvenByte4, sizeof(unsigned char), 1, fp );
+				int wutHeight = topLeft ? i : ( imageHeight - 1 - i );
+				int idx = ( wutHeight*imageWidth + j )*imageChannels;
+				imageData[idx+2] = byte1;
+				imageData[idx+1] = byte2;
+				imageData[idx+0] = byte3;
+				if( imageChannels == 4 ) imageData[idx+3] = maybeEvenByte4;
+			}
+		}
+	}
+
+	fclose( fp );
+	return true;
+}
+
+// loadBMP() before the mapped decoder, handing back the buffer it used to leak
+static bool loadOldBMP( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData, int &imageChannels ) {
+	FILE *file = fopen( filename, "rb" );
+	imageData = NULL;
+	if( !file ) return false;
+
+	unsigned short int planes, bpp;
+	fseek( file, 18, SEEK_CUR );
+	if( fread( &imageWidth, 4, 1, file ) != 1 || fread( &imageHeight, 4, 1, file ) != 1
+		|| fread( &planes, 2, 1, file ) != 1 || planes != 1 || fread( &bpp, 2, 1, file ) != 1 || bpp != 24 ) {
+		fclose( file );
+		return false;
+	}
+	unsigned long size = imageWidth * imageHeight * 3;
+	fseek( file, 24, SEEK_CUR );
+
+	imageData = new unsigned char[size];
+	if( fread( imageData, size, 1, file ) != 1 ) {
+		fclose( file );
+		delete[] imageData;
+		imageData = NULL;
+		return false;
+	}
+	for( unsigned long i = 0; i < size; i += 3 ) {
+		char temp = imageData[i];
+		imageData[i] = imageData[i+2];
+		imageData[i+2] = temp;
+	}
+	fclose( file );
+	imageChannels = 3;
+	return true;
+}
+
+static bool loadNewBMP( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData, int &imageChannels ) {
+	return CSCI441::TextureUtils::loadBMP( filename, imageWidth, imageHeight, imageChannels, imageData );
+}
+
+static size_t fileSize( const char *filename ) {
+	FILE *fp = fopen( filename, "rb" );
+	if( !fp ) return 0;
+	fseek( fp, 0, SEEK_END );
+	size_t size = ftell( fp );
+	fclose( fp );
+	return size;
+}
+
+typedef bool (*Loader)( const char*, int&, int&, unsigned char*&, int& );
+
+// best time in milliseconds; every run must load the expected pixels
+static double timeLoad( Loader load, const char *filename, int runs, const std::vector< unsigned char > &expected ) {
+	TestHarness::Timings times;
+	for( int run = 0; run < runs; run++ ) {
+		int width, height, channels;
+		unsigned char *imageData = NULL;
+		double start = TestHarness::now();
+		bool loaded = load( filename, width, height, imageData, channels );
+		times.add( TestHarness::now() - start );
+
+		CHECK( loaded && (size_t)width * height * channels == expected.size() && memcmp( imageData, &expected[0], expected.size() ) == 0 );
+		delete[] imageData;
+	}
+	return times.percentile( 0 );
+}
+
+static void compare( const char *label, Loader oldLoad, Loader newLoad, const char *filename, int runs, const std::vector< unsigned char > &expected ) {
+	const size_t size = fileSize( filename );
+	const double oldMs = timeLoad( oldLoad, filename, runs, expected ), newMs = timeLoad( newLoad, filename, runs, expected );
+	printf( "[INFO]: %-22s %7.2f MB  old %8.2f ms %7.1f MB/s  new %8.2f ms %7.1f MB/s  %5.1fx\n",
+		label, size / 1e6, oldMs, size / 1e3 / oldMs, newMs, size / 1e3 / newMs, oldMs / newMs );
+}
+
+// noise broken up by flat spans, top row first
+static std::vector< unsigned char > testImage( int size, int channels ) {
+	std::vector< unsigned char > pixels( (size_t)size * size * channels );
+	srand( 441 );
+	for( size_t p = 0; p < pixels.size(); ) {
+		const size_t span = rand() % 3 == 0 ? 1 + rand() % 64 : 1;
+		const int color = rand();
+		for( size_t s = 0; s < span && p < pixels.size(); s++, p += channels ) {
+			for( int c = 0; c < channels; c++ ) pixels[p + c] = (unsigned char)( ( color >> ( 5*c ) ) + ( span == 1 ? s : 0 ) );
+		}
+	}
+	return pixels;
+}
+
+int main( int argc, char *argv[] ) {
+	const int size = argc > 1 ? atoi( argv[1] ) & ~3 : 2048;
+	const int runs = argc > 2 ? atoi( argv[2] ) : 3;
+	printf( "[INFO]: %d x %d, best of %d runs\n", size, size, runs );
+
+	for( int channels = 3; channels <= 4; channels++ ) {
+		std::vector< unsigned char > pixels = testImage( size, channels );
+		for( int rle = 0; rle < 2; rle++ ) {
+			for( int topLeft = 0; topLeft < 2; topLeft++ ) {
+				char label[64];
+				sprintf( label, "TGA %d-bit %s %s", channels * 8, rle ? "RLE" : "raw", topLeft ? "top" : "bottom" );
+				ImageFiles::writeFile( TGA_FILE, ImageFiles::encodeTGA( &pixels[0], size, size, channels, rle, topLeft ) );
+				compare( label, loadOldTGA, CSCI441::TextureUtils::loadTGA, TGA_FILE, runs, pixels );
+			}
+		}
+	}
+
+	// the same pixels read bottom row first, as loadBMP() returns them
+	std::vector< unsigned char > pixels = testImage( size, 3 );
+	ImageFiles::writeFile( BMP_FILE, ImageFiles::encodeBMP( &pixels[0], size, size, false ) );
+	compare( "BMP 24-bit", loadOldBMP, loadNewBMP, BMP_FILE, runs, pixels );
+
+	remove( TGA_FILE );
+	remove( BMP_FILE );
+	return TestHarness::result( "tgaBenchmark" );
+}
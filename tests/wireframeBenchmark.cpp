@@ -0,0 +1,101 @@
+/*
+ *  wireframeBenchmark.cpp
+ *
+ *  Times a wire heavy debug view: a grid of wire primitives redrawn from an
+ *  orbiting camera.  Each frame is drawn twice, once the way the wire
+ *  objects used to draw (polygon mode switched to GL_LINE around the
+ *  triangle mesh) and once through drawWire*() (GL_LINES over the baked
+ *  edge index buffer).  Reports the CPU time to submit a frame and the time
+ *  until glFinish() returns.
+ *
+ *  usage: wireframeBenchmark [gridSize=20] [frames=200]
+ */
+
+#include "glBenchmark.hpp"
+#include "testHarness.hpp"
+
+#include <CSCI441/objects3.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <math.h>
+#include <stdlib.h>
+
+// the pre edge buffer wire objects: the solid triangles rasterized as lines
+static void drawOldWire( int shape ) {
+	glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
+	switch( shape ) {
+		case 0: CSCI441_INTERNAL::drawSphere( 0.7, 16, 16, GL_FILL );					break;
+		case 1: CSCI441_INTERNAL::drawCube( 1.0, GL_FILL );							break;
+		case 2: CSCI441_INTERNAL::drawTorus( 0.2, 0.6, 8, 16, GL_FILL );				break;
+		case 3: CSCI441_INTERNAL::drawCylinder( 0.5, 0.5, 1.0, 4, 16, GL_FILL );		break;
+		case 4: CSCI441_INTERNAL::drawCylinder( 0.5, 0.0, 1.0, 4, 16, GL_FILL );		break;
+		case 5: CSCI441_INTERNAL::drawPartialDisk( 0.2, 0.7, 16, 4, 0, 2*M_PI, GL_FILL );	break;
+	}
+	glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+}
+
+static void drawNewWire( int shape ) {
+	switch( shape ) {
+		case 0: CSCI441::drawWireSphere( 0.7, 16, 16 );						break;
+		case 1: CSCI441::drawWireCube( 1.0 );									break;
+		case 2: CSCI441::drawWireTorus( 0.2, 0.6, 8, 16 );					break;
+		case 3: CSCI441::drawWireCylinder( 0.5, 0.5, 1.0, 4, 16 );			break;
+		case 4: CSCI441::drawWireCone( 0.5, 1.0, 4, 16 );					break;
+		case 5: CSCI441::drawWireDisk( 0.2, 0.7, 16, 4 );					break;
+	}
+}
+
+static void timeWireView( const char *label, void (*drawWire)( int ), int gridSize, int frames, GLint mvpLocation, const glm::mat4 &projMtx ) {
+	TestHarness::Timings submitTimes, frameTimes;
+
+	// the first frames build the VBOs and VAOs, so they are not timed
+	for( int frame = -20; frame < frames; frame++ ) {
+		double start = TestHarness::now();
+		glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+		float angle = frame * 0.01f;
+		glm::mat4 viewMtx = glm::lookAt( glm::vec3( gridSize*1.6f*cosf(angle), gridSize*0.8f, gridSize*1.6f*sinf(angle) ), glm::vec3( 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+		for( int i = 0; i < gridSize; i++ ) {
+			for( int j = 0; j < gridSize; j++ ) {
+				glm::mat4 mvpMtx = projMtx * viewMtx * glm::translate( glm::mat4( 1.0f ), glm::vec3( (i - gridSize/2)*2.0f, 0.0f, (j - gridSize/2)*2.0f ) );
+				glUniformMatrix4fv( mvpLocation, 1, GL_FALSE, &mvpMtx[0][0] );
+				drawWire( (i*gridSize + j) % 6 );
+			}
+		}
+		double submitted = TestHarness::now();
+		glFinish();
+		double finished = TestHarness::now();
+
+		if( frame >= 0 ) {
+			submitTimes.add( submitted - start );
+			frameTimes.add( finished - start );
+		}
+	}
+
+	printf( "[INFO]: %-20s %4d objects: submit %7.3f ms/frame, frame %7.3f ms/frame (p95 %7.3f)\n",
+			label, gridSize*gridSize, submitTimes.mean(), frameTimes.mean(), frameTimes.percentile( 95 ) );
+}
+
+int main( int argc, char *argv[] ) {
+	const int gridSize = argc > 1 ? atoi( argv[1] ) : 20;
+	const int frames = argc > 2 ? atoi( argv[2] ) : 200;
+	const int width = 1280, height = 720;
+
+	GLFWwindow *window = GLBenchmark::openHiddenWindow( width, height );
+	GLuint program = GLBenchmark::useFlatShader();
+	GLint mvpLocation = glGetUniformLocation( program, "mvpMatrix" );
+	CSCI441::setVertexAttributeLocations( 0, 1, -1 );
+
+	glm::mat4 projMtx = glm::perspective( 0.9f, (float)width / height, 0.1f, 1000.0f );
+	timeWireView( "glPolygonMode path", drawOldWire, gridSize, frames, mvpLocation, projMtx );
+	timeWireView( "edge IBO path", drawNewWire, gridSize, frames, mvpLocation, projMtx );
+
+	GLenum error = glGetError();
+	GLBenchmark::closeWindow( window );
+	if( error != GL_NO_ERROR ) {
+		printf( "[FAIL]: wireframeBenchmark, GL error 0x%x\n", error );
+		return 1;
+	}
+	return 0;
+}